@@ -783,6 +783,23 @@ Rtklib_Pvt::Rtklib_Pvt(ConfigurationInterface* configuration,
     // Set maximum clock offset allowed if pvt_output_parameters.enable_rx_clock_correction = false
     pvt_output_parameters.max_obs_block_rx_clock_offset_ms = configuration->property(role + ".max_clock_offset_ms", pvt_output_parameters.max_obs_block_rx_clock_offset_ms);
 
+    // Write the output files and the RTCM stream in a dedicated thread
+    pvt_output_parameters.async_output = configuration->property(role + ".async_output", pvt_output_parameters.async_output);
+    pvt_output_parameters.async_output_queue_size = configuration->property(role + ".async_output_queue_size", pvt_output_parameters.async_output_queue_size);
+    if (pvt_output_parameters.async_output_queue_size < 1)
+        {
+            pvt_output_parameters.async_output_queue_size = 1;
+        }
+    pvt_output_parameters.async_output_drop_when_full = configuration->property(role + ".async_output_drop_when_full", pvt_output_parameters.async_output_drop_when_full);
+
+    // Receiver state snapshot for warm starts
+    pvt_output_parameters.snapshot_file = configuration->property(role + ".snapshot_file", pvt_output_parameters.snapshot_file);
+    pvt_output_parameters.snapshot_rate_ms = configuration->property(role + ".snapshot_rate_ms", pvt_output_parameters.snapshot_rate_ms);
+    if (pvt_output_parameters.snapshot_rate_ms < 0)
+        {
+            pvt_output_parameters.snapshot_rate_ms = 0;
+        }
+
     // make PVT object
     pvt_ = rtklib_make_pvt_gs(in_streams_, pvt_output_parameters, rtk);
     DLOG(INFO) << "pvt(" << pvt_->unique_id() << ")";
@@ -44,10 +44,12 @@
 #include "gps_utc_model.h"
 #include "gpx_printer.h"
 #include "kml_printer.h"
+#include "latency_tracer.h"
 #include "monitor_pvt.h"
 #include "monitor_pvt_udp_sink.h"
 #include "nmea_printer.h"
 #include "pvt_conf.h"
+#include "receiver_state_snapshot.h"
 #include "rinex_printer.h"
 #include "rtcm_printer.h"
 #include "rtklib_solver.h"
@@ -74,6 +76,7 @@
 #include <stdexcept>                    // for length_error
 #include <sys/ipc.h>                    // for IPC_CREAT
 #include <sys/msg.h>                    // for msgctl
+#include <utility>                      // for move
 
 #if HAS_STD_FILESYSTEM
 #include <system_error>
@@ -122,17 +125,10 @@ rtklib_pvt_gs::rtklib_pvt_gs(uint32_t nchannels,
     // Send PVT status to gnss_flowgraph
     this->message_port_register_out(pmt::mp("status"));
 
-    mapStringValues_["1C"] = evGPS_1C;
-    mapStringValues_["2S"] = evGPS_2S;
-    mapStringValues_["L5"] = evGPS_L5;
-    mapStringValues_["1B"] = evGAL_1B;
-    mapStringValues_["5X"] = evGAL_5X;
-    mapStringValues_["1G"] = evGLO_1G;
-    mapStringValues_["2G"] = evGLO_2G;
-    mapStringValues_["B1"] = evBDS_B1;
-    mapStringValues_["B2"] = evBDS_B2;
-    mapStringValues_["B3"] = evBDS_B3;
-
+    // storage for the observables of all the channels is reserved here, so that work() does not allocate memory
+    d_observables = Observables_Epoch(nchannels);
+    d_observables_t0 = Observables_Epoch(nchannels);
+    d_observables_t1 = Observables_Epoch(nchannels);
 
     initial_carrier_phase_offset_estimation_rads = std::vector<double>(nchannels, 0.0);
     channel_initialized = std::vector<bool>(nchannels, false);
@@ -389,6 +385,10 @@ rtklib_pvt_gs::rtklib_pvt_gs(uint32_t nchannels,
             xml_base_path = xml_base_path + fs::path::preferred_separator;
         }
 
+    // Receiver state snapshot
+    d_snapshot_file = conf_.snapshot_file;
+    d_snapshot_rate_ms = conf_.snapshot_rate_ms;
+
     d_rx_time = 0.0;
     d_last_status_print_seg = 0;
 
@@ -483,30 +483,66 @@ rtklib_pvt_gs::rtklib_pvt_gs(uint32_t nchannels,
             d_user_pvt_solver = d_internal_pvt_solver;
         }
 
+    // Output writers (files and RTCM server)
+    if (conf_.async_output)
+        {
+            // the writers run in their own thread and work on snapshots of the user solver,
+            // so that slow disks or network links do not delay the PVT computation
+            // one snapshot of the user solver per queue slot
+            std::vector<Pvt_Output_Record> records(conf_.async_output_queue_size == 0 ? 1 : conf_.async_output_queue_size);
+            for (auto& record : records)
+                {
+                    record.pvt_solver = std::make_shared<Rtklib_Solver>(static_cast<int32_t>(nchannels), std::string(""), false, false, rtk);
+                }
+            auto write = [this](Pvt_Output_Record& record) { write_output_record(record); };
+            d_output_sink = std::unique_ptr<Pvt_Output_Sink<Pvt_Output_Record>>(new Pvt_Output_Sink<Pvt_Output_Record>(std::move(records), conf_.async_output_drop_when_full, write));
+        }
+    else
+        {
+            d_output_record.pvt_solver = d_user_pvt_solver;
+        }
+
     start = std::chrono::system_clock::now();
 }
 
 
 rtklib_pvt_gs::~rtklib_pvt_gs()
 {
+    if (d_output_sink)
+        {
+            LOG(INFO) << "PVT output sink: " << d_output_sink->get_written() << " records written, "
+                      << d_output_sink->get_dropped() << " dropped, " << d_output_sink->get_blocked()
+                      << " blocked, maximum queue depth " << d_output_sink->get_max_depth();
+            // write the pending outputs before the printers are destroyed
+            d_output_sink.reset();
+        }
     if (sysv_msqid != -1)
         {
             msgctl(sysv_msqid, IPC_RMID, nullptr);
         }
+    if (!d_snapshot_file.empty())
+        {
+            // do not replace a previous snapshot if nothing was decoded in this run
+            const std::shared_ptr<Receiver_State_Snapshot> snapshot = take_state_snapshot();
+            if (snapshot->has_navigation_data() and snapshot->save(d_snapshot_file))
+                {
+                    LOG(INFO) << "Receiver state saved to " << d_snapshot_file;
+                }
+        }
     try
         {
             if (d_xml_storage)
                 {
                     // save GPS L2CM ephemeris to XML file
                     std::string file_name = xml_base_path + "gps_cnav_ephemeris.xml";
-                    if (d_internal_pvt_solver->gps_cnav_ephemeris_map.empty() == false)
+                    if (d_internal_pvt_solver->get_gps_cnav_ephemeris_map().empty() == false)
                         {
                             std::ofstream ofs;
                             try
                                 {
                                     ofs.open(file_name.c_str(), std::ofstream::trunc | std::ofstream::out);
                                     boost::archive::xml_oarchive xml(ofs);
-                                    xml << boost::serialization::make_nvp("GNSS-SDR_cnav_ephemeris_map", d_internal_pvt_solver->gps_cnav_ephemeris_map);
+                                    xml << boost::serialization::make_nvp("GNSS-SDR_cnav_ephemeris_map", d_internal_pvt_solver->get_gps_cnav_ephemeris_map());
                                     LOG(INFO) << "Saved GPS L2CM or L5 Ephemeris map data";
                                 }
                             catch (const boost::archive::archive_exception& e)
@@ -525,14 +561,14 @@ rtklib_pvt_gs::~rtklib_pvt_gs()
 
                     // save GPS L1 CA ephemeris to XML file
                     file_name = xml_base_path + "gps_ephemeris.xml";
-                    if (d_internal_pvt_solver->gps_ephemeris_map.empty() == false)
+                    if (d_internal_pvt_solver->get_gps_ephemeris_map().empty() == false)
                         {
                             std::ofstream ofs;
                             try
                                 {
                                     ofs.open(file_name.c_str(), std::ofstream::trunc | std::ofstream::out);
                                     boost::archive::xml_oarchive xml(ofs);
-                                    xml << boost::serialization::make_nvp("GNSS-SDR_ephemeris_map", d_internal_pvt_solver->gps_ephemeris_map);
+                                    xml << boost::serialization::make_nvp("GNSS-SDR_ephemeris_map", d_internal_pvt_solver->get_gps_ephemeris_map());
                                     LOG(INFO) << "Saved GPS L1 CA Ephemeris map data";
                                 }
                             catch (const boost::archive::archive_exception& e)
@@ -551,14 +587,14 @@ rtklib_pvt_gs::~rtklib_pvt_gs()
 
                     // save Galileo E1 ephemeris to XML file
                     file_name = xml_base_path + "gal_ephemeris.xml";
-                    if (d_internal_pvt_solver->galileo_ephemeris_map.empty() == false)
+                    if (d_internal_pvt_solver->get_galileo_ephemeris_map().empty() == false)
                         {
                             std::ofstream ofs;
                             try
                                 {
                                     ofs.open(file_name.c_str(), std::ofstream::trunc | std::ofstream::out);
                                     boost::archive::xml_oarchive xml(ofs);
-                                    xml << boost::serialization::make_nvp("GNSS-SDR_gal_ephemeris_map", d_internal_pvt_solver->galileo_ephemeris_map);
+                                    xml << boost::serialization::make_nvp("GNSS-SDR_gal_ephemeris_map", d_internal_pvt_solver->get_galileo_ephemeris_map());
                                     LOG(INFO) << "Saved Galileo E1 Ephemeris map data";
                                 }
                             catch (const boost::archive::archive_exception& e)
@@ -581,14 +617,14 @@ rtklib_pvt_gs::~rtklib_pvt_gs()
 
                     // save GLONASS GNAV ephemeris to XML file
                     file_name = xml_base_path + "eph_GLONASS_GNAV.xml";
-                    if (d_internal_pvt_solver->glonass_gnav_ephemeris_map.empty() == false)
+                    if (d_internal_pvt_solver->get_glonass_gnav_ephemeris_map().empty() == false)
                         {
                             std::ofstream ofs;
                             try
                                 {
                                     ofs.open(file_name.c_str(), std::ofstream::trunc | std::ofstream::out);
                                     boost::archive::xml_oarchive xml(ofs);
-                                    xml << boost::serialization::make_nvp("GNSS-SDR_gnav_ephemeris_map", d_internal_pvt_solver->glonass_gnav_ephemeris_map);
+                                    xml << boost::serialization::make_nvp("GNSS-SDR_gnav_ephemeris_map", d_internal_pvt_solver->get_glonass_gnav_ephemeris_map());
                                     LOG(INFO) << "Saved GLONASS GNAV Ephemeris map data";
                                 }
                             catch (const boost::archive::archive_exception& e)
@@ -851,14 +887,14 @@ rtklib_pvt_gs::~rtklib_pvt_gs()
 
                     // save GLONASS GNAV ephemeris to XML file
                     file_name = xml_base_path + "glo_gnav_ephemeris.xml";
-                    if (d_internal_pvt_solver->glonass_gnav_ephemeris_map.empty() == false)
+                    if (d_internal_pvt_solver->get_glonass_gnav_ephemeris_map().empty() == false)
                         {
                             std::ofstream ofs;
                             try
                                 {
                                     ofs.open(file_name.c_str(), std::ofstream::trunc | std::ofstream::out);
                                     boost::archive::xml_oarchive xml(ofs);
-                                    xml << boost::serialization::make_nvp("GNSS-SDR_gnav_ephemeris_map", d_internal_pvt_solver->glonass_gnav_ephemeris_map);
+                                    xml << boost::serialization::make_nvp("GNSS-SDR_gnav_ephemeris_map", d_internal_pvt_solver->get_glonass_gnav_ephemeris_map());
                                     LOG(INFO) << "Saved GLONASS GNAV ephemeris map data";
                                 }
                             catch (const boost::archive::archive_exception& e)
@@ -911,14 +947,14 @@ rtklib_pvt_gs::~rtklib_pvt_gs()
 
                     // save BeiDou DNAV ephemeris to XML file
                     file_name = xml_base_path + "bds_dnav_ephemeris.xml";
-                    if (d_internal_pvt_solver->beidou_dnav_ephemeris_map.empty() == false)
+                    if (d_internal_pvt_solver->get_beidou_dnav_ephemeris_map().empty() == false)
                         {
                             std::ofstream ofs;
                             try
                                 {
                                     ofs.open(file_name.c_str(), std::ofstream::trunc | std::ofstream::out);
                                     boost::archive::xml_oarchive xml(ofs);
-                                    xml << boost::serialization::make_nvp("GNSS-SDR_bds_dnav_ephemeris_map", d_internal_pvt_solver->beidou_dnav_ephemeris_map);
+                                    xml << boost::serialization::make_nvp("GNSS-SDR_bds_dnav_ephemeris_map", d_internal_pvt_solver->get_beidou_dnav_ephemeris_map());
                                     LOG(INFO) << "Saved BeiDou DNAV Ephemeris map data";
                                 }
                             catch (const boost::archive::archive_exception& e)
@@ -1053,16 +1089,16 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                                << "inserted with Toe=" << gps_eph->d_Toe << " and GPS Week="
                                << gps_eph->i_GPS_week;
                     // update/insert new ephemeris record to the global ephemeris map
-                    if (b_rinex_header_written)  // The header is already written, we can now log the navigation message data
+                    if (b_rinex_output_enabled)
                         {
                             bool new_annotation = false;
-                            if (d_internal_pvt_solver->gps_ephemeris_map.find(gps_eph->i_satellite_PRN) == d_internal_pvt_solver->gps_ephemeris_map.cend())
+                            if (d_internal_pvt_solver->get_gps_ephemeris_map().find(gps_eph->i_satellite_PRN) == d_internal_pvt_solver->get_gps_ephemeris_map().cend())
                                 {
                                     new_annotation = true;
                                 }
                             else
                                 {
-                                    if (d_internal_pvt_solver->gps_ephemeris_map[gps_eph->i_satellite_PRN].d_Toe != gps_eph->d_Toe)
+                                    if (d_internal_pvt_solver->get_gps_ephemeris_map().at(gps_eph->i_satellite_PRN).d_Toe != gps_eph->d_Toe)
                                         {
                                             new_annotation = true;
                                         }
@@ -1070,68 +1106,19 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                             if (new_annotation == true)
                                 {
                                     // New record!
-                                    std::map<int32_t, Gps_Ephemeris> new_eph;
-                                    std::map<int32_t, Galileo_Ephemeris> new_gal_eph;
-                                    std::map<int32_t, Glonass_Gnav_Ephemeris> new_glo_eph;
-                                    new_eph[gps_eph->i_satellite_PRN] = *gps_eph;
-                                    switch (type_of_rx)
-                                        {
-                                        case 1:  // GPS L1 C/A only
-                                            rp->log_rinex_nav(rp->navFile, new_eph);
-                                            break;
-                                        case 8:  // L1+L5
-                                            rp->log_rinex_nav(rp->navFile, new_eph);
-                                            break;
-                                        case 9:  // GPS L1 C/A + Galileo E1B
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 10:  // GPS L1 C/A + Galileo E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 11:  // GPS L1 C/A + Galileo E5b
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 26:  // GPS L1 C/A + GLONASS L1 C/A
-                                            if (d_rinex_version == 3)
-                                                {
-                                                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
-                                                }
-                                            if (d_rinex_version == 2)
-                                                {
-                                                    rp->log_rinex_nav(rp->navFile, new_glo_eph);
-                                                }
-                                            break;
-                                        case 29:  // GPS L1 C/A + GLONASS L2 C/A
-                                            if (d_rinex_version == 3)
-                                                {
-                                                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
-                                                }
-                                            if (d_rinex_version == 2)
-                                                {
-                                                    rp->log_rinex_nav(rp->navFile, new_eph);
-                                                }
-                                            break;
-                                        case 32:  // L1+E1+L5+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 33:  // L1+E1+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 1000:  // L1+L2+L5
-                                            rp->log_rinex_nav(rp->navFile, new_eph);
-                                            break;
-                                        case 1001:  // L1+E1+L2+L5+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        default:
-                                            break;
+                                    Pvt_Output_Record* record = acquire_output_record();
+                                    if (record != nullptr)
+                                        {
+                                            record->kind = Pvt_Output_Record::Gps_Navigation;
+                                            record->gps_ephemeris[gps_eph->i_satellite_PRN] = *gps_eph;
+                                            commit_output_record(*record);
                                         }
                                 }
                         }
-                    d_internal_pvt_solver->gps_ephemeris_map[gps_eph->i_satellite_PRN] = *gps_eph;
+                    d_internal_pvt_solver->set_ephemeris(*gps_eph);
                     if (d_enable_rx_clock_correction == true)
                         {
-                            d_user_pvt_solver->gps_ephemeris_map[gps_eph->i_satellite_PRN] = *gps_eph;
+                            d_user_pvt_solver->set_ephemeris(*gps_eph);
                         }
                 }
             else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Iono>))
@@ -1140,9 +1127,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Gps_Iono> gps_iono;
                     gps_iono = boost::any_cast<std::shared_ptr<Gps_Iono>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->gps_iono = *gps_iono;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->gps_iono = *gps_iono;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New IONO record has arrived ";
                 }
@@ -1152,9 +1141,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Gps_Utc_Model> gps_utc_model;
                     gps_utc_model = boost::any_cast<std::shared_ptr<Gps_Utc_Model>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->gps_utc_model = *gps_utc_model;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->gps_utc_model = *gps_utc_model;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New UTC record has arrived ";
                 }
@@ -1164,16 +1155,16 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Gps_CNAV_Ephemeris> gps_cnav_ephemeris;
                     gps_cnav_ephemeris = boost::any_cast<std::shared_ptr<Gps_CNAV_Ephemeris>>(pmt::any_ref(msg));
                     // update/insert new ephemeris record to the global ephemeris map
-                    if (b_rinex_header_written)  // The header is already written, we can now log the navigation message data
+                    if (b_rinex_output_enabled)
                         {
                             bool new_annotation = false;
-                            if (d_internal_pvt_solver->gps_cnav_ephemeris_map.find(gps_cnav_ephemeris->i_satellite_PRN) == d_internal_pvt_solver->gps_cnav_ephemeris_map.cend())
+                            if (d_internal_pvt_solver->get_gps_cnav_ephemeris_map().find(gps_cnav_ephemeris->i_satellite_PRN) == d_internal_pvt_solver->get_gps_cnav_ephemeris_map().cend())
                                 {
                                     new_annotation = true;
                                 }
                             else
                                 {
-                                    if (d_internal_pvt_solver->gps_cnav_ephemeris_map[gps_cnav_ephemeris->i_satellite_PRN].d_Toe1 != gps_cnav_ephemeris->d_Toe1)
+                                    if (d_internal_pvt_solver->get_gps_cnav_ephemeris_map().at(gps_cnav_ephemeris->i_satellite_PRN).d_Toe1 != gps_cnav_ephemeris->d_Toe1)
                                         {
                                             new_annotation = true;
                                         }
@@ -1181,39 +1172,19 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                             if (new_annotation == true)
                                 {
                                     // New record!
-                                    std::map<int32_t, Galileo_Ephemeris> new_gal_eph;
-                                    std::map<int32_t, Gps_CNAV_Ephemeris> new_cnav_eph;
-                                    std::map<int32_t, Glonass_Gnav_Ephemeris> new_glo_eph;
-                                    new_cnav_eph[gps_cnav_ephemeris->i_satellite_PRN] = *gps_cnav_ephemeris;
-                                    switch (type_of_rx)
-                                        {
-                                        case 2:  // GPS L2C only
-                                            rp->log_rinex_nav(rp->navFile, new_cnav_eph);
-                                            break;
-                                        case 3:  // GPS L5 only
-                                            rp->log_rinex_nav(rp->navFile, new_cnav_eph);
-                                            break;
-                                        case 7:  // GPS L1 C/A + GPS L2C
-                                            rp->log_rinex_nav(rp->navFile, new_cnav_eph);
-                                            break;
-                                        case 13:  // L5+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_gal_eph);
-                                            break;
-                                        case 28:  // GPS L2C + GLONASS L1 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
-                                            break;
-                                        case 31:  // GPS L2C + GLONASS L2 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
-                                            break;
-                                        default:
-                                            break;
+                                    Pvt_Output_Record* record = acquire_output_record();
+                                    if (record != nullptr)
+                                        {
+                                            record->kind = Pvt_Output_Record::Gps_Cnav_Navigation;
+                                            record->gps_cnav_ephemeris[gps_cnav_ephemeris->i_satellite_PRN] = *gps_cnav_ephemeris;
+                                            commit_output_record(*record);
                                         }
                                 }
                         }
-                    d_internal_pvt_solver->gps_cnav_ephemeris_map[gps_cnav_ephemeris->i_satellite_PRN] = *gps_cnav_ephemeris;
+                    d_internal_pvt_solver->set_ephemeris(*gps_cnav_ephemeris);
                     if (d_enable_rx_clock_correction == true)
                         {
-                            d_user_pvt_solver->gps_cnav_ephemeris_map[gps_cnav_ephemeris->i_satellite_PRN] = *gps_cnav_ephemeris;
+                            d_user_pvt_solver->set_ephemeris(*gps_cnav_ephemeris);
                         }
                     DLOG(INFO) << "New GPS CNAV ephemeris record has arrived ";
                 }
@@ -1223,9 +1194,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Gps_CNAV_Iono> gps_cnav_iono;
                     gps_cnav_iono = boost::any_cast<std::shared_ptr<Gps_CNAV_Iono>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->gps_cnav_iono = *gps_cnav_iono;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->gps_cnav_iono = *gps_cnav_iono;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New CNAV IONO record has arrived ";
                 }
@@ -1235,8 +1208,10 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Gps_CNAV_Utc_Model> gps_cnav_utc_model;
                     gps_cnav_utc_model = boost::any_cast<std::shared_ptr<Gps_CNAV_Utc_Model>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->gps_cnav_utc_model = *gps_cnav_utc_model;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     {
                         d_user_pvt_solver->gps_cnav_utc_model = *gps_cnav_utc_model;
+                        d_user_pvt_solver->notify_nav_models_update();
                     }
                     DLOG(INFO) << "New CNAV UTC record has arrived ";
                 }
@@ -1265,16 +1240,16 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                                << ", GALILEO Week Number =" << galileo_eph->WN_5
                                << " and Ephemeris IOD = " << galileo_eph->IOD_ephemeris;
                     // update/insert new ephemeris record to the global ephemeris map
-                    if (b_rinex_header_written)  // The header is already written, we can now log the navigation message data
+                    if (b_rinex_output_enabled)
                         {
                             bool new_annotation = false;
-                            if (d_internal_pvt_solver->galileo_ephemeris_map.find(galileo_eph->i_satellite_PRN) == d_internal_pvt_solver->galileo_ephemeris_map.cend())
+                            if (d_internal_pvt_solver->get_galileo_ephemeris_map().find(galileo_eph->i_satellite_PRN) == d_internal_pvt_solver->get_galileo_ephemeris_map().cend())
                                 {
                                     new_annotation = true;
                                 }
                             else
                                 {
-                                    if (d_internal_pvt_solver->galileo_ephemeris_map[galileo_eph->i_satellite_PRN].t0e_1 != galileo_eph->t0e_1)
+                                    if (d_internal_pvt_solver->get_galileo_ephemeris_map().at(galileo_eph->i_satellite_PRN).t0e_1 != galileo_eph->t0e_1)
                                         {
                                             new_annotation = true;
                                         }
@@ -1282,61 +1257,19 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                             if (new_annotation == true)
                                 {
                                     // New record!
-                                    std::map<int32_t, Galileo_Ephemeris> new_gal_eph;
-                                    std::map<int32_t, Gps_CNAV_Ephemeris> new_cnav_eph;
-                                    std::map<int32_t, Gps_Ephemeris> new_eph;
-                                    std::map<int32_t, Glonass_Gnav_Ephemeris> new_glo_eph;
-                                    new_gal_eph[galileo_eph->i_satellite_PRN] = *galileo_eph;
-                                    switch (type_of_rx)
-                                        {
-                                        case 4:  // Galileo E1B only
-                                            rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
-                                            break;
-                                        case 5:  // Galileo E5a only
-                                            rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
-                                            break;
-                                        case 6:  // Galileo E5b only
-                                            rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
-                                            break;
-                                        case 9:  // GPS L1 C/A + Galileo E1B
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 10:  // GPS L1 C/A + Galileo E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 11:  // GPS L1 C/A + Galileo E5b
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 13:  // L5+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_gal_eph);
-                                            break;
-                                        case 15:  // Galileo E1B + Galileo E5b
-                                            rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
-                                            break;
-                                        case 27:  // Galileo E1B + GLONASS L1 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
-                                            break;
-                                        case 30:  // Galileo E1B + GLONASS L2 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
-                                            break;
-                                        case 32:  // L1+E1+L5+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 33:  // L1+E1+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        case 1001:  // L1+E1+L2+L5+E5a
-                                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
-                                            break;
-                                        default:
-                                            break;
+                                    Pvt_Output_Record* record = acquire_output_record();
+                                    if (record != nullptr)
+                                        {
+                                            record->kind = Pvt_Output_Record::Galileo_Navigation;
+                                            record->galileo_ephemeris[galileo_eph->i_satellite_PRN] = *galileo_eph;
+                                            commit_output_record(*record);
                                         }
                                 }
                         }
-                    d_internal_pvt_solver->galileo_ephemeris_map[galileo_eph->i_satellite_PRN] = *galileo_eph;
+                    d_internal_pvt_solver->set_ephemeris(*galileo_eph);
                     if (d_enable_rx_clock_correction == true)
                         {
-                            d_user_pvt_solver->galileo_ephemeris_map[galileo_eph->i_satellite_PRN] = *galileo_eph;
+                            d_user_pvt_solver->set_ephemeris(*galileo_eph);
                         }
                 }
             else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Iono>))
@@ -1345,9 +1278,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Galileo_Iono> galileo_iono;
                     galileo_iono = boost::any_cast<std::shared_ptr<Galileo_Iono>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->galileo_iono = *galileo_iono;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->galileo_iono = *galileo_iono;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New IONO record has arrived ";
                 }
@@ -1357,9 +1292,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Galileo_Utc_Model> galileo_utc_model;
                     galileo_utc_model = boost::any_cast<std::shared_ptr<Galileo_Utc_Model>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->galileo_utc_model = *galileo_utc_model;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->galileo_utc_model = *galileo_utc_model;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New UTC record has arrived ";
                 }
@@ -1425,16 +1362,16 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                                << " and Ephemeris IOD in UTC = " << glonass_gnav_eph->compute_GLONASS_time(glonass_gnav_eph->d_t_b)
                                << " from SV = " << glonass_gnav_eph->i_satellite_slot_number;
                     // update/insert new ephemeris record to the global ephemeris map
-                    if (b_rinex_header_written)  // The header is already written, we can now log the navigation message data
+                    if (b_rinex_output_enabled)
                         {
                             bool new_annotation = false;
-                            if (d_internal_pvt_solver->glonass_gnav_ephemeris_map.find(glonass_gnav_eph->i_satellite_PRN) == d_internal_pvt_solver->glonass_gnav_ephemeris_map.cend())
+                            if (d_internal_pvt_solver->get_glonass_gnav_ephemeris_map().find(glonass_gnav_eph->i_satellite_PRN) == d_internal_pvt_solver->get_glonass_gnav_ephemeris_map().cend())
                                 {
                                     new_annotation = true;
                                 }
                             else
                                 {
-                                    if (d_internal_pvt_solver->glonass_gnav_ephemeris_map[glonass_gnav_eph->i_satellite_PRN].d_t_b != glonass_gnav_eph->d_t_b)
+                                    if (d_internal_pvt_solver->get_glonass_gnav_ephemeris_map().at(glonass_gnav_eph->i_satellite_PRN).d_t_b != glonass_gnav_eph->d_t_b)
                                         {
                                             new_annotation = true;
                                         }
@@ -1442,63 +1379,19 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                             if (new_annotation == true)
                                 {
                                     // New record!
-                                    std::map<int32_t, Galileo_Ephemeris> new_gal_eph;
-                                    std::map<int32_t, Gps_CNAV_Ephemeris> new_cnav_eph;
-                                    std::map<int32_t, Gps_Ephemeris> new_eph;
-                                    std::map<int32_t, Glonass_Gnav_Ephemeris> new_glo_eph;
-                                    new_glo_eph[glonass_gnav_eph->i_satellite_PRN] = *glonass_gnav_eph;
-                                    switch (type_of_rx)
-                                        {
-                                        case 23:  // GLONASS L1 C/A
-                                            rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
-                                            break;
-                                        case 24:  // GLONASS L2 C/A
-                                            rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
-                                            break;
-                                        case 25:  // GLONASS L1 C/A + GLONASS L2 C/A
-                                            rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
-                                            break;
-                                        case 26:  // GPS L1 C/A + GLONASS L1 C/A
-                                            if (d_rinex_version == 3)
-                                                {
-                                                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
-                                                }
-                                            if (d_rinex_version == 2)
-                                                {
-                                                    rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
-                                                }
-                                            break;
-                                        case 27:  // Galileo E1B + GLONASS L1 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
-                                            break;
-                                        case 28:  // GPS L2C + GLONASS L1 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
-                                            break;
-                                        case 29:  // GPS L1 C/A + GLONASS L2 C/A
-                                            if (d_rinex_version == 3)
-                                                {
-                                                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
-                                                }
-                                            if (d_rinex_version == 2)
-                                                {
-                                                    rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
-                                                }
-                                            break;
-                                        case 30:  // Galileo E1B + GLONASS L2 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
-                                            break;
-                                        case 31:  // GPS L2C + GLONASS L2 C/A
-                                            rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
-                                            break;
-                                        default:
-                                            break;
+                                    Pvt_Output_Record* record = acquire_output_record();
+                                    if (record != nullptr)
+                                        {
+                                            record->kind = Pvt_Output_Record::Glonass_Navigation;
+                                            record->glonass_gnav_ephemeris[glonass_gnav_eph->i_satellite_PRN] = *glonass_gnav_eph;
+                                            commit_output_record(*record);
                                         }
                                 }
                         }
-                    d_internal_pvt_solver->glonass_gnav_ephemeris_map[glonass_gnav_eph->i_satellite_PRN] = *glonass_gnav_eph;
+                    d_internal_pvt_solver->set_ephemeris(*glonass_gnav_eph);
                     if (d_enable_rx_clock_correction == true)
                         {
-                            d_user_pvt_solver->glonass_gnav_ephemeris_map[glonass_gnav_eph->i_satellite_PRN] = *glonass_gnav_eph;
+                            d_user_pvt_solver->set_ephemeris(*glonass_gnav_eph);
                         }
                 }
             else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Glonass_Gnav_Utc_Model>))
@@ -1507,9 +1400,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Glonass_Gnav_Utc_Model> glonass_gnav_utc_model;
                     glonass_gnav_utc_model = boost::any_cast<std::shared_ptr<Glonass_Gnav_Utc_Model>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->glonass_gnav_utc_model = *glonass_gnav_utc_model;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->glonass_gnav_utc_model = *glonass_gnav_utc_model;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New GLONASS GNAV UTC record has arrived ";
                 }
@@ -1539,16 +1434,16 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                                << "inserted with Toe=" << bds_dnav_eph->d_Toe << " and BDS Week="
                                << bds_dnav_eph->i_BEIDOU_week;
                     // update/insert new ephemeris record to the global ephemeris map
-                    if (b_rinex_header_written)  // The header is already written, we can now log the navigation message data
+                    if (b_rinex_output_enabled)
                         {
                             bool new_annotation = false;
-                            if (d_internal_pvt_solver->beidou_dnav_ephemeris_map.find(bds_dnav_eph->i_satellite_PRN) == d_internal_pvt_solver->beidou_dnav_ephemeris_map.cend())
+                            if (d_internal_pvt_solver->get_beidou_dnav_ephemeris_map().find(bds_dnav_eph->i_satellite_PRN) == d_internal_pvt_solver->get_beidou_dnav_ephemeris_map().cend())
                                 {
                                     new_annotation = true;
                                 }
                             else
                                 {
-                                    if (d_internal_pvt_solver->beidou_dnav_ephemeris_map[bds_dnav_eph->i_satellite_PRN].d_Toc != bds_dnav_eph->d_Toc)
+                                    if (d_internal_pvt_solver->get_beidou_dnav_ephemeris_map().at(bds_dnav_eph->i_satellite_PRN).d_Toc != bds_dnav_eph->d_Toc)
                                         {
                                             new_annotation = true;
                                         }
@@ -1556,25 +1451,19 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                             if (new_annotation == true)
                                 {
                                     // New record!
-                                    std::map<int32_t, Beidou_Dnav_Ephemeris> new_bds_eph;
-                                    new_bds_eph[bds_dnav_eph->i_satellite_PRN] = *bds_dnav_eph;
-                                    switch (type_of_rx)
+                                    Pvt_Output_Record* record = acquire_output_record();
+                                    if (record != nullptr)
                                         {
-                                        case 500:  // BDS B1I only
-                                            rp->log_rinex_nav(rp->navFile, new_bds_eph);
-                                            break;
-                                        case 600:  // BDS B3I only
-                                            rp->log_rinex_nav(rp->navFile, new_bds_eph);
-                                            break;
-                                        default:
-                                            break;
+                                            record->kind = Pvt_Output_Record::Beidou_Navigation;
+                                            record->beidou_dnav_ephemeris[bds_dnav_eph->i_satellite_PRN] = *bds_dnav_eph;
+                                            commit_output_record(*record);
                                         }
                                 }
                         }
-                    d_internal_pvt_solver->beidou_dnav_ephemeris_map[bds_dnav_eph->i_satellite_PRN] = *bds_dnav_eph;
+                    d_internal_pvt_solver->set_ephemeris(*bds_dnav_eph);
                     if (d_enable_rx_clock_correction == true)
                         {
-                            d_user_pvt_solver->beidou_dnav_ephemeris_map[bds_dnav_eph->i_satellite_PRN] = *bds_dnav_eph;
+                            d_user_pvt_solver->set_ephemeris(*bds_dnav_eph);
                         }
                 }
             else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Beidou_Dnav_Iono>))
@@ -1583,9 +1472,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Beidou_Dnav_Iono> bds_dnav_iono;
                     bds_dnav_iono = boost::any_cast<std::shared_ptr<Beidou_Dnav_Iono>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->beidou_dnav_iono = *bds_dnav_iono;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->beidou_dnav_iono = *bds_dnav_iono;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New BeiDou DNAV IONO record has arrived ";
                 }
@@ -1595,9 +1486,11 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
                     std::shared_ptr<Beidou_Dnav_Utc_Model> bds_dnav_utc_model;
                     bds_dnav_utc_model = boost::any_cast<std::shared_ptr<Beidou_Dnav_Utc_Model>>(pmt::any_ref(msg));
                     d_internal_pvt_solver->beidou_dnav_utc_model = *bds_dnav_utc_model;
+                    d_internal_pvt_solver->notify_nav_models_update();
                     if (d_enable_rx_clock_correction == true)
                         {
                             d_user_pvt_solver->beidou_dnav_utc_model = *bds_dnav_utc_model;
+                            d_user_pvt_solver->notify_nav_models_update();
                         }
                     DLOG(INFO) << "New BeiDou DNAV UTC record has arrived ";
                 }
@@ -1627,7 +1520,7 @@ void rtklib_pvt_gs::msg_handler_telemetry(const pmt::pmt_t& msg)
 
 std::map<int, Gps_Ephemeris> rtklib_pvt_gs::get_gps_ephemeris_map() const
 {
-    return d_internal_pvt_solver->gps_ephemeris_map;
+    return d_internal_pvt_solver->get_gps_ephemeris_map();
 }
 
 
@@ -1639,7 +1532,7 @@ std::map<int, Gps_Almanac> rtklib_pvt_gs::get_gps_almanac_map() const
 
 std::map<int, Galileo_Ephemeris> rtklib_pvt_gs::get_galileo_ephemeris_map() const
 {
-    return d_internal_pvt_solver->galileo_ephemeris_map;
+    return d_internal_pvt_solver->get_galileo_ephemeris_map();
 }
 
 
@@ -1651,7 +1544,7 @@ std::map<int, Galileo_Almanac> rtklib_pvt_gs::get_galileo_almanac_map() const
 
 std::map<int, Beidou_Dnav_Ephemeris> rtklib_pvt_gs::get_beidou_dnav_ephemeris_map() const
 {
-    return d_internal_pvt_solver->beidou_dnav_ephemeris_map;
+    return d_internal_pvt_solver->get_beidou_dnav_ephemeris_map();
 }
 
 
@@ -1663,19 +1556,15 @@ std::map<int, Beidou_Dnav_Almanac> rtklib_pvt_gs::get_beidou_dnav_almanac_map()
 
 void rtklib_pvt_gs::clear_ephemeris()
 {
-    d_internal_pvt_solver->gps_ephemeris_map.clear();
+    d_internal_pvt_solver->clear_ephemeris();
     d_internal_pvt_solver->gps_almanac_map.clear();
-    d_internal_pvt_solver->galileo_ephemeris_map.clear();
     d_internal_pvt_solver->galileo_almanac_map.clear();
-    d_internal_pvt_solver->beidou_dnav_ephemeris_map.clear();
     d_internal_pvt_solver->beidou_dnav_almanac_map.clear();
     if (d_enable_rx_clock_correction == true)
         {
-            d_user_pvt_solver->gps_ephemeris_map.clear();
+            d_user_pvt_solver->clear_ephemeris();
             d_user_pvt_solver->gps_almanac_map.clear();
-            d_user_pvt_solver->galileo_ephemeris_map.clear();
             d_user_pvt_solver->galileo_almanac_map.clear();
-            d_user_pvt_solver->beidou_dnav_ephemeris_map.clear();
             d_user_pvt_solver->beidou_dnav_almanac_map.clear();
         }
 }
@@ -1703,6 +1592,7 @@ bool rtklib_pvt_gs::send_sys_v_ttff_msg(ttff_msgbuf ttff)
 
 bool rtklib_pvt_gs::save_gnss_synchro_map_xml(const std::string& file_name)
 {
+    d_observables.to_map(gnss_observables_map);
     if (gnss_observables_map.empty() == false)
         {
             std::ofstream ofs;
@@ -1802,288 +1692,2406 @@ bool rtklib_pvt_gs::get_latest_PVT(double* longitude_deg,
 }
 
 
-void rtklib_pvt_gs::apply_rx_clock_offset(std::map<int, Gnss_Synchro>& observables_map,
-    double rx_clock_offset_s)
+void rtklib_pvt_gs::initialize_and_apply_carrier_phase_offset()
+{
+    // we have a valid PVT. First check if we need to reset the initial carrier phase offsets to match their pseudoranges
+    for (auto& observable : d_observables)
+        {
+            Gnss_Synchro& gnss_synchro = observable.second;
+            // check if an initialization is required (new satellite or loss of lock)
+            // it is set to false by the work function if the gnss_synchro is not valid
+            if (channel_initialized.at(gnss_synchro.Channel_ID) == false)
+                {
+                    double wavelength_m = 0;
+                    const double freq_hz = Observables_Epoch::carrier_frequency_hz(Observables_Epoch::signal_id(gnss_synchro.Signal));
+                    if (freq_hz > 0.0)
+                        {
+                            wavelength_m = SPEED_OF_LIGHT / freq_hz;
+                        }
+                    double wrap_carrier_phase_rad = fmod(gnss_synchro.Carrier_phase_rads, PI_2);
+                    initial_carrier_phase_offset_estimation_rads.at(gnss_synchro.Channel_ID) = PI_2 * round(gnss_synchro.Pseudorange_m / wavelength_m) - gnss_synchro.Carrier_phase_rads + wrap_carrier_phase_rad;
+                    channel_initialized.at(gnss_synchro.Channel_ID) = true;
+                    DLOG(INFO) << "initialized carrier phase at channel " << gnss_synchro.Channel_ID;
+                }
+            // apply the carrier phase offset to this satellite
+            gnss_synchro.Carrier_phase_rads = gnss_synchro.Carrier_phase_rads + initial_carrier_phase_offset_estimation_rads.at(gnss_synchro.Channel_ID);
+        }
+}
+
+
+rtklib_pvt_gs::Pvt_Output_Record* rtklib_pvt_gs::acquire_output_record()
+{
+    if (d_output_sink)
+        {
+            return d_output_sink->acquire();
+        }
+    return &d_output_record;
+}
+
+
+void rtklib_pvt_gs::commit_output_record(Pvt_Output_Record& record)
+{
+    if (d_output_sink)
+        {
+            d_output_sink->commit();
+        }
+    else
+        {
+            write_output_record(record);
+        }
+}
+
+
+void rtklib_pvt_gs::write_output_record(Pvt_Output_Record& record)
 {
-    // apply corrections according to Rinex 3.04, Table 1: Observation Corrections for Receiver Clock Offset
-    std::map<int, Gnss_Synchro>::iterator observables_iter;
+    switch (record.kind)
+        {
+        case Pvt_Output_Record::Epoch:
+            write_outputs(record);
+            break;
+        case Pvt_Output_Record::Monitor:
+            udp_sink_ptr->write_monitor_pvt(record.monitor_pvt);
+            break;
+        case Pvt_Output_Record::Snapshot:
+            record.snapshot->save(d_snapshot_file);
+            record.snapshot.reset();
+            break;
+        default:
+            write_rinex_nav(record);
+            // the maps of the other systems must be empty when the record is reused
+            record.gps_ephemeris.clear();
+            record.gps_cnav_ephemeris.clear();
+            record.galileo_ephemeris.clear();
+            record.glonass_gnav_ephemeris.clear();
+            record.beidou_dnav_ephemeris.clear();
+            break;
+        }
+}
+
 
-    for (observables_iter = observables_map.begin(); observables_iter != observables_map.end(); observables_iter++)
+std::shared_ptr<Receiver_State_Snapshot> rtklib_pvt_gs::take_state_snapshot() const
+{
+    auto snapshot = std::make_shared<Receiver_State_Snapshot>();
+    snapshot->utc_time_s = std::time(nullptr);
+    if (d_user_pvt_solver->is_valid_position())
+        {
+            snapshot->position_valid = true;
+            snapshot->latitude_deg = d_user_pvt_solver->get_latitude();
+            snapshot->longitude_deg = d_user_pvt_solver->get_longitude();
+            snapshot->height_m = d_user_pvt_solver->get_height();
+            snapshot->position_utc_time_s = convert_to_time_t(d_user_pvt_solver->get_position_UTC_time());
+            snapshot->rx_clock_offset_s = d_user_pvt_solver->get_time_offset_s();
+            snapshot->rx_clock_drift_ppm = d_user_pvt_solver->get_clock_drift_ppm();
+        }
+    for (const auto& observable : d_observables)
         {
-            // all observables in the map are valid
-            observables_iter->second.RX_time -= rx_clock_offset_s;
-            observables_iter->second.Pseudorange_m -= rx_clock_offset_s * SPEED_OF_LIGHT;
+            const Gnss_Synchro& gnss_synchro = observable.second;
+            switch (Observables_Epoch::signal_id(gnss_synchro.Signal))
+                {
+                case Observables_Epoch::evGPS_1C:
+                    snapshot->gps_doppler_hz[gnss_synchro.PRN] = gnss_synchro.Carrier_Doppler_hz;
+                    break;
+                case Observables_Epoch::evGAL_1B:
+                    snapshot->galileo_doppler_hz[gnss_synchro.PRN] = gnss_synchro.Carrier_Doppler_hz;
+                    break;
+                case Observables_Epoch::evGLO_1G:
+                    snapshot->glonass_doppler_hz[gnss_synchro.PRN] = gnss_synchro.Carrier_Doppler_hz;
+                    break;
+                case Observables_Epoch::evBDS_B1:
+                    snapshot->beidou_doppler_hz[gnss_synchro.PRN] = gnss_synchro.Carrier_Doppler_hz;
+                    break;
+                default:
+                    break;
+                }
+        }
+    // the ephemeris and models received from the telemetry decoders are all stored in the internal solver
+    snapshot->gps_ephemeris_map = d_internal_pvt_solver->get_gps_ephemeris_map();
+    snapshot->gps_cnav_ephemeris_map = d_internal_pvt_solver->get_gps_cnav_ephemeris_map();
+    snapshot->galileo_ephemeris_map = d_internal_pvt_solver->get_galileo_ephemeris_map();
+    snapshot->glonass_gnav_ephemeris_map = d_internal_pvt_solver->get_glonass_gnav_ephemeris_map();
+    snapshot->beidou_dnav_ephemeris_map = d_internal_pvt_solver->get_beidou_dnav_ephemeris_map();
+    snapshot->gps_almanac_map = d_internal_pvt_solver->gps_almanac_map;
+    snapshot->galileo_almanac_map = d_internal_pvt_solver->galileo_almanac_map;
+    snapshot->beidou_dnav_almanac_map = d_internal_pvt_solver->beidou_dnav_almanac_map;
+    snapshot->glonass_gnav_almanac = d_internal_pvt_solver->glonass_gnav_almanac;
+    snapshot->gps_iono = d_internal_pvt_solver->gps_iono;
+    snapshot->gps_utc_model = d_internal_pvt_solver->gps_utc_model;
+    snapshot->gps_cnav_iono = d_internal_pvt_solver->gps_cnav_iono;
+    snapshot->gps_cnav_utc_model = d_internal_pvt_solver->gps_cnav_utc_model;
+    snapshot->galileo_iono = d_internal_pvt_solver->galileo_iono;
+    snapshot->galileo_utc_model = d_internal_pvt_solver->galileo_utc_model;
+    snapshot->glonass_gnav_utc_model = d_internal_pvt_solver->glonass_gnav_utc_model;
+    snapshot->beidou_dnav_iono = d_internal_pvt_solver->beidou_dnav_iono;
+    snapshot->beidou_dnav_utc_model = d_internal_pvt_solver->beidou_dnav_utc_model;
+    return snapshot;
+}
+
 
-            switch (mapStringValues_[observables_iter->second.Signal])
+void rtklib_pvt_gs::write_rinex_nav(const Pvt_Output_Record& record)
+{
+    if (!b_rinex_header_written)
+        {
+            // the navigation message data is logged once the header is written
+            return;
+        }
+    const std::map<int32_t, Gps_Ephemeris>& new_eph = record.gps_ephemeris;
+    const std::map<int32_t, Gps_CNAV_Ephemeris>& new_cnav_eph = record.gps_cnav_ephemeris;
+    const std::map<int32_t, Galileo_Ephemeris>& new_gal_eph = record.galileo_ephemeris;
+    const std::map<int32_t, Glonass_Gnav_Ephemeris>& new_glo_eph = record.glonass_gnav_ephemeris;
+    const std::map<int32_t, Beidou_Dnav_Ephemeris>& new_bds_eph = record.beidou_dnav_ephemeris;
+    switch (record.kind)
+        {
+        case Pvt_Output_Record::Gps_Navigation:
+            switch (type_of_rx)
+                {
+                case 1:  // GPS L1 C/A only
+                    rp->log_rinex_nav(rp->navFile, new_eph);
+                    break;
+                case 8:  // L1+L5
+                    rp->log_rinex_nav(rp->navFile, new_eph);
+                    break;
+                case 9:  // GPS L1 C/A + Galileo E1B
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 10:  // GPS L1 C/A + Galileo E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 11:  // GPS L1 C/A + Galileo E5b
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 26:  // GPS L1 C/A + GLONASS L1 C/A
+                    if (d_rinex_version == 3)
+                        {
+                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
+                        }
+                    if (d_rinex_version == 2)
+                        {
+                            rp->log_rinex_nav(rp->navFile, new_glo_eph);
+                        }
+                    break;
+                case 29:  // GPS L1 C/A + GLONASS L2 C/A
+                    if (d_rinex_version == 3)
+                        {
+                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
+                        }
+                    if (d_rinex_version == 2)
+                        {
+                            rp->log_rinex_nav(rp->navFile, new_eph);
+                        }
+                    break;
+                case 32:  // L1+E1+L5+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 33:  // L1+E1+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 1000:  // L1+L2+L5
+                    rp->log_rinex_nav(rp->navFile, new_eph);
+                    break;
+                case 1001:  // L1+E1+L2+L5+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                default:
+                    break;
+                }
+            break;
+        case Pvt_Output_Record::Gps_Cnav_Navigation:
+            switch (type_of_rx)
+                {
+                case 2:  // GPS L2C only
+                    rp->log_rinex_nav(rp->navFile, new_cnav_eph);
+                    break;
+                case 3:  // GPS L5 only
+                    rp->log_rinex_nav(rp->navFile, new_cnav_eph);
+                    break;
+                case 7:  // GPS L1 C/A + GPS L2C
+                    rp->log_rinex_nav(rp->navFile, new_cnav_eph);
+                    break;
+                case 13:  // L5+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_gal_eph);
+                    break;
+                case 28:  // GPS L2C + GLONASS L1 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
+                    break;
+                case 31:  // GPS L2C + GLONASS L2 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
+                    break;
+                default:
+                    break;
+                }
+            break;
+        case Pvt_Output_Record::Galileo_Navigation:
+            switch (type_of_rx)
+                {
+                case 4:  // Galileo E1B only
+                    rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
+                    break;
+                case 5:  // Galileo E5a only
+                    rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
+                    break;
+                case 6:  // Galileo E5b only
+                    rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
+                    break;
+                case 9:  // GPS L1 C/A + Galileo E1B
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 10:  // GPS L1 C/A + Galileo E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 11:  // GPS L1 C/A + Galileo E5b
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 13:  // L5+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_gal_eph);
+                    break;
+                case 15:  // Galileo E1B + Galileo E5b
+                    rp->log_rinex_nav(rp->navGalFile, new_gal_eph);
+                    break;
+                case 27:  // Galileo E1B + GLONASS L1 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
+                    break;
+                case 30:  // Galileo E1B + GLONASS L2 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
+                    break;
+                case 32:  // L1+E1+L5+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 33:  // L1+E1+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                case 1001:  // L1+E1+L2+L5+E5a
+                    rp->log_rinex_nav(rp->navMixFile, new_eph, new_gal_eph);
+                    break;
+                default:
+                    break;
+                }
+            break;
+        case Pvt_Output_Record::Glonass_Navigation:
+            switch (type_of_rx)
                 {
-                case evGPS_1C:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ1 * PI_2;
+                case 23:  // GLONASS L1 C/A
+                    rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
                     break;
-                case evGPS_L5:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ5 * PI_2;
+                case 24:  // GLONASS L2 C/A
+                    rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
                     break;
-                case evSBAS_1C:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ1 * PI_2;
+                case 25:  // GLONASS L1 C/A + GLONASS L2 C/A
+                    rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
+                    break;
+                case 26:  // GPS L1 C/A + GLONASS L1 C/A
+                    if (d_rinex_version == 3)
+                        {
+                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
+                        }
+                    if (d_rinex_version == 2)
+                        {
+                            rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
+                        }
                     break;
-                case evGAL_1B:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ1 * PI_2;
+                case 27:  // Galileo E1B + GLONASS L1 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
                     break;
-                case evGAL_5X:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ5 * PI_2;
+                case 28:  // GPS L2C + GLONASS L1 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
                     break;
-                case evGPS_2S:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ2 * PI_2;
+                case 29:  // GPS L1 C/A + GLONASS L2 C/A
+                    if (d_rinex_version == 3)
+                        {
+                            rp->log_rinex_nav(rp->navMixFile, new_eph, new_glo_eph);
+                        }
+                    if (d_rinex_version == 2)
+                        {
+                            rp->log_rinex_nav(rp->navGloFile, new_glo_eph);
+                        }
                     break;
-                case evBDS_B3:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ3_BDS * PI_2;
+                case 30:  // Galileo E1B + GLONASS L2 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_gal_eph, new_glo_eph);
                     break;
-                case evGLO_1G:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ1_GLO * PI_2;
+                case 31:  // GPS L2C + GLONASS L2 C/A
+                    rp->log_rinex_nav(rp->navMixFile, new_cnav_eph, new_glo_eph);
                     break;
-                case evGLO_2G:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ2_GLO * PI_2;
+                default:
                     break;
-                case evBDS_B1:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ1_BDS * PI_2;
+                }
+            break;
+        case Pvt_Output_Record::Beidou_Navigation:
+            switch (type_of_rx)
+                {
+                case 500:  // BDS B1I only
+                    rp->log_rinex_nav(rp->navFile, new_bds_eph);
                     break;
-                case evBDS_B2:
-                    observables_iter->second.Carrier_phase_rads -= rx_clock_offset_s * FREQ2_BDS * PI_2;
+                case 600:  // BDS B3I only
+                    rp->log_rinex_nav(rp->navFile, new_bds_eph);
                     break;
                 default:
                     break;
                 }
+            break;
+        default:
+            break;
         }
 }
 
-
-std::map<int, Gnss_Synchro> rtklib_pvt_gs::interpolate_observables(std::map<int, Gnss_Synchro>& observables_map_t0,
-    std::map<int, Gnss_Synchro>& observables_map_t1,
-    double rx_time_s)
+void rtklib_pvt_gs::write_outputs(const Pvt_Output_Record& output)
 {
-    std::map<int, Gnss_Synchro> interp_observables_map;
-    // Linear interpolation: y(t) = y(t0) + (y(t1) - y(t0)) * (t - t0) / (t1 - t0)
+    const std::shared_ptr<Rtklib_Solver>& pvt_solver = output.pvt_solver;
+    const std::map<int, Gnss_Synchro>& observables_map = output.observables_map;
+    const double rx_time = output.rx_time;
+    const uint32_t rx_time_ms = output.rx_time_ms;
 
-    // check TOW rollover
-    double time_factor;
-    if ((observables_map_t1.cbegin()->second.RX_time -
-            observables_map_t0.cbegin()->second.RX_time) > 0)
+    if (d_kml_output_enabled)
         {
-            time_factor = (rx_time_s - observables_map_t0.cbegin()->second.RX_time) /
-                          (observables_map_t1.cbegin()->second.RX_time -
-                              observables_map_t0.cbegin()->second.RX_time);
+            if (rx_time_ms % d_kml_rate_ms == 0)
+                {
+                    d_kml_dump->print_position(pvt_solver, false);
+                }
         }
-    else
+    if (d_gpx_output_enabled)
         {
-            // TOW rollover situation
-            time_factor = (604800000.0 + rx_time_s - observables_map_t0.cbegin()->second.RX_time) /
-                          (604800000.0 + observables_map_t1.cbegin()->second.RX_time -
-                              observables_map_t0.cbegin()->second.RX_time);
+            if (rx_time_ms % d_gpx_rate_ms == 0)
+                {
+                    d_gpx_dump->print_position(pvt_solver, false);
+                }
         }
-
-    std::map<int, Gnss_Synchro>::const_iterator observables_iter;
-    for (observables_iter = observables_map_t0.cbegin(); observables_iter != observables_map_t0.cend(); observables_iter++)
+    if (d_geojson_output_enabled)
         {
-            // 1. Check if the observable exist in t0 and t1
-            // the map key is the channel ID (see work())
-            try
+            if (rx_time_ms % d_geojson_rate_ms == 0)
                 {
-                    if (observables_map_t1.at(observables_iter->first).PRN == observables_iter->second.PRN)
-                        {
-                            interp_observables_map.insert(std::pair<int, Gnss_Synchro>(observables_iter->first, observables_iter->second));
-                            interp_observables_map.at(observables_iter->first).RX_time = rx_time_s;  // interpolation point
-                            interp_observables_map.at(observables_iter->first).Pseudorange_m += (observables_map_t1.at(observables_iter->first).Pseudorange_m - observables_iter->second.Pseudorange_m) * time_factor;
-                            interp_observables_map.at(observables_iter->first).Carrier_phase_rads += (observables_map_t1.at(observables_iter->first).Carrier_phase_rads - observables_iter->second.Carrier_phase_rads) * time_factor;
-                            interp_observables_map.at(observables_iter->first).Carrier_Doppler_hz += (observables_map_t1.at(observables_iter->first).Carrier_Doppler_hz - observables_iter->second.Carrier_Doppler_hz) * time_factor;
-                        }
+                    d_geojson_printer->print_position(pvt_solver, false);
                 }
-            catch (const std::out_of_range& oor)
+        }
+    if (d_nmea_output_file_enabled)
+        {
+            if (rx_time_ms % d_nmea_rate_ms == 0)
                 {
-                    // observable does not exist in t1
+                    d_nmea_printer->Print_Nmea_Line(pvt_solver, false);
                 }
         }
-    return interp_observables_map;
-}
-
 
-void rtklib_pvt_gs::initialize_and_apply_carrier_phase_offset()
-{
-    // we have a valid PVT. First check if we need to reset the initial carrier phase offsets to match their pseudoranges
-    std::map<int, Gnss_Synchro>::iterator observables_iter;
-    for (observables_iter = gnss_observables_map.begin(); observables_iter != gnss_observables_map.end(); observables_iter++)
+    /*
+     *   TYPE  |  RECEIVER
+     *     0   |  Unknown
+     *     1   |  GPS L1 C/A
+     *     2   |  GPS L2C
+     *     3   |  GPS L5
+     *     4   |  Galileo E1B
+     *     5   |  Galileo E5a
+     *     6   |  Galileo E5b
+     *     7   |  GPS L1 C/A + GPS L2C
+     *     8   |  GPS L1 C/A + GPS L5
+     *     9   |  GPS L1 C/A + Galileo E1B
+     *    10   |  GPS L1 C/A + Galileo E5a
+     *    11   |  GPS L1 C/A + Galileo E5b
+     *    12   |  Galileo E1B + GPS L2C
+     *    13   |  Galileo E5a + GPS L5
+     *    14   |  Galileo E1B + Galileo E5a
+     *    15   |  Galileo E1B + Galileo E5b
+     *    16   |  GPS L2C + GPS L5
+     *    17   |  GPS L2C + Galileo E5a
+     *    18   |  GPS L2C + Galileo E5b
+     *    21   |  GPS L1 C/A + Galileo E1B + GPS L2C
+     *    22   |  GPS L1 C/A + Galileo E1B + GPS L5
+     *    23   |  GLONASS L1 C/A
+     *    24   |  GLONASS L2 C/A
+     *    25   |  GLONASS L1 C/A + GLONASS L2 C/A
+     *    26   |  GPS L1 C/A + GLONASS L1 C/A
+     *    27   |  Galileo E1B + GLONASS L1 C/A
+     *    28   |  GPS L2C + GLONASS L1 C/A
+     *    29   |  GPS L1 C/A + GLONASS L2 C/A
+     *    30   |  Galileo E1B + GLONASS L2 C/A
+     *    31   |  GPS L2C + GLONASS L2 C/A
+     *    32   |  GPS L1 C/A + Galileo E1B + GPS L5 + Galileo E5a
+     *    500   |  BeiDou B1I
+     *    501   |  BeiDou B1I + GPS L1 C/A
+     *    502   |  BeiDou B1I + Galileo E1B
+     *    503   |  BeiDou B1I + GLONASS L1 C/A
+     *    504   |  BeiDou B1I + GPS L1 C/A + Galileo E1B
+     *    505   |  BeiDou B1I + GPS L1 C/A + GLONASS L1 C/A + Galileo E1B
+     *    506   |  BeiDou B1I + Beidou B3I
+     *    600   |  BeiDou B3I
+     *    601   |  BeiDou B3I + GPS L2C
+     *    602   |  BeiDou B3I + GLONASS L2 C/A
+     *    603   |  BeiDou B3I + GPS L2C + GLONASS L2 C/A
+     *    604   |  BeiDou B3I + GPS L1 C/A
+     *    605   |  BeiDou B3I + Galileo E1B
+     *    606   |  BeiDou B3I + GLONASS L1 C/A
+     *    607   |  BeiDou B3I + GPS L1 C/A + Galileo E1B
+     *    608   |  BeiDou B3I + GPS L1 C/A + Galileo E1B + BeiDou B1I
+     *    609   |  BeiDou B3I + GPS L1 C/A + Galileo E1B + GLONASS L1 C/A
+     *    610   |  BeiDou B3I + GPS L1 C/A + Galileo E1B + GLONASS L1 C/A + BeiDou B1I
+     *   1000   |  GPS L1 C/A + GPS L2C + GPS L5
+     *   1001   |  GPS L1 C/A + Galileo E1B + GPS L2C + GPS L5 + Galileo E5a
+     */
+
+    // ####################### RINEX FILES #################
+    if (b_rinex_output_enabled)
         {
-            // check if an initialization is required (new satellite or loss of lock)
-            // it is set to false by the work function if the gnss_synchro is not valid
-            if (channel_initialized.at(observables_iter->second.Channel_ID) == false)
+            std::map<int, Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
+            std::map<int, Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+            std::map<int, Gps_CNAV_Ephemeris>::const_iterator gps_cnav_ephemeris_iter;
+            std::map<int, Glonass_Gnav_Ephemeris>::const_iterator glonass_gnav_ephemeris_iter;
+            std::map<int, Beidou_Dnav_Ephemeris>::const_iterator beidou_dnav_ephemeris_iter;
+            if (!b_rinex_header_written)  // & we have utc data in nav message!
                 {
-                    double wavelength_m = 0;
-                    switch (mapStringValues_[observables_iter->second.Signal])
+                    galileo_ephemeris_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                    gps_ephemeris_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                    gps_cnav_ephemeris_iter = pvt_solver->get_gps_cnav_ephemeris_map().cbegin();
+                    glonass_gnav_ephemeris_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                    beidou_dnav_ephemeris_iter = pvt_solver->get_beidou_dnav_ephemeris_map().cbegin();
+                    switch (type_of_rx)
                         {
-                        case evGPS_1C:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ1;
+                        case 1:  // GPS L1 C/A only
+                            if (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                {
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, rx_time);
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evGPS_L5:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ5;
+                        case 2:  // GPS L2C only
+                            if (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend())
+                                {
+                                    std::string signal("2S");
+                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->gps_cnav_iono, pvt_solver->gps_cnav_utc_model);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_cnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evSBAS_1C:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ1;
+                        case 3:  // GPS L5 only
+                            if (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend())
+                                {
+                                    std::string signal("L5");
+                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->gps_cnav_iono, pvt_solver->gps_cnav_utc_model);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_cnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evGAL_1B:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ1;
+                        case 4:  // Galileo E1B only
+                            if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                {
+                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, rx_time);
+                                    rp->rinex_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navGalFile, pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evGAL_5X:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ5;
+                        case 5:  // Galileo E5a only
+                            if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                {
+                                    std::string signal("5X");
+                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navGalFile, pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evGPS_2S:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ2;
+                        case 6:  // Galileo E5b only
+                            if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                {
+                                    std::string signal("7X");
+                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navGalFile, pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evBDS_B3:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ3_BDS;
+                        case 7:  // GPS L1 C/A + GPS L2C
+                            if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                {
+                                    std::string signal("1C 2S");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_cnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evGLO_1G:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ1_GLO;
+                        case 8:  // GPS L1 + GPS L5
+                            if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                {
+                                    std::string signal("1C L5");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evGLO_2G:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ2_GLO;
+                        case 9:  // GPS L1 C/A + Galileo E1B
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("1B");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evBDS_B1:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ1_BDS;
+                        case 10:  // GPS L1 C/A + Galileo E5a
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("5X");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        case evBDS_B2:
-                            wavelength_m = SPEED_OF_LIGHT / FREQ2_BDS;
+                        case 11:  // GPS L1 C/A + Galileo E5b
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("7X");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        default:
+                        case 13:  // L5+E5a
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("5X");
+                                    std::string gps_signal("L5");
+                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, gps_signal, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_cnav_iono, pvt_solver->gps_cnav_utc_model, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_cnav_ephemeris_map(), pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
                             break;
-                        }
-                    double wrap_carrier_phase_rad = fmod(observables_iter->second.Carrier_phase_rads, PI_2);
-                    initial_carrier_phase_offset_estimation_rads.at(observables_iter->second.Channel_ID) = PI_2 * round(observables_iter->second.Pseudorange_m / wavelength_m) - observables_iter->second.Carrier_phase_rads + wrap_carrier_phase_rad;
-                    channel_initialized.at(observables_iter->second.Channel_ID) = true;
-                    DLOG(INFO) << "initialized carrier phase at channel " << observables_iter->second.Channel_ID;
-                }
-            // apply the carrier phase offset to this satellite
-            observables_iter->second.Carrier_phase_rads = observables_iter->second.Carrier_phase_rads + initial_carrier_phase_offset_estimation_rads.at(observables_iter->second.Channel_ID);
-        }
-}
+                        case 14:  // Galileo E1B + Galileo E5a
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("1B 5X");
+                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, rx_time, gal_signal);
+                                    rp->rinex_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navGalFile, pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 15:  // Galileo E1B + Galileo E5b
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("1B 7X");
+                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, rx_time, gal_signal);
+                                    rp->rinex_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navGalFile, pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 23:  // GLONASS L1 C/A only
+                            if (glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                {
+                                    std::string signal("1G");
+                                    rp->rinex_obs_header(rp->obsFile, glonass_gnav_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navGloFile, pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
+                                    rp->log_rinex_nav(rp->navGloFile, pvt_solver->get_glonass_gnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 24:  // GLONASS L2 C/A only
+                            if (glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                {
+                                    std::string signal("2G");
+                                    rp->rinex_obs_header(rp->obsFile, glonass_gnav_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navGloFile, pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
+                                    rp->log_rinex_nav(rp->navGloFile, pvt_solver->get_glonass_gnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 25:  // GLONASS L1 C/A + GLONASS L2 C/A
+                            if (glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                {
+                                    std::string signal("1G 2G");
+                                    rp->rinex_obs_header(rp->obsFile, glonass_gnav_ephemeris_iter->second, rx_time, signal);
+                                    rp->rinex_nav_header(rp->navGloFile, pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
+                                    rp->log_rinex_nav(rp->navGloFile, pvt_solver->get_glonass_gnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 26:  // GPS L1 C/A + GLONASS L1 C/A
+                            if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                {
+                                    std::string glo_signal("1G");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, glo_signal);
+                                    if (d_rinex_version == 3)
+                                        {
+                                            rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_glonass_gnav_ephemeris_map());
+                                        }
+                                    if (d_rinex_version == 2)
+                                        {
+                                            rp->rinex_nav_header(rp->navFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
+                                            rp->rinex_nav_header(rp->navGloFile, pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
+                                            rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_ephemeris_map());
+                                            rp->log_rinex_nav(rp->navGloFile, pvt_solver->get_glonass_gnav_ephemeris_map());
+                                        }
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 27:  // Galileo E1B + GLONASS L1 C/A
+                            if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                {
+                                    std::string glo_signal("1G");
+                                    std::string gal_signal("1B");
+                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, glo_signal, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_galileo_ephemeris_map(), pvt_solver->get_glonass_gnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 28:  // GPS L2C + GLONASS L1 C/A
+                            if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                {
+                                    std::string glo_signal("1G");
+                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, glo_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_cnav_iono, pvt_solver->gps_cnav_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_cnav_ephemeris_map(), pvt_solver->get_glonass_gnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 29:  // GPS L1 C/A + GLONASS L2 C/A
+                            if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                {
+                                    std::string glo_signal("2G");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, glo_signal);
+                                    if (d_rinex_version == 3)
+                                        {
+                                            rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_glonass_gnav_ephemeris_map());
+                                        }
+                                    if (d_rinex_version == 2)
+                                        {
+                                            rp->rinex_nav_header(rp->navFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
+                                            rp->rinex_nav_header(rp->navGloFile, pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
+                                            rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_ephemeris_map());
+                                            rp->log_rinex_nav(rp->navGloFile, pvt_solver->get_glonass_gnav_ephemeris_map());
+                                        }
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 30:  // Galileo E1B + GLONASS L2 C/A
+                            if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                {
+                                    std::string glo_signal("2G");
+                                    std::string gal_signal("1B");
+                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, glo_signal, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_galileo_ephemeris_map(), pvt_solver->get_glonass_gnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 31:  // GPS L2C + GLONASS L2 C/A
+                            if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                {
+                                    std::string glo_signal("2G");
+                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, glo_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_cnav_iono, pvt_solver->gps_cnav_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_cnav_ephemeris_map(), pvt_solver->get_glonass_gnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 32:  // L1+E1+L5+E5a
+                            if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and
+                                (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()) and
+                                (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("1B 5X");
+                                    std::string gps_signal("1C L5");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, gps_signal, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 33:  // L1+E1+E5a
+                            if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and
+                                (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("1B 5X");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 500:  // BDS B1I only
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B1");
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_beidou_dnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
 
+                            break;
+                        case 501:  // BeiDou B1I + GPS L1 C/A
+                            if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend()))
+                                {
+                                    std::string bds_signal("B1");
+                                    // rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, beidou_dnav_ephemeris_iter->second, rx_time, bds_signal);
+                                    // rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
 
-int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_items,
-    gr_vector_void_star& output_items __attribute__((unused)))
-{
-    for (int32_t epoch = 0; epoch < noutput_items; epoch++)
-        {
-            bool flag_display_pvt = false;
-            bool flag_compute_pvt_output = false;
-            bool flag_write_RTCM_1019_output = false;
-            bool flag_write_RTCM_1020_output = false;
-            bool flag_write_RTCM_1045_output = false;
-            bool flag_write_RTCM_MSM_output = false;
-            bool flag_write_RINEX_obs_output = false;
+                            break;
+                        case 502:  // BeiDou B1I + Galileo E1B
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend()))
+                                {
+                                    std::string bds_signal("B1");
+                                    std::string gal_signal("1B");
+                                    // rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, beidou_dnav_ephemeris_iter->second, rx_time, gal_signal, bds_signal);
+                                    // rp->rinex_nav_header(rp->navMixFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
 
-            gnss_observables_map.clear();
-            const auto** in = reinterpret_cast<const Gnss_Synchro**>(&input_items[0]);  // Get the input buffer pointer
-            // ############ 1. READ PSEUDORANGES ####
-            for (uint32_t i = 0; i < d_nchannels; i++)
+                            break;
+                        case 503:  // BeiDou B1I + GLONASS L1 C/A
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B1");
+                                    // rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    // rp->log_rinex_nav(rp->navFile, pvt_solver->get_beidou_dnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 504:  // BeiDou B1I + GPS L1 C/A + Galileo E1B
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B1");
+                                    // rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    // rp->log_rinex_nav(rp->navFile, pvt_solver->get_beidou_dnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 505:  // BeiDou B1I + GPS L1 C/A + GLONASS L1 C/A + Galileo E1B
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B1");
+                                    // rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    // rp->log_rinex_nav(rp->navFile, pvt_solver->get_beidou_dnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 506:  // BeiDou B1I + Beidou B3I
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B1");
+                                    // rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    // rp->log_rinex_nav(rp->navFile, pvt_solver->get_beidou_dnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 600:  // BDS B3I only
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B3");
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_beidou_dnav_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 601:  // BeiDou B3I + GPS L2C
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B3");
+                                    // rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 602:  // BeiDou B3I + GLONASS L2 C/A
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B3");
+                                    // rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 603:  // BeiDou B3I + GPS L2C + GLONASS L2 C/A
+                            if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                {
+                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, "B3");
+                                    // rp->rinex_nav_header(rp->navFile, pvt_solver->beidou_dnav_iono, pvt_solver->beidou_dnav_utc_model);
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+
+                            break;
+                        case 1000:  // GPS L1 C/A + GPS L2C + GPS L5
+                            if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and
+                                (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                {
+                                    std::string gps_signal("1C 2S L5");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, rx_time, gps_signal);
+                                    rp->rinex_nav_header(rp->navFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
+                                    rp->log_rinex_nav(rp->navFile, pvt_solver->get_gps_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        case 1001:  // GPS L1 C/A + Galileo E1B + GPS L2C + GPS L5 + Galileo E5a
+                            if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and
+                                (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and
+                                (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                {
+                                    std::string gal_signal("1B 5X");
+                                    std::string gps_signal("1C 2S L5");
+                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, gps_signal, gal_signal);
+                                    rp->rinex_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                    rp->log_rinex_nav(rp->navMixFile, pvt_solver->get_gps_ephemeris_map(), pvt_solver->get_galileo_ephemeris_map());
+                                    b_rinex_header_written = true;  // do not write header anymore
+                                }
+                            break;
+                        default:
+                            break;
+                        }
+                }
+            if (b_rinex_header_written)  // The header is already written, we can now log the navigation message data
                 {
-                    if (in[i][epoch].Flag_valid_pseudorange)
+                    galileo_ephemeris_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                    gps_ephemeris_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                    gps_cnav_ephemeris_iter = pvt_solver->get_gps_cnav_ephemeris_map().cbegin();
+                    glonass_gnav_ephemeris_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                    beidou_dnav_ephemeris_iter = pvt_solver->get_beidou_dnav_ephemeris_map().cbegin();
+
+                    // Log observables into the RINEX file
+                    if (output.flag_write_RINEX_obs_output)
                         {
-                            auto tmp_eph_iter_gps = d_internal_pvt_solver->gps_ephemeris_map.find(in[i][epoch].PRN);
-                            auto tmp_eph_iter_gal = d_internal_pvt_solver->galileo_ephemeris_map.find(in[i][epoch].PRN);
-                            auto tmp_eph_iter_cnav = d_internal_pvt_solver->gps_cnav_ephemeris_map.find(in[i][epoch].PRN);
-                            auto tmp_eph_iter_glo_gnav = d_internal_pvt_solver->glonass_gnav_ephemeris_map.find(in[i][epoch].PRN);
-                            auto tmp_eph_iter_bds_dnav = d_internal_pvt_solver->beidou_dnav_ephemeris_map.find(in[i][epoch].PRN);
+                            switch (type_of_rx)
+                                {
+                                case 1:  // GPS L1 C/A only
+                                    if (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0))
+                                                {
+                                                    rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                    rp->update_nav_header(rp->navFile, pvt_solver->gps_utc_model, pvt_solver->gps_iono, gps_ephemeris_iter->second);
+                                                    b_rinex_header_updated = true;
+                                                }
+                                        }
+                                    break;
+                                case 2:  // GPS L2C only
+                                    if (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, rx_time, observables_map);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->gps_cnav_utc_model.d_A0 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_cnav_utc_model);
+                                            rp->update_nav_header(rp->navFile, pvt_solver->gps_cnav_utc_model, pvt_solver->gps_cnav_iono);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 3:  // GPS L5
+                                    if (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, rx_time, observables_map);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->gps_cnav_utc_model.d_A0 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_cnav_utc_model);
+                                            rp->update_nav_header(rp->navFile, pvt_solver->gps_cnav_utc_model, pvt_solver->gps_cnav_iono);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 4:  // Galileo E1B only
+                                    if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, rx_time, observables_map, "1B");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->galileo_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 5:  // Galileo E5a only
+                                    if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, rx_time, observables_map, "5X");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->galileo_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 6:  // Galileo E5b only
+                                    if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, rx_time, observables_map, "7X");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->galileo_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 7:  // GPS L1 C/A + GPS L2C
+                                    if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0))
+                                                {
+                                                    rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                    rp->update_nav_header(rp->navFile, pvt_solver->gps_utc_model, pvt_solver->gps_iono, gps_ephemeris_iter->second);
+                                                    b_rinex_header_updated = true;
+                                                }
+                                        }
+                                    break;
+                                case 8:  // L1+L5
+                                    if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and ((pvt_solver->gps_cnav_utc_model.d_A0 != 0) or (pvt_solver->gps_utc_model.d_A0 != 0)))
+                                                {
+                                                    if (pvt_solver->gps_cnav_utc_model.d_A0 != 0)
+                                                        {
+                                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_cnav_utc_model);
+                                                            rp->update_nav_header(rp->navFile, pvt_solver->gps_cnav_utc_model, pvt_solver->gps_cnav_iono);
+                                                        }
+                                                    else
+                                                        {
+                                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                            rp->update_nav_header(rp->navFile, pvt_solver->gps_utc_model, pvt_solver->gps_iono, gps_ephemeris_iter->second);
+                                                        }
+                                                    b_rinex_header_updated = true;
+                                                }
+                                        }
+                                    break;
+                                case 9:  // GPS L1 C/A + Galileo E1B
+                                    if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0))
+                                                {
+                                                    rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                    rp->update_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                                    b_rinex_header_updated = true;
+                                                }
+                                        }
+                                    break;
+                                case 13:  // L5+E5a
+                                    if ((gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()) and (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, observables_map);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->gps_cnav_utc_model.d_A0 != 0) and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_cnav_utc_model);
+                                            rp->update_nav_header(rp->navMixFile, pvt_solver->gps_cnav_utc_model, pvt_solver->gps_cnav_iono, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                            b_rinex_header_updated = true;  // do not write header anymore
+                                        }
+                                    break;
+                                case 14:  // Galileo E1B + Galileo E5a
+                                    if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, rx_time, observables_map, "1B 5X");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->galileo_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 15:  // Galileo E1B + Galileo E5b
+                                    if (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, rx_time, observables_map, "1B 7X");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_nav_header(rp->navGalFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->galileo_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 23:  // GLONASS L1 C/A only
+                                    if (glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, glonass_gnav_ephemeris_iter->second, rx_time, observables_map, "1C");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->glonass_gnav_utc_model.d_tau_c != 0))
+                                        {
+                                            rp->update_nav_header(rp->navGloFile, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->glonass_gnav_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 24:  // GLONASS L2 C/A only
+                                    if (glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, glonass_gnav_ephemeris_iter->second, rx_time, observables_map, "2C");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->glonass_gnav_utc_model.d_tau_c != 0))
+                                        {
+                                            rp->update_nav_header(rp->navGloFile, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->glonass_gnav_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 25:  // GLONASS L1 C/A + GLONASS L2 C/A
+                                    if (glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, glonass_gnav_ephemeris_iter->second, rx_time, observables_map, "1C 2C");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->glonass_gnav_utc_model.d_tau_c != 0))
+                                        {
+                                            rp->update_nav_header(rp->navMixFile, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->glonass_gnav_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 26:  // GPS L1 C/A + GLONASS L1 C/A
+                                    if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0))
+                                                {
+                                                    rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                    rp->update_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                                    b_rinex_header_updated = true;  // do not write header anymore
+                                                }
+                                        }
+                                    break;
+                                case 27:  // Galileo E1B + GLONASS L1 C/A
+                                    if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, observables_map);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->galileo_utc_model);
+                                            rp->update_nav_header(rp->navMixFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            b_rinex_header_updated = true;  // do not write header anymore
+                                        }
+                                    break;
+                                case 28:  // GPS L2C + GLONASS L1 C/A
+                                    if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, observables_map);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->gps_cnav_utc_model.d_A0 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_cnav_utc_model);
+                                            rp->update_nav_header(rp->navMixFile, pvt_solver->gps_cnav_iono, pvt_solver->gps_cnav_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            b_rinex_header_updated = true;  // do not write header anymore
+                                        }
+                                    break;
+                                case 29:  // GPS L1 C/A + GLONASS L2 C/A
+                                    if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0))
+                                                {
+                                                    rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                    rp->update_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                                    b_rinex_header_updated = true;  // do not write header anymore
+                                                }
+                                        }
+                                    break;
+                                case 30:  // Galileo E1B + GLONASS L2 C/A
+                                    if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, observables_map);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->galileo_utc_model);
+                                            rp->update_nav_header(rp->navMixFile, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            b_rinex_header_updated = true;  // do not write header anymore
+                                        }
+                                    break;
+                                case 31:  // GPS L2C + GLONASS L2 C/A
+                                    if ((glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, rx_time, observables_map);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->gps_cnav_utc_model.d_A0 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_cnav_utc_model);
+                                            rp->update_nav_header(rp->navMixFile, pvt_solver->gps_cnav_iono, pvt_solver->gps_cnav_utc_model, pvt_solver->glonass_gnav_utc_model, pvt_solver->glonass_gnav_almanac);
+                                            b_rinex_header_updated = true;  // do not write header anymore
+                                        }
+                                    break;
+                                case 32:  // L1+E1+L5+E5a
+                                    if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()) and (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and ((pvt_solver->gps_cnav_utc_model.d_A0 != 0) or (pvt_solver->gps_utc_model.d_A0 != 0)) and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                                {
+                                                    if (pvt_solver->gps_cnav_utc_model.d_A0 != 0)
+                                                        {
+                                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_cnav_utc_model);
+                                                            rp->update_nav_header(rp->navMixFile, pvt_solver->gps_cnav_utc_model, pvt_solver->gps_cnav_iono, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                                        }
+                                                    else
+                                                        {
+                                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                            rp->update_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                                        }
+                                                    b_rinex_header_updated = true;  // do not write header anymore
+                                                }
+                                        }
+                                    break;
+                                case 33:  // L1+E1+E5a
+                                    if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, observables_map);
+                                            if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0) and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                                {
+                                                    rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                                    rp->update_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                                    b_rinex_header_updated = true;  // do not write header anymore
+                                                }
+                                        }
+                                    break;
+                                case 500:  // BDS B1I only
+                                    if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, observables_map, "B1");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->beidou_dnav_utc_model.d_A0_UTC != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->beidou_dnav_utc_model);
+                                            rp->update_nav_header(rp->navFile, pvt_solver->beidou_dnav_utc_model, pvt_solver->beidou_dnav_iono);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 600:  // BDS B3I only
+                                    if (beidou_dnav_ephemeris_iter != pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, beidou_dnav_ephemeris_iter->second, rx_time, observables_map, "B3");
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->beidou_dnav_utc_model.d_A0_UTC != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->beidou_dnav_utc_model);
+                                            rp->update_nav_header(rp->navFile, pvt_solver->beidou_dnav_utc_model, pvt_solver->beidou_dnav_iono);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 1000:  // GPS L1 C/A + GPS L2C + GPS L5
+                                    if ((gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and
+                                        (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, rx_time, observables_map, true);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                            rp->update_nav_header(rp->navFile, pvt_solver->gps_utc_model, pvt_solver->gps_iono, gps_ephemeris_iter->second);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                case 1001:  // GPS L1 C/A + Galileo E1B + GPS L2C + GPS L5 + Galileo E5a
+                                    if ((galileo_ephemeris_iter != pvt_solver->get_galileo_ephemeris_map().cend()) and
+                                        (gps_ephemeris_iter != pvt_solver->get_gps_ephemeris_map().cend()) and
+                                        (gps_cnav_ephemeris_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, rx_time, observables_map, true);
+                                        }
+                                    if (!b_rinex_header_updated and (pvt_solver->gps_utc_model.d_A0 != 0) and (pvt_solver->galileo_utc_model.A0_6 != 0))
+                                        {
+                                            rp->update_obs_header(rp->obsFile, pvt_solver->gps_utc_model);
+                                            rp->update_nav_header(rp->navMixFile, pvt_solver->gps_iono, pvt_solver->gps_utc_model, gps_ephemeris_iter->second, pvt_solver->galileo_iono, pvt_solver->galileo_utc_model);
+                                            b_rinex_header_updated = true;
+                                        }
+                                    break;
+                                default:
+                                    break;
+                                }
+                        }
+                }
+        }
 
-                            bool store_valid_observable = false;
+    // ####################### RTCM MESSAGES #################
+    try
+        {
+            if (b_rtcm_writing_started and b_rtcm_enabled)
+                {
+                    switch (type_of_rx)
+                        {
+                        case 1:  // GPS L1 C/A
+                            if (output.flag_write_RTCM_1019_output == true)
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 4:
+                        case 5:
+                        case 6:
+                            if (output.flag_write_RTCM_1045_output == true)
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 7:  // GPS L1 C/A + GPS L2C
+                            if (output.flag_write_RTCM_1019_output == true)
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto gps_cnav_eph_iter = pvt_solver->get_gps_cnav_ephemeris_map().cbegin();
+                                    if ((gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_eph_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 8:  // L1+L5
+                            if (output.flag_write_RTCM_1019_output == true)
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto gps_cnav_eph_iter = pvt_solver->get_gps_cnav_ephemeris_map().cbegin();
+                                    if ((gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_eph_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 9:  // GPS L1 C/A + Galileo E1B
+                            if (output.flag_write_RTCM_1019_output == true)
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_1045_output == true)
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    int gps_channel = 0;
+                                    int gal_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 13:  // L5+E5a
+                            if (output.flag_write_RTCM_1045_output == true)
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+
+                            if (output.flag_write_RTCM_MSM_output and d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto gps_cnav_eph_iter = pvt_solver->get_gps_cnav_ephemeris_map().cbegin();
+                                    int gal_channel = 0;
+                                    int gps_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gps_cnav_eph_iter = pvt_solver->get_gps_cnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_cnav_eph_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend() and (d_rtcm_MT1097_rate_ms != 0))
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gps_cnav_eph_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend() and (d_rtcm_MT1077_rate_ms != 0))
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, gps_cnav_eph_iter->second, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 14:
+                        case 15:
+                            if (output.flag_write_RTCM_1045_output == true)
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 23:
+                        case 24:
+                        case 25:
+                            if (output.flag_write_RTCM_1020_output == true)
+                                {
+                                    for (auto glonass_gnav_ephemeris_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_ephemeris_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_ephemeris_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    auto glo_gnav_ephemeris_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    if (glo_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glo_gnav_ephemeris_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 26:  // GPS L1 C/A + GLONASS L1 C/A
+                            if (output.flag_write_RTCM_1019_output == true)
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_1020_output == true)
+                                {
+                                    for (auto glonass_gnav_ephemeris_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_ephemeris_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_ephemeris_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    int gps_channel = 0;
+                                    int glo_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (glo_channel == 0)
+                                                {
+                                                    if (system == "R")
+                                                        {
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 27:  // GLONASS L1 C/A + Galileo E1B
+                            if (output.flag_write_RTCM_1020_output == true)
+                                {
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_1045_output == true)
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    int gal_channel = 0;
+                                    int glo_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (glo_channel == 0)
+                                                {
+                                                    if (system == "R")
+                                                        {
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 29:  // GPS L1 C/A + GLONASS L2 C/A
+                            if (output.flag_write_RTCM_1019_output == true)
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_1020_output == true)
+                                {
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    int gps_channel = 0;
+                                    int glo_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (glo_channel == 0)
+                                                {
+                                                    if (system == "R")
+                                                        {
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 30:  // GLONASS L2 C/A + Galileo E1B
+                            if (output.flag_write_RTCM_1020_output == true)
+                                {
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_1045_output == true)
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    int gal_channel = 0;
+                                    int glo_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (glo_channel == 0)
+                                                {
+                                                    if (system == "R")
+                                                        {
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        case 32:  // L1+E1+L5+E5a
+                            if (output.flag_write_RTCM_1019_output == true)
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_1045_output == true)
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (output.flag_write_RTCM_MSM_output == true)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    int gal_channel = 0;
+                                    int gps_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            break;
+                        default:
+                            break;
+                        }
+                }
+
+            if (!b_rtcm_writing_started and b_rtcm_enabled)  // the first time
+                {
+                    switch (type_of_rx)
+                        {
+                        case 1:                              // GPS L1 C/A
+                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
 
-                            if (tmp_eph_iter_gps != d_internal_pvt_solver->gps_ephemeris_map.cend())
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 4:
+                        case 5:
+                        case 6:
+                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 7:                              // GPS L1 C/A + GPS L2C
+                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
                                 {
-                                    uint32_t prn_aux = tmp_eph_iter_gps->second.i_satellite_PRN;
-                                    if ((prn_aux == in[i][epoch].PRN) and (std::string(in[i][epoch].Signal) == "1C"))
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
                                         {
-                                            store_valid_observable = true;
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
                                         }
                                 }
-                            if (tmp_eph_iter_gal != d_internal_pvt_solver->galileo_ephemeris_map.cend())
+                            if (d_rtcm_MSM_rate_ms != 0)
                                 {
-                                    uint32_t prn_aux = tmp_eph_iter_gal->second.i_satellite_PRN;
-                                    if ((prn_aux == in[i][epoch].PRN) and ((std::string(in[i][epoch].Signal) == "1B") or (std::string(in[i][epoch].Signal) == "5X")))
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto gps_cnav_eph_iter = pvt_solver->get_gps_cnav_ephemeris_map().cbegin();
+                                    if ((gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_eph_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
                                         {
-                                            store_valid_observable = true;
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
                                         }
                                 }
-                            if (tmp_eph_iter_cnav != d_internal_pvt_solver->gps_cnav_ephemeris_map.cend())
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 8:                              // L1+L5
+                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto gps_cnav_eph_iter = pvt_solver->get_gps_cnav_ephemeris_map().cbegin();
+                                    if ((gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend()) and (gps_cnav_eph_iter != pvt_solver->get_gps_cnav_ephemeris_map().cend()))
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 9:                              // GPS L1 C/A + Galileo E1B
+                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MT1045_rate_ms != 0)
                                 {
-                                    uint32_t prn_aux = tmp_eph_iter_cnav->second.i_satellite_PRN;
-                                    if ((prn_aux == in[i][epoch].PRN) and ((std::string(in[i][epoch].Signal) == "2S") or (std::string(in[i][epoch].Signal) == "L5")))
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
                                         {
-                                            store_valid_observable = true;
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
                                         }
                                 }
-                            if (tmp_eph_iter_glo_gnav != d_internal_pvt_solver->glonass_gnav_ephemeris_map.cend())
+                            if (d_rtcm_MSM_rate_ms != 0)
                                 {
-                                    uint32_t prn_aux = tmp_eph_iter_glo_gnav->second.i_satellite_PRN;
-                                    if ((prn_aux == in[i][epoch].PRN) and ((std::string(in[i][epoch].Signal) == "1G") or (std::string(in[i][epoch].Signal) == "2G")))
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    int gps_channel = 0;
+                                    int gal_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
                                         {
-                                            store_valid_observable = true;
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
                                         }
                                 }
-                            if (tmp_eph_iter_bds_dnav != d_internal_pvt_solver->beidou_dnav_ephemeris_map.cend())
+                            b_rtcm_writing_started = true;
+                            break;
+
+                        case 13:  // L5+E5a
+                            if (d_rtcm_MT1045_rate_ms != 0)
                                 {
-                                    uint32_t prn_aux = tmp_eph_iter_bds_dnav->second.i_satellite_PRN;
-                                    if ((prn_aux == in[i][epoch].PRN) and ((std::string(in[i][epoch].Signal) == "B1") or (std::string(in[i][epoch].Signal) == "B3")))
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
                                         {
-                                            store_valid_observable = true;
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
                                         }
                                 }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    int gal_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
 
-                            if (store_valid_observable)
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend() and (d_rtcm_MT1097_rate_ms != 0))
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 14:
+                        case 15:
+                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 23:
+                        case 24:
+                        case 25:
+                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    auto glo_gnav_ephemeris_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    if (glo_gnav_ephemeris_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glo_gnav_ephemeris_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 26:                             // GPS L1 C/A + GLONASS L1 C/A
+                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    int gps_channel = 0;
+                                    int glo_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (glo_channel == 0)
+                                                {
+                                                    if (system == "R")
+                                                        {
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 27:                             // GLONASS L1 C/A + Galileo E1B
+                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    int gal_channel = 0;
+                                    int glo_channel = 0;
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gal_channel == 0)
+                                                {
+                                                    if (system == "E")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (glo_channel == 0)
+                                                {
+                                                    if (system == "R")
+                                                        {
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 29:                             // GPS L1 C/A + GLONASS L2 C/A
+                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
                                 {
-                                    // store valid observables in a map.
-                                    gnss_observables_map.insert(std::pair<int, Gnss_Synchro>(i, in[i][epoch]));
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
                                 }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    int gps_channel = 0;
+                                    int glo_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
+                                                {
+                                                    if (system == "G")
+                                                        {
+                                                            // This is a channel with valid GPS signal
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                            if (glo_channel == 0)
+                                                {
+                                                    if (system == "R")
+                                                        {
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
 
-                            if (b_rtcm_enabled)
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 30:                             // GLONASS L2 C/A + Galileo E1B
+                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin(); glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend(); glonass_gnav_eph_iter++)
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, pvt_solver->glonass_gnav_utc_model);
+                                        }
+                                }
+                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
                                 {
-                                    try
+                                    int gal_channel = 0;
+                                    int glo_channel = 0;
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().cbegin();
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
                                         {
-                                            if (d_internal_pvt_solver->gps_ephemeris_map.empty() == false)
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gal_channel == 0)
                                                 {
-                                                    if (tmp_eph_iter_gps != d_internal_pvt_solver->gps_ephemeris_map.cend())
+                                                    if (system == "E")
                                                         {
-                                                            d_rtcm_printer->lock_time(d_internal_pvt_solver->gps_ephemeris_map.find(in[i][epoch].PRN)->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                            // This is a channel with valid GPS signal
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
                                                         }
                                                 }
-                                            if (d_internal_pvt_solver->galileo_ephemeris_map.empty() == false)
+                                            if (glo_channel == 0)
                                                 {
-                                                    if (tmp_eph_iter_gal != d_internal_pvt_solver->galileo_ephemeris_map.cend())
+                                                    if (system == "R")
                                                         {
-                                                            d_rtcm_printer->lock_time(d_internal_pvt_solver->galileo_ephemeris_map.find(in[i][epoch].PRN)->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                            glonass_gnav_eph_iter = pvt_solver->get_glonass_gnav_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                                {
+                                                                    glo_channel = 1;
+                                                                }
                                                         }
                                                 }
-                                            if (d_internal_pvt_solver->gps_cnav_ephemeris_map.empty() == false)
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (glonass_gnav_eph_iter != pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        case 32:                             // L1+E1+L5+E5a
+                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gps_eph_iter : pvt_solver->get_gps_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
+                                {
+                                    for (const auto& gal_eph_iter : pvt_solver->get_galileo_ephemeris_map())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
+                                        }
+                                }
+                            if (d_rtcm_MSM_rate_ms != 0)
+                                {
+                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+                                    auto gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().cbegin();
+                                    auto gps_eph_iter = pvt_solver->get_gps_ephemeris_map().cbegin();
+                                    int gps_channel = 0;
+                                    int gal_channel = 0;
+                                    for (gnss_observables_iter = observables_map.cbegin(); gnss_observables_iter != observables_map.cend(); gnss_observables_iter++)
+                                        {
+                                            std::string system(&gnss_observables_iter->second.System, 1);
+                                            if (gps_channel == 0)
                                                 {
-                                                    if (tmp_eph_iter_cnav != d_internal_pvt_solver->gps_cnav_ephemeris_map.cend())
+                                                    if (system == "G")
                                                         {
-                                                            d_rtcm_printer->lock_time(d_internal_pvt_solver->gps_cnav_ephemeris_map.find(in[i][epoch].PRN)->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                            // This is a channel with valid GPS signal
+                                                            gps_eph_iter = pvt_solver->get_gps_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                                                {
+                                                                    gps_channel = 1;
+                                                                }
                                                         }
                                                 }
-                                            if (d_internal_pvt_solver->glonass_gnav_ephemeris_map.empty() == false)
+                                            if (gal_channel == 0)
                                                 {
-                                                    if (tmp_eph_iter_glo_gnav != d_internal_pvt_solver->glonass_gnav_ephemeris_map.cend())
+                                                    if (system == "E")
                                                         {
-                                                            d_rtcm_printer->lock_time(d_internal_pvt_solver->glonass_gnav_ephemeris_map.find(in[i][epoch].PRN)->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                            gal_eph_iter = pvt_solver->get_galileo_ephemeris_map().find(gnss_observables_iter->second.PRN);
+                                                            if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
+                                                                {
+                                                                    gal_channel = 1;
+                                                                }
                                                         }
                                                 }
                                         }
-                                    catch (const boost::exception& ex)
+                                    if (gps_eph_iter != pvt_solver->get_gps_ephemeris_map().cend())
+                                        {
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
+                                        }
+                                    if (gal_eph_iter != pvt_solver->get_galileo_ephemeris_map().cend())
                                         {
-                                            std::cout << "RTCM boost exception: " << boost::diagnostic_information(ex) << std::endl;
-                                            LOG(ERROR) << "RTCM boost exception: " << boost::diagnostic_information(ex);
+                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, rx_time, observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
                                         }
-                                    catch (const std::exception& ex)
+                                }
+                            b_rtcm_writing_started = true;
+                            break;
+                        default:
+                            break;
+                        }
+                }
+        }
+    catch (const boost::exception& ex)
+        {
+            std::cout << "RTCM boost exception: " << boost::diagnostic_information(ex) << std::endl;
+            LOG(ERROR) << "RTCM boost exception: " << boost::diagnostic_information(ex);
+        }
+    catch (const std::exception& ex)
+        {
+            std::cout << "RTCM std exception: " << ex.what() << std::endl;
+            LOG(ERROR) << "RTCM std exception: " << ex.what();
+        }
+}
+
+
+int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_items,
+    gr_vector_void_star& output_items __attribute__((unused)))
+{
+    for (int32_t epoch = 0; epoch < noutput_items; epoch++)
+        {
+            bool flag_display_pvt = false;
+            bool flag_compute_pvt_output = false;
+            bool flag_write_RTCM_1019_output = false;
+            bool flag_write_RTCM_1020_output = false;
+            bool flag_write_RTCM_1045_output = false;
+            bool flag_write_RTCM_MSM_output = false;
+            bool flag_write_RINEX_obs_output = false;
+
+            d_observables.clear();
+            const auto** in = reinterpret_cast<const Gnss_Synchro**>(&input_items[0]);  // Get the input buffer pointer
+            // ############ 1. READ PSEUDORANGES ####
+            for (uint32_t i = 0; i < d_nchannels; i++)
+                {
+                    if (in[i][epoch].Flag_valid_pseudorange)
+                        {
+                            // only the ephemeris map of the satellite system is searched
+                            const Observables_Epoch::Signal_Id signal = Observables_Epoch::signal_id(in[i][epoch].Signal);
+                            bool store_valid_observable = false;
+                            try
+                                {
+                                    switch (in[i][epoch].System)
                                         {
-                                            std::cout << "RTCM std exception: " << ex.what() << std::endl;
-                                            LOG(ERROR) << "RTCM std exception: " << ex.what();
+                                        case 'G':
+                                            if (signal == Observables_Epoch::evGPS_1C)
+                                                {
+                                                    auto tmp_eph_iter_gps = d_internal_pvt_solver->get_gps_ephemeris_map().find(in[i][epoch].PRN);
+                                                    if (tmp_eph_iter_gps != d_internal_pvt_solver->get_gps_ephemeris_map().cend())
+                                                        {
+                                                            store_valid_observable = (tmp_eph_iter_gps->second.i_satellite_PRN == in[i][epoch].PRN);
+                                                            if (b_rtcm_enabled)
+                                                                {
+                                                                    d_rtcm_printer->lock_time(tmp_eph_iter_gps->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                                }
+                                                        }
+                                                }
+                                            else if ((signal == Observables_Epoch::evGPS_2S) or (signal == Observables_Epoch::evGPS_L5))
+                                                {
+                                                    auto tmp_eph_iter_cnav = d_internal_pvt_solver->get_gps_cnav_ephemeris_map().find(in[i][epoch].PRN);
+                                                    if (tmp_eph_iter_cnav != d_internal_pvt_solver->get_gps_cnav_ephemeris_map().cend())
+                                                        {
+                                                            store_valid_observable = (tmp_eph_iter_cnav->second.i_satellite_PRN == in[i][epoch].PRN);
+                                                            if (b_rtcm_enabled)
+                                                                {
+                                                                    d_rtcm_printer->lock_time(tmp_eph_iter_cnav->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                                }
+                                                        }
+                                                }
+                                            break;
+                                        case 'E':
+                                            {
+                                                auto tmp_eph_iter_gal = d_internal_pvt_solver->get_galileo_ephemeris_map().find(in[i][epoch].PRN);
+                                                if (tmp_eph_iter_gal != d_internal_pvt_solver->get_galileo_ephemeris_map().cend())
+                                                    {
+                                                        store_valid_observable = (tmp_eph_iter_gal->second.i_satellite_PRN == in[i][epoch].PRN) and
+                                                                                 ((signal == Observables_Epoch::evGAL_1B) or (signal == Observables_Epoch::evGAL_5X));
+                                                        if (b_rtcm_enabled)
+                                                            {
+                                                                d_rtcm_printer->lock_time(tmp_eph_iter_gal->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                            }
+                                                    }
+                                            }
+                                            break;
+                                        case 'R':
+                                            {
+                                                auto tmp_eph_iter_glo_gnav = d_internal_pvt_solver->get_glonass_gnav_ephemeris_map().find(in[i][epoch].PRN);
+                                                if (tmp_eph_iter_glo_gnav != d_internal_pvt_solver->get_glonass_gnav_ephemeris_map().cend())
+                                                    {
+                                                        store_valid_observable = (tmp_eph_iter_glo_gnav->second.i_satellite_PRN == in[i][epoch].PRN) and
+                                                                                 ((signal == Observables_Epoch::evGLO_1G) or (signal == Observables_Epoch::evGLO_2G));
+                                                        if (b_rtcm_enabled)
+                                                            {
+                                                                d_rtcm_printer->lock_time(tmp_eph_iter_glo_gnav->second, in[i][epoch].RX_time, in[i][epoch]);  // keep track of locking time
+                                                            }
+                                                    }
+                                            }
+                                            break;
+                                        case 'C':
+                                            {
+                                                auto tmp_eph_iter_bds_dnav = d_internal_pvt_solver->get_beidou_dnav_ephemeris_map().find(in[i][epoch].PRN);
+                                                if (tmp_eph_iter_bds_dnav != d_internal_pvt_solver->get_beidou_dnav_ephemeris_map().cend())
+                                                    {
+                                                        store_valid_observable = (tmp_eph_iter_bds_dnav->second.i_satellite_PRN == in[i][epoch].PRN) and
+                                                                                 ((signal == Observables_Epoch::evBDS_B1) or (signal == Observables_Epoch::evBDS_B3));
+                                                    }
+                                            }
+                                            break;
+                                        default:
+                                            break;
                                         }
                                 }
+                            catch (const boost::exception& ex)
+                                {
+                                    std::cout << "RTCM boost exception: " << boost::diagnostic_information(ex) << std::endl;
+                                    LOG(ERROR) << "RTCM boost exception: " << boost::diagnostic_information(ex);
+                                }
+                            catch (const std::exception& ex)
+                                {
+                                    std::cout << "RTCM std exception: " << ex.what() << std::endl;
+                                    LOG(ERROR) << "RTCM std exception: " << ex.what();
+                                }
+
+                            if (store_valid_observable)
+                                {
+                                    // store valid observables, sorted by channel
+                                    d_observables.insert(i, in[i][epoch]);
+                                }
                         }
                     else
                         {
@@ -2093,13 +4101,13 @@ int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_item
 
             // ############ 2 COMPUTE THE PVT ################################
             bool flag_pvt_valid = false;
-            if (gnss_observables_map.empty() == false)
+            if (d_observables.empty() == false)
                 {
-                    // LOG(INFO) << "diff raw obs time: " << gnss_observables_map.cbegin()->second.RX_time * 1000.0 - old_time_debug;
-                    // old_time_debug = gnss_observables_map.cbegin()->second.RX_time * 1000.0;
+                    // LOG(INFO) << "diff raw obs time: " << d_observables.cbegin()->second.RX_time * 1000.0 - old_time_debug;
+                    // old_time_debug = d_observables.cbegin()->second.RX_time * 1000.0;
                     uint32_t current_RX_time_ms = 0;
                     // #### solve PVT and store the corrected observable set
-                    if (d_internal_pvt_solver->get_PVT(gnss_observables_map, false))
+                    if (d_internal_pvt_solver->get_PVT(d_observables, false))
                         {
                             double Rx_clock_offset_s = d_internal_pvt_solver->get_time_offset_s();
                             if (fabs(Rx_clock_offset_s) * 1000.0 > max_obs_block_rx_clock_offset_ms)
@@ -2116,42 +4124,42 @@ int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_item
                                     if (d_enable_rx_clock_correction == true)
                                         {
                                             d_waiting_obs_block_rx_clock_offset_correction_msg = false;
-                                            gnss_observables_map_t0 = gnss_observables_map_t1;
-                                            apply_rx_clock_offset(gnss_observables_map, Rx_clock_offset_s);
-                                            gnss_observables_map_t1 = gnss_observables_map;
+                                            d_observables_t0 = d_observables_t1;
+                                            d_observables.apply_rx_clock_offset(Rx_clock_offset_s);
+                                            d_observables_t1 = d_observables;
 
                                             // ### select the rx_time and interpolate observables at that time
-                                            if (!gnss_observables_map_t0.empty())
+                                            if (!d_observables_t0.empty())
                                                 {
-                                                    uint32_t t0_int_ms = static_cast<uint32_t>(gnss_observables_map_t0.cbegin()->second.RX_time * 1000.0);
+                                                    uint32_t t0_int_ms = static_cast<uint32_t>(d_observables_t0.cbegin()->second.RX_time * 1000.0);
                                                     uint32_t adjust_next_20ms = 20 - t0_int_ms % 20;
                                                     current_RX_time_ms = t0_int_ms + adjust_next_20ms;
 
                                                     if (current_RX_time_ms % d_output_rate_ms == 0)
                                                         {
                                                             d_rx_time = static_cast<double>(current_RX_time_ms) / 1000.0;
-                                                            // std::cout << " obs time t0: " << gnss_observables_map_t0.cbegin()->second.RX_time
-                                                            //           << " t1: " << gnss_observables_map_t1.cbegin()->second.RX_time
+                                                            // std::cout << " obs time t0: " << d_observables_t0.cbegin()->second.RX_time
+                                                            //           << " t1: " << d_observables_t1.cbegin()->second.RX_time
                                                             //           << " interp time: " << d_rx_time << std::endl;
-                                                            gnss_observables_map = interpolate_observables(gnss_observables_map_t0,
-                                                                gnss_observables_map_t1,
+                                                            d_observables.interpolate(d_observables_t0,
+                                                                d_observables_t1,
                                                                 d_rx_time);
                                                             flag_compute_pvt_output = true;
                                                             // d_rx_time = current_RX_time;
                                                             // std::cout.precision(17);
-                                                            // std::cout << "current_RX_time: " << current_RX_time << " map time: " << gnss_observables_map.begin()->second.RX_time << std::endl;
+                                                            // std::cout << "current_RX_time: " << current_RX_time << " map time: " << d_observables.begin()->second.RX_time << std::endl;
                                                         }
                                                 }
                                         }
                                     else
                                         {
-                                            d_rx_time = gnss_observables_map.begin()->second.RX_time;
+                                            d_rx_time = d_observables.begin()->second.RX_time;
                                             current_RX_time_ms = static_cast<uint32_t>(d_rx_time * 1000.0);
                                             if (current_RX_time_ms % d_output_rate_ms == 0)
                                                 {
                                                     flag_compute_pvt_output = true;
                                                     // std::cout.precision(17);
-                                                    // std::cout << "current_RX_time: " << current_RX_time << " map time: " << gnss_observables_map.begin()->second.RX_time << std::endl;
+                                                    // std::cout << "current_RX_time: " << current_RX_time << " map time: " << d_observables.begin()->second.RX_time << std::endl;
                                                 }
                                             flag_pvt_valid = true;
                                         }
@@ -2166,7 +4174,7 @@ int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_item
                     // compute on the fly PVT solution
                     if (flag_compute_pvt_output == true)
                         {
-                            flag_pvt_valid = d_user_pvt_solver->get_PVT(gnss_observables_map, false);
+                            flag_pvt_valid = d_user_pvt_solver->get_PVT(d_observables, false);
                         }
 
                     if (flag_pvt_valid == true)
@@ -2267,1945 +4275,54 @@ int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_item
                                             send_sys_v_ttff_msg(ttff);
                                             first_fix = false;
                                         }
-                                    if (d_kml_output_enabled)
+                                    // hand the solution to the output writers
+                                    Pvt_Output_Record* output = acquire_output_record();
+                                    if (output != nullptr)
                                         {
-                                            if (current_RX_time_ms % d_kml_rate_ms == 0)
+                                            output->kind = Pvt_Output_Record::Epoch;
+                                            if (d_output_sink)
                                                 {
-                                                    d_kml_dump->print_position(d_user_pvt_solver, false);
+                                                    d_user_pvt_solver->get_output_snapshot(*output->pvt_solver);
                                                 }
-                                        }
-                                    if (d_gpx_output_enabled)
-                                        {
-                                            if (current_RX_time_ms % d_gpx_rate_ms == 0)
+                                            output->rx_time = d_rx_time;
+                                            output->rx_time_ms = current_RX_time_ms;
+                                            output->flag_write_RTCM_1019_output = flag_write_RTCM_1019_output;
+                                            output->flag_write_RTCM_1020_output = flag_write_RTCM_1020_output;
+                                            output->flag_write_RTCM_1045_output = flag_write_RTCM_1045_output;
+                                            output->flag_write_RTCM_MSM_output = flag_write_RTCM_MSM_output;
+                                            output->flag_write_RINEX_obs_output = flag_write_RINEX_obs_output;
+                                            // the printers take the observables as a map, which is only built at output epochs
+                                            if (flag_write_RINEX_obs_output or flag_write_RTCM_1019_output or flag_write_RTCM_1020_output or
+                                                flag_write_RTCM_1045_output or flag_write_RTCM_MSM_output or (!b_rtcm_writing_started and b_rtcm_enabled))
                                                 {
-                                                    d_gpx_dump->print_position(d_user_pvt_solver, false);
+                                                    d_observables.to_map(output->observables_map);
                                                 }
-                                        }
-                                    if (d_geojson_output_enabled)
-                                        {
-                                            if (current_RX_time_ms % d_geojson_rate_ms == 0)
+                                            else
                                                 {
-                                                    d_geojson_printer->print_position(d_user_pvt_solver, false);
+                                                    output->observables_map.clear();
                                                 }
+                                            commit_output_record(*output);
                                         }
-                                    if (d_nmea_output_file_enabled)
+                                    if (Latency_Tracer::instance().enabled())
                                         {
-                                            if (current_RX_time_ms % d_nmea_rate_ms == 0)
-                                                {
-                                                    d_nmea_printer->Print_Nmea_Line(d_user_pvt_solver, false);
-                                                }
-                                        }
-
-                                    /*
-                                     *   TYPE  |  RECEIVER
-                                     *     0   |  Unknown
-                                     *     1   |  GPS L1 C/A
-                                     *     2   |  GPS L2C
-                                     *     3   |  GPS L5
-                                     *     4   |  Galileo E1B
-                                     *     5   |  Galileo E5a
-                                     *     6   |  Galileo E5b
-                                     *     7   |  GPS L1 C/A + GPS L2C
-                                     *     8   |  GPS L1 C/A + GPS L5
-                                     *     9   |  GPS L1 C/A + Galileo E1B
-                                     *    10   |  GPS L1 C/A + Galileo E5a
-                                     *    11   |  GPS L1 C/A + Galileo E5b
-                                     *    12   |  Galileo E1B + GPS L2C
-                                     *    13   |  Galileo E5a + GPS L5
-                                     *    14   |  Galileo E1B + Galileo E5a
-                                     *    15   |  Galileo E1B + Galileo E5b
-                                     *    16   |  GPS L2C + GPS L5
-                                     *    17   |  GPS L2C + Galileo E5a
-                                     *    18   |  GPS L2C + Galileo E5b
-                                     *    21   |  GPS L1 C/A + Galileo E1B + GPS L2C
-                                     *    22   |  GPS L1 C/A + Galileo E1B + GPS L5
-                                     *    23   |  GLONASS L1 C/A
-                                     *    24   |  GLONASS L2 C/A
-                                     *    25   |  GLONASS L1 C/A + GLONASS L2 C/A
-                                     *    26   |  GPS L1 C/A + GLONASS L1 C/A
-                                     *    27   |  Galileo E1B + GLONASS L1 C/A
-                                     *    28   |  GPS L2C + GLONASS L1 C/A
-                                     *    29   |  GPS L1 C/A + GLONASS L2 C/A
-                                     *    30   |  Galileo E1B + GLONASS L2 C/A
-                                     *    31   |  GPS L2C + GLONASS L2 C/A
-                                     *    32   |  GPS L1 C/A + Galileo E1B + GPS L5 + Galileo E5a
-                                     *    500   |  BeiDou B1I
-                                     *    501   |  BeiDou B1I + GPS L1 C/A
-                                     *    502   |  BeiDou B1I + Galileo E1B
-                                     *    503   |  BeiDou B1I + GLONASS L1 C/A
-                                     *    504   |  BeiDou B1I + GPS L1 C/A + Galileo E1B
-                                     *    505   |  BeiDou B1I + GPS L1 C/A + GLONASS L1 C/A + Galileo E1B
-                                     *    506   |  BeiDou B1I + Beidou B3I
-                                     *    600   |  BeiDou B3I
-                                     *    601   |  BeiDou B3I + GPS L2C
-                                     *    602   |  BeiDou B3I + GLONASS L2 C/A
-                                     *    603   |  BeiDou B3I + GPS L2C + GLONASS L2 C/A
-                                     *    604   |  BeiDou B3I + GPS L1 C/A
-                                     *    605   |  BeiDou B3I + Galileo E1B
-                                     *    606   |  BeiDou B3I + GLONASS L1 C/A
-                                     *    607   |  BeiDou B3I + GPS L1 C/A + Galileo E1B
-                                     *    608   |  BeiDou B3I + GPS L1 C/A + Galileo E1B + BeiDou B1I
-                                     *    609   |  BeiDou B3I + GPS L1 C/A + Galileo E1B + GLONASS L1 C/A
-                                     *    610   |  BeiDou B3I + GPS L1 C/A + Galileo E1B + GLONASS L1 C/A + BeiDou B1I
-                                     *   1000   |  GPS L1 C/A + GPS L2C + GPS L5
-                                     *   1001   |  GPS L1 C/A + Galileo E1B + GPS L2C + GPS L5 + Galileo E5a
-                                     */
-
-                                    // ####################### RINEX FILES #################
-                                    if (b_rinex_output_enabled)
-                                        {
-                                            std::map<int, Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
-                                            std::map<int, Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
-                                            std::map<int, Gps_CNAV_Ephemeris>::const_iterator gps_cnav_ephemeris_iter;
-                                            std::map<int, Glonass_Gnav_Ephemeris>::const_iterator glonass_gnav_ephemeris_iter;
-                                            std::map<int, Beidou_Dnav_Ephemeris>::const_iterator beidou_dnav_ephemeris_iter;
-                                            if (!b_rinex_header_written)  // & we have utc data in nav message!
-                                                {
-                                                    galileo_ephemeris_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                    gps_ephemeris_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                    gps_cnav_ephemeris_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.cbegin();
-                                                    glonass_gnav_ephemeris_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                    beidou_dnav_ephemeris_iter = d_user_pvt_solver->beidou_dnav_ephemeris_map.cbegin();
-                                                    switch (type_of_rx)
-                                                        {
-                                                        case 1:  // GPS L1 C/A only
-                                                            if (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                {
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, d_rx_time);
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 2:  // GPS L2C only
-                                                            if (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend())
-                                                                {
-                                                                    std::string signal("2S");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_cnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 3:  // GPS L5 only
-                                                            if (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend())
-                                                                {
-                                                                    std::string signal("L5");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_cnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 4:  // Galileo E1B only
-                                                            if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                {
-                                                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time);
-                                                                    rp->rinex_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navGalFile, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 5:  // Galileo E5a only
-                                                            if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                {
-                                                                    std::string signal("5X");
-                                                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navGalFile, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 6:  // Galileo E5b only
-                                                            if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                {
-                                                                    std::string signal("7X");
-                                                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navGalFile, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 7:  // GPS L1 C/A + GPS L2C
-                                                            if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string signal("1C 2S");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_cnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 8:  // GPS L1 + GPS L5
-                                                            if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string signal("1C L5");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 9:  // GPS L1 C/A + Galileo E1B
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("1B");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 10:  // GPS L1 C/A + Galileo E5a
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("5X");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 11:  // GPS L1 C/A + Galileo E5b
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("7X");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 13:  // L5+E5a
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("5X");
-                                                                    std::string gps_signal("L5");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gps_signal, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_cnav_ephemeris_map, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 14:  // Galileo E1B + Galileo E5a
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("1B 5X");
-                                                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navGalFile, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 15:  // Galileo E1B + Galileo E5b
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("1B 7X");
-                                                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navGalFile, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 23:  // GLONASS L1 C/A only
-                                                            if (glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                {
-                                                                    std::string signal("1G");
-                                                                    rp->rinex_obs_header(rp->obsFile, glonass_gnav_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navGloFile, d_user_pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
-                                                                    rp->log_rinex_nav(rp->navGloFile, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 24:  // GLONASS L2 C/A only
-                                                            if (glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                {
-                                                                    std::string signal("2G");
-                                                                    rp->rinex_obs_header(rp->obsFile, glonass_gnav_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navGloFile, d_user_pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
-                                                                    rp->log_rinex_nav(rp->navGloFile, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 25:  // GLONASS L1 C/A + GLONASS L2 C/A
-                                                            if (glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                {
-                                                                    std::string signal("1G 2G");
-                                                                    rp->rinex_obs_header(rp->obsFile, glonass_gnav_ephemeris_iter->second, d_rx_time, signal);
-                                                                    rp->rinex_nav_header(rp->navGloFile, d_user_pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
-                                                                    rp->log_rinex_nav(rp->navGloFile, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 26:  // GPS L1 C/A + GLONASS L1 C/A
-                                                            if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string glo_signal("1G");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, glo_signal);
-                                                                    if (d_rinex_version == 3)
-                                                                        {
-                                                                            rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                        }
-                                                                    if (d_rinex_version == 2)
-                                                                        {
-                                                                            rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
-                                                                            rp->rinex_nav_header(rp->navGloFile, d_user_pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
-                                                                            rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_ephemeris_map);
-                                                                            rp->log_rinex_nav(rp->navGloFile, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                        }
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 27:  // Galileo E1B + GLONASS L1 C/A
-                                                            if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string glo_signal("1G");
-                                                                    std::string gal_signal("1B");
-                                                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, glo_signal, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->galileo_ephemeris_map, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 28:  // GPS L2C + GLONASS L1 C/A
-                                                            if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string glo_signal("1G");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, glo_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_cnav_ephemeris_map, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 29:  // GPS L1 C/A + GLONASS L2 C/A
-                                                            if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string glo_signal("2G");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, glo_signal);
-                                                                    if (d_rinex_version == 3)
-                                                                        {
-                                                                            rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                        }
-                                                                    if (d_rinex_version == 2)
-                                                                        {
-                                                                            rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
-                                                                            rp->rinex_nav_header(rp->navGloFile, d_user_pvt_solver->glonass_gnav_utc_model, glonass_gnav_ephemeris_iter->second);
-                                                                            rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_ephemeris_map);
-                                                                            rp->log_rinex_nav(rp->navGloFile, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                        }
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 30:  // Galileo E1B + GLONASS L2 C/A
-                                                            if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string glo_signal("2G");
-                                                                    std::string gal_signal("1B");
-                                                                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, glo_signal, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->galileo_ephemeris_map, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 31:  // GPS L2C + GLONASS L2 C/A
-                                                            if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string glo_signal("2G");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, glo_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_cnav_ephemeris_map, d_user_pvt_solver->glonass_gnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 32:  // L1+E1+L5+E5a
-                                                            if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and
-                                                                (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()) and
-                                                                (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("1B 5X");
-                                                                    std::string gps_signal("1C L5");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gps_signal, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 33:  // L1+E1+E5a
-                                                            if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and
-                                                                (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("1B 5X");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 500:  // BDS B1I only
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B1");
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->beidou_dnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 501:  // BeiDou B1I + GPS L1 C/A
-                                                            if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string bds_signal("B1");
-                                                                    // rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, beidou_dnav_ephemeris_iter->second, d_rx_time, bds_signal);
-                                                                    // rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 502:  // BeiDou B1I + Galileo E1B
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string bds_signal("B1");
-                                                                    std::string gal_signal("1B");
-                                                                    // rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, beidou_dnav_ephemeris_iter->second, d_rx_time, gal_signal, bds_signal);
-                                                                    // rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 503:  // BeiDou B1I + GLONASS L1 C/A
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B1");
-                                                                    // rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    // rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->beidou_dnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 504:  // BeiDou B1I + GPS L1 C/A + Galileo E1B
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B1");
-                                                                    // rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    // rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->beidou_dnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 505:  // BeiDou B1I + GPS L1 C/A + GLONASS L1 C/A + Galileo E1B
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B1");
-                                                                    // rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    // rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->beidou_dnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 506:  // BeiDou B1I + Beidou B3I
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    // rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B1");
-                                                                    // rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    // rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->beidou_dnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 600:  // BDS B3I only
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B3");
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->beidou_dnav_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 601:  // BeiDou B3I + GPS L2C
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B3");
-                                                                    // rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 602:  // BeiDou B3I + GLONASS L2 C/A
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B3");
-                                                                    // rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 603:  // BeiDou B3I + GPS L2C + GLONASS L2 C/A
-                                                            if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                {
-                                                                    rp->rinex_obs_header(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, "B3");
-                                                                    // rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_iono, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-
-                                                            break;
-                                                        case 1000:  // GPS L1 C/A + GPS L2C + GPS L5
-                                                            if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and
-                                                                (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gps_signal("1C 2S L5");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, d_rx_time, gps_signal);
-                                                                    rp->rinex_nav_header(rp->navFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second);
-                                                                    rp->log_rinex_nav(rp->navFile, d_user_pvt_solver->gps_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        case 1001:  // GPS L1 C/A + Galileo E1B + GPS L2C + GPS L5 + Galileo E5a
-                                                            if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and
-                                                                (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and
-                                                                (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                {
-                                                                    std::string gal_signal("1B 5X");
-                                                                    std::string gps_signal("1C 2S L5");
-                                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gps_signal, gal_signal);
-                                                                    rp->rinex_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                    rp->log_rinex_nav(rp->navMixFile, d_user_pvt_solver->gps_ephemeris_map, d_user_pvt_solver->galileo_ephemeris_map);
-                                                                    b_rinex_header_written = true;  // do not write header anymore
-                                                                }
-                                                            break;
-                                                        default:
-                                                            break;
-                                                        }
-                                                }
-                                            if (b_rinex_header_written)  // The header is already written, we can now log the navigation message data
+                                            // the solution is as recent as the newest samples it used
+                                            uint64_t sample_counter = 0;
+                                            for (const auto& observable : d_observables)
                                                 {
-                                                    galileo_ephemeris_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                    gps_ephemeris_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                    gps_cnav_ephemeris_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.cbegin();
-                                                    glonass_gnav_ephemeris_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                    beidou_dnav_ephemeris_iter = d_user_pvt_solver->beidou_dnav_ephemeris_map.cbegin();
-
-                                                    // Log observables into the RINEX file
-                                                    if (flag_write_RINEX_obs_output)
-                                                        {
-                                                            switch (type_of_rx)
-                                                                {
-                                                                case 1:  // GPS L1 C/A only
-                                                                    if (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0))
-                                                                                {
-                                                                                    rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                    rp->update_nav_header(rp->navFile, d_user_pvt_solver->gps_utc_model, d_user_pvt_solver->gps_iono, gps_ephemeris_iter->second);
-                                                                                    b_rinex_header_updated = true;
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 2:  // GPS L2C only
-                                                                    if (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                            rp->update_nav_header(rp->navFile, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->gps_cnav_iono);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 3:  // GPS L5
-                                                                    if (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                            rp->update_nav_header(rp->navFile, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->gps_cnav_iono);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 4:  // Galileo E1B only
-                                                                    if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map, "1B");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->galileo_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 5:  // Galileo E5a only
-                                                                    if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map, "5X");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->galileo_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 6:  // Galileo E5b only
-                                                                    if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map, "7X");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->galileo_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 7:  // GPS L1 C/A + GPS L2C
-                                                                    if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0))
-                                                                                {
-                                                                                    rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                    rp->update_nav_header(rp->navFile, d_user_pvt_solver->gps_utc_model, d_user_pvt_solver->gps_iono, gps_ephemeris_iter->second);
-                                                                                    b_rinex_header_updated = true;
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 8:  // L1+L5
-                                                                    if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and ((d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0) or (d_user_pvt_solver->gps_utc_model.d_A0 != 0)))
-                                                                                {
-                                                                                    if (d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0)
-                                                                                        {
-                                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                                            rp->update_nav_header(rp->navFile, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->gps_cnav_iono);
-                                                                                        }
-                                                                                    else
-                                                                                        {
-                                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                            rp->update_nav_header(rp->navFile, d_user_pvt_solver->gps_utc_model, d_user_pvt_solver->gps_iono, gps_ephemeris_iter->second);
-                                                                                        }
-                                                                                    b_rinex_header_updated = true;
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 9:  // GPS L1 C/A + Galileo E1B
-                                                                    if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0))
-                                                                                {
-                                                                                    rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                    rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                                    b_rinex_header_updated = true;
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 13:  // L5+E5a
-                                                                    if ((gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()) and (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0) and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                            b_rinex_header_updated = true;  // do not write header anymore
-                                                                        }
-                                                                    break;
-                                                                case 14:  // Galileo E1B + Galileo E5a
-                                                                    if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map, "1B 5X");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->galileo_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 15:  // Galileo E1B + Galileo E5b
-                                                                    if (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map, "1B 7X");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navGalFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->galileo_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 23:  // GLONASS L1 C/A only
-                                                                    if (glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, "1C");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->glonass_gnav_utc_model.d_tau_c != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navGloFile, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 24:  // GLONASS L2 C/A only
-                                                                    if (glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, "2C");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->glonass_gnav_utc_model.d_tau_c != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navGloFile, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 25:  // GLONASS L1 C/A + GLONASS L2 C/A
-                                                                    if (glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, "1C 2C");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->glonass_gnav_utc_model.d_tau_c != 0))
-                                                                        {
-                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 26:  // GPS L1 C/A + GLONASS L1 C/A
-                                                                    if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0))
-                                                                                {
-                                                                                    rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                    rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                                    b_rinex_header_updated = true;  // do not write header anymore
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 27:  // Galileo E1B + GLONASS L1 C/A
-                                                                    if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->galileo_utc_model);
-                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            b_rinex_header_updated = true;  // do not write header anymore
-                                                                        }
-                                                                    break;
-                                                                case 28:  // GPS L2C + GLONASS L1 C/A
-                                                                    if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            b_rinex_header_updated = true;  // do not write header anymore
-                                                                        }
-                                                                    break;
-                                                                case 29:  // GPS L1 C/A + GLONASS L2 C/A
-                                                                    if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0))
-                                                                                {
-                                                                                    rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                    rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                                    b_rinex_header_updated = true;  // do not write header anymore
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 30:  // Galileo E1B + GLONASS L2 C/A
-                                                                    if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->galileo_utc_model);
-                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            b_rinex_header_updated = true;  // do not write header anymore
-                                                                        }
-                                                                    break;
-                                                                case 31:  // GPS L2C + GLONASS L2 C/A
-                                                                    if ((glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_cnav_ephemeris_iter->second, glonass_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->glonass_gnav_utc_model, d_user_pvt_solver->glonass_gnav_almanac);
-                                                                            b_rinex_header_updated = true;  // do not write header anymore
-                                                                        }
-                                                                    break;
-                                                                case 32:  // L1+E1+L5+E5a
-                                                                    if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()) and (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and ((d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0) or (d_user_pvt_solver->gps_utc_model.d_A0 != 0)) and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                                {
-                                                                                    if (d_user_pvt_solver->gps_cnav_utc_model.d_A0 != 0)
-                                                                                        {
-                                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_cnav_utc_model);
-                                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_cnav_utc_model, d_user_pvt_solver->gps_cnav_iono, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                                        }
-                                                                                    else
-                                                                                        {
-                                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                                        }
-                                                                                    b_rinex_header_updated = true;  // do not write header anymore
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 33:  // L1+E1+E5a
-                                                                    if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map);
-                                                                            if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0) and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                                {
-                                                                                    rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                                    rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                                    b_rinex_header_updated = true;  // do not write header anymore
-                                                                                }
-                                                                        }
-                                                                    break;
-                                                                case 500:  // BDS B1I only
-                                                                    if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, "B1");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->beidou_dnav_utc_model.d_A0_UTC != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                            rp->update_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_utc_model, d_user_pvt_solver->beidou_dnav_iono);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 600:  // BDS B3I only
-                                                                    if (beidou_dnav_ephemeris_iter != d_user_pvt_solver->beidou_dnav_ephemeris_map.cend())
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, beidou_dnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, "B3");
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->beidou_dnav_utc_model.d_A0_UTC != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->beidou_dnav_utc_model);
-                                                                            rp->update_nav_header(rp->navFile, d_user_pvt_solver->beidou_dnav_utc_model, d_user_pvt_solver->beidou_dnav_iono);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 1000:  // GPS L1 C/A + GPS L2C + GPS L5
-                                                                    if ((gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and
-                                                                        (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, true);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                            rp->update_nav_header(rp->navFile, d_user_pvt_solver->gps_utc_model, d_user_pvt_solver->gps_iono, gps_ephemeris_iter->second);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                case 1001:  // GPS L1 C/A + Galileo E1B + GPS L2C + GPS L5 + Galileo E5a
-                                                                    if ((galileo_ephemeris_iter != d_user_pvt_solver->galileo_ephemeris_map.cend()) and
-                                                                        (gps_ephemeris_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and
-                                                                        (gps_cnav_ephemeris_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, gps_cnav_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gnss_observables_map, true);
-                                                                        }
-                                                                    if (!b_rinex_header_updated and (d_user_pvt_solver->gps_utc_model.d_A0 != 0) and (d_user_pvt_solver->galileo_utc_model.A0_6 != 0))
-                                                                        {
-                                                                            rp->update_obs_header(rp->obsFile, d_user_pvt_solver->gps_utc_model);
-                                                                            rp->update_nav_header(rp->navMixFile, d_user_pvt_solver->gps_iono, d_user_pvt_solver->gps_utc_model, gps_ephemeris_iter->second, d_user_pvt_solver->galileo_iono, d_user_pvt_solver->galileo_utc_model);
-                                                                            b_rinex_header_updated = true;
-                                                                        }
-                                                                    break;
-                                                                default:
-                                                                    break;
-                                                                }
-                                                        }
+                                                    sample_counter = std::max(sample_counter, observable.second.Tracking_sample_counter);
                                                 }
+                                            Latency_Tracer::instance().record(Latency_Tracer::Pvt, sample_counter);
                                         }
-
-                                    // ####################### RTCM MESSAGES #################
-                                    try
+                                    if (!d_snapshot_file.empty() and d_snapshot_rate_ms != 0 and current_RX_time_ms % d_snapshot_rate_ms == 0)
                                         {
-                                            if (b_rtcm_writing_started and b_rtcm_enabled)
-                                                {
-                                                    switch (type_of_rx)
-                                                        {
-                                                        case 1:  // GPS L1 C/A
-                                                            if (flag_write_RTCM_1019_output == true)
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 4:
-                                                        case 5:
-                                                        case 6:
-                                                            if (flag_write_RTCM_1045_output == true)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 7:  // GPS L1 C/A + GPS L2C
-                                                            if (flag_write_RTCM_1019_output == true)
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto gps_cnav_eph_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.cbegin();
-                                                                    if ((gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_eph_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 8:  // L1+L5
-                                                            if (flag_write_RTCM_1019_output == true)
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto gps_cnav_eph_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.cbegin();
-                                                                    if ((gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_eph_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 9:  // GPS L1 C/A + Galileo E1B
-                                                            if (flag_write_RTCM_1019_output == true)
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_1045_output == true)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    int gps_channel = 0;
-                                                                    int gal_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 13:  // L5+E5a
-                                                            if (flag_write_RTCM_1045_output == true)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-
-                                                            if (flag_write_RTCM_MSM_output and d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto gps_cnav_eph_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.cbegin();
-                                                                    int gal_channel = 0;
-                                                                    int gps_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_cnav_eph_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_cnav_eph_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend() and (d_rtcm_MT1097_rate_ms != 0))
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gps_cnav_eph_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend() and (d_rtcm_MT1077_rate_ms != 0))
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, gps_cnav_eph_iter->second, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 14:
-                                                        case 15:
-                                                            if (flag_write_RTCM_1045_output == true)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 23:
-                                                        case 24:
-                                                        case 25:
-                                                            if (flag_write_RTCM_1020_output == true)
-                                                                {
-                                                                    for (auto glonass_gnav_ephemeris_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_ephemeris_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_ephemeris_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    auto glo_gnav_ephemeris_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    if (glo_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glo_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 26:  // GPS L1 C/A + GLONASS L1 C/A
-                                                            if (flag_write_RTCM_1019_output == true)
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_1020_output == true)
-                                                                {
-                                                                    for (auto glonass_gnav_ephemeris_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_ephemeris_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_ephemeris_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    int gps_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 27:  // GLONASS L1 C/A + Galileo E1B
-                                                            if (flag_write_RTCM_1020_output == true)
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_1045_output == true)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    int gal_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 29:  // GPS L1 C/A + GLONASS L2 C/A
-                                                            if (flag_write_RTCM_1019_output == true)
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_1020_output == true)
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    int gps_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 30:  // GLONASS L2 C/A + Galileo E1B
-                                                            if (flag_write_RTCM_1020_output == true)
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_1045_output == true)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    int gal_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        case 32:  // L1+E1+L5+E5a
-                                                            if (flag_write_RTCM_1019_output == true)
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_1045_output == true)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (flag_write_RTCM_MSM_output == true)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    int gal_channel = 0;
-                                                                    int gps_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            break;
-                                                        default:
-                                                            break;
-                                                        }
-                                                }
-
-                                            if (!b_rtcm_writing_started and b_rtcm_enabled)  // the first time
+                                            Pvt_Output_Record* record = acquire_output_record();
+                                            if (record != nullptr)
                                                 {
-                                                    switch (type_of_rx)
-                                                        {
-                                                        case 1:                              // GPS L1 C/A
-                                                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 4:
-                                                        case 5:
-                                                        case 6:
-                                                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 7:                              // GPS L1 C/A + GPS L2C
-                                                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto gps_cnav_eph_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.cbegin();
-                                                                    if ((gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_eph_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 8:                              // L1+L5
-                                                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto gps_cnav_eph_iter = d_user_pvt_solver->gps_cnav_ephemeris_map.cbegin();
-                                                                    if ((gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend()) and (gps_cnav_eph_iter != d_user_pvt_solver->gps_cnav_ephemeris_map.cend()))
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, gps_cnav_eph_iter->second, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 9:                              // GPS L1 C/A + Galileo E1B
-                                                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MT1045_rate_ms != 0)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    int gps_channel = 0;
-                                                                    int gal_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-
-                                                        case 13:  // L5+E5a
-                                                            if (d_rtcm_MT1045_rate_ms != 0)
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    int gal_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend() and (d_rtcm_MT1097_rate_ms != 0))
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 14:
-                                                        case 15:
-                                                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 23:
-                                                        case 24:
-                                                        case 25:
-                                                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    auto glo_gnav_ephemeris_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    if (glo_gnav_ephemeris_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glo_gnav_ephemeris_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 26:                             // GPS L1 C/A + GLONASS L1 C/A
-                                                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    int gps_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 27:                             // GLONASS L1 C/A + Galileo E1B
-                                                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    int gal_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 29:                             // GPS L1 C/A + GLONASS L2 C/A
-                                                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    int gps_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 30:                             // GLONASS L2 C/A + Galileo E1B
-                                                            if (d_rtcm_MT1020_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin(); glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend(); glonass_gnav_eph_iter++)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1020(glonass_gnav_eph_iter->second, d_user_pvt_solver->glonass_gnav_utc_model);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    int gal_channel = 0;
-                                                                    int glo_channel = 0;
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.cbegin();
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (glo_channel == 0)
-                                                                                {
-                                                                                    if (system == "R")
-                                                                                        {
-                                                                                            glonass_gnav_eph_iter = d_user_pvt_solver->glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    glo_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (glonass_gnav_eph_iter != d_user_pvt_solver->glonass_gnav_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, {}, glonass_gnav_eph_iter->second, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        case 32:                             // L1+E1+L5+E5a
-                                                            if (d_rtcm_MT1019_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gps_eph_iter : d_user_pvt_solver->gps_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MT1045_rate_ms != 0)  // allows deactivating messages by setting rate = 0
-                                                                {
-                                                                    for (const auto& gal_eph_iter : d_user_pvt_solver->galileo_ephemeris_map)
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_eph_iter.second);
-                                                                        }
-                                                                }
-                                                            if (d_rtcm_MSM_rate_ms != 0)
-                                                                {
-                                                                    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
-                                                                    auto gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.cbegin();
-                                                                    auto gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.cbegin();
-                                                                    int gps_channel = 0;
-                                                                    int gal_channel = 0;
-                                                                    for (gnss_observables_iter = gnss_observables_map.cbegin(); gnss_observables_iter != gnss_observables_map.cend(); gnss_observables_iter++)
-                                                                        {
-                                                                            std::string system(&gnss_observables_iter->second.System, 1);
-                                                                            if (gps_channel == 0)
-                                                                                {
-                                                                                    if (system == "G")
-                                                                                        {
-                                                                                            // This is a channel with valid GPS signal
-                                                                                            gps_eph_iter = d_user_pvt_solver->gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gps_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                            if (gal_channel == 0)
-                                                                                {
-                                                                                    if (system == "E")
-                                                                                        {
-                                                                                            gal_eph_iter = d_user_pvt_solver->galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                                                                            if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                                                {
-                                                                                                    gal_channel = 1;
-                                                                                                }
-                                                                                        }
-                                                                                }
-                                                                        }
-                                                                    if (gps_eph_iter != d_user_pvt_solver->gps_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_eph_iter->second, {}, {}, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                    if (gal_eph_iter != d_user_pvt_solver->galileo_ephemeris_map.cend())
-                                                                        {
-                                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_eph_iter->second, {}, d_rx_time, gnss_observables_map, d_enable_rx_clock_correction, 0, 0, false, false);
-                                                                        }
-                                                                }
-                                                            b_rtcm_writing_started = true;
-                                                            break;
-                                                        default:
-                                                            break;
-                                                        }
+                                                    record->kind = Pvt_Output_Record::Snapshot;
+                                                    record->snapshot = take_state_snapshot();
+                                                    commit_output_record(*record);
                                                 }
                                         }
-                                    catch (const boost::exception& ex)
-                                        {
-                                            std::cout << "RTCM boost exception: " << boost::diagnostic_information(ex) << std::endl;
-                                            LOG(ERROR) << "RTCM boost exception: " << boost::diagnostic_information(ex);
-                                        }
-                                    catch (const std::exception& ex)
-                                        {
-                                            std::cout << "RTCM std exception: " << ex.what() << std::endl;
-                                            LOG(ERROR) << "RTCM std exception: " << ex.what();
-                                        }
                                 }
                         }
 
@@ -4250,7 +4367,7 @@ int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_item
                             DLOG(INFO) << "RX clock drift: " << d_user_pvt_solver->get_clock_drift_ppm() << " [ppm]";
 
                             // boost::posix_time::ptime p_time;
-                            // gtime_t rtklib_utc_time = gpst2time(adjgpsweek(d_user_pvt_solver->gps_ephemeris_map.cbegin()->second.i_GPS_week), d_rx_time);
+                            // gtime_t rtklib_utc_time = gpst2time(adjgpsweek(d_user_pvt_solver->get_gps_ephemeris_map().cbegin()->second.i_GPS_week), d_rx_time);
                             // p_time = boost::posix_time::from_time_t(rtklib_utc_time.time);
                             // p_time += boost::posix_time::microseconds(round(rtklib_utc_time.sec * 1e6));
                             // std::cout << TEXT_MAGENTA << "Observable RX time (GPST) " << boost::posix_time::to_simple_string(p_time) << TEXT_RESET << std::endl;
@@ -4268,16 +4385,22 @@ int rtklib_pvt_gs::work(int noutput_items, gr_vector_const_void_star& input_item
                     // PVT MONITOR
                     if (d_user_pvt_solver->is_valid_position())
                         {
-                            std::shared_ptr<Monitor_Pvt> monitor_pvt = std::make_shared<Monitor_Pvt>(d_user_pvt_solver->get_monitor_pvt());
-
                             // publish new position to the gnss_flowgraph channel status monitor
                             if (current_RX_time_ms % d_report_rate_ms == 0)
                                 {
+                                    // the receiver keeps the message, so it gets its own copy
+                                    std::shared_ptr<Monitor_Pvt> monitor_pvt = std::make_shared<Monitor_Pvt>(d_user_pvt_solver->get_monitor_pvt());
                                     this->message_port_pub(pmt::mp("status"), pmt::make_any(monitor_pvt));
                                 }
                             if (flag_monitor_pvt_enabled)
                                 {
-                                    udp_sink_ptr->write_monitor_pvt(monitor_pvt);
+                                    Pvt_Output_Record* record = acquire_output_record();
+                                    if (record != nullptr)
+                                        {
+                                            record->kind = Pvt_Output_Record::Monitor;
+                                            *record->monitor_pvt = d_user_pvt_solver->get_monitor_pvt();
+                                            commit_output_record(*record);
+                                        }
                                 }
                         }
                 }
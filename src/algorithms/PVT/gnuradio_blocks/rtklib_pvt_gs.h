@@ -20,13 +20,22 @@
 #ifndef GNSS_SDR_RTKLIB_PVT_GS_H
 #define GNSS_SDR_RTKLIB_PVT_GS_H
 
+#include "beidou_dnav_ephemeris.h"
+#include "galileo_ephemeris.h"
+#include "glonass_gnav_ephemeris.h"
 #include "gnss_synchro.h"
+#include "gps_cnav_ephemeris.h"
+#include "gps_ephemeris.h"
+#include "monitor_pvt.h"
+#include "observables_epoch.h"
+#include "pvt_output_sink.h"
 #include "rtklib.h"
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <gnuradio/sync_block.h>  // for sync_block
 #include <gnuradio/types.h>       // for gr_vector_const_void_star
 #include <pmt/pmt.h>              // for pmt_t
+#include <atomic>                 // for atomic
 #include <chrono>                 // for system_clock
 #include <cstdint>                // for int32_t
 #include <ctime>                  // for time_t
@@ -42,17 +51,15 @@
 #endif
 
 class Beidou_Dnav_Almanac;
-class Beidou_Dnav_Ephemeris;
 class Galileo_Almanac;
-class Galileo_Ephemeris;
 class GeoJSON_Printer;
 class Gps_Almanac;
-class Gps_Ephemeris;
 class Gpx_Printer;
 class Kml_Printer;
 class Monitor_Pvt_Udp_Sink;
 class Nmea_Printer;
 class Pvt_Conf;
+class Receiver_State_Snapshot;
 class Rinex_Printer;
 class Rtcm_Printer;
 class Rtklib_Solver;
@@ -133,31 +140,51 @@ private:
         const Pvt_Conf& conf_,
         const rtk_t& rtk);
 
-    void msg_handler_telemetry(const pmt::pmt_t& msg);
-
-    enum StringValue
+    /*!
+     * \brief Data needed by the output writers for one output epoch, one
+     * monitor message, the new ephemeris of one satellite or one receiver
+     * state snapshot. The records are reused by the output sink.
+     */
+    struct Pvt_Output_Record
     {
-        evGPS_1C,
-        evGPS_2S,
-        evGPS_L5,
-        evSBAS_1C,
-        evGAL_1B,
-        evGAL_5X,
-        evGLO_1G,
-        evGLO_2G,
-        evBDS_B1,
-        evBDS_B2,
-        evBDS_B3
+        enum Kind
+        {
+            Epoch,
+            Monitor,
+            Gps_Navigation,
+            Gps_Cnav_Navigation,
+            Galileo_Navigation,
+            Glonass_Navigation,
+            Beidou_Navigation,
+            Snapshot
+        };
+        Kind kind{Epoch};
+        std::shared_ptr<Rtklib_Solver> pvt_solver;
+        std::map<int, Gnss_Synchro> observables_map;
+        double rx_time{0.0};
+        uint32_t rx_time_ms{0};
+        bool flag_write_RTCM_1019_output{false};
+        bool flag_write_RTCM_1020_output{false};
+        bool flag_write_RTCM_1045_output{false};
+        bool flag_write_RTCM_MSM_output{false};
+        bool flag_write_RINEX_obs_output{false};
+        std::shared_ptr<Monitor_Pvt> monitor_pvt{std::make_shared<Monitor_Pvt>()};  // overwritten in place
+        std::map<int32_t, Gps_Ephemeris> gps_ephemeris;
+        std::map<int32_t, Gps_CNAV_Ephemeris> gps_cnav_ephemeris;
+        std::map<int32_t, Galileo_Ephemeris> galileo_ephemeris;
+        std::map<int32_t, Glonass_Gnav_Ephemeris> glonass_gnav_ephemeris;
+        std::map<int32_t, Beidou_Dnav_Ephemeris> beidou_dnav_ephemeris;
+        std::shared_ptr<Receiver_State_Snapshot> snapshot;
     };
 
-    std::map<std::string, StringValue> mapStringValues_;
-
-    void apply_rx_clock_offset(std::map<int, Gnss_Synchro>& observables_map,
-        double rx_clock_offset_s);
+    void msg_handler_telemetry(const pmt::pmt_t& msg);
 
-    std::map<int, Gnss_Synchro> interpolate_observables(std::map<int, Gnss_Synchro>& observables_map_t0,
-        std::map<int, Gnss_Synchro>& observables_map_t1,
-        double rx_time_s);
+    Pvt_Output_Record* acquire_output_record();                            // a record of the output sink, or the synchronous one. nullptr if dropped
+    void commit_output_record(Pvt_Output_Record& record);                  // hands the record to the output sink, or writes it if there is none
+    void write_output_record(Pvt_Output_Record& record);                   // passes the record to its writer
+    void write_outputs(const Pvt_Output_Record& output);                   // KML, GPX, GeoJSON, NMEA, RINEX and RTCM
+    void write_rinex_nav(const Pvt_Output_Record& record);                 // the new ephemeris, once the RINEX header is written
+    std::shared_ptr<Receiver_State_Snapshot> take_state_snapshot() const;  // navigation data, last fix and Doppler, for warm starts
 
     bool d_dump;
     bool d_dump_mat;
@@ -167,7 +194,7 @@ private:
     double d_rinex_version;
     int32_t d_rinexobs_rate_ms;
 
-    bool b_rtcm_writing_started;
+    std::atomic<bool> b_rtcm_writing_started;
     bool b_rtcm_enabled;
     int32_t d_rtcm_MT1045_rate_ms;  // Galileo Broadcast Ephemeris
     int32_t d_rtcm_MT1019_rate_ms;  // GPS Broadcast Ephemeris (orbits)
@@ -199,6 +226,9 @@ private:
     std::shared_ptr<Rtcm_Printer> d_rtcm_printer;
     double d_rx_time;
 
+    std::unique_ptr<Pvt_Output_Sink<Pvt_Output_Record>> d_output_sink;  // nullptr if the outputs are written synchronously
+    Pvt_Output_Record d_output_record;                                  // used if there is no output sink
+
     bool d_geojson_output_enabled;
     bool d_gpx_output_enabled;
     bool d_kml_output_enabled;
@@ -210,9 +240,10 @@ private:
     int32_t max_obs_block_rx_clock_offset_ms;
     bool d_waiting_obs_block_rx_clock_offset_correction_msg;
     bool d_enable_rx_clock_correction;
-    std::map<int, Gnss_Synchro> gnss_observables_map;
-    std::map<int, Gnss_Synchro> gnss_observables_map_t0;
-    std::map<int, Gnss_Synchro> gnss_observables_map_t1;
+    Observables_Epoch d_observables;
+    Observables_Epoch d_observables_t0;
+    Observables_Epoch d_observables_t1;
+    std::map<int, Gnss_Synchro> gnss_observables_map;  // only filled at RINEX and RTCM output epochs
 
     std::vector<double> initial_carrier_phase_offset_estimation_rads;
     std::vector<bool> channel_initialized;
@@ -237,6 +268,9 @@ private:
     bool d_xml_storage;
     std::string xml_base_path;
 
+    std::string d_snapshot_file;
+    int32_t d_snapshot_rate_ms;
+
     inline std::time_t convert_to_time_t(const boost::posix_time::ptime pt) const
     {
         return (pt - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_seconds();
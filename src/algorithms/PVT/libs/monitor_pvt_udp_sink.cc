@@ -20,18 +20,12 @@
 
 #include "monitor_pvt_udp_sink.h"
 #include <boost/archive/binary_oarchive.hpp>
-#include <iostream>
-#include <sstream>
+#include <exception>
+#include <ostream>
 
 
-Monitor_Pvt_Udp_Sink::Monitor_Pvt_Udp_Sink(const std::vector<std::string>& addresses, const uint16_t& port, bool protobuf_enabled) : socket{io_context}
+Monitor_Pvt_Udp_Sink::Monitor_Pvt_Udp_Sink(const std::vector<std::string>& addresses, const uint16_t& port, bool protobuf_enabled) : udp_transport(addresses, port)
 {
-    for (const auto& address : addresses)
-        {
-            boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::address::from_string(address, error), port);
-            endpoints.push_back(endpoint);
-        }
-
     use_protobuf = protobuf_enabled;
     if (use_protobuf)
         {
@@ -42,32 +36,38 @@ Monitor_Pvt_Udp_Sink::Monitor_Pvt_Udp_Sink(const std::vector<std::string>& addre
 
 bool Monitor_Pvt_Udp_Sink::write_monitor_pvt(const std::shared_ptr<Monitor_Pvt>& monitor_pvt)
 {
-    std::string outbound_data;
-    if (use_protobuf == false)
+    uint8_t* datagram = udp_transport.claim();
+    if (datagram == nullptr)
         {
-            std::ostringstream archive_stream;
-            boost::archive::binary_oarchive oa{archive_stream};
-            oa << *monitor_pvt.get();
-            outbound_data = archive_stream.str();
+            return false;
         }
-    else
-        {
-            outbound_data = serdes.createProtobuffer(monitor_pvt);
-        }
-
-    for (const auto& endpoint : endpoints)
+    std::size_t length = 0;
+    if (use_protobuf == false)
         {
-            socket.open(endpoint.protocol(), error);
-            socket.connect(endpoint, error);
-
+            Monitor_Datagram_Buffer buffer(datagram, udp_transport.datagram_size());
             try
                 {
-                    socket.send(boost::asio::buffer(outbound_data));
+                    std::ostream archive_stream(&buffer);
+                    boost::archive::binary_oarchive oa{archive_stream};
+                    oa << *monitor_pvt.get();
+                }
+            catch (const std::exception& e)
+                {
+                    udp_transport.drop();
+                    return false;
                 }
-            catch (boost::system::system_error const& e)
+            length = buffer.size();
+        }
+    else
+        {
+            length = serdes.createProtobuffer(*monitor_pvt, datagram, udp_transport.datagram_size());
+            if (length == 0)
                 {
+                    udp_transport.drop();
                     return false;
                 }
         }
+    udp_transport.publish(length);
+    udp_transport.wake();
     return true;
 }
@@ -22,18 +22,16 @@
 #define GNSS_SDR_MONITOR_PVT_UDP_SINK_H
 
 #include "monitor_pvt.h"
+#include "monitor_udp_transport.h"
 #include "serdes_monitor_pvt.h"
-#include <boost/asio.hpp>
 #include <memory>
 #include <string>
 #include <vector>
 
-#if BOOST_GREATER_1_65
-using b_io_context = boost::asio::io_context;
-#else
-using b_io_context = boost::asio::io_service;
-#endif
-
+/*!
+ * \brief Sends serialized Monitor_Pvt objects over UDP to one or multiple
+ * endpoints, through the persistent sockets of a Monitor_Udp_Transport.
+ */
 class Monitor_Pvt_Udp_Sink
 {
 public:
@@ -41,10 +39,7 @@ public:
     bool write_monitor_pvt(const std::shared_ptr<Monitor_Pvt>& monitor_pvt);
 
 private:
-    b_io_context io_context;
-    boost::asio::ip::udp::socket socket;
-    boost::system::error_code error;
-    std::vector<boost::asio::ip::udp::endpoint> endpoints;
+    Monitor_Udp_Transport udp_transport;
     Serdes_Monitor_Pvt serdes;
     bool use_protobuf;
 };
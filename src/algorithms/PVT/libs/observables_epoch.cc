@@ -0,0 +1,220 @@
+/*!
+ * \file observables_epoch.cc
+ * \brief Fixed-capacity container of the observables of one epoch, indexed by
+ * channel
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "observables_epoch.h"
+#include "MATH_CONSTANTS.h"
+#include "gnss_frequencies.h"
+#include <algorithm>
+
+
+Observables_Epoch::Observables_Epoch(uint32_t nchannels)
+{
+    d_observables.reserve(nchannels);
+}
+
+
+Observables_Epoch::Signal_Id Observables_Epoch::signal_id(const char* signal)
+{
+    switch (signal[0])
+        {
+        case '1':
+            switch (signal[1])
+                {
+                case 'C':
+                    return evGPS_1C;
+                case 'B':
+                    return evGAL_1B;
+                case 'G':
+                    return evGLO_1G;
+                default:
+                    return evUNKNOWN;
+                }
+        case '2':
+            switch (signal[1])
+                {
+                case 'S':
+                    return evGPS_2S;
+                case 'G':
+                    return evGLO_2G;
+                default:
+                    return evUNKNOWN;
+                }
+        case '5':
+            return signal[1] == 'X' ? evGAL_5X : evUNKNOWN;
+        case '7':
+            return signal[1] == 'X' ? evGAL_7X : evUNKNOWN;
+        case 'L':
+            return signal[1] == '5' ? evGPS_L5 : evUNKNOWN;
+        case 'B':
+            switch (signal[1])
+                {
+                case '1':
+                    return evBDS_B1;
+                case '2':
+                    return evBDS_B2;
+                case '3':
+                    return evBDS_B3;
+                default:
+                    return evUNKNOWN;
+                }
+        default:
+            return evUNKNOWN;
+        }
+}
+
+
+double Observables_Epoch::carrier_frequency_hz(Signal_Id signal)
+{
+    switch (signal)
+        {
+        case evGPS_1C:
+        case evSBAS_1C:
+        case evGAL_1B:
+            return FREQ1;
+        case evGPS_2S:
+            return FREQ2;
+        case evGPS_L5:
+        case evGAL_5X:
+            return FREQ5;
+        case evGAL_7X:
+            return FREQ7;
+        case evGLO_1G:
+            return FREQ1_GLO;
+        case evGLO_2G:
+            return FREQ2_GLO;
+        case evBDS_B1:
+            return FREQ1_BDS;
+        case evBDS_B2:
+            return FREQ2_BDS;
+        case evBDS_B3:
+            return FREQ3_BDS;
+        default:
+            return 0.0;
+        }
+}
+
+
+void Observables_Epoch::clear()
+{
+    d_observables.clear();
+}
+
+
+void Observables_Epoch::insert(int channel, const Gnss_Synchro& gnss_synchro)
+{
+    if (d_observables.empty() or d_observables.back().first < channel)
+        {
+            d_observables.emplace_back(channel, gnss_synchro);
+            return;
+        }
+    auto it = std::lower_bound(d_observables.begin(), d_observables.end(), channel,
+        [](const value_type& element, int ch) { return element.first < ch; });
+    if (it != d_observables.end() and it->first == channel)
+        {
+            // keep the behavior of std::map::insert
+            return;
+        }
+    d_observables.emplace(it, channel, gnss_synchro);
+}
+
+
+Observables_Epoch::const_iterator Observables_Epoch::find(int channel) const
+{
+    auto it = std::lower_bound(d_observables.cbegin(), d_observables.cend(), channel,
+        [](const value_type& element, int ch) { return element.first < ch; });
+    if (it != d_observables.cend() and it->first == channel)
+        {
+            return it;
+        }
+    return d_observables.cend();
+}
+
+
+void Observables_Epoch::apply_rx_clock_offset(double rx_clock_offset_s)
+{
+    // apply corrections according to Rinex 3.04, Table 1: Observation Corrections for Receiver Clock Offset
+    for (auto& observable : d_observables)
+        {
+            // all the stored observables are valid
+            observable.second.RX_time -= rx_clock_offset_s;
+            observable.second.Pseudorange_m -= rx_clock_offset_s * SPEED_OF_LIGHT;
+            observable.second.Carrier_phase_rads -= rx_clock_offset_s * carrier_frequency_hz(signal_id(observable.second.Signal)) * PI_2;
+        }
+}
+
+
+void Observables_Epoch::interpolate(const Observables_Epoch& observables_t0,
+    const Observables_Epoch& observables_t1,
+    double rx_time_s)
+{
+    d_observables.clear();
+    if (observables_t0.empty() or observables_t1.empty())
+        {
+            return;
+        }
+    // Linear interpolation: y(t) = y(t0) + (y(t1) - y(t0)) * (t - t0) / (t1 - t0)
+
+    // check TOW rollover
+    const double rx_time_t0 = observables_t0.cbegin()->second.RX_time;
+    const double rx_time_t1 = observables_t1.cbegin()->second.RX_time;
+    double time_factor;
+    if ((rx_time_t1 - rx_time_t0) > 0)
+        {
+            time_factor = (rx_time_s - rx_time_t0) / (rx_time_t1 - rx_time_t0);
+        }
+    else
+        {
+            // TOW rollover situation
+            time_factor = (604800000.0 + rx_time_s - rx_time_t0) / (604800000.0 + rx_time_t1 - rx_time_t0);
+        }
+
+    // both sets are sorted by channel, so they can be merged in a single pass
+    auto it_t1 = observables_t1.cbegin();
+    for (const auto& observable_t0 : observables_t0)
+        {
+            while (it_t1 != observables_t1.cend() and it_t1->first < observable_t0.first)
+                {
+                    it_t1++;
+                }
+            if (it_t1 == observables_t1.cend())
+                {
+                    break;
+                }
+            // the observable must exist in t0 and t1
+            if (it_t1->first == observable_t0.first and it_t1->second.PRN == observable_t0.second.PRN)
+                {
+                    d_observables.push_back(observable_t0);
+                    Gnss_Synchro& interp = d_observables.back().second;
+                    interp.RX_time = rx_time_s;  // interpolation point
+                    interp.Pseudorange_m += (it_t1->second.Pseudorange_m - observable_t0.second.Pseudorange_m) * time_factor;
+                    interp.Carrier_phase_rads += (it_t1->second.Carrier_phase_rads - observable_t0.second.Carrier_phase_rads) * time_factor;
+                    interp.Carrier_Doppler_hz += (it_t1->second.Carrier_Doppler_hz - observable_t0.second.Carrier_Doppler_hz) * time_factor;
+                }
+        }
+}
+
+
+void Observables_Epoch::to_map(std::map<int, Gnss_Synchro>& observables_map) const
+{
+    observables_map.clear();
+    for (const auto& observable : d_observables)
+        {
+            observables_map.emplace_hint(observables_map.end(), observable.first, observable.second);
+        }
+}
@@ -0,0 +1,125 @@
+/*!
+ * \file observables_epoch.h
+ * \brief Fixed-capacity container of the observables of one epoch, indexed by
+ * channel
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OBSERVABLES_EPOCH_H
+#define GNSS_SDR_OBSERVABLES_EPOCH_H
+
+#include "gnss_synchro.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+
+/*!
+ * \brief Set of valid observables of one epoch, sorted by channel ID.
+ *
+ * Storage for one observable per channel is reserved at construction, so
+ * clearing, filling, copying between epochs, applying the receiver clock
+ * offset and interpolating do not allocate memory. Elements are
+ * std::pair<int, Gnss_Synchro> with the channel ID as first member, so that
+ * iteration works as with a std::map<int, Gnss_Synchro>.
+ */
+class Observables_Epoch
+{
+public:
+    using value_type = std::pair<int, Gnss_Synchro>;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+    /*!
+     * \brief Signal identifiers, obtained from Gnss_Synchro::Signal
+     */
+    enum Signal_Id : uint8_t
+    {
+        evGPS_1C,
+        evGPS_2S,
+        evGPS_L5,
+        evSBAS_1C,
+        evGAL_1B,
+        evGAL_5X,
+        evGAL_7X,
+        evGLO_1G,
+        evGLO_2G,
+        evBDS_B1,
+        evBDS_B2,
+        evBDS_B3,
+        evUNKNOWN
+    };
+
+    explicit Observables_Epoch(uint32_t nchannels = 0);
+
+    /*!
+     * \brief Returns the identifier of a Gnss_Synchro::Signal string
+     */
+    static Signal_Id signal_id(const char* signal);
+
+    /*!
+     * \brief Returns the carrier frequency [Hz] of a signal, or 0.0 if unknown
+     */
+    static double carrier_frequency_hz(Signal_Id signal);
+
+    void clear();
+
+    /*!
+     * \brief Stores the observable of a channel. If channels are inserted in
+     * increasing order (as done by the PVT block) this is a constant time
+     * operation.
+     */
+    void insert(int channel, const Gnss_Synchro& gnss_synchro);
+
+    const_iterator find(int channel) const;
+
+    bool empty() const { return d_observables.empty(); }
+    std::size_t size() const { return d_observables.size(); }
+    std::size_t capacity() const { return d_observables.capacity(); }
+
+    iterator begin() { return d_observables.begin(); }
+    iterator end() { return d_observables.end(); }
+    const_iterator begin() const { return d_observables.cbegin(); }
+    const_iterator end() const { return d_observables.cend(); }
+    const_iterator cbegin() const { return d_observables.cbegin(); }
+    const_iterator cend() const { return d_observables.cend(); }
+
+    /*!
+     * \brief Applies the receiver clock offset correction to all the
+     * observables, according to RINEX 3.04, Table 1
+     */
+    void apply_rx_clock_offset(double rx_clock_offset_s);
+
+    /*!
+     * \brief Fills this container with the observables linearly interpolated
+     * at rx_time_s from the observables present in both t0 and t1
+     */
+    void interpolate(const Observables_Epoch& observables_t0,
+        const Observables_Epoch& observables_t1,
+        double rx_time_s);
+
+    /*!
+     * \brief Copies the observables to a map indexed by channel, as expected
+     * by the RINEX and RTCM printers
+     */
+    void to_map(std::map<int, Gnss_Synchro>& observables_map) const;
+
+private:
+    std::vector<value_type> d_observables;
+};
+
+#endif  // GNSS_SDR_OBSERVABLES_EPOCH_H
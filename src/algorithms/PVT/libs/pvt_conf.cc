@@ -68,4 +68,10 @@ Pvt_Conf::Pvt_Conf()
     udp_port = 0;
     pre_2009_file = false;
     show_local_time_zone = false;
+
+    async_output = false;
+    async_output_queue_size = 16;
+    async_output_drop_when_full = true;
+
+    snapshot_rate_ms = 60000;
 }
@@ -83,6 +83,13 @@ public:
     bool show_local_time_zone;
     bool pre_2009_file;
 
+    bool async_output;
+    int32_t async_output_queue_size;
+    bool async_output_drop_when_full;
+
+    std::string snapshot_file;  // empty: no receiver state snapshot
+    int32_t snapshot_rate_ms;   // 0: only when the receiver stops
+
     Pvt_Conf();
 };
 
@@ -0,0 +1,312 @@
+/*!
+ * \file pvt_output_sink.h
+ * \brief Class template that runs the PVT output writers in their own
+ * thread, fed through a bounded queue of preallocated records
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_OUTPUT_SINK_H
+#define GNSS_SDR_PVT_OUTPUT_SINK_H
+
+#include <glog/logging.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+/*!
+ * \brief Hands output records (file and network writes) to a dedicated
+ * thread.
+ *
+ * The records are the slots of a bounded single-producer, single-consumer
+ * ring buffer, allocated once: the producer fills the slot returned by
+ * acquire() and publishes it with commit(), and the writer thread passes the
+ * committed records to the handler in the same order, and then gives their
+ * slots back for reuse. A slow disk or network does not stall the producer
+ * unless the queue is full and the sink was configured to block. Otherwise,
+ * records that do not fit in the queue are dropped and counted.
+ *
+ * The producer and the writer thread only take the mutex to sleep and to
+ * wake each other up.
+ */
+template <typename Record>
+class Pvt_Output_Sink
+{
+public:
+    using Handler = std::function<void(Record&)>;
+
+    /*!
+     * \brief Starts the writer thread.
+     * \param slots The records of the queue. Its size is the maximum number
+     * of pending records.
+     * \param drop_when_full If true, acquire() drops the record when the
+     * queue is full. If false, acquire() waits until there is room for it.
+     * \param handler Called by the writer thread for each committed record
+     */
+    Pvt_Output_Sink(std::vector<Record> slots, bool drop_when_full, Handler handler);
+
+    /*!
+     * \brief Writes the pending records and stops the writer thread
+     */
+    ~Pvt_Output_Sink();
+
+    /*!
+     * \brief Returns the record to be filled and committed next, or nullptr
+     * if the queue is full and records are dropped. Must always be called
+     * from the same thread as commit().
+     */
+    Record* acquire();
+
+    /*!
+     * \brief Queues the record returned by the last acquire()
+     */
+    void commit();
+
+    bool full() const;                 //!< True if an acquire() would drop or block
+    void flush();                      //!< Waits until all the committed records have been written
+    std::size_t get_capacity() const;  //!< Maximum number of pending records
+
+    uint64_t get_pushed() const;     //!< Number of records committed to the queue
+    uint64_t get_written() const;    //!< Number of records written by the writer thread
+    uint64_t get_dropped() const;    //!< Number of records dropped because the queue was full
+    uint64_t get_blocked() const;    //!< Number of times acquire() had to wait for room in the queue
+    uint64_t get_max_depth() const;  //!< Maximum number of pending records observed
+
+private:
+    void run();
+    void wait_for_tail(uint64_t tail);  // waits until the writer thread has given back the slots before tail
+
+    std::vector<Record> d_slots;
+    std::size_t d_capacity;
+    bool d_drop_when_full;
+    Handler d_handler;
+
+    // d_head is only written by the producer and d_tail by the writer thread.
+    // A slot is given back (d_tail advanced) after its record has been written.
+    std::atomic<uint64_t> d_head{0};
+    std::atomic<uint64_t> d_tail{0};
+
+    std::atomic<uint64_t> d_dropped{0};
+    std::atomic<uint64_t> d_blocked{0};
+    std::atomic<uint64_t> d_max_depth{0};
+
+    // Each side announces that it is about to sleep before checking the
+    // other side's index for the last time, and the other side checks the
+    // announcement after moving its index, so that no wakeup is missed.
+    std::atomic<bool> d_writer_waiting{false};
+    std::atomic<bool> d_producer_waiting{false};
+    bool d_stop{false};
+    std::mutex d_mutex;
+    std::condition_variable d_records_cv;  // the writer thread waits for records
+    std::condition_variable d_slots_cv;    // the producer waits for free slots
+    std::thread d_thread;
+};
+
+
+template <typename Record>
+Pvt_Output_Sink<Record>::Pvt_Output_Sink(std::vector<Record> slots, bool drop_when_full, Handler handler) : d_slots(std::move(slots)),
+                                                                                                            d_drop_when_full(drop_when_full),
+                                                                                                            d_handler(std::move(handler))
+{
+    if (d_slots.empty())
+        {
+            d_slots.resize(1);
+        }
+    d_capacity = d_slots.size();
+    d_thread = std::thread(&Pvt_Output_Sink::run, this);
+}
+
+
+template <typename Record>
+Pvt_Output_Sink<Record>::~Pvt_Output_Sink()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_records_cv.notify_one();
+    try
+        {
+            if (d_thread.joinable())
+                {
+                    d_thread.join();
+                }
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << "Error stopping the PVT output sink: " << e.what();
+        }
+    if (d_dropped > 0)
+        {
+            LOG(WARNING) << "PVT output sink dropped " << d_dropped << " of " << d_dropped + get_pushed() << " output records";
+        }
+}
+
+
+template <typename Record>
+Record* Pvt_Output_Sink<Record>::acquire()
+{
+    const uint64_t head = d_head.load(std::memory_order_relaxed);
+    if (head - d_tail.load(std::memory_order_acquire) >= d_capacity)
+        {
+            if (d_drop_when_full)
+                {
+                    d_dropped++;
+                    return nullptr;
+                }
+            d_blocked++;
+            wait_for_tail(head + 1 - d_capacity);
+        }
+    return &d_slots[head % d_capacity];
+}
+
+
+template <typename Record>
+void Pvt_Output_Sink<Record>::commit()
+{
+    const uint64_t head = d_head.load(std::memory_order_relaxed) + 1;
+    d_head.store(head, std::memory_order_release);
+
+    const uint64_t depth = head - d_tail.load(std::memory_order_relaxed);
+    if (depth > d_max_depth.load(std::memory_order_relaxed))
+        {
+            d_max_depth.store(depth, std::memory_order_relaxed);
+        }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (d_writer_waiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_records_cv.notify_one();
+        }
+}
+
+
+template <typename Record>
+bool Pvt_Output_Sink<Record>::full() const
+{
+    return d_head.load(std::memory_order_relaxed) - d_tail.load(std::memory_order_acquire) >= d_capacity;
+}
+
+
+template <typename Record>
+void Pvt_Output_Sink<Record>::flush()
+{
+    wait_for_tail(d_head.load(std::memory_order_relaxed));
+}
+
+
+template <typename Record>
+std::size_t Pvt_Output_Sink<Record>::get_capacity() const
+{
+    return d_capacity;
+}
+
+
+template <typename Record>
+uint64_t Pvt_Output_Sink<Record>::get_pushed() const
+{
+    return d_head.load(std::memory_order_relaxed);
+}
+
+
+template <typename Record>
+uint64_t Pvt_Output_Sink<Record>::get_written() const
+{
+    return d_tail.load(std::memory_order_relaxed);
+}
+
+
+template <typename Record>
+uint64_t Pvt_Output_Sink<Record>::get_dropped() const
+{
+    return d_dropped.load(std::memory_order_relaxed);
+}
+
+
+template <typename Record>
+uint64_t Pvt_Output_Sink<Record>::get_blocked() const
+{
+    return d_blocked.load(std::memory_order_relaxed);
+}
+
+
+template <typename Record>
+uint64_t Pvt_Output_Sink<Record>::get_max_depth() const
+{
+    return d_max_depth.load(std::memory_order_relaxed);
+}
+
+
+template <typename Record>
+void Pvt_Output_Sink<Record>::wait_for_tail(uint64_t tail)
+{
+    if (d_tail.load(std::memory_order_acquire) >= tail)
+        {
+            return;
+        }
+    std::unique_lock<std::mutex> lock(d_mutex);
+    d_producer_waiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    d_slots_cv.wait(lock, [&] { return d_tail.load(std::memory_order_acquire) >= tail; });
+    d_producer_waiting.store(false, std::memory_order_relaxed);
+}
+
+
+template <typename Record>
+void Pvt_Output_Sink<Record>::run()
+{
+    while (true)
+        {
+            const uint64_t tail = d_tail.load(std::memory_order_relaxed);
+            if (tail == d_head.load(std::memory_order_acquire))
+                {
+                    std::unique_lock<std::mutex> lock(d_mutex);
+                    d_writer_waiting.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    d_records_cv.wait(lock, [&] { return d_stop or tail != d_head.load(std::memory_order_acquire); });
+                    d_writer_waiting.store(false, std::memory_order_relaxed);
+                    if (tail == d_head.load(std::memory_order_acquire))
+                        {
+                            // stopped, and all the committed records have been written
+                            return;
+                        }
+                    continue;
+                }
+            try
+                {
+                    d_handler(d_slots[tail % d_capacity]);
+                }
+            catch (const std::exception& e)
+                {
+                    LOG(ERROR) << "PVT output record could not be written: " << e.what();
+                }
+            d_tail.store(tail + 1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (d_producer_waiting.load(std::memory_order_relaxed))
+                {
+                    std::lock_guard<std::mutex> lock(d_mutex);
+                    d_slots_cv.notify_one();
+                }
+        }
+}
+
+#endif  // GNSS_SDR_PVT_OUTPUT_SINK_H
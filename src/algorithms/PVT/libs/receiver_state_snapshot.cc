@@ -0,0 +1,216 @@
+/*!
+ * \file receiver_state_snapshot.cc
+ * \brief Implementation of a class that stores the navigation data and the
+ * last fix of the receiver in a binary file, to warm start the next run
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "receiver_state_snapshot.h"
+#include <boost/archive/binary_iarchive.hpp>  // for binary_iarchive
+#include <boost/archive/binary_oarchive.hpp>  // for binary_oarchive
+#include <glog/logging.h>
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for write, fsync, close
+#include <array>       // for array
+#include <cerrno>      // for errno
+#include <cstdio>      // for rename, remove
+#include <cstring>     // for memcpy, strerror
+#include <exception>   // for exception
+#include <istream>     // for istream
+#include <sstream>     // for ostringstream
+#include <streambuf>   // for streambuf
+
+
+namespace
+{
+const std::array<char, 8> SNAPSHOT_MAGIC{{'G', 'S', 'D', 'R', 'S', 'N', 'A', 'P'}};
+
+struct Snapshot_Header
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t payload_size;
+    uint64_t checksum;
+};
+
+
+// 64-bit FNV-1a
+uint64_t checksum(const char* data, uint64_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint64_t n = 0; n < size; n++)
+        {
+            hash ^= static_cast<uint8_t>(data[n]);
+            hash *= 1099511628211ULL;
+        }
+    return hash;
+}
+
+
+// reads from memory, without copying it
+class Memory_Buffer : public std::streambuf
+{
+public:
+    Memory_Buffer(const char* data, uint64_t size)
+    {
+        char* begin = const_cast<char*>(data);
+        setg(begin, begin, begin + size);
+    }
+};
+
+
+bool write_all(int fd, const char* data, uint64_t size)
+{
+    while (size > 0)
+        {
+            const ssize_t written = write(fd, data, size);
+            if (written < 0)
+                {
+                    if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                    return false;
+                }
+            data += written;
+            size -= static_cast<uint64_t>(written);
+        }
+    return true;
+}
+}  // namespace
+
+
+const uint32_t Receiver_State_Snapshot::format_version;
+
+
+bool Receiver_State_Snapshot::save(const std::string& file_name) const
+{
+    std::ostringstream payload_stream;
+    try
+        {
+            boost::archive::binary_oarchive archive(payload_stream);
+            archive << *this;
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << "Can't serialize the receiver state: " << e.what();
+            return false;
+        }
+    const std::string payload = payload_stream.str();
+
+    Snapshot_Header header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = format_version;
+    header.header_size = sizeof(Snapshot_Header);
+    header.payload_size = payload.size();
+    header.checksum = checksum(payload.data(), payload.size());
+
+    // write the new snapshot aside, and replace the old one only when it is on disk
+    const std::string tmp_file_name = file_name + ".tmp";
+    const int fd = open(tmp_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        {
+            LOG(WARNING) << "Can't write the receiver state to " << tmp_file_name << ": " << strerror(errno);
+            return false;
+        }
+    const bool written = write_all(fd, reinterpret_cast<const char*>(&header), sizeof(header)) and
+                         write_all(fd, payload.data(), payload.size()) and
+                         (fsync(fd) == 0);
+    const int write_error = errno;
+    close(fd);
+    if (!written or std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0)
+        {
+            LOG(WARNING) << "Can't write the receiver state to " << file_name << ": " << strerror(written ? errno : write_error);
+            std::remove(tmp_file_name.c_str());
+            return false;
+        }
+    return true;
+}
+
+
+bool Receiver_State_Snapshot::load(const std::string& file_name)
+{
+    const int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+        {
+            return false;
+        }
+    struct stat file_status
+    {
+    };
+    if (fstat(fd, &file_status) != 0 or static_cast<uint64_t>(file_status.st_size) < sizeof(Snapshot_Header))
+        {
+            close(fd);
+            LOG(WARNING) << "Receiver state file " << file_name << " is truncated";
+            return false;
+        }
+    const auto file_size = static_cast<uint64_t>(file_status.st_size);
+    void* mapped = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        {
+            LOG(WARNING) << "Can't map the receiver state file " << file_name << ": " << strerror(errno);
+            return false;
+        }
+
+    bool loaded = false;
+    const auto* data = static_cast<const char*>(mapped);
+    Snapshot_Header header{};
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC)
+        {
+            LOG(WARNING) << file_name << " is not a receiver state file";
+        }
+    else if (header.version != format_version or header.header_size != sizeof(Snapshot_Header))
+        {
+            LOG(WARNING) << "Receiver state file " << file_name << " has format version " << header.version
+                         << ", expected " << format_version;
+        }
+    else if (header.payload_size != file_size - sizeof(Snapshot_Header) or
+             header.checksum != checksum(data + sizeof(Snapshot_Header), header.payload_size))
+        {
+            LOG(WARNING) << "Receiver state file " << file_name << " is corrupted";
+        }
+    else
+        {
+            try
+                {
+                    Memory_Buffer buffer(data + sizeof(Snapshot_Header), header.payload_size);
+                    std::istream payload_stream(&buffer);
+                    boost::archive::binary_iarchive archive(payload_stream);
+                    Receiver_State_Snapshot snapshot;
+                    archive >> snapshot;
+                    *this = snapshot;
+                    loaded = true;
+                }
+            catch (const std::exception& e)
+                {
+                    LOG(WARNING) << "Can't read the receiver state from " << file_name << ": " << e.what();
+                }
+        }
+    munmap(mapped, file_size);
+    return loaded;
+}
+
+
+bool Receiver_State_Snapshot::has_navigation_data() const
+{
+    return !(gps_ephemeris_map.empty() and gps_cnav_ephemeris_map.empty() and galileo_ephemeris_map.empty() and
+             glonass_gnav_ephemeris_map.empty() and beidou_dnav_ephemeris_map.empty() and gps_almanac_map.empty() and
+             galileo_almanac_map.empty() and beidou_dnav_almanac_map.empty());
+}
@@ -0,0 +1,167 @@
+/*!
+ * \file receiver_state_snapshot.h
+ * \brief Interface of a class that stores the navigation data and the last
+ * fix of the receiver in a binary file, to warm start the next run
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RECEIVER_STATE_SNAPSHOT_H
+#define GNSS_SDR_RECEIVER_STATE_SNAPSHOT_H
+
+#include "beidou_dnav_almanac.h"
+#include "beidou_dnav_ephemeris.h"
+#include "beidou_dnav_iono.h"
+#include "beidou_dnav_utc_model.h"
+#include "galileo_almanac.h"
+#include "galileo_ephemeris.h"
+#include "galileo_iono.h"
+#include "galileo_utc_model.h"
+#include "glonass_gnav_almanac.h"
+#include "glonass_gnav_ephemeris.h"
+#include "glonass_gnav_utc_model.h"
+#include "gps_almanac.h"
+#include "gps_cnav_ephemeris.h"
+#include "gps_cnav_iono.h"
+#include "gps_cnav_utc_model.h"
+#include "gps_ephemeris.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+
+
+/*!
+ * \brief Navigation data, last position fix, receiver clock and Doppler of
+ * the tracked satellites, written periodically by the PVT block and read at
+ * startup to seed the acquisition and the PVT solver.
+ *
+ * The file is a fixed header (magic, format version, payload size and
+ * checksum) followed by a Boost binary archive of the data. It is written to
+ * a temporary file that replaces the previous snapshot only once it is on
+ * disk, so a power cut leaves either the old or the new snapshot. The file
+ * is mapped in memory to be read.
+ *
+ * The format is native to the machine that writes it (byte order and type
+ * sizes), as it is only meant to survive reboots of the same receiver.
+ */
+class Receiver_State_Snapshot
+{
+public:
+    static const uint32_t format_version = 1;  //!< Increment when the stored data changes
+
+    /*!
+     * \brief Writes the snapshot to file_name. Returns false on failure,
+     * leaving the previous file, if any, untouched.
+     */
+    bool save(const std::string& file_name) const;
+
+    /*!
+     * \brief Reads a snapshot. Returns false if the file does not exist, is
+     * corrupted or was written with another format version.
+     */
+    bool load(const std::string& file_name);
+
+    /*!
+     * \brief True if there is any ephemeris or almanac
+     */
+    bool has_navigation_data() const;
+
+    int64_t utc_time_s{0};  //!< When the snapshot was taken [s since the Unix epoch]
+
+    // last position fix
+    bool position_valid{false};
+    double latitude_deg{0.0};
+    double longitude_deg{0.0};
+    double height_m{0.0};
+    int64_t position_utc_time_s{0};  //!< Time of the fix [s since the Unix epoch]
+    double rx_clock_offset_s{0.0};
+    double rx_clock_drift_ppm{0.0};
+
+    // carrier Doppler of the satellites in the solution, by PRN [Hz]
+    // (GPS L1 C/A, Galileo E1, GLONASS L1 C/A and BeiDou B1I)
+    std::map<int, double> gps_doppler_hz;
+    std::map<int, double> galileo_doppler_hz;
+    std::map<int, double> glonass_doppler_hz;
+    std::map<int, double> beidou_doppler_hz;
+
+    std::map<int, Gps_Ephemeris> gps_ephemeris_map;
+    std::map<int, Gps_CNAV_Ephemeris> gps_cnav_ephemeris_map;
+    std::map<int, Galileo_Ephemeris> galileo_ephemeris_map;
+    std::map<int, Glonass_Gnav_Ephemeris> glonass_gnav_ephemeris_map;
+    std::map<int, Beidou_Dnav_Ephemeris> beidou_dnav_ephemeris_map;
+
+    std::map<int, Gps_Almanac> gps_almanac_map;
+    std::map<int, Galileo_Almanac> galileo_almanac_map;
+    std::map<int, Beidou_Dnav_Almanac> beidou_dnav_almanac_map;
+    Glonass_Gnav_Almanac glonass_gnav_almanac;
+
+    Gps_Iono gps_iono;
+    Gps_Utc_Model gps_utc_model;
+    Gps_CNAV_Iono gps_cnav_iono;
+    Gps_CNAV_Utc_Model gps_cnav_utc_model;
+    Galileo_Iono galileo_iono;
+    Galileo_Utc_Model galileo_utc_model;
+    Glonass_Gnav_Utc_Model glonass_gnav_utc_model;
+    Beidou_Dnav_Iono beidou_dnav_iono;
+    Beidou_Dnav_Utc_Model beidou_dnav_utc_model;
+
+    template <class Archive>
+    void serialize(Archive& archive, const uint32_t version)
+    {
+        using boost::serialization::make_nvp;
+        if (version)
+            {
+            };
+        archive& make_nvp("utc_time_s", utc_time_s);
+        archive& make_nvp("position_valid", position_valid);
+        archive& make_nvp("latitude_deg", latitude_deg);
+        archive& make_nvp("longitude_deg", longitude_deg);
+        archive& make_nvp("height_m", height_m);
+        archive& make_nvp("position_utc_time_s", position_utc_time_s);
+        archive& make_nvp("rx_clock_offset_s", rx_clock_offset_s);
+        archive& make_nvp("rx_clock_drift_ppm", rx_clock_drift_ppm);
+        archive& make_nvp("gps_doppler_hz", gps_doppler_hz);
+        archive& make_nvp("galileo_doppler_hz", galileo_doppler_hz);
+        archive& make_nvp("glonass_doppler_hz", glonass_doppler_hz);
+        archive& make_nvp("beidou_doppler_hz", beidou_doppler_hz);
+        archive& make_nvp("gps_ephemeris_map", gps_ephemeris_map);
+        archive& make_nvp("gps_cnav_ephemeris_map", gps_cnav_ephemeris_map);
+        archive& make_nvp("galileo_ephemeris_map", galileo_ephemeris_map);
+        archive& make_nvp("glonass_gnav_ephemeris_map", glonass_gnav_ephemeris_map);
+        archive& make_nvp("beidou_dnav_ephemeris_map", beidou_dnav_ephemeris_map);
+        archive& make_nvp("gps_almanac_map", gps_almanac_map);
+        archive& make_nvp("galileo_almanac_map", galileo_almanac_map);
+        archive& make_nvp("beidou_dnav_almanac_map", beidou_dnav_almanac_map);
+        archive& make_nvp("glonass_gnav_almanac", glonass_gnav_almanac);
+        archive& make_nvp("gps_iono", gps_iono);
+        archive& make_nvp("gps_utc_model", gps_utc_model);
+        archive& make_nvp("gps_cnav_iono", gps_cnav_iono);
+        archive& make_nvp("gps_cnav_utc_model", gps_cnav_utc_model);
+        archive& make_nvp("galileo_iono", galileo_iono);
+        archive& make_nvp("galileo_utc_model", galileo_utc_model);
+        archive& make_nvp("glonass_gnav_utc_model", glonass_gnav_utc_model);
+        archive& make_nvp("beidou_dnav_iono", beidou_dnav_iono);
+        archive& make_nvp("beidou_dnav_utc_model", beidou_dnav_utc_model);
+        // the iono classes do not serialize their valid flag
+        archive& make_nvp("gps_iono_valid", gps_iono.valid);
+        archive& make_nvp("gps_cnav_iono_valid", gps_cnav_iono.valid);
+        archive& make_nvp("beidou_dnav_iono_valid", beidou_dnav_iono.valid);
+    }
+};
+
+#endif  // GNSS_SDR_RECEIVER_STATE_SNAPSHOT_H
@@ -48,6 +48,7 @@
 #include <map>      // for map
 #include <sstream>  // for stringstream
 #include <string>   // for string
+#include <vector>   // for vector
 
 class Beidou_Dnav_Ephemeris;
 class Beidou_Dnav_Iono;
@@ -477,6 +478,27 @@ private:
      */
     void lengthCheck(const std::string& line);
 
+    /*
+     * COMMENT line written after TIME OF FIRST OBS in the observation header,
+     * saying that the leap seconds are not known yet. It is replaced by the
+     * LEAP SECONDS line when the UTC model is decoded.
+     */
+    std::string reserved_header_line() const;
+
+    /*
+     * Reads the header lines of a RINEX file, up to END OF HEADER. The rest of
+     * the file is not read.
+     */
+    std::vector<std::string> read_header(std::fstream& out, const std::string& filename) const;
+
+    /*
+     * Writes an updated header to a RINEX file. If it has the same size as
+     * the old one (after using the reserved lines for any new line), it is
+     * written in place and the time needed does not depend on the file size.
+     * Otherwise, the whole file is rewritten.
+     */
+    void overwrite_header(std::fstream& out, const std::string& filename, const std::vector<std::string>& old_header, const std::vector<std::string>& new_header) const;
+
     double fake_cnav_iode;
 
     /*
@@ -3428,6 +3428,7 @@ boost::posix_time::ptime Rtcm::compute_GLONASS_time(const Glonass_Gnav_Ephemeris
 
 uint32_t Rtcm::lock_time(const Gps_Ephemeris& eph, double obs_time, const Gnss_Synchro& gnss_synchro)
 {
+    std::lock_guard<std::mutex> lock(lock_time_mutex);
     uint32_t lock_time_in_seconds;
     boost::posix_time::ptime current_time = Rtcm::compute_GPS_time(eph, obs_time);
     boost::posix_time::ptime last_lock_time = Rtcm::gps_L1_last_lock_time[65 - gnss_synchro.PRN];
@@ -3445,6 +3446,7 @@ uint32_t Rtcm::lock_time(const Gps_Ephemeris& eph, double obs_time, const Gnss_S
 
 uint32_t Rtcm::lock_time(const Gps_CNAV_Ephemeris& eph, double obs_time, const Gnss_Synchro& gnss_synchro)
 {
+    std::lock_guard<std::mutex> lock(lock_time_mutex);
     uint32_t lock_time_in_seconds;
     boost::posix_time::ptime current_time = Rtcm::compute_GPS_time(eph, obs_time);
     boost::posix_time::ptime last_lock_time = Rtcm::gps_L2_last_lock_time[65 - gnss_synchro.PRN];
@@ -3460,6 +3462,7 @@ uint32_t Rtcm::lock_time(const Gps_CNAV_Ephemeris& eph, double obs_time, const G
 
 uint32_t Rtcm::lock_time(const Galileo_Ephemeris& eph, double obs_time, const Gnss_Synchro& gnss_synchro)
 {
+    std::lock_guard<std::mutex> lock(lock_time_mutex);
     uint32_t lock_time_in_seconds;
     boost::posix_time::ptime current_time = Rtcm::compute_Galileo_time(eph, obs_time);
 
@@ -3503,6 +3506,7 @@ uint32_t Rtcm::lock_time(const Galileo_Ephemeris& eph, double obs_time, const Gn
 
 uint32_t Rtcm::lock_time(const Glonass_Gnav_Ephemeris& eph, double obs_time, const Gnss_Synchro& gnss_synchro)
 {
+    std::lock_guard<std::mutex> lock(lock_time_mutex);
     uint32_t lock_time_in_seconds;
     boost::posix_time::ptime current_time = Rtcm::compute_GLONASS_time(eph, obs_time);
 
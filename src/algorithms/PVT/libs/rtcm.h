@@ -42,6 +42,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <thread>
@@ -490,6 +491,7 @@ private:
     boost::posix_time::ptime gal_E5_last_lock_time[64];
     boost::posix_time::ptime glo_L1_last_lock_time[64];
     boost::posix_time::ptime glo_L2_last_lock_time[64];
+    std::mutex lock_time_mutex;  // lock_time() can be called from the PVT block and from the output writer threads
     uint32_t lock_time_indicator(uint32_t lock_time_period_s);
     uint32_t msm_lock_time_indicator(uint32_t lock_time_period_s);
     uint32_t msm_extended_lock_time_indicator(uint32_t lock_time_period_s);
@@ -75,6 +75,19 @@ Rtklib_Solver::Rtklib_Solver(int nchannels, const std::string &dump_filename, bo
     d_flag_dump_mat_enabled = flag_dump_to_mat;
     this->set_averaging_flag(false);
     rtk_ = rtk;
+    d_nav_models_dirty = true;
+    d_nav_data_version = 1;
+    d_snapshot_nav_data_version = 0;
+
+    // Carrier wavelengths do not depend on the ephemeris except for GLONASS FDMA
+    // signals, which are updated at each epoch only for the satellites in view
+    for (int i = 0; i < MAXSAT; i++)
+        {
+            for (int j = 0; j < NFREQ; j++)
+                {
+                    d_nav_data.lam[i][j] = satwavelen(i + 1, j, &d_nav_data);
+                }
+        }
 
     // ############# ENABLE DATA FILE LOG #################
     if (d_flag_dump_enabled == true)
@@ -402,17 +415,290 @@ Monitor_Pvt Rtklib_Solver::get_monitor_pvt() const
 }
 
 
+void Rtklib_Solver::get_output_snapshot(Rtklib_Solver &snapshot) const
+{
+    static_cast<Pvt_Solution &>(snapshot) = *this;
+    snapshot.pvt_sol = pvt_sol;
+    snapshot.pvt_ssat = pvt_ssat;
+    snapshot.dop_ = dop_;
+    snapshot.monitor_pvt = monitor_pvt;
+    snapshot.glonass_gnav_almanac = glonass_gnav_almanac;
+    if (snapshot.d_snapshot_nav_data_version != d_nav_data_version)
+        {
+            snapshot.d_galileo_ephemeris_map = d_galileo_ephemeris_map;
+            snapshot.d_gps_ephemeris_map = d_gps_ephemeris_map;
+            snapshot.d_gps_cnav_ephemeris_map = d_gps_cnav_ephemeris_map;
+            snapshot.d_glonass_gnav_ephemeris_map = d_glonass_gnav_ephemeris_map;
+            snapshot.d_beidou_dnav_ephemeris_map = d_beidou_dnav_ephemeris_map;
+            snapshot.galileo_utc_model = galileo_utc_model;
+            snapshot.galileo_iono = galileo_iono;
+            snapshot.gps_utc_model = gps_utc_model;
+            snapshot.gps_iono = gps_iono;
+            snapshot.gps_cnav_iono = gps_cnav_iono;
+            snapshot.gps_cnav_utc_model = gps_cnav_utc_model;
+            snapshot.glonass_gnav_utc_model = glonass_gnav_utc_model;
+            snapshot.beidou_dnav_utc_model = beidou_dnav_utc_model;
+            snapshot.beidou_dnav_iono = beidou_dnav_iono;
+            snapshot.d_snapshot_nav_data_version = d_nav_data_version;
+        }
+}
+
+
+void Rtklib_Solver::set_ephemeris(const Gps_Ephemeris &gps_eph)
+{
+    d_nav_data_version++;
+    d_gps_ephemeris_map[gps_eph.i_satellite_PRN] = gps_eph;
+    d_gps_eph_cache.erase(gps_eph.i_satellite_PRN);
+}
+
+
+void Rtklib_Solver::set_ephemeris(const Gps_CNAV_Ephemeris &gps_cnav_eph)
+{
+    d_nav_data_version++;
+    d_gps_cnav_ephemeris_map[gps_cnav_eph.i_satellite_PRN] = gps_cnav_eph;
+    d_gps_cnav_eph_cache.erase(gps_cnav_eph.i_satellite_PRN);
+}
+
+
+void Rtklib_Solver::set_ephemeris(const Galileo_Ephemeris &gal_eph)
+{
+    d_nav_data_version++;
+    d_galileo_ephemeris_map[gal_eph.i_satellite_PRN] = gal_eph;
+    d_galileo_eph_cache.erase(gal_eph.i_satellite_PRN);
+}
+
+
+void Rtklib_Solver::set_ephemeris(const Glonass_Gnav_Ephemeris &glo_eph)
+{
+    d_nav_data_version++;
+    d_glonass_gnav_ephemeris_map[glo_eph.i_satellite_PRN] = glo_eph;
+    d_glonass_gnav_geph_cache.erase(glo_eph.i_satellite_PRN);
+}
+
+
+void Rtklib_Solver::set_ephemeris(const Beidou_Dnav_Ephemeris &bds_eph)
+{
+    d_nav_data_version++;
+    d_beidou_dnav_ephemeris_map[bds_eph.i_satellite_PRN] = bds_eph;
+    d_beidou_dnav_eph_cache.erase(bds_eph.i_satellite_PRN);
+}
+
+
+void Rtklib_Solver::clear_ephemeris()
+{
+    d_nav_data_version++;
+    d_gps_ephemeris_map.clear();
+    d_gps_cnav_ephemeris_map.clear();
+    d_galileo_ephemeris_map.clear();
+    d_glonass_gnav_ephemeris_map.clear();
+    d_beidou_dnav_ephemeris_map.clear();
+    d_gps_eph_cache.clear();
+    d_gps_cnav_eph_cache.clear();
+    d_galileo_eph_cache.clear();
+    d_beidou_dnav_eph_cache.clear();
+    d_glonass_gnav_geph_cache.clear();
+}
+
+
+void Rtklib_Solver::notify_nav_models_update()
+{
+    d_nav_data_version++;
+    d_nav_models_dirty = true;
+    // GLONASS ephemeris conversion depends on the GLONASS UTC model
+    d_glonass_gnav_geph_cache.clear();
+}
+
+
+const eph_t &Rtklib_Solver::get_cached_eph(const Gps_Ephemeris &gps_eph)
+{
+    auto it = d_gps_eph_cache.find(gps_eph.i_satellite_PRN);
+    if (it == d_gps_eph_cache.cend())
+        {
+            it = d_gps_eph_cache.emplace(gps_eph.i_satellite_PRN, eph_to_rtklib(gps_eph, d_pre_2009_file)).first;
+        }
+    return it->second;
+}
+
+
+const eph_t &Rtklib_Solver::get_cached_eph(const Gps_CNAV_Ephemeris &gps_cnav_eph)
+{
+    auto it = d_gps_cnav_eph_cache.find(gps_cnav_eph.i_satellite_PRN);
+    if (it == d_gps_cnav_eph_cache.cend())
+        {
+            it = d_gps_cnav_eph_cache.emplace(gps_cnav_eph.i_satellite_PRN, eph_to_rtklib(gps_cnav_eph)).first;
+        }
+    return it->second;
+}
+
+
+const eph_t &Rtklib_Solver::get_cached_eph(const Galileo_Ephemeris &gal_eph)
+{
+    auto it = d_galileo_eph_cache.find(gal_eph.i_satellite_PRN);
+    if (it == d_galileo_eph_cache.cend())
+        {
+            it = d_galileo_eph_cache.emplace(gal_eph.i_satellite_PRN, eph_to_rtklib(gal_eph)).first;
+        }
+    return it->second;
+}
+
+
+const eph_t &Rtklib_Solver::get_cached_eph(const Beidou_Dnav_Ephemeris &bds_eph)
+{
+    auto it = d_beidou_dnav_eph_cache.find(bds_eph.i_satellite_PRN);
+    if (it == d_beidou_dnav_eph_cache.cend())
+        {
+            it = d_beidou_dnav_eph_cache.emplace(bds_eph.i_satellite_PRN, eph_to_rtklib(bds_eph)).first;
+        }
+    return it->second;
+}
+
+
+const geph_t &Rtklib_Solver::get_cached_geph(const Glonass_Gnav_Ephemeris &glo_eph)
+{
+    auto it = d_glonass_gnav_geph_cache.find(glo_eph.i_satellite_PRN);
+    if (it == d_glonass_gnav_geph_cache.cend())
+        {
+            it = d_glonass_gnav_geph_cache.emplace(glo_eph.i_satellite_PRN, eph_to_rtklib(glo_eph, this->glonass_gnav_utc_model)).first;
+        }
+    return it->second;
+}
+
+
+void Rtklib_Solver::update_nav_models()
+{
+    for (auto &ion : d_nav_data.ion_gps)
+        {
+            ion = 0.0;
+        }
+    for (auto &ion : d_nav_data.ion_gal)
+        {
+            ion = 0.0;
+        }
+    for (auto &ion : d_nav_data.ion_cmp)
+        {
+            ion = 0.0;
+        }
+    for (auto &utc : d_nav_data.utc_gps)
+        {
+            utc = 0.0;
+        }
+    for (auto &utc : d_nav_data.utc_glo)
+        {
+            utc = 0.0;
+        }
+    for (auto &utc : d_nav_data.utc_gal)
+        {
+            utc = 0.0;
+        }
+    for (auto &utc : d_nav_data.utc_cmp)
+        {
+            utc = 0.0;
+        }
+    d_nav_data.leaps = 0;
+
+    if (gps_iono.valid)
+        {
+            d_nav_data.ion_gps[0] = gps_iono.d_alpha0;
+            d_nav_data.ion_gps[1] = gps_iono.d_alpha1;
+            d_nav_data.ion_gps[2] = gps_iono.d_alpha2;
+            d_nav_data.ion_gps[3] = gps_iono.d_alpha3;
+            d_nav_data.ion_gps[4] = gps_iono.d_beta0;
+            d_nav_data.ion_gps[5] = gps_iono.d_beta1;
+            d_nav_data.ion_gps[6] = gps_iono.d_beta2;
+            d_nav_data.ion_gps[7] = gps_iono.d_beta3;
+        }
+    if (!(gps_iono.valid) and gps_cnav_iono.valid)
+        {
+            d_nav_data.ion_gps[0] = gps_cnav_iono.d_alpha0;
+            d_nav_data.ion_gps[1] = gps_cnav_iono.d_alpha1;
+            d_nav_data.ion_gps[2] = gps_cnav_iono.d_alpha2;
+            d_nav_data.ion_gps[3] = gps_cnav_iono.d_alpha3;
+            d_nav_data.ion_gps[4] = gps_cnav_iono.d_beta0;
+            d_nav_data.ion_gps[5] = gps_cnav_iono.d_beta1;
+            d_nav_data.ion_gps[6] = gps_cnav_iono.d_beta2;
+            d_nav_data.ion_gps[7] = gps_cnav_iono.d_beta3;
+        }
+    if (galileo_iono.ai0_5 != 0.0)
+        {
+            d_nav_data.ion_gal[0] = galileo_iono.ai0_5;
+            d_nav_data.ion_gal[1] = galileo_iono.ai1_5;
+            d_nav_data.ion_gal[2] = galileo_iono.ai2_5;
+            d_nav_data.ion_gal[3] = 0.0;
+        }
+    if (beidou_dnav_iono.valid)
+        {
+            d_nav_data.ion_cmp[0] = beidou_dnav_iono.d_alpha0;
+            d_nav_data.ion_cmp[1] = beidou_dnav_iono.d_alpha1;
+            d_nav_data.ion_cmp[2] = beidou_dnav_iono.d_alpha2;
+            d_nav_data.ion_cmp[3] = beidou_dnav_iono.d_alpha3;
+            d_nav_data.ion_cmp[4] = beidou_dnav_iono.d_beta0;
+            d_nav_data.ion_cmp[5] = beidou_dnav_iono.d_beta0;
+            d_nav_data.ion_cmp[6] = beidou_dnav_iono.d_beta0;
+            d_nav_data.ion_cmp[7] = beidou_dnav_iono.d_beta3;
+        }
+    if (gps_utc_model.valid)
+        {
+            d_nav_data.utc_gps[0] = gps_utc_model.d_A0;
+            d_nav_data.utc_gps[1] = gps_utc_model.d_A1;
+            d_nav_data.utc_gps[2] = gps_utc_model.d_t_OT;
+            d_nav_data.utc_gps[3] = gps_utc_model.i_WN_T;
+            d_nav_data.leaps = gps_utc_model.d_DeltaT_LS;
+        }
+    if (!(gps_utc_model.valid) and gps_cnav_utc_model.valid)
+        {
+            d_nav_data.utc_gps[0] = gps_cnav_utc_model.d_A0;
+            d_nav_data.utc_gps[1] = gps_cnav_utc_model.d_A1;
+            d_nav_data.utc_gps[2] = gps_cnav_utc_model.d_t_OT;
+            d_nav_data.utc_gps[3] = gps_cnav_utc_model.i_WN_T;
+            d_nav_data.leaps = gps_cnav_utc_model.d_DeltaT_LS;
+        }
+    if (glonass_gnav_utc_model.valid)
+        {
+            d_nav_data.utc_glo[0] = glonass_gnav_utc_model.d_tau_c;  // ??
+            d_nav_data.utc_glo[1] = 0.0;                             // ??
+            d_nav_data.utc_glo[2] = 0.0;                             // ??
+            d_nav_data.utc_glo[3] = 0.0;                             // ??
+        }
+    if (galileo_utc_model.A0_6 != 0.0)
+        {
+            d_nav_data.utc_gal[0] = galileo_utc_model.A0_6;
+            d_nav_data.utc_gal[1] = galileo_utc_model.A1_6;
+            d_nav_data.utc_gal[2] = galileo_utc_model.t0t_6;
+            d_nav_data.utc_gal[3] = galileo_utc_model.WNot_6;
+            d_nav_data.leaps = galileo_utc_model.Delta_tLS_6;
+        }
+    if (beidou_dnav_utc_model.valid)
+        {
+            d_nav_data.utc_cmp[0] = beidou_dnav_utc_model.d_A0_UTC;
+            d_nav_data.utc_cmp[1] = beidou_dnav_utc_model.d_A1_UTC;
+            d_nav_data.utc_cmp[2] = 0.0;  // ??
+            d_nav_data.utc_cmp[3] = 0.0;  // ??
+            d_nav_data.leaps = beidou_dnav_utc_model.d_DeltaT_LS;
+        }
+    d_nav_models_dirty = false;
+}
+
+
 bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_map, bool flag_averaging)
 {
-    std::map<int, Gnss_Synchro>::const_iterator gnss_observables_iter;
+    Observables_Epoch gnss_observables(gnss_observables_map.size());
+    for (const auto &gnss_observable : gnss_observables_map)
+        {
+            gnss_observables.insert(gnss_observable.first, gnss_observable.second);
+        }
+    return get_PVT(gnss_observables, flag_averaging);
+}
+
+
+bool Rtklib_Solver::get_PVT(const Observables_Epoch &gnss_observables, bool flag_averaging)
+{
+    Observables_Epoch::const_iterator gnss_observables_iter;
     std::map<int, Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
     std::map<int, Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
     std::map<int, Gps_CNAV_Ephemeris>::const_iterator gps_cnav_ephemeris_iter;
     std::map<int, Glonass_Gnav_Ephemeris>::const_iterator glonass_gnav_ephemeris_iter;
     std::map<int, Beidou_Dnav_Ephemeris>::const_iterator beidou_ephemeris_iter;
 
-    const Glonass_Gnav_Utc_Model gnav_utc = this->glonass_gnav_utc_model;
-
     this->set_averaging_flag(flag_averaging);
 
     // ********************************************************************************
@@ -422,27 +708,35 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
     int glo_valid_obs = 0;  // GLONASS L1/L2 valid observations counter
 
     obs_data.fill({});
-    std::vector<eph_t> eph_data(MAXOBS);
-    std::vector<geph_t> geph_data(MAXOBS);
+
+    // Wavelengths of the GLONASS satellites in view at the last solved epoch
+    // are reset before their ephemeris slots are reused
+    for (int i = 0; i < d_glonass_lam_count; i++)
+        {
+            d_nav_data.lam[d_glonass_lam_sats[i] - 1][0] = 0.0;
+            d_nav_data.lam[d_glonass_lam_sats[i] - 1][1] = 0.0;
+        }
+    d_glonass_lam_count = 0;
+    d_nav_data.ng = 0;
 
     // Workaround for NAV/CNAV clash problem
     bool gps_dual_band = false;
     bool band1 = false;
     bool band2 = false;
-    for (gnss_observables_iter = gnss_observables_map.cbegin();
-         gnss_observables_iter != gnss_observables_map.cend();
+    for (gnss_observables_iter = gnss_observables.cbegin();
+         gnss_observables_iter != gnss_observables.cend();
          ++gnss_observables_iter)
         {
             switch (gnss_observables_iter->second.System)
                 {
                 case 'G':
                     {
-                        std::string sig_(gnss_observables_iter->second.Signal);
-                        if (sig_ == "1C")
+                        const Observables_Epoch::Signal_Id sig_ = Observables_Epoch::signal_id(gnss_observables_iter->second.Signal);
+                        if (sig_ == Observables_Epoch::evGPS_1C)
                             {
                                 band1 = true;
                             }
-                        if (sig_ == "2S")
+                        if (sig_ == Observables_Epoch::evGPS_2S)
                             {
                                 band2 = true;
                             }
@@ -458,24 +752,24 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
             gps_dual_band = true;
         }
 
-    for (gnss_observables_iter = gnss_observables_map.cbegin();
-         gnss_observables_iter != gnss_observables_map.cend();
+    for (gnss_observables_iter = gnss_observables.cbegin();
+         gnss_observables_iter != gnss_observables.cend();
          ++gnss_observables_iter)  // CHECK INCONSISTENCY when combining GLONASS + other system
         {
             switch (gnss_observables_iter->second.System)
                 {
                 case 'E':
                     {
-                        std::string sig_(gnss_observables_iter->second.Signal);
+                        const Observables_Epoch::Signal_Id sig_ = Observables_Epoch::signal_id(gnss_observables_iter->second.Signal);
                         // Galileo E1
-                        if (sig_ == "1B")
+                        if (sig_ == Observables_Epoch::evGAL_1B)
                             {
                                 // 1 Gal - find the ephemeris for the current GALILEO SV observation. The SV PRN ID is the map key
-                                galileo_ephemeris_iter = galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (galileo_ephemeris_iter != galileo_ephemeris_map.cend())
+                                galileo_ephemeris_iter = d_galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (galileo_ephemeris_iter != d_galileo_ephemeris_map.cend())
                                     {
                                         // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                        eph_data[valid_obs] = eph_to_rtklib(galileo_ephemeris_iter->second);
+                                        d_eph_data[valid_obs] = get_cached_eph(galileo_ephemeris_iter->second);
                                         // convert observation from GNSS-SDR class to RTKLIB structure
                                         obsd_t newobs = {{0, 0}, '0', '0', {}, {}, {}, {}, {}, {}};
                                         obs_data[valid_obs + glo_valid_obs] = insert_obs_to_rtklib(newobs,
@@ -491,16 +785,16 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                             }
 
                         // Galileo E5
-                        if (sig_ == "5X")
+                        if (sig_ == Observables_Epoch::evGAL_5X)
                             {
                                 // 1 Gal - find the ephemeris for the current GALILEO SV observation. The SV PRN ID is the map key
-                                galileo_ephemeris_iter = galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (galileo_ephemeris_iter != galileo_ephemeris_map.cend())
+                                galileo_ephemeris_iter = d_galileo_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (galileo_ephemeris_iter != d_galileo_ephemeris_map.cend())
                                     {
                                         bool found_E1_obs = false;
                                         for (int i = 0; i < valid_obs; i++)
                                             {
-                                                if (eph_data[i].sat == (static_cast<int>(gnss_observables_iter->second.PRN + NSATGPS + NSATGLO)))
+                                                if (d_eph_data[i].sat == (static_cast<int>(gnss_observables_iter->second.PRN + NSATGPS + NSATGLO)))
                                                     {
                                                         obs_data[i + glo_valid_obs] = insert_obs_to_rtklib(obs_data[i + glo_valid_obs],
                                                             gnss_observables_iter->second,
@@ -514,7 +808,7 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                             {
                                                 // insert Galileo E5 obs as new obs and also insert its ephemeris
                                                 // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                                eph_data[valid_obs] = eph_to_rtklib(galileo_ephemeris_iter->second);
+                                                d_eph_data[valid_obs] = get_cached_eph(galileo_ephemeris_iter->second);
                                                 // convert observation from GNSS-SDR class to RTKLIB structure
                                                 auto default_code_ = static_cast<unsigned char>(CODE_NONE);
                                                 obsd_t newobs = {{0, 0}, '0', '0', {}, {},
@@ -538,14 +832,14 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                     {
                         // GPS L1
                         // 1 GPS - find the ephemeris for the current GPS SV observation. The SV PRN ID is the map key
-                        std::string sig_(gnss_observables_iter->second.Signal);
-                        if (sig_ == "1C")
+                        const Observables_Epoch::Signal_Id sig_ = Observables_Epoch::signal_id(gnss_observables_iter->second.Signal);
+                        if (sig_ == Observables_Epoch::evGPS_1C)
                             {
-                                gps_ephemeris_iter = gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (gps_ephemeris_iter != gps_ephemeris_map.cend())
+                                gps_ephemeris_iter = d_gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (gps_ephemeris_iter != d_gps_ephemeris_map.cend())
                                     {
                                         // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                        eph_data[valid_obs] = eph_to_rtklib(gps_ephemeris_iter->second, d_pre_2009_file);
+                                        d_eph_data[valid_obs] = get_cached_eph(gps_ephemeris_iter->second);
                                         // convert observation from GNSS-SDR class to RTKLIB structure
                                         obsd_t newobs = {{0, 0}, '0', '0', {}, {}, {}, {}, {}, {}};
                                         obs_data[valid_obs + glo_valid_obs] = insert_obs_to_rtklib(newobs,
@@ -561,26 +855,26 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                     }
                             }
                         // GPS L2 (todo: solve NAV/CNAV clash)
-                        if ((sig_ == "2S") and (gps_dual_band == false))
+                        if ((sig_ == Observables_Epoch::evGPS_2S) and (gps_dual_band == false))
                             {
-                                gps_cnav_ephemeris_iter = gps_cnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (gps_cnav_ephemeris_iter != gps_cnav_ephemeris_map.cend())
+                                gps_cnav_ephemeris_iter = d_gps_cnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (gps_cnav_ephemeris_iter != d_gps_cnav_ephemeris_map.cend())
                                     {
                                         // 1. Find the same satellite in GPS L1 band
-                                        gps_ephemeris_iter = gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                        if (gps_ephemeris_iter != gps_ephemeris_map.cend())
+                                        gps_ephemeris_iter = d_gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                        if (gps_ephemeris_iter != d_gps_ephemeris_map.cend())
                                             {
                                                 /* By the moment, GPS L2 observables are not used in pseudorange computations if GPS L1 is available
                                                 // 2. If found, replace the existing GPS L1 ephemeris with the GPS L2 ephemeris
                                                 // (more precise!), and attach the L2 observation to the L1 observation in RTKLIB structure
                                                 for (int i = 0; i < valid_obs; i++)
                                                     {
-                                                        if (eph_data[i].sat == static_cast<int>(gnss_observables_iter->second.PRN))
+                                                        if (d_eph_data[i].sat == static_cast<int>(gnss_observables_iter->second.PRN))
                                                             {
-                                                                eph_data[i] = eph_to_rtklib(gps_cnav_ephemeris_iter->second);
+                                                                d_eph_data[i] = get_cached_eph(gps_cnav_ephemeris_iter->second);
                                                                 obs_data[i + glo_valid_obs] = insert_obs_to_rtklib(obs_data[i + glo_valid_obs],
                                                                     gnss_observables_iter->second,
-                                                                    eph_data[i].week,
+                                                                    d_eph_data[i].week,
                                                                     1);  // Band 2 (L2)
                                                                 break;
                                                             }
@@ -591,7 +885,7 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                             {
                                                 // 3. If not found, insert the GPS L2 ephemeris and the observation
                                                 // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                                eph_data[valid_obs] = eph_to_rtklib(gps_cnav_ephemeris_iter->second);
+                                                d_eph_data[valid_obs] = get_cached_eph(gps_cnav_ephemeris_iter->second);
                                                 // convert observation from GNSS-SDR class to RTKLIB structure
                                                 auto default_code_ = static_cast<unsigned char>(CODE_NONE);
                                                 obsd_t newobs = {{0, 0}, '0', '0', {}, {},
@@ -610,22 +904,22 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                     }
                             }
                         // GPS L5
-                        if (sig_ == "L5")
+                        if (sig_ == Observables_Epoch::evGPS_L5)
                             {
-                                gps_cnav_ephemeris_iter = gps_cnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (gps_cnav_ephemeris_iter != gps_cnav_ephemeris_map.cend())
+                                gps_cnav_ephemeris_iter = d_gps_cnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (gps_cnav_ephemeris_iter != d_gps_cnav_ephemeris_map.cend())
                                     {
                                         // 1. Find the same satellite in GPS L1 band
-                                        gps_ephemeris_iter = gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                        if (gps_ephemeris_iter != gps_ephemeris_map.cend())
+                                        gps_ephemeris_iter = d_gps_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                        if (gps_ephemeris_iter != d_gps_ephemeris_map.cend())
                                             {
                                                 // 2. If found, replace the existing GPS L1 ephemeris with the GPS L5 ephemeris
                                                 // (more precise!), and attach the L5 observation to the L1 observation in RTKLIB structure
                                                 for (int i = 0; i < valid_obs; i++)
                                                     {
-                                                        if (eph_data[i].sat == static_cast<int>(gnss_observables_iter->second.PRN))
+                                                        if (d_eph_data[i].sat == static_cast<int>(gnss_observables_iter->second.PRN))
                                                             {
-                                                                eph_data[i] = eph_to_rtklib(gps_cnav_ephemeris_iter->second);
+                                                                d_eph_data[i] = get_cached_eph(gps_cnav_ephemeris_iter->second);
                                                                 obs_data[i + glo_valid_obs] = insert_obs_to_rtklib(obs_data[i],
                                                                     gnss_observables_iter->second,
                                                                     gps_cnav_ephemeris_iter->second.i_GPS_week,
@@ -638,7 +932,7 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                             {
                                                 // 3. If not found, insert the GPS L5 ephemeris and the observation
                                                 // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                                eph_data[valid_obs] = eph_to_rtklib(gps_cnav_ephemeris_iter->second);
+                                                d_eph_data[valid_obs] = get_cached_eph(gps_cnav_ephemeris_iter->second);
                                                 // convert observation from GNSS-SDR class to RTKLIB structure
                                                 auto default_code_ = static_cast<unsigned char>(CODE_NONE);
                                                 obsd_t newobs = {{0, 0}, '0', '0', {}, {},
@@ -660,16 +954,16 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                     }
                 case 'R':  // TODO This should be using rtk lib nomenclature
                     {
-                        std::string sig_(gnss_observables_iter->second.Signal);
+                        const Observables_Epoch::Signal_Id sig_ = Observables_Epoch::signal_id(gnss_observables_iter->second.Signal);
                         // GLONASS GNAV L1
-                        if (sig_ == "1G")
+                        if (sig_ == Observables_Epoch::evGLO_1G)
                             {
                                 // 1 Glo - find the ephemeris for the current GLONASS SV observation. The SV Slot Number (PRN ID) is the map key
-                                glonass_gnav_ephemeris_iter = glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (glonass_gnav_ephemeris_iter != glonass_gnav_ephemeris_map.cend())
+                                glonass_gnav_ephemeris_iter = d_glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (glonass_gnav_ephemeris_iter != d_glonass_gnav_ephemeris_map.cend())
                                     {
                                         // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                        geph_data[glo_valid_obs] = eph_to_rtklib(glonass_gnav_ephemeris_iter->second, gnav_utc);
+                                        d_geph_data[glo_valid_obs] = get_cached_geph(glonass_gnav_ephemeris_iter->second);
                                         // convert observation from GNSS-SDR class to RTKLIB structure
                                         obsd_t newobs = {{0, 0}, '0', '0', {}, {}, {}, {}, {}, {}};
                                         obs_data[valid_obs + glo_valid_obs] = insert_obs_to_rtklib(newobs,
@@ -684,16 +978,16 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                     }
                             }
                         // GLONASS GNAV L2
-                        if (sig_ == "2G")
+                        if (sig_ == Observables_Epoch::evGLO_2G)
                             {
                                 // 1 GLONASS - find the ephemeris for the current GLONASS SV observation. The SV PRN ID is the map key
-                                glonass_gnav_ephemeris_iter = glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (glonass_gnav_ephemeris_iter != glonass_gnav_ephemeris_map.cend())
+                                glonass_gnav_ephemeris_iter = d_glonass_gnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (glonass_gnav_ephemeris_iter != d_glonass_gnav_ephemeris_map.cend())
                                     {
                                         bool found_L1_obs = false;
                                         for (int i = 0; i < glo_valid_obs; i++)
                                             {
-                                                if (geph_data[i].sat == (static_cast<int>(gnss_observables_iter->second.PRN + NSATGPS)))
+                                                if (d_geph_data[i].sat == (static_cast<int>(gnss_observables_iter->second.PRN + NSATGPS)))
                                                     {
                                                         obs_data[i + valid_obs] = insert_obs_to_rtklib(obs_data[i + valid_obs],
                                                             gnss_observables_iter->second,
@@ -707,7 +1001,7 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                             {
                                                 // insert GLONASS GNAV L2 obs as new obs and also insert its ephemeris
                                                 // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                                geph_data[glo_valid_obs] = eph_to_rtklib(glonass_gnav_ephemeris_iter->second, gnav_utc);
+                                                d_geph_data[glo_valid_obs] = get_cached_geph(glonass_gnav_ephemeris_iter->second);
                                                 // convert observation from GNSS-SDR class to RTKLIB structure
                                                 obsd_t newobs = {{0, 0}, '0', '0', {}, {}, {}, {}, {}, {}};
                                                 obs_data[valid_obs + glo_valid_obs] = insert_obs_to_rtklib(newobs,
@@ -728,14 +1022,14 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                     {
                         // BEIDOU B1I
                         //  - find the ephemeris for the current BEIDOU SV observation. The SV PRN ID is the map key
-                        std::string sig_(gnss_observables_iter->second.Signal);
-                        if (sig_ == "B1")
+                        const Observables_Epoch::Signal_Id sig_ = Observables_Epoch::signal_id(gnss_observables_iter->second.Signal);
+                        if (sig_ == Observables_Epoch::evBDS_B1)
                             {
-                                beidou_ephemeris_iter = beidou_dnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (beidou_ephemeris_iter != beidou_dnav_ephemeris_map.cend())
+                                beidou_ephemeris_iter = d_beidou_dnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (beidou_ephemeris_iter != d_beidou_dnav_ephemeris_map.cend())
                                     {
                                         // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                        eph_data[valid_obs] = eph_to_rtklib(beidou_ephemeris_iter->second);
+                                        d_eph_data[valid_obs] = get_cached_eph(beidou_ephemeris_iter->second);
                                         // convert observation from GNSS-SDR class to RTKLIB structure
                                         obsd_t newobs = {{0, 0}, '0', '0', {}, {}, {}, {}, {}, {}};
                                         obs_data[valid_obs + glo_valid_obs] = insert_obs_to_rtklib(newobs,
@@ -750,15 +1044,15 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                     }
                             }
                         // BeiDou B3
-                        if (sig_ == "B3")
+                        if (sig_ == Observables_Epoch::evBDS_B3)
                             {
-                                beidou_ephemeris_iter = beidou_dnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
-                                if (beidou_ephemeris_iter != beidou_dnav_ephemeris_map.cend())
+                                beidou_ephemeris_iter = d_beidou_dnav_ephemeris_map.find(gnss_observables_iter->second.PRN);
+                                if (beidou_ephemeris_iter != d_beidou_dnav_ephemeris_map.cend())
                                     {
                                         bool found_B1I_obs = false;
                                         for (int i = 0; i < valid_obs; i++)
                                             {
-                                                if (eph_data[i].sat == (static_cast<int>(gnss_observables_iter->second.PRN + NSATGPS + NSATGLO + NSATGAL + NSATQZS)))
+                                                if (d_eph_data[i].sat == (static_cast<int>(gnss_observables_iter->second.PRN + NSATGPS + NSATGLO + NSATGAL + NSATQZS)))
                                                     {
                                                         obs_data[i + glo_valid_obs] = insert_obs_to_rtklib(obs_data[i + glo_valid_obs],
                                                             gnss_observables_iter->second,
@@ -772,7 +1066,7 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                             {
                                                 // insert BeiDou B3I obs as new obs and also insert its ephemeris
                                                 // convert ephemeris from GNSS-SDR class to RTKLIB structure
-                                                eph_data[valid_obs] = eph_to_rtklib(beidou_ephemeris_iter->second);
+                                                d_eph_data[valid_obs] = get_cached_eph(beidou_ephemeris_iter->second);
                                                 // convert observation from GNSS-SDR class to RTKLIB structure
                                                 auto default_code_ = static_cast<unsigned char>(CODE_NONE);
                                                 obsd_t newobs = {{0, 0}, '0', '0', {}, {},
@@ -807,101 +1101,28 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
     if ((valid_obs + glo_valid_obs) > 3)
         {
             int result = 0;
-            nav_t nav_data{};
-            nav_data.eph = eph_data.data();
-            nav_data.geph = geph_data.data();
-            nav_data.n = valid_obs;
-            nav_data.ng = glo_valid_obs;
-            if (gps_iono.valid)
-                {
-                    nav_data.ion_gps[0] = gps_iono.d_alpha0;
-                    nav_data.ion_gps[1] = gps_iono.d_alpha1;
-                    nav_data.ion_gps[2] = gps_iono.d_alpha2;
-                    nav_data.ion_gps[3] = gps_iono.d_alpha3;
-                    nav_data.ion_gps[4] = gps_iono.d_beta0;
-                    nav_data.ion_gps[5] = gps_iono.d_beta1;
-                    nav_data.ion_gps[6] = gps_iono.d_beta2;
-                    nav_data.ion_gps[7] = gps_iono.d_beta3;
-                }
-            if (!(gps_iono.valid) and gps_cnav_iono.valid)
+            d_nav_data.eph = d_eph_data.data();
+            d_nav_data.geph = d_geph_data.data();
+            d_nav_data.orbcache = &d_orbit_cache;
+            d_nav_data.n = valid_obs;
+            d_nav_data.ng = glo_valid_obs;
+            if (d_nav_models_dirty)
                 {
-                    nav_data.ion_gps[0] = gps_cnav_iono.d_alpha0;
-                    nav_data.ion_gps[1] = gps_cnav_iono.d_alpha1;
-                    nav_data.ion_gps[2] = gps_cnav_iono.d_alpha2;
-                    nav_data.ion_gps[3] = gps_cnav_iono.d_alpha3;
-                    nav_data.ion_gps[4] = gps_cnav_iono.d_beta0;
-                    nav_data.ion_gps[5] = gps_cnav_iono.d_beta1;
-                    nav_data.ion_gps[6] = gps_cnav_iono.d_beta2;
-                    nav_data.ion_gps[7] = gps_cnav_iono.d_beta3;
-                }
-            if (galileo_iono.ai0_5 != 0.0)
-                {
-                    nav_data.ion_gal[0] = galileo_iono.ai0_5;
-                    nav_data.ion_gal[1] = galileo_iono.ai1_5;
-                    nav_data.ion_gal[2] = galileo_iono.ai2_5;
-                    nav_data.ion_gal[3] = 0.0;
-                }
-            if (beidou_dnav_iono.valid)
-                {
-                    nav_data.ion_cmp[0] = beidou_dnav_iono.d_alpha0;
-                    nav_data.ion_cmp[1] = beidou_dnav_iono.d_alpha1;
-                    nav_data.ion_cmp[2] = beidou_dnav_iono.d_alpha2;
-                    nav_data.ion_cmp[3] = beidou_dnav_iono.d_alpha3;
-                    nav_data.ion_cmp[4] = beidou_dnav_iono.d_beta0;
-                    nav_data.ion_cmp[5] = beidou_dnav_iono.d_beta0;
-                    nav_data.ion_cmp[6] = beidou_dnav_iono.d_beta0;
-                    nav_data.ion_cmp[7] = beidou_dnav_iono.d_beta3;
-                }
-            if (gps_utc_model.valid)
-                {
-                    nav_data.utc_gps[0] = gps_utc_model.d_A0;
-                    nav_data.utc_gps[1] = gps_utc_model.d_A1;
-                    nav_data.utc_gps[2] = gps_utc_model.d_t_OT;
-                    nav_data.utc_gps[3] = gps_utc_model.i_WN_T;
-                    nav_data.leaps = gps_utc_model.d_DeltaT_LS;
-                }
-            if (!(gps_utc_model.valid) and gps_cnav_utc_model.valid)
-                {
-                    nav_data.utc_gps[0] = gps_cnav_utc_model.d_A0;
-                    nav_data.utc_gps[1] = gps_cnav_utc_model.d_A1;
-                    nav_data.utc_gps[2] = gps_cnav_utc_model.d_t_OT;
-                    nav_data.utc_gps[3] = gps_cnav_utc_model.i_WN_T;
-                    nav_data.leaps = gps_cnav_utc_model.d_DeltaT_LS;
-                }
-            if (glonass_gnav_utc_model.valid)
-                {
-                    nav_data.utc_glo[0] = glonass_gnav_utc_model.d_tau_c;  // ??
-                    nav_data.utc_glo[1] = 0.0;                             // ??
-                    nav_data.utc_glo[2] = 0.0;                             // ??
-                    nav_data.utc_glo[3] = 0.0;                             // ??
-                }
-            if (galileo_utc_model.A0_6 != 0.0)
-                {
-                    nav_data.utc_gal[0] = galileo_utc_model.A0_6;
-                    nav_data.utc_gal[1] = galileo_utc_model.A1_6;
-                    nav_data.utc_gal[2] = galileo_utc_model.t0t_6;
-                    nav_data.utc_gal[3] = galileo_utc_model.WNot_6;
-                    nav_data.leaps = galileo_utc_model.Delta_tLS_6;
-                }
-            if (beidou_dnav_utc_model.valid)
-                {
-                    nav_data.utc_cmp[0] = beidou_dnav_utc_model.d_A0_UTC;
-                    nav_data.utc_cmp[1] = beidou_dnav_utc_model.d_A1_UTC;
-                    nav_data.utc_cmp[2] = 0.0;  // ??
-                    nav_data.utc_cmp[3] = 0.0;  // ??
-                    nav_data.leaps = beidou_dnav_utc_model.d_DeltaT_LS;
+                    update_nav_models();
                 }
 
-            /* update carrier wave length using native function call in RTKlib */
-            for (int i = 0; i < MAXSAT; i++)
+            /* update carrier wave length of the GLONASS satellites in view using native function call in RTKlib */
+            for (int i = 0; i < glo_valid_obs; i++)
                 {
-                    for (int j = 0; j < NFREQ; j++)
+                    for (int j = 0; j < 2; j++)
                         {
-                            nav_data.lam[i][j] = satwavelen(i + 1, j, &nav_data);
+                            d_nav_data.lam[d_geph_data[i].sat - 1][j] = satwavelen(d_geph_data[i].sat, j, &d_nav_data);
                         }
+                    d_glonass_lam_sats[i] = d_geph_data[i].sat;
                 }
+            d_glonass_lam_count = glo_valid_obs;
 
-            result = rtkpos(&rtk_, obs_data.data(), valid_obs + glo_valid_obs, &nav_data);
+            result = rtkpos(&rtk_, obs_data.data(), valid_obs + glo_valid_obs, &d_nav_data);
 
             if (result == 0)
                 {
@@ -915,32 +1136,25 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                     this->set_num_valid_observations(rtk_.sol.ns);  // record the number of valid satellites used by the PVT solver
                     pvt_sol = rtk_.sol;
                     // DOP computation
-                    unsigned int used_sats = 0;
                     for (unsigned int i = 0; i < MAXSAT; i++)
                         {
                             pvt_ssat[i] = rtk_.ssat[i];
-                            if (rtk_.ssat[i].vs == 1)
-                                {
-                                    used_sats++;
-                                }
                         }
 
-                    std::vector<double> azel;
-                    azel.reserve(used_sats * 2);
                     unsigned int index_aux = 0;
                     for (auto &i : rtk_.ssat)
                         {
                             if (i.vs == 1)
                                 {
-                                    azel[2 * index_aux] = i.azel[0];
-                                    azel[2 * index_aux + 1] = i.azel[1];
+                                    d_azel[2 * index_aux] = i.azel[0];
+                                    d_azel[2 * index_aux + 1] = i.azel[1];
                                     index_aux++;
                                 }
                         }
 
                     if (index_aux > 0)
                         {
-                            dops(index_aux, azel.data(), 0.0, dop_.data());
+                            dops(index_aux, d_azel.data(), 0.0, dop_.data());
                         }
                     this->set_valid_position(true);
                     arma::vec rx_position_and_time(4);
@@ -982,7 +1196,7 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
 
                     this->set_time_offset_s(rx_position_and_time(3));
 
-                    DLOG(INFO) << "RTKLIB Position at RX TOW = " << gnss_observables_map.begin()->second.RX_time
+                    DLOG(INFO) << "RTKLIB Position at RX TOW = " << gnss_observables.cbegin()->second.RX_time
                                << " in ECEF (X,Y,Z,t[meters]) = " << rx_position_and_time;
 
                     boost::posix_time::ptime p_time;
@@ -1003,11 +1217,11 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
 
                     // ######## PVT MONITOR #########
                     // TOW
-                    monitor_pvt.TOW_at_current_symbol_ms = gnss_observables_map.begin()->second.TOW_at_current_symbol_ms;
+                    monitor_pvt.TOW_at_current_symbol_ms = gnss_observables.cbegin()->second.TOW_at_current_symbol_ms;
                     // WEEK
-                    monitor_pvt.week = adjgpsweek(nav_data.eph[0].week, d_pre_2009_file);
+                    monitor_pvt.week = adjgpsweek(d_nav_data.eph[0].week, d_pre_2009_file);
                     // PVT GPS time
-                    monitor_pvt.RX_time = gnss_observables_map.begin()->second.RX_time;
+                    monitor_pvt.RX_time = gnss_observables.cbegin()->second.RX_time;
                     // User clock offset [s]
                     monitor_pvt.user_clk_offset = rx_position_and_time(3);
 
@@ -1073,13 +1287,13 @@ bool Rtklib_Solver::get_PVT(const std::map<int, Gnss_Synchro> &gnss_observables_
                                     double tmp_double;
                                     uint32_t tmp_uint32;
                                     // TOW
-                                    tmp_uint32 = gnss_observables_map.begin()->second.TOW_at_current_symbol_ms;
+                                    tmp_uint32 = gnss_observables.cbegin()->second.TOW_at_current_symbol_ms;
                                     d_dump_file.write(reinterpret_cast<char *>(&tmp_uint32), sizeof(uint32_t));
                                     // WEEK
-                                    tmp_uint32 = adjgpsweek(nav_data.eph[0].week, d_pre_2009_file);
+                                    tmp_uint32 = adjgpsweek(d_nav_data.eph[0].week, d_pre_2009_file);
                                     d_dump_file.write(reinterpret_cast<char *>(&tmp_uint32), sizeof(uint32_t));
                                     // PVT GPS time
-                                    tmp_double = gnss_observables_map.begin()->second.RX_time;
+                                    tmp_double = gnss_observables.cbegin()->second.RX_time;
                                     d_dump_file.write(reinterpret_cast<char *>(&tmp_double), sizeof(double));
                                     // User clock offset [s]
                                     tmp_double = rx_position_and_time(3);
@@ -54,9 +54,11 @@
 #include "gps_iono.h"
 #include "gps_utc_model.h"
 #include "monitor_pvt.h"
+#include "observables_epoch.h"
 #include "pvt_solution.h"
 #include "rtklib.h"
 #include <array>
+#include <cstdint>
 #include <fstream>
 #include <map>
 #include <string>
@@ -71,8 +73,42 @@ public:
     Rtklib_Solver(int nchannels, const std::string& dump_filename, bool flag_dump_to_file, bool flag_dump_to_mat, const rtk_t& rtk);
     ~Rtklib_Solver();
 
+    bool get_PVT(const Observables_Epoch& gnss_observables, bool flag_averaging);
+
+    /*!
+     * \brief Convenience overload for observables stored in a map indexed by
+     * channel. It allocates memory, so it is not used in the processing loop.
+     */
     bool get_PVT(const std::map<int, Gnss_Synchro>& gnss_observables_map, bool flag_averaging);
 
+    /*!
+     * \brief Stores a new ephemeris, replacing the previous one of the same
+     * satellite. Only the cached RTKLIB structure of that satellite is
+     * converted again.
+     */
+    void set_ephemeris(const Gps_Ephemeris& gps_eph);
+    void set_ephemeris(const Gps_CNAV_Ephemeris& gps_cnav_eph);
+    void set_ephemeris(const Galileo_Ephemeris& gal_eph);
+    void set_ephemeris(const Glonass_Gnav_Ephemeris& glo_eph);
+    void set_ephemeris(const Beidou_Dnav_Ephemeris& bds_eph);
+
+    /*!
+     * \brief Removes the ephemeris of all the satellites
+     */
+    void clear_ephemeris();
+
+    const std::map<int, Galileo_Ephemeris>& get_galileo_ephemeris_map() const { return d_galileo_ephemeris_map; }
+    const std::map<int, Gps_Ephemeris>& get_gps_ephemeris_map() const { return d_gps_ephemeris_map; }
+    const std::map<int, Gps_CNAV_Ephemeris>& get_gps_cnav_ephemeris_map() const { return d_gps_cnav_ephemeris_map; }
+    const std::map<int, Glonass_Gnav_Ephemeris>& get_glonass_gnav_ephemeris_map() const { return d_glonass_gnav_ephemeris_map; }
+    const std::map<int, Beidou_Dnav_Ephemeris>& get_beidou_dnav_ephemeris_map() const { return d_beidou_dnav_ephemeris_map; }
+
+    /*!
+     * \brief Marks the ionospheric and UTC parameters of the cached RTKLIB
+     * navigation data as outdated. Must be called after writing any iono or UTC model.
+     */
+    void notify_nav_models_update();
+
     sol_t pvt_sol{};
     std::array<ssat_t, MAXSAT> pvt_ssat{};
     double get_hdop() const;
@@ -81,11 +117,13 @@ public:
     double get_gdop() const;
     Monitor_Pvt get_monitor_pvt() const;
 
-    std::map<int, Galileo_Ephemeris> galileo_ephemeris_map;            //!< Map storing new Galileo_Ephemeris
-    std::map<int, Gps_Ephemeris> gps_ephemeris_map;                    //!< Map storing new GPS_Ephemeris
-    std::map<int, Gps_CNAV_Ephemeris> gps_cnav_ephemeris_map;          //!< Map storing new GPS_CNAV_Ephemeris
-    std::map<int, Glonass_Gnav_Ephemeris> glonass_gnav_ephemeris_map;  //!< Map storing new GLONASS GNAV Ephemeris
-    std::map<int, Beidou_Dnav_Ephemeris> beidou_dnav_ephemeris_map;    //!< Map storing new BeiDou DNAV Ephmeris
+    /*!
+     * \brief Copies the current solution, and the ephemeris and models used by
+     * the output printers, to another solver that is then handed to the output
+     * writers. Ephemeris and models are only copied if they changed since the
+     * previous call with the same snapshot. Almanac maps are not copied.
+     */
+    void get_output_snapshot(Rtklib_Solver& snapshot) const;
 
     Galileo_Utc_Model galileo_utc_model;
     Galileo_Iono galileo_iono;
@@ -106,15 +144,47 @@ public:
     std::map<int, Beidou_Dnav_Almanac> beidou_dnav_almanac_map;
 
 private:
+    void update_nav_models();
+    const eph_t& get_cached_eph(const Gps_Ephemeris& gps_eph);
+    const eph_t& get_cached_eph(const Gps_CNAV_Ephemeris& gps_cnav_eph);
+    const eph_t& get_cached_eph(const Galileo_Ephemeris& gal_eph);
+    const eph_t& get_cached_eph(const Beidou_Dnav_Ephemeris& bds_eph);
+    const geph_t& get_cached_geph(const Glonass_Gnav_Ephemeris& glo_eph);
+
+    std::map<int, Galileo_Ephemeris> d_galileo_ephemeris_map;            // Map storing new Galileo_Ephemeris
+    std::map<int, Gps_Ephemeris> d_gps_ephemeris_map;                    // Map storing new GPS_Ephemeris
+    std::map<int, Gps_CNAV_Ephemeris> d_gps_cnav_ephemeris_map;          // Map storing new GPS_CNAV_Ephemeris
+    std::map<int, Glonass_Gnav_Ephemeris> d_glonass_gnav_ephemeris_map;  // Map storing new GLONASS GNAV Ephemeris
+    std::map<int, Beidou_Dnav_Ephemeris> d_beidou_dnav_ephemeris_map;    // Map storing new BeiDou DNAV Ephmeris
+
+    // RTKLIB navigation data, maintained across epochs
+    nav_t d_nav_data{};
+    std::array<eph_t, MAXOBS> d_eph_data{};
+    std::array<geph_t, MAXOBS> d_geph_data{};
+    std::array<int, MAXOBS> d_glonass_lam_sats{};  // GLONASS satellites with a wavelength set in d_nav_data.lam
+    int d_glonass_lam_count{0};
+    orbcache_t d_orbit_cache{};  // polynomial fits of satellite orbits and clocks
+
+    // Ephemeris already converted to RTKLIB structures, indexed by PRN
+    std::map<int, eph_t> d_gps_eph_cache;
+    std::map<int, eph_t> d_gps_cnav_eph_cache;
+    std::map<int, eph_t> d_galileo_eph_cache;
+    std::map<int, eph_t> d_beidou_dnav_eph_cache;
+    std::map<int, geph_t> d_glonass_gnav_geph_cache;
+
     rtk_t rtk_{};
     Monitor_Pvt monitor_pvt{};
     std::array<obsd_t, MAXOBS> obs_data{};
     std::array<double, 4> dop_{};
+    std::array<double, 2 * MAXSAT> d_azel{};  // azimuth and elevation of the satellites used in the solution
     std::string d_dump_filename;
     std::ofstream d_dump_file;
     int d_nchannels;  // Number of available channels for positioning
     bool d_flag_dump_enabled;
     bool d_flag_dump_mat_enabled;
+    bool d_nav_models_dirty;
+    uint64_t d_nav_data_version;           // incremented when any ephemeris or model changes
+    uint64_t d_snapshot_nav_data_version;  // version of the data copied by get_output_snapshot()
     bool save_matfile();
 };
 
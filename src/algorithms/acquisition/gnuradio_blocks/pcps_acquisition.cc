@@ -25,6 +25,7 @@
 #include "pcps_acquisition.h"
 #include "GLONASS_L1_L2_CA.h"  // for GLONASS_TWO_PI
 #include "GPS_L1_CA.h"         // for GPS_TWO_PI
+#include "fft_plan_registry.h"
 #include "gnss_frequencies.h"
 #include "gnss_sdr_create_directory.h"
 #include "gnss_synchro.h"
@@ -129,11 +130,9 @@ pcps_acquisition::pcps_acquisition(const Acq_Conf& conf_) : gr::block("pcps_acqu
     d_fft_codes = volk_gnsssdr::vector<std::complex<float>>(d_fft_size);
     d_input_signal = volk_gnsssdr::vector<std::complex<float>>(d_fft_size);
 
-    // Direct FFT
-    d_fft_if = std::make_shared<gr::fft::fft_complex>(d_fft_size, true);
-
-    // Inverse FFT
-    d_ifft = std::make_shared<gr::fft::fft_complex>(d_fft_size, false);
+    // Direct and inverse FFT plans are borrowed from the registry when needed
+    Fft_Plan_Registry::instance().announce(d_fft_size, true);
+    Fft_Plan_Registry::instance().announce(d_fft_size, false);
 
     d_gnss_synchro = nullptr;
     d_worker_active = false;
@@ -207,27 +206,28 @@ void pcps_acquisition::set_local_code(std::complex<float>* code)
     // [ 0 0 0 ... 0 c_0 c_1 ... c_L]
     // where c_i is the local code and there are L zeros and L chips
     gr::thread::scoped_lock lock(d_setlock);  // require mutex with work function called by the scheduler
+    const auto fft_if = Fft_Plan_Registry::instance().get(d_fft_size, true);
     if (acq_parameters.bit_transition_flag)
         {
             int32_t offset = d_fft_size / 2;
-            std::fill_n(d_fft_if->get_inbuf(), offset, gr_complex(0.0, 0.0));
-            memcpy(d_fft_if->get_inbuf() + offset, code, sizeof(gr_complex) * offset);
+            std::fill_n(fft_if->get_inbuf(), offset, gr_complex(0.0, 0.0));
+            memcpy(fft_if->get_inbuf() + offset, code, sizeof(gr_complex) * offset);
         }
     else
         {
             if (acq_parameters.sampled_ms == acq_parameters.ms_per_code)
                 {
-                    memcpy(d_fft_if->get_inbuf(), code, sizeof(gr_complex) * d_consumed_samples);
+                    memcpy(fft_if->get_inbuf(), code, sizeof(gr_complex) * d_consumed_samples);
                 }
             else
                 {
-                    std::fill_n(d_fft_if->get_inbuf(), d_fft_size - d_consumed_samples, gr_complex(0.0, 0.0));
-                    memcpy(d_fft_if->get_inbuf() + d_consumed_samples, code, sizeof(gr_complex) * d_consumed_samples);
+                    std::fill_n(fft_if->get_inbuf(), d_fft_size - d_consumed_samples, gr_complex(0.0, 0.0));
+                    memcpy(fft_if->get_inbuf() + d_consumed_samples, code, sizeof(gr_complex) * d_consumed_samples);
                 }
         }
 
-    d_fft_if->execute();  // We need the FFT of local code
-    volk_32fc_conjugate_32fc(d_fft_codes.data(), d_fft_if->get_outbuf(), d_fft_size);
+    fft_if->execute();  // We need the FFT of local code
+    volk_32fc_conjugate_32fc(d_fft_codes.data(), fft_if->get_outbuf(), d_fft_size);
 }
 
 
@@ -283,27 +283,16 @@ void pcps_acquisition::init()
 
     d_num_doppler_bins = static_cast<uint32_t>(std::ceil(static_cast<double>(static_cast<int32_t>(acq_parameters.doppler_max) - static_cast<int32_t>(-acq_parameters.doppler_max)) / static_cast<double>(d_doppler_step)));
 
-    // Create the carrier Doppler wipeoff signals
-    if (d_grid_doppler_wipeoffs.empty())
-        {
-            d_grid_doppler_wipeoffs = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(d_num_doppler_bins, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
-        }
-    if (acq_parameters.make_2_steps && (d_grid_doppler_wipeoffs_step_two.empty()))
-        {
-            d_grid_doppler_wipeoffs_step_two = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(d_num_doppler_bins_step2, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
-        }
-
-    if (d_magnitude_grid.empty())
-        {
-            d_magnitude_grid = volk_gnsssdr::vector<volk_gnsssdr::vector<float>>(d_num_doppler_bins, volk_gnsssdr::vector<float>(d_fft_size));
-        }
-
-    for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+    // The Doppler grids are allocated by allocate_grids() on the first
+    // acquisition, channels that never search do not pay for them
+    if (!d_grid_doppler_wipeoffs.empty())
         {
-            std::fill(d_magnitude_grid[doppler_index].begin(), d_magnitude_grid[doppler_index].end(), 0.0);
+            for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                {
+                    std::fill(d_magnitude_grid[doppler_index].begin(), d_magnitude_grid[doppler_index].end(), 0.0);
+                }
+            update_grid_doppler_wipeoffs();
         }
-
-    update_grid_doppler_wipeoffs();
     d_worker_active = false;
 
     if (d_dump)
@@ -315,8 +304,25 @@ void pcps_acquisition::init()
 }
 
 
+void pcps_acquisition::allocate_grids()
+{
+    // Create the carrier Doppler wipeoff signals
+    d_grid_doppler_wipeoffs = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(d_num_doppler_bins, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
+    if (acq_parameters.make_2_steps)
+        {
+            d_grid_doppler_wipeoffs_step_two = volk_gnsssdr::vector<volk_gnsssdr::vector<std::complex<float>>>(d_num_doppler_bins_step2, volk_gnsssdr::vector<std::complex<float>>(d_fft_size));
+        }
+    d_magnitude_grid = volk_gnsssdr::vector<volk_gnsssdr::vector<float>>(d_num_doppler_bins, volk_gnsssdr::vector<float>(d_fft_size));
+    update_grid_doppler_wipeoffs();
+}
+
+
 void pcps_acquisition::update_grid_doppler_wipeoffs()
 {
+    if (d_grid_doppler_wipeoffs.empty())
+        {
+            return;  // computed by allocate_grids()
+        }
     for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
         {
             int32_t doppler = -static_cast<int32_t>(acq_parameters.doppler_max) + d_doppler_center + d_doppler_step * doppler_index;
@@ -327,6 +333,10 @@ void pcps_acquisition::update_grid_doppler_wipeoffs()
 
 void pcps_acquisition::update_grid_doppler_wipeoffs_step2()
 {
+    if (d_grid_doppler_wipeoffs_step_two.empty())
+        {
+            return;
+        }
     for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins_step2; doppler_index++)
         {
             float doppler = (static_cast<float>(doppler_index) - static_cast<float>(floor(d_num_doppler_bins_step2 / 2.0))) * acq_parameters.doppler_step2;
@@ -646,33 +656,37 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
 
     lk.unlock();
 
+    // Borrow the FFT plans for the duration of the search
+    const auto fft_if = Fft_Plan_Registry::instance().get(d_fft_size, true);
+    const auto ifft = Fft_Plan_Registry::instance().get(d_fft_size, false);
+
     // Doppler frequency grid loop
     if (!d_step_two)
         {
             for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
                 {
                     // Remove Doppler
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in, d_grid_doppler_wipeoffs[doppler_index].data(), d_fft_size);
+                    volk_32fc_x2_multiply_32fc(fft_if->get_inbuf(), in, d_grid_doppler_wipeoffs[doppler_index].data(), d_fft_size);
 
                     // Perform the FFT-based convolution  (parallel time search)
                     // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
+                    fft_if->execute();
 
                     // Multiply carrier wiped--off, Fourier transformed incoming signal with the local FFT'd code reference
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft_if->get_outbuf(), d_fft_codes.data(), d_fft_size);
+                    volk_32fc_x2_multiply_32fc(ifft->get_inbuf(), fft_if->get_outbuf(), d_fft_codes.data(), d_fft_size);
 
                     // Compute the inverse FFT
-                    d_ifft->execute();
+                    ifft->execute();
 
                     // Compute squared magnitude (and accumulate in case of non-coherent integration)
                     size_t offset = (acq_parameters.bit_transition_flag ? effective_fft_size : 0);
                     if (d_num_noncoherent_integrations_counter == 1)
                         {
-                            volk_32fc_magnitude_squared_32f(d_magnitude_grid[doppler_index].data(), d_ifft->get_outbuf() + offset, effective_fft_size);
+                            volk_32fc_magnitude_squared_32f(d_magnitude_grid[doppler_index].data(), ifft->get_outbuf() + offset, effective_fft_size);
                         }
                     else
                         {
-                            volk_32fc_magnitude_squared_32f(d_tmp_buffer.data(), d_ifft->get_outbuf() + offset, effective_fft_size);
+                            volk_32fc_magnitude_squared_32f(d_tmp_buffer.data(), ifft->get_outbuf() + offset, effective_fft_size);
                             volk_32f_x2_add_32f(d_magnitude_grid[doppler_index].data(), d_magnitude_grid[doppler_index].data(), d_tmp_buffer.data(), effective_fft_size);
                         }
                     // Record results to file if required
@@ -710,27 +724,27 @@ void pcps_acquisition::acquisition_core(uint64_t samp_count)
         {
             for (uint32_t doppler_index = 0; doppler_index < d_num_doppler_bins_step2; doppler_index++)
                 {
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in, d_grid_doppler_wipeoffs_step_two[doppler_index].data(), d_fft_size);
+                    volk_32fc_x2_multiply_32fc(fft_if->get_inbuf(), in, d_grid_doppler_wipeoffs_step_two[doppler_index].data(), d_fft_size);
 
                     // Perform the FFT-based convolution  (parallel time search)
                     // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
+                    fft_if->execute();
 
                     // Multiply carrier wiped--off, Fourier transformed incoming signal
                     // with the local FFT'd code reference using SIMD operations with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft_if->get_outbuf(), d_fft_codes.data(), d_fft_size);
+                    volk_32fc_x2_multiply_32fc(ifft->get_inbuf(), fft_if->get_outbuf(), d_fft_codes.data(), d_fft_size);
 
                     // compute the inverse FFT
-                    d_ifft->execute();
+                    ifft->execute();
 
                     size_t offset = (acq_parameters.bit_transition_flag ? effective_fft_size : 0);
                     if (d_num_noncoherent_integrations_counter == 1)
                         {
-                            volk_32fc_magnitude_squared_32f(d_magnitude_grid[doppler_index].data(), d_ifft->get_outbuf() + offset, effective_fft_size);
+                            volk_32fc_magnitude_squared_32f(d_magnitude_grid[doppler_index].data(), ifft->get_outbuf() + offset, effective_fft_size);
                         }
                     else
                         {
-                            volk_32fc_magnitude_squared_32f(d_tmp_buffer.data(), d_ifft->get_outbuf() + offset, effective_fft_size);
+                            volk_32fc_magnitude_squared_32f(d_tmp_buffer.data(), ifft->get_outbuf() + offset, effective_fft_size);
                             volk_32f_x2_add_32f(d_magnitude_grid[doppler_index].data(), d_magnitude_grid[doppler_index].data(), d_tmp_buffer.data(), effective_fft_size);
                         }
                     // Record results to file if required
@@ -940,6 +954,11 @@ int pcps_acquisition::general_work(int noutput_items __attribute__((unused)),
             return 0;
         }
 
+    if (d_grid_doppler_wipeoffs.empty())
+        {
+            allocate_grids();
+        }
+
     switch (d_state)
         {
         case 0:
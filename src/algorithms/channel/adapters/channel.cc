@@ -26,13 +26,19 @@
 #include "telemetry_decoder_interface.h"
 #include "tracking_interface.h"
 #include <glog/logging.h>
-#include <utility>  // for std::move
+#include <stdexcept>  // for invalid_argument
+#include <utility>    // for std::move
 
 
 Channel::Channel(ConfigurationInterface* configuration, uint32_t channel, const std::shared_ptr<AcquisitionInterface>& acq,
     const std::shared_ptr<TrackingInterface>& trk, const std::shared_ptr<TelemetryDecoderInterface>& nav,
     const std::string& role, const std::string& implementation, const std::shared_ptr<Concurrent_Queue<pmt::pmt_t> >& queue)
 {
+    if (acq == nullptr or trk == nullptr or nav == nullptr)
+        {
+            // unknown implementation in the configuration
+            throw std::invalid_argument("Channel " + std::to_string(channel) + " is missing a processing block");
+        }
     acq_ = acq;
     trk_ = trk;
     nav_ = nav;
@@ -227,6 +233,12 @@ void Channel::assist_acquisition_doppler(double Carrier_Doppler_hz)
 }
 
 
+void Channel::set_event_queue(const std::shared_ptr<Control_Event_Queue>& event_queue)
+{
+    channel_fsm_->set_event_queue(event_queue);
+}
+
+
 void Channel::start_acquisition()
 {
     std::lock_guard<std::mutex> lk(mx);
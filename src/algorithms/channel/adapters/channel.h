@@ -28,6 +28,7 @@
 #include "channel_interface.h"
 #include "channel_msg_receiver_cc.h"
 #include "concurrent_queue.h"
+#include "control_event_queue.h"
 #include "gnss_signal.h"
 #include "gnss_synchro.h"
 #include <gnuradio/block.h>
@@ -82,6 +83,7 @@ public:
     inline std::shared_ptr<TrackingInterface> tracking() { return trk_; }
     inline std::shared_ptr<TelemetryDecoderInterface> telemetry() { return nav_; }
     void msg_handler_events(pmt::pmt_t msg);
+    void set_event_queue(const std::shared_ptr<Control_Event_Queue>& event_queue);  //!< Sends the channel events through a lock-free queue
 
 private:
     channel_msg_receiver_cc_sptr channel_msg_rx;
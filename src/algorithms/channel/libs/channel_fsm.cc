@@ -175,6 +175,13 @@ void ChannelFsm::set_queue(std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue)
 }
 
 
+void ChannelFsm::set_event_queue(std::shared_ptr<Control_Event_Queue> event_queue)
+{
+    std::lock_guard<std::mutex> lk(mx);
+    event_queue_ = std::move(event_queue);
+}
+
+
 void ChannelFsm::set_channel(uint32_t channel)
 {
     std::lock_guard<std::mutex> lk(mx);
@@ -204,17 +211,27 @@ void ChannelFsm::start_acquisition()
 void ChannelFsm::start_tracking()
 {
     trk_->start_tracking();
-    queue_->push(pmt::make_any(channel_event_make(channel_, 1)));
+    send_event(1);
 }
 
 
 void ChannelFsm::request_satellite()
 {
-    queue_->push(pmt::make_any(channel_event_make(channel_, 0)));
+    send_event(0);
 }
 
 
 void ChannelFsm::notify_stop_tracking()
 {
-    queue_->push(pmt::make_any(channel_event_make(channel_, 2)));
+    send_event(2);
+}
+
+
+void ChannelFsm::send_event(int event_type)
+{
+    // The command queue is still used if the event queue is full
+    if (event_queue_ == nullptr or !event_queue_->push(static_cast<int32_t>(channel_), event_type))
+        {
+            queue_->push(pmt::make_any(channel_event_make(channel_, event_type)));
+        }
 }
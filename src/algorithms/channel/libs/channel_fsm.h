@@ -24,6 +24,7 @@
 
 #include "acquisition_interface.h"
 #include "concurrent_queue.h"
+#include "control_event_queue.h"
 #include "telemetry_decoder_interface.h"
 #include "tracking_interface.h"
 #include <pmt/pmt.h>
@@ -46,6 +47,7 @@ public:
     void set_tracking(std::shared_ptr<TrackingInterface> tracking);
     void set_telemetry(std::shared_ptr<TelemetryDecoderInterface> telemetry);
     void set_queue(std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue);
+    void set_event_queue(std::shared_ptr<Control_Event_Queue> event_queue);  //!< Lock-free path for the channel events, if set
     void set_channel(uint32_t channel);
     void start_acquisition();
     // FSM EVENTS
@@ -63,11 +65,13 @@ private:
     void stop_tracking();
     void request_satellite();
     void notify_stop_tracking();
+    void send_event(int event_type);
 
     std::shared_ptr<AcquisitionInterface> acq_;
     std::shared_ptr<TrackingInterface> trk_;
     std::shared_ptr<TelemetryDecoderInterface> nav_;
     std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue_;
+    std::shared_ptr<Control_Event_Queue> event_queue_;
     uint32_t channel_;
     uint32_t d_state;
     std::mutex mx;
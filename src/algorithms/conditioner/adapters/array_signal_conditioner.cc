@@ -19,6 +19,7 @@
  */
 
 #include "array_signal_conditioner.h"
+#include "beamformer_filter.h"
 #include "configuration_interface.h"
 #include <glog/logging.h>
 #include <utility>
@@ -53,6 +54,16 @@ void ArraySignalConditioner::connect(gr::top_block_sptr top_block)
         }
     // data_type_adapt_->connect(top_block);
     in_filt_->connect(top_block);
+    if (beams() > 1)
+        {
+            // the beams leave the conditioner straight from the input filter
+            if (res_->implementation() != "Pass_Through")
+                {
+                    LOG(WARNING) << "The resampler of " << role_ << " is not applied to the " << beams() << " beams of the input filter";
+                }
+            connected_ = true;
+            return;
+        }
     res_->connect(top_block);
 
     // top_block->connect(data_type_adapt_->get_right_block(), 0, in_filt_->get_left_block(), 0);
@@ -75,6 +86,13 @@ void ArraySignalConditioner::disconnect(gr::top_block_sptr top_block)
             return;
         }
 
+    if (beams() > 1)
+        {
+            in_filt_->disconnect(top_block);
+            connected_ = false;
+            return;
+        }
+
     // top_block->disconnect(data_type_adapt_->get_right_block(), 0,
     //                      in_filt_->get_left_block(), 0);
     top_block->disconnect(in_filt_->get_right_block(), 0,
@@ -97,5 +115,23 @@ gr::basic_block_sptr ArraySignalConditioner::get_left_block()
 
 gr::basic_block_sptr ArraySignalConditioner::get_right_block()
 {
+    if (beams() > 1)
+        {
+            return in_filt_->get_right_block();
+        }
     return res_->get_right_block();
 }
+
+
+size_t ArraySignalConditioner::beams() const
+{
+    const auto beamformer = std::dynamic_pointer_cast<BeamformerFilter>(in_filt_);
+    return beamformer ? beamformer->beams() : 1;
+}
+
+
+int ArraySignalConditioner::output_port(const std::string &signal, unsigned int channel) const
+{
+    const auto beamformer = std::dynamic_pointer_cast<BeamformerFilter>(in_filt_);
+    return beamformer ? beamformer->output_port(signal, channel) : -1;
+}
@@ -61,6 +61,15 @@ public:
     inline std::shared_ptr<GNSSBlockInterface> input_filter() { return in_filt_; }
     inline std::shared_ptr<GNSSBlockInterface> resampler() { return res_; }
 
+    /*!
+     * \brief Number of output ports. A Beamformer_Filter with several beams
+     * delivers each beam on its own port, bypassing the resampler.
+     */
+    size_t beams() const;
+
+    //! Beam of the given channel, or -1 if the input filter assigns none
+    int output_port(const std::string &signal, unsigned int channel) const;
+
 private:
     std::shared_ptr<GNSSBlockInterface> data_type_adapt_;
     std::shared_ptr<GNSSBlockInterface> in_filt_;
@@ -0,0 +1,162 @@
+/*!
+ * \file channelizer_conditioner.cc
+ * \brief Signal conditioner that splits a wideband signal into several
+ * decimated sub-bands in a single pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "channelizer_conditioner.h"
+#include "configuration_interface.h"
+#include <glog/logging.h>
+#include <volk/volk.h>  // for lv_16sc_t, lv_8sc_t
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+
+
+ChannelizerConditioner::ChannelizerConditioner(
+    ConfigurationInterface *configuration, const std::string &role,
+    unsigned int in_stream, unsigned int out_stream) : role_(role), in_stream_(in_stream), out_stream_(out_stream)
+{
+    const std::string default_item_type = "gr_complex";
+    const double fs_in_deprecated = configuration->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    const double fs = configuration->property("GNSS-SDR.internal_fs_sps", fs_in_deprecated);
+    sample_freq_in_ = configuration->property(role_ + ".sample_freq_in", 4.0 * fs);
+    sample_freq_out_ = configuration->property(role_ + ".sample_freq_out", fs);
+    item_type_ = configuration->property(role_ + ".item_type", default_item_type);
+    const uint32_t fft_size = configuration->property(role_ + ".fft_size", 0U);
+    const uint32_t taps = configuration->property(role_ + ".taps", 0U);
+
+    if (item_type_ == "gr_complex")
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_ == "cshort")
+        {
+            item_size_ = sizeof(lv_16sc_t);
+        }
+    else if (item_type_ == "cbyte")
+        {
+            item_size_ = sizeof(lv_8sc_t);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unrecognized item type for channelizer. Using gr_complex.";
+            item_type_ = default_item_type;
+            item_size_ = sizeof(gr_complex);
+        }
+
+    // All the sub-bands share the output rate, which must divide the input rate
+    const double ratio = sample_freq_in_ / sample_freq_out_;
+    const auto decimation = static_cast<uint32_t>(std::max(std::round(ratio), 1.0));
+    if (std::fabs(ratio - decimation) > 1e-9 * ratio)
+        {
+            std::string aux_warn = "CONFIGURATION WARNING: " + role_ + ".sample_freq_in is not a multiple of " + role_ +
+                                   ".sample_freq_out. The output is sampled at " + std::to_string(sample_freq_in_ / decimation) + " sps.";
+            LOG(WARNING) << aux_warn;
+            std::cout << aux_warn << std::endl;
+            sample_freq_out_ = sample_freq_in_ / decimation;
+        }
+    if (std::fabs(fs - sample_freq_out_) > 1e-9 * fs)
+        {
+            std::string aux_warn = "CONFIGURATION WARNING: Parameters GNSS-SDR.internal_fs_sps and " + role_ + ".sample_freq_out are not set to the same value!";
+            LOG(WARNING) << aux_warn;
+            std::cout << aux_warn << std::endl;
+        }
+
+    const int count = configuration->property(role_ + ".subbands", 1);
+    for (int n = 0; n < count; n++)
+        {
+            const std::string subband_role = role_ + ".subband" + std::to_string(n);
+            Channelizer_Subband subband{};
+            subband.center_freq_hz = configuration->property(subband_role + ".freq", 0.0);
+            subband.bandwidth_hz = configuration->property(subband_role + ".bandwidth", 0.8 * sample_freq_out_);
+            subbands_.push_back(subband);
+
+            std::vector<std::string> signals;
+            std::stringstream list(configuration->property(subband_role + ".signals", std::string("")));
+            std::string signal;
+            while (std::getline(list, signal, ','))
+                {
+                    signal.erase(std::remove(signal.begin(), signal.end(), ' '), signal.end());
+                    if (!signal.empty())
+                        {
+                            signals.push_back(signal);
+                        }
+                }
+            subband_signals_.push_back(signals);
+        }
+
+    channelizer_ = make_fft_channelizer_cc(sample_freq_in_, decimation, subbands_, item_type_, fft_size, taps);
+    DLOG(INFO) << "sample_freq_in " << sample_freq_in_;
+    DLOG(INFO) << "sample_freq_out " << sample_freq_out_;
+    DLOG(INFO) << "Item type " << item_type_;
+    DLOG(INFO) << subbands_.size() << " sub-bands from FFTs of " << channelizer_->fft_size() << " points, overlapping "
+               << channelizer_->overlap() << " samples, and a filter of " << channelizer_->num_taps() << " taps";
+    DLOG(INFO) << "channelizer(" << channelizer_->unique_id() << ")";
+    if (in_stream_ > 1)
+        {
+            LOG(ERROR) << "This implementation only supports one input stream";
+        }
+    if (out_stream_ > 1)
+        {
+            LOG(ERROR) << "The sub-bands are the output ports of a single stream";
+        }
+}
+
+
+int ChannelizerConditioner::output_port(const std::string &signal) const
+{
+    for (size_t n = 0; n < subband_signals_.size(); n++)
+        {
+            if (std::find(subband_signals_[n].begin(), subband_signals_[n].end(), signal) != subband_signals_[n].end())
+                {
+                    return static_cast<int>(n);
+                }
+        }
+    return -1;
+}
+
+
+void ChannelizerConditioner::connect(gr::top_block_sptr top_block)
+{
+    if (top_block)
+        { /* top_block is not null */
+        };
+    DLOG(INFO) << "nothing to connect internally";
+}
+
+
+void ChannelizerConditioner::disconnect(gr::top_block_sptr top_block)
+{
+    if (top_block)
+        { /* top_block is not null */
+        };
+    // Nothing to disconnect
+}
+
+
+gr::basic_block_sptr ChannelizerConditioner::get_left_block()
+{
+    return channelizer_;
+}
+
+
+gr::basic_block_sptr ChannelizerConditioner::get_right_block()
+{
+    return channelizer_;
+}
@@ -0,0 +1,79 @@
+/*!
+ * \file channelizer_conditioner.h
+ * \brief Signal conditioner that splits a wideband signal into several
+ * decimated sub-bands in a single pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CHANNELIZER_CONDITIONER_H
+#define GNSS_SDR_CHANNELIZER_CONDITIONER_H
+
+#include "fft_channelizer_cc.h"
+#include "gnss_block_interface.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Replaces one SignalConditioner per band when a single capture
+ * covers several of them (e.g. L1/E1 and L5/E5a). The input is read once,
+ * and each sub-band is delivered at GNSS-SDR.internal_fs_sps on its own
+ * output port. Channels are attached to the port whose SubbandN.signals
+ * list contains their signal.
+ */
+class ChannelizerConditioner : public GNSSBlockInterface
+{
+public:
+    ChannelizerConditioner(ConfigurationInterface *configuration,
+        const std::string &role, unsigned int in_stream,
+        unsigned int out_stream);
+
+    ~ChannelizerConditioner() = default;
+
+    inline std::string role() override { return role_; }
+    //! Returns "Channelizer_Conditioner"
+    inline std::string implementation() override { return "Channelizer_Conditioner"; }
+    inline size_t item_size() override { return item_size_; }
+
+    void connect(gr::top_block_sptr top_block) override;
+    void disconnect(gr::top_block_sptr top_block) override;
+    gr::basic_block_sptr get_left_block() override;
+    gr::basic_block_sptr get_right_block() override;
+
+    //! Number of output ports
+    inline size_t subbands() const { return subbands_.size(); }
+
+    /*!
+     * \brief Output port that carries the given signal ("1C", "L5", ...),
+     * or -1 if none of the sub-bands lists it.
+     */
+    int output_port(const std::string &signal) const;
+
+private:
+    std::string role_;
+    unsigned int in_stream_;
+    unsigned int out_stream_;
+    std::string item_type_;
+    size_t item_size_;
+    double sample_freq_in_;
+    double sample_freq_out_;
+    std::vector<Channelizer_Subband> subbands_;
+    std::vector<std::vector<std::string>> subband_signals_;
+    fft_channelizer_cc_sptr channelizer_;
+};
+
+#endif  // GNSS_SDR_CHANNELIZER_CONDITIONER_H
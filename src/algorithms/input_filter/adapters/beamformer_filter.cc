@@ -22,6 +22,29 @@
 #include "configuration_interface.h"
 #include <glog/logging.h>
 #include <gnuradio/blocks/file_sink.h>
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+
+namespace
+{
+std::vector<std::string> split_list(const std::string& list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        {
+            item.erase(std::remove(item.begin(), item.end(), ' '), item.end());
+            if (!item.empty())
+                {
+                    items.push_back(item);
+                }
+        }
+    return items;
+}
+}  // namespace
 
 
 BeamformerFilter::BeamformerFilter(
@@ -34,13 +57,45 @@ BeamformerFilter::BeamformerFilter(
     dump_ = configuration->property(role + ".dump", false);
     DLOG(INFO) << "dump_ is " << dump_;
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_file);
+    elements_ = configuration->property(role + ".elements", GNSS_SDR_BEAMFORMER_CHANNELS);
+    beams_ = std::max(configuration->property(role + ".beams", 1U), 1U);
+
+    // One row of weights per beam, given as re0,im0,re1,im1,...
+    std::vector<std::vector<gr_complex>> weights;
+    for (uint32_t b = 0; b < beams_; b++)
+        {
+            const std::string beam_role = role + ".beam" + std::to_string(b);
+            std::vector<gr_complex> beam_weights(elements_, gr_complex(1.0, 0.0));
+            const std::vector<std::string> values = split_list(configuration->property(beam_role + ".weights", std::string("")));
+            if (values.size() == 2 * elements_)
+                {
+                    for (uint32_t i = 0; i < elements_; i++)
+                        {
+                            beam_weights[i] = gr_complex(std::stof(values[2 * i]), std::stof(values[2 * i + 1]));
+                        }
+                }
+            else if (!values.empty())
+                {
+                    LOG(WARNING) << beam_role << ".weights needs " << 2 * elements_ << " values, but it has "
+                                 << values.size() << ". Using unit weights.";
+                }
+            weights.push_back(std::move(beam_weights));
+            beam_signals_.push_back(split_list(configuration->property(beam_role + ".signals", std::string(""))));
+            std::vector<unsigned int> channels;
+            for (const auto& channel : split_list(configuration->property(beam_role + ".channels", std::string(""))))
+                {
+                    channels.push_back(std::stoul(channel));
+                }
+            beam_channels_.push_back(std::move(channels));
+        }
 
     if (item_type_ == "gr_complex")
         {
             item_size_ = sizeof(gr_complex);
-            beamformer_ = make_beamformer_sptr();
+            beamformer_ = make_multibeam_beamformer_cc(elements_, weights);
             DLOG(INFO) << "Item size " << item_size_;
-            DLOG(INFO) << "resampler(" << beamformer_->unique_id() << ")";
+            DLOG(INFO) << beams_ << " beams from " << elements_ << " elements";
+            DLOG(INFO) << "beamformer(" << beamformer_->unique_id() << ")";
         }
     else
         {
@@ -55,9 +110,9 @@ BeamformerFilter::BeamformerFilter(
             DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
         }
     samples_ = 0ULL;
-    if (in_stream_ > 8)
+    if (in_stream_ > elements_)
         {
-            LOG(ERROR) << "This implementation only supports eight input streams";
+            LOG(ERROR) << "This implementation only supports " << elements_ << " input streams";
         }
     if (out_stream_ > 1)
         {
@@ -99,3 +154,33 @@ gr::basic_block_sptr BeamformerFilter::get_right_block()
 {
     return beamformer_;
 }
+
+
+int BeamformerFilter::output_port(const std::string& signal, unsigned int channel) const
+{
+    for (size_t b = 0; b < beam_channels_.size(); b++)
+        {
+            if (std::find(beam_channels_[b].begin(), beam_channels_[b].end(), channel) != beam_channels_[b].end())
+                {
+                    return static_cast<int>(b);
+                }
+        }
+    for (size_t b = 0; b < beam_signals_.size(); b++)
+        {
+            if (std::find(beam_signals_[b].begin(), beam_signals_[b].end(), signal) != beam_signals_[b].end())
+                {
+                    return static_cast<int>(b);
+                }
+        }
+    return -1;
+}
+
+
+bool BeamformerFilter::set_weights(const std::vector<std::vector<gr_complex>>& weights)
+{
+    if (!beamformer_)
+        {
+            return false;
+        }
+    return beamformer_->set_weights(weights);
+}
@@ -22,9 +22,11 @@
 #define GNSS_SDR_BEAMFORMER_FILTER_H
 
 #include "gnss_block_interface.h"
+#include "multibeam_beamformer_cc.h"
 #include <gnuradio/hier_block2.h>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 class ConfigurationInterface;
 
@@ -62,6 +64,23 @@ public:
     gr::basic_block_sptr get_left_block() override;
     gr::basic_block_sptr get_right_block() override;
 
+    //! Number of beams, which are the output ports of the right block
+    inline uint32_t beams() const { return beams_; }
+
+    /*!
+     * \brief Beam for the given channel: the one that lists the channel in
+     * InputFilter.beamN.channels or, if none does, the signal in
+     * InputFilter.beamN.signals. Returns -1 if no beam is assigned.
+     */
+    int output_port(const std::string& signal, unsigned int channel) const;
+
+    /*!
+     * \brief Steers the beams while the receiver runs, without stopping
+     * the stream. Returns false if weights does not have one row of
+     * elements weights per beam.
+     */
+    bool set_weights(const std::vector<std::vector<gr_complex>>& weights);
+
 private:
     std::string role_;
     unsigned int in_stream_;
@@ -69,9 +88,13 @@ private:
     std::string item_type_;
     size_t item_size_;
     uint64_t samples_;
+    uint32_t elements_;
+    uint32_t beams_;
     bool dump_;
     std::string dump_filename_;
-    gr::block_sptr beamformer_;
+    std::vector<std::vector<std::string>> beam_signals_;
+    std::vector<std::vector<unsigned int>> beam_channels_;
+    multibeam_beamformer_cc_sptr beamformer_;
     gr::block_sptr file_sink_;
 };
 
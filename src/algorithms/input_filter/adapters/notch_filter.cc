@@ -20,6 +20,7 @@
 
 #include "notch_filter.h"
 #include "configuration_interface.h"
+#include "multi_notch_cc.h"
 #include "notch_cc.h"
 #include <boost/lexical_cast.hpp>
 #include <glog/logging.h>
@@ -39,6 +40,8 @@ NotchFilter::NotchFilter(ConfigurationInterface* configuration, const std::strin
     int default_n_segments_est = 12500;
     int n_segments_reset;
     int default_n_segments_reset = 5000000;
+    int n_interferers;
+    int default_n_interferers = 1;
     std::string default_item_type = "gr_complex";
     std::string default_dump_file = "./data/input_filter.dat";
     item_type_ = configuration->property(role + ".item_type", default_item_type);
@@ -50,10 +53,19 @@ NotchFilter::NotchFilter(ConfigurationInterface* configuration, const std::strin
     length_ = configuration->property(role + ".length", default_length_);
     n_segments_est = configuration->property(role + ".segments_est", default_n_segments_est);
     n_segments_reset = configuration->property(role + ".segments_reset", default_n_segments_reset);
+    n_interferers = configuration->property(role + ".interferers", default_n_interferers);
     if (item_type_ == "gr_complex")
         {
             item_size_ = sizeof(gr_complex);
-            notch_filter_ = make_notch_filter(pfa, p_c_factor, length_, n_segments_est, n_segments_reset);
+            if (n_interferers > 1)
+                {
+                    notch_filter_ = make_multi_notch_filter(pfa, p_c_factor, length_, n_segments_est, n_segments_reset, n_interferers);
+                    DLOG(INFO) << "Tracking up to " << n_interferers << " interferers";
+                }
+            else
+                {
+                    notch_filter_ = make_notch_filter(pfa, p_c_factor, length_, n_segments_est, n_segments_reset);
+                }
             DLOG(INFO) << "Item size " << item_size_;
             DLOG(INFO) << "input filter(" << notch_filter_->unique_id() << ")";
         }
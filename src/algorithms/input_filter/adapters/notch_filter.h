@@ -23,7 +23,7 @@
 #define GNSS_SDR_NOTCH_FILTER_H
 
 #include "gnss_block_interface.h"
-#include "notch_cc.h"
+#include <gnuradio/block.h>
 #include <gnuradio/blocks/file_sink.h>
 #include <string>
 #include <vector>
@@ -65,7 +65,7 @@ private:
     unsigned int in_streams_;
     unsigned int out_streams_;
     gr::blocks::file_sink::sptr file_sink_;
-    notch_sptr notch_filter_;
+    gr::block_sptr notch_filter_;  // Notch, or MultiNotch when more than one interferer is tracked
 };
 
 #endif  // GNSS_SDR_NOTCH_FILTER_H
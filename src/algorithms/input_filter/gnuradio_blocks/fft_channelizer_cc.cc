@@ -0,0 +1,263 @@
+/*!
+ * \file fft_channelizer_cc.cc
+ * \brief Fast convolution filter bank that extracts several decimated
+ * sub-bands from a wideband signal in a single pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_channelizer_cc.h"
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>  // for lv_16sc_t, lv_8sc_t, volk_16i_s32f_convert_32f
+#include <algorithm>    // for max, min, copy
+#include <cmath>        // for ceil, cos, llround
+#include <cstring>      // for memcpy
+
+
+namespace
+{
+const double PI = 3.14159265358979323846;
+
+
+// Narrowest transition band of the sub-bands. The stop band of each of them
+// must begin before half the output rate, because the bins beyond it are
+// discarded.
+double min_transition(double sample_freq_out, const std::vector<Channelizer_Subband> &subbands)
+{
+    double transition = sample_freq_out / 2.0;
+    for (const auto &subband : subbands)
+        {
+            const double bandwidth = std::min(subband.bandwidth_hz, 0.96 * sample_freq_out);
+            transition = std::min(transition, (sample_freq_out - bandwidth) / 2.0);
+        }
+    return transition;
+}
+}  // namespace
+
+
+fft_channelizer_cc_sptr make_fft_channelizer_cc(
+    double sample_freq_in,
+    uint32_t decimation,
+    const std::vector<Channelizer_Subband> &subbands,
+    const std::string &item_type,
+    uint32_t fft_size,
+    uint32_t taps)
+{
+    return fft_channelizer_cc_sptr(
+        new fft_channelizer_cc(sample_freq_in,
+            decimation,
+            subbands,
+            item_type,
+            fft_size,
+            taps));
+}
+
+
+fft_channelizer_cc::fft_channelizer_cc(
+    double sample_freq_in,
+    uint32_t decimation,
+    const std::vector<Channelizer_Subband> &subbands,
+    const std::string &item_type,
+    uint32_t fft_size,
+    uint32_t taps) : gr::sync_decimator("fft_channelizer_cc",
+                         gr::io_signature::make(1, 1, item_size(item_type_from_name(item_type))),
+                         gr::io_signature::make(subbands.size(), subbands.size(), sizeof(gr_complex)),
+                         std::max(decimation, 1U)),
+                     d_sample_freq_in(sample_freq_in),
+                     d_decimation(std::max(decimation, 1U)),
+                     d_item_type(item_type_from_name(item_type)),
+                     d_item_size(item_size(d_item_type)),
+                     d_block_start_mod(0),
+                     d_subbands(subbands)
+{
+    const double sample_freq_out = sample_freq_in / d_decimation;
+
+    // Hamming window: about 3.3 / transition taps
+    d_num_taps = taps;
+    if (d_num_taps == 0)
+        {
+            d_num_taps = static_cast<uint32_t>(std::ceil(3.3 * sample_freq_in / min_transition(sample_freq_out, subbands)));
+        }
+    d_num_taps |= 1U;  // odd, for an integer group delay
+
+    d_overlap = ((d_num_taps - 1 + d_decimation - 1) / d_decimation) * d_decimation;
+    d_ifft_size = 2;
+    if (fft_size == 0)
+        {
+            // at least 3/4 of each block is new samples
+            while (static_cast<uint64_t>(d_ifft_size) * d_decimation < 4ULL * d_overlap)
+                {
+                    d_ifft_size <<= 1U;
+                }
+        }
+    else
+        {
+            d_ifft_size = std::max((fft_size + d_decimation - 1) / d_decimation, d_overlap / d_decimation + 1);
+        }
+    d_fft_size = d_ifft_size * d_decimation;
+    d_step = d_fft_size - d_overlap;
+    d_block_start_mod = (d_fft_size - d_overlap) % d_fft_size;  // the first block begins with the history
+
+    d_fft = std::make_shared<gr::fft::fft_complex>(d_fft_size, true);
+    d_ifft = std::make_shared<gr::fft::fft_complex>(d_ifft_size, false);
+
+    // Each sub-band has its own pass band, on the same transition band
+    d_states.resize(d_subbands.size());
+    for (size_t s = 0; s < d_subbands.size(); s++)
+        {
+            const double bandwidth = std::min(d_subbands[s].bandwidth_hz, 0.96 * sample_freq_out);
+            const double cutoff = (bandwidth / 2.0 + min_transition(sample_freq_out, d_subbands) / 2.0) / sample_freq_in;
+            const double delay = (d_num_taps - 1) / 2.0;
+            gr_complex *filter = d_fft->get_inbuf();
+            std::fill(filter, filter + d_fft_size, gr_complex(0.0, 0.0));
+            double gain = 0.0;
+            for (uint32_t n = 0; n < d_num_taps; n++)
+                {
+                    const double t = static_cast<double>(n) - delay;
+                    const double sinc = (t == 0.0) ? 2.0 * cutoff : std::sin(2.0 * PI * cutoff * t) / (PI * t);
+                    const double window = 0.54 - 0.46 * std::cos(2.0 * PI * n / (d_num_taps - 1));
+                    filter[n] = gr_complex(static_cast<float>(sinc * window), 0.0);
+                    gain += sinc * window;
+                }
+            for (uint32_t n = 0; n < d_num_taps; n++)
+                {
+                    filter[n] /= static_cast<float>(gain);
+                }
+            d_fft->execute();
+            const std::vector<gr_complex> response(d_fft->get_outbuf(), d_fft->get_outbuf() + d_fft_size);
+            design_subband(d_subbands[s], response, d_states[s]);
+        }
+
+    set_history(d_overlap + 1);
+    set_output_multiple(static_cast<int>(d_step / d_decimation));
+}
+
+
+void fft_channelizer_cc::design_subband(const Channelizer_Subband &subband, const std::vector<gr_complex> &response, Subband_State &state) const
+{
+    const double bin_width = d_sample_freq_in / d_fft_size;
+    const int64_t bin = std::llround(subband.center_freq_hz / bin_width);
+    const int64_t n = d_fft_size;
+    state.center_bin = static_cast<uint64_t>(((bin % n) + n) % n);
+
+    // Bins above half the output rate are discarded: the inverse transform
+    // of the remaining d_ifft_size bins is the decimated output
+    state.bins.resize(d_ifft_size);
+    state.response.resize(d_ifft_size);
+    const int64_t m = d_ifft_size;
+    for (int64_t k = 0; k < m; k++)
+        {
+            const int64_t offset = (k < m / 2) ? k : k - m;
+            state.bins[k] = static_cast<uint32_t>((((bin + offset) % n) + n) % n);
+            state.response[k] = response[((offset % n) + n) % n] / static_cast<float>(d_fft_size);
+        }
+
+    const double residual = subband.center_freq_hz - static_cast<double>(bin) * bin_width;
+    state.residual_step = std::polar(1.0, -2.0 * PI * residual * d_decimation / d_sample_freq_in);
+    // The filter was centered on the bin instead of the sub-band center,
+    // which rotates the output by the remainder over the group delay
+    state.residual_phase = std::polar(1.0, 2.0 * PI * residual * latency() / d_sample_freq_in);
+}
+
+
+fft_channelizer_cc::Item_Type fft_channelizer_cc::item_type_from_name(const std::string &item_type)
+{
+    if (item_type == "cshort")
+        {
+            return Item_Type::Cshort;
+        }
+    if (item_type == "cbyte")
+        {
+            return Item_Type::Cbyte;
+        }
+    return Item_Type::Gr_Complex;
+}
+
+
+size_t fft_channelizer_cc::item_size(Item_Type item_type)
+{
+    switch (item_type)
+        {
+        case Item_Type::Cshort:
+            return sizeof(lv_16sc_t);
+        case Item_Type::Cbyte:
+            return sizeof(lv_8sc_t);
+        default:
+            return sizeof(gr_complex);
+        }
+}
+
+
+void fft_channelizer_cc::load_block(const void *in)
+{
+    gr_complex *buffer = d_fft->get_inbuf();
+    switch (d_item_type)
+        {
+        case Item_Type::Cshort:
+            volk_16i_s32f_convert_32f(reinterpret_cast<float *>(buffer), static_cast<const int16_t *>(in), 1.0, 2 * d_fft_size);
+            break;
+        case Item_Type::Cbyte:
+            volk_8i_s32f_convert_32f(reinterpret_cast<float *>(buffer), static_cast<const int8_t *>(in), 1.0, 2 * d_fft_size);
+            break;
+        default:
+            std::memcpy(buffer, in, d_fft_size * sizeof(gr_complex));
+            break;
+        }
+}
+
+
+int fft_channelizer_cc::work(int noutput_items,
+    gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items)
+{
+    const auto *in = static_cast<const uint8_t *>(input_items[0]);
+    const uint32_t outputs_per_block = d_step / d_decimation;
+    const uint32_t first_valid = d_overlap / d_decimation;
+    const int blocks = noutput_items / static_cast<int>(outputs_per_block);
+
+    for (int b = 0; b < blocks; b++)
+        {
+            load_block(in + static_cast<size_t>(b) * d_step * d_item_size);
+            d_fft->execute();
+            const gr_complex *spectrum = d_fft->get_outbuf();
+
+            for (size_t s = 0; s < d_states.size(); s++)
+                {
+                    Subband_State &state = d_states[s];
+                    gr_complex *bins = d_ifft->get_inbuf();
+                    for (uint32_t k = 0; k < d_ifft_size; k++)
+                        {
+                            bins[k] = spectrum[state.bins[k]] * state.response[k];
+                        }
+                    d_ifft->execute();
+
+                    // Shifting the spectrum mixed the block as if it began at
+                    // sample 0: correct by the phase of its actual first sample
+                    const uint64_t phase_index = (state.center_bin * d_block_start_mod) % d_fft_size;
+                    const std::complex<double> block_phase = std::polar(1.0, -2.0 * PI * static_cast<double>(phase_index) / d_fft_size);
+                    std::complex<double> phase = state.residual_phase * block_phase;
+                    const gr_complex *decimated = d_ifft->get_outbuf() + first_valid;
+                    auto *out = static_cast<gr_complex *>(output_items[s]) + static_cast<size_t>(b) * outputs_per_block;
+                    for (uint32_t q = 0; q < outputs_per_block; q++)
+                        {
+                            out[q] = decimated[q] * gr_complex(static_cast<float>(phase.real()), static_cast<float>(phase.imag()));
+                            phase *= state.residual_step;
+                        }
+                    state.residual_phase = phase * std::conj(block_phase);
+                    state.residual_phase /= std::abs(state.residual_phase);
+                }
+            d_block_start_mod = (d_block_start_mod + d_step) % d_fft_size;
+        }
+    return blocks * static_cast<int>(outputs_per_block);
+}
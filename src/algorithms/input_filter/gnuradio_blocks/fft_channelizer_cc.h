@@ -0,0 +1,157 @@
+/*!
+ * \file fft_channelizer_cc.h
+ * \brief Fast convolution filter bank that extracts several decimated
+ * sub-bands from a wideband signal in a single pass
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FFT_CHANNELIZER_CC_H
+#define GNSS_SDR_FFT_CHANNELIZER_CC_H
+
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_decimator.h>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class fft_channelizer_cc;
+
+#if GNURADIO_USES_STD_POINTERS
+using fft_channelizer_cc_sptr = std::shared_ptr<fft_channelizer_cc>;
+#else
+using fft_channelizer_cc_sptr = boost::shared_ptr<fft_channelizer_cc>;
+#endif
+
+/*!
+ * \brief Sub-band extracted by the channelizer
+ */
+struct Channelizer_Subband
+{
+    double center_freq_hz;  //!< Offset of the sub-band center from the center of the input band
+    double bandwidth_hz;    //!< Two-sided pass band
+};
+
+/*!
+ * \brief Makes a channelizer.
+ * \param sample_freq_in Input sampling frequency [Sps]
+ * \param decimation Ratio between the input and the (common) output sampling frequencies
+ * \param subbands One output port per sub-band, in this order
+ * \param item_type Input items: "gr_complex", "cshort" or "cbyte"
+ * \param fft_size Length of the forward transform. It is rounded up to a
+ * multiple of the decimation. 0 chooses it from the filter length.
+ * \param taps Length of the prototype low pass filter. 0 chooses it from
+ * the narrowest transition band.
+ */
+fft_channelizer_cc_sptr make_fft_channelizer_cc(
+    double sample_freq_in,
+    uint32_t decimation,
+    const std::vector<Channelizer_Subband> &subbands,
+    const std::string &item_type,
+    uint32_t fft_size = 0,
+    uint32_t taps = 0);
+
+/*!
+ * \brief This class implements a fast convolution (overlap-save) filter bank.
+ *
+ * Each block of input samples is transformed once. For each sub-band, the
+ * bins around its center are weighted with the frequency response of the
+ * low pass filter and brought back to the time domain with a short inverse
+ * transform of fft_size / decimation points, which translates, filters and
+ * decimates the sub-band at once. The sub-band centers are rounded to the
+ * nearest bin and the remainder is removed at the output rate, so each
+ * output is exactly the input mixed down by its center frequency, low pass
+ * filtered and decimated, with a phase that is continuous across blocks.
+ */
+class fft_channelizer_cc : public gr::sync_decimator
+{
+public:
+    ~fft_channelizer_cc() = default;
+
+    inline uint32_t fft_size() const { return d_fft_size; }           //!< Length of the forward transform
+    inline uint32_t overlap() const { return d_overlap; }             //!< Input samples shared by consecutive blocks
+    inline uint32_t num_taps() const { return d_num_taps; }           //!< Length of the prototype filter
+    inline size_t num_subbands() const { return d_subbands.size(); }  //!< Number of output ports
+    inline double latency() const { return (d_num_taps - 1) / 2.0; }  //!< Group delay, in input samples
+
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend fft_channelizer_cc_sptr make_fft_channelizer_cc(
+        double sample_freq_in,
+        uint32_t decimation,
+        const std::vector<Channelizer_Subband> &subbands,
+        const std::string &item_type,
+        uint32_t fft_size,
+        uint32_t taps);
+
+    fft_channelizer_cc(
+        double sample_freq_in,
+        uint32_t decimation,
+        const std::vector<Channelizer_Subband> &subbands,
+        const std::string &item_type,
+        uint32_t fft_size,
+        uint32_t taps);
+
+    // item type, resolved once from its name
+    enum class Item_Type
+    {
+        Gr_Complex,
+        Cshort,
+        Cbyte
+    };
+
+    struct Subband_State
+    {
+        uint64_t center_bin;                 // in [0, d_fft_size)
+        std::vector<uint32_t> bins;          // input bin of each of the d_ifft_size output bins
+        std::vector<gr_complex> response;    // filter response on those bins, scaled by 1 / d_fft_size
+        std::complex<double> residual_step;  // output rate mixing of the remainder of the center frequency
+        std::complex<double> residual_phase;
+    };
+
+    static Item_Type item_type_from_name(const std::string &item_type);
+    static size_t item_size(Item_Type item_type);
+
+    void design_subband(const Channelizer_Subband &subband, const std::vector<gr_complex> &response, Subband_State &state) const;
+    void load_block(const void *in);
+
+    double d_sample_freq_in;
+    uint32_t d_decimation;
+    Item_Type d_item_type;
+    size_t d_item_size;
+    uint32_t d_num_taps;
+    uint32_t d_fft_size;
+    uint32_t d_ifft_size;
+    uint32_t d_overlap;          // multiple of the decimation, at least d_num_taps - 1
+    uint32_t d_step;             // new input samples per block
+    uint64_t d_block_start_mod;  // index of the first sample of the block, modulo d_fft_size
+
+    std::vector<Channelizer_Subband> d_subbands;
+    std::vector<Subband_State> d_states;
+    std::shared_ptr<gr::fft::fft_complex> d_fft;
+    std::shared_ptr<gr::fft::fft_complex> d_ifft;
+};
+
+#endif  // GNSS_SDR_FFT_CHANNELIZER_CC_H
@@ -0,0 +1,63 @@
+/*!
+ * \file mitigation_kernels.cc
+ * \brief Vector kernels and detection statistics shared by the interference
+ * mitigation filters
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mitigation_kernels.h"
+#include <volk/volk.h>
+
+
+void segment_energies(float *energies, const gr_complex *in, int32_t length, int32_t segments, float *scratch)
+{
+    volk_32fc_magnitude_squared_32f(scratch, in, length * segments);
+    for (int32_t s = 0; s < segments; s++)
+        {
+            volk_32f_accumulator_s32f(&energies[s], scratch + s * length, length);
+        }
+}
+
+
+// The recursive part is the only one left sample by sample: one complex
+// multiply-accumulate per sample
+void notch_section_32fc(gr_complex *out, const gr_complex *in, const gr_complex *in_prev, gr_complex *z, float p, gr_complex &last_out, gr_complex *scratch, int32_t n)
+{
+    volk_32fc_x2_multiply_32fc(scratch, z, in_prev, n);
+    volk_32f_x2_subtract_32f(reinterpret_cast<float *>(scratch), reinterpret_cast<const float *>(in), reinterpret_cast<const float *>(scratch), 2 * n);
+    volk_32f_s32f_multiply_32f(reinterpret_cast<float *>(z), reinterpret_cast<const float *>(z), p, 2 * n);
+    gr_complex last = last_out;
+    for (int32_t k = 0; k < n; k++)
+        {
+            last = scratch[k] + z[k] * last;
+            out[k] = last;
+        }
+    last_out = last;
+}
+
+
+void notch_section_const_32fc(gr_complex *out, const gr_complex *in, const gr_complex *in_prev, gr_complex z, float p, gr_complex &last_out, gr_complex *scratch, int32_t n)
+{
+    volk_32fc_s32fc_multiply_32fc(scratch, in_prev, z, n);
+    volk_32f_x2_subtract_32f(reinterpret_cast<float *>(scratch), reinterpret_cast<const float *>(in), reinterpret_cast<const float *>(scratch), 2 * n);
+    const gr_complex pole = p * z;
+    gr_complex last = last_out;
+    for (int32_t k = 0; k < n; k++)
+        {
+            last = scratch[k] + pole * last;
+            out[k] = last;
+        }
+    last_out = last;
+}
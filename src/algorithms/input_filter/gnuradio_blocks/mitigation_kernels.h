@@ -0,0 +1,66 @@
+/*!
+ * \file mitigation_kernels.h
+ * \brief Vector kernels and detection statistics shared by the interference
+ * mitigation filters
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MITIGATION_KERNELS_H
+#define GNSS_SDR_MITIGATION_KERNELS_H
+
+#include <gnuradio/gr_complex.h>
+#include <cstdint>
+
+/*!
+ * \brief Detection statistics of an interference mitigation filter
+ */
+struct Interference_Statistics
+{
+    uint64_t segments = 0;    //!< Segments compared with the detection threshold
+    uint64_t detections = 0;  //!< Segments over the threshold, which were filtered or blanked
+    float last_ratio = 0.0;   //!< Energy to noise ratio of the last segment
+    float max_ratio = 0.0;    //!< Highest energy to noise ratio seen
+
+    inline void update(float ratio, bool detected)
+    {
+        segments++;
+        detections += detected ? 1 : 0;
+        last_ratio = ratio;
+        max_ratio = ratio > max_ratio ? ratio : max_ratio;
+    }
+};
+
+/*!
+ * \brief Energy of each of the segments of length samples in in, computed
+ * for the whole block at once. scratch holds segments * length floats.
+ */
+void segment_energies(float *energies, const gr_complex *in, int32_t length, int32_t segments, float *scratch);
+
+/*!
+ * \brief First order notch section with a zero that changes every sample:
+ * out[n] = in[n] - z[n] in_prev[n] + p z[n] out[n - 1]
+ *
+ * in_prev is in delayed by one sample, and last_out is out[-1] on input and
+ * the last output sample on return. z is scaled by p in place. scratch
+ * holds n samples, and can not be out.
+ */
+void notch_section_32fc(gr_complex *out, const gr_complex *in, const gr_complex *in_prev, gr_complex *z, float p, gr_complex &last_out, gr_complex *scratch, int32_t n);
+
+/*!
+ * \brief As notch_section_32fc, with the same zero for all the samples.
+ */
+void notch_section_const_32fc(gr_complex *out, const gr_complex *in, const gr_complex *in_prev, gr_complex z, float p, gr_complex &last_out, gr_complex *scratch, int32_t n);
+
+#endif  // GNSS_SDR_MITIGATION_KERNELS_H
@@ -0,0 +1,240 @@
+/*!
+ * \file multi_notch_cc.cc
+ * \brief Cascade of adaptive notch filters that tracks several continuous
+ * wave interferers at once
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "multi_notch_cc.h"
+#include <boost/math/distributions/chi_squared.hpp>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+const float TWO_PI = 6.28318530717958647692F;
+}
+
+
+multi_notch_sptr make_multi_notch_filter(float pfa, float p_c_factor,
+    int32_t length_, int32_t n_segments_est, int32_t n_segments_reset, int32_t n_interferers)
+{
+    return multi_notch_sptr(new MultiNotch(pfa, p_c_factor, length_, n_segments_est, n_segments_reset, n_interferers));
+}
+
+
+MultiNotch::MultiNotch(float pfa,
+    float p_c_factor,
+    int32_t length_,
+    int32_t n_segments_est,
+    int32_t n_segments_reset,
+    int32_t n_interferers) : gr::block("MultiNotch",
+                                 gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                                 gr::io_signature::make(1, 1, sizeof(gr_complex)))
+{
+    const int32_t alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
+    set_alignment(std::max(1, alignment_multiple));
+    set_history(2);
+    this->p_c_factor = p_c_factor;
+    this->length_ = length_;
+    set_output_multiple(length_);
+    n_deg_fred = 2 * length_;
+    n_segments = 0;
+    this->n_segments_est = n_segments_est;
+    this->n_segments_reset = n_segments_reset;
+    noise_pow_est = 0.0;
+    filter_state_ = false;
+    boost::math::chi_squared_distribution<float> my_dist_(n_deg_fred);
+    thres_ = boost::math::quantile(boost::math::complement(my_dist_, pfa));
+    // the power of a single bin of noise is chi-squared with two degrees of
+    // freedom, and length_ bins are searched. The spectral noise floor is an
+    // average of dB values, which falls short of the mean power of the bins
+    // by a factor exp(Euler's constant).
+    boost::math::chi_squared_distribution<float> bin_dist_(2);
+    thres_line_ = std::exp(0.5772156649F) * boost::math::quantile(boost::math::complement(bin_dist_, pfa / static_cast<float>(length_)));
+    d_sections = std::vector<Notch_Section>(std::max(1, n_interferers));
+    d_ping = volk_gnsssdr::vector<gr_complex>(length_ + 1);
+    d_pong = volk_gnsssdr::vector<gr_complex>(length_ + 1);
+    d_scratch = volk_gnsssdr::vector<gr_complex>(length_);
+    d_power_spect = volk_gnsssdr::vector<float>(length_);
+    d_fft = std::unique_ptr<gr::fft::fft_complex>(new gr::fft::fft_complex(length_, true));
+}
+
+
+void MultiNotch::forecast(int noutput_items __attribute__((unused)), gr_vector_int &ninput_items_required)
+{
+    for (int &aux : ninput_items_required)
+        {
+            aux = length_;
+        }
+}
+
+
+std::vector<float> MultiNotch::frequencies() const
+{
+    std::vector<float> freqs;
+    for (const auto &section : d_sections)
+        {
+            if (section.active)
+                {
+                    freqs.push_back(section.omega / TWO_PI);
+                }
+        }
+    return freqs;
+}
+
+
+bool MultiNotch::track(Notch_Section &section, const gr_complex *in)
+{
+    memcpy(d_fft->get_inbuf(), in, sizeof(gr_complex) * length_);
+    d_fft->execute();
+    const gr_complex *spectrum = d_fft->get_outbuf();
+    volk_32fc_magnitude_squared_32f(d_power_spect.data(), spectrum, length_);
+    uint32_t bin = 0;
+    volk_gnsssdr_32f_index_max_32u(&bin, d_power_spect.data(), length_);
+    // the mean power of a bin of noise is 2 * length_ * noise_pow_est
+    if (d_power_spect[bin] < thres_line_ * static_cast<float>(length_) * noise_pow_est)
+        {
+            return false;
+        }
+
+    // interpolation between bins (Jacobsen, with Candan's bias correction)
+    const gr_complex prev = spectrum[(bin + length_ - 1) % length_];
+    const gr_complex next = spectrum[(bin + 1) % length_];
+    const gr_complex den = 2.0F * spectrum[bin] - prev - next;
+    float delta = 0.0;
+    if (std::norm(den) > 0.0)
+        {
+            const auto half_bin = TWO_PI / 2.0F / static_cast<float>(length_);
+            delta = std::real((prev - next) / den) * std::tan(half_bin) / half_bin;
+            delta = std::min(std::max(delta, -0.5F), 0.5F);
+        }
+    float omega = TWO_PI * (static_cast<float>(bin) + delta) / static_cast<float>(length_);
+    omega = std::remainder(omega, TWO_PI);
+
+    const float step = std::remainder(omega - section.omega, TWO_PI);
+    if (section.active and std::abs(step) < 2.0F * TWO_PI / static_cast<float>(length_))
+        {
+            section.omega = std::remainder(section.omega + TRACKING_GAIN * step, TWO_PI);
+        }
+    else
+        {
+            // a new interferer, or a jump of the one being tracked
+            section.omega = omega;
+            section.active = false;
+        }
+    return true;
+}
+
+
+int MultiNotch::general_work(int noutput_items, gr_vector_int &ninput_items __attribute__((unused)),
+    gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    float sig2dB = 0.0;
+    float sig2lin = 0.0;
+    const auto *in = reinterpret_cast<const gr_complex *>(input_items[0]);
+    auto *out = reinterpret_cast<gr_complex *>(output_items[0]);
+    in++;
+    const int32_t segments = (noutput_items - 1) / length_;
+    if (segments <= 0)
+        {
+            consume_each(0);
+            return 0;
+        }
+    if (d_energies.size() < static_cast<size_t>(segments))
+        {
+            d_energies.resize(segments);
+            d_magnitude.resize(static_cast<size_t>(segments) * length_);
+        }
+    segment_energies(d_energies.data(), in, length_, segments, d_magnitude.data());
+    for (int32_t s = 0; s < segments; s++)
+        {
+            bool filtered = false;
+            if ((n_segments < n_segments_est) && (filter_state_ == false))
+                {
+                    memcpy(d_fft->get_inbuf(), in, sizeof(gr_complex) * length_);
+                    d_fft->execute();
+                    volk_32fc_s32f_power_spectrum_32f(d_power_spect.data(), d_fft->get_outbuf(), 1.0, length_);
+                    volk_32f_s32f_calc_spectral_noise_floor_32f(&sig2dB, d_power_spect.data(), 15.0, length_);
+                    sig2lin = std::pow(10.0, (sig2dB / 10.0)) / (static_cast<float>(n_deg_fred));
+                    noise_pow_est = (static_cast<float>(n_segments) * noise_pow_est + sig2lin) / (static_cast<float>(n_segments + 1));
+                }
+            else
+                {
+                    const float ratio = d_energies[s] / noise_pow_est;
+                    const bool detected = ratio > thres_;
+                    d_stats.update(ratio, detected);
+                    if (detected)
+                        {
+                            filter_state_ = true;
+                            filtered = true;
+                            gr_complex *cur = d_ping.data();
+                            gr_complex *next = d_pong.data();
+                            cur[0] = *(in - 1);
+                            memcpy(cur + 1, in, sizeof(gr_complex) * length_);
+                            bool cascade = true;
+                            for (auto &section : d_sections)
+                                {
+                                    cascade = cascade and track(section, cur + 1);
+                                    if (cascade)
+                                        {
+                                            // the recursion starts from rest when the section (re)locks, as in Notch
+                                            gr_complex state = section.active ? section.last_out : gr_complex(0, 0);
+                                            section.active = true;
+                                            next[0] = section.last_out;
+                                            notch_section_const_32fc(next + 1, cur + 1, cur, std::polar(1.0F, section.omega), p_c_factor, state, d_scratch.data(), length_);
+                                            section.last_out = state;
+                                            std::swap(cur, next);
+                                        }
+                                    else
+                                        {
+                                            // pass through: the next section sees the previous output of this one
+                                            section.active = false;
+                                            cur[0] = section.last_out;
+                                            section.last_out = cur[length_];
+                                        }
+                                }
+                            memcpy(out, cur + 1, sizeof(gr_complex) * length_);
+                        }
+                    else
+                        {
+                            if (n_segments > n_segments_reset)
+                                {
+                                    n_segments = 0;
+                                }
+                            filter_state_ = false;
+                        }
+                }
+            if (not filtered)
+                {
+                    memcpy(out, in, sizeof(gr_complex) * length_);
+                    for (auto &section : d_sections)
+                        {
+                            section.active = false;
+                            section.last_out = in[length_ - 1];
+                        }
+                }
+            n_segments++;
+            in += length_;
+            out += length_;
+        }
+    consume_each(segments * length_);
+    return segments * length_;
+}
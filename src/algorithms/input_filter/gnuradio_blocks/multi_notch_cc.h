@@ -0,0 +1,118 @@
+/*!
+ * \file multi_notch_cc.h
+ * \brief Cascade of adaptive notch filters that tracks several continuous
+ * wave interferers at once
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MULTI_NOTCH_CC_H
+#define GNSS_SDR_MULTI_NOTCH_CC_H
+
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+#include "mitigation_kernels.h"
+#include <gnuradio/block.h>
+#include <gnuradio/fft/fft.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
+#include <cstdint>
+#include <vector>
+
+class MultiNotch;
+
+#if GNURADIO_USES_STD_POINTERS
+using multi_notch_sptr = std::shared_ptr<MultiNotch>;
+#else
+using multi_notch_sptr = boost::shared_ptr<MultiNotch>;
+#endif
+
+multi_notch_sptr make_multi_notch_filter(
+    float pfa,
+    float p_c_factor,
+    int32_t length_,
+    int32_t n_segments_est,
+    int32_t n_segments_reset,
+    int32_t n_interferers);
+
+/*!
+ * \brief This class implements a cascade of up to n_interferers first order
+ * notch filters, each one locked to a different continuous wave interferer.
+ *
+ * The noise power is estimated and the segments are detected as in Notch.
+ * When a segment is over the threshold, it goes through the sections one
+ * after the other. Each section looks for the strongest spectral line over
+ * the noise floor left by the previous ones, refines its frequency between
+ * the FFT bins and notches it with a zero that is constant within the
+ * segment. The cascade stops at the first section that finds no line, so
+ * the cost grows with the number of interferers actually present.
+ */
+class MultiNotch : public gr::block
+{
+public:
+    ~MultiNotch() = default;
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+    inline const Interference_Statistics &stats() const { return d_stats; }  //!< Detection statistics
+
+    /*!
+     * \brief Frequencies of the interferers being notched, normalized to the
+     * sampling frequency, in [-0.5, 0.5)
+     */
+    std::vector<float> frequencies() const;
+
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend multi_notch_sptr make_multi_notch_filter(float pfa, float p_c_factor, int32_t length_, int32_t n_segments_est, int32_t n_segments_reset, int32_t n_interferers);
+    MultiNotch(float pfa, float p_c_factor, int32_t length_, int32_t n_segments_est, int32_t n_segments_reset, int32_t n_interferers);
+
+    struct Notch_Section
+    {
+        bool active = false;
+        float omega = 0.0;                       // frequency of the zero [rad / sample]
+        gr_complex last_out = gr_complex(0, 0);  // last output sample of the section, filtered or not
+    };
+
+    bool track(Notch_Section &section, const gr_complex *in);
+
+    static constexpr float TRACKING_GAIN = 0.25;  // smoothing of the frequency of the sections
+
+    float noise_pow_est;
+    float thres_;
+    float thres_line_;
+    float p_c_factor;
+    int32_t length_;
+    int32_t n_deg_fred;
+    uint32_t n_segments;
+    uint32_t n_segments_est;
+    uint32_t n_segments_reset;
+    bool filter_state_;
+    std::vector<Notch_Section> d_sections;
+    volk_gnsssdr::vector<gr_complex> d_ping;  // d_ping[0] is the sample before the segment
+    volk_gnsssdr::vector<gr_complex> d_pong;
+    volk_gnsssdr::vector<gr_complex> d_scratch;
+    volk_gnsssdr::vector<float> d_power_spect;
+    volk_gnsssdr::vector<float> d_energies;
+    volk_gnsssdr::vector<float> d_magnitude;
+    Interference_Statistics d_stats;
+    std::unique_ptr<gr::fft::fft_complex> d_fft;
+};
+
+#endif  // GNSS_SDR_MULTI_NOTCH_CC_H
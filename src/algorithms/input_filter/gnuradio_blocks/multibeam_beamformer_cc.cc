@@ -0,0 +1,121 @@
+/*!
+ * \file multibeam_beamformer_cc.cc
+ * \brief Spatial filter that forms several beams from the elements of an
+ * antenna array, with weights that can be changed while the receiver runs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "multibeam_beamformer_cc.h"
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+
+multibeam_beamformer_cc_sptr make_multibeam_beamformer_cc(uint32_t elements, const std::vector<std::vector<gr_complex>> &weights)
+{
+    return multibeam_beamformer_cc_sptr(new multibeam_beamformer_cc(elements, weights));
+}
+
+
+multibeam_beamformer_cc::multibeam_beamformer_cc(uint32_t elements,
+    const std::vector<std::vector<gr_complex>> &weights) : gr::sync_block("multibeam_beamformer_cc",
+                                                               gr::io_signature::make(elements, elements, sizeof(gr_complex)),
+                                                               gr::io_signature::make(weights.size(), weights.size(), sizeof(gr_complex))),
+                                                           d_elements(elements),
+                                                           d_beams(weights.size()),
+                                                           d_ready(1),
+                                                           d_front(0),
+                                                           d_back(2),
+                                                           d_updates(0),
+                                                           d_published(0)
+{
+    if (weights.empty())
+        {
+            throw std::invalid_argument("the beamformer needs at least one beam");
+        }
+    for (auto &slot : d_slots)
+        {
+            slot = volk_gnsssdr::vector<gr_complex>(d_beams * d_elements);
+        }
+    for (uint32_t b = 0; b < d_beams; b++)
+        {
+            if (weights[b].size() != d_elements)
+                {
+                    throw std::invalid_argument("beam " + std::to_string(b) + " has " + std::to_string(weights[b].size()) + " weights for " + std::to_string(d_elements) + " elements");
+                }
+            std::copy(weights[b].begin(), weights[b].end(), d_slots[d_front].begin() + b * d_elements);
+        }
+    d_product = volk_gnsssdr::vector<gr_complex>(TILE_SAMPLES);
+    const int alignment_multiple = volk_get_alignment() / sizeof(gr_complex);
+    set_alignment(std::max(1, alignment_multiple));
+}
+
+
+bool multibeam_beamformer_cc::set_weights(const std::vector<std::vector<gr_complex>> &weights)
+{
+    if (weights.size() != d_beams)
+        {
+            return false;
+        }
+    for (const auto &beam : weights)
+        {
+            if (beam.size() != d_elements)
+                {
+                    return false;
+                }
+        }
+    std::lock_guard<std::mutex> lock(d_writer_mutex);
+    for (uint32_t b = 0; b < d_beams; b++)
+        {
+            std::copy(weights[b].begin(), weights[b].end(), d_slots[d_back].begin() + b * d_elements);
+        }
+    // the slot written becomes the latest complete one, and the one it
+    // replaces (never the one being applied) is written next time
+    d_back = d_ready.exchange(d_back | FRESH, std::memory_order_acq_rel) & SLOT_MASK;
+    d_published++;
+    return true;
+}
+
+
+int multibeam_beamformer_cc::work(int noutput_items,
+    gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items)
+{
+    if (d_ready.load(std::memory_order_relaxed) & FRESH)
+        {
+            d_front = d_ready.exchange(d_front, std::memory_order_acq_rel) & SLOT_MASK;
+            d_updates++;
+        }
+    const gr_complex *weights = d_slots[d_front].data();
+
+    for (int start = 0; start < noutput_items; start += TILE_SAMPLES)
+        {
+            const auto len = static_cast<unsigned int>(std::min<int>(TILE_SAMPLES, noutput_items - start));
+            for (uint32_t b = 0; b < d_beams; b++)
+                {
+                    auto *out = reinterpret_cast<gr_complex *>(output_items[b]) + start;
+                    const gr_complex *w = weights + b * d_elements;
+                    volk_32fc_s32fc_multiply_32fc(out, reinterpret_cast<const gr_complex *>(input_items[0]) + start, w[0], len);
+                    for (uint32_t i = 1; i < d_elements; i++)
+                        {
+                            volk_32fc_s32fc_multiply_32fc(d_product.data(), reinterpret_cast<const gr_complex *>(input_items[i]) + start, w[i], len);
+                            volk_32f_x2_add_32f(reinterpret_cast<float *>(out), reinterpret_cast<const float *>(out), reinterpret_cast<const float *>(d_product.data()), 2 * len);
+                        }
+                }
+        }
+    return noutput_items;
+}
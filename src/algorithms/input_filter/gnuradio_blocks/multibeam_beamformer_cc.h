@@ -0,0 +1,108 @@
+/*!
+ * \file multibeam_beamformer_cc.h
+ * \brief Spatial filter that forms several beams from the elements of an
+ * antenna array, with weights that can be changed while the receiver runs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MULTIBEAM_BEAMFORMER_CC_H
+#define GNSS_SDR_MULTIBEAM_BEAMFORMER_CC_H
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/sync_block.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class multibeam_beamformer_cc;
+
+#if GNURADIO_USES_STD_POINTERS
+using multibeam_beamformer_cc_sptr = std::shared_ptr<multibeam_beamformer_cc>;
+#else
+using multibeam_beamformer_cc_sptr = boost::shared_ptr<multibeam_beamformer_cc>;
+#endif
+
+/*!
+ * \brief Makes a beamformer with one input port per array element and one
+ * output port per row of weights. Each row holds one weight per element.
+ * Throws std::invalid_argument if a row does not.
+ */
+multibeam_beamformer_cc_sptr make_multibeam_beamformer_cc(
+    uint32_t elements,
+    const std::vector<std::vector<gr_complex>> &weights);
+
+/*!
+ * \brief This class computes out_b[n] = sum_i w[b][i] in_i[n] for all the
+ * beams b, as a complex matrix product on blocks of samples that stay in
+ * cache while all the beams are accumulated with VOLK kernels.
+ *
+ * New weights can be published from any thread with set_weights(). The
+ * stream never waits for them: weights are exchanged through three slots
+ * (the one being applied, the one being written and the latest complete
+ * one), and work() picks up the latest complete set at its next call.
+ */
+class multibeam_beamformer_cc : public gr::sync_block
+{
+public:
+    ~multibeam_beamformer_cc() = default;
+
+    /*!
+     * \brief Publishes new weights, with the same layout as in the
+     * constructor. Returns false, leaving the current ones, if the number
+     * of beams or elements does not match.
+     */
+    bool set_weights(const std::vector<std::vector<gr_complex>> &weights);
+
+    inline uint32_t beams() const { return d_beams; }                         //!< Number of output ports
+    inline uint32_t elements() const { return d_elements; }                   //!< Number of input ports
+    inline uint64_t weight_updates() const { return d_updates.load(); }       //!< Weight sets applied since the start
+    inline uint64_t published_weights() const { return d_published.load(); }  //!< Weight sets received since the start
+
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend multibeam_beamformer_cc_sptr make_multibeam_beamformer_cc(
+        uint32_t elements,
+        const std::vector<std::vector<gr_complex>> &weights);
+
+    multibeam_beamformer_cc(uint32_t elements, const std::vector<std::vector<gr_complex>> &weights);
+
+    static const uint32_t TILE_SAMPLES = 512;  // samples of every element processed for all the beams at once
+    static const uint32_t FRESH = 4;           // flag of d_ready: it holds weights not applied yet
+    static const uint32_t SLOT_MASK = 3;
+
+    uint32_t d_elements;
+    uint32_t d_beams;
+    std::array<volk_gnsssdr::vector<gr_complex>, 3> d_slots;  // d_beams x d_elements weights, by beam
+    std::atomic<uint32_t> d_ready;                           // latest complete slot, plus FRESH
+    uint32_t d_front;                                        // slot being applied, owned by work()
+    uint32_t d_back;                                         // slot being written, owned by set_weights()
+    std::mutex d_writer_mutex;                               // serializes writers only
+    std::atomic<uint64_t> d_updates;
+    std::atomic<uint64_t> d_published;
+    volk_gnsssdr::vector<gr_complex> d_product;
+};
+
+#endif  // GNSS_SDR_MULTIBEAM_BEAMFORMER_CC_H
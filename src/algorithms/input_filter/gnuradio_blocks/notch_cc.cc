@@ -18,9 +18,11 @@
  */
 
 #include "notch_cc.h"
+#include "mitigation_kernels.h"
 #include <boost/math/distributions/chi_squared.hpp>
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 #include <algorithm>
 #include <cstring>
 
@@ -58,6 +60,7 @@ Notch::Notch(float pfa,
     c_samples = static_cast<gr_complex *>(volk_malloc(length_ * sizeof(gr_complex), volk_get_alignment()));
     angle_ = static_cast<float *>(volk_malloc(length_ * sizeof(float), volk_get_alignment()));
     power_spect = static_cast<float *>(volk_malloc(length_ * sizeof(float), volk_get_alignment()));
+    z_ = static_cast<gr_complex *>(volk_malloc(length_ * sizeof(gr_complex), volk_get_alignment()));
     last_out = gr_complex(0.0, 0.0);
     d_fft = std::unique_ptr<gr::fft::fft_complex>(new gr::fft::fft_complex(length_, true));
 }
@@ -68,6 +71,7 @@ Notch::~Notch()
     volk_free(c_samples);
     volk_free(angle_);
     volk_free(power_spect);
+    volk_free(z_);
 }
 
 
@@ -83,14 +87,25 @@ void Notch::forecast(int noutput_items __attribute__((unused)), gr_vector_int &n
 int Notch::general_work(int noutput_items, gr_vector_int &ninput_items __attribute__((unused)),
     gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
-    int32_t index_out = 0;
     float sig2dB = 0.0;
     float sig2lin = 0.0;
-    lv_32fc_t dot_prod_;
     const auto *in = reinterpret_cast<const gr_complex *>(input_items[0]);
     auto *out = reinterpret_cast<gr_complex *>(output_items[0]);
     in++;
-    while ((index_out + length_) < noutput_items)
+    const int32_t segments = (noutput_items - 1) / length_;
+    if (segments <= 0)
+        {
+            consume_each(0);
+            return 0;
+        }
+    // energies of all the segments of the block at once
+    if (d_energies.size() < static_cast<size_t>(segments))
+        {
+            d_energies.resize(segments);
+            d_magnitude.resize(static_cast<size_t>(segments) * length_);
+        }
+    segment_energies(d_energies.data(), in, length_, segments, d_magnitude.data());
+    for (int32_t s = 0; s < segments; s++)
         {
             if ((n_segments < n_segments_est) && (filter_state_ == false))
                 {
@@ -104,22 +119,21 @@ int Notch::general_work(int noutput_items, gr_vector_int &ninput_items __attribu
                 }
             else
                 {
-                    volk_32fc_x2_conjugate_dot_prod_32fc(&dot_prod_, in, in, length_);
-                    if ((lv_creal(dot_prod_) / noise_pow_est) > thres_)
+                    const float ratio = d_energies[s] / noise_pow_est;
+                    const bool detected = ratio > thres_;
+                    d_stats.update(ratio, detected);
+                    if (detected)
                         {
                             if (filter_state_ == false)
                                 {
                                     filter_state_ = true;
                                     last_out = gr_complex(0, 0);
                                 }
+                            // the zero follows the phase increment of every sample
                             volk_32fc_x2_multiply_conjugate_32fc(c_samples, in, (in - 1), length_);
                             volk_32fc_s32f_atan2_32f(angle_, c_samples, static_cast<float>(1.0), length_);
-                            for (int32_t aux = 0; aux < length_; aux++)
-                                {
-                                    z_0 = std::exp(gr_complex(0, 1) * (*(angle_ + aux)));
-                                    *(out + aux) = *(in + aux) - z_0 * (*(in + aux - 1)) + p_c_factor * z_0 * last_out;
-                                    last_out = *(out + aux);
-                                }
+                            volk_gnsssdr_32f_sincos_32fc(z_, angle_, length_);
+                            notch_section_32fc(out, in, in - 1, z_, p_c_factor.real(), last_out, c_samples, length_);
                         }
                     else
                         {
@@ -131,11 +145,10 @@ int Notch::general_work(int noutput_items, gr_vector_int &ninput_items __attribu
                             memcpy(out, in, sizeof(gr_complex) * length_);
                         }
                 }
-            index_out += length_;
             n_segments++;
             in += length_;
             out += length_;
         }
-    consume_each(index_out);
-    return index_out;
+    consume_each(segments * length_);
+    return segments * length_;
 }
@@ -25,8 +25,10 @@
 #else
 #include <boost/shared_ptr.hpp>
 #endif
+#include "mitigation_kernels.h"
 #include <gnuradio/block.h>
 #include <gnuradio/fft/fft.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
 #include <cstdint>
 
 class Notch;
@@ -54,6 +56,8 @@ public:
 
     void forecast(int noutput_items, gr_vector_int &ninput_items_required);
 
+    inline const Interference_Statistics &stats() const { return d_stats; }  //!< Detection statistics
+
     int general_work(int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items);
@@ -76,6 +80,10 @@ private:
     gr_complex *c_samples;
     float *angle_;
     float *power_spect;
+    gr_complex *z_;
+    volk_gnsssdr::vector<float> d_energies;
+    volk_gnsssdr::vector<float> d_magnitude;
+    Interference_Statistics d_stats;
     std::unique_ptr<gr::fft::fft_complex> d_fft;
 };
 
@@ -18,6 +18,7 @@
  */
 
 #include "notch_lite_cc.h"
+#include "mitigation_kernels.h"
 #include <boost/math/distributions/chi_squared.hpp>
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
@@ -64,6 +65,7 @@ NotchLite::NotchLite(float p_c_factor,
     angle1 = 0.0;
     angle2 = 0.0;
     power_spect = static_cast<float *>(volk_malloc(length_ * sizeof(float), volk_get_alignment()));
+    d_scratch = volk_gnsssdr::vector<gr_complex>(length_);
     d_fft = std::unique_ptr<gr::fft::fft_complex>(new gr::fft::fft_complex(length_, true));
 }
 
@@ -86,14 +88,24 @@ void NotchLite::forecast(int noutput_items __attribute__((unused)), gr_vector_in
 int NotchLite::general_work(int noutput_items, gr_vector_int &ninput_items __attribute__((unused)),
     gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
-    int32_t index_out = 0;
     float sig2dB = 0.0;
     float sig2lin = 0.0;
-    lv_32fc_t dot_prod_;
     const auto *in = reinterpret_cast<const gr_complex *>(input_items[0]);
     auto *out = reinterpret_cast<gr_complex *>(output_items[0]);
     in++;
-    while ((index_out + length_) < noutput_items)
+    const int32_t segments = (noutput_items - 1) / length_;
+    if (segments <= 0)
+        {
+            consume_each(0);
+            return 0;
+        }
+    if (d_energies.size() < static_cast<size_t>(segments))
+        {
+            d_energies.resize(segments);
+            d_magnitude.resize(static_cast<size_t>(segments) * length_);
+        }
+    segment_energies(d_energies.data(), in, length_, segments, d_magnitude.data());
+    for (int32_t s = 0; s < segments; s++)
         {
             if ((n_segments < n_segments_est) && (filter_state_ == false))
                 {
@@ -107,8 +119,10 @@ int NotchLite::general_work(int noutput_items, gr_vector_int &ninput_items __att
                 }
             else
                 {
-                    volk_32fc_x2_conjugate_dot_prod_32fc(&dot_prod_, in, in, length_);
-                    if ((lv_creal(dot_prod_) / noise_pow_est) > thres_)
+                    const float ratio = d_energies[s] / noise_pow_est;
+                    const bool detected = ratio > thres_;
+                    d_stats.update(ratio, detected);
+                    if (detected)
                         {
                             if (filter_state_ == false)
                                 {
@@ -125,11 +139,7 @@ int NotchLite::general_work(int noutput_items, gr_vector_int &ninput_items __att
                                     float angle_ = (angle1 + angle2) / 2.0;
                                     z_0 = std::exp(gr_complex(0, 1) * angle_);
                                 }
-                            for (int32_t aux = 0; aux < length_; aux++)
-                                {
-                                    *(out + aux) = *(in + aux) - z_0 * (*(in + aux - 1)) + p_c_factor * z_0 * last_out;
-                                    last_out = *(out + aux);
-                                }
+                            notch_section_const_32fc(out, in, in - 1, z_0, p_c_factor.real(), last_out, d_scratch.data(), length_);
                             n_segments_coeff++;
                             n_segments_coeff = n_segments_coeff % n_segments_coeff_reset;
                         }
@@ -143,11 +153,10 @@ int NotchLite::general_work(int noutput_items, gr_vector_int &ninput_items __att
                             memcpy(out, in, sizeof(gr_complex) * length_);
                         }
                 }
-            index_out += length_;
             n_segments++;
             in += length_;
             out += length_;
         }
-    consume_each(index_out);
-    return index_out;
+    consume_each(segments * length_);
+    return segments * length_;
 }
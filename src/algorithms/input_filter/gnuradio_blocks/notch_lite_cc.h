@@ -25,8 +25,10 @@
 #else
 #include <boost/shared_ptr.hpp>
 #endif
+#include "mitigation_kernels.h"
 #include <gnuradio/block.h>
 #include <gnuradio/fft/fft.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
 #include <cstdint>
 
 class NotchLite;
@@ -55,6 +57,8 @@ public:
 
     void forecast(int noutput_items, gr_vector_int &ninput_items_required);
 
+    inline const Interference_Statistics &stats() const { return d_stats; }  //!< Detection statistics
+
     int general_work(int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items);
@@ -81,6 +85,10 @@ private:
     float angle1;
     float angle2;
     float *power_spect;
+    volk_gnsssdr::vector<gr_complex> d_scratch;
+    volk_gnsssdr::vector<float> d_energies;
+    volk_gnsssdr::vector<float> d_magnitude;
+    Interference_Statistics d_stats;
     std::unique_ptr<gr::fft::fft_complex> d_fft;
 };
 
@@ -18,10 +18,12 @@
  */
 
 #include "pulse_blanking_cc.h"
+#include "mitigation_kernels.h"
 #include <boost/math/distributions/chi_squared.hpp>
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
 #include <algorithm>
+#include <cstring>
 
 
 pulse_blanking_cc_sptr make_pulse_blanking_cc(float pfa, int32_t length_,
@@ -78,13 +80,21 @@ int pulse_blanking_cc::general_work(int noutput_items, gr_vector_int &ninput_ite
 {
     const auto *in = reinterpret_cast<const gr_complex *>(input_items[0]);
     auto *out = reinterpret_cast<gr_complex *>(output_items[0]);
-    auto *magnitude = static_cast<float *>(volk_malloc(noutput_items * sizeof(float), volk_get_alignment()));
-    volk_32fc_magnitude_squared_32f(magnitude, in, noutput_items);
-    int32_t sample_index = 0;
-    float segment_energy;
-    while ((sample_index + length_) < noutput_items)
+    const int32_t segments = (noutput_items - 1) / length_;
+    if (segments <= 0)
         {
-            volk_32f_accumulator_s32f(&segment_energy, (magnitude + sample_index), length_);
+            consume_each(0);
+            return 0;
+        }
+    if (d_energies.size() < static_cast<size_t>(segments))
+        {
+            d_energies.resize(segments);
+            d_magnitude.resize(static_cast<size_t>(segments) * length_);
+        }
+    segment_energies(d_energies.data(), in, length_, segments, d_magnitude.data());
+    for (int32_t s = 0; s < segments; s++)
+        {
+            const float segment_energy = d_energies[s];
             if ((n_segments < n_segments_est) && (last_filtered == false))
                 {
                     noise_power_estimation = (static_cast<float>(n_segments) * noise_power_estimation + segment_energy / static_cast<float>(n_deg_fred)) / static_cast<float>(n_segments + 1);
@@ -92,7 +102,10 @@ int pulse_blanking_cc::general_work(int noutput_items, gr_vector_int &ninput_ite
                 }
             else
                 {
-                    if ((segment_energy / noise_power_estimation) > thres_)
+                    const float ratio = segment_energy / noise_power_estimation;
+                    const bool detected = ratio > thres_;
+                    d_stats.update(ratio, detected);
+                    if (detected)
                         {
                             memcpy(out, zeros_, sizeof(gr_complex) * length_);
                             last_filtered = true;
@@ -109,10 +122,8 @@ int pulse_blanking_cc::general_work(int noutput_items, gr_vector_int &ninput_ite
                 }
             in += length_;
             out += length_;
-            sample_index += length_;
             n_segments++;
         }
-    volk_free(magnitude);
-    consume_each(sample_index);
-    return sample_index;
+    consume_each(segments * length_);
+    return segments * length_;
 }
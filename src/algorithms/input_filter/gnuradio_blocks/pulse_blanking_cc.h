@@ -25,7 +25,9 @@
 #else
 #include <boost/shared_ptr.hpp>
 #endif
+#include "mitigation_kernels.h"
 #include <gnuradio/block.h>
+#include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
 #include <cstdint>
 
 class pulse_blanking_cc;
@@ -49,6 +51,8 @@ public:
 
     void forecast(int noutput_items, gr_vector_int &ninput_items_required);
 
+    inline const Interference_Statistics &stats() const { return d_stats; }  //!< Detection statistics
+
     int general_work(int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
@@ -65,6 +69,9 @@ private:
     float thres_;
     float pfa;
     gr_complex *zeros_;
+    volk_gnsssdr::vector<float> d_energies;
+    volk_gnsssdr::vector<float> d_magnitude;  // squared magnitude of the samples of the block
+    Interference_Statistics d_stats;
 };
 
 #endif  // GNSS_SDR_PULSE_BLANKING_H
@@ -0,0 +1,140 @@
+/*!
+ * \file fft_plan_registry.cc
+ * \brief Process-wide pool of FFT plans shared by the processing blocks
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_plan_registry.h"
+
+
+Fft_Plan_Registry& Fft_Plan_Registry::instance()
+{
+    static Fft_Plan_Registry registry;
+    return registry;
+}
+
+
+std::shared_ptr<gr::fft::fft_complex> Fft_Plan_Registry::get(uint32_t fft_size, bool forward)
+{
+    const std::shared_ptr<Pool> plans = pool(fft_size, forward);
+    std::unique_ptr<gr::fft::fft_complex> plan;
+    {
+        std::lock_guard<std::mutex> lock(plans->mutex);
+        if (!plans->free_plans.empty())
+            {
+                plan = std::move(plans->free_plans.back());
+                plans->free_plans.pop_back();
+            }
+    }
+    if (plan)
+        {
+            d_reused++;
+        }
+    else
+        {
+            // GNU Radio serializes the planning, do not hold the pool meanwhile
+            plan = std::unique_ptr<gr::fft::fft_complex>(new gr::fft::fft_complex(static_cast<int>(fft_size), forward));
+            {
+                // counted once it exists, in case the planner throws
+                std::lock_guard<std::mutex> lock(plans->mutex);
+                plans->plans++;
+            }
+            d_created++;
+        }
+    // The deleter keeps the pool alive, and gives the plan back to it
+    return std::shared_ptr<gr::fft::fft_complex>(plan.release(), [plans](gr::fft::fft_complex* returned) {
+        std::lock_guard<std::mutex> lock(plans->mutex);
+        plans->free_plans.emplace_back(returned);
+    });
+}
+
+
+void Fft_Plan_Registry::announce(uint32_t fft_size, bool forward)
+{
+    pool(fft_size, forward);
+}
+
+
+std::size_t Fft_Plan_Registry::warm_up(std::size_t plans_per_size)
+{
+    std::vector<std::pair<std::pair<uint32_t, bool>, std::shared_ptr<Pool>>> pools;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        pools.assign(d_pools.begin(), d_pools.end());
+    }
+    std::size_t created = 0;
+    for (const auto& entry : pools)
+        {
+            std::vector<std::unique_ptr<gr::fft::fft_complex>> new_plans;
+            std::size_t missing;
+            {
+                std::lock_guard<std::mutex> lock(entry.second->mutex);
+                missing = plans_per_size > entry.second->plans ? plans_per_size - entry.second->plans : 0;
+            }
+            for (std::size_t n = 0; n < missing; n++)
+                {
+                    new_plans.emplace_back(new gr::fft::fft_complex(static_cast<int>(entry.first.first), entry.first.second));
+                }
+            std::lock_guard<std::mutex> lock(entry.second->mutex);
+            entry.second->plans += new_plans.size();
+            for (auto& plan : new_plans)
+                {
+                    entry.second->free_plans.push_back(std::move(plan));
+                }
+            created += new_plans.size();
+        }
+    d_created += created;
+    return created;
+}
+
+
+void Fft_Plan_Registry::clear()
+{
+    // each pool lives on while its borrowed plans hold it
+    std::map<std::pair<uint32_t, bool>, std::shared_ptr<Pool>> pools;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        pools.swap(d_pools);
+    }
+    for (const auto& entry : pools)
+        {
+            std::lock_guard<std::mutex> lock(entry.second->mutex);
+            entry.second->free_plans.clear();
+        }
+}
+
+
+uint64_t Fft_Plan_Registry::get_created() const
+{
+    return d_created.load();
+}
+
+
+uint64_t Fft_Plan_Registry::get_reused() const
+{
+    return d_reused.load();
+}
+
+
+std::shared_ptr<Fft_Plan_Registry::Pool> Fft_Plan_Registry::pool(uint32_t fft_size, bool forward)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    std::shared_ptr<Pool>& plans = d_pools[std::make_pair(fft_size, forward)];
+    if (plans == nullptr)
+        {
+            plans = std::make_shared<Pool>();
+        }
+    return plans;
+}
@@ -0,0 +1,97 @@
+/*!
+ * \file fft_plan_registry.h
+ * \brief Process-wide pool of FFT plans shared by the processing blocks
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FFT_PLAN_REGISTRY_H
+#define GNSS_SDR_FFT_PLAN_REGISTRY_H
+
+#include <gnuradio/fft/fft.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*!
+ * \brief Pool of gr::fft::fft_complex objects, per size and direction.
+ *
+ * Creating a plan is slow: GNU Radio serializes it behind a global lock,
+ * runs FFTW in measure mode and reads and writes its wisdom file each time.
+ * Blocks that only need an FFT for a short while (e.g., acquisition, which
+ * runs on a handful of channels at a time) borrow one with get() instead of
+ * owning their own, so the receiver creates as many plans as FFTs are in use
+ * at the same time, instead of two per channel.
+ *
+ * A borrowed plan goes back to the pool when the last copy of the returned
+ * pointer is destroyed. It must not be used by two threads at the same time.
+ */
+class Fft_Plan_Registry
+{
+public:
+    static Fft_Plan_Registry& instance();  //!< The registry of the process
+
+    /*!
+     * \brief Borrows a plan of the given size and direction, creating it if
+     * there is none free
+     */
+    std::shared_ptr<gr::fft::fft_complex> get(uint32_t fft_size, bool forward);
+
+    /*!
+     * \brief Records that a block will need plans of this size and direction,
+     * so that warm_up() can create them before they are used
+     */
+    void announce(uint32_t fft_size, bool forward);
+
+    /*!
+     * \brief Creates plans until each announced size and direction has at
+     * least plans_per_size of them. Returns the number of plans created.
+     */
+    std::size_t warm_up(std::size_t plans_per_size);
+
+    /*!
+     * \brief Destroys the free plans and forgets the announced sizes. The
+     * plans still borrowed are destroyed when they are returned, instead of
+     * going back to the registry. Called when the flow graph is torn down,
+     * since the registry itself outlives GNU Radio's planner lock.
+     */
+    void clear();
+
+    uint64_t get_created() const;  //!< Number of plans created so far
+    uint64_t get_reused() const;   //!< Number of plans lent from the pool
+
+private:
+    class Pool
+    {
+    public:
+        std::mutex mutex;
+        std::vector<std::unique_ptr<gr::fft::fft_complex>> free_plans;
+        std::size_t plans = 0;  // free or borrowed
+    };
+
+    Fft_Plan_Registry() = default;
+    std::shared_ptr<Pool> pool(uint32_t fft_size, bool forward);
+
+    std::mutex d_mutex;  // guards d_pools
+    std::map<std::pair<uint32_t, bool>, std::shared_ptr<Pool>> d_pools;
+    std::atomic<uint64_t> d_created{0};
+    std::atomic<uint64_t> d_reused{0};
+};
+
+#endif  // GNSS_SDR_FFT_PLAN_REGISTRY_H
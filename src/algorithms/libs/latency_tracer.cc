@@ -0,0 +1,312 @@
+/*!
+ * \file latency_tracer.cc
+ * \brief Process-wide tracer of the time it takes a block of samples to go
+ * from the signal source to each processing stage
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "latency_tracer.h"
+#include <glog/logging.h>
+#include <algorithm>  // for max
+#include <chrono>     // for steady_clock
+#include <sstream>    // for ostringstream
+
+
+namespace
+{
+const uint64_t MAX_TRACE_EVENTS = 1000000;  // about 200 MB of trace file
+
+const std::array<const char*, Latency_Tracer::num_stages> STAGE_NAMES{{"tracking", "observables", "pvt"}};
+
+
+int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+int32_t trace_thread_id(Latency_Tracer::Stage stage, int32_t channel)
+{
+    // one row per tracking channel, and then one per stage
+    return stage == Latency_Tracer::Tracking ? channel : 1000 + static_cast<int32_t>(stage);
+}
+}  // namespace
+
+
+const uint32_t Latency_Tracer::num_stages;
+
+
+Latency_Tracer& Latency_Tracer::instance()
+{
+    static Latency_Tracer tracer;
+    return tracer;
+}
+
+
+void Latency_Tracer::set_enabled(bool enabled)
+{
+    d_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+void Latency_Tracer::set_source(uint64_t samples_per_block, int32_t block_ms)
+{
+    for (auto& mark : d_marks)
+        {
+            mark.block.store(UINT64_MAX, std::memory_order_relaxed);
+        }
+    d_samples_per_block.store(samples_per_block, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(d_trace_mutex);
+    d_block_ms = block_ms;
+    update_trace_rate();
+}
+
+
+void Latency_Tracer::mark_source(uint64_t sample_counter)
+{
+    const uint64_t samples_per_block = d_samples_per_block.load(std::memory_order_relaxed);
+    if (samples_per_block == 0)
+        {
+            return;
+        }
+    const uint64_t block = sample_counter / samples_per_block;
+    Source_Mark& mark = d_marks[block % history_blocks];
+    // invalidate the slot while it is rewritten, so that readers do not
+    // take the time of another block
+    mark.block.store(UINT64_MAX, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    mark.time_ns.store(now_ns(), std::memory_order_relaxed);
+    mark.block.store(block, std::memory_order_release);
+}
+
+
+void Latency_Tracer::record(Stage stage, uint64_t sample_counter, int32_t channel)
+{
+    const int64_t now = now_ns();
+    const uint64_t samples_per_block = d_samples_per_block.load(std::memory_order_acquire);
+    if (samples_per_block == 0)
+        {
+            return;
+        }
+    Stage_Stats& stats = d_stats[stage];
+    // the first block that contains sample_counter
+    const uint64_t block = (sample_counter + samples_per_block - 1) / samples_per_block;
+    const Source_Mark& mark = d_marks[block % history_blocks];
+    const uint64_t block_before = mark.block.load(std::memory_order_acquire);
+    const int64_t source_ns = mark.time_ns.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t block_after = mark.block.load(std::memory_order_relaxed);
+    if (block_before != block or block_after != block)
+        {
+            // overwritten, or the sample counter has not got there yet
+            stats.missed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+    const int64_t latency_ns = std::max<int64_t>(now - source_ns, 0);
+    const std::vector<double>& bounds = bucket_bounds_ms();
+    const double latency_ms = static_cast<double>(latency_ns) / 1e6;
+    size_t bucket = 0;
+    while (bucket < bounds.size() and latency_ms > bounds[bucket])
+        {
+            bucket++;
+        }
+    stats.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.sum_ns.fetch_add(static_cast<uint64_t>(latency_ns), std::memory_order_relaxed);
+    int64_t max_ns = stats.max_ns.load(std::memory_order_relaxed);
+    while (latency_ns > max_ns and !stats.max_ns.compare_exchange_weak(max_ns, latency_ns, std::memory_order_relaxed))
+        {
+        }
+
+    const uint64_t trace_every_blocks = d_trace_every_blocks.load(std::memory_order_relaxed);
+    if (trace_every_blocks != 0 and block % trace_every_blocks == 0)
+        {
+            trace(stage, channel, sample_counter, source_ns, latency_ns);
+        }
+}
+
+
+std::vector<Latency_Histogram> Latency_Tracer::histograms() const
+{
+    std::vector<Latency_Histogram> result;
+    if (!enabled())
+        {
+            return result;
+        }
+    for (uint32_t stage = 0; stage < num_stages; stage++)
+        {
+            const Stage_Stats& stats = d_stats[stage];
+            Latency_Histogram histogram;
+            histogram.stage = STAGE_NAMES[stage];
+            for (const auto& count : stats.counts)
+                {
+                    histogram.counts.push_back(count.load(std::memory_order_relaxed));
+                }
+            histogram.count = stats.count.load(std::memory_order_relaxed);
+            histogram.missed = stats.missed.load(std::memory_order_relaxed);
+            histogram.sum_ms = static_cast<double>(stats.sum_ns.load(std::memory_order_relaxed)) / 1e6;
+            histogram.max_ms = static_cast<double>(stats.max_ns.load(std::memory_order_relaxed)) / 1e6;
+            result.push_back(histogram);
+        }
+    return result;
+}
+
+
+const std::vector<double>& Latency_Tracer::bucket_bounds_ms()
+{
+    static const std::vector<double> bounds{1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+    return bounds;
+}
+
+
+bool Latency_Tracer::open_trace(const std::string& file_name, int32_t period_ms)
+{
+    close_trace();
+    std::lock_guard<std::mutex> file_lock(d_file_mutex);
+    d_trace_file.open(file_name, std::ios::out | std::ios::trunc);
+    if (!d_trace_file.is_open())
+        {
+            LOG(WARNING) << "Can't open the latency trace file " << file_name;
+            return false;
+        }
+    d_trace_file << "[\n";
+    std::lock_guard<std::mutex> lock(d_trace_mutex);
+    d_trace_events.clear();
+    d_last_traced_block.clear();
+    d_named_threads.clear();
+    d_trace_event_count = 0;
+    d_trace_start_ns = now_ns();
+    d_trace_period_ms = std::max(period_ms, 1);
+    update_trace_rate();
+    return true;
+}
+
+
+void Latency_Tracer::flush_trace()
+{
+    std::lock_guard<std::mutex> file_lock(d_file_mutex);
+    std::string events;
+    {
+        // do not hold the recording threads while writing
+        std::lock_guard<std::mutex> lock(d_trace_mutex);
+        events.swap(d_trace_events);
+    }
+    if (d_trace_file.is_open() and !events.empty())
+        {
+            d_trace_file << events;
+            d_trace_file.flush();
+        }
+}
+
+
+void Latency_Tracer::close_trace()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_trace_mutex);
+        d_trace_period_ms = 0;
+        update_trace_rate();
+    }
+    flush_trace();
+    std::lock_guard<std::mutex> file_lock(d_file_mutex);
+    if (d_trace_file.is_open())
+        {
+            d_trace_file << "\n]\n";
+            d_trace_file.close();
+        }
+}
+
+
+void Latency_Tracer::reset()
+{
+    for (auto& mark : d_marks)
+        {
+            mark.block.store(UINT64_MAX, std::memory_order_relaxed);
+        }
+    for (auto& stats : d_stats)
+        {
+            for (auto& count : stats.counts)
+                {
+                    count.store(0, std::memory_order_relaxed);
+                }
+            stats.count.store(0, std::memory_order_relaxed);
+            stats.missed.store(0, std::memory_order_relaxed);
+            stats.sum_ns.store(0, std::memory_order_relaxed);
+            stats.max_ns.store(0, std::memory_order_relaxed);
+        }
+}
+
+
+void Latency_Tracer::update_trace_rate()
+{
+    // called with d_trace_mutex held
+    uint64_t every_blocks = 0;
+    if (d_trace_period_ms > 0)
+        {
+            every_blocks = d_block_ms > 0 ? std::max(d_trace_period_ms / d_block_ms, 1) : 1;
+        }
+    d_trace_every_blocks.store(every_blocks, std::memory_order_relaxed);
+}
+
+
+void Latency_Tracer::trace(Stage stage, int32_t channel, uint64_t sample_counter, int64_t source_ns, int64_t latency_ns)
+{
+    const uint64_t samples_per_block = d_samples_per_block.load(std::memory_order_relaxed);
+    const uint64_t block = (sample_counter + samples_per_block - 1) / samples_per_block;
+    const int32_t thread_id = trace_thread_id(stage, channel);
+    std::lock_guard<std::mutex> lock(d_trace_mutex);
+    if (d_trace_period_ms == 0 or source_ns < d_trace_start_ns or d_trace_event_count >= MAX_TRACE_EVENTS)
+        {
+            return;
+        }
+    // a stage may output several times per block, keep the first one
+    auto last_traced = d_last_traced_block.find(std::make_pair(static_cast<int32_t>(stage), channel));
+    if (last_traced != d_last_traced_block.end() and last_traced->second == block)
+        {
+            return;
+        }
+    d_last_traced_block[std::make_pair(static_cast<int32_t>(stage), channel)] = block;
+
+    std::ostringstream event;
+    if (d_named_threads.insert(thread_id).second)
+        {
+            event << (d_trace_event_count > 0 ? ",\n" : "")
+                  << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread_id
+                  << ",\"args\":{\"name\":\"";
+            if (stage == Tracking)
+                {
+                    event << "Channel " << channel << " tracking";
+                }
+            else
+                {
+                    event << STAGE_NAMES[stage];
+                }
+            event << "\"}}";
+            d_trace_event_count++;
+        }
+    event.setf(std::ios::fixed);
+    event.precision(3);
+    event << (d_trace_event_count > 0 ? ",\n" : "")
+          << "{\"name\":\"" << STAGE_NAMES[stage] << "\",\"cat\":\"latency\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread_id
+          << ",\"ts\":" << static_cast<double>(source_ns - d_trace_start_ns) / 1e3
+          << ",\"dur\":" << static_cast<double>(latency_ns) / 1e3
+          << ",\"args\":{\"sample_counter\":" << sample_counter << ",\"channel\":" << channel << "}}";
+    d_trace_event_count++;
+    if (d_trace_event_count >= MAX_TRACE_EVENTS)
+        {
+            LOG(WARNING) << "The latency trace has reached " << MAX_TRACE_EVENTS << " events, no more are written";
+        }
+    d_trace_events += event.str();
+}
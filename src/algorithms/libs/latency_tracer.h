@@ -0,0 +1,168 @@
+/*!
+ * \file latency_tracer.h
+ * \brief Process-wide tracer of the time it takes a block of samples to go
+ * from the signal source to each processing stage
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_LATENCY_TRACER_H
+#define GNSS_SDR_LATENCY_TRACER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * \brief Latency distribution of a processing stage
+ */
+class Latency_Histogram
+{
+public:
+    std::string stage;             // "tracking", "observables" or "pvt"
+    std::vector<uint64_t> counts;  // per bucket of Latency_Tracer::bucket_bounds_ms(), and a last one for the slower
+    uint64_t count = 0;            // measured outputs
+    uint64_t missed = 0;           // outputs whose source block was not in the history
+    double sum_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+
+/*!
+ * \brief Measures the sample-to-output latency of the receiver, keyed on
+ * Gnss_Synchro::Tracking_sample_counter.
+ *
+ * The sample counter marks the wall time at which each block of samples
+ * leaves the signal source (after the signal conditioner). Tracking,
+ * observables and PVT record the sample counter of each of their outputs,
+ * and the tracer looks up when that sample left the source. The latencies go
+ * to a histogram per stage and, optionally, to a Chrome trace file that can
+ * be opened with chrome://tracing or https://ui.perfetto.dev
+ *
+ * The source marks are kept in a lock-free ring, so recording costs a clock
+ * read and a few relaxed atomic operations. When the tracer is disabled
+ * (the default) the instrumented blocks only read a flag.
+ */
+class Latency_Tracer
+{
+public:
+    enum Stage : uint8_t
+    {
+        Tracking,
+        Observables,
+        Pvt
+    };
+    static const uint32_t num_stages = 3;
+
+    static Latency_Tracer& instance();  //!< The tracer of the process
+
+    /*!
+     * \brief Starts or stops measuring
+     */
+    void set_enabled(bool enabled);
+
+    bool enabled() const
+    {
+        return d_enabled.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Size and duration of the blocks marked by mark_source(). Forgets
+     * the previous marks.
+     */
+    void set_source(uint64_t samples_per_block, int32_t block_ms);
+
+    /*!
+     * \brief Records that the samples up to sample_counter left the signal
+     * source now. Must be called from a single thread.
+     */
+    void mark_source(uint64_t sample_counter);
+
+    /*!
+     * \brief Records that a stage has output the result of the samples up to
+     * sample_counter. Channel is -1 for the stages that are not per channel.
+     */
+    void record(Stage stage, uint64_t sample_counter, int32_t channel = -1);
+
+    /*!
+     * \brief Latency distribution of each stage, or none if disabled
+     */
+    std::vector<Latency_Histogram> histograms() const;
+
+    /*!
+     * \brief Upper bounds of the histogram buckets [ms]
+     */
+    static const std::vector<double>& bucket_bounds_ms();
+
+    /*!
+     * \brief Writes one output of each stage and channel every period_ms
+     * to a Chrome trace file (JSON array format)
+     */
+    bool open_trace(const std::string& file_name, int32_t period_ms);
+
+    void flush_trace();  //!< Writes the buffered trace events to the file
+    void close_trace();  //!< Flushes and closes the trace file
+
+    void reset();  //!< Clears the marks and the histograms
+
+private:
+    class Source_Mark
+    {
+    public:
+        std::atomic<uint64_t> block{UINT64_MAX};  // sample_counter / samples_per_block
+        std::atomic<int64_t> time_ns{0};
+    };
+
+    class alignas(64) Stage_Stats
+    {
+    public:
+        std::array<std::atomic<uint64_t>, 14> counts{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> missed{0};
+        std::atomic<uint64_t> sum_ns{0};
+        std::atomic<int64_t> max_ns{0};
+    };
+
+    static const uint32_t history_blocks = 8192;
+
+    Latency_Tracer() = default;
+    void update_trace_rate();
+    void trace(Stage stage, int32_t channel, uint64_t sample_counter, int64_t source_ns, int64_t latency_ns);
+
+    std::atomic<bool> d_enabled{false};
+    std::atomic<uint64_t> d_samples_per_block{0};
+    std::atomic<uint64_t> d_trace_every_blocks{0};  // 0 if there is no trace file
+    std::array<Source_Mark, history_blocks> d_marks;
+    std::array<Stage_Stats, num_stages> d_stats;
+
+    std::mutex d_trace_mutex;  // guards the trace members below
+    int32_t d_block_ms = 0;
+    int32_t d_trace_period_ms = 0;
+    std::string d_trace_events;
+    std::map<std::pair<int32_t, int32_t>, uint64_t> d_last_traced_block;  // per stage and channel
+    std::set<int32_t> d_named_threads;
+    uint64_t d_trace_event_count = 0;
+    int64_t d_trace_start_ns = 0;
+    std::mutex d_file_mutex;
+    std::ofstream d_trace_file;
+};
+
+#endif  // GNSS_SDR_LATENCY_TRACER_H
@@ -256,6 +256,10 @@ const double MAXDTOE_SBS = 360.0;    //!<    max time difference to SBAS Toe (s)
 const double MAXDTOE_S = 86400.0;    //!<    max time difference to ephem toe (s) for other
 const double MAXGDOP = 300.0;        //!<    max GDOP
 
+const int ORBFIT_NCOEF = 12;       //!<    number of Chebyshev coefficients of the satellite orbit/clock fit
+const double ORBFIT_SPAN = 300.0;  //!<    time span of the satellite orbit/clock fit (s)
+const double ORBFIT_LEAD = 30.0;   //!<    time span of the fit before the time at which it is requested (s)
+
 const int MAXSBSURA = 8;  //!<    max URA of SBAS satellite
 const int MAXBAND = 10;   //!<    max SBAS band of IGP
 const int MAXNIGP = 201;  //!<    max number of IGP in SBAS band
@@ -467,6 +471,24 @@ typedef struct
 } geph_t;
 
 
+typedef struct
+{                                 /* satellite orbit/clock polynomial fit type */
+    int sat;                      /* satellite number (0: empty) */
+    int iode;                     /* IODE of the fitted ephemeris */
+    gtime_t toe;                  /* Toe of the fitted ephemeris */
+    double key[3];                /* orbit/clock parameters identifying the fitted ephemeris */
+    gtime_t ts;                   /* start time of the fit span (gpst) */
+    double var;                   /* satellite position and clock variance (m^2) */
+    double coef[4][ORBFIT_NCOEF]; /* Chebyshev coefficients {x,y,z,dts} */
+} orbfit_t;
+
+
+typedef struct
+{                         /* satellite orbit/clock cache type */
+    orbfit_t fit[MAXSAT]; /* polynomial fits indexed by satellite number - 1 */
+} orbcache_t;
+
+
 typedef struct
 {                          /* precise ephemeris type */
     gtime_t time;          /* time (GPST) */
@@ -787,6 +809,7 @@ typedef struct
     lexeph_t lexeph[MAXSAT];      /* LEX ephemeris */
     lexion_t lexion;              /* LEX ionosphere correction */
     pppcorr_t pppcorr;            /* ppp corrections */
+    orbcache_t *orbcache;         /* satellite orbit/clock cache (nullptr: disabled) */
 } nav_t;
 
 
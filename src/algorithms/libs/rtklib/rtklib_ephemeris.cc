@@ -693,6 +693,181 @@ int ephclk(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
 }
 
 
+/* satellite orbit/clock by the exact ephemeris model ------------------------*/
+void orbexact(gtime_t time, const eph_t *eph, const geph_t *geph, double *rs,
+    double *dts, double *var)
+{
+    if (eph)
+        {
+            eph2pos(time, eph, rs, dts, var);
+        }
+    else
+        {
+            geph2pos(time, geph, rs, dts, var);
+        }
+}
+
+
+/* set parameters identifying an ephemeris in an orbit/clock fit -------------*/
+void orbkey(const eph_t *eph, const geph_t *geph, int *sat, int *iode,
+    gtime_t *toe, double *key)
+{
+    if (eph)
+        {
+            *sat = eph->sat;
+            *iode = eph->iode;
+            *toe = eph->toe;
+            key[0] = eph->M0;
+            key[1] = eph->A;
+            key[2] = eph->f0;
+        }
+    else
+        {
+            *sat = geph->sat;
+            *iode = geph->iode;
+            *toe = geph->toe;
+            key[0] = geph->pos[0];
+            key[1] = geph->pos[1];
+            key[2] = geph->taun;
+        }
+}
+
+
+/* polynomial fit of satellite orbit and clock ---------------------------------
+ * fit Chebyshev polynomials to the satellite position and clock bias computed
+ * with the broadcast ephemeris over the time span [ts, ts + ORBFIT_SPAN]
+ * args   : gtime_t ts       I   start time of the fit span (gpst)
+ *          eph_t  *eph      I   broadcast ephemeris (nullptr: use geph)
+ *          geph_t *geph     I   glonass ephemeris (used if eph is nullptr)
+ *          orbfit_t *fit    O   orbit/clock fit
+ * return : none
+ * notes  : the exact model is evaluated at the ORBFIT_NCOEF Chebyshev nodes of
+ *          the span, so the polynomial interpolates it at those nodes
+ *-----------------------------------------------------------------------------*/
+void orbfit(gtime_t ts, const eph_t *eph, const geph_t *geph, orbfit_t *fit)
+{
+    double val[ORBFIT_NCOEF][4];
+    double rs[3];
+    double dts;
+    double u;
+    int i;
+    int j;
+    int k;
+
+    orbkey(eph, geph, &fit->sat, &fit->iode, &fit->toe, fit->key);
+
+    trace(4, "orbfit  : ts=%s sat=%2d\n", time_str(ts, 3), fit->sat);
+
+    fit->ts = ts;
+    for (k = 0; k < ORBFIT_NCOEF; k++)
+        {
+            u = cos(PI * (k + 0.5) / ORBFIT_NCOEF);
+            orbexact(timeadd(ts, 0.5 * ORBFIT_SPAN * (u + 1.0)), eph, geph, rs, &dts, &fit->var);
+            for (i = 0; i < 3; i++)
+                {
+                    val[k][i] = rs[i];
+                }
+            val[k][3] = dts;
+        }
+    for (i = 0; i < 4; i++)
+        {
+            for (j = 0; j < ORBFIT_NCOEF; j++)
+                {
+                    fit->coef[i][j] = 0.0;
+                    for (k = 0; k < ORBFIT_NCOEF; k++)
+                        {
+                            fit->coef[i][j] += val[k][i] * cos(PI * j * (k + 0.5) / ORBFIT_NCOEF);
+                        }
+                    fit->coef[i][j] *= (j == 0 ? 1.0 : 2.0) / ORBFIT_NCOEF;
+                }
+        }
+}
+
+
+/* satellite position and clock by orbit/clock cache ---------------------------
+ * compute satellite position, velocity, clock bias and clock drift by
+ * evaluating the cached polynomial fit of the broadcast ephemeris. the fit is
+ * recomputed if the ephemeris changed or time is out of the fit span
+ * args   : gtime_t time     I   time (gpst)
+ *          eph_t  *eph      I   broadcast ephemeris (nullptr: use geph)
+ *          geph_t *geph     I   glonass ephemeris (used if eph is nullptr)
+ *          orbcache_t *cache IO orbit/clock cache
+ *          double *rs       O   satellite position and velocity {x,y,z,vx,vy,vz} (ecef) (m|m/s)
+ *          double *dts      O   satellite clock {bias,drift} (s|s/s)
+ *          double *var      O   satellite position and clock variance (m^2)
+ * return : none
+ *-----------------------------------------------------------------------------*/
+void orbcachepos(gtime_t time, const eph_t *eph, const geph_t *geph,
+    orbcache_t *cache, double *rs, double *dts, double *var)
+{
+    orbfit_t *fit;
+    gtime_t toe;
+    double key[3];
+    double t;
+    double u;
+    double tj[ORBFIT_NCOEF];
+    double dj[ORBFIT_NCOEF];
+    double uj;
+    double ujm1;
+    double ujm2;
+    int sat;
+    int iode;
+    int i;
+    int j;
+
+    orbkey(eph, geph, &sat, &iode, &toe, key);
+    fit = cache->fit + sat - 1;
+    t = timediff(time, fit->ts);
+
+    if (fit->sat != sat || fit->iode != iode || timediff(toe, fit->toe) != 0.0 ||
+        key[0] != fit->key[0] || key[1] != fit->key[1] || key[2] != fit->key[2] ||
+        t < 0.0 || t > ORBFIT_SPAN)
+        {
+            orbfit(timeadd(time, -ORBFIT_LEAD), eph, geph, fit);
+            t = ORBFIT_LEAD;
+        }
+
+    /* Chebyshev polynomials T_j(u) and derivatives T'_j(u) = j*U_{j-1}(u) */
+    u = 2.0 * t / ORBFIT_SPAN - 1.0;
+    tj[0] = 1.0;
+    tj[1] = u;
+    dj[0] = 0.0;
+    dj[1] = 1.0;
+    ujm2 = 1.0;
+    ujm1 = 2.0 * u;
+    for (j = 2; j < ORBFIT_NCOEF; j++)
+        {
+            tj[j] = 2.0 * u * tj[j - 1] - tj[j - 2];
+            dj[j] = j * ujm1;
+            uj = 2.0 * u * ujm1 - ujm2;
+            ujm2 = ujm1;
+            ujm1 = uj;
+        }
+    for (i = 0; i < 4; i++)
+        {
+            double p = 0.0;
+            double v = 0.0;
+            for (j = 0; j < ORBFIT_NCOEF; j++)
+                {
+                    p += fit->coef[i][j] * tj[j];
+                    v += fit->coef[i][j] * dj[j];
+                }
+            v *= 2.0 / ORBFIT_SPAN;
+            if (i < 3)
+                {
+                    rs[i] = p;
+                    rs[i + 3] = v;
+                }
+            else
+                {
+                    dts[0] = p;
+                    dts[1] = v;
+                }
+        }
+    *var = fit->var;
+}
+
+
 /* satellite position and clock by broadcast ephemeris -----------------------*/
 int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
     int iode, double *rs, double *dts, double *var, int *svh)
@@ -718,11 +893,16 @@ int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
                 {
                     return 0;
                 }
+            *svh = eph->svh;
+            if (nav->orbcache)
+                {
+                    orbcachepos(time, eph, nullptr, nav->orbcache, rs, dts, var);
+                    return 1;
+                }
 
             eph2pos(time, eph, rs, dts, var);
             time = timeadd(time, tt);
             eph2pos(time, eph, rst, dtst, var);
-            *svh = eph->svh;
         }
     else if (sys == SYS_GLO)
         {
@@ -730,10 +910,15 @@ int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
                 {
                     return 0;
                 }
+            *svh = geph->svh;
+            if (nav->orbcache)
+                {
+                    orbcachepos(time, nullptr, geph, nav->orbcache, rs, dts, var);
+                    return 1;
+                }
             geph2pos(time, geph, rs, dts, var);
             time = timeadd(time, tt);
             geph2pos(time, geph, rst, dtst, var);
-            *svh = geph->svh;
         }
     else if (sys == SYS_SBS)
         {
@@ -56,6 +56,15 @@ geph_t *selgeph(gtime_t time, int sat, int iode, const nav_t *nav);
 seph_t *selseph(gtime_t time, int sat, const nav_t *nav);
 int ephclk(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
     double *dts);
+void orbexact(gtime_t time, const eph_t *eph, const geph_t *geph, double *rs,
+    double *dts, double *var);
+void orbkey(const eph_t *eph, const geph_t *geph, int *sat, int *iode,
+    gtime_t *toe, double *key);
+// polynomial fit of the satellite orbit and clock over a time span
+void orbfit(gtime_t ts, const eph_t *eph, const geph_t *geph, orbfit_t *fit);
+// satellite position, velocity and clock by the orbit/clock cache
+void orbcachepos(gtime_t time, const eph_t *eph, const geph_t *geph,
+    orbcache_t *cache, double *rs, double *dts, double *var);
 // satellite position and clock by broadcast ephemeris
 int ephpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
     int iode, double *rs, double *dts, double *var, int *svh);
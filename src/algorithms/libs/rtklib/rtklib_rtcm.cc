@@ -102,6 +102,7 @@ int init_rtcm(rtcm_t *rtcm)
     rtcm->obs.data = nullptr;
     rtcm->nav.eph = nullptr;
     rtcm->nav.geph = nullptr;
+    rtcm->nav.orbcache = nullptr;
 
     /* reallocate memory for observation and ephemris buffer */
     if (!(rtcm->obs.data = static_cast<obsd_t *>(malloc(sizeof(obsd_t) * MAXOBS))) ||
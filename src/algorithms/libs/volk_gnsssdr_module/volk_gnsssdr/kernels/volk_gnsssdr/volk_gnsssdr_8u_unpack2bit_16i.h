@@ -0,0 +1,219 @@
+/*!
+ * \file volk_gnsssdr_8u_unpack2bit_16i.h
+ * \brief VOLK_GNSSSDR kernel: unpacks 2-bit samples packed in bytes into 16 bits integers.
+ *
+ * VOLK_GNSSSDR kernel that unpacks four 2-bit two's complement samples per
+ * byte into 16 bits integers, mapping each sample v to 2 * v + 1.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_8u_unpack2bit_16i
+ *
+ * \b Overview
+ *
+ * Unpacks bytes containing four 2-bit two's complement samples each. The
+ * first sample is taken from the two least significant bits of the byte.
+ * Each sample v in {-2, -1, 0, 1} is mapped to 2 * v + 1, that is, to
+ * {-3, -1, 1, 3}. The mapping is done with a lookup table (byte shuffles in
+ * the SIMD implementations).
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_8u_unpack2bit_16i(int16_t* outVector, const uint8_t* inVector, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li inVector: Packed bytes. It must contain at least (num_points + 3) / 4 bytes.
+ * \li num_points: Number of samples to unpack.
+ *
+ * \b Outputs
+ * \li outVector: Unpacked samples.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8u_unpack2bit_16i_H
+#define INCLUDED_volk_gnsssdr_8u_unpack2bit_16i_H
+
+#include <stdint.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_8u_unpack2bit_16i_generic(int16_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    static const int16_t lut[4] = {1, 3, -3, -1};
+    const unsigned int num_bytes = num_points / 4;
+    unsigned int number;
+    unsigned int i;
+    int16_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+    uint8_t c;
+
+    for (number = 0; number < num_bytes; number++)
+        {
+            c = *inPtr++;
+            *outPtr++ = lut[c & 3];
+            *outPtr++ = lut[(c >> 2) & 3];
+            *outPtr++ = lut[(c >> 4) & 3];
+            *outPtr++ = lut[(c >> 6) & 3];
+        }
+
+    for (i = num_bytes * 4; i < num_points; ++i)
+        {
+            *outPtr++ = lut[(inVector[i / 4] >> (2 * (i % 4))) & 3];
+        }
+}
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSSE3
+#include <tmmintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_16i_u_ssse3(int16_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 64;
+    unsigned int number;
+    int16_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+
+    const __m128i lut = _mm_setr_epi8(1, 3, -3, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask = _mm_set1_epi8(0x03);
+    __m128i packed, s0, s1, s2, s3, s01lo, s01hi, s23lo, s23hi, q0, q1, q2, q3;
+
+    for (number = 0; number < sse_iters; number++)
+        {
+            packed = _mm_loadu_si128((__m128i*)inPtr);
+
+            // one register per sample position in the byte
+            s0 = _mm_shuffle_epi8(lut, _mm_and_si128(packed, mask));
+            s1 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(packed, 2), mask));
+            s2 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(packed, 4), mask));
+            s3 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(packed, 6), mask));
+
+            // interleave them back in sample order
+            s01lo = _mm_unpacklo_epi8(s0, s1);
+            s01hi = _mm_unpackhi_epi8(s0, s1);
+            s23lo = _mm_unpacklo_epi8(s2, s3);
+            s23hi = _mm_unpackhi_epi8(s2, s3);
+
+            q0 = _mm_unpacklo_epi16(s01lo, s23lo);
+            q1 = _mm_unpackhi_epi16(s01lo, s23lo);
+            q2 = _mm_unpacklo_epi16(s01hi, s23hi);
+            q3 = _mm_unpackhi_epi16(s01hi, s23hi);
+
+            // sign extension to 16 bits
+            _mm_storeu_si128((__m128i*)outPtr, _mm_srai_epi16(_mm_unpacklo_epi8(q0, q0), 8));
+            _mm_storeu_si128((__m128i*)(outPtr + 8), _mm_srai_epi16(_mm_unpackhi_epi8(q0, q0), 8));
+            _mm_storeu_si128((__m128i*)(outPtr + 16), _mm_srai_epi16(_mm_unpacklo_epi8(q1, q1), 8));
+            _mm_storeu_si128((__m128i*)(outPtr + 24), _mm_srai_epi16(_mm_unpackhi_epi8(q1, q1), 8));
+            _mm_storeu_si128((__m128i*)(outPtr + 32), _mm_srai_epi16(_mm_unpacklo_epi8(q2, q2), 8));
+            _mm_storeu_si128((__m128i*)(outPtr + 40), _mm_srai_epi16(_mm_unpackhi_epi8(q2, q2), 8));
+            _mm_storeu_si128((__m128i*)(outPtr + 48), _mm_srai_epi16(_mm_unpacklo_epi8(q3, q3), 8));
+            _mm_storeu_si128((__m128i*)(outPtr + 56), _mm_srai_epi16(_mm_unpackhi_epi8(q3, q3), 8));
+
+            inPtr += 16;
+            outPtr += 64;
+        }
+
+    volk_gnsssdr_8u_unpack2bit_16i_generic(outPtr, inPtr, num_points - sse_iters * 64);
+}
+#endif /* LV_HAVE_SSSE3 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_16i_u_avx2(int16_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 64;
+    unsigned int number;
+    int16_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+
+    const __m128i lut = _mm_setr_epi8(1, 3, -3, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask = _mm_set1_epi8(0x03);
+    __m128i packed, s0, s1, s2, s3, s01lo, s01hi, s23lo, s23hi;
+
+    for (number = 0; number < avx_iters; number++)
+        {
+            packed = _mm_loadu_si128((__m128i*)inPtr);
+
+            s0 = _mm_shuffle_epi8(lut, _mm_and_si128(packed, mask));
+            s1 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(packed, 2), mask));
+            s2 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(packed, 4), mask));
+            s3 = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(packed, 6), mask));
+
+            s01lo = _mm_unpacklo_epi8(s0, s1);
+            s01hi = _mm_unpackhi_epi8(s0, s1);
+            s23lo = _mm_unpacklo_epi8(s2, s3);
+            s23hi = _mm_unpackhi_epi8(s2, s3);
+
+            _mm256_storeu_si256((__m256i*)outPtr, _mm256_cvtepi8_epi16(_mm_unpacklo_epi16(s01lo, s23lo)));
+            _mm256_storeu_si256((__m256i*)(outPtr + 16), _mm256_cvtepi8_epi16(_mm_unpackhi_epi16(s01lo, s23lo)));
+            _mm256_storeu_si256((__m256i*)(outPtr + 32), _mm256_cvtepi8_epi16(_mm_unpacklo_epi16(s01hi, s23hi)));
+            _mm256_storeu_si256((__m256i*)(outPtr + 48), _mm256_cvtepi8_epi16(_mm_unpackhi_epi16(s01hi, s23hi)));
+
+            inPtr += 16;
+            outPtr += 64;
+        }
+
+    volk_gnsssdr_8u_unpack2bit_16i_generic(outPtr, inPtr, num_points - avx_iters * 64);
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_NEONV7
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_16i_neonv7(int16_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 32;
+    unsigned int number;
+    int16_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+
+    const int8_t lut_values[8] = {1, 3, -3, -1, 0, 0, 0, 0};
+    const int8x8_t lut = vld1_s8(lut_values);
+    const uint8x8_t mask = vdup_n_u8(0x03);
+    uint8x8_t packed;
+    int8x8_t s0, s1, s2, s3;
+    int16x8x4_t samples;
+
+    for (number = 0; number < neon_iters; number++)
+        {
+            packed = vld1_u8(inPtr);
+
+            s0 = vtbl1_s8(lut, vreinterpret_s8_u8(vand_u8(packed, mask)));
+            s1 = vtbl1_s8(lut, vreinterpret_s8_u8(vand_u8(vshr_n_u8(packed, 2), mask)));
+            s2 = vtbl1_s8(lut, vreinterpret_s8_u8(vand_u8(vshr_n_u8(packed, 4), mask)));
+            s3 = vtbl1_s8(lut, vreinterpret_s8_u8(vshr_n_u8(packed, 6)));
+            samples.val[0] = vmovl_s8(s0);
+            samples.val[1] = vmovl_s8(s1);
+            samples.val[2] = vmovl_s8(s2);
+            samples.val[3] = vmovl_s8(s3);
+
+            // interleaving store puts the four samples of each byte together
+            vst4q_s16(outPtr, samples);
+
+            inPtr += 8;
+            outPtr += 32;
+        }
+
+    volk_gnsssdr_8u_unpack2bit_16i_generic(outPtr, inPtr, num_points - neon_iters * 32);
+}
+#endif /* LV_HAVE_NEONV7 */
+
+#endif /* INCLUDED_volk_gnsssdr_8u_unpack2bit_16i_H */
@@ -0,0 +1,186 @@
+/*!
+ * \file volk_gnsssdr_8u_unpack4bit_8i.h
+ * \brief VOLK_GNSSSDR kernel: unpacks 4-bit samples packed in bytes into 8 bits integers.
+ *
+ * VOLK_GNSSSDR kernel that unpacks two 4-bit two's complement samples per
+ * byte into 8 bits integers, mapping each sample v to 2 * v + 1.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_8u_unpack4bit_8i
+ *
+ * \b Overview
+ *
+ * Unpacks bytes containing two 4-bit two's complement samples each. The
+ * first sample is taken from the least significant nibble of the byte.
+ * Each sample v in [-8, 7] is mapped to 2 * v + 1. The mapping is done with
+ * a lookup table (byte shuffles in the SIMD implementations).
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_8u_unpack4bit_8i(int8_t* outVector, const uint8_t* inVector, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li inVector: Packed bytes. It must contain at least (num_points + 1) / 2 bytes.
+ * \li num_points: Number of samples to unpack.
+ *
+ * \b Outputs
+ * \li outVector: Unpacked samples.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8u_unpack4bit_8i_H
+#define INCLUDED_volk_gnsssdr_8u_unpack4bit_8i_H
+
+#include <stdint.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_8u_unpack4bit_8i_generic(int8_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    static const int8_t lut[16] = {1, 3, 5, 7, 9, 11, 13, 15, -15, -13, -11, -9, -7, -5, -3, -1};
+    const unsigned int num_bytes = num_points / 2;
+    unsigned int number;
+    int8_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+    uint8_t c;
+
+    for (number = 0; number < num_bytes; number++)
+        {
+            c = *inPtr++;
+            *outPtr++ = lut[c & 0x0F];
+            *outPtr++ = lut[c >> 4];
+        }
+
+    if (num_points % 2 != 0)
+        {
+            *outPtr = lut[*inPtr & 0x0F];
+        }
+}
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSSE3
+#include <tmmintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack4bit_8i_u_ssse3(int8_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 32;
+    unsigned int number;
+    int8_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+
+    const __m128i lut = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -15, -13, -11, -9, -7, -5, -3, -1);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i packed, lo, hi;
+
+    for (number = 0; number < sse_iters; number++)
+        {
+            packed = _mm_loadu_si128((__m128i*)inPtr);
+
+            lo = _mm_shuffle_epi8(lut, _mm_and_si128(packed, mask));
+            hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(packed, 4), mask));
+
+            _mm_storeu_si128((__m128i*)outPtr, _mm_unpacklo_epi8(lo, hi));
+            _mm_storeu_si128((__m128i*)(outPtr + 16), _mm_unpackhi_epi8(lo, hi));
+
+            inPtr += 16;
+            outPtr += 32;
+        }
+
+    volk_gnsssdr_8u_unpack4bit_8i_generic(outPtr, inPtr, num_points - sse_iters * 32);
+}
+#endif /* LV_HAVE_SSSE3 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack4bit_8i_u_avx2(int8_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 64;
+    unsigned int number;
+    int8_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+
+    const __m256i lut = _mm256_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -15, -13, -11, -9, -7, -5, -3, -1,
+        1, 3, 5, 7, 9, 11, 13, 15, -15, -13, -11, -9, -7, -5, -3, -1);
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    __m256i packed, lo, hi, q0, q1;
+
+    for (number = 0; number < avx_iters; number++)
+        {
+            packed = _mm256_loadu_si256((__m256i*)inPtr);
+
+            lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(packed, mask));
+            hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(packed, 4), mask));
+
+            // unpacks work within 128-bit lanes: q0 holds the samples of
+            // bytes 0-7 and 16-23, q1 of bytes 8-15 and 24-31
+            q0 = _mm256_unpacklo_epi8(lo, hi);
+            q1 = _mm256_unpackhi_epi8(lo, hi);
+
+            _mm256_storeu_si256((__m256i*)outPtr, _mm256_permute2x128_si256(q0, q1, 0x20));
+            _mm256_storeu_si256((__m256i*)(outPtr + 32), _mm256_permute2x128_si256(q0, q1, 0x31));
+
+            inPtr += 32;
+            outPtr += 64;
+        }
+
+    volk_gnsssdr_8u_unpack4bit_8i_generic(outPtr, inPtr, num_points - avx_iters * 64);
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_NEONV7
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_8u_unpack4bit_8i_neonv7(int8_t* outVector, const uint8_t* inVector, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 16;
+    unsigned int number;
+    int8_t* outPtr = outVector;
+    const uint8_t* inPtr = inVector;
+
+    const int8_t lut_values[16] = {1, 3, 5, 7, 9, 11, 13, 15, -15, -13, -11, -9, -7, -5, -3, -1};
+    int8x8x2_t lut;
+    lut.val[0] = vld1_s8(lut_values);
+    lut.val[1] = vld1_s8(lut_values + 8);
+    const uint8x8_t mask = vdup_n_u8(0x0F);
+    uint8x8_t packed;
+    int8x8x2_t samples;
+
+    for (number = 0; number < neon_iters; number++)
+        {
+            packed = vld1_u8(inPtr);
+
+            samples.val[0] = vtbl2_s8(lut, vreinterpret_s8_u8(vand_u8(packed, mask)));
+            samples.val[1] = vtbl2_s8(lut, vreinterpret_s8_u8(vshr_n_u8(packed, 4)));
+
+            // interleaving store puts the two samples of each byte together
+            vst2_s8(outPtr, samples);
+
+            inPtr += 8;
+            outPtr += 16;
+        }
+
+    volk_gnsssdr_8u_unpack4bit_8i_generic(outPtr, inPtr, num_points - neon_iters * 16);
+}
+#endif /* LV_HAVE_NEONV7 */
+
+#endif /* INCLUDED_volk_gnsssdr_8u_unpack4bit_8i_H */
@@ -24,6 +24,7 @@
 #include "gnss_circular_deque.h"
 #include "gnss_sdr_create_directory.h"
 #include "gnss_synchro.h"
+#include "latency_tracer.h"
 #include <glog/logging.h>
 #include <gnuradio/io_signature.h>
 #include <matio.h>
@@ -737,6 +738,10 @@ int hybrid_observables_gs::general_work(int noutput_items __attribute__((unused)
                 {
                     // LOG(INFO) << "OBS: diff time: " << out[0][0].RX_time * 1000.0 - old_time_debug;
                     // old_time_debug = out[0][0].RX_time * 1000.0;
+                    if (Latency_Tracer::instance().enabled())
+                        {
+                            Latency_Tracer::instance().record(Latency_Tracer::Observables, d_Rx_clock_buffer.front());
+                        }
                     return 1;
                 }
         }
@@ -0,0 +1,130 @@
+/*!
+ * \file polyphase_resampler_conditioner.cc
+ * \brief Implementation of an adapter of a polyphase resampler conditioner
+ * block to a SignalConditionerInterface
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "polyphase_resampler_conditioner.h"
+#include "configuration_interface.h"
+#include <glog/logging.h>
+#include <gnuradio/blocks/file_sink.h>
+#include <volk/volk.h>  // for lv_16sc_t, lv_8sc_t
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+
+PolyphaseResamplerConditioner::PolyphaseResamplerConditioner(
+    ConfigurationInterface* configuration, const std::string& role,
+    unsigned int in_stream, unsigned int out_stream) : role_(role), in_stream_(in_stream), out_stream_(out_stream)
+{
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_file = "./data/signal_conditioner.dat";
+    double fs_in_deprecated;
+    double fs_in;
+    fs_in_deprecated = configuration->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    fs_in = configuration->property("GNSS-SDR.internal_fs_sps", fs_in_deprecated);
+    sample_freq_in_ = configuration->property(role_ + ".sample_freq_in", 4000000.0);
+    sample_freq_out_ = configuration->property(role_ + ".sample_freq_out", fs_in);
+    if (std::fabs(fs_in - sample_freq_out_) > std::numeric_limits<double>::epsilon())
+        {
+            std::string aux_warn = "CONFIGURATION WARNING: Parameters GNSS-SDR.internal_fs_sps and " + role_ + ".sample_freq_out are not set to the same value!";
+            LOG(WARNING) << aux_warn;
+            std::cout << aux_warn << std::endl;
+        }
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    taps_per_phase_ = configuration->property(role + ".taps_per_phase", 16U);
+    dump_ = configuration->property(role + ".dump", false);
+    DLOG(INFO) << "dump_ is " << dump_;
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_file);
+
+    if (item_type_ == "gr_complex")
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_ == "cshort")
+        {
+            item_size_ = sizeof(lv_16sc_t);
+        }
+    else if (item_type_ == "cbyte")
+        {
+            item_size_ = sizeof(lv_8sc_t);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unrecognized item type for resampler. Using gr_complex.";
+            item_type_ = default_item_type;
+            item_size_ = sizeof(gr_complex);
+        }
+
+    resampler_ = make_polyphase_resampler(sample_freq_in_, sample_freq_out_, item_type_, taps_per_phase_);
+    DLOG(INFO) << "sample_freq_in " << sample_freq_in_;
+    DLOG(INFO) << "sample_freq_out " << sample_freq_out_;
+    DLOG(INFO) << "Item size " << item_size_;
+    DLOG(INFO) << "Filter bank of " << resampler_->num_phases() << " phases of " << resampler_->num_taps() << " taps"
+               << (resampler_->exact_ratio() ? " (exact ratio)" : "");
+    DLOG(INFO) << "resampler(" << resampler_->unique_id() << ")";
+
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
+        }
+    if (in_stream_ > 1)
+        {
+            LOG(ERROR) << "This implementation only supports one input stream";
+        }
+    if (out_stream_ > 1)
+        {
+            LOG(ERROR) << "This implementation only supports one output stream";
+        }
+}
+
+
+void PolyphaseResamplerConditioner::connect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->connect(resampler_, 0, file_sink_, 0);
+            DLOG(INFO) << "connected resampler to file sink";
+        }
+    else
+        {
+            DLOG(INFO) << "nothing to connect internally";
+        }
+}
+
+
+void PolyphaseResamplerConditioner::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->disconnect(resampler_, 0, file_sink_, 0);
+        }
+}
+
+
+gr::basic_block_sptr PolyphaseResamplerConditioner::get_left_block()
+{
+    return resampler_;
+}
+
+
+gr::basic_block_sptr PolyphaseResamplerConditioner::get_right_block()
+{
+    return resampler_;
+}
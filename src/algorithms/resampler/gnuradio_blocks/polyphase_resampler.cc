@@ -0,0 +1,260 @@
+/*!
+ * \file polyphase_resampler.cc
+ * \brief Polyphase FIR resampler with gr_complex, cshort or cbyte
+ * input and output
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "polyphase_resampler.h"
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>  // for lv_16sc_t, lv_8sc_t, volk_32fc_32f_dot_prod_32fc
+#include <algorithm>    // for max, min
+#include <cmath>        // for ceil, floor, round, fabs, cos, sin
+#include <cstdint>      // for int8_t, int16_t, uint64_t
+#include <string>       // for string
+#include <vector>       // for vector
+
+
+polyphase_resampler_sptr make_polyphase_resampler(
+    double sample_freq_in,
+    double sample_freq_out,
+    const std::string &item_type,
+    uint32_t taps_per_phase)
+{
+    return polyphase_resampler_sptr(
+        new polyphase_resampler(sample_freq_in,
+            sample_freq_out,
+            item_type,
+            taps_per_phase));
+}
+
+
+polyphase_resampler::polyphase_resampler(
+    double sample_freq_in,
+    double sample_freq_out,
+    const std::string &item_type,
+    uint32_t taps_per_phase) : gr::block("polyphase_resampler",
+                                   gr::io_signature::make(1, 1, item_size(item_type_from_name(item_type))),
+                                   gr::io_signature::make(1, 1, item_size(item_type_from_name(item_type)))),
+                               d_sample_freq_in(sample_freq_in),
+                               d_sample_freq_out(sample_freq_out),
+                               d_item_type(item_type_from_name(item_type)),
+                               d_exact_ratio(false),
+                               d_frac_units(1ULL << 32),
+                               d_frac(0),
+                               d_step_int(0),
+                               d_step_frac(0),
+                               d_skip(0),
+                               d_num_phases(POLYPHASE_RESAMPLER_PHASES),
+                               d_num_taps(0)
+{
+    const double ratio = sample_freq_in / sample_freq_out;  // input samples per output sample
+
+    // Look for ratio = M / L with a small L, so that a bank of L filters
+    // covers all the output phases exactly
+    for (uint32_t L = 1; L <= POLYPHASE_RESAMPLER_PHASES; L++)
+        {
+            const double M = std::round(ratio * L);
+            if (M >= 1.0 and std::fabs(ratio * L - M) < 1e-9 * M)
+                {
+                    d_exact_ratio = true;
+                    d_num_phases = L;
+                    d_frac_units = L;
+                    d_step_int = static_cast<uint64_t>(M) / L;
+                    d_step_frac = static_cast<uint64_t>(M) % L;
+                    break;
+                }
+        }
+    if (!d_exact_ratio)
+        {
+            d_step_int = static_cast<uint64_t>(std::floor(ratio));
+            d_step_frac = static_cast<uint64_t>(std::round((ratio - std::floor(ratio)) * static_cast<double>(d_frac_units)));
+            if (d_step_frac >= d_frac_units)
+                {
+                    d_step_frac -= d_frac_units;
+                    d_step_int++;
+                }
+        }
+
+    // When decimating, the filter must be longer to keep the same number of
+    // side lobes at the lower cut-off frequency
+    const uint32_t taps = static_cast<uint32_t>(std::ceil(taps_per_phase * std::max(1.0, ratio)));
+    d_num_taps = std::max(4U, (taps + 3U) & ~3U);  // multiple of 4 for the SIMD dot products
+
+    // Low pass cut-off, normalized to the input sampling frequency, below
+    // the Nyquist frequency of the lowest of both rates
+    design_filter_bank(0.45 * std::min(1.0, 1.0 / ratio));
+
+    set_relative_rate(sample_freq_out / sample_freq_in);
+    set_output_multiple(1);
+}
+
+
+polyphase_resampler::Item_Type polyphase_resampler::item_type_from_name(const std::string &item_type)
+{
+    if (item_type == "cshort")
+        {
+            return Item_Type::Cshort;
+        }
+    if (item_type == "cbyte")
+        {
+            return Item_Type::Cbyte;
+        }
+    return Item_Type::Gr_Complex;
+}
+
+
+size_t polyphase_resampler::item_size(Item_Type item_type)
+{
+    switch (item_type)
+        {
+        case Item_Type::Cshort:
+            return sizeof(lv_16sc_t);
+        case Item_Type::Cbyte:
+            return sizeof(lv_8sc_t);
+        default:
+            return sizeof(gr_complex);
+        }
+}
+
+
+void polyphase_resampler::design_filter_bank(double cutoff)
+{
+    const double pi = 3.14159265358979323846;
+    const double half_length = static_cast<double>(d_num_taps) / 2.0;
+    const double delay = half_length - 1.0;
+    d_bank.assign(static_cast<size_t>(d_num_phases) * d_num_taps, 0.0F);
+    for (uint32_t p = 0; p < d_num_phases; p++)
+        {
+            // filter p interpolates at a fractional delay p / d_num_phases
+            // after the first sample of its input window
+            const double mu = static_cast<double>(p) / static_cast<double>(d_num_phases);
+            double sum = 0.0;
+            std::vector<double> h(d_num_taps);
+            for (uint32_t k = 0; k < d_num_taps; k++)
+                {
+                    const double t = mu + delay - static_cast<double>(k);
+                    const double x = 2.0 * cutoff * t;
+                    const double sinc = (std::fabs(x) < 1e-12) ? 1.0 : std::sin(pi * x) / (pi * x);
+                    // Blackman window centered at t = 0
+                    const double window = 0.42 + 0.5 * std::cos(pi * t / half_length) + 0.08 * std::cos(2.0 * pi * t / half_length);
+                    h[k] = (std::fabs(t) < half_length) ? 2.0 * cutoff * sinc * window : 0.0;
+                    sum += h[k];
+                }
+            for (uint32_t k = 0; k < d_num_taps; k++)
+                {
+                    // unit gain at DC for every phase
+                    d_bank[static_cast<size_t>(p) * d_num_taps + k] = static_cast<float>(h[k] / sum);
+                }
+        }
+}
+
+
+void polyphase_resampler::forecast(int noutput_items,
+    gr_vector_int &ninput_items_required)
+{
+    const double ratio = d_sample_freq_in / d_sample_freq_out;
+    const int nreqd = static_cast<int>(std::ceil(static_cast<double>(noutput_items) * ratio)) + static_cast<int>(d_num_taps + d_skip);
+    for (int &n : ninput_items_required)
+        {
+            n = nreqd;
+        }
+}
+
+
+int polyphase_resampler::resample(const gr_complex *in, int ninput_items,
+    gr_complex *out, int noutput_items, int &consumed)
+{
+    const auto n_in = static_cast<uint64_t>(ninput_items);
+    uint64_t base = d_skip;
+    int produced = 0;
+    while (produced < noutput_items)
+        {
+            uint64_t start = base;
+            uint64_t phase;
+            if (d_exact_ratio)
+                {
+                    phase = d_frac;
+                }
+            else
+                {
+                    // closest filter of the bank
+                    phase = (d_frac * d_num_phases + (d_frac_units >> 1)) / d_frac_units;
+                    if (phase == d_num_phases)
+                        {
+                            phase = 0;
+                            start++;
+                        }
+                }
+            if (start + d_num_taps > n_in)
+                {
+                    break;
+                }
+            volk_32fc_32f_dot_prod_32fc(&out[produced], in + start, &d_bank[phase * d_num_taps], d_num_taps);
+            produced++;
+
+            base += d_step_int;
+            d_frac += d_step_frac;
+            if (d_frac >= d_frac_units)
+                {
+                    d_frac -= d_frac_units;
+                    base++;
+                }
+        }
+    // the step between output samples can be longer than the available input
+    const uint64_t used = std::min(base, n_in);
+    d_skip = base - used;
+    consumed = static_cast<int>(used);
+    return produced;
+}
+
+
+int polyphase_resampler::general_work(int noutput_items,
+    gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items)
+{
+    int consumed = 0;
+    int produced = 0;
+    if (d_item_type != Item_Type::Gr_Complex)
+        {
+            // work in floating point
+            const double ratio = d_sample_freq_in / d_sample_freq_out;
+            const int ninput = std::min(ninput_items[0], static_cast<int>(std::ceil(static_cast<double>(noutput_items) * ratio)) + static_cast<int>(d_num_taps + d_skip));
+            d_in_buffer.resize(ninput);
+            d_out_buffer.resize(noutput_items);
+            auto *in_floats = reinterpret_cast<float *>(d_in_buffer.data());
+            const auto *out_floats = reinterpret_cast<const float *>(d_out_buffer.data());
+            if (d_item_type == Item_Type::Cshort)
+                {
+                    volk_16i_s32f_convert_32f(in_floats, reinterpret_cast<const int16_t *>(input_items[0]), 1.0, 2 * ninput);
+                    produced = resample(d_in_buffer.data(), ninput, d_out_buffer.data(), noutput_items, consumed);
+                    volk_32f_s32f_convert_16i(reinterpret_cast<int16_t *>(output_items[0]), out_floats, 1.0, 2 * produced);
+                }
+            else
+                {
+                    volk_8i_s32f_convert_32f(in_floats, reinterpret_cast<const int8_t *>(input_items[0]), 1.0, 2 * ninput);
+                    produced = resample(d_in_buffer.data(), ninput, d_out_buffer.data(), noutput_items, consumed);
+                    volk_32f_s32f_convert_8i(reinterpret_cast<int8_t *>(output_items[0]), out_floats, 1.0, 2 * produced);
+                }
+        }
+    else
+        {
+            produced = resample(reinterpret_cast<const gr_complex *>(input_items[0]), ninput_items[0],
+                reinterpret_cast<gr_complex *>(output_items[0]), noutput_items, consumed);
+        }
+
+    consume_each(consumed);
+    return produced;
+}
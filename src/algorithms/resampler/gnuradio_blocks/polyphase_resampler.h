@@ -0,0 +1,139 @@
+/*!
+ * \file polyphase_resampler.h
+ * \brief Polyphase FIR resampler with gr_complex, cshort or cbyte
+ * input and output
+ *
+ * This block resamples the input signal with a bank of FIR filters, one per
+ * fractional delay, that also act as the anti-aliasing low pass filter.
+ * If the resampling ratio is a fraction with a small denominator (for
+ * instance, 30.72 Msps to 4 Msps is 192/25), the bank has one filter per
+ * output phase and the resampling is exact. Otherwise, the closest of
+ * POLYPHASE_RESAMPLER_PHASES fractional delays is used for each output
+ * sample.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_POLYPHASE_RESAMPLER_H
+#define GNSS_SDR_POLYPHASE_RESAMPLER_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class polyphase_resampler;
+
+#if GNURADIO_USES_STD_POINTERS
+using polyphase_resampler_sptr = std::shared_ptr<polyphase_resampler>;
+#else
+using polyphase_resampler_sptr = boost::shared_ptr<polyphase_resampler>;
+#endif
+
+/*!
+ * \brief Number of fractional delays of the filter bank when the resampling
+ * ratio is not a fraction with a small denominator
+ */
+constexpr uint32_t POLYPHASE_RESAMPLER_PHASES = 256;
+
+/*!
+ * \brief Makes a polyphase resampler.
+ * \param sample_freq_in Input sampling frequency [Sps]
+ * \param sample_freq_out Output sampling frequency [Sps]
+ * \param item_type "gr_complex", "cshort" or "cbyte"
+ * \param taps_per_phase Filter length at the input rate when not
+ * decimating. When decimating, it is scaled by the decimation factor.
+ */
+polyphase_resampler_sptr make_polyphase_resampler(
+    double sample_freq_in,
+    double sample_freq_out,
+    const std::string &item_type,
+    uint32_t taps_per_phase = 16);
+
+/*!
+ * \brief This class implements a polyphase FIR resampler
+ */
+class polyphase_resampler : public gr::block
+{
+public:
+    ~polyphase_resampler() = default;
+
+    inline uint32_t num_phases() const { return d_num_phases; }  //!< Number of filters in the bank
+    inline uint32_t num_taps() const { return d_num_taps; }      //!< Length of each filter
+    inline bool exact_ratio() const { return d_exact_ratio; }    //!< True if the ratio is resampled without phase approximation
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend polyphase_resampler_sptr make_polyphase_resampler(
+        double sample_freq_in,
+        double sample_freq_out,
+        const std::string &item_type,
+        uint32_t taps_per_phase);
+
+    polyphase_resampler(
+        double sample_freq_in,
+        double sample_freq_out,
+        const std::string &item_type,
+        uint32_t taps_per_phase);
+
+    // item type, resolved once from its name
+    enum class Item_Type
+    {
+        Gr_Complex,
+        Cshort,
+        Cbyte
+    };
+
+    static Item_Type item_type_from_name(const std::string &item_type);
+    static size_t item_size(Item_Type item_type);
+
+    void design_filter_bank(double cutoff);
+    int resample(const gr_complex *in, int ninput_items, gr_complex *out, int noutput_items, int &consumed);
+
+    double d_sample_freq_in;   // Sampling frequency of the input signal
+    double d_sample_freq_out;  // Sampling frequency of the output signal
+    Item_Type d_item_type;
+
+    // The position of the next output sample, in input samples, is
+    // integer part + d_frac / d_frac_units. Each output sample advances it
+    // by d_step_int + d_step_frac / d_frac_units.
+    bool d_exact_ratio;
+    uint64_t d_frac_units;
+    uint64_t d_frac;
+    uint64_t d_step_int;
+    uint64_t d_step_frac;
+    uint64_t d_skip;  // input samples to skip before the next output sample
+
+    uint32_t d_num_phases;
+    uint32_t d_num_taps;
+    std::vector<float> d_bank;  // d_num_phases filters of d_num_taps taps
+
+    // conversion buffers for cshort and cbyte items
+    std::vector<gr_complex> d_in_buffer;
+    std::vector<gr_complex> d_out_buffer;
+};
+
+#endif  // GNSS_SDR_POLYPHASE_RESAMPLER_H
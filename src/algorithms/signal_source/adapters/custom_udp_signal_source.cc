@@ -46,6 +46,11 @@ CustomUDPSignalSource::CustomUDPSignalSource(ConfigurationInterface* configurati
     std::string capture_device = configuration->property(role + ".capture_device", default_capture_device);
     int port = configuration->property(role + ".port", default_port);
     int payload_bytes = configuration->property(role + ".payload_bytes", 1024);
+    std::string default_capture_backend = "pcap";
+    std::string capture_backend = configuration->property(role + ".capture_backend", default_capture_backend);
+    int sequence_number_bytes = configuration->property(role + ".sequence_number_bytes", 0);
+    int ring_buffer_bytes = configuration->property(role + ".ring_buffer_bytes", 16777216);
+    int socket_buffer_bytes = configuration->property(role + ".socket_buffer_bytes", 67108864);
 
     RF_channels_ = configuration->property(role + ".RF_channels", 1);
     channels_in_udp_ = configuration->property(role + ".channels_in_udp", 1);
@@ -64,7 +69,11 @@ CustomUDPSignalSource::CustomUDPSignalSource(ConfigurationInterface* configurati
         channels_in_udp_,
         sample_type,
         item_size_,
-        IQ_swap_);
+        IQ_swap_,
+        capture_backend,
+        sequence_number_bytes,
+        ring_buffer_bytes,
+        socket_buffer_bytes);
 
     if (channels_in_udp_ >= RF_channels_)
         {
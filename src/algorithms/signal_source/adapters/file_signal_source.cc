@@ -23,6 +23,7 @@
 #include "configuration_interface.h"
 #include "gnss_sdr_flags.h"
 #include "gnss_sdr_valve.h"
+#include "mmap_file_source.h"
 #include <glog/logging.h>
 #include <exception>
 #include <fstream>
@@ -41,7 +42,7 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
 
     double default_seconds_to_skip = 0.0;
     size_t header_size = 0;
-    samples_ = configuration->property(role + ".samples", 0);
+    samples_ = configuration->property(role + ".samples", static_cast<uint64_t>(0));
     sampling_frequency_ = configuration->property(role + ".sampling_frequency", 0);
     filename_ = configuration->property(role + ".filename", default_filename);
 
@@ -57,6 +58,7 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
 
     item_type_ = configuration->property(role + ".item_type", default_item_type);
     repeat_ = configuration->property(role + ".repeat", false);
+    enable_mmap_ = configuration->property(role + ".enable_mmap", false);
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
     enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
@@ -101,8 +103,6 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
         }
     try
         {
-            file_source_ = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
-
             if (seconds_to_skip > 0)
                 {
                     samples_to_skip = static_cast<int64_t>(seconds_to_skip * sampling_frequency_);
@@ -117,10 +117,31 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
                     samples_to_skip += header_size;
                 }
 
+            bool seek_ok = true;
+            if (enable_mmap_)
+                {
+                    // map the file in memory instead of reading it with buffered fread() calls
+                    mmap_file_source_sptr mmap_source = mmap_make_file_source(item_size_, filename_.c_str(), repeat_);
+                    if (samples_to_skip > 0)
+                        {
+                            seek_ok = mmap_source->seek(samples_to_skip, SEEK_SET);
+                        }
+                    file_source_ = mmap_source;
+                }
+            else
+                {
+                    gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(item_size_, filename_.c_str(), repeat_);
+                    if (samples_to_skip > 0)
+                        {
+                            seek_ok = file_source->seek(samples_to_skip, SEEK_SET);
+                        }
+                    file_source_ = file_source;
+                }
+
             if (samples_to_skip > 0)
                 {
                     LOG(INFO) << "Skipping " << samples_to_skip << " samples of the input file";
-                    if (not file_source_->seek(samples_to_skip, SEEK_SET))
+                    if (not seek_ok)
                         {
                             LOG(INFO) << "Error skipping bytes!";
                         }
@@ -231,6 +252,7 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
     DLOG(INFO) << "Item type " << item_type_;
     DLOG(INFO) << "Item size " << item_size_;
     DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Memory-mapped file " << enable_mmap_;
     DLOG(INFO) << "Dump " << dump_;
     DLOG(INFO) << "Dump filename " << dump_filename_;
     if (in_streams_ > 0)
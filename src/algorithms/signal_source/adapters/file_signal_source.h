@@ -92,6 +92,11 @@ public:
         return repeat_;
     }
 
+    inline bool mmap_enabled() const
+    {
+        return enable_mmap_;
+    }
+
     inline int64_t sampling_frequency() const
     {
         return sampling_frequency_;
@@ -108,15 +113,17 @@ private:
     std::string filename_;
     std::string item_type_;
     bool repeat_;
+    bool enable_mmap_;
     bool dump_;
     std::string dump_filename_;
     std::string role_;
     uint32_t in_streams_;
     uint32_t out_streams_;
-    gr::blocks::file_source::sptr file_source_;
 #if GNURADIO_USES_STD_POINTERS
+    std::shared_ptr<gr::block> file_source_;  // gr::blocks::file_source or mmap_file_source
     std::shared_ptr<gr::block> valve_;
 #else
+    boost::shared_ptr<gr::block> file_source_;  // gr::blocks::file_source or mmap_file_source
     boost::shared_ptr<gr::block> valve_;
 #endif
     gr::blocks::file_sink::sptr sink_;
@@ -0,0 +1,180 @@
+/*!
+ * \file iq_archive_signal_source.cc
+ * \brief Signal source that replays the samples recorded in an IQ archive
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "iq_archive_signal_source.h"
+#include "configuration_interface.h"
+#include "gnss_sdr_valve.h"
+#include <glog/logging.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <thread>
+
+
+IqArchiveSignalSource::IqArchiveSignalSource(ConfigurationInterface* configuration,
+    const std::string& role, unsigned int in_streams, unsigned int out_streams,
+    const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue) : role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    const std::string default_filename = "./example_capture.iqa";
+    const std::string default_item_type = "gr_complex";
+
+    filename_ = configuration->property(role + ".filename", default_filename);
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    repeat_ = configuration->property(role + ".repeat", false);
+    enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    const double seconds_to_skip = configuration->property(role + ".seconds_to_skip", 0.0);
+    const unsigned int default_threads = std::max(std::min(std::thread::hardware_concurrency(), 4U), 1U);
+    const unsigned int decoding_threads = configuration->property(role + ".decoding_threads", default_threads);
+
+    if (item_type_ == "gr_complex")
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_ == "cshort")
+        {
+            item_size_ = sizeof(lv_16sc_t);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unrecognized item type. Using gr_complex.";
+            item_type_ = default_item_type;
+            item_size_ = sizeof(gr_complex);
+        }
+
+    try
+        {
+            archive_source_ = iq_archive_make_source(filename_, item_size_, repeat_, decoding_threads);
+        }
+    catch (const std::exception& e)
+        {
+            std::cerr
+                << "The receiver was configured to work with an IQ archive signal source "
+                << std::endl
+                << "but the specified file is unreachable or is not an IQ archive."
+                << std::endl
+                << "Please modify your configuration file"
+                << std::endl
+                << "and point " << role << ".filename to a valid IQ archive."
+                << std::endl;
+            LOG(INFO) << "iq_archive_signal_source: Unable to open " << filename_ << ", exiting the program.";
+            throw;
+        }
+
+    n_channels_ = archive_source_->format().channels;
+    sampling_frequency_ = configuration->property(role + ".sampling_frequency", archive_source_->format().sampling_frequency);
+
+    // The index gives the exact length of the file, and any position can be
+    // reached without reading what comes before it.
+    uint64_t samples_to_skip = 0;
+    if (seconds_to_skip > 0)
+        {
+            samples_to_skip = static_cast<uint64_t>(seconds_to_skip * sampling_frequency_);
+            LOG(INFO) << "Skipping " << samples_to_skip << " samples of the IQ archive";
+            if (not archive_source_->seek(samples_to_skip))
+                {
+                    LOG(WARNING) << "The IQ archive " << filename_ << " has only " << archive_source_->samples() << " samples";
+                }
+        }
+    samples_ = configuration->property(role + ".samples", static_cast<uint64_t>(0));
+    if (samples_ == 0 and archive_source_->samples() > samples_to_skip)
+        {
+            samples_ = archive_source_->samples() - samples_to_skip;
+        }
+
+    CHECK(samples_ > 0) << "File does not contain enough samples to process.";
+    const double signal_duration_s = static_cast<double>(samples_) / sampling_frequency_;
+    DLOG(INFO) << "Total number samples to be processed= " << samples_ << " GNSS signal duration= " << signal_duration_s << " [s]";
+    std::cout << "GNSS signal recorded time to be processed: " << signal_duration_s << " [s]" << std::endl;
+
+    valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+    DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+
+    if (enable_throttle_control_)
+        {
+            for (unsigned int n = 0; n < n_channels_; n++)
+                {
+                    throttle_vec_.push_back(gr::blocks::throttle::make(item_size_, sampling_frequency_));
+                }
+        }
+
+    DLOG(INFO) << "IQ archive filename " << filename_;
+    DLOG(INFO) << "Channels " << n_channels_;
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "Sampling frequency " << sampling_frequency_;
+    DLOG(INFO) << "Item type " << item_type_;
+    DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Decoding threads " << decoding_threads;
+    if (in_streams_ > 0)
+        {
+            LOG(ERROR) << "A signal source does not have an input stream";
+        }
+    if (out_streams_ > 1)
+        {
+            LOG(ERROR) << "This implementation only supports one output stream";
+        }
+}
+
+
+void IqArchiveSignalSource::connect(gr::top_block_sptr top_block)
+{
+    for (unsigned int n = 0; n < n_channels_; n++)
+        {
+            if (enable_throttle_control_ == true)
+                {
+                    top_block->connect(archive_source_, n, throttle_vec_.at(n), 0);
+                    top_block->connect(throttle_vec_.at(n), 0, valve_, n);
+                    DLOG(INFO) << "connected IQ archive channel #" << n << " to throttle and valve";
+                }
+            else
+                {
+                    top_block->connect(archive_source_, n, valve_, n);
+                    DLOG(INFO) << "connected IQ archive channel #" << n << " to valve";
+                }
+        }
+}
+
+
+void IqArchiveSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    for (unsigned int n = 0; n < n_channels_; n++)
+        {
+            if (enable_throttle_control_ == true)
+                {
+                    top_block->disconnect(archive_source_, n, throttle_vec_.at(n), 0);
+                    top_block->disconnect(throttle_vec_.at(n), 0, valve_, n);
+                }
+            else
+                {
+                    top_block->disconnect(archive_source_, n, valve_, n);
+                }
+        }
+}
+
+
+gr::basic_block_sptr IqArchiveSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return iq_archive_source_sptr();
+}
+
+
+gr::basic_block_sptr IqArchiveSignalSource::get_right_block()
+{
+    return valve_;
+}
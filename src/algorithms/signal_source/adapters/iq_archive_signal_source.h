@@ -0,0 +1,128 @@
+/*!
+ * \file iq_archive_signal_source.h
+ * \brief Signal source that replays the samples recorded in an IQ archive
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_IQ_ARCHIVE_SIGNAL_SOURCE_H
+#define GNSS_SDR_IQ_ARCHIVE_SIGNAL_SOURCE_H
+
+#include "concurrent_queue.h"
+#include "gnss_block_interface.h"
+#include "iq_archive_source.h"
+#include <gnuradio/blocks/throttle.h>
+#include <pmt/pmt.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Class that reads the samples of an IQ archive (see iq_archive.h),
+ * such as those recorded by UHD_Signal_Source with dump_format=iqa, and
+ * adapts it to a SignalSourceInterface. Archives with several channels have
+ * one output per channel.
+ */
+class IqArchiveSignalSource : public GNSSBlockInterface
+{
+public:
+    IqArchiveSignalSource(ConfigurationInterface* configuration, const std::string& role,
+        unsigned int in_streams, unsigned int out_streams,
+        const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue);
+
+    ~IqArchiveSignalSource() = default;
+
+    inline std::string role() override
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Iq_Archive_Signal_Source".
+     */
+    inline std::string implementation() override
+    {
+        return "Iq_Archive_Signal_Source";
+    }
+
+    inline size_t item_size() override
+    {
+        return item_size_;
+    }
+
+    void connect(gr::top_block_sptr top_block) override;
+    void disconnect(gr::top_block_sptr top_block) override;
+    gr::basic_block_sptr get_left_block() override;
+    gr::basic_block_sptr get_right_block() override;
+
+    inline std::string filename() const
+    {
+        return filename_;
+    }
+
+    inline std::string item_type() const
+    {
+        return item_type_;
+    }
+
+    inline bool repeat() const
+    {
+        return repeat_;
+    }
+
+    inline double sampling_frequency() const
+    {
+        return sampling_frequency_;
+    }
+
+    inline uint64_t samples() const
+    {
+        return samples_;
+    }
+
+    inline uint32_t channels() const
+    {
+        return n_channels_;
+    }
+
+private:
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    std::string filename_;
+    std::string item_type_;
+    size_t item_size_;
+    bool repeat_;
+    double sampling_frequency_;
+    uint64_t samples_;
+    uint32_t n_channels_;
+    bool enable_throttle_control_;
+    iq_archive_source_sptr archive_source_;
+#if GNURADIO_USES_STD_POINTERS
+    std::shared_ptr<gr::block> valve_;
+#else
+    boost::shared_ptr<gr::block> valve_;
+#endif
+    std::vector<gr::blocks::throttle::sptr> throttle_vec_;
+    std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue_;
+};
+
+#endif  // GNSS_SDR_IQ_ARCHIVE_SIGNAL_SOURCE_H
@@ -22,6 +22,7 @@
 #include "configuration_interface.h"
 #include "gnss_sdr_flags.h"
 #include "gnss_sdr_valve.h"
+#include "mmap_file_source.h"
 #include <glog/logging.h>
 #include <exception>
 #include <fstream>
@@ -51,6 +52,7 @@ MultichannelFileSignalSource::MultichannelFileSignalSource(ConfigurationInterfac
 
     item_type_ = configuration->property(role + ".item_type", default_item_type);
     repeat_ = configuration->property(role + ".repeat", false);
+    enable_mmap_ = configuration->property(role + ".enable_mmap", false);
     enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
 
     double seconds_to_skip = configuration->property(role + ".seconds_to_skip", default_seconds_to_skip);
@@ -95,8 +97,6 @@ MultichannelFileSignalSource::MultichannelFileSignalSource(ConfigurationInterfac
         {
             for (unsigned int n = 0; n < n_channels_; n++)
                 {
-                    file_source_vec_.push_back(gr::blocks::file_source::make(item_size_, filename_vec_.at(n).c_str(), repeat_));
-
                     if (seconds_to_skip > 0)
                         {
                             samples_to_skip = static_cast<int64_t>(seconds_to_skip * sampling_frequency_);
@@ -111,10 +111,30 @@ MultichannelFileSignalSource::MultichannelFileSignalSource(ConfigurationInterfac
                             samples_to_skip += header_size;
                         }
 
+                    bool seek_ok = true;
+                    if (enable_mmap_)
+                        {
+                            mmap_file_source_sptr mmap_source = mmap_make_file_source(item_size_, filename_vec_.at(n).c_str(), repeat_);
+                            if (samples_to_skip > 0)
+                                {
+                                    seek_ok = mmap_source->seek(samples_to_skip, SEEK_SET);
+                                }
+                            file_source_vec_.push_back(mmap_source);
+                        }
+                    else
+                        {
+                            gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(item_size_, filename_vec_.at(n).c_str(), repeat_);
+                            if (samples_to_skip > 0)
+                                {
+                                    seek_ok = file_source->seek(samples_to_skip, SEEK_SET);
+                                }
+                            file_source_vec_.push_back(file_source);
+                        }
+
                     if (samples_to_skip > 0)
                         {
                             LOG(INFO) << "Skipping " << samples_to_skip << " samples of the input file #" << n;
-                            if (not file_source_vec_.back()->seek(samples_to_skip, SEEK_SET))
+                            if (not seek_ok)
                                 {
                                     LOG(INFO) << "Error skipping bytes!";
                                 }
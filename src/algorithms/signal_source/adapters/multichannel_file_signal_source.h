@@ -110,13 +110,15 @@ private:
     std::vector<std::string> filename_vec_;
     std::string item_type_;
     bool repeat_;
+    bool enable_mmap_;
     std::string role_;
     uint32_t in_streams_;
     uint32_t out_streams_;
-    std::vector<gr::blocks::file_source::sptr> file_source_vec_;
 #if GNURADIO_USES_STD_POINTERS
+    std::vector<std::shared_ptr<gr::block>> file_source_vec_;  // gr::blocks::file_source or mmap_file_source
     std::shared_ptr<gr::block> valve_;
 #else
+    std::vector<boost::shared_ptr<gr::block>> file_source_vec_;  // gr::blocks::file_source or mmap_file_source
     boost::shared_ptr<gr::block> valve_;
 #endif
     gr::blocks::file_sink::sptr sink_;
@@ -0,0 +1,144 @@
+/*!
+ * \file shm_bus_signal_source.cc
+ * \brief Signal source that reads the samples published on a shared memory
+ * sample bus by another GNSS-SDR process
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "shm_bus_signal_source.h"
+#include "configuration_interface.h"
+#include "gnss_sdr_valve.h"
+#include <glog/logging.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <cmath>
+#include <exception>
+#include <iostream>
+
+
+ShmBusSignalSource::ShmBusSignalSource(ConfigurationInterface* configuration,
+    const std::string& role, unsigned int in_streams, unsigned int out_streams,
+    const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue) : role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    const std::string default_bus_name = "/gnss-sdr-bus";
+    const std::string default_item_type = "gr_complex";
+
+    bus_name_ = configuration->property(role + ".bus_name", default_bus_name);
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    const bool fill_gaps = configuration->property(role + ".fill_gaps", true);
+    const double attach_timeout_s = configuration->property(role + ".attach_timeout_s", 10.0);
+    samples_ = configuration->property(role + ".samples", static_cast<uint64_t>(0));
+
+    if (item_type_ == "gr_complex")
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_ == "cshort")
+        {
+            item_size_ = sizeof(lv_16sc_t);
+        }
+    else if (item_type_ == "cbyte")
+        {
+            item_size_ = sizeof(lv_8sc_t);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unrecognized item type. Using gr_complex.";
+            item_type_ = default_item_type;
+            item_size_ = sizeof(gr_complex);
+        }
+
+    try
+        {
+            bus_source_ = shm_bus_make_source(bus_name_, item_size_, fill_gaps, attach_timeout_s);
+        }
+    catch (const std::exception& e)
+        {
+            std::cerr
+                << "The receiver was configured to read the samples of another receiver,"
+                << std::endl
+                << "but " << e.what() << "." << std::endl
+                << "Please start the receiver that owns the front-end with "
+                << "SignalSource.shm_bus_name=" << bus_name_ << std::endl
+                << "and check that " << role << ".item_type matches its output." << std::endl;
+            LOG(INFO) << "shm_bus_signal_source: " << e.what() << ", exiting the program.";
+            throw;
+        }
+
+    const double sampling_frequency = configuration->property(role + ".sampling_frequency", bus_source_->sampling_frequency());
+    if (std::abs(sampling_frequency - bus_source_->sampling_frequency()) > 0.5)
+        {
+            LOG(WARNING) << role << ".sampling_frequency=" << sampling_frequency << " but the sample bus "
+                         << bus_name_ << " carries " << bus_source_->sampling_frequency() << " samples per second";
+        }
+
+    if (samples_ != 0)
+        {
+            DLOG(INFO) << "Send STOP signal after " << samples_ << " samples";
+            valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+            DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+        }
+
+    DLOG(INFO) << "Sample bus " << bus_name_;
+    DLOG(INFO) << "Item type " << item_type_;
+    DLOG(INFO) << "Fill gaps " << fill_gaps;
+    if (in_streams_ > 0)
+        {
+            LOG(ERROR) << "A signal source does not have an input stream";
+        }
+    if (out_streams_ > 1)
+        {
+            LOG(ERROR) << "This implementation only supports one output stream";
+        }
+}
+
+
+void ShmBusSignalSource::connect(gr::top_block_sptr top_block)
+{
+    if (samples_ != 0)
+        {
+            top_block->connect(bus_source_, 0, valve_, 0);
+            DLOG(INFO) << "connected sample bus source to valve";
+        }
+    else
+        {
+            DLOG(INFO) << "sample bus source is the right block";
+        }
+}
+
+
+void ShmBusSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    if (samples_ != 0)
+        {
+            top_block->disconnect(bus_source_, 0, valve_, 0);
+        }
+}
+
+
+gr::basic_block_sptr ShmBusSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return shm_bus_source_sptr();
+}
+
+
+gr::basic_block_sptr ShmBusSignalSource::get_right_block()
+{
+    if (samples_ != 0)
+        {
+            return valve_;
+        }
+    return bus_source_;
+}
@@ -0,0 +1,106 @@
+/*!
+ * \file shm_bus_signal_source.h
+ * \brief Signal source that reads the samples published on a shared memory
+ * sample bus by another GNSS-SDR process
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SHM_BUS_SIGNAL_SOURCE_H
+#define GNSS_SDR_SHM_BUS_SIGNAL_SOURCE_H
+
+#include "concurrent_queue.h"
+#include "gnss_block_interface.h"
+#include "shm_bus_source.h"
+#include <pmt/pmt.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#if GNURADIO_USES_STD_POINTERS
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Class that reads the samples a receiver publishes with
+ * SignalSource.shm_bus_name (see shm_sample_bus.h), and adapts it to a
+ * SignalSourceInterface. Several receivers can share one front-end this way.
+ */
+class ShmBusSignalSource : public GNSSBlockInterface
+{
+public:
+    ShmBusSignalSource(ConfigurationInterface* configuration, const std::string& role,
+        unsigned int in_streams, unsigned int out_streams,
+        const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue);
+
+    ~ShmBusSignalSource() = default;
+
+    inline std::string role() override
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Shm_Bus_Signal_Source".
+     */
+    inline std::string implementation() override
+    {
+        return "Shm_Bus_Signal_Source";
+    }
+
+    inline size_t item_size() override
+    {
+        return item_size_;
+    }
+
+    void connect(gr::top_block_sptr top_block) override;
+    void disconnect(gr::top_block_sptr top_block) override;
+    gr::basic_block_sptr get_left_block() override;
+    gr::basic_block_sptr get_right_block() override;
+
+    inline std::string bus_name() const
+    {
+        return bus_name_;
+    }
+
+    inline std::string item_type() const
+    {
+        return item_type_;
+    }
+
+    inline uint64_t samples() const
+    {
+        return samples_;
+    }
+
+private:
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    std::string bus_name_;
+    std::string item_type_;
+    size_t item_size_;
+    uint64_t samples_;
+    shm_bus_source_sptr bus_source_;
+#if GNURADIO_USES_STD_POINTERS
+    std::shared_ptr<gr::block> valve_;
+#else
+    boost::shared_ptr<gr::block> valve_;
+#endif
+    std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue_;
+};
+
+#endif  // GNSS_SDR_SHM_BUS_SIGNAL_SOURCE_H
@@ -21,10 +21,12 @@
 #include "GPS_L1_CA.h"
 #include "configuration_interface.h"
 #include "gnss_sdr_valve.h"
+#include "iq_archive.h"
 #include <glog/logging.h>
 #include <uhd/exception.hpp>
 #include <uhd/types/device_addr.hpp>
 #include <volk/volk.h>
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
@@ -199,6 +201,27 @@ UhdSignalSource::UhdSignalSource(ConfigurationInterface* configuration,
                 }
         }
 
+    // dump_format=iqa records all the RF channels in a single IQ archive,
+    // bit-packed and entropy-coded, instead of a raw file per channel
+    dump_format_ = configuration->property(role + ".dump_format", std::string("raw"));
+    if (dump_format_ == "iqa" and std::find(dump_.begin(), dump_.end(), true) != dump_.end())
+        {
+            const int default_bits = item_type_ == "cbyte" ? 8 : 16;
+            Iq_Archive_Format format;
+            format.channels = static_cast<uint16_t>(RF_channels_);
+            format.bits = static_cast<uint8_t>(configuration->property(role + ".dump_bits", default_bits));
+            format.compression = configuration->property(role + ".dump_compression", true) ? Iq_Archive_Compression::HUFFMAN : Iq_Archive_Compression::NONE;
+            format.sampling_frequency = uhd_source_->get_samp_rate();
+            // fc32 samples are in [-1, 1]
+            format.scale = item_type_ == "gr_complex" ? configuration->property(role + ".dump_scale", static_cast<float>((1 << (format.bits - 1)) - 1)) : 1.0F;
+            LOG(INFO) << "Recording " << RF_channels_ << " RF channels into the IQ archive " << dump_filename_.at(0);
+            archive_sink_ = iq_archive_make_sink(dump_filename_.at(0), item_size_, format, configuration->property(role + ".dump_threads", 2));
+            for (int i = 0; i < RF_channels_; i++)
+                {
+                    dump_.at(i) = false;
+                }
+        }
+
     for (int i = 0; i < RF_channels_; i++)
         {
             if (samples_.at(i) != 0ULL)
@@ -230,6 +253,18 @@ void UhdSignalSource::connect(gr::top_block_sptr top_block)
 {
     for (int i = 0; i < RF_channels_; i++)
         {
+            if (archive_sink_)
+                {
+                    if (samples_.at(i) != 0ULL)
+                        {
+                            top_block->connect(valve_.at(i), 0, archive_sink_, i);
+                        }
+                    else
+                        {
+                            top_block->connect(uhd_source_, i, archive_sink_, i);
+                        }
+                    DLOG(INFO) << "connected RF Channel " << i << " to IQ archive sink";
+                }
             if (samples_.at(i) != 0ULL)
                 {
                     top_block->connect(uhd_source_, i, valve_.at(i), 0);
@@ -256,6 +291,17 @@ void UhdSignalSource::disconnect(gr::top_block_sptr top_block)
 {
     for (int i = 0; i < RF_channels_; i++)
         {
+            if (archive_sink_)
+                {
+                    if (samples_.at(i) != 0ULL)
+                        {
+                            top_block->disconnect(valve_.at(i), 0, archive_sink_, i);
+                        }
+                    else
+                        {
+                            top_block->disconnect(uhd_source_, i, archive_sink_, i);
+                        }
+                }
             if (samples_.at(i) != 0ULL)
                 {
                     top_block->disconnect(uhd_source_, i, valve_.at(i), 0);
@@ -22,6 +22,7 @@
 
 #include "concurrent_queue.h"
 #include "gnss_block_interface.h"
+#include "iq_archive_sink.h"
 #include <gnuradio/blocks/file_sink.h>
 #include <gnuradio/hier_block2.h>
 #include <gnuradio/uhd/usrp_source.h>
@@ -103,6 +104,8 @@ private:
     std::vector<boost::shared_ptr<gr::block>> valve_;
 #endif
     std::vector<gr::blocks::file_sink::sptr> file_sink_;
+    std::string dump_format_;
+    iq_archive_sink_sptr archive_sink_;
 
     std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue_;
 };
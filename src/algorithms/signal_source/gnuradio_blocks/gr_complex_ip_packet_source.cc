@@ -2,7 +2,8 @@
  * \file gr_complex_ip_packet_source.cc
  *
  * \brief Receives ip frames containing samples in UDP frame encapsulation
- * using a high performance packet capture library (libpcap)
+ * using a high performance packet capture library (libpcap), an AF_PACKET
+ * TPACKET_V3 memory-mapped ring, or batched recvmmsg() calls on a UDP socket
  * \author Javier Arribas jarribas (at) cttc.es
  * -------------------------------------------------------------------------
  *
@@ -20,12 +21,26 @@
 
 
 #include "gr_complex_ip_packet_source.h"
+#include <glog/logging.h>
 #include <gnuradio/io_signature.h>
+#include <linux/if_packet.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
 #include <array>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
 #include <utility>
+#include <vector>
 
-const int FIFO_SIZE = 1472000;
+const int RECVMMSG_BATCH = 64;                  // datagrams per recvmmsg() call
+const unsigned int TPACKET_BLOCK_SIZE = 1 << 22;  // bytes per block of the TPACKET_V3 ring
+const unsigned int TPACKET_BLOCK_NR = 64;         // blocks in the TPACKET_V3 ring
+const unsigned int TPACKET_FRAME_SIZE = 2048;
+const int POLL_TIMEOUT_MS = 100;  // capture threads check the stop flag at least this often
 
 
 /* 4 bytes IP address */
@@ -73,7 +88,11 @@ Gr_Complex_Ip_Packet_Source::make(std::string src_device,
     int n_baseband_channels,
     const std::string &wire_sample_type,
     size_t item_size,
-    bool IQ_swap_)
+    bool IQ_swap_,
+    const std::string &capture_backend,
+    int sequence_number_bytes,
+    size_t ring_buffer_bytes,
+    int socket_buffer_bytes)
 {
     return gnuradio::get_initial_sptr(new Gr_Complex_Ip_Packet_Source(std::move(src_device),
         origin_address,
@@ -82,7 +101,11 @@ Gr_Complex_Ip_Packet_Source::make(std::string src_device,
         n_baseband_channels,
         wire_sample_type,
         item_size,
-        IQ_swap_));
+        IQ_swap_,
+        capture_backend,
+        sequence_number_bytes,
+        ring_buffer_bytes,
+        socket_buffer_bytes));
 }
 
 
@@ -96,10 +119,15 @@ Gr_Complex_Ip_Packet_Source::Gr_Complex_Ip_Packet_Source(std::string src_device,
     int n_baseband_channels,
     const std::string &wire_sample_type,
     size_t item_size,
-    bool IQ_swap_)
+    bool IQ_swap_,
+    const std::string &capture_backend,
+    int sequence_number_bytes,
+    size_t ring_buffer_bytes,
+    int socket_buffer_bytes)
     : gr::sync_block("gr_complex_ip_packet_source",
           gr::io_signature::make(0, 0, 0),
-          gr::io_signature::make(1, 4, item_size))  // 1 to 4 baseband complex channels
+          gr::io_signature::make(1, 4, item_size)),  // 1 to 4 baseband complex channels
+      d_ring(ring_buffer_bytes)
 {
     std::cout << "Start Ethernet packet capture\n";
 
@@ -125,14 +153,45 @@ Gr_Complex_Ip_Packet_Source::Gr_Complex_Ip_Packet_Source(std::string src_device,
     d_udp_payload_size = udp_packet_size;
     d_fifo_full = false;
 
-    // allocate signal samples buffer
-    fifo_buff = new char[FIFO_SIZE];
-    fifo_read_ptr = 0;
-    fifo_write_ptr = 0;
-    fifo_items = 0;
+    if (capture_backend == "tpacket_v3")
+        {
+            d_backend = TPACKET_V3;
+        }
+    else if (capture_backend == "recvmmsg")
+        {
+            d_backend = RECVMMSG;
+        }
+    else
+        {
+            if (capture_backend != "pcap")
+                {
+                    std::cout << "Unknown capture backend " << capture_backend << ", using pcap\n";
+                }
+            d_backend = PCAP;
+        }
+    if (sequence_number_bytes != 0 && sequence_number_bytes != 2 && sequence_number_bytes != 4 && sequence_number_bytes != 8)
+        {
+            std::cout << "Sequence numbers must have 0, 2, 4 or 8 bytes\n";
+            exit(0);
+        }
+    d_sequence_number_bytes = sequence_number_bytes;
+    d_socket_buffer_bytes = socket_buffer_bytes;
+    d_expected_sequence_number = 0;
+    d_sequence_started = false;
+    d_last_kernel_drops = 0;
+    d_stop = false;
+    d_packets_received = 0;
+    d_packets_dropped = 0;
+    d_kernel_packets_dropped = 0;
+    d_sequence_gaps = 0;
+    d_out_of_order_packets = 0;
+
     d_item_size = item_size;
     d_IQ_swap = IQ_swap_;
     d_sock_raw = 0;
+    d_sock_packet = -1;
+    d_packet_ring = nullptr;
+    d_packet_ring_size = 0;
     d_pcap_thread = nullptr;
     descr = nullptr;
 
@@ -144,11 +203,22 @@ Gr_Complex_Ip_Packet_Source::Gr_Complex_Ip_Packet_Source(std::string src_device,
 bool Gr_Complex_Ip_Packet_Source::start()
 {
     std::cout << "gr_complex_ip_packet_source START\n";
+    d_stop = false;
     // open the ethernet device
     if (open() == true)
         {
-            // start pcap capture thread
-            d_pcap_thread = new boost::thread(boost::bind(&Gr_Complex_Ip_Packet_Source::my_pcap_loop_thread, this, descr));
+            // start capture thread
+            switch (d_backend)
+                {
+                case TPACKET_V3:
+                    d_pcap_thread = new boost::thread(boost::bind(&Gr_Complex_Ip_Packet_Source::tpacket_loop_thread, this));
+                    break;
+                case RECVMMSG:
+                    d_pcap_thread = new boost::thread(boost::bind(&Gr_Complex_Ip_Packet_Source::recvmmsg_loop_thread, this));
+                    break;
+                default:
+                    d_pcap_thread = new boost::thread(boost::bind(&Gr_Complex_Ip_Packet_Source::my_pcap_loop_thread, this, descr));
+                }
             return true;
         }
     return false;
@@ -159,27 +229,80 @@ bool Gr_Complex_Ip_Packet_Source::start()
 bool Gr_Complex_Ip_Packet_Source::stop()
 {
     std::cout << "gr_complex_ip_packet_source STOP\n";
+    d_stop = true;
     if (descr != nullptr)
         {
             pcap_breakloop(descr);
+        }
+    if (d_pcap_thread != nullptr)
+        {
             d_pcap_thread->join();
+            delete d_pcap_thread;
+            d_pcap_thread = nullptr;
+        }
+    if (descr != nullptr)
+        {
             pcap_close(descr);
+            descr = nullptr;
+        }
+    if (d_packet_ring != nullptr)
+        {
+            munmap(d_packet_ring, d_packet_ring_size);
+            d_packet_ring = nullptr;
+        }
+    if (d_sock_packet != -1)
+        {
+            close(d_sock_packet);
+            d_sock_packet = -1;
         }
+    if (d_sock_raw > 0)
+        {
+            close(d_sock_raw);
+            d_sock_raw = 0;
+        }
+    print_statistics();
     return true;
 }
 
 
+void Gr_Complex_Ip_Packet_Source::print_statistics()
+{
+    std::cout << "UDP packets received: " << d_packets_received
+              << ", dropped by a full ring buffer: " << d_packets_dropped
+              << ", dropped by the kernel: " << d_kernel_packets_dropped;
+    if (d_sequence_number_bytes > 0)
+        {
+            std::cout << ", missing in the sequence: " << d_sequence_gaps
+                      << ", out of order: " << d_out_of_order_packets;
+        }
+    std::cout << std::endl;
+    LOG(INFO) << "UDP packets received: " << d_packets_received << " ring drops: " << d_packets_dropped
+              << " kernel drops: " << d_kernel_packets_dropped << " sequence gaps: " << d_sequence_gaps
+              << " out of order: " << d_out_of_order_packets;
+}
+
+
 bool Gr_Complex_Ip_Packet_Source::open()
 {
     std::array<char, PCAP_ERRBUF_SIZE> errbuf{};
     boost::mutex::scoped_lock lock(d_mutex);  // hold mutex for duration of this function
-    // open device for reading
-    descr = pcap_open_live(d_src_device.c_str(), 1500, 1, 1000, errbuf.data());
-    if (descr == nullptr)
+    if (d_backend == PCAP)
         {
-            std::cout << "Error opening Ethernet device " << d_src_device << std::endl;
-            std::cout << "Fatal Error in pcap_open_live(): " << std::string(errbuf.data()) << std::endl;
-            return false;
+            // open device for reading
+            descr = pcap_open_live(d_src_device.c_str(), 1500, 1, 1000, errbuf.data());
+            if (descr == nullptr)
+                {
+                    std::cout << "Error opening Ethernet device " << d_src_device << std::endl;
+                    std::cout << "Fatal Error in pcap_open_live(): " << std::string(errbuf.data()) << std::endl;
+                    return false;
+                }
+        }
+    else if (d_backend == TPACKET_V3)
+        {
+            if (!open_tpacket())
+                {
+                    return false;
+                }
         }
     // bind UDP port to avoid automatic reply with ICMP port unreachable packets from kernel
     d_sock_raw = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
@@ -196,12 +319,92 @@ bool Gr_Complex_Ip_Packet_Source::open()
     si_me.sin_port = htons(d_udp_port);
     si_me.sin_addr.s_addr = htonl(INADDR_ANY);
 
+    if (d_backend == RECVMMSG)
+        {
+            // this socket receives the samples: make room for bursts, count
+            // the datagrams dropped by the kernel, and wake up periodically
+            // to check the stop flag
+            setsockopt(d_sock_raw, SOL_SOCKET, SO_RCVBUF, &d_socket_buffer_bytes, sizeof(d_socket_buffer_bytes));
+            int enable = 1;
+            setsockopt(d_sock_raw, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+            struct timeval timeout
+            {
+            };
+            timeout.tv_usec = POLL_TIMEOUT_MS * 1000;
+            setsockopt(d_sock_raw, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        }
+
     // bind socket to port
     if (bind(d_sock_raw, reinterpret_cast<struct sockaddr *>(&si_me), sizeof(si_me)) == -1)
         {
             std::cout << "Error opening UDP socket" << std::endl;
             return false;
         }
+    if (d_udp_port == 0)
+        {
+            // the capture threads filter on the port assigned by the kernel
+            socklen_t length = sizeof(si_me);
+            if (getsockname(d_sock_raw, reinterpret_cast<struct sockaddr *>(&si_me), &length) == -1)
+                {
+                    std::cout << "Error reading the port of the UDP socket" << std::endl;
+                    return false;
+                }
+            d_udp_port = ntohs(si_me.sin_port);
+        }
+    return true;
+}
+
+
+bool Gr_Complex_Ip_Packet_Source::open_tpacket()
+{
+    d_sock_packet = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_IP));
+    if (d_sock_packet == -1)
+        {
+            std::cout << "Error opening AF_PACKET socket: " << strerror(errno) << std::endl;
+            return false;
+        }
+    int version = TPACKET_V3;
+    if (setsockopt(d_sock_packet, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1)
+        {
+            std::cout << "TPACKET_V3 is not supported: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+    // the kernel fills blocks of frames, and hands over a block when it is
+    // full or after tp_retire_blk_tov ms
+    struct tpacket_req3 req
+    {
+    };
+    req.tp_block_size = TPACKET_BLOCK_SIZE;
+    req.tp_block_nr = TPACKET_BLOCK_NR;
+    req.tp_frame_size = TPACKET_FRAME_SIZE;
+    req.tp_frame_nr = (TPACKET_BLOCK_SIZE / TPACKET_FRAME_SIZE) * TPACKET_BLOCK_NR;
+    req.tp_retire_blk_tov = 10;
+    if (setsockopt(d_sock_packet, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1)
+        {
+            std::cout << "Error setting up the TPACKET_V3 ring: " << strerror(errno) << std::endl;
+            return false;
+        }
+    d_packet_ring_size = static_cast<size_t>(req.tp_block_size) * req.tp_block_nr;
+    void *ring = mmap(nullptr, d_packet_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, d_sock_packet, 0);
+    if (ring == MAP_FAILED)
+        {
+            std::cout << "Error mapping the TPACKET_V3 ring: " << strerror(errno) << std::endl;
+            return false;
+        }
+    d_packet_ring = static_cast<uint8_t *>(ring);
+
+    struct sockaddr_ll ll
+    {
+    };
+    ll.sll_family = AF_PACKET;
+    ll.sll_protocol = htons(ETH_P_IP);
+    ll.sll_ifindex = static_cast<int>(if_nametoindex(d_src_device.c_str()));
+    if (ll.sll_ifindex == 0 || bind(d_sock_packet, reinterpret_cast<struct sockaddr *>(&ll), sizeof(ll)) == -1)
+        {
+            std::cout << "Error opening Ethernet device " << d_src_device << std::endl;
+            return false;
+        }
     return true;
 }
 
@@ -212,7 +415,6 @@ Gr_Complex_Ip_Packet_Source::~Gr_Complex_Ip_Packet_Source()
         {
             delete d_pcap_thread;
         }
-    delete fifo_buff;
     std::cout << "Stop Ethernet packet capture\n";
 }
 
@@ -225,16 +427,24 @@ void Gr_Complex_Ip_Packet_Source::static_pcap_callback(u_char *args, const struc
 }
 
 
-void Gr_Complex_Ip_Packet_Source::pcap_callback(__attribute__((unused)) u_char *args, __attribute__((unused)) const struct pcap_pkthdr *pkthdr,
+void Gr_Complex_Ip_Packet_Source::pcap_callback(__attribute__((unused)) u_char *args, const struct pcap_pkthdr *pkthdr,
     const u_char *packet)
 {
-    boost::mutex::scoped_lock lock(d_mutex);  // hold mutex for duration of this function
+    process_frame(packet, pkthdr->caplen);
+}
 
+
+void Gr_Complex_Ip_Packet_Source::process_frame(const u_char *packet, size_t frame_length)
+{
     const gr_ip_header *ih;
     const gr_udp_header *uh;
 
     // eth frame parameters
     // **** UDP RAW PACKET DECODER ****
+    if (frame_length < 14 + 20 + sizeof(gr_udp_header))
+        {
+            return;
+        }
     if ((packet[12] == 0x08) & (packet[13] == 0x00))  // IP FRAME
         {
             // retrieve the position of the ip header
@@ -246,55 +456,23 @@ void Gr_Complex_Ip_Packet_Source::pcap_callback(__attribute__((unused)) u_char *
             uh = reinterpret_cast<const gr_udp_header *>(reinterpret_cast<const u_char *>(ih) + ip_len);
 
             // convert from network byte order to host byte order
-            // u_short sport;
             u_short dport;
             dport = ntohs(uh->dport);
-            // sport = ntohs(uh->sport);
             if (dport == d_udp_port)
                 {
-                    // print ip addresses and udp ports
-                    //            printf("%d.%d.%d.%d.%d -> %d.%d.%d.%d.%d\n",
-                    //                   ih->saddr.byte1,
-                    //                   ih->saddr.byte2,
-                    //                   ih->saddr.byte3,
-                    //                   ih->saddr.byte4,
-                    //                   sport,
-                    //                   ih->daddr.byte1,
-                    //                   ih->daddr.byte2,
-                    //                   ih->daddr.byte3,
-                    //                   ih->daddr.byte4,
-                    //                   dport);
-                    //            std::cout<<"uh->len:"<<ntohs(uh->len)<<std::endl;
-
                     int payload_length_bytes = ntohs(uh->len) - 8;  // total udp packet length minus the header length
-                    // read the payload bytes and insert them into the shared circular buffer
                     const u_char *udp_payload = (reinterpret_cast<const u_char *>(uh) + sizeof(gr_udp_header));
-                    if (fifo_items <= (FIFO_SIZE - payload_length_bytes))
+                    if (udp_payload + payload_length_bytes > packet + frame_length)
                         {
-                            int aligned_write_items = FIFO_SIZE - fifo_write_ptr;
-                            if (aligned_write_items >= payload_length_bytes)
-                                {
-                                    // write all in a single memcpy
-                                    memcpy(&fifo_buff[fifo_write_ptr], &udp_payload[0], payload_length_bytes);  // size in bytes
-                                    fifo_write_ptr += payload_length_bytes;
-                                    if (fifo_write_ptr == FIFO_SIZE)
-                                        {
-                                            fifo_write_ptr = 0;
-                                        }
-                                    fifo_items += payload_length_bytes;
-                                }
-                            else
-                                {
-                                    // two step wrap write
-                                    memcpy(&fifo_buff[fifo_write_ptr], &udp_payload[0], aligned_write_items);  // size in bytes
-                                    fifo_write_ptr = payload_length_bytes - aligned_write_items;
-                                    memcpy(&fifo_buff[0], &udp_payload[aligned_write_items], fifo_write_ptr);  // size in bytes
-                                    fifo_items += payload_length_bytes;
-                                }
+                            return;  // truncated capture
                         }
-                    else
+                    d_packets_received++;
+                    const int header_bytes = check_sequence_number(udp_payload, payload_length_bytes);
+                    // insert the payload bytes into the shared circular buffer
+                    if (!d_ring.push(udp_payload + header_bytes, payload_length_bytes - header_bytes))
                         {
                             // notify overflow
+                            d_packets_dropped++;
                             std::cout << "O" << std::flush;
                         }
                 }
@@ -302,17 +480,190 @@ void Gr_Complex_Ip_Packet_Source::pcap_callback(__attribute__((unused)) u_char *
 }
 
 
+int Gr_Complex_Ip_Packet_Source::check_sequence_number(const uint8_t *payload, int payload_length_bytes)
+{
+    if (d_sequence_number_bytes == 0 || payload_length_bytes < d_sequence_number_bytes)
+        {
+            return 0;
+        }
+    // big-endian counter, wrapping at 2^(8 * d_sequence_number_bytes)
+    uint64_t sequence_number = 0;
+    for (int i = 0; i < d_sequence_number_bytes; i++)
+        {
+            sequence_number = (sequence_number << 8U) | payload[i];
+        }
+    const uint64_t mask = d_sequence_number_bytes == 8 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << (8U * d_sequence_number_bytes)) - 1;
+    if (d_sequence_started)
+        {
+            const uint64_t gap = (sequence_number - d_expected_sequence_number) & mask;
+            if (gap > mask / 2)
+                {
+                    // late or repeated packet, its samples are already out of place
+                    d_out_of_order_packets++;
+                    return d_sequence_number_bytes;
+                }
+            d_sequence_gaps += gap;
+        }
+    d_sequence_started = true;
+    d_expected_sequence_number = (sequence_number + 1) & mask;
+    return d_sequence_number_bytes;
+}
+
+
 void Gr_Complex_Ip_Packet_Source::my_pcap_loop_thread(pcap_t *pcap_handle)
 {
     pcap_loop(pcap_handle, -1, Gr_Complex_Ip_Packet_Source::static_pcap_callback, reinterpret_cast<u_char *>(this));
 }
 
 
+void Gr_Complex_Ip_Packet_Source::tpacket_loop_thread()
+{
+    unsigned int block_index = 0;
+    struct pollfd pfd
+    {
+    };
+    pfd.fd = d_sock_packet;
+    pfd.events = POLLIN | POLLERR;
+    while (!d_stop)
+        {
+            auto *block = reinterpret_cast<struct tpacket_block_desc *>(d_packet_ring + static_cast<size_t>(block_index) * TPACKET_BLOCK_SIZE);
+            if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0)
+                {
+                    poll(&pfd, 1, POLL_TIMEOUT_MS);
+                    continue;
+                }
+
+            // the frames are read in place, in the memory shared with the kernel
+            auto *frame = reinterpret_cast<struct tpacket3_hdr *>(reinterpret_cast<uint8_t *>(block) + block->hdr.bh1.offset_to_first_pkt);
+            for (uint32_t i = 0; i < block->hdr.bh1.num_pkts; i++)
+                {
+                    process_frame(reinterpret_cast<const u_char *>(frame) + frame->tp_mac, frame->tp_snaplen);
+                    frame = reinterpret_cast<struct tpacket3_hdr *>(reinterpret_cast<uint8_t *>(frame) + frame->tp_next_offset);
+                }
+
+            // give the block back to the kernel
+            __sync_synchronize();
+            block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+            block_index = (block_index + 1) % TPACKET_BLOCK_NR;
+        }
+
+    struct tpacket_stats_v3 stats
+    {
+    };
+    socklen_t len = sizeof(stats);
+    if (getsockopt(d_sock_packet, SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0)
+        {
+            d_kernel_packets_dropped += stats.tp_drops;
+        }
+}
+
+
+void Gr_Complex_Ip_Packet_Source::recvmmsg_loop_thread()
+{
+    // each datagram is received straight into the ring buffer, split in two
+    // pieces if it wraps around its end; the sequence number, if any, goes
+    // to a separate buffer
+    const auto slot = static_cast<size_t>(d_udp_payload_size);
+    std::vector<struct mmsghdr> msgs(RECVMMSG_BATCH);
+    std::vector<std::array<struct iovec, 3>> iovecs(RECVMMSG_BATCH);
+    std::vector<std::array<uint8_t, 8>> sequence_numbers(RECVMMSG_BATCH);
+    std::vector<std::array<char, CMSG_SPACE(sizeof(uint32_t))>> controls(RECVMMSG_BATCH);
+    std::vector<uint8_t> discard(65536);
+    std::vector<uint8_t> payload(d_sequence_number_bytes);
+
+    while (!d_stop)
+        {
+            const auto batch = static_cast<int>(std::min<size_t>(RECVMMSG_BATCH, d_ring.free_space() / slot));
+            if (batch == 0)
+                {
+                    // the ring buffer is full: drain the socket anyway
+                    const ssize_t received = recv(d_sock_raw, discard.data(), discard.size(), 0);
+                    if (received > 0)
+                        {
+                            d_packets_received++;
+                            d_packets_dropped++;
+                            check_sequence_number(discard.data(), static_cast<int>(received));
+                            std::cout << "O" << std::flush;
+                        }
+                    continue;
+                }
+
+            for (int i = 0; i < batch; i++)
+                {
+                    int n = 0;
+                    if (d_sequence_number_bytes > 0)
+                        {
+                            iovecs[i][n].iov_base = sequence_numbers[i].data();
+                            iovecs[i][n++].iov_len = d_sequence_number_bytes;
+                        }
+                    size_t contiguous;
+                    iovecs[i][n].iov_base = d_ring.writable(i * slot, contiguous);
+                    const size_t first_piece = std::min(slot, contiguous);
+                    iovecs[i][n++].iov_len = first_piece;
+                    if (first_piece < slot)
+                        {
+                            iovecs[i][n].iov_base = d_ring.writable(i * slot + first_piece, contiguous);
+                            iovecs[i][n++].iov_len = slot - first_piece;
+                        }
+                    msgs[i].msg_hdr = {};
+                    msgs[i].msg_hdr.msg_iov = iovecs[i].data();
+                    msgs[i].msg_hdr.msg_iovlen = n;
+                    msgs[i].msg_hdr.msg_control = controls[i].data();
+                    msgs[i].msg_hdr.msg_controllen = controls[i].size();
+                }
+
+            const int received = recvmmsg(d_sock_raw, msgs.data(), batch, MSG_WAITFORONE, nullptr);
+            if (received <= 0)
+                {
+                    continue;  // timeout, checks the stop flag
+                }
+
+            size_t committed = 0;
+            for (int i = 0; i < received; i++)
+                {
+                    d_packets_received++;
+                    int length = static_cast<int>(msgs[i].msg_len);
+                    if (d_sequence_number_bytes > 0)
+                        {
+                            if (length < d_sequence_number_bytes)
+                                {
+                                    continue;
+                                }
+                            std::copy(sequence_numbers[i].begin(), sequence_numbers[i].begin() + d_sequence_number_bytes, payload.begin());
+                            check_sequence_number(payload.data(), length);
+                            length -= d_sequence_number_bytes;
+                        }
+                    length = std::min(length, static_cast<int>(slot));  // longer datagrams are truncated
+                    if (committed != i * slot)
+                        {
+                            // an earlier datagram was shorter than the slot
+                            d_ring.compact(i * slot, committed, length);
+                        }
+                    committed += length;
+
+                    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+                        {
+                            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+                                {
+                                    // cumulative count of datagrams dropped by the socket
+                                    uint32_t drops;
+                                    std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                                    d_kernel_packets_dropped += drops - d_last_kernel_drops;
+                                    d_last_kernel_drops = drops;
+                                }
+                        }
+                }
+            d_ring.commit(committed);
+        }
+}
+
+
 void Gr_Complex_Ip_Packet_Source::demux_samples(const gr_vector_void_star &output_items, int num_samples_readed)
 {
     int8_t real;
     int8_t imag;
     uint8_t tmp_char2;
+    size_t read_offset = 0;  // from the read position of the ring buffer
     for (int n = 0; n < num_samples_readed; n++)
         {
             switch (d_wire_sample_type)
@@ -320,8 +671,8 @@ void Gr_Complex_Ip_Packet_Source::demux_samples(const gr_vector_void_star &outpu
                 case 1:  // interleaved byte samples
                     for (auto &output_item : output_items)
                         {
-                            real = fifo_buff[fifo_read_ptr++];
-                            imag = fifo_buff[fifo_read_ptr++];
+                            real = static_cast<int8_t>(d_ring.peek(read_offset++));
+                            imag = static_cast<int8_t>(d_ring.peek(read_offset++));
                             if (d_IQ_swap)
                                 {
                                     static_cast<gr_complex *>(output_item)[n] = gr_complex(real, imag);
@@ -335,7 +686,7 @@ void Gr_Complex_Ip_Packet_Source::demux_samples(const gr_vector_void_star &outpu
                 case 2:  // 4-bit samples
                     for (auto &output_item : output_items)
                         {
-                            tmp_char2 = fifo_buff[fifo_read_ptr] & 0x0F;
+                            tmp_char2 = d_ring.peek(read_offset) & 0x0F;
                             if (tmp_char2 >= 8)
                                 {
                                     real = 2 * (tmp_char2 - 16) + 1;
@@ -344,7 +695,7 @@ void Gr_Complex_Ip_Packet_Source::demux_samples(const gr_vector_void_star &outpu
                                 {
                                     real = 2 * tmp_char2 + 1;
                                 }
-                            tmp_char2 = fifo_buff[fifo_read_ptr++] >> 4;
+                            tmp_char2 = d_ring.peek(read_offset++) >> 4;
                             tmp_char2 = tmp_char2 & 0x0F;
                             if (tmp_char2 >= 8)
                                 {
@@ -368,11 +719,10 @@ void Gr_Complex_Ip_Packet_Source::demux_samples(const gr_vector_void_star &outpu
                     std::cout << "Unknown wire sample type\n";
                     exit(0);
                 }
-            if (fifo_read_ptr == FIFO_SIZE)
-                {
-                    fifo_read_ptr = 0;
-                }
+            // skip the channels in the packets that are not connected
+            read_offset = static_cast<size_t>(n + 1) * d_bytes_per_sample;
         }
+    d_ring.consume(read_offset);
 }
 
 
@@ -381,7 +731,7 @@ int Gr_Complex_Ip_Packet_Source::work(int noutput_items,
     gr_vector_void_star &output_items)
 {
     // send samples to next GNU Radio block
-    boost::mutex::scoped_lock lock(d_mutex);  // hold mutex for duration of this function
+    const int fifo_items = static_cast<int>(std::min<size_t>(d_ring.available(), INT32_MAX));
     if (fifo_items == 0)
         {
             return 0;
@@ -430,11 +780,8 @@ int Gr_Complex_Ip_Packet_Source::work(int noutput_items,
                 }
         }
 
-    bytes_requested = num_samples_readed * d_bytes_per_sample;
     // read all in a single loop
-    demux_samples(output_items, num_samples_readed);  // it also increases the fifo read pointer
-    // update fifo items
-    fifo_items = fifo_items - bytes_requested;
+    demux_samples(output_items, num_samples_readed);  // it also releases the bytes read from the ring buffer
 
     for (uint64_t n = 0; n < output_items.size(); n++)
         {
@@ -2,7 +2,8 @@
  * \file gr_complex_ip_packet_source.h
  *
  * \brief Receives ip frames containing samples in UDP frame encapsulation
- * using a high performance packet capture library (libpcap)
+ * using a high performance packet capture library (libpcap), an AF_PACKET
+ * TPACKET_V3 memory-mapped ring, or batched recvmmsg() calls on a UDP socket
  * \author Javier Arribas jarribas (at) cttc.es
  * -------------------------------------------------------------------------
  *
@@ -22,6 +23,7 @@
 #ifndef GNSS_SDR_GR_COMPLEX_IP_PACKET_SOURCE_H
 #define GNSS_SDR_GR_COMPLEX_IP_PACKET_SOURCE_H
 
+#include "spsc_byte_ring.h"
 #include <boost/thread.hpp>
 #include <gnuradio/sync_block.h>
 #include <arpa/inet.h>
@@ -29,6 +31,8 @@
 #include <net/if.h>
 #include <netinet/if_ether.h>
 #include <pcap.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <sys/ioctl.h>
 #if GNURADIO_USES_STD_POINTERS
@@ -52,7 +56,11 @@ public:
         int n_baseband_channels,
         const std::string &wire_sample_type,
         size_t item_size,
-        bool IQ_swap_);
+        bool IQ_swap_,
+        const std::string &capture_backend = std::string("pcap"),
+        int sequence_number_bytes = 0,
+        size_t ring_buffer_bytes = 16777216,
+        int socket_buffer_bytes = 67108864);
     Gr_Complex_Ip_Packet_Source(std::string src_device,
         const std::string &origin_address,
         int udp_port,
@@ -60,7 +68,11 @@ public:
         int n_baseband_channels,
         const std::string &wire_sample_type,
         size_t item_size,
-        bool IQ_swap_);
+        bool IQ_swap_,
+        const std::string &capture_backend,
+        int sequence_number_bytes,
+        size_t ring_buffer_bytes,
+        int socket_buffer_bytes);
     ~Gr_Complex_Ip_Packet_Source();
 
     // Called by gnuradio to enable drivers, etc for i/o devices.
@@ -74,15 +86,43 @@ public:
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items);
 
+    // Packet statistics
+    inline uint64_t packets_received() const { return d_packets_received.load(); }
+    inline uint64_t packets_dropped() const { return d_packets_dropped.load(); }                // ring buffer full
+    inline uint64_t kernel_packets_dropped() const { return d_kernel_packets_dropped.load(); }  // socket or capture ring full
+    inline uint64_t sequence_gaps() const { return d_sequence_gaps.load(); }                    // packets missing in the sequence numbers
+    inline uint64_t out_of_order_packets() const { return d_out_of_order_packets.load(); }
+
+    // UDP port, assigned by the kernel when the source is started if 0 was requested
+    inline int udp_port() const { return d_udp_port.load(); }
+
 private:
+    enum Capture_Backend
+    {
+        PCAP,
+        TPACKET_V3,
+        RECVMMSG
+    };
     boost::mutex d_mutex;
     pcap_t *descr;  // ethernet pcap device descriptor
-    char *fifo_buff;
-    int fifo_read_ptr;
-    int fifo_write_ptr;
-    int fifo_items;
+    Spsc_Byte_Ring d_ring;
     int d_sock_raw;
-    int d_udp_port;
+    int d_sock_packet;
+    uint8_t *d_packet_ring;
+    size_t d_packet_ring_size;
+    Capture_Backend d_backend;
+    int d_sequence_number_bytes;
+    int d_socket_buffer_bytes;
+    uint64_t d_expected_sequence_number;
+    bool d_sequence_started;
+    uint32_t d_last_kernel_drops;
+    std::atomic<bool> d_stop;
+    std::atomic<uint64_t> d_packets_received;
+    std::atomic<uint64_t> d_packets_dropped;
+    std::atomic<uint64_t> d_kernel_packets_dropped;
+    std::atomic<uint64_t> d_sequence_gaps;
+    std::atomic<uint64_t> d_out_of_order_packets;
+    std::atomic<int> d_udp_port;
     // clang-format off
     struct sockaddr_in si_me{};
     // clang-format on
@@ -98,13 +138,30 @@ private:
     boost::thread *d_pcap_thread;
     void demux_samples(const gr_vector_void_star &output_items, int num_samples_readed);
     void my_pcap_loop_thread(pcap_t *pcap_handle);
+    void tpacket_loop_thread();
+    void recvmmsg_loop_thread();
     void pcap_callback(u_char *args, const struct pcap_pkthdr *pkthdr, const u_char *packet);
     static void static_pcap_callback(u_char *args, const struct pcap_pkthdr *pkthdr, const u_char *packet);
+    /*
+     * Decodes an Ethernet frame and, if it carries an UDP datagram for
+     * d_udp_port, pushes its payload into the ring buffer
+     */
+    void process_frame(const u_char *packet, size_t frame_length);
+    /*
+     * Checks and strips the sequence number at the beginning of a payload.
+     * Returns the number of bytes of the header.
+     */
+    int check_sequence_number(const uint8_t *payload, int payload_length_bytes);
+    void print_statistics();
     /*
      * Opens the ethernet device using libpcap raw capture mode
      * If any of these fail, the function returns the error and exits.
      */
     bool open();
+    /*
+     * Opens an AF_PACKET socket with a TPACKET_V3 receive ring mapped in memory
+     */
+    bool open_tpacket();
 };
 
 #endif  //  GNSS_SDR_GR_COMPLEX_IP_PACKET_SOURCE_H
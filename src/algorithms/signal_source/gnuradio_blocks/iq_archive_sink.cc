@@ -0,0 +1,167 @@
+/*!
+ * \file iq_archive_sink.cc
+ * \brief GNU Radio block that records its inputs in an IQ archive
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "iq_archive_sink.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+
+iq_archive_sink_sptr iq_archive_make_sink(const std::string &filename, size_t item_size, const Iq_Archive_Format &format, unsigned int encoding_threads)
+{
+    return iq_archive_sink_sptr(new iq_archive_sink(filename, item_size, format, encoding_threads));
+}
+
+
+iq_archive_sink::iq_archive_sink(const std::string &filename,
+    size_t item_size,
+    const Iq_Archive_Format &format,
+    unsigned int encoding_threads) : gr::sync_block("iq_archive_sink",
+                                         gr::io_signature::make(format.channels, format.channels, item_size),
+                                         gr::io_signature::make(0, 0, 0)),
+                                     d_format(format),
+                                     d_item_size(item_size),
+                                     d_encoding_threads(std::max(encoding_threads, 1U)),
+                                     d_components(format.channels, std::vector<int16_t>(2 * static_cast<size_t>(format.chunk_samples))),
+                                     d_fill(0),
+                                     d_sample_counter(format.first_sample_counter),
+                                     d_finished(false)
+{
+    if (d_item_size != sizeof(std::complex<float>) and d_item_size != sizeof(std::complex<int16_t>) and d_item_size != sizeof(std::complex<int8_t>))
+        {
+            throw std::runtime_error("iq_archive_sink: unsupported item size");
+        }
+    if (not d_writer.open(filename, d_format))
+        {
+            throw std::runtime_error("can't create IQ archive " + filename);
+        }
+}
+
+
+iq_archive_sink::~iq_archive_sink()
+{
+    finish();
+}
+
+
+bool iq_archive_sink::stop()
+{
+    finish();
+    return true;
+}
+
+
+void iq_archive_sink::finish()
+{
+    if (d_finished)
+        {
+            return;
+        }
+    d_finished = true;
+    submit();
+    write_pending(0);
+    d_writer.close();
+    LOG(INFO) << "IQ archive closed after " << d_writer.chunks() << " chunks";
+}
+
+
+void iq_archive_sink::submit()
+{
+    if (d_fill == 0)
+        {
+            return;
+        }
+    auto components = std::make_shared<std::vector<std::vector<int16_t>>>(std::move(d_components));
+    d_components = std::vector<std::vector<int16_t>>(d_format.channels, std::vector<int16_t>(2 * static_cast<size_t>(d_format.chunk_samples)));
+    const Iq_Archive_Format format = d_format;
+    const uint32_t samples = d_fill;
+    const uint64_t counter = d_sample_counter;
+    d_pending.push_back(std::async(std::launch::async, [components, format, samples, counter]() {
+        std::vector<const int16_t *> channels;
+        for (const auto &c : *components)
+            {
+                channels.push_back(c.data());
+            }
+        std::vector<uint8_t> chunk;
+        iq_archive::encode_chunk(format, channels, samples, counter, chunk);
+        return chunk;
+    }));
+    d_sample_counter += d_fill;
+    d_fill = 0;
+    write_pending(d_encoding_threads);
+}
+
+
+void iq_archive_sink::write_pending(size_t keep)
+{
+    while (d_pending.size() > keep)
+        {
+            if (not d_writer.write_chunk(d_pending.front().get()))
+                {
+                    LOG(WARNING) << "Error writing the IQ archive";
+                }
+            d_pending.pop_front();
+        }
+}
+
+
+int iq_archive_sink::work(int noutput_items,
+    gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items __attribute__((unused)))
+{
+    int consumed = 0;
+    while (consumed < noutput_items)
+        {
+            const int n = std::min(noutput_items - consumed, static_cast<int>(d_format.chunk_samples - d_fill));
+            for (size_t c = 0; c < input_items.size(); c++)
+                {
+                    int16_t *out = &d_components[c][2 * static_cast<size_t>(d_fill)];
+                    if (d_item_size == sizeof(std::complex<float>))
+                        {
+                            const auto *in = static_cast<const float *>(input_items[c]) + 2 * consumed;
+                            for (int i = 0; i < 2 * n; i++)
+                                {
+                                    const float value = std::round(in[i] * d_format.scale);
+                                    out[i] = static_cast<int16_t>(std::max(std::min(value, 32767.0F), -32768.0F));
+                                }
+                        }
+                    else if (d_item_size == sizeof(std::complex<int16_t>))
+                        {
+                            const auto *in = static_cast<const int16_t *>(input_items[c]) + 2 * consumed;
+                            std::copy(in, in + 2 * n, out);
+                        }
+                    else
+                        {
+                            const auto *in = static_cast<const int8_t *>(input_items[c]) + 2 * consumed;
+                            std::copy(in, in + 2 * n, out);
+                        }
+                }
+            d_fill += n;
+            consumed += n;
+            if (d_fill == d_format.chunk_samples)
+                {
+                    submit();
+                }
+        }
+    return noutput_items;
+}
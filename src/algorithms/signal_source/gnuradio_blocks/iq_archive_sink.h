@@ -0,0 +1,88 @@
+/*!
+ * \file iq_archive_sink.h
+ * \brief GNU Radio block that records its inputs in an IQ archive
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_IQ_ARCHIVE_SINK_H
+#define GNSS_SDR_IQ_ARCHIVE_SINK_H
+
+#include "iq_archive.h"
+#include <gnuradio/sync_block.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class iq_archive_sink;
+
+#if GNURADIO_USES_STD_POINTERS
+using iq_archive_sink_sptr = std::shared_ptr<iq_archive_sink>;
+#else
+using iq_archive_sink_sptr = boost::shared_ptr<iq_archive_sink>;
+#endif
+
+/*!
+ * \brief Creates the archive. item_size selects the input type, gr_complex
+ * (multiplied by format.scale and rounded), lv_16sc_t or lv_8sc_t, and
+ * format.channels the number of inputs. Throws std::runtime_error if the file cannot be
+ * created.
+ */
+iq_archive_sink_sptr iq_archive_make_sink(const std::string &filename, size_t item_size, const Iq_Archive_Format &format, unsigned int encoding_threads);
+
+/*!
+ * \brief Records its inputs in an IQ archive. Full chunks are encoded by
+ * up to encoding_threads worker threads and written in order, and the
+ * index is written when the flowgraph stops.
+ */
+class iq_archive_sink : public gr::sync_block
+{
+public:
+    ~iq_archive_sink();
+
+    bool stop() override;
+
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend iq_archive_sink_sptr iq_archive_make_sink(const std::string &filename, size_t item_size, const Iq_Archive_Format &format, unsigned int encoding_threads);
+
+    iq_archive_sink(const std::string &filename, size_t item_size, const Iq_Archive_Format &format, unsigned int encoding_threads);
+
+    void submit();                    // encodes the samples gathered so far
+    void write_pending(size_t keep);  // writes encoded chunks until keep are left
+    void finish();
+
+    Iq_Archive_Writer d_writer;
+    Iq_Archive_Format d_format;
+    size_t d_item_size;
+    unsigned int d_encoding_threads;
+    std::vector<std::vector<int16_t>> d_components;  // interleaved I and Q of each channel
+    uint32_t d_fill;
+    uint64_t d_sample_counter;  // counter of the first sample of the chunk being filled
+    std::deque<std::future<std::vector<uint8_t>>> d_pending;
+    bool d_finished;
+};
+
+#endif  // GNSS_SDR_IQ_ARCHIVE_SINK_H
@@ -0,0 +1,173 @@
+/*!
+ * \file iq_archive_source.cc
+ * \brief GNU Radio block that replays an IQ archive, decoding several chunks
+ * in parallel
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "iq_archive_source.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+
+iq_archive_source_sptr iq_archive_make_source(const std::string &filename, size_t item_size, bool repeat, unsigned int decoding_threads)
+{
+    auto reader = std::make_shared<Iq_Archive_Reader>();
+    if (not reader->open(filename))
+        {
+            throw std::runtime_error("can't open IQ archive " + filename);
+        }
+    return iq_archive_source_sptr(new iq_archive_source(std::move(reader), item_size, repeat, decoding_threads));
+}
+
+
+iq_archive_source::iq_archive_source(std::shared_ptr<Iq_Archive_Reader> reader,
+    size_t item_size,
+    bool repeat,
+    unsigned int decoding_threads) : gr::sync_block("iq_archive_source",
+                                         gr::io_signature::make(0, 0, 0),
+                                         gr::io_signature::make(reader->format().channels, reader->format().channels, item_size)),
+                                     d_reader(std::move(reader)),
+                                     d_item_size(item_size),
+                                     d_repeat(repeat),
+                                     d_decoding_threads(std::max(decoding_threads, 1U)),
+                                     d_next_chunk(0),
+                                     d_offset(0),
+                                     d_skip(0)
+{
+    if (d_item_size != sizeof(std::complex<float>) and d_item_size != sizeof(std::complex<int16_t>))
+        {
+            throw std::runtime_error("iq_archive_source: unsupported item size");
+        }
+    LOG(INFO) << "IQ archive with " << d_reader->format().channels << " channels of "
+              << static_cast<int>(d_reader->format().bits) << "-bit samples, "
+              << d_reader->samples() << " samples per channel in " << d_reader->chunks() << " chunks";
+}
+
+
+iq_archive_source::Decoded_Chunk iq_archive_source::decode(const std::shared_ptr<Iq_Archive_Reader> &reader, size_t chunk, size_t item_size)
+{
+    Decoded_Chunk decoded;
+    std::vector<uint8_t> data;
+    if (reader->read_chunk(chunk, data))
+        {
+            if (item_size == sizeof(std::complex<float>))
+                {
+                    decoded.valid = iq_archive::decode_chunk(reader->format(), data, decoded.fc);
+                }
+            else
+                {
+                    decoded.valid = iq_archive::decode_chunk(reader->format(), data, decoded.sc);
+                }
+            decoded.samples = reader->chunk_samples(chunk);
+        }
+    return decoded;
+}
+
+
+void iq_archive_source::schedule()
+{
+    while (d_pending.size() < d_decoding_threads and d_next_chunk < d_reader->chunks())
+        {
+            d_pending.push_back(std::async(std::launch::async, &iq_archive_source::decode, d_reader, d_next_chunk, d_item_size));
+            d_next_chunk++;
+        }
+}
+
+
+bool iq_archive_source::next_chunk()
+{
+    schedule();
+    if (d_pending.empty())
+        {
+            if (not d_repeat or d_reader->chunks() == 0)
+                {
+                    return false;
+                }
+            d_next_chunk = 0;
+            schedule();
+        }
+    d_current = d_pending.front().get();
+    d_pending.pop_front();
+    schedule();
+    if (not d_current.valid)
+        {
+            LOG(ERROR) << "Corrupted chunk in the IQ archive, stopping the replay";
+            d_pending.clear();
+            d_current = Decoded_Chunk();
+            d_next_chunk = d_reader->chunks();
+            d_repeat = false;
+            return false;
+        }
+    d_offset = std::min(d_skip, d_current.samples);
+    d_skip = 0;
+    return true;
+}
+
+
+bool iq_archive_source::seek(uint64_t sample)
+{
+    const size_t chunk = d_reader->chunk_for_sample(sample);
+    if (chunk >= d_reader->chunks())
+        {
+            return false;
+        }
+    d_pending.clear();
+    d_current = Decoded_Chunk();
+    d_offset = 0;
+    d_next_chunk = chunk;
+    d_skip = static_cast<uint32_t>(sample - d_reader->chunk_first_sample(chunk));
+    DLOG(INFO) << "IQ archive seek to sample " << sample << ", chunk " << chunk
+               << " with sample counter " << d_reader->chunk_counter(chunk);
+    return true;
+}
+
+
+int iq_archive_source::work(int noutput_items,
+    gr_vector_const_void_star &input_items __attribute__((unused)),
+    gr_vector_void_star &output_items)
+{
+    int produced = 0;
+    while (produced < noutput_items)
+        {
+            if (d_offset >= d_current.samples)
+                {
+                    if (not next_chunk())
+                        {
+                            break;
+                        }
+                    continue;
+                }
+            const int n = std::min(noutput_items - produced, static_cast<int>(d_current.samples - d_offset));
+            const auto *data = d_item_size == sizeof(std::complex<float>) ? reinterpret_cast<const uint8_t *>(d_current.fc.data()) : reinterpret_cast<const uint8_t *>(d_current.sc.data());
+            for (size_t c = 0; c < output_items.size(); c++)
+                {
+                    std::memcpy(static_cast<uint8_t *>(output_items[c]) + produced * d_item_size,
+                        data + (c * d_current.samples + d_offset) * d_item_size,
+                        n * d_item_size);
+                }
+            d_offset += n;
+            produced += n;
+        }
+    if (produced == 0)
+        {
+            return WORK_DONE;
+        }
+    return produced;
+}
@@ -0,0 +1,106 @@
+/*!
+ * \file iq_archive_source.h
+ * \brief GNU Radio block that replays an IQ archive, decoding several chunks
+ * in parallel
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_IQ_ARCHIVE_SOURCE_H
+#define GNSS_SDR_IQ_ARCHIVE_SOURCE_H
+
+#include "iq_archive.h"
+#include <gnuradio/sync_block.h>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class iq_archive_source;
+
+#if GNURADIO_USES_STD_POINTERS
+using iq_archive_source_sptr = std::shared_ptr<iq_archive_source>;
+#else
+using iq_archive_source_sptr = boost::shared_ptr<iq_archive_source>;
+#endif
+
+/*!
+ * \brief Opens an IQ archive. item_size selects the output type, gr_complex
+ * or lv_16sc_t. Throws std::runtime_error if the file cannot be read.
+ */
+iq_archive_source_sptr iq_archive_make_source(const std::string &filename, size_t item_size, bool repeat, unsigned int decoding_threads);
+
+/*!
+ * \brief Replays an IQ archive, with one output per channel.
+ *
+ * The next decoding_threads chunks are read and decoded by worker threads
+ * while the current one is delivered, and seek() moves to any sample by
+ * looking up the chunk in the index.
+ */
+class iq_archive_source : public gr::sync_block
+{
+public:
+    ~iq_archive_source() = default;
+
+    /*!
+     * \brief Moves the read position to a sample, counted from the first
+     * sample of the file. Returns false if it is past the end of the file.
+     */
+    bool seek(uint64_t sample);
+
+    inline const Iq_Archive_Format &format() const { return d_reader->format(); }
+    inline uint64_t samples() const { return d_reader->samples(); }  //!< Samples per channel in the file
+
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend iq_archive_source_sptr iq_archive_make_source(const std::string &filename, size_t item_size, bool repeat, unsigned int decoding_threads);
+
+    iq_archive_source(std::shared_ptr<Iq_Archive_Reader> reader, size_t item_size, bool repeat, unsigned int decoding_threads);
+
+    struct Decoded_Chunk
+    {
+        bool valid = false;
+        uint32_t samples = 0;
+        std::vector<std::complex<float>> fc;
+        std::vector<std::complex<int16_t>> sc;
+    };
+
+    static Decoded_Chunk decode(const std::shared_ptr<Iq_Archive_Reader> &reader, size_t chunk, size_t item_size);
+    void schedule();    // keeps decoding_threads chunks in flight
+    bool next_chunk();  // makes the oldest decoded chunk the current one
+
+    std::shared_ptr<Iq_Archive_Reader> d_reader;
+    size_t d_item_size;
+    bool d_repeat;
+    unsigned int d_decoding_threads;
+
+    std::deque<std::future<Decoded_Chunk>> d_pending;
+    size_t d_next_chunk;
+    Decoded_Chunk d_current;
+    uint32_t d_offset;  // next sample of the current chunk
+    uint32_t d_skip;    // samples to skip in the next chunk, after a seek
+};
+
+#endif  // GNSS_SDR_IQ_ARCHIVE_SOURCE_H
@@ -0,0 +1,229 @@
+/*!
+ * \file mmap_file_source.cc
+ * \brief GNU Radio block that reads samples from a memory-mapped file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mmap_file_source.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>   // for min
+#include <cerrno>      // for errno
+#include <cstdio>      // for SEEK_SET
+#include <cstring>     // for memcpy, strerror
+#include <fcntl.h>     // for open
+#include <iostream>    // for cout
+#include <stdexcept>   // for runtime_error
+#include <sys/mman.h>  // for mmap, madvise
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close, sysconf
+
+
+mmap_file_source_sptr mmap_make_file_source(size_t item_size, const char *filename, bool repeat)
+{
+    return mmap_file_source_sptr(new mmap_file_source(item_size, filename, repeat));
+}
+
+
+mmap_file_source::mmap_file_source(size_t item_size,
+    const char *filename,
+    bool repeat) : gr::sync_block("mmap_file_source",
+                       gr::io_signature::make(0, 0, 0),
+                       gr::io_signature::make(1, 1, item_size)),
+                   d_filename(filename),
+                   d_item_size(item_size),
+                   d_repeat(repeat),
+                   d_fd(-1),
+                   d_data(nullptr),
+                   d_file_size(0),
+                   d_n_items(0),
+                   d_item(0),
+                   d_advised_until(0),
+                   d_released_until(0),
+                   d_bytes_read(0),
+                   d_started(false),
+                   d_reported(false)
+{
+    d_page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    d_fd = ::open(filename, O_RDONLY);
+    if (d_fd == -1)
+        {
+            throw std::runtime_error(std::string("mmap_file_source: can't open file ") + d_filename + ": " + std::strerror(errno));
+        }
+    struct stat file_stat;
+    if (fstat(d_fd, &file_stat) != 0)
+        {
+            ::close(d_fd);
+            throw std::runtime_error(std::string("mmap_file_source: can't stat file ") + d_filename + ": " + std::strerror(errno));
+        }
+    d_file_size = static_cast<uint64_t>(file_stat.st_size);
+    d_n_items = d_file_size / d_item_size;
+    if (d_file_size > 0)
+        {
+            void *data = mmap(nullptr, d_file_size, PROT_READ, MAP_SHARED, d_fd, 0);
+            if (data == MAP_FAILED)
+                {
+                    ::close(d_fd);
+                    throw std::runtime_error(std::string("mmap_file_source: can't map file ") + d_filename + ": " + std::strerror(errno));
+                }
+            d_data = static_cast<uint8_t *>(data);
+            if (madvise(d_data, d_file_size, MADV_SEQUENTIAL) != 0)
+                {
+                    LOG(WARNING) << "mmap_file_source: madvise(MADV_SEQUENTIAL) failed: " << std::strerror(errno);
+                }
+            advise(0);
+        }
+}
+
+
+mmap_file_source::~mmap_file_source()
+{
+    report_throughput();
+    if (d_data != nullptr)
+        {
+            munmap(d_data, d_file_size);
+        }
+    if (d_fd != -1)
+        {
+            ::close(d_fd);
+        }
+}
+
+
+bool mmap_file_source::seek(int64_t seek_point, int whence)
+{
+    int64_t item;
+    switch (whence)
+        {
+        case SEEK_SET:
+            item = seek_point;
+            break;
+        case SEEK_CUR:
+            item = static_cast<int64_t>(d_item) + seek_point;
+            break;
+        case SEEK_END:
+            item = static_cast<int64_t>(d_n_items) + seek_point;
+            break;
+        default:
+            return false;
+        }
+    if (item < 0 or item > static_cast<int64_t>(d_n_items))
+        {
+            return false;
+        }
+    d_item = static_cast<uint64_t>(item);
+    // restart the read-ahead window at the new position
+    d_released_until = (d_item * d_item_size / d_page_size) * d_page_size;
+    d_advised_until = d_released_until;
+    advise(d_item);
+    return true;
+}
+
+
+double mmap_file_source::get_throughput_gbps() const
+{
+    const double elapsed_s = std::chrono::duration<double>(d_last_time - d_start_time).count();
+    if (!d_started or elapsed_s <= 0.0)
+        {
+            return 0.0;
+        }
+    return static_cast<double>(d_bytes_read) / elapsed_s / 1e9;
+}
+
+
+void mmap_file_source::advise(uint64_t item)
+{
+    if (d_data == nullptr)
+        {
+            return;
+        }
+    const uint64_t position = item * d_item_size;
+
+    // ask for the next window when half of the previous one has been consumed
+    if (position + READ_AHEAD_BYTES / 2 >= d_advised_until and d_advised_until < d_file_size)
+        {
+            const uint64_t start = std::max(d_advised_until, (position / d_page_size) * d_page_size);
+            const uint64_t end = std::min(d_file_size, position + READ_AHEAD_BYTES);
+            if (end > start)
+                {
+                    madvise(d_data + start, end - start, MADV_WILLNEED);
+                }
+            d_advised_until = end;
+        }
+
+    // release the pages that have already been delivered, keeping the current one
+    const uint64_t release_end = (position / d_page_size) * d_page_size;
+    if (release_end >= d_released_until + READ_AHEAD_BYTES)
+        {
+            madvise(d_data + d_released_until, release_end - d_released_until, MADV_DONTNEED);
+            d_released_until = release_end;
+        }
+}
+
+
+void mmap_file_source::report_throughput()
+{
+    if (d_reported or !d_started)
+        {
+            return;
+        }
+    d_reported = true;
+    const double elapsed_s = std::chrono::duration<double>(d_last_time - d_start_time).count();
+    LOG(INFO) << "mmap_file_source: read " << d_bytes_read << " bytes from " << d_filename
+              << " in " << elapsed_s << " s (" << get_throughput_gbps() << " GB/s)";
+    std::cout << "File source read " << static_cast<double>(d_bytes_read) / 1e9 << " GB in " << elapsed_s
+              << " s (" << get_throughput_gbps() << " GB/s)" << std::endl;
+}
+
+
+int mmap_file_source::work(int noutput_items,
+    gr_vector_const_void_star &input_items __attribute__((unused)),
+    gr_vector_void_star &output_items)
+{
+    if (!d_started)
+        {
+            d_start_time = std::chrono::steady_clock::now();
+            d_started = true;
+        }
+    auto *out = static_cast<uint8_t *>(output_items[0]);
+    uint64_t produced = 0;
+    const auto requested = static_cast<uint64_t>(noutput_items);
+    while (produced < requested)
+        {
+            if (d_item >= d_n_items)
+                {
+                    if (!d_repeat or d_n_items == 0)
+                        {
+                            break;
+                        }
+                    // as gr::blocks::file_source, repeat from the beginning of the file
+                    seek(0, SEEK_SET);
+                }
+            const uint64_t n = std::min(requested - produced, d_n_items - d_item);
+            std::memcpy(out + produced * d_item_size, d_data + d_item * d_item_size, n * d_item_size);
+            d_item += n;
+            produced += n;
+        }
+    advise(d_item);
+    d_bytes_read += produced * d_item_size;
+    d_last_time = std::chrono::steady_clock::now();
+
+    if (produced == 0)
+        {
+            report_throughput();
+            return WORK_DONE;
+        }
+    return static_cast<int>(produced);
+}
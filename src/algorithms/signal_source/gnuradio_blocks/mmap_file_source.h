@@ -0,0 +1,98 @@
+/*!
+ * \file mmap_file_source.h
+ * \brief GNU Radio block that reads samples from a memory-mapped file
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MMAP_FILE_SOURCE_H
+#define GNSS_SDR_MMAP_FILE_SOURCE_H
+
+#include <gnuradio/sync_block.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class mmap_file_source;
+
+#if GNURADIO_USES_STD_POINTERS
+using mmap_file_source_sptr = std::shared_ptr<mmap_file_source>;
+#else
+using mmap_file_source_sptr = boost::shared_ptr<mmap_file_source>;
+#endif
+
+mmap_file_source_sptr mmap_make_file_source(size_t item_size, const char *filename, bool repeat);
+
+/*!
+ * \brief Drop-in replacement of gr::blocks::file_source that maps the whole
+ * file in memory instead of reading it with buffered fread() calls.
+ *
+ * The kernel is told that the file is read sequentially, and read-ahead is
+ * requested for the next READ_AHEAD_BYTES bytes as the read position moves,
+ * while the pages already consumed are released. The achieved throughput is
+ * reported when the end of the file is reached and when the block is
+ * destroyed.
+ */
+class mmap_file_source : public gr::sync_block
+{
+public:
+    ~mmap_file_source();
+
+    /*!
+     * \brief Moves the read position, in items, as gr::blocks::file_source::seek()
+     */
+    bool seek(int64_t seek_point, int whence);
+
+    uint64_t get_bytes_read() const { return d_bytes_read; }  //!< Number of bytes delivered so far
+    double get_throughput_gbps() const;                          //!< Read throughput so far [GB/s]
+
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend mmap_file_source_sptr mmap_make_file_source(size_t item_size, const char *filename, bool repeat);
+
+    mmap_file_source(size_t item_size, const char *filename, bool repeat);
+
+    void advise(uint64_t item);  // read-ahead and release around the read position
+    void report_throughput();
+
+    static const uint64_t READ_AHEAD_BYTES = 64 * 1024 * 1024;
+
+    std::string d_filename;
+    size_t d_item_size;
+    bool d_repeat;
+    int d_fd;
+    uint8_t *d_data;
+    uint64_t d_file_size;  // bytes
+    uint64_t d_n_items;
+    uint64_t d_item;  // read position
+    uint64_t d_page_size;
+    uint64_t d_advised_until;   // bytes
+    uint64_t d_released_until;  // bytes
+    uint64_t d_bytes_read;
+    bool d_started;
+    bool d_reported;
+    std::chrono::time_point<std::chrono::steady_clock> d_start_time;
+    std::chrono::time_point<std::chrono::steady_clock> d_last_time;
+};
+
+#endif  // GNSS_SDR_MMAP_FILE_SOURCE_H
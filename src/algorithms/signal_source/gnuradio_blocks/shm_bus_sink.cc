@@ -0,0 +1,62 @@
+/*!
+ * \file shm_bus_sink.cc
+ * \brief GNU Radio block that publishes its input on a shared memory sample
+ * bus, for other receiver processes to read
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "shm_bus_sink.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <stdexcept>
+
+
+shm_bus_sink_sptr shm_bus_make_sink(const std::string &bus_name, size_t item_size, uint64_t capacity, double sampling_frequency)
+{
+    return shm_bus_sink_sptr(new shm_bus_sink(bus_name, item_size, capacity, sampling_frequency));
+}
+
+
+shm_bus_sink::shm_bus_sink(const std::string &bus_name,
+    size_t item_size,
+    uint64_t capacity,
+    double sampling_frequency) : gr::sync_block("shm_bus_sink",
+                                     gr::io_signature::make(1, 1, item_size),
+                                     gr::io_signature::make(0, 0, 0))
+{
+    if (not d_writer.create(bus_name, item_size, capacity, sampling_frequency))
+        {
+            throw std::runtime_error("can't create the sample bus " + bus_name);
+        }
+    LOG(INFO) << "Publishing samples on the shared memory bus " << bus_name
+              << " (" << d_writer.capacity() << " items of " << item_size << " bytes)";
+}
+
+
+bool shm_bus_sink::stop()
+{
+    LOG(INFO) << "Closing the sample bus after " << d_writer.counter() << " samples";
+    d_writer.close();
+    return true;
+}
+
+
+int shm_bus_sink::work(int noutput_items,
+    gr_vector_const_void_star &input_items,
+    gr_vector_void_star &output_items __attribute__((unused)))
+{
+    d_writer.write(input_items[0], noutput_items);
+    return noutput_items;
+}
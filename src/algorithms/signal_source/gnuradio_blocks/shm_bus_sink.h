@@ -0,0 +1,73 @@
+/*!
+ * \file shm_bus_sink.h
+ * \brief GNU Radio block that publishes its input on a shared memory sample
+ * bus, for other receiver processes to read
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SHM_BUS_SINK_H
+#define GNSS_SDR_SHM_BUS_SINK_H
+
+#include "shm_sample_bus.h"
+#include <gnuradio/sync_block.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class shm_bus_sink;
+
+#if GNURADIO_USES_STD_POINTERS
+using shm_bus_sink_sptr = std::shared_ptr<shm_bus_sink>;
+#else
+using shm_bus_sink_sptr = boost::shared_ptr<shm_bus_sink>;
+#endif
+
+/*!
+ * \brief Creates the bus, with room for at least capacity items. Throws
+ * std::runtime_error if the shared memory segment cannot be created.
+ */
+shm_bus_sink_sptr shm_bus_make_sink(const std::string &bus_name, size_t item_size, uint64_t capacity, double sampling_frequency);
+
+/*!
+ * \brief Writes its input on a Shm_Sample_Bus_Writer. It never blocks the
+ * flowgraph: readers that fall behind lose samples, and are told how many.
+ */
+class shm_bus_sink : public gr::sync_block
+{
+public:
+    ~shm_bus_sink() = default;
+
+    bool stop() override;  // closes the bus
+
+    inline uint64_t counter() const { return d_writer.counter(); }
+
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend shm_bus_sink_sptr shm_bus_make_sink(const std::string &bus_name, size_t item_size, uint64_t capacity, double sampling_frequency);
+
+    shm_bus_sink(const std::string &bus_name, size_t item_size, uint64_t capacity, double sampling_frequency);
+
+    Shm_Sample_Bus_Writer d_writer;
+};
+
+#endif  // GNSS_SDR_SHM_BUS_SINK_H
@@ -0,0 +1,130 @@
+/*!
+ * \file shm_bus_source.cc
+ * \brief GNU Radio block that reads the samples published on a shared
+ * memory sample bus by another receiver process
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "shm_bus_source.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+
+shm_bus_source_sptr shm_bus_make_source(const std::string &bus_name, size_t item_size, bool fill_gaps, double attach_timeout_s)
+{
+    return shm_bus_source_sptr(new shm_bus_source(bus_name, item_size, fill_gaps, attach_timeout_s));
+}
+
+
+shm_bus_source::shm_bus_source(const std::string &bus_name,
+    size_t item_size,
+    bool fill_gaps,
+    double attach_timeout_s) : gr::sync_block("shm_bus_source",
+                                   gr::io_signature::make(0, 0, 0),
+                                   gr::io_signature::make(1, 1, item_size)),
+                               d_bus_name(bus_name),
+                               d_item_size(item_size),
+                               d_fill_gaps(fill_gaps),
+                               d_gap(0),
+                               d_overruns(0),
+                               d_lost_samples(0)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(static_cast<int64_t>(attach_timeout_s * 1000.0));
+    while (not d_reader.attach(bus_name))
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    throw std::runtime_error("sample bus " + bus_name + " not found");
+                }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    if (d_reader.item_size() != item_size)
+        {
+            throw std::runtime_error("the items of the sample bus " + bus_name + " are " + std::to_string(d_reader.item_size()) + " bytes long");
+        }
+    LOG(INFO) << "Attached to the shared memory bus " << bus_name << " at sample counter " << d_reader.counter();
+}
+
+
+bool shm_bus_source::stop()
+{
+    if (d_overruns > 0)
+        {
+            std::cout << "Sample bus " << d_bus_name << ": " << d_lost_samples << " samples lost in "
+                      << d_overruns << " overruns" << std::endl;
+        }
+    LOG(INFO) << "Sample bus " << d_bus_name << " read up to sample counter " << d_reader.counter()
+              << ", " << d_lost_samples << " samples lost in " << d_overruns << " overruns";
+    return true;
+}
+
+
+void shm_bus_source::report_loss(uint64_t samples)
+{
+    d_overruns++;
+    d_lost_samples += samples;
+    LOG(WARNING) << "Sample bus " << d_bus_name << " overrun: " << samples << " samples lost before sample counter "
+                 << d_reader.counter() << (d_fill_gaps ? ", replaced by zeros" : "");
+}
+
+
+int shm_bus_source::work(int noutput_items,
+    gr_vector_const_void_star &input_items __attribute__((unused)),
+    gr_vector_void_star &output_items)
+{
+    auto *out = static_cast<uint8_t *>(output_items[0]);
+    if (d_gap > 0)
+        {
+            const auto n = static_cast<int>(std::min<uint64_t>(d_gap, noutput_items));
+            std::memset(out, 0, n * d_item_size);
+            d_gap -= n;
+            return n;
+        }
+
+    if (d_reader.wait(WAIT_TIMEOUT_MS) == 0)
+        {
+            return d_reader.finished() ? WORK_DONE : 0;
+        }
+
+    uint64_t lost = 0;
+    uint64_t zeroed = 0;
+    auto n = static_cast<int>(d_reader.read(out, noutput_items, lost, zeroed));
+    if (lost > 0)
+        {
+            report_loss(lost);
+            if (d_fill_gaps)
+                {
+                    d_gap = lost;
+                }
+            return 0;
+        }
+    if (zeroed > 0)
+        {
+            // the first samples were overwritten while they were being copied
+            report_loss(zeroed);
+            if (not d_fill_gaps)
+                {
+                    std::memmove(out, out + zeroed * d_item_size, (n - zeroed) * d_item_size);
+                    n -= static_cast<int>(zeroed);
+                }
+        }
+    return n;
+}
@@ -0,0 +1,91 @@
+/*!
+ * \file shm_bus_source.h
+ * \brief GNU Radio block that reads the samples published on a shared
+ * memory sample bus by another receiver process
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SHM_BUS_SOURCE_H
+#define GNSS_SDR_SHM_BUS_SOURCE_H
+
+#include "shm_sample_bus.h"
+#include <gnuradio/sync_block.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+class shm_bus_source;
+
+#if GNURADIO_USES_STD_POINTERS
+using shm_bus_source_sptr = std::shared_ptr<shm_bus_source>;
+#else
+using shm_bus_source_sptr = boost::shared_ptr<shm_bus_source>;
+#endif
+
+/*!
+ * \brief Attaches to the bus, waiting up to attach_timeout_s seconds for the
+ * writer to create it. Throws std::runtime_error if it does not show up, or
+ * if its items are not item_size bytes long.
+ */
+shm_bus_source_sptr shm_bus_make_source(const std::string &bus_name, size_t item_size, bool fill_gaps, double attach_timeout_s);
+
+/*!
+ * \brief Reads a Shm_Sample_Bus_Reader, checking the continuity of the
+ * sample counter.
+ *
+ * When the writer overruns this reader, the loss is reported and, if
+ * fill_gaps is set, replaced by as many zeros, so that the sample count
+ * (and thus the receiver time) stays aligned with the writer. The stream
+ * ends when the writer closes the bus.
+ */
+class shm_bus_source : public gr::sync_block
+{
+public:
+    ~shm_bus_source() = default;
+
+    bool stop() override;  // reports the statistics
+
+    inline double sampling_frequency() const { return d_reader.sampling_frequency(); }
+    inline uint64_t overruns() const { return d_overruns; }          //!< Number of discontinuities
+    inline uint64_t lost_samples() const { return d_lost_samples; }  //!< Samples lost in them
+
+    int work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items);
+
+private:
+    friend shm_bus_source_sptr shm_bus_make_source(const std::string &bus_name, size_t item_size, bool fill_gaps, double attach_timeout_s);
+
+    shm_bus_source(const std::string &bus_name, size_t item_size, bool fill_gaps, double attach_timeout_s);
+
+    void report_loss(uint64_t samples);
+
+    static const int WAIT_TIMEOUT_MS = 100;
+
+    Shm_Sample_Bus_Reader d_reader;
+    std::string d_bus_name;
+    size_t d_item_size;
+    bool d_fill_gaps;
+    uint64_t d_gap;  // zeros still to be delivered
+    uint64_t d_overruns;
+    uint64_t d_lost_samples;
+};
+
+#endif  // GNSS_SDR_SHM_BUS_SOURCE_H
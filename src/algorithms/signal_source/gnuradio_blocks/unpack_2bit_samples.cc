@@ -20,6 +20,8 @@
 
 #include "unpack_2bit_samples.h"
 #include <gnuradio/io_signature.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <array>
 
 struct byte_2bit_struct
 {
@@ -119,6 +121,41 @@ unpack_2bit_samples::unpack_2bit_samples(bool big_endian_bytes,
     bool big_endian_bytes_system = systemBytesAreBigEndian();
 
     swap_endian_bytes_ = (big_endian_bytes_system != big_endian_bytes_);
+
+    // Position, in the packed byte, of each output sample
+    std::array<int, 4> order{0, 1, 2, 3};
+    if (!reverse_interleaving_)
+        {
+            if (swap_endian_bytes_)
+                {
+                    order = {3, 2, 1, 0};
+                }
+        }
+    else
+        {
+            if (swap_endian_bytes_)
+                {
+                    order = {2, 3, 0, 1};
+                }
+            else
+                {
+                    order = {1, 0, 3, 2};
+                }
+        }
+
+    if (order != std::array<int, 4>{0, 1, 2, 3})
+        {
+            reorder_lut_.resize(256);
+            for (int byte = 0; byte < 256; byte++)
+                {
+                    int reordered = 0;
+                    for (int k = 0; k < 4; k++)
+                        {
+                            reordered |= ((byte >> (2 * order[k])) & 3) << (2 * k);
+                        }
+                    reorder_lut_[byte] = static_cast<uint8_t>(reordered);
+                }
+        }
 }
 
 
@@ -145,68 +182,21 @@ int unpack_2bit_samples::work(int noutput_items,
     // converted. But we now have two possibilities:
     // 1) The samples in a byte are in big endian order
     // 2) The samples in a byte are in little endian order
-
-    byte_and_samples raw_byte{};
-    int n = 0;
-
-    if (!reverse_interleaving_)
+    // and the samples can also be pairwise swapped (reverse_interleaving_).
+    // The unpacking kernel takes the samples from the least significant
+    // bits first, so other orderings are first rearranged with a lookup table.
+    const auto *bytes = reinterpret_cast<const uint8_t *>(in);
+    if (!reorder_lut_.empty())
         {
-            if (swap_endian_bytes_)
+            reorder_buffer_.resize(ninput_bytes);
+            for (size_t i = 0; i < ninput_bytes; ++i)
                 {
-                    for (size_t i = 0; i < ninput_bytes; ++i)
-                        {
-                            // Read packed input sample (1 byte = 4 samples)
-                            raw_byte.byte = in[i];
-
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_3 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_2 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_1 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_0 + 1);
-                        }
-                }
-            else
-                {
-                    for (size_t i = 0; i < ninput_bytes; ++i)
-                        {
-                            // Read packed input sample (1 byte = 4 samples)
-                            raw_byte.byte = in[i];
-
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_0 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_1 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_2 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_3 + 1);
-                        }
+                    reorder_buffer_[i] = reorder_lut_[bytes[i]];
                 }
+            bytes = reorder_buffer_.data();
         }
-    else
-        {
-            if (swap_endian_bytes_)
-                {
-                    for (size_t i = 0; i < ninput_bytes; ++i)
-                        {
-                            // Read packed input sample (1 byte = 4 samples)
-                            raw_byte.byte = in[i];
-
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_2 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_3 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_0 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_1 + 1);
-                        }
-                }
-            else
-                {
-                    for (size_t i = 0; i < ninput_bytes; ++i)
-                        {
-                            // Read packed input sample (1 byte = 4 samples)
-                            raw_byte.byte = in[i];
 
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_1 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_0 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_3 + 1);
-                            out[n++] = static_cast<int8_t>(2 * raw_byte.samples.sample_2 + 1);
-                        }
-                }
-        }
+    volk_gnsssdr_8u_unpack2bit_8i(out, bytes, ninput_bytes * 4);
 
     return noutput_items;
 }
@@ -113,6 +113,8 @@ private:
     bool swap_endian_bytes_;
     bool reverse_interleaving_;
     std::vector<int8_t> work_buffer_;
+    std::vector<uint8_t> reorder_lut_;  // empty if the samples are already in kernel order
+    std::vector<uint8_t> reorder_buffer_;
 };
 
 #endif  // GNSS_SDR_UNPACK_2BIT_SAMPLES_H
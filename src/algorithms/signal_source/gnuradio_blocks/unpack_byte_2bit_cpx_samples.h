@@ -25,6 +25,8 @@
 #define GNSS_SDR_UNPACK_BYTE_2BIT_CPX_SAMPLES_H
 
 #include <gnuradio/sync_interpolator.h>
+#include <cstdint>
+#include <vector>
 #if GNURADIO_USES_STD_POINTERS
 #include <memory>
 #else
@@ -56,6 +58,7 @@ public:
 
 private:
     friend unpack_byte_2bit_cpx_samples_sptr make_unpack_byte_2bit_cpx_samples_sptr();
+    std::vector<uint8_t> work_buffer_;
 };
 
 #endif  // GNSS_SDR_UNPACK_BYTE_2BIT_CPX_SAMPLES_H
@@ -43,29 +43,16 @@ int unpack_intspir_1bit_samples::work(int noutput_items,
     const auto *in = reinterpret_cast<const signed int *>(input_items[0]);
     auto *out = reinterpret_cast<float *>(output_items[0]);
 
+    // For historical reasons, values are float versions of short int limits (32767)
+    // Only the bits of the first channel (bits 0 and 1) are used
+    static const float lut[4][2] = {{-32767.0, -32767.0}, {32767.0, -32767.0}, {-32767.0, 32767.0}, {32767.0, 32767.0}};
     int n = 0;
-    int channel = 1;
     for (int i = 0; i < noutput_items / 2; i++)
         {
             // Read packed input sample (1 byte = 1 complex sample)
-            // For historical reasons, values are float versions of short int limits (32767)
-            signed int val = in[i];
-            if (((val >> ((channel - 1) * 2)) & 1) == 1)
-                {
-                    out[n++] = static_cast<float>(32767.0);
-                }
-            else
-                {
-                    out[n++] = static_cast<float>(-32767.0);
-                }
-            if (((val >> (2 * channel - 1)) & 1) == 1)
-                {
-                    out[n++] = static_cast<float>(32767.0);
-                }
-            else
-                {
-                    out[n++] = static_cast<float>(-32767.0);
-                }
+            const float *sample = lut[in[i] & 3];
+            out[n++] = sample[0];
+            out[n++] = sample[1];
         }
     return noutput_items;
 }
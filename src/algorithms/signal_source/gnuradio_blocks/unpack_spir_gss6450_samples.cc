@@ -21,7 +21,7 @@
 
 #include "unpack_spir_gss6450_samples.h"
 #include <gnuradio/io_signature.h>
-#include <cmath>
+#include <cstdint>
 
 unpack_spir_gss6450_samples_sptr make_unpack_spir_gss6450_samples(unsigned int adc_nbit_)
 {
@@ -35,72 +35,53 @@ unpack_spir_gss6450_samples::unpack_spir_gss6450_samples(unsigned int adc_nbit)
 {
     adc_bits = adc_nbit;
     samples_per_int = 16 / adc_bits;
+
+    // Decoding table indexed by byte value
+    const auto sign_extend = [](int value, int nbits) { return (value >= (1 << (nbits - 1))) ? value - (1 << nbits) : value; };
+    switch (adc_bits)
+        {
+        case 2:
+            // four bits per complex sample (2 I + 2 Q), two samples per byte.
+            // The sample in the most significant nibble comes first.
+            byte_lut.resize(2 * 256);
+            for (int byte = 0; byte < 256; byte++)
+                {
+                    byte_lut[2 * byte] = gr_complex(sign_extend((byte >> 4) & 3, 2), sign_extend((byte >> 6) & 3, 2));
+                    byte_lut[2 * byte + 1] = gr_complex(sign_extend(byte & 3, 2), sign_extend((byte >> 2) & 3, 2));
+                }
+            break;
+        case 4:
+            // eight bits per complex sample (4 I + 4 Q), one sample per byte
+            byte_lut.resize(256);
+            for (int byte = 0; byte < 256; byte++)
+                {
+                    byte_lut[byte] = gr_complex(sign_extend(byte & 0x0F, 4), sign_extend(byte >> 4, 4));
+                }
+            break;
+        }
 }
 
 
 void unpack_spir_gss6450_samples::decode_4bits_word(uint32_t input_uint32, gr_complex* out, int adc_bits_)
 {
-    int8_t tmp_char;
-    float Q;
-    float I;
     switch (adc_bits_)
         {
         case 2:
-            // four bits per complex sample (2 I + 2 Q), 8 samples per int32[s0,s1,s2,s3,s4,s5,s6,s7]
-            for (int i = 0; i < 8; i++)
+            // 8 samples per int32 [s0,s1,s2,s3,s4,s5,s6,s7], s7 in the least significant bits
+            for (int i = 0; i < 4; i++)
                 {
-                    tmp_char = input_uint32 & 3;
-
-                    if (tmp_char >= 2)
-                        {
-                            I = (tmp_char - 4);
-                        }
-                    else
-                        {
-                            I = tmp_char;
-                        }
-                    input_uint32 = input_uint32 >> 2;
-                    tmp_char = input_uint32 & 3;
-                    if (tmp_char >= 2)
-                        {
-                            Q = (tmp_char - 4);
-                        }
-                    else
-                        {
-                            Q = tmp_char;
-                        }
-                    input_uint32 = input_uint32 >> 2;
-
-                    out[7 - i] = gr_complex(I, Q);
+                    const uint32_t byte = input_uint32 & 0xFF;
+                    out[6 - 2 * i] = byte_lut[2 * byte];
+                    out[7 - 2 * i] = byte_lut[2 * byte + 1];
+                    input_uint32 = input_uint32 >> 8;
                 }
             break;
         case 4:
-            // eight bits per complex sample (4 I + 4 Q), 4 samples per int32= [s0,s1,s2,s3]
+            // 4 samples per int32 = [s0,s1,s2,s3], s3 in the least significant bits
             for (int i = 0; i < 4; i++)
                 {
-                    tmp_char = input_uint32 & 0x0F;
-
-                    if (tmp_char >= 8)
-                        {
-                            I = (tmp_char - 16);
-                        }
-                    else
-                        {
-                            I = tmp_char;
-                        }
-                    input_uint32 = input_uint32 >> 4;
-                    tmp_char = input_uint32 & 0x0F;
-                    if (tmp_char >= 8)
-                        {
-                            Q = (tmp_char - 16);
-                        }
-                    else
-                        {
-                            Q = tmp_char;
-                        }
-                    input_uint32 = input_uint32 >> 4;
-
-                    out[3 - i] = gr_complex(I, Q);
+                    out[3 - i] = byte_lut[input_uint32 & 0xFF];
+                    input_uint32 = input_uint32 >> 8;
                 }
             break;
         }
@@ -22,6 +22,8 @@
 #define GNSS_SDR_UNPACK_SPIR_GSS6450_SAMPLES_H
 
 #include <gnuradio/sync_interpolator.h>
+#include <cstdint>
+#include <vector>
 #if GNURADIO_USES_STD_POINTERS
 #include <memory>
 #else
@@ -52,6 +54,7 @@ public:
 private:
     unsigned int adc_bits;
     unsigned int samples_per_int;
+    std::vector<gr_complex> byte_lut;  // decoded samples for each byte value
 };
 
 #endif  // GNSS_SDR_UNPACK_SPIR_GSS6450_SAMPLES_H
@@ -0,0 +1,671 @@
+/*!
+ * \file iq_archive.cc
+ * \brief Seekable container for recorded IQ samples, made of independently
+ * decodable chunks of bit-packed (and optionally entropy-coded) samples
+ * followed by an index.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "iq_archive.h"
+#include <glog/logging.h>
+#include <fcntl.h>     // for open, O_RDONLY
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for pread, close
+#include <algorithm>
+#include <array>
+#include <cstring>
+#if IQ_ARCHIVE_ZLIB
+#include <zlib.h>
+#endif
+
+
+namespace
+{
+const char FILE_MAGIC[4] = {'G', 'I', 'Q', 'A'};
+const char CHUNK_MAGIC[4] = {'C', 'H', 'N', 'K'};
+const char INDEX_MAGIC[4] = {'G', 'I', 'Q', 'X'};
+const char TRAILER_MAGIC[4] = {'G', 'I', 'Q', 'E'};
+const uint16_t FORMAT_VERSION = 1;
+const uint32_t CHUNK_FLAG_COMPRESSED = 1;
+
+
+void put_u16(uint8_t* p, uint16_t v)
+{
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8U);
+}
+
+
+void put_u32(uint8_t* p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++)
+        {
+            p[i] = static_cast<uint8_t>(v >> (8U * i));
+        }
+}
+
+
+void put_u64(uint8_t* p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++)
+        {
+            p[i] = static_cast<uint8_t>(v >> (8U * i));
+        }
+}
+
+
+uint16_t get_u16(const uint8_t* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8U));
+}
+
+
+uint32_t get_u32(const uint8_t* p)
+{
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--)
+        {
+            v = (v << 8U) | p[i];
+        }
+    return v;
+}
+
+
+uint64_t get_u64(const uint8_t* p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--)
+        {
+            v = (v << 8U) | p[i];
+        }
+    return v;
+}
+
+
+bool pread_all(int fd, uint8_t* buffer, size_t size, uint64_t offset)
+{
+    while (size > 0)
+        {
+            const ssize_t n = pread(fd, buffer, size, static_cast<off_t>(offset));
+            if (n <= 0)
+                {
+                    return false;
+                }
+            buffer += n;
+            size -= static_cast<size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+    return true;
+}
+
+
+bool valid_bits(uint8_t bits)
+{
+    return bits == 2 or bits == 4 or bits == 8 or bits == 16;
+}
+
+
+int16_t clip(int16_t value, uint8_t bits)
+{
+    const int16_t max_value = static_cast<int16_t>((1 << (bits - 1)) - 1);
+    const int16_t min_value = static_cast<int16_t>(-(1 << (bits - 1)));
+    return std::max(min_value, std::min(max_value, value));
+}
+
+
+// Two's complement value of the b-bit field at the lowest bits of v
+inline int16_t sign_extend(uint32_t v, uint8_t bits)
+{
+    const uint32_t sign = 1U << (bits - 1U);
+    return static_cast<int16_t>(static_cast<int32_t>(v ^ sign) - static_cast<int32_t>(sign));
+}
+
+
+template <typename T>
+T make_sample(int16_t i, int16_t q, float scale);
+
+
+template <>
+inline std::complex<float> make_sample(int16_t i, int16_t q, float scale)
+{
+    return {static_cast<float>(i) * scale, static_cast<float>(q) * scale};
+}
+
+
+template <>
+inline std::complex<int16_t> make_sample(int16_t i, int16_t q, float /*scale*/)
+{
+    return {i, q};
+}
+
+
+template <typename T>
+void unpack_samples(const uint8_t* in, uint32_t samples, uint8_t bits, float scale, T* out)
+{
+    const float inv_scale = scale != 0.0F ? 1.0F / scale : 1.0F;
+    switch (bits)
+        {
+        case 16:
+            for (uint32_t n = 0; n < samples; n++)
+                {
+                    out[n] = make_sample<T>(static_cast<int16_t>(get_u16(in + 4 * n)), static_cast<int16_t>(get_u16(in + 4 * n + 2)), inv_scale);
+                }
+            break;
+        case 8:
+            for (uint32_t n = 0; n < samples; n++)
+                {
+                    out[n] = make_sample<T>(static_cast<int8_t>(in[2 * n]), static_cast<int8_t>(in[2 * n + 1]), inv_scale);
+                }
+            break;
+        case 4:
+            {
+                // one sample per byte
+                std::array<T, 256> table{};
+                for (uint32_t b = 0; b < 256; b++)
+                    {
+                        table[b] = make_sample<T>(sign_extend(b & 0x0FU, 4), sign_extend(b >> 4U, 4), inv_scale);
+                    }
+                for (uint32_t n = 0; n < samples; n++)
+                    {
+                        out[n] = table[in[n]];
+                    }
+                break;
+            }
+        case 2:
+            {
+                // two samples per byte
+                std::array<std::array<T, 2>, 256> table{};
+                for (uint32_t b = 0; b < 256; b++)
+                    {
+                        table[b][0] = make_sample<T>(sign_extend(b & 0x03U, 2), sign_extend((b >> 2U) & 0x03U, 2), inv_scale);
+                        table[b][1] = make_sample<T>(sign_extend((b >> 4U) & 0x03U, 2), sign_extend(b >> 6U, 2), inv_scale);
+                    }
+                const uint32_t pairs = samples / 2;
+                for (uint32_t n = 0; n < pairs; n++)
+                    {
+                        out[2 * n] = table[in[n]][0];
+                        out[2 * n + 1] = table[in[n]][1];
+                    }
+                if (samples % 2 == 1)
+                    {
+                        out[samples - 1] = table[in[pairs]][0];
+                    }
+                break;
+            }
+        default:
+            break;
+        }
+}
+
+
+template <typename T>
+bool decode(const Iq_Archive_Format& format, const std::vector<uint8_t>& chunk, std::vector<T>& out)
+{
+    if (chunk.size() < iq_archive::CHUNK_HEADER_SIZE or std::memcmp(chunk.data(), CHUNK_MAGIC, 4) != 0)
+        {
+            return false;
+        }
+    const uint32_t samples = get_u32(&chunk[4]);
+    const uint32_t stored_bytes = get_u32(&chunk[16]);
+    const uint32_t raw_bytes = get_u32(&chunk[20]);
+    const uint32_t flags = get_u32(&chunk[24]);
+    const size_t channel_bytes = iq_archive::packed_size(samples, format.bits);
+    if (stored_bytes != chunk.size() - iq_archive::CHUNK_HEADER_SIZE or raw_bytes != channel_bytes * format.channels)
+        {
+            return false;
+        }
+
+    const uint8_t* payload = &chunk[iq_archive::CHUNK_HEADER_SIZE];
+    std::vector<uint8_t> inflated;
+    if (flags & CHUNK_FLAG_COMPRESSED)
+        {
+#if IQ_ARCHIVE_ZLIB
+            inflated.resize(raw_bytes);
+            z_stream stream{};
+            if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+                {
+                    return false;
+                }
+            stream.next_in = const_cast<Bytef*>(payload);
+            stream.avail_in = stored_bytes;
+            stream.next_out = inflated.data();
+            stream.avail_out = raw_bytes;
+            const int result = inflate(&stream, Z_FINISH);
+            inflateEnd(&stream);
+            if (result != Z_STREAM_END or stream.total_out != raw_bytes)
+                {
+                    return false;
+                }
+            payload = inflated.data();
+#else
+            LOG(WARNING) << "IQ archive chunk is compressed, but GNSS-SDR was built without zlib";
+            return false;
+#endif
+        }
+
+    out.resize(static_cast<size_t>(samples) * format.channels);
+    for (uint16_t c = 0; c < format.channels; c++)
+        {
+            unpack_samples(payload + c * channel_bytes, samples, format.bits, format.scale, &out[static_cast<size_t>(c) * samples]);
+        }
+    return true;
+}
+}  // namespace
+
+
+bool iq_archive::has_compression_support()
+{
+#if IQ_ARCHIVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+size_t iq_archive::packed_size(uint32_t samples, uint8_t bits)
+{
+    return (static_cast<size_t>(samples) * 2 * bits + 7) / 8;
+}
+
+
+void iq_archive::pack(const int16_t* components, uint32_t samples, uint8_t bits, uint8_t* out)
+{
+    const size_t n_components = static_cast<size_t>(samples) * 2;
+    switch (bits)
+        {
+        case 16:
+            for (size_t n = 0; n < n_components; n++)
+                {
+                    put_u16(out + 2 * n, static_cast<uint16_t>(components[n]));
+                }
+            break;
+        case 8:
+            for (size_t n = 0; n < n_components; n++)
+                {
+                    out[n] = static_cast<uint8_t>(clip(components[n], 8));
+                }
+            break;
+        default:
+            {
+                const uint32_t mask = (1U << bits) - 1U;
+                const uint32_t per_byte = 8U / bits;
+                std::memset(out, 0, packed_size(samples, bits));
+                for (size_t n = 0; n < n_components; n++)
+                    {
+                        const uint32_t field = static_cast<uint32_t>(clip(components[n], bits)) & mask;
+                        out[n / per_byte] |= static_cast<uint8_t>(field << (bits * (n % per_byte)));
+                    }
+                break;
+            }
+        }
+}
+
+
+void iq_archive::unpack(const uint8_t* in, uint32_t samples, uint8_t bits, float scale, std::complex<float>* out)
+{
+    unpack_samples(in, samples, bits, scale, out);
+}
+
+
+void iq_archive::unpack(const uint8_t* in, uint32_t samples, uint8_t bits, std::complex<int16_t>* out)
+{
+    unpack_samples(in, samples, bits, 1.0F, out);
+}
+
+
+void iq_archive::encode_chunk(const Iq_Archive_Format& format,
+    const std::vector<const int16_t*>& channels,
+    uint32_t samples,
+    uint64_t sample_counter,
+    std::vector<uint8_t>& chunk)
+{
+    const size_t channel_bytes = packed_size(samples, format.bits);
+    const size_t raw_bytes = channel_bytes * format.channels;
+    std::vector<uint8_t> packed(raw_bytes);
+    for (uint16_t c = 0; c < format.channels; c++)
+        {
+            pack(channels[c], samples, format.bits, &packed[c * channel_bytes]);
+        }
+
+    uint32_t flags = 0;
+    size_t stored_bytes = raw_bytes;
+#if IQ_ARCHIVE_ZLIB
+    if (format.compression == Iq_Archive_Compression::HUFFMAN)
+        {
+            // The samples are noise-like, so string matching would not find
+            // anything: only the Huffman coding stage of deflate is used.
+            chunk.resize(CHUNK_HEADER_SIZE + deflateBound(nullptr, raw_bytes) + 16);
+            z_stream stream{};
+            if (deflateInit2(&stream, 1, Z_DEFLATED, -MAX_WBITS, 8, Z_HUFFMAN_ONLY) == Z_OK)
+                {
+                    stream.next_in = packed.data();
+                    stream.avail_in = static_cast<uInt>(raw_bytes);
+                    stream.next_out = &chunk[CHUNK_HEADER_SIZE];
+                    stream.avail_out = static_cast<uInt>(chunk.size() - CHUNK_HEADER_SIZE);
+                    if (deflate(&stream, Z_FINISH) == Z_STREAM_END and stream.total_out < raw_bytes)
+                        {
+                            flags = CHUNK_FLAG_COMPRESSED;
+                            stored_bytes = stream.total_out;
+                        }
+                    deflateEnd(&stream);
+                }
+        }
+#endif
+    chunk.resize(CHUNK_HEADER_SIZE + stored_bytes);
+    if (flags == 0)
+        {
+            std::memcpy(&chunk[CHUNK_HEADER_SIZE], packed.data(), raw_bytes);
+        }
+
+    std::memcpy(chunk.data(), CHUNK_MAGIC, 4);
+    put_u32(&chunk[4], samples);
+    put_u64(&chunk[8], sample_counter);
+    put_u32(&chunk[16], static_cast<uint32_t>(stored_bytes));
+    put_u32(&chunk[20], static_cast<uint32_t>(raw_bytes));
+    put_u32(&chunk[24], flags);
+    put_u32(&chunk[28], 0);
+}
+
+
+bool iq_archive::decode_chunk(const Iq_Archive_Format& format, const std::vector<uint8_t>& chunk, std::vector<std::complex<float>>& out)
+{
+    return decode(format, chunk, out);
+}
+
+
+bool iq_archive::decode_chunk(const Iq_Archive_Format& format, const std::vector<uint8_t>& chunk, std::vector<std::complex<int16_t>>& out)
+{
+    return decode(format, chunk, out);
+}
+
+
+Iq_Archive_Writer::~Iq_Archive_Writer()
+{
+    close();
+}
+
+
+bool Iq_Archive_Writer::open(const std::string& filename, const Iq_Archive_Format& format)
+{
+    if (not valid_bits(format.bits) or format.channels == 0 or format.chunk_samples == 0)
+        {
+            LOG(WARNING) << "Invalid IQ archive format";
+            return false;
+        }
+    close();
+    d_file = std::fopen(filename.c_str(), "wb");
+    if (d_file == nullptr)
+        {
+            LOG(WARNING) << "Unable to create the IQ archive " << filename;
+            return false;
+        }
+    if (format.compression != Iq_Archive_Compression::NONE and not iq_archive::has_compression_support())
+        {
+            LOG(WARNING) << "GNSS-SDR was built without zlib, the IQ archive " << filename << " will not be compressed";
+        }
+
+    std::array<uint8_t, iq_archive::FILE_HEADER_SIZE> header{};
+    std::memcpy(header.data(), FILE_MAGIC, 4);
+    put_u16(&header[4], FORMAT_VERSION);
+    put_u16(&header[6], static_cast<uint16_t>(iq_archive::FILE_HEADER_SIZE));
+    put_u16(&header[8], format.channels);
+    header[10] = format.bits;
+    header[11] = static_cast<uint8_t>(format.compression);
+    put_u32(&header[12], format.chunk_samples);
+    uint64_t bits64;
+    std::memcpy(&bits64, &format.sampling_frequency, sizeof(bits64));
+    put_u64(&header[16], bits64);
+    uint32_t bits32;
+    std::memcpy(&bits32, &format.scale, sizeof(bits32));
+    put_u32(&header[24], bits32);
+    put_u64(&header[32], format.first_sample_counter);
+    d_offsets.clear();
+    d_counters.clear();
+    d_position = header.size();
+    return std::fwrite(header.data(), 1, header.size(), d_file) == header.size();
+}
+
+
+bool Iq_Archive_Writer::write_chunk(const std::vector<uint8_t>& chunk)
+{
+    if (d_file == nullptr or chunk.size() < iq_archive::CHUNK_HEADER_SIZE)
+        {
+            return false;
+        }
+    if (std::fwrite(chunk.data(), 1, chunk.size(), d_file) != chunk.size())
+        {
+            return false;
+        }
+    d_offsets.push_back(d_position);
+    d_counters.push_back(get_u64(&chunk[8]));
+    d_position += chunk.size();
+    return true;
+}
+
+
+bool Iq_Archive_Writer::close()
+{
+    if (d_file == nullptr)
+        {
+            return false;
+        }
+    std::vector<uint8_t> index(16 + 16 * d_offsets.size() + iq_archive::TRAILER_SIZE);
+    std::memcpy(index.data(), INDEX_MAGIC, 4);
+    put_u64(&index[8], d_offsets.size());
+    for (size_t i = 0; i < d_offsets.size(); i++)
+        {
+            put_u64(&index[16 + 16 * i], d_offsets[i]);
+            put_u64(&index[24 + 16 * i], d_counters[i]);
+        }
+    uint8_t* trailer = &index[index.size() - iq_archive::TRAILER_SIZE];
+    put_u64(trailer, d_position);
+    std::memcpy(trailer + 8, TRAILER_MAGIC, 4);
+    const bool ok = std::fwrite(index.data(), 1, index.size(), d_file) == index.size();
+    std::fclose(d_file);
+    d_file = nullptr;
+    return ok;
+}
+
+
+Iq_Archive_Reader::~Iq_Archive_Reader()
+{
+    close();
+}
+
+
+bool Iq_Archive_Reader::open(const std::string& filename)
+{
+    close();
+    d_fd = ::open(filename.c_str(), O_RDONLY);
+    if (d_fd < 0)
+        {
+            LOG(WARNING) << "Unable to open the IQ archive " << filename;
+            return false;
+        }
+    struct stat file_status
+    {
+    };
+    std::array<uint8_t, iq_archive::FILE_HEADER_SIZE> header{};
+    if (fstat(d_fd, &file_status) != 0 or not pread_all(d_fd, header.data(), header.size(), 0) or std::memcmp(header.data(), FILE_MAGIC, 4) != 0)
+        {
+            LOG(WARNING) << filename << " is not an IQ archive";
+            close();
+            return false;
+        }
+    d_header_size = get_u16(&header[6]);
+    d_format.channels = get_u16(&header[8]);
+    d_format.bits = header[10];
+    d_format.compression = static_cast<Iq_Archive_Compression>(header[11]);
+    d_format.chunk_samples = get_u32(&header[12]);
+    const uint64_t bits64 = get_u64(&header[16]);
+    std::memcpy(&d_format.sampling_frequency, &bits64, sizeof(bits64));
+    const uint32_t bits32 = get_u32(&header[24]);
+    std::memcpy(&d_format.scale, &bits32, sizeof(bits32));
+    d_format.first_sample_counter = get_u64(&header[32]);
+    if (get_u16(&header[4]) > FORMAT_VERSION or d_header_size < iq_archive::FILE_HEADER_SIZE or not valid_bits(d_format.bits) or d_format.channels == 0 or d_format.chunk_samples == 0)
+        {
+            LOG(WARNING) << "Unsupported IQ archive " << filename;
+            close();
+            return false;
+        }
+
+    const auto file_size = static_cast<uint64_t>(file_status.st_size);
+    if (not read_index(file_size))
+        {
+            LOG(WARNING) << "The IQ archive " << filename << " has no index, probably because the recording was interrupted. Rebuilding it.";
+            d_index_rebuilt = true;
+            rebuild_index(file_size);
+        }
+    return true;
+}
+
+
+void Iq_Archive_Reader::close()
+{
+    if (d_fd >= 0)
+        {
+            ::close(d_fd);
+        }
+    d_fd = -1;
+    d_offsets.clear();
+    d_counters.clear();
+    d_chunk_samples.clear();
+    d_samples = 0;
+    d_index_rebuilt = false;
+}
+
+
+bool Iq_Archive_Reader::read_index(uint64_t file_size)
+{
+    std::array<uint8_t, iq_archive::TRAILER_SIZE> trailer{};
+    if (file_size < iq_archive::FILE_HEADER_SIZE + iq_archive::TRAILER_SIZE or
+        not pread_all(d_fd, trailer.data(), trailer.size(), file_size - trailer.size()) or
+        std::memcmp(&trailer[8], TRAILER_MAGIC, 4) != 0)
+        {
+            return false;
+        }
+    const uint64_t index_offset = get_u64(trailer.data());
+    if (index_offset + 16 + iq_archive::TRAILER_SIZE > file_size)
+        {
+            return false;
+        }
+    std::vector<uint8_t> index(file_size - iq_archive::TRAILER_SIZE - index_offset);
+    if (not pread_all(d_fd, index.data(), index.size(), index_offset) or std::memcmp(index.data(), INDEX_MAGIC, 4) != 0)
+        {
+            return false;
+        }
+    const uint64_t n_chunks = get_u64(&index[8]);
+    if (index.size() != 16 + 16 * n_chunks)
+        {
+            return false;
+        }
+    for (uint64_t i = 0; i < n_chunks; i++)
+        {
+            d_offsets.push_back(get_u64(&index[16 + 16 * i]));
+            d_counters.push_back(get_u64(&index[24 + 16 * i]));
+        }
+
+    // chunk lengths follow from the counters, except for the last one
+    for (size_t i = 0; i + 1 < d_counters.size(); i++)
+        {
+            d_chunk_samples.push_back(static_cast<uint32_t>(d_counters[i + 1] - d_counters[i]));
+        }
+    if (not d_offsets.empty())
+        {
+            std::array<uint8_t, iq_archive::CHUNK_HEADER_SIZE> chunk_header{};
+            if (not pread_all(d_fd, chunk_header.data(), chunk_header.size(), d_offsets.back()))
+                {
+                    return false;
+                }
+            d_chunk_samples.push_back(get_u32(&chunk_header[4]));
+        }
+    d_samples = 0;
+    for (const auto n : d_chunk_samples)
+        {
+            d_samples += n;
+        }
+    return true;
+}
+
+
+void Iq_Archive_Reader::rebuild_index(uint64_t file_size)
+{
+    d_offsets.clear();
+    d_counters.clear();
+    d_chunk_samples.clear();
+    d_samples = 0;
+    uint64_t offset = d_header_size;
+    std::array<uint8_t, iq_archive::CHUNK_HEADER_SIZE> chunk_header{};
+    while (offset + chunk_header.size() <= file_size and pread_all(d_fd, chunk_header.data(), chunk_header.size(), offset))
+        {
+            const uint64_t next = offset + chunk_header.size() + get_u32(&chunk_header[16]);
+            if (std::memcmp(chunk_header.data(), CHUNK_MAGIC, 4) != 0 or next > file_size)
+                {
+                    break;  // truncated chunk
+                }
+            d_offsets.push_back(offset);
+            d_counters.push_back(get_u64(&chunk_header[8]));
+            d_chunk_samples.push_back(get_u32(&chunk_header[4]));
+            d_samples += d_chunk_samples.back();
+            offset = next;
+        }
+}
+
+
+uint32_t Iq_Archive_Reader::chunk_samples(size_t chunk) const
+{
+    return d_chunk_samples[chunk];
+}
+
+
+size_t Iq_Archive_Reader::chunk_for_sample(uint64_t sample) const
+{
+    if (sample >= d_samples)
+        {
+            return chunks();
+        }
+    // all the chunks but the last one have format().chunk_samples samples
+    const auto guess = static_cast<size_t>(sample / d_format.chunk_samples);
+    if (guess < chunks() and chunk_first_sample(guess) <= sample and sample < chunk_first_sample(guess) + d_chunk_samples[guess])
+        {
+            return guess;
+        }
+    const uint64_t counter = sample + d_format.first_sample_counter;
+    return static_cast<size_t>(std::upper_bound(d_counters.begin(), d_counters.end(), counter) - d_counters.begin()) - 1;
+}
+
+
+bool Iq_Archive_Reader::read_chunk(size_t chunk, std::vector<uint8_t>& data) const
+{
+    if (chunk >= chunks())
+        {
+            return false;
+        }
+    const uint64_t end = chunk + 1 < chunks() ? d_offsets[chunk + 1] : 0;
+    std::array<uint8_t, iq_archive::CHUNK_HEADER_SIZE> chunk_header{};
+    if (not pread_all(d_fd, chunk_header.data(), chunk_header.size(), d_offsets[chunk]))
+        {
+            return false;
+        }
+    const size_t size = chunk_header.size() + get_u32(&chunk_header[16]);
+    if (end != 0 and d_offsets[chunk] + size > end)
+        {
+            return false;
+        }
+    data.resize(size);
+    std::memcpy(data.data(), chunk_header.data(), chunk_header.size());
+    return pread_all(d_fd, data.data() + chunk_header.size(), size - chunk_header.size(), d_offsets[chunk] + chunk_header.size());
+}
@@ -0,0 +1,190 @@
+/*!
+ * \file iq_archive.h
+ * \brief Seekable container for recorded IQ samples, made of independently
+ * decodable chunks of bit-packed (and optionally entropy-coded) samples
+ * followed by an index.
+ *
+ * File layout (all fields little-endian):
+ *
+ *   File header (64 bytes): "GIQA", version, header size, number of
+ *   channels, bits per component, compression, samples per chunk,
+ *   sampling frequency, scale and the sample counter of the first sample.
+ *
+ *   Chunks: a 32-byte header ("CHNK", samples per channel, sample counter
+ *   of its first sample, stored and unpacked payload sizes, flags) and the
+ *   payload, which holds the samples of each channel one after the other,
+ *   as I and Q two's complement integers packed LSB first.
+ *
+ *   Index: "GIQX", number of chunks, and an (offset, sample counter) pair
+ *   per chunk, followed by a 16-byte trailer with the index offset and
+ *   "GIQE". If the recording was interrupted before the index was written,
+ *   the reader rebuilds it by walking the chunk headers.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_IQ_ARCHIVE_H
+#define GNSS_SDR_IQ_ARCHIVE_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+enum class Iq_Archive_Compression : uint8_t
+{
+    NONE = 0,
+    HUFFMAN = 1  // zlib Huffman-only coding of the packed bytes
+};
+
+/*!
+ * \brief Parameters stored in the file header
+ */
+struct Iq_Archive_Format
+{
+    uint16_t channels = 1;
+    uint8_t bits = 8;  // bits per I or Q component: 2, 4, 8 or 16
+    Iq_Archive_Compression compression = Iq_Archive_Compression::NONE;
+    uint32_t chunk_samples = 1048576;  // samples per channel in each chunk
+    double sampling_frequency = 0.0;
+    float scale = 1.0;  // integer value = round(scale * floating point value)
+    uint64_t first_sample_counter = 0;
+};
+
+
+/*!
+ * \brief Sample encoding and decoding, shared by the writer and the reader.
+ * All the functions are thread-safe.
+ */
+namespace iq_archive
+{
+const size_t FILE_HEADER_SIZE = 64;
+const size_t CHUNK_HEADER_SIZE = 32;
+const size_t TRAILER_SIZE = 16;
+
+bool has_compression_support();  //!< True if built with zlib
+
+size_t packed_size(uint32_t samples, uint8_t bits);  //!< Bytes taken by the samples of one channel
+
+/*!
+ * \brief Packs samples given as interleaved I and Q components, clipping
+ * them to the range of the given number of bits.
+ */
+void pack(const int16_t* components, uint32_t samples, uint8_t bits, uint8_t* out);
+
+void unpack(const uint8_t* in, uint32_t samples, uint8_t bits, float scale, std::complex<float>* out);
+void unpack(const uint8_t* in, uint32_t samples, uint8_t bits, std::complex<int16_t>* out);
+
+/*!
+ * \brief Builds a chunk (header and payload) from the interleaved I and Q
+ * components of each channel.
+ */
+void encode_chunk(const Iq_Archive_Format& format,
+    const std::vector<const int16_t*>& channels,
+    uint32_t samples,
+    uint64_t sample_counter,
+    std::vector<uint8_t>& chunk);
+
+/*!
+ * \brief Decodes a chunk read by Iq_Archive_Reader::read_chunk() into
+ * out, which holds the samples of each channel one after the other.
+ * Returns false if the chunk is corrupted.
+ */
+bool decode_chunk(const Iq_Archive_Format& format, const std::vector<uint8_t>& chunk, std::vector<std::complex<float>>& out);
+bool decode_chunk(const Iq_Archive_Format& format, const std::vector<uint8_t>& chunk, std::vector<std::complex<int16_t>>& out);
+}  // namespace iq_archive
+
+
+/*!
+ * \brief Writes chunks to a new archive, and the index when it is closed.
+ */
+class Iq_Archive_Writer
+{
+public:
+    Iq_Archive_Writer() = default;
+    ~Iq_Archive_Writer();
+
+    bool open(const std::string& filename, const Iq_Archive_Format& format);
+
+    /*!
+     * \brief Appends a chunk built by iq_archive::encode_chunk()
+     */
+    bool write_chunk(const std::vector<uint8_t>& chunk);
+
+    /*!
+     * \brief Writes the index and closes the file
+     */
+    bool close();
+
+    inline uint64_t chunks() const { return d_offsets.size(); }
+
+private:
+    FILE* d_file = nullptr;
+    uint64_t d_position = 0;
+    std::vector<uint64_t> d_offsets;
+    std::vector<uint64_t> d_counters;
+};
+
+
+/*!
+ * \brief Gives random access to the chunks of an archive. Chunks can be
+ * read from several threads at once.
+ */
+class Iq_Archive_Reader
+{
+public:
+    Iq_Archive_Reader() = default;
+    ~Iq_Archive_Reader();
+
+    bool open(const std::string& filename);
+    void close();
+
+    inline const Iq_Archive_Format& format() const { return d_format; }
+    inline size_t chunks() const { return d_offsets.size(); }
+    inline uint64_t samples() const { return d_samples; }                         //!< Samples per channel
+    inline bool index_rebuilt() const { return d_index_rebuilt; }                 //!< True if the file had no index
+    inline uint64_t chunk_counter(size_t chunk) const { return d_counters[chunk]; }  //!< Timestamp of the chunk
+
+    /*!
+     * \brief Position of the first sample of a chunk, counted from the first
+     * sample of the file.
+     */
+    inline uint64_t chunk_first_sample(size_t chunk) const { return d_counters[chunk] - d_format.first_sample_counter; }
+
+    uint32_t chunk_samples(size_t chunk) const;
+
+    /*!
+     * \brief Chunk that contains a sample, or chunks() if it is past the end
+     */
+    size_t chunk_for_sample(uint64_t sample) const;
+
+    bool read_chunk(size_t chunk, std::vector<uint8_t>& data) const;
+
+private:
+    bool read_index(uint64_t file_size);
+    void rebuild_index(uint64_t file_size);
+
+    int d_fd = -1;
+    uint16_t d_header_size = 0;
+    Iq_Archive_Format d_format;
+    std::vector<uint64_t> d_offsets;
+    std::vector<uint64_t> d_counters;
+    std::vector<uint32_t> d_chunk_samples;
+    uint64_t d_samples = 0;
+    bool d_index_rebuilt = false;
+};
+
+#endif  // GNSS_SDR_IQ_ARCHIVE_H
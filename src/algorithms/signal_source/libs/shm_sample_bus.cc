@@ -0,0 +1,318 @@
+/*!
+ * \file shm_sample_bus.cc
+ * \brief Ring buffer of samples in POSIX shared memory, written by one
+ * process and read by any number of other processes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "shm_sample_bus.h"
+#include <glog/logging.h>
+#include <fcntl.h>     // for O_CREAT, O_RDWR
+#include <sys/mman.h>  // for mmap, shm_open, shm_unlink
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for ftruncate, close
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+#if defined(__linux__)
+#include <linux/futex.h>  // for FUTEX_WAIT, FUTEX_WAKE
+#include <sys/syscall.h>  // for SYS_futex
+#include <ctime>
+#endif
+
+
+namespace
+{
+const uint32_t BUS_MAGIC = 0x53425347;  // "GSBS"
+const uint32_t BUS_VERSION = 1;
+const size_t DATA_OFFSET = 4096;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the sample bus needs lock-free 64-bit atomics");
+
+
+void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms)
+{
+#if defined(__linux__)
+    struct timespec timeout
+    {
+    };
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = static_cast<int64_t>(timeout_ms % 1000) * 1000000;
+    // not FUTEX_PRIVATE_FLAG: the word is shared between processes
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#else
+    if (word->load() == expected)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(timeout_ms, 1)));
+        }
+#endif
+}
+
+
+void futex_wake(std::atomic<uint32_t>* word)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+}  // namespace
+
+
+Shm_Sample_Bus_Writer::~Shm_Sample_Bus_Writer()
+{
+    close();
+}
+
+
+bool Shm_Sample_Bus_Writer::create(const std::string& name, size_t item_size, uint64_t capacity, double sampling_frequency)
+{
+    close();
+    uint64_t items = 1024;
+    while (items < capacity)
+        {
+            items <<= 1U;
+        }
+
+    shm_unlink(name.c_str());  // a writer that crashed may have left it behind
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        {
+            LOG(WARNING) << "Unable to create the shared memory sample bus " << name << ": " << std::strerror(errno);
+            return false;
+        }
+    d_map_size = DATA_OFFSET + items * item_size;
+    if (ftruncate(fd, static_cast<off_t>(d_map_size)) != 0)
+        {
+            LOG(WARNING) << "Unable to allocate " << d_map_size << " bytes for the sample bus " << name;
+            ::close(fd);
+            shm_unlink(name.c_str());
+            return false;
+        }
+    d_map = mmap(nullptr, d_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (d_map == MAP_FAILED)
+        {
+            d_map = nullptr;
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+    d_name = name;
+    d_header = new (d_map) Shm_Sample_Bus_Header();
+    d_header->version = BUS_VERSION;
+    d_header->item_size = static_cast<uint32_t>(item_size);
+    d_header->capacity = items;
+    d_header->sampling_frequency = sampling_frequency;
+    d_header->write_claim.store(0);
+    d_header->write_counter.store(0);
+    d_header->sequence.store(0);
+    d_header->waiters.store(0);
+    d_header->closed.store(0);
+    d_data = static_cast<uint8_t*>(d_map) + DATA_OFFSET;
+    d_item_size = item_size;
+    d_mask = items - 1;
+    d_counter = 0;
+    d_header->magic.store(BUS_MAGIC, std::memory_order_release);
+    return true;
+}
+
+
+void Shm_Sample_Bus_Writer::write(const void* items, uint64_t n)
+{
+    if (d_header == nullptr or n == 0)
+        {
+            return;
+        }
+    const auto* in = static_cast<const uint8_t*>(items);
+    const uint64_t capacity = d_mask + 1;
+    if (n > capacity)
+        {
+            // only the last ring of items can be kept
+            in += (n - capacity) * d_item_size;
+            d_counter += n - capacity;
+            n = capacity;
+        }
+
+    // Readers copy optimistically, and check write_claim afterwards to know
+    // which of the items they copied may have been overwritten meanwhile.
+    d_header->write_claim.store(d_counter + n, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint64_t position = d_counter & d_mask;
+    const uint64_t first = std::min(n, capacity - position);
+    std::memcpy(d_data + position * d_item_size, in, first * d_item_size);
+    if (first < n)
+        {
+            std::memcpy(d_data, in + first * d_item_size, (n - first) * d_item_size);
+        }
+    d_counter += n;
+    d_header->write_counter.store(d_counter, std::memory_order_release);
+
+    d_header->sequence.fetch_add(1);
+    if (d_header->waiters.load() > 0)
+        {
+            futex_wake(&d_header->sequence);
+        }
+}
+
+
+void Shm_Sample_Bus_Writer::close()
+{
+    if (d_header == nullptr)
+        {
+            return;
+        }
+    d_header->closed.store(1);
+    d_header->sequence.fetch_add(1);
+    futex_wake(&d_header->sequence);
+    munmap(d_map, d_map_size);
+    shm_unlink(d_name.c_str());
+    d_map = nullptr;
+    d_header = nullptr;
+    d_data = nullptr;
+}
+
+
+Shm_Sample_Bus_Reader::~Shm_Sample_Bus_Reader()
+{
+    detach();
+}
+
+
+bool Shm_Sample_Bus_Reader::attach(const std::string& name)
+{
+    detach();
+    // readers register themselves as waiters, so they map the bus writable
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        {
+            return false;
+        }
+    struct stat file_status
+    {
+    };
+    if (fstat(fd, &file_status) != 0 or static_cast<size_t>(file_status.st_size) < DATA_OFFSET)
+        {
+            ::close(fd);
+            return false;
+        }
+    d_map_size = static_cast<size_t>(file_status.st_size);
+    d_map = mmap(nullptr, d_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (d_map == MAP_FAILED)
+        {
+            d_map = nullptr;
+            return false;
+        }
+    d_header = static_cast<Shm_Sample_Bus_Header*>(d_map);
+    if (d_header->magic.load(std::memory_order_acquire) != BUS_MAGIC or
+        d_header->version != BUS_VERSION or
+        DATA_OFFSET + d_header->capacity * d_header->item_size > d_map_size)
+        {
+            LOG(WARNING) << name << " is not a GNSS-SDR sample bus";
+            detach();
+            return false;
+        }
+    d_data = static_cast<const uint8_t*>(d_map) + DATA_OFFSET;
+    d_mask = d_header->capacity - 1;
+    d_counter = d_header->write_counter.load(std::memory_order_acquire);
+    return true;
+}
+
+
+void Shm_Sample_Bus_Reader::detach()
+{
+    if (d_map != nullptr)
+        {
+            munmap(d_map, d_map_size);
+        }
+    d_map = nullptr;
+    d_header = nullptr;
+    d_data = nullptr;
+}
+
+
+bool Shm_Sample_Bus_Reader::finished() const
+{
+    return d_header->closed.load() != 0 and d_header->write_counter.load(std::memory_order_acquire) == d_counter;
+}
+
+
+uint64_t Shm_Sample_Bus_Reader::wait(int timeout_ms)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true)
+        {
+            const uint32_t sequence = d_header->sequence.load();
+            const uint64_t available = d_header->write_counter.load(std::memory_order_acquire) - d_counter;
+            if (available > 0 or d_header->closed.load() != 0)
+                {
+                    return available;
+                }
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0)
+                {
+                    return 0;
+                }
+            d_header->waiters.fetch_add(1);
+            futex_wait(&d_header->sequence, sequence, static_cast<int>(remaining));
+            d_header->waiters.fetch_sub(1);
+        }
+}
+
+
+uint64_t Shm_Sample_Bus_Reader::read(void* out, uint64_t max_items, uint64_t& lost, uint64_t& zeroed)
+{
+    lost = 0;
+    zeroed = 0;
+    const uint64_t capacity = d_mask + 1;
+    const uint64_t written = d_header->write_counter.load(std::memory_order_acquire);
+    if (written - d_counter > capacity)
+        {
+            // Overrun: resume half a ring behind the writer, to leave some
+            // room before it catches up again.
+            lost = written - capacity / 2 - d_counter;
+            d_counter += lost;
+            return 0;
+        }
+
+    const size_t item_size = d_header->item_size;
+    const uint64_t n = std::min(max_items, written - d_counter);
+    const uint64_t position = d_counter & d_mask;
+    const uint64_t first = std::min(n, capacity - position);
+    auto* dest = static_cast<uint8_t*>(out);
+    std::memcpy(dest, d_data + position * item_size, first * item_size);
+    if (first < n)
+        {
+            std::memcpy(dest + first * item_size, d_data, (n - first) * item_size);
+        }
+
+    // items below claim - capacity may have been overwritten during the copy
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t claim = d_header->write_claim.load(std::memory_order_relaxed);
+    if (claim - d_counter > capacity)
+        {
+            zeroed = std::min(n, claim - capacity - d_counter);
+            std::memset(dest, 0, zeroed * item_size);
+        }
+    d_counter += n;
+    return n;
+}
@@ -0,0 +1,146 @@
+/*!
+ * \file shm_sample_bus.h
+ * \brief Ring buffer of samples in POSIX shared memory, written by one
+ * process and read by any number of other processes.
+ *
+ * The writer never waits for the readers: each reader keeps its own read
+ * position, and detects that it was overrun when the writer is more than
+ * one ring ahead of it. Items are identified by a sample counter, the
+ * number of items written since the bus was created, so readers always
+ * know how many samples they have lost. Readers sleep on a futex that the
+ * writer only wakes up when somebody is waiting.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SHM_SAMPLE_BUS_H
+#define GNSS_SDR_SHM_SAMPLE_BUS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*!
+ * \brief Layout of the beginning of the shared memory segment
+ */
+struct Shm_Sample_Bus_Header
+{
+    std::atomic<uint32_t> magic;  // written last by the writer
+    uint32_t version;
+    uint32_t item_size;
+    uint32_t reserved;
+    uint64_t capacity;  // in items, a power of two
+    double sampling_frequency;
+    alignas(64) std::atomic<uint64_t> write_claim;    // items that are being written or were written
+    alignas(64) std::atomic<uint64_t> write_counter;  // items that can be read
+    alignas(64) std::atomic<uint32_t> sequence;       // futex word, increased on each write
+    std::atomic<uint32_t> waiters;                    // readers sleeping on the futex
+    std::atomic<uint32_t> closed;                     // set when the writer goes away
+};
+
+
+/*!
+ * \brief Creates a bus and publishes items on it
+ */
+class Shm_Sample_Bus_Writer
+{
+public:
+    Shm_Sample_Bus_Writer() = default;
+    ~Shm_Sample_Bus_Writer();
+
+    /*!
+     * \brief Creates the shared memory segment name (e.g. "/gnss-sdr-bus"),
+     * replacing any previous one, with room for at least capacity items.
+     */
+    bool create(const std::string& name, size_t item_size, uint64_t capacity, double sampling_frequency);
+
+    /*!
+     * \brief Appends n items to the ring. Never blocks.
+     */
+    void write(const void* items, uint64_t n);
+
+    /*!
+     * \brief Tells the readers that no more items will come and removes the
+     * segment name. Readers that are attached keep their mapping.
+     */
+    void close();
+
+    inline uint64_t counter() const { return d_counter; }  //!< Items written so far
+    inline uint64_t capacity() const { return d_mask + 1; }
+
+private:
+    std::string d_name;
+    void* d_map = nullptr;
+    size_t d_map_size = 0;
+    Shm_Sample_Bus_Header* d_header = nullptr;
+    uint8_t* d_data = nullptr;
+    size_t d_item_size = 0;
+    uint64_t d_mask = 0;
+    uint64_t d_counter = 0;
+};
+
+
+/*!
+ * \brief Attaches to an existing bus and reads its items in order
+ */
+class Shm_Sample_Bus_Reader
+{
+public:
+    Shm_Sample_Bus_Reader() = default;
+    ~Shm_Sample_Bus_Reader();
+
+    /*!
+     * \brief Maps the bus. Reading starts with the next item written.
+     */
+    bool attach(const std::string& name);
+    void detach();
+
+    inline size_t item_size() const { return d_header->item_size; }
+    inline double sampling_frequency() const { return d_header->sampling_frequency; }
+    inline uint64_t capacity() const { return d_header->capacity; }
+    inline uint64_t counter() const { return d_counter; }  //!< Sample counter of the next item to read
+
+    /*!
+     * \brief True if the writer closed the bus and all its items were read
+     */
+    bool finished() const;
+
+    /*!
+     * \brief Sleeps until there are items to read, the writer closes the
+     * bus, or timeout_ms milliseconds have passed. Returns the number of
+     * items available.
+     */
+    uint64_t wait(int timeout_ms);
+
+    /*!
+     * \brief Copies up to max_items items into out, and returns how many.
+     *
+     * If the writer overran this reader, lost is set to the number of items
+     * skipped. They come before the ones returned in the counter sequence,
+     * and nothing is copied. Items that were overwritten while being copied
+     * are replaced by zeros, and their number is stored in zeroed.
+     */
+    uint64_t read(void* out, uint64_t max_items, uint64_t& lost, uint64_t& zeroed);
+
+private:
+    void* d_map = nullptr;
+    size_t d_map_size = 0;
+    Shm_Sample_Bus_Header* d_header = nullptr;
+    const uint8_t* d_data = nullptr;
+    uint64_t d_mask = 0;
+    uint64_t d_counter = 0;
+};
+
+#endif  // GNSS_SDR_SHM_SAMPLE_BUS_H
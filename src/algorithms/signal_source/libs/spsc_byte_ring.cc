@@ -0,0 +1,67 @@
+/*!
+ * \file spsc_byte_ring.cc
+ * \brief Lock-free single-producer, single-consumer ring buffer of bytes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "spsc_byte_ring.h"
+#include <algorithm>
+#include <cstring>
+
+
+Spsc_Byte_Ring::Spsc_Byte_Ring(size_t min_capacity) : d_write_index(0),
+                                                     d_shared_write_index(0),
+                                                     d_padding0{},
+                                                     d_consumer_read_index(0),
+                                                     d_read_index(0),
+                                                     d_padding1{}
+{
+    size_t capacity = 4096;
+    while (capacity < min_capacity)
+        {
+            capacity <<= 1U;
+        }
+    d_buffer = std::vector<uint8_t>(capacity, 0);
+    d_mask = capacity - 1;
+}
+
+
+void Spsc_Byte_Ring::compact(size_t from_offset, size_t to_offset, size_t size)
+{
+    // forward copy, regions may overlap and wrap around the end of the buffer
+    for (size_t i = 0; i < size; i++)
+        {
+            d_buffer[(d_write_index + to_offset + i) & d_mask] = d_buffer[(d_write_index + from_offset + i) & d_mask];
+        }
+}
+
+
+bool Spsc_Byte_Ring::push(const uint8_t* data, size_t size)
+{
+    if (size > free_space())
+        {
+            return false;
+        }
+    size_t contiguous;
+    uint8_t* dest = writable(0, contiguous);
+    const size_t first = std::min(size, contiguous);
+    std::memcpy(dest, data, first);
+    if (first < size)
+        {
+            std::memcpy(&d_buffer[0], data + first, size - first);
+        }
+    commit(size);
+    return true;
+}
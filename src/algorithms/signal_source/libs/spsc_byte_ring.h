@@ -0,0 +1,139 @@
+/*!
+ * \file spsc_byte_ring.h
+ * \brief Lock-free single-producer, single-consumer ring buffer of bytes.
+ *
+ * The producer and the consumer run in different threads and never block
+ * each other: each one owns its index, and reads the index of the other one
+ * with acquire semantics.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SPSC_BYTE_RING_H
+#define GNSS_SDR_SPSC_BYTE_RING_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief Ring buffer of bytes shared by one producer and one consumer thread.
+ *
+ * Its capacity is a power of two. The producer can either copy data into
+ * the ring with push(), or let a system call write directly into the free
+ * space returned by writable(), and then publish it with commit().
+ */
+class Spsc_Byte_Ring
+{
+public:
+    /*!
+     * \brief Allocates a ring of at least min_capacity bytes.
+     */
+    explicit Spsc_Byte_Ring(size_t min_capacity);
+
+    inline size_t capacity() const
+    {
+        return d_mask + 1;
+    }
+
+    // Producer side
+
+    /*!
+     * \brief Bytes that can be written without overwriting unread data.
+     */
+    inline size_t free_space() const
+    {
+        return capacity() - (d_write_index - d_read_index.load(std::memory_order_acquire));
+    }
+
+    /*!
+     * \brief Returns a pointer to the byte at offset from the write position,
+     * and stores in contiguous the number of bytes that follow it up to
+     * the end of the buffer.
+     */
+    inline uint8_t* writable(size_t offset, size_t& contiguous)
+    {
+        const size_t position = (d_write_index + offset) & d_mask;
+        contiguous = capacity() - position;
+        return &d_buffer[position];
+    }
+
+    /*!
+     * \brief Moves size bytes written (and not committed yet) at offset from
+     * the write position to to_offset, with to_offset < from_offset.
+     */
+    void compact(size_t from_offset, size_t to_offset, size_t size);
+
+    /*!
+     * \brief Copies size bytes into the ring. Returns false, without
+     * writing anything, if they do not fit.
+     */
+    bool push(const uint8_t* data, size_t size);
+
+    /*!
+     * \brief Makes size bytes written at the write position visible to
+     * the consumer.
+     */
+    inline void commit(size_t size)
+    {
+        d_write_index += size;
+        d_shared_write_index.store(d_write_index, std::memory_order_release);
+    }
+
+    // Consumer side
+
+    /*!
+     * \brief Bytes ready to be read.
+     */
+    inline size_t available() const
+    {
+        return d_shared_write_index.load(std::memory_order_acquire) - d_consumer_read_index;
+    }
+
+    /*!
+     * \brief Byte at offset from the read position. The offset must be lower
+     * than the last value returned by available().
+     */
+    inline uint8_t peek(size_t offset) const
+    {
+        return d_buffer[(d_consumer_read_index + offset) & d_mask];
+    }
+
+    /*!
+     * \brief Releases size bytes to the producer.
+     */
+    inline void consume(size_t size)
+    {
+        d_consumer_read_index += size;
+        d_read_index.store(d_consumer_read_index, std::memory_order_release);
+    }
+
+private:
+    std::vector<uint8_t> d_buffer;
+    size_t d_mask;
+
+    // owned by the producer
+    uint64_t d_write_index;
+    std::atomic<uint64_t> d_shared_write_index;
+    std::array<char, 64> d_padding0;
+
+    // owned by the consumer
+    uint64_t d_consumer_read_index;
+    std::atomic<uint64_t> d_read_index;
+    std::array<char, 64> d_padding1;
+};
+
+#endif  // GNSS_SDR_SPSC_BYTE_RING_H
@@ -91,6 +91,12 @@ void GalileoE1DllPllVemlTracking::stop_tracking()
 }
 
 
+bool GalileoE1DllPllVemlTracking::reduce_correlators(bool reduce)
+{
+    return tracking_->reduce_correlators(reduce);
+}
+
+
 void GalileoE1DllPllVemlTracking::start_tracking()
 {
     tracking_->start_tracking();
@@ -87,6 +87,11 @@ public:
      */
     void stop_tracking() override;
 
+    /*!
+     * \brief Computes only the Early, Prompt and Late taps
+     */
+    bool reduce_correlators(bool reduce) override;
+
 private:
     dll_pll_veml_tracking_sptr tracking_;
     size_t item_size_;
@@ -41,6 +41,7 @@
 #include "gps_l2c_signal.h"
 #include "gps_l5_signal.h"
 #include "gps_sdr_signal_processing.h"
+#include "latency_tracer.h"
 #include "lock_detectors.h"
 #include "tracking_discriminators.h"
 #include <glog/logging.h>
@@ -365,6 +366,9 @@ dll_pll_veml_tracking::dll_pll_veml_tracking(const Dll_Pll_Conf &conf_) : gr::bl
     // Get space for a vector with the sinboc(1,1) replica sampled 2x/chip
     d_tracking_code.resize(2 * d_code_length_chips, 0.0);
     // correlator outputs (scalar)
+    d_veml_taps = d_veml;
+    d_reduced_correlators = false;
+    d_reduce_correlators = false;
     if (d_veml)
         {
             // Very-Early, Early, Prompt, Late, Very-Late
@@ -725,7 +729,7 @@ void dll_pll_veml_tracking::start_tracking()
     d_carrier_lock_test = 1.0;
     d_CN0_SNV_dB_Hz = 0.0;
 
-    if (d_veml)
+    if (d_veml_taps)
         {
             d_local_code_shift_chips[0] = -trk_parameters.very_early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
             d_local_code_shift_chips[1] = -trk_parameters.early_late_space_chips * static_cast<float>(d_code_samples_per_chip);
@@ -1588,6 +1592,17 @@ void dll_pll_veml_tracking::stop_tracking()
 }
 
 
+bool dll_pll_veml_tracking::reduce_correlators(bool reduce)
+{
+    if (!d_veml_taps)
+        {
+            return false;
+        }
+    d_reduce_correlators.store(reduce, std::memory_order_relaxed);
+    return true;
+}
+
+
 int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)), gr_vector_int &ninput_items,
     gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
@@ -1606,6 +1621,23 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                     d_code_lock_fail_counter = 0;
                 }
         }
+    // switch between integration periods, so that all the accumulators hold
+    // the same correlation time: an extended integration starts in state 3
+    // and ends in state 4
+    const bool integration_start = (d_state == 3) ? (d_extend_correlation_symbols_count == 0) : (d_state != 4 or !d_enable_extended_integration);
+    if (d_reduce_correlators.load(std::memory_order_relaxed) != d_reduced_correlators and integration_start)
+        {
+            d_reduced_correlators = !d_reduced_correlators;
+            d_veml = !d_reduced_correlators;
+            if (d_reduced_correlators)
+                {
+                    multicorrelator_cpu.set_active_correlators(1, 3);  // Early, Prompt and Late
+                }
+            else
+                {
+                    multicorrelator_cpu.set_active_correlators(0, d_n_correlator_taps);
+                }
+        }
     switch (d_state)
         {
         case 0:  // Standby - Consume samples at full throttle, do nothing
@@ -1759,7 +1791,7 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
                                         d_code_loop_filter.set_update_interval(d_current_correlation_time_s);
                                         d_code_loop_filter.set_noise_bandwidth(trk_parameters.dll_bw_narrow_hz);
                                         d_carrier_loop_filter.set_params(trk_parameters.fll_bw_hz, trk_parameters.pll_bw_narrow_hz, trk_parameters.pll_filter_order);
-                                        if (d_veml)
+                                        if (d_veml_taps)
                                             {
                                                 d_local_code_shift_chips[0] = -trk_parameters.very_early_late_space_narrow_chips * static_cast<float>(d_code_samples_per_chip);
                                                 d_local_code_shift_chips[1] = -trk_parameters.early_late_space_narrow_chips * static_cast<float>(d_code_samples_per_chip);
@@ -1888,6 +1920,10 @@ int dll_pll_veml_tracking::general_work(int noutput_items __attribute__((unused)
             current_synchro_data.fs = static_cast<int64_t>(trk_parameters.fs_in);
             current_synchro_data.Tracking_sample_counter = d_sample_counter;
             *out[0] = current_synchro_data;
+            if (Latency_Tracer::instance().enabled())
+                {
+                    Latency_Tracer::instance().record(Latency_Tracer::Tracking, d_sample_counter, static_cast<int32_t>(d_channel));
+                }
             return 1;
         }
     return 0;
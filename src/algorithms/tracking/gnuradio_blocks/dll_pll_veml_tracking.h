@@ -32,6 +32,7 @@
 #include <gnuradio/types.h>                   // for gr_vector_int, gr_vector...
 #include <pmt/pmt.h>                          // for pmt_t
 #include <volk_gnsssdr/volk_gnsssdr_alloc.h>  // for volk_gnsssdr::vector
+#include <atomic>                             // for atomic
 #include <cstdint>                            // for int32_t
 #include <fstream>                            // for string, ofstream
 #include <string>
@@ -67,6 +68,14 @@ public:
     void start_tracking();
     void stop_tracking();
 
+    /*!
+     * \brief Requests to compute only the Early, Prompt and Late taps of a
+     * VEML tracking, with an E-L discriminator. It takes effect at the start
+     * of the next integration period (the whole extended one, if enabled).
+     * Returns false if the tracking has no taps to drop.
+     */
+    bool reduce_correlators(bool reduce);
+
     int general_work(int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
@@ -90,7 +99,10 @@ private:
 
     // tracking configuration vars
     Dll_Pll_Conf trk_parameters;
-    bool d_veml;
+    bool d_veml;       // the DLL uses the Very-Early and Very-Late taps
+    bool d_veml_taps;  // the Very-Early and Very-Late taps exist
+    bool d_reduced_correlators;
+    std::atomic<bool> d_reduce_correlators;  // requested from other threads
     bool d_cloop;
     uint32_t d_channel;
     Gnss_Synchro *d_acquisition_gnss_synchro;
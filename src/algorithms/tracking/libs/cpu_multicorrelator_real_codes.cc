@@ -35,6 +35,8 @@ Cpu_Multicorrelator_Real_Codes::Cpu_Multicorrelator_Real_Codes()
     d_local_codes_resampled = nullptr;
     d_code_length_chips = 0;
     d_n_correlators = 0;
+    d_first_active_correlator = 0;
+    d_n_active_correlators = 0;
     d_use_high_dynamics_resampler = true;
 }
 
@@ -61,6 +63,8 @@ bool Cpu_Multicorrelator_Real_Codes::init(
             d_local_codes_resampled[n] = static_cast<float*>(volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
         }
     d_n_correlators = n_correlators;
+    d_first_active_correlator = 0;
+    d_n_active_correlators = n_correlators;
     return true;
 }
 
@@ -87,29 +91,41 @@ bool Cpu_Multicorrelator_Real_Codes::set_input_output_vectors(std::complex<float
 }
 
 
+bool Cpu_Multicorrelator_Real_Codes::set_active_correlators(int first_correlator, int n_active_correlators)
+{
+    if (first_correlator < 0 or n_active_correlators < 1 or first_correlator + n_active_correlators > d_n_correlators)
+        {
+            return false;
+        }
+    d_first_active_correlator = first_correlator;
+    d_n_active_correlators = n_active_correlators;
+    return true;
+}
+
+
 void Cpu_Multicorrelator_Real_Codes::update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips, float code_phase_rate_step_chips)
 {
     if (d_use_high_dynamics_resampler)
         {
-            volk_gnsssdr_32f_xn_high_dynamics_resampler_32f_xn(d_local_codes_resampled,
+            volk_gnsssdr_32f_xn_high_dynamics_resampler_32f_xn(d_local_codes_resampled + d_first_active_correlator,
                 d_local_code_in,
                 rem_code_phase_chips,
                 code_phase_step_chips,
                 code_phase_rate_step_chips,
-                d_shifts_chips,
+                d_shifts_chips + d_first_active_correlator,
                 d_code_length_chips,
-                d_n_correlators,
+                d_n_active_correlators,
                 correlator_length_samples);
         }
     else
         {
-            volk_gnsssdr_32f_xn_resampler_32f_xn(d_local_codes_resampled,
+            volk_gnsssdr_32f_xn_resampler_32f_xn(d_local_codes_resampled + d_first_active_correlator,
                 d_local_code_in,
                 rem_code_phase_chips,
                 code_phase_step_chips,
-                d_shifts_chips,
+                d_shifts_chips + d_first_active_correlator,
                 d_code_length_chips,
-                d_n_correlators,
+                d_n_active_correlators,
                 correlator_length_samples);
         }
 }
@@ -131,11 +147,11 @@ bool Cpu_Multicorrelator_Real_Codes::Carrier_wipeoff_multicorrelator_resampler(
     // call VOLK_GNSSSDR kernel
     if (d_use_high_dynamics_resampler)
         {
-            volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), std::exp(lv_32fc_t(0.0, -phase_rate_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+            volk_gnsssdr_32fc_32f_high_dynamic_rotator_dot_prod_32fc_xn(d_corr_out + d_first_active_correlator, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), std::exp(lv_32fc_t(0.0, -phase_rate_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled + d_first_active_correlator), d_n_active_correlators, signal_length_samples);
         }
     else
         {
-            volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+            volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out + d_first_active_correlator, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled + d_first_active_correlator), d_n_active_correlators, signal_length_samples);
         }
     return true;
 }
@@ -154,7 +170,7 @@ bool Cpu_Multicorrelator_Real_Codes::Carrier_wipeoff_multicorrelator_resampler(
     lv_32fc_t phase_offset_as_complex[1];
     phase_offset_as_complex[0] = lv_cmake(std::cos(rem_carrier_phase_in_rad), -std::sin(rem_carrier_phase_in_rad));
     // call VOLK_GNSSSDR kernel
-    volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled), d_n_correlators, signal_length_samples);
+    volk_gnsssdr_32fc_32f_rotator_dot_prod_32fc_xn(d_corr_out + d_first_active_correlator, d_sig_in, std::exp(lv_32fc_t(0.0, -phase_step_rad)), phase_offset_as_complex, const_cast<const float**>(d_local_codes_resampled + d_first_active_correlator), d_n_active_correlators, signal_length_samples);
     return true;
 }
 
@@ -53,6 +53,8 @@ public:
     virtual float property(std::string property_name, float default_value) = 0;
     virtual double property(std::string property_name, double default_value) = 0;
     virtual void set_property(std::string property_name, std::string value) = 0;
+    virtual void supersede_property(const std::string& property_name, const std::string& value) = 0;  // set_property() keeps the current value
+    virtual void erase_property(const std::string& property_name) = 0;
 };
 
 #endif  // GNSS_SDR_CONFIGURATION_INTERFACE_H
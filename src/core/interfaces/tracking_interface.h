@@ -48,6 +48,16 @@ public:
     virtual void stop_tracking() = 0;
     virtual void set_gnss_synchro(Gnss_Synchro* gnss_synchro) = 0;
     virtual void set_channel(unsigned int channel) = 0;
+
+    /*!
+     * \brief Drops (or restores) the correlator taps that are not essential
+     * to keep the lock, to save processing load. Returns false if the
+     * tracking block has no taps to drop.
+     */
+    virtual bool reduce_correlators(bool reduce __attribute__((unused)))
+    {
+        return false;
+    }
 };
 
 #endif  // GNSS_SDR_TRACKING_INTERFACE_H
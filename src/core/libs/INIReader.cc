@@ -62,6 +62,18 @@ int64_t INIReader::GetInteger(const std::string& section, const std::string& nam
 }
 
 
+std::vector<std::string> INIReader::GetNames(const std::string& section) const
+{
+    const std::string prefix = MakeKey(section, "");
+    std::vector<std::string> names;
+    for (auto it = _values.lower_bound(prefix); it != _values.end() and it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+        {
+            names.push_back(it->first.substr(prefix.size()));
+        }
+    return names;
+}
+
+
 std::string INIReader::MakeKey(const std::string& section, const std::string& name)
 {
     std::string key = section + "." + name;
@@ -31,6 +31,7 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 /*!
  * \brief Read an INI file into easy-to-access name/value pairs. (Note that I've gone
@@ -52,6 +53,9 @@ public:
     //! Get an integer (long) value from INI file, returning default_value if not found.
     int64_t GetInteger(const std::string& section, const std::string& name, int64_t default_value);
 
+    //! Return the names defined in a section, in lower case.
+    std::vector<std::string> GetNames(const std::string& section) const;
+
 private:
     int _error;
     std::map<std::string, std::string> _values;
@@ -20,6 +20,7 @@
 
 #include "gnss_sdr_sample_counter.h"
 #include "gnss_synchro.h"
+#include "latency_tracer.h"
 #include <gnuradio/io_signature.h>
 #include <pmt/pmt.h>        // for from_double
 #include <pmt/pmt_sugar.h>  // for mp
@@ -51,6 +52,7 @@ gnss_sdr_sample_counter::gnss_sdr_sample_counter(
     flag_m = false;
     flag_h = false;
     flag_days = false;
+    Latency_Tracer::instance().set_source(samples_per_output, interval_ms);
 }
 
 
@@ -131,6 +133,11 @@ int gnss_sdr_sample_counter::work(int noutput_items __attribute__((unused)),
         }
     sample_counter += samples_per_output;
     out[0].Tracking_sample_counter = sample_counter;
+    if (Latency_Tracer::instance().enabled())
+        {
+            // the samples up to sample_counter have left the signal source
+            Latency_Tracer::instance().mark_source(sample_counter);
+        }
     current_T_rx_ms += interval_ms;
     return 1;
 }
@@ -52,6 +52,11 @@ public:
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items);
 
+    inline double sampling_frequency() const
+    {
+        return fs;
+    }
+
 private:
     friend gnss_sdr_sample_counter_sptr gnss_sdr_make_sample_counter(
         double _fs,
@@ -0,0 +1,32 @@
+/*!
+ * \file reconfiguration_event.cc
+ * \brief Class that defines a request to rebuild a channel or a signal
+ * conditioner while the receiver is running
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "reconfiguration_event.h"
+
+reconfiguration_event_sptr reconfiguration_event_make(bool conditioner, unsigned int block_id, std::vector<std::pair<std::string, std::string>> properties)
+{
+    return reconfiguration_event_sptr(new Reconfiguration_Event(conditioner, block_id, std::move(properties)));
+}
+
+Reconfiguration_Event::Reconfiguration_Event(bool conditioner_, unsigned int block_id_, std::vector<std::pair<std::string, std::string>> properties_)
+{
+    conditioner = conditioner_;
+    block_id = block_id_;
+    properties = std::move(properties_);
+}
@@ -0,0 +1,53 @@
+/*!
+ * \file reconfiguration_event.h
+ * \brief Class that defines a request to rebuild a channel or a signal
+ * conditioner while the receiver is running
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RECONFIGURATION_EVENT_H
+#define GNSS_SDR_RECONFIGURATION_EVENT_H
+
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Reconfiguration_Event;
+
+using reconfiguration_event_sptr = std::shared_ptr<Reconfiguration_Event>;
+
+reconfiguration_event_sptr reconfiguration_event_make(bool conditioner, unsigned int block_id, std::vector<std::pair<std::string, std::string>> properties);
+
+/*!
+ * \brief Sent by the telecommand interface to the control thread, which
+ * rebuilds the block and sets the result: an empty string if it succeeded,
+ * or the error otherwise
+ */
+class Reconfiguration_Event
+{
+public:
+    bool conditioner;  // a signal conditioner instead of a channel
+    unsigned int block_id;
+    std::vector<std::pair<std::string, std::string>> properties;
+    std::promise<std::string> result;
+
+private:
+    friend reconfiguration_event_sptr reconfiguration_event_make(bool conditioner, unsigned int block_id, std::vector<std::pair<std::string, std::string>> properties);
+    Reconfiguration_Event(bool conditioner_, unsigned int block_id_, std::vector<std::pair<std::string, std::string>> properties_);
+};
+
+#endif  // GNSS_SDR_RECONFIGURATION_EVENT_H
@@ -49,10 +49,11 @@ gnss_synchro_monitor::gnss_synchro_monitor(unsigned int n_channels,
                                 gr::io_signature::make(n_channels, n_channels, sizeof(Gnss_Synchro)),
                                 gr::io_signature::make(0, 0, 0))
 {
-    d_decimation_factor = decimation_factor;
+    d_decimation_factor.store(decimation_factor, std::memory_order_relaxed);
     d_nchannels = n_channels;
 
     udp_sink_ptr = std::unique_ptr<Gnss_Synchro_Udp_Sink>(new Gnss_Synchro_Udp_Sink(udp_addresses, udp_port, enable_protobuf));
+    d_epoch = std::vector<Gnss_Synchro>(d_nchannels);
 
     count = 0;
 }
@@ -62,19 +63,26 @@ int gnss_synchro_monitor::work(int noutput_items, gr_vector_const_void_star& inp
     gr_vector_void_star& output_items __attribute__((unused)))
 {
     const auto** in = reinterpret_cast<const Gnss_Synchro**>(&input_items[0]);  // Get the input buffer pointer
+    const int decimation_factor = d_decimation_factor.load(std::memory_order_relaxed);
     for (int epoch = 0; epoch < noutput_items; epoch++)
         {
             count++;
-            if (count >= d_decimation_factor)
+            if (count >= decimation_factor)
                 {
+                    // all the channels of the epoch go out together
                     for (unsigned int i = 0; i < d_nchannels; i++)
                         {
-                            std::vector<Gnss_Synchro> stocks;
-                            stocks.push_back(in[i][epoch]);
-                            udp_sink_ptr->write_gnss_synchro(stocks);
+                            d_epoch[i] = in[i][epoch];
                         }
+                    udp_sink_ptr->write_gnss_synchro(d_epoch.data(), d_epoch.size());
                     count = 0;
                 }
         }
     return noutput_items;
 }
+
+
+void gnss_synchro_monitor::set_decimation_factor(int decimation_factor)
+{
+    d_decimation_factor.store(std::max(decimation_factor, 1), std::memory_order_relaxed);
+}
@@ -26,6 +26,7 @@
 #include "gnss_synchro_udp_sink.h"
 #include <gnuradio/runtime_types.h>  // for gr_vector_void_star
 #include <gnuradio/sync_block.h>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -62,6 +63,17 @@ public:
     int work(int noutput_items, gr_vector_const_void_star& input_items,
         gr_vector_void_star& output_items);
 
+    /*!
+     * \brief Sends one epoch out of decimation_factor. Can be called while
+     * the flow graph is running.
+     */
+    void set_decimation_factor(int decimation_factor);
+
+    int decimation_factor() const
+    {
+        return d_decimation_factor.load(std::memory_order_relaxed);
+    }
+
 private:
     friend gnss_synchro_monitor_sptr gnss_synchro_make_monitor(unsigned int n_channels,
         int decimation_factor,
@@ -76,8 +88,9 @@ private:
         bool enable_protobuf);
 
     unsigned int d_nchannels;
-    int d_decimation_factor;
+    std::atomic<int> d_decimation_factor;
     std::unique_ptr<Gnss_Synchro_Udp_Sink> udp_sink_ptr;
+    std::vector<Gnss_Synchro> d_epoch;  // preallocated, one object per channel
     int count;
 };
 
@@ -21,51 +21,147 @@
 #include "gnss_synchro_udp_sink.h"
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/serialization/vector.hpp>
-#include <iostream>
+#include <google/protobuf/io/coded_stream.h>
+#include <algorithm>
+#include <exception>
+#include <ostream>
 #include <sstream>
 
-Gnss_Synchro_Udp_Sink::Gnss_Synchro_Udp_Sink(const std::vector<std::string>& addresses, const uint16_t& port, bool enable_protobuf) : socket{io_context}
+Gnss_Synchro_Udp_Sink::Gnss_Synchro_Udp_Sink(const std::vector<std::string>& addresses, const uint16_t& port, bool enable_protobuf) : udp_transport(addresses, port)
 {
     use_protobuf = enable_protobuf;
     if (enable_protobuf)
         {
             serdes = Serdes_Gnss_Synchro();
         }
-    for (const auto& address : addresses)
+
+    // Gnss_Synchro archives have a fixed size, so the number of objects
+    // that fit in a datagram is measured once
+    std::vector<Gnss_Synchro> probe(1);
+    std::ostringstream one_stream;
+    {
+        boost::archive::binary_oarchive oa{one_stream};
+        oa << probe;
+    }
+    probe.resize(2);
+    std::ostringstream two_stream;
+    {
+        boost::archive::binary_oarchive oa{two_stream};
+        oa << probe;
+    }
+    const std::size_t item_size = two_stream.str().size() - one_stream.str().size();
+    const std::size_t header_size = one_stream.str().size() - item_size;
+    items_per_archive = 1;
+    if (udp_transport.datagram_size() > header_size + item_size)
         {
-            boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::address::from_string(address, error), port);
-            endpoints.push_back(endpoint);
+            items_per_archive = (udp_transport.datagram_size() - header_size) / item_size;
         }
 }
 
 
 bool Gnss_Synchro_Udp_Sink::write_gnss_synchro(const std::vector<Gnss_Synchro>& stocks)
 {
-    std::string outbound_data;
-    if (use_protobuf == false)
-        {
-            std::ostringstream archive_stream;
-            boost::archive::binary_oarchive oa{archive_stream};
-            oa << stocks;
-            outbound_data = archive_stream.str();
-        }
-    else
+    return write_gnss_synchro(stocks.data(), stocks.size());
+}
+
+
+bool Gnss_Synchro_Udp_Sink::write_gnss_synchro(const Gnss_Synchro* stocks, std::size_t count)
+{
+    if (count == 0)
         {
-            outbound_data = serdes.createProtobuffer(stocks);
+            return true;
         }
-    for (const auto& endpoint : endpoints)
-        {
-            socket.open(endpoint.protocol(), error);
-            socket.connect(endpoint, error);
+    const bool written = use_protobuf ? write_protobuf(stocks, count) : write_archive(stocks, count);
+    udp_transport.wake();
+    return written;
+}
+
 
+void Gnss_Synchro_Udp_Sink::flush()
+{
+    udp_transport.flush();
+}
+
+
+const Monitor_Udp_Transport& Gnss_Synchro_Udp_Sink::transport() const
+{
+    return udp_transport;
+}
+
+
+bool Gnss_Synchro_Udp_Sink::write_archive(const Gnss_Synchro* stocks, std::size_t count)
+{
+    bool written = true;
+    for (std::size_t first = 0; first < count; first += items_per_archive)
+        {
+            uint8_t* datagram = udp_transport.claim();
+            if (datagram == nullptr)
+                {
+                    written = false;
+                    continue;
+                }
+            archive_items.assign(stocks + first, stocks + std::min(first + items_per_archive, count));
+            Monitor_Datagram_Buffer buffer(datagram, udp_transport.datagram_size());
             try
                 {
-                    socket.send(boost::asio::buffer(outbound_data));
+                    std::ostream archive_stream(&buffer);
+                    boost::archive::binary_oarchive oa{archive_stream};
+                    oa << archive_items;
                 }
-            catch (boost::system::system_error const& e)
+            catch (const std::exception& e)
                 {
-                    return false;
+                    // does not fit in a datagram: the slot is not published
+                    udp_transport.drop();
+                    written = false;
+                    continue;
                 }
+            udp_transport.publish(buffer.size());
+        }
+    return written;
+}
+
+
+bool Gnss_Synchro_Udp_Sink::write_protobuf(const Gnss_Synchro* stocks, std::size_t count)
+{
+    // Cleared messages keep their memory, so that packing does not allocate
+    bool written = true;
+    std::size_t message_size = 0;
+    observables.Clear();
+    for (std::size_t n = 0; n < count; n++)
+        {
+            gnss_sdr::GnssSynchro* obs = observables.add_observable();
+            serdes.fillObservable(obs, stocks[n]);
+            std::size_t item_size = obs->ByteSizeLong();
+            item_size += 1 + google::protobuf::io::CodedOutputStream::VarintSize32(static_cast<uint32_t>(item_size));
+            if (message_size + item_size > udp_transport.datagram_size() and observables.observable_size() > 1)
+                {
+                    // send the previous objects, and start a new datagram with this one
+                    observables.mutable_observable()->RemoveLast();
+                    written = publish_observables() and written;
+                    observables.Clear();
+                    message_size = 0;
+                    serdes.fillObservable(observables.add_observable(), stocks[n]);
+                }
+            message_size += item_size;
+        }
+    return publish_observables() and written;
+}
+
+
+bool Gnss_Synchro_Udp_Sink::publish_observables()
+{
+    const std::size_t size = observables.ByteSizeLong();
+    if (size > udp_transport.datagram_size())
+        {
+            udp_transport.drop();
+            return false;
+        }
+    uint8_t* datagram = udp_transport.claim();
+    if (datagram == nullptr)
+        {
+            return false;
         }
+    observables.SerializeWithCachedSizesToArray(datagram);
+    udp_transport.publish(size);
     return true;
 }
@@ -22,22 +22,22 @@
 #define GNSS_SDR_GNSS_SYNCHRO_UDP_SINK_H
 
 #include "gnss_synchro.h"
+#include "gnss_synchro.pb.h"  // file created by Protocol Buffers at compile time
+#include "monitor_udp_transport.h"
 #include "serdes_gnss_synchro.h"
-#include <boost/asio.hpp>
-#include <boost/system/error_code.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
-#if BOOST_GREATER_1_65
-using b_io_context = boost::asio::io_context;
-#else
-using b_io_context = boost::asio::io_service;
-#endif
-
 /*!
  * \brief This class sends serialized Gnss_Synchro objects
  * over UDP to one or multiple endpoints.
+ *
+ * All the objects of a write are packed in as few datagrams as possible,
+ * each of them holding a complete std::vector<Gnss_Synchro> archive or
+ * gnss_sdr::Observables message. The datagrams are serialized in place in
+ * the ring of a Monitor_Udp_Transport, which sends them from its own thread.
  */
 class Gnss_Synchro_Udp_Sink
 {
@@ -45,12 +45,25 @@ public:
     Gnss_Synchro_Udp_Sink(const std::vector<std::string>& addresses, const uint16_t& port, bool enable_protobuf);
     bool write_gnss_synchro(const std::vector<Gnss_Synchro>& stocks);
 
+    /*!
+     * \brief Sends count objects, usually all the channels of an epoch.
+     * Returns false if any datagram was dropped.
+     */
+    bool write_gnss_synchro(const Gnss_Synchro* stocks, std::size_t count);
+
+    void flush();                                    //!< Waits until all the written objects have been sent
+    const Monitor_Udp_Transport& transport() const;  //!< Datagram counters
+
 private:
-    b_io_context io_context;
-    boost::asio::ip::udp::socket socket;
-    boost::system::error_code error;
-    std::vector<boost::asio::ip::udp::endpoint> endpoints;
+    bool write_archive(const Gnss_Synchro* stocks, std::size_t count);
+    bool write_protobuf(const Gnss_Synchro* stocks, std::size_t count);
+    bool publish_observables();
+
+    Monitor_Udp_Transport udp_transport;
     Serdes_Gnss_Synchro serdes;
+    gnss_sdr::Observables observables;
+    std::vector<Gnss_Synchro> archive_items;
+    std::size_t items_per_archive;
     bool use_protobuf;
 };
 
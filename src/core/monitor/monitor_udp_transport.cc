@@ -0,0 +1,264 @@
+/*!
+ * \file monitor_udp_transport.cc
+ * \brief Implementation of a class that sends monitoring datagrams to one
+ * or multiple UDP endpoints from a dedicated thread
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "monitor_udp_transport.h"
+#include <glog/logging.h>
+#include <algorithm>  // for min
+#include <chrono>
+#include <cstring>  // for memcpy
+#include <exception>
+
+
+Monitor_Udp_Transport::Monitor_Udp_Transport(const std::vector<std::string>& addresses,
+    uint16_t port,
+    std::size_t datagram_size,
+    std::size_t capacity) : d_datagram_size(datagram_size == 0 ? MONITOR_MAX_DATAGRAM_SIZE : datagram_size),
+                            d_capacity(capacity == 0 ? 1 : capacity)
+{
+    d_sockets.reserve(addresses.size());
+    for (const auto& address : addresses)
+        {
+            boost::system::error_code error;
+            const boost::asio::ip::udp::endpoint endpoint(boost::asio::ip::address::from_string(address, error), port);
+            if (error)
+                {
+                    LOG(WARNING) << "Invalid monitor address " << address << ": " << error.message();
+                    continue;
+                }
+            boost::asio::ip::udp::socket socket(d_io_context);
+            socket.open(endpoint.protocol(), error);
+            if (!error)
+                {
+                    socket.connect(endpoint, error);
+                }
+            if (error)
+                {
+                    LOG(WARNING) << "Cannot connect to monitor endpoint " << endpoint << ": " << error.message();
+                    continue;
+                }
+            d_sockets.push_back(std::move(socket));
+        }
+
+    d_slots.resize(d_capacity * d_datagram_size);
+    d_lengths.resize(d_capacity);
+#if defined(__linux__)
+    d_messages.resize(d_capacity);
+    d_iovecs.resize(d_capacity);
+#endif
+    d_thread = std::thread(&Monitor_Udp_Transport::run, this);
+}
+
+
+Monitor_Udp_Transport::~Monitor_Udp_Transport()
+{
+    d_stop = true;
+    d_cv.notify_one();
+    try
+        {
+            if (d_thread.joinable())
+                {
+                    d_thread.join();
+                }
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << "Error stopping the monitor transport: " << e.what();
+        }
+    if (d_dropped > 0)
+        {
+            LOG(WARNING) << "Monitor transport dropped " << d_dropped << " of " << d_dropped + get_published() << " datagrams";
+        }
+}
+
+
+uint8_t* Monitor_Udp_Transport::claim()
+{
+    const uint64_t head = d_head.load(std::memory_order_relaxed);
+    if (head - d_tail.load(std::memory_order_acquire) >= d_capacity)
+        {
+            d_dropped++;
+            return nullptr;
+        }
+    return &d_slots[(head % d_capacity) * d_datagram_size];
+}
+
+
+void Monitor_Udp_Transport::publish(std::size_t length)
+{
+    const uint64_t head = d_head.load(std::memory_order_relaxed);
+    d_lengths[head % d_capacity] = std::min(length, d_datagram_size);
+    d_head.store(head + 1, std::memory_order_release);
+}
+
+
+void Monitor_Udp_Transport::drop()
+{
+    d_dropped++;
+}
+
+
+bool Monitor_Udp_Transport::send(const void* data, std::size_t length)
+{
+    if (length > d_datagram_size)
+        {
+            drop();
+            return false;
+        }
+    uint8_t* buffer = claim();
+    if (buffer == nullptr)
+        {
+            return false;
+        }
+    std::memcpy(buffer, data, length);
+    publish(length);
+    wake();
+    return true;
+}
+
+
+void Monitor_Udp_Transport::wake()
+{
+    d_cv.notify_one();
+}
+
+
+void Monitor_Udp_Transport::flush()
+{
+    while (d_tail.load(std::memory_order_acquire) != d_head.load(std::memory_order_relaxed))
+        {
+            d_cv.notify_one();
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+}
+
+
+std::size_t Monitor_Udp_Transport::datagram_size() const
+{
+    return d_datagram_size;
+}
+
+
+std::size_t Monitor_Udp_Transport::endpoints() const
+{
+    return d_sockets.size();
+}
+
+
+uint64_t Monitor_Udp_Transport::get_published() const
+{
+    return d_head.load(std::memory_order_relaxed);
+}
+
+
+uint64_t Monitor_Udp_Transport::get_sent() const
+{
+    return d_tail.load(std::memory_order_relaxed);
+}
+
+
+uint64_t Monitor_Udp_Transport::get_dropped() const
+{
+    return d_dropped.load(std::memory_order_relaxed);
+}
+
+
+uint64_t Monitor_Udp_Transport::get_errors() const
+{
+    return d_errors.load(std::memory_order_relaxed);
+}
+
+
+uint64_t Monitor_Udp_Transport::get_syscalls() const
+{
+    return d_syscalls.load(std::memory_order_relaxed);
+}
+
+
+void Monitor_Udp_Transport::run()
+{
+    while (true)
+        {
+            const uint64_t tail = d_tail.load(std::memory_order_relaxed);
+            const uint64_t head = d_head.load(std::memory_order_acquire);
+            if (tail == head)
+                {
+                    if (d_stop)
+                        {
+                            // all the published datagrams have been sent
+                            return;
+                        }
+                    // wake() notifies without taking the mutex, so a wakeup can be
+                    // missed. The timeout bounds the extra latency in that case.
+                    std::unique_lock<std::mutex> lock(d_mutex);
+                    d_cv.wait_for(lock, std::chrono::milliseconds(10), [&] { return d_stop or tail != d_head.load(std::memory_order_acquire); });
+                    continue;
+                }
+            // The pending datagrams may wrap around the end of the ring
+            const uint64_t first = tail % d_capacity;
+            const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(head - tail, d_capacity - first));
+            send_batch(first, count);
+            d_tail.store(tail + count, std::memory_order_release);
+        }
+}
+
+
+void Monitor_Udp_Transport::send_batch(uint64_t first, std::size_t count)
+{
+    for (auto& socket : d_sockets)
+        {
+#if defined(__linux__)
+            for (std::size_t n = 0; n < count; n++)
+                {
+                    d_iovecs[n].iov_base = &d_slots[(first + n) * d_datagram_size];
+                    d_iovecs[n].iov_len = d_lengths[first + n];
+                    std::memset(&d_messages[n], 0, sizeof(struct mmsghdr));
+                    d_messages[n].msg_hdr.msg_iov = &d_iovecs[n];
+                    d_messages[n].msg_hdr.msg_iovlen = 1;
+                }
+            // The socket is connected, so the messages need no address
+            std::size_t sent = 0;
+            while (sent < count)
+                {
+                    d_syscalls++;
+                    const int result = sendmmsg(socket.native_handle(), &d_messages[sent], static_cast<unsigned int>(count - sent), 0);
+                    if (result <= 0)
+                        {
+                            // e.g. ECONNREFUSED while nobody listens: skip the datagram
+                            d_errors++;
+                            sent++;
+                        }
+                    else
+                        {
+                            sent += static_cast<std::size_t>(result);
+                        }
+                }
+#else
+            for (std::size_t n = 0; n < count; n++)
+                {
+                    boost::system::error_code error;
+                    d_syscalls++;
+                    socket.send(boost::asio::buffer(&d_slots[(first + n) * d_datagram_size], d_lengths[first + n]), 0, error);
+                    if (error)
+                        {
+                            d_errors++;
+                        }
+                }
+#endif
+        }
+}
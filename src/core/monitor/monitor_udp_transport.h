@@ -0,0 +1,171 @@
+/*!
+ * \file monitor_udp_transport.h
+ * \brief Interface of a class that sends monitoring datagrams to one or
+ * multiple UDP endpoints from a dedicated thread
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MONITOR_UDP_TRANSPORT_H
+#define GNSS_SDR_MONITOR_UDP_TRANSPORT_H
+
+#include <boost/asio.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <sys/socket.h>  // for mmsghdr
+#include <sys/uio.h>     // for iovec
+#endif
+
+#if BOOST_GREATER_1_65
+using b_io_context = boost::asio::io_context;
+#else
+using b_io_context = boost::asio::io_service;
+#endif
+
+/*!
+ * \brief Largest UDP payload that fits in a single Ethernet frame
+ */
+const std::size_t MONITOR_MAX_DATAGRAM_SIZE = 1472;
+
+/*!
+ * \brief Sends datagrams to a set of UDP endpoints.
+ *
+ * The sockets are opened and connected once, at construction. Datagrams are
+ * written in place into a preallocated single-producer, single-consumer ring
+ * of fixed-size slots, so that the producer neither allocates nor makes
+ * system calls. A dedicated thread sends all the pending datagrams to each
+ * endpoint with a single sendmmsg() call, where available. Datagrams that
+ * do not fit in the ring are dropped and counted.
+ */
+class Monitor_Udp_Transport
+{
+public:
+    /*!
+     * \brief Opens the sockets and starts the sender thread.
+     * \param addresses IP addresses of the endpoints
+     * \param port UDP port of the endpoints
+     * \param datagram_size Maximum size of a datagram, in bytes
+     * \param capacity Maximum number of datagrams waiting to be sent
+     */
+    Monitor_Udp_Transport(const std::vector<std::string>& addresses,
+        uint16_t port,
+        std::size_t datagram_size = MONITOR_MAX_DATAGRAM_SIZE,
+        std::size_t capacity = 256);
+
+    /*!
+     * \brief Sends the pending datagrams and stops the sender thread
+     */
+    ~Monitor_Udp_Transport();
+
+    /*!
+     * \brief Returns a buffer of datagram_size() bytes where the next
+     * datagram can be written, or nullptr if the ring is full (the datagram
+     * is then counted as dropped). Must always be called from the same thread.
+     */
+    uint8_t* claim();
+
+    /*!
+     * \brief Queues the datagram written in the last claimed buffer. The
+     * sender thread is not woken up until wake() is called, so that all the
+     * datagrams of an epoch go out in the same batch.
+     */
+    void publish(std::size_t length);
+
+    /*!
+     * \brief Counts as dropped a datagram that is not published because it
+     * does not fit in datagram_size() bytes. If a buffer was claimed for it,
+     * the next claim() returns the same buffer.
+     */
+    void drop();
+
+    /*!
+     * \brief Copies a datagram into the ring and publishes it.
+     * Returns false if it was dropped.
+     */
+    bool send(const void* data, std::size_t length);
+
+    void wake();   //!< Wakes up the sender thread
+    void flush();  //!< Waits until all the published datagrams have been sent
+
+    std::size_t datagram_size() const;  //!< Maximum size of a datagram, in bytes
+    std::size_t endpoints() const;      //!< Number of connected endpoints
+
+    uint64_t get_published() const;  //!< Number of datagrams accepted in the ring
+    uint64_t get_sent() const;       //!< Number of published datagrams already sent
+    uint64_t get_dropped() const;    //!< Number of datagrams dropped because the ring was full or they were too large
+    uint64_t get_errors() const;     //!< Number of failed send system calls
+    uint64_t get_syscalls() const;   //!< Number of send system calls
+
+private:
+    void run();
+    void send_batch(uint64_t first, std::size_t count);
+
+    b_io_context d_io_context;
+    std::vector<boost::asio::ip::udp::socket> d_sockets;
+
+    std::vector<uint8_t> d_slots;  // capacity * datagram_size bytes
+    std::vector<std::size_t> d_lengths;
+    std::size_t d_datagram_size;
+    std::size_t d_capacity;
+
+#if defined(__linux__)
+    // Scratch space of the sender thread, sized for a full ring
+    std::vector<struct mmsghdr> d_messages;
+    std::vector<struct iovec> d_iovecs;
+#endif
+
+    // d_head is only written by the producer and d_tail by the sender thread
+    std::atomic<uint64_t> d_head{0};
+    std::atomic<uint64_t> d_tail{0};
+
+    std::atomic<uint64_t> d_dropped{0};
+    std::atomic<uint64_t> d_errors{0};
+    std::atomic<uint64_t> d_syscalls{0};
+
+    std::atomic<bool> d_stop{false};
+    std::mutex d_mutex;  // only used to sleep when the ring is empty
+    std::condition_variable d_cv;
+    std::thread d_thread;
+};
+
+
+/*!
+ * \brief Output stream buffer over a fixed memory area, so that
+ * Boost archives can be written directly into a claimed datagram.
+ * Writing past the end fails instead of allocating.
+ */
+class Monitor_Datagram_Buffer : public std::streambuf
+{
+public:
+    Monitor_Datagram_Buffer(uint8_t* data, std::size_t size)
+    {
+        char* begin = reinterpret_cast<char*>(data);
+        setp(begin, begin + size);
+    }
+
+    std::size_t size() const
+    {
+        return static_cast<std::size_t>(pptr() - pbase());
+    }
+};
+
+#endif  // GNSS_SDR_MONITOR_UDP_TRANSPORT_H
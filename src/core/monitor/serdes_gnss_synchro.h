@@ -76,50 +76,59 @@ public:
     {
         observables.Clear();
         std::string data;
-        for (auto gs : vgs)
+        for (const auto& gs : vgs)
             {
-                gnss_sdr::GnssSynchro* obs = observables.add_observable();
-                char c = gs.System;
-                const std::string sys(1, c);
-
-                std::array<char, 2> cc;
-                cc[0] = gs.Signal[0];
-                cc[1] = gs.Signal[1];
-                const std::string sig(cc.cbegin(), cc.cend());
-
-                obs->set_system(sys);
-                obs->set_signal(sig);
-                obs->set_prn(gs.PRN);
-                obs->set_channel_id(gs.Channel_ID);
-
-                obs->set_acq_delay_samples(gs.Acq_delay_samples);
-                obs->set_acq_doppler_hz(gs.Acq_doppler_hz);
-                obs->set_acq_samplestamp_samples(gs.Acq_samplestamp_samples);
-                obs->set_acq_doppler_step(gs.Acq_doppler_step);
-                obs->set_flag_valid_acquisition(gs.Flag_valid_acquisition);
-
-                obs->set_fs(gs.fs);
-                obs->set_prompt_i(gs.Prompt_I);
-                obs->set_prompt_q(gs.Prompt_Q);
-                obs->set_cn0_db_hz(gs.CN0_dB_hz);
-                obs->set_carrier_doppler_hz(gs.Carrier_Doppler_hz);
-                obs->set_code_phase_samples(gs.Code_phase_samples);
-                obs->set_tracking_sample_counter(gs.Tracking_sample_counter);
-                obs->set_flag_valid_symbol_output(gs.Flag_valid_symbol_output);
-                obs->set_correlation_length_ms(gs.correlation_length_ms);
-
-                obs->set_flag_valid_word(gs.Flag_valid_word);
-                obs->set_tow_at_current_symbol_ms(gs.TOW_at_current_symbol_ms);
-
-                obs->set_pseudorange_m(gs.Pseudorange_m);
-                obs->set_rx_time(gs.RX_time);
-                obs->set_flag_valid_pseudorange(gs.Flag_valid_pseudorange);
-                obs->set_interp_tow_ms(gs.interp_TOW_ms);
+                fillObservable(observables.add_observable(), gs);
             }
         observables.SerializeToString(&data);
         return data;
     }
 
+    /*!
+     * \brief Copies a Gnss_Synchro object into a protobuf message. Messages
+     * that are cleared and refilled keep their memory, so this does not
+     * allocate once the message has been filled before.
+     */
+    inline void fillObservable(gnss_sdr::GnssSynchro* obs, const Gnss_Synchro& gs) const
+    {
+        char c = gs.System;
+        const std::string sys(1, c);
+
+        std::array<char, 2> cc;
+        cc[0] = gs.Signal[0];
+        cc[1] = gs.Signal[1];
+        const std::string sig(cc.cbegin(), cc.cend());
+
+        obs->set_system(sys);
+        obs->set_signal(sig);
+        obs->set_prn(gs.PRN);
+        obs->set_channel_id(gs.Channel_ID);
+
+        obs->set_acq_delay_samples(gs.Acq_delay_samples);
+        obs->set_acq_doppler_hz(gs.Acq_doppler_hz);
+        obs->set_acq_samplestamp_samples(gs.Acq_samplestamp_samples);
+        obs->set_acq_doppler_step(gs.Acq_doppler_step);
+        obs->set_flag_valid_acquisition(gs.Flag_valid_acquisition);
+
+        obs->set_fs(gs.fs);
+        obs->set_prompt_i(gs.Prompt_I);
+        obs->set_prompt_q(gs.Prompt_Q);
+        obs->set_cn0_db_hz(gs.CN0_dB_hz);
+        obs->set_carrier_doppler_hz(gs.Carrier_Doppler_hz);
+        obs->set_code_phase_samples(gs.Code_phase_samples);
+        obs->set_tracking_sample_counter(gs.Tracking_sample_counter);
+        obs->set_flag_valid_symbol_output(gs.Flag_valid_symbol_output);
+        obs->set_correlation_length_ms(gs.correlation_length_ms);
+
+        obs->set_flag_valid_word(gs.Flag_valid_word);
+        obs->set_tow_at_current_symbol_ms(gs.TOW_at_current_symbol_ms);
+
+        obs->set_pseudorange_m(gs.Pseudorange_m);
+        obs->set_rx_time(gs.RX_time);
+        obs->set_flag_valid_pseudorange(gs.Flag_valid_pseudorange);
+        obs->set_interp_tow_ms(gs.interp_TOW_ms);
+    }
+
     inline std::vector<Gnss_Synchro> readProtobuffer(const gnss_sdr::Observables& obs) const  //!< Deserialization
     {
         std::vector<Gnss_Synchro> vgs;
@@ -0,0 +1,232 @@
+/*!
+ * \file block_metrics.cc
+ * \brief Performance counters of the processing blocks, in Prometheus text
+ * and JSON formats
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "block_metrics.h"
+#include <gnuradio/block.h>           // for block
+#include <gnuradio/block_detail.h>    // for block_detail
+#include <gnuradio/high_res_timer.h>  // for high_res_timer_tps
+#include <gnuradio/prefs.h>           // for prefs
+#include <cmath>                      // for round
+#include <iomanip>                    // for setprecision
+#include <map>                        // for map
+#include <numeric>                    // for accumulate
+#include <sstream>                    // for stringstream
+
+
+Block_Metrics::Block_Metrics()
+{
+    d_start = std::chrono::steady_clock::now();
+}
+
+
+void Block_Metrics::enable_counters()
+{
+    // read by each block thread when the flow graph starts
+    gr::prefs::singleton()->set_bool("PerfCounters", "on", true);
+}
+
+
+Block_Sample Block_Metrics::sample(const std::string& name, int32_t channel, const gr::basic_block_sptr& block)
+{
+    Block_Sample block_sample;
+    block_sample.name = name;
+    block_sample.channel = channel;
+#if GNURADIO_USES_STD_POINTERS
+    const gr::block_sptr gr_block = std::dynamic_pointer_cast<gr::block>(block);
+#else
+    const gr::block_sptr gr_block = boost::dynamic_pointer_cast<gr::block>(block);
+#endif
+    if (gr_block == nullptr or gr_block->detail() == nullptr)
+        {
+            // hierarchical blocks have no counters, and blocks get their
+            // detail when the flow graph starts
+            return block_sample;
+        }
+    const double work_time = gr_block->pc_work_time_total();
+    const double work_time_avg = gr_block->pc_work_time_avg();  // cumulative mean
+    block_sample.work_s = work_time / static_cast<double>(gr::high_res_timer_tps());
+    block_sample.work_calls = work_time_avg > 0.0 ? std::round(work_time / work_time_avg) : 0.0;
+    if (gr_block->detail()->ninputs() > 0)
+        {
+            block_sample.items_in = gr_block->nitems_read(0);
+            const std::vector<float> full = gr_block->pc_input_buffers_full_avg();
+            block_sample.input_buffer_full = std::accumulate(full.begin(), full.end(), 0.0) / static_cast<double>(full.size());
+        }
+    if (gr_block->detail()->noutputs() > 0)
+        {
+            block_sample.items_out = gr_block->nitems_written(0);
+            const std::vector<float> full = gr_block->pc_output_buffers_full_avg();
+            block_sample.output_stall = std::accumulate(full.begin(), full.end(), 0.0) / static_cast<double>(full.size());
+        }
+    return block_sample;
+}
+
+
+double Block_Metrics::uptime_s() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - d_start).count();
+}
+
+
+std::string Block_Metrics::prometheus(const std::vector<Block_Sample>& samples,
+    const std::vector<Latency_Histogram>& latencies) const
+{
+    std::stringstream text;
+    text << std::setprecision(9);
+    const auto metric = [&text, &samples](const std::string& name, const std::string& type, const std::string& help, double (*value)(const Block_Sample&)) {
+        text << "# HELP " << name << " " << help << "\n";
+        text << "# TYPE " << name << " " << type << "\n";
+        for (const auto& block_sample : samples)
+            {
+                text << name << "{block=\"" << block_sample.name << "\",channel=\"" << block_sample.channel << "\"} " << value(block_sample) << "\n";
+            }
+    };
+    metric("gnss_sdr_block_work_calls_total", "counter", "Calls to work()",
+        [](const Block_Sample& s) { return s.work_calls; });
+    metric("gnss_sdr_block_work_seconds_total", "counter", "CPU time spent in work()",
+        [](const Block_Sample& s) { return s.work_s; });
+    metric("gnss_sdr_block_items_in_total", "counter", "Items read from the first input",
+        [](const Block_Sample& s) { return static_cast<double>(s.items_in); });
+    metric("gnss_sdr_block_items_out_total", "counter", "Items written to the first output",
+        [](const Block_Sample& s) { return static_cast<double>(s.items_out); });
+    metric("gnss_sdr_block_input_buffer_full_ratio", "gauge", "Average occupancy of the input buffers",
+        [](const Block_Sample& s) { return s.input_buffer_full; });
+    metric("gnss_sdr_block_output_stall_ratio", "gauge", "Average occupancy of the output buffers",
+        [](const Block_Sample& s) { return s.output_stall; });
+
+    std::map<int32_t, double> channel_work_s;
+    for (const auto& block_sample : samples)
+        {
+            if (block_sample.channel >= 0)
+                {
+                    channel_work_s[block_sample.channel] += block_sample.work_s;
+                }
+        }
+    const double uptime = uptime_s();
+    text << "# HELP gnss_sdr_channel_work_seconds_total CPU time spent by the blocks of each channel\n";
+    text << "# TYPE gnss_sdr_channel_work_seconds_total counter\n";
+    for (const auto& channel : channel_work_s)
+        {
+            text << "gnss_sdr_channel_work_seconds_total{channel=\"" << channel.first << "\"} " << channel.second << "\n";
+        }
+    text << "# HELP gnss_sdr_channel_cpu_ratio Average share of a core used by each channel\n";
+    text << "# TYPE gnss_sdr_channel_cpu_ratio gauge\n";
+    for (const auto& channel : channel_work_s)
+        {
+            text << "gnss_sdr_channel_cpu_ratio{channel=\"" << channel.first << "\"} " << (uptime > 0.0 ? channel.second / uptime : 0.0) << "\n";
+        }
+    if (!latencies.empty())
+        {
+            const std::vector<double>& bounds = Latency_Tracer::bucket_bounds_ms();
+            text << "# HELP gnss_sdr_latency_seconds Time from when a sample leaves the signal source until each stage outputs it\n";
+            text << "# TYPE gnss_sdr_latency_seconds histogram\n";
+            for (const auto& latency : latencies)
+                {
+                    uint64_t cumulative = 0;
+                    for (size_t n = 0; n < bounds.size(); n++)
+                        {
+                            cumulative += latency.counts[n];
+                            text << "gnss_sdr_latency_seconds_bucket{stage=\"" << latency.stage << "\",le=\"" << bounds[n] / 1e3 << "\"} " << cumulative << "\n";
+                        }
+                    text << "gnss_sdr_latency_seconds_bucket{stage=\"" << latency.stage << "\",le=\"+Inf\"} " << latency.count << "\n";
+                    text << "gnss_sdr_latency_seconds_sum{stage=\"" << latency.stage << "\"} " << latency.sum_ms / 1e3 << "\n";
+                    text << "gnss_sdr_latency_seconds_count{stage=\"" << latency.stage << "\"} " << latency.count << "\n";
+                }
+            text << "# HELP gnss_sdr_latency_max_seconds Largest latency of each stage\n";
+            text << "# TYPE gnss_sdr_latency_max_seconds gauge\n";
+            for (const auto& latency : latencies)
+                {
+                    text << "gnss_sdr_latency_max_seconds{stage=\"" << latency.stage << "\"} " << latency.max_ms / 1e3 << "\n";
+                }
+            text << "# HELP gnss_sdr_latency_missed_total Outputs whose samples were not found in the history of the signal source\n";
+            text << "# TYPE gnss_sdr_latency_missed_total counter\n";
+            for (const auto& latency : latencies)
+                {
+                    text << "gnss_sdr_latency_missed_total{stage=\"" << latency.stage << "\"} " << latency.missed << "\n";
+                }
+        }
+    text << "# HELP gnss_sdr_uptime_seconds Time since the metrics started\n";
+    text << "# TYPE gnss_sdr_uptime_seconds gauge\n";
+    text << "gnss_sdr_uptime_seconds " << uptime << "\n";
+    return text.str();
+}
+
+
+std::string Block_Metrics::json(const std::vector<Block_Sample>& samples,
+    const std::vector<Latency_Histogram>& latencies) const
+{
+    std::stringstream text;
+    text << std::setprecision(9);
+    const double uptime = uptime_s();
+    std::map<int32_t, double> channel_work_s;
+    text << "{\"uptime_s\":" << uptime << ",\"blocks\":[";
+    for (size_t n = 0; n < samples.size(); n++)
+        {
+            const Block_Sample& block_sample = samples[n];
+            text << (n > 0 ? "," : "") << "{\"name\":\"" << block_sample.name << "\""
+                 << ",\"channel\":" << block_sample.channel
+                 << ",\"work_calls\":" << block_sample.work_calls
+                 << ",\"work_s\":" << block_sample.work_s
+                 << ",\"items_in\":" << block_sample.items_in
+                 << ",\"items_out\":" << block_sample.items_out
+                 << ",\"input_buffer_full\":" << block_sample.input_buffer_full
+                 << ",\"output_stall\":" << block_sample.output_stall << "}";
+            if (block_sample.channel >= 0)
+                {
+                    channel_work_s[block_sample.channel] += block_sample.work_s;
+                }
+        }
+    text << "],\"channels\":[";
+    bool first = true;
+    for (const auto& channel : channel_work_s)
+        {
+            text << (first ? "" : ",") << "{\"channel\":" << channel.first
+                 << ",\"work_s\":" << channel.second
+                 << ",\"cpu\":" << (uptime > 0.0 ? channel.second / uptime : 0.0) << "}";
+            first = false;
+        }
+    text << "],\"latency\":[";
+    const std::vector<double>& bounds = Latency_Tracer::bucket_bounds_ms();
+    for (size_t n = 0; n < latencies.size(); n++)
+        {
+            const Latency_Histogram& latency = latencies[n];
+            text << (n > 0 ? "," : "") << "{\"stage\":\"" << latency.stage << "\""
+                 << ",\"count\":" << latency.count
+                 << ",\"missed\":" << latency.missed
+                 << ",\"mean_ms\":" << (latency.count > 0 ? latency.sum_ms / static_cast<double>(latency.count) : 0.0)
+                 << ",\"max_ms\":" << latency.max_ms
+                 << ",\"buckets\":[";
+            for (size_t m = 0; m < latency.counts.size(); m++)
+                {
+                    text << (m > 0 ? "," : "") << "{\"le_ms\":";
+                    if (m < bounds.size())
+                        {
+                            text << bounds[m];
+                        }
+                    else
+                        {
+                            text << "null";
+                        }
+                    text << ",\"count\":" << latency.counts[m] << "}";
+                }
+            text << "]}";
+        }
+    text << "]}\n";
+    return text.str();
+}
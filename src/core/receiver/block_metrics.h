@@ -0,0 +1,90 @@
+/*!
+ * \file block_metrics.h
+ * \brief Performance counters of the processing blocks, in Prometheus text
+ * and JSON formats
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BLOCK_METRICS_H
+#define GNSS_SDR_BLOCK_METRICS_H
+
+#include "latency_tracer.h"
+#include <gnuradio/runtime_types.h>  // for basic_block_sptr
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Performance counters of a GNU Radio block, since the flow graph
+ * started
+ */
+class Block_Sample
+{
+public:
+    std::string name;                // role of the block, or GNU Radio alias
+    int32_t channel = -1;            // channel the block belongs to, or -1
+    double work_calls = 0.0;         // calls to work()
+    double work_s = 0.0;             // CPU time spent in work()
+    uint64_t items_in = 0;           // items read from the first input
+    uint64_t items_out = 0;          // items written to the first output
+    double input_buffer_full = 0.0;  // average occupancy of the input buffers (0 to 1)
+    double output_stall = 0.0;       // average occupancy of the output buffers, i.e. how much the consumers hold it back (0 to 1)
+};
+
+
+/*!
+ * \brief Reads the performance counters that GNU Radio keeps for each block
+ * and formats them.
+ *
+ * The counters must be enabled, with enable_counters(), before the flow
+ * graph starts. They cost two reads of the thread CPU clock per call to
+ * work().
+ */
+class Block_Metrics
+{
+public:
+    Block_Metrics();
+
+    /*!
+     * \brief Turns on the GNU Radio performance counters ([PerfCounters] on)
+     */
+    static void enable_counters();
+
+    /*!
+     * \brief Reads the counters of a block
+     */
+    static Block_Sample sample(const std::string& name, int32_t channel, const gr::basic_block_sptr& block);
+
+    /*!
+     * \brief Prometheus text exposition format, with the counters of each
+     * block, the CPU time of each channel and, if measured, the latency of
+     * each processing stage
+     */
+    std::string prometheus(const std::vector<Block_Sample>& samples,
+        const std::vector<Latency_Histogram>& latencies = {}) const;
+
+    /*!
+     * \brief Same as prometheus(), in JSON
+     */
+    std::string json(const std::vector<Block_Sample>& samples,
+        const std::vector<Latency_Histogram>& latencies = {}) const;
+
+private:
+    double uptime_s() const;
+    std::chrono::steady_clock::time_point d_start;
+};
+
+#endif  // GNSS_SDR_BLOCK_METRICS_H
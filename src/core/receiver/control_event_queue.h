@@ -0,0 +1,265 @@
+/*!
+ * \file control_event_queue.h
+ * \brief Bounded lock-free queue that carries the channel events to the
+ * control thread
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CONTROL_EVENT_QUEUE_H
+#define GNSS_SDR_CONTROL_EVENT_QUEUE_H
+
+#include "log2_histogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+/*!
+ * \brief Event sent by a channel to the control thread, with the same
+ * meaning as a Channel_Event
+ */
+class Control_Event
+{
+public:
+    int32_t channel_id;
+    int32_t event_type;
+    int64_t enqueue_ns;  // steady clock time of the push
+};
+
+
+/*!
+ * \brief Bounded multi-producer, single-consumer queue of Control_Event.
+ *
+ * Pushing an event does not allocate memory nor take a lock, so a burst of
+ * acquisitions does not make the channels contend with each other or with
+ * the control thread. The consumer drains the events in batches.
+ *
+ * The consumer sleeps elsewhere (on the Concurrent_Queue of commands): it
+ * calls begin_wait() before sleeping and end_wait() after, and the first
+ * push() in between calls the wakeup function to wake it up.
+ *
+ * Each slot holds a sequence number that tells whether it is free for the
+ * producer that claimed it, or holds an event for the consumer (D. Vyukov's
+ * bounded queue).
+ *
+ * A producer that finds the queue full sends the event through the command
+ * queue instead. Before dispatching such an event, the consumer pops every
+ * event pushed before it (see pushed()), so the events of each channel are
+ * dispatched in order.
+ */
+class Control_Event_Queue
+{
+public:
+    /*!
+     * \brief Creates a queue of the given capacity, rounded up to a power of two
+     */
+    explicit Control_Event_Queue(std::size_t capacity = 1024)
+    {
+        d_capacity = 1;
+        while (d_capacity < capacity)
+            {
+                d_capacity <<= 1U;
+            }
+        d_slots = std::unique_ptr<Slot[]>(new Slot[d_capacity]);
+        for (std::size_t n = 0; n < d_capacity; n++)
+            {
+                d_slots[n].sequence.store(n, std::memory_order_relaxed);
+            }
+        d_tail.store(0, std::memory_order_relaxed);
+        d_head.store(0, std::memory_order_relaxed);
+        d_consumer_waiting.store(false, std::memory_order_relaxed);
+        d_overflows.store(0, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Function that wakes up the consumer. It must be set before the
+     * producers start.
+     */
+    void set_wakeup(std::function<void()> wakeup)
+    {
+        d_wakeup = std::move(wakeup);
+    }
+
+    /*!
+     * \brief Pushes an event from any thread. Returns false, without
+     * blocking, if the queue is full.
+     */
+    bool push(int32_t channel_id, int32_t event_type)
+    {
+        uint64_t position = d_tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+            {
+                slot = &d_slots[position & (d_capacity - 1)];
+                const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<int64_t>(sequence - position);
+                if (difference == 0)
+                    {
+                        if (d_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            {
+                                break;
+                            }
+                    }
+                else if (difference < 0)
+                    {
+                        d_overflows.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                else
+                    {
+                        position = d_tail.load(std::memory_order_relaxed);
+                    }
+            }
+        slot->event.channel_id = channel_id;
+        slot->event.event_type = event_type;
+        slot->event.enqueue_ns = now_ns();
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        // pairs with the fence in begin_wait(): either the consumer sees this
+        // event before sleeping, or this producer sees it waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (d_consumer_waiting.load(std::memory_order_relaxed) and d_consumer_waiting.exchange(false) and d_wakeup)
+            {
+                d_wakeup();
+            }
+        return true;
+    }
+
+    /*!
+     * \brief Pops up to max_events events (consumer thread only). Returns
+     * the number of events copied to events.
+     */
+    std::size_t pop(Control_Event* events, std::size_t max_events)
+    {
+        const std::size_t depth = size();
+        uint64_t head = d_head.load(std::memory_order_relaxed);
+        std::size_t popped = 0;
+        while (popped < max_events)
+            {
+                Slot& slot = d_slots[head & (d_capacity - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+                    {
+                        break;
+                    }
+                events[popped++] = slot.event;
+                slot.sequence.store(head + d_capacity, std::memory_order_release);
+                head++;
+            }
+        d_head.store(head, std::memory_order_relaxed);
+        if (popped > 0)
+            {
+                d_depths.record(depth);
+                d_batch_sizes.record(popped);
+            }
+        return popped;
+    }
+
+    /*!
+     * \brief Number of events in the queue, including those being pushed
+     */
+    std::size_t size() const
+    {
+        const uint64_t tail = d_tail.load(std::memory_order_relaxed);
+        const uint64_t head = d_head.load(std::memory_order_relaxed);
+        return tail > head ? static_cast<std::size_t>(tail - head) : 0;
+    }
+
+    /*!
+     * \brief Announces that the consumer is going to sleep. Returns false,
+     * and the consumer must not sleep, if there are events to pop.
+     */
+    bool begin_wait()
+    {
+        d_consumer_waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const Slot& slot = d_slots[d_head.load(std::memory_order_relaxed) & (d_capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) == d_head.load(std::memory_order_relaxed) + 1)
+            {
+                d_consumer_waiting.store(false, std::memory_order_relaxed);
+                return false;
+            }
+        return true;
+    }
+
+    void end_wait()
+    {
+        d_consumer_waiting.store(false, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Records the time from the push of an event to its dispatch
+     */
+    void record_dispatch(const Control_Event& event)
+    {
+        const int64_t latency_ns = now_ns() - event.enqueue_ns;
+        d_latencies_ns.record(latency_ns > 0 ? static_cast<uint64_t>(latency_ns) : 0);
+    }
+
+    /*!
+     * \brief Positions claimed by the producers so far. Every event pushed
+     * before this call has been popped once popped() reaches this value.
+     */
+    uint64_t pushed() const { return d_tail.load(std::memory_order_relaxed); }
+
+    /*!
+     * \brief Positions popped by the consumer so far
+     */
+    uint64_t popped() const { return d_head.load(std::memory_order_relaxed); }
+
+    std::size_t capacity() const { return d_capacity; }
+    uint64_t overflows() const { return d_overflows.load(std::memory_order_relaxed); }
+
+    std::string report() const
+    {
+        std::stringstream str_stream;
+        str_stream << "Control event queue: capacity " << d_capacity << ", " << size() << " queued, "
+                   << overflows() << " sent through the command queue because it was full" << std::endl;
+        str_stream << "Queue depth when a batch is popped: " << d_depths.report("events");
+        str_stream << "Events per batch: " << d_batch_sizes.report("events");
+        str_stream << "Push to dispatch latency: " << d_latencies_ns.report("us", 1e3);
+        return str_stream.str();
+    }
+
+private:
+    class Slot
+    {
+    public:
+        std::atomic<uint64_t> sequence;
+        Control_Event event;
+    };
+
+    static int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::unique_ptr<Slot[]> d_slots;
+    std::size_t d_capacity;
+    std::atomic<uint64_t> d_tail;  // next position to claim, shared by the producers
+    std::atomic<uint64_t> d_head;  // next position to pop, written by the consumer only
+    std::atomic<bool> d_consumer_waiting;
+    std::atomic<uint64_t> d_overflows;
+    std::function<void()> d_wakeup;
+    Log2_Histogram d_depths;
+    Log2_Histogram d_batch_sizes;
+    Log2_Histogram d_latencies_ns;
+};
+
+#endif  // GNSS_SDR_CONTROL_EVENT_QUEUE_H
@@ -48,7 +48,12 @@
 #include "gps_ephemeris.h"         // for Gps_Ephemeris
 #include "gps_iono.h"              // for Gps_Iono
 #include "gps_utc_model.h"         // for Gps_Utc_Model
+#include "latency_tracer.h"        // for Latency_Tracer
+#include "load_governor.h"         // for Load_Governor
+#include "metrics_server.h"        // for Metrics_Server
 #include "pvt_interface.h"         // for PvtInterface
+#include "receiver_state_snapshot.h"
+#include "reconfiguration_event.h"
 #include "rtklib.h"                // for gtime_t, alm_t
 #include "rtklib_conversions.h"    // for alm_to_rtklib
 #include "rtklib_ephemeris.h"      // for alm2pos, eph2pos
@@ -110,9 +115,13 @@ void ControlThread::init()
     // Instantiates a control queue, a GNSS flowgraph, and a control message factory
     control_queue_ = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
     cmd_interface_.set_msg_queue(control_queue_);  // set also the queue pointer for the telecommand thread
+    event_queue_ = std::make_shared<Control_Event_Queue>();
+    set_event_queue_wakeup();
+    cmd_interface_.set_event_queue(event_queue_);
     try
         {
             flowgraph_ = std::make_shared<GNSSFlowgraph>(configuration_, control_queue_);
+            flowgraph_->set_event_queue(event_queue_);
         }
     catch (const boost::bad_lexical_cast &e)
         {
@@ -121,6 +130,9 @@ void ControlThread::init()
     stop_ = false;
     processed_control_messages_ = 0;
     applied_actions_ = 0;
+    last_visibility_update_ = 0;
+    load_governor_interval_s_ = 1.0;
+    warm_started_ = false;
     supl_mcc = 0;
     supl_mns = 0;
     supl_lac = 0;
@@ -235,6 +247,9 @@ void ControlThread::event_dispatcher(bool &valid_event, pmt::pmt_t &msg)
                 {
                     if (receiver_on_standby_ == false)
                         {
+                            // sent here because the event queue was full: the
+                            // earlier events of the channel go first
+                            drain_channel_events();
                             channel_event_sptr new_event;
                             new_event = boost::any_cast<channel_event_sptr>(pmt::any_ref(msg));
                             DLOG(INFO) << "New channel event rx from ch id: " << new_event->channel_id
@@ -244,6 +259,9 @@ void ControlThread::event_dispatcher(bool &valid_event, pmt::pmt_t &msg)
                 }
             else if (pmt::any_ref(msg).type() == typeid(command_event_sptr))
                 {
+                    // e.g. a channel started after its reconfiguration must not
+                    // get the events sent before by the replaced channel
+                    drain_channel_events();
                     command_event_sptr new_event;
                     new_event = boost::any_cast<command_event_sptr>(pmt::any_ref(msg));
                     DLOG(INFO) << "New command event rx from ch id: " << new_event->command_id
@@ -262,6 +280,32 @@ void ControlThread::event_dispatcher(bool &valid_event, pmt::pmt_t &msg)
                             flowgraph_->apply_action(new_event->command_id, new_event->event_type);
                         }
                 }
+            else if (pmt::any_ref(msg).type() == typeid(reconfiguration_event_sptr))
+                {
+                    // the events of the old channel are dispatched before it
+                    // is replaced
+                    drain_channel_events();
+                    reconfiguration_event_sptr new_event;
+                    new_event = boost::any_cast<reconfiguration_event_sptr>(pmt::any_ref(msg));
+                    std::string error;
+                    try
+                        {
+                            if (new_event->conditioner)
+                                {
+                                    flowgraph_->reconfigure_conditioner(new_event->block_id, new_event->properties);
+                                }
+                            else
+                                {
+                                    flowgraph_->reconfigure_channel(new_event->block_id, new_event->properties);
+                                }
+                        }
+                    catch (const std::exception &e)
+                        {
+                            error = e.what();
+                            LOG(WARNING) << "Reconfiguration failed: " << error;
+                        }
+                    new_event->result.set_value(error);
+                }
             else
                 {
                     DLOG(INFO) << "Control Queue: unknown object type!\n";
@@ -272,12 +316,80 @@ void ControlThread::event_dispatcher(bool &valid_event, pmt::pmt_t &msg)
             if (receiver_on_standby_ == false)
                 {
                     // perform non-priority tasks
+                    update_visibility();
                     flowgraph_->acquisition_manager(0);  // start acquisition of untracked satellites
                 }
+            Latency_Tracer::instance().flush_trace();
+        }
+}
+
+
+void ControlThread::govern_load()
+{
+    if (load_governor_ == nullptr)
+        {
+            return;
+        }
+    const auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - last_load_sample_).count() < load_governor_interval_s_)
+        {
+            return;
+        }
+    last_load_sample_ = now;
+    Load_Sample sample;
+    if (flowgraph_->load_sample(sample))
+        {
+            load_governor_->update(sample);
+        }
+}
+
+
+size_t ControlThread::dispatch_channel_events()
+{
+    std::array<Control_Event, 64> events{};
+    const size_t count = event_queue_->pop(events.data(), events.size());
+    for (size_t n = 0; n < count; n++)
+        {
+            processed_control_messages_++;
+            event_queue_->record_dispatch(events[n]);
+            if (receiver_on_standby_ == false)
+                {
+                    DLOG(INFO) << "New channel event rx from ch id: " << events[n].channel_id
+                               << " what: " << events[n].event_type;
+                    flowgraph_->apply_action(events[n].channel_id, events[n].event_type);
+                }
+        }
+    return count;
+}
+
+
+void ControlThread::drain_channel_events()
+{
+    // a slot claimed by another channel may still be being written
+    const uint64_t pushed = event_queue_->pushed();
+    while (event_queue_->popped() < pushed)
+        {
+            if (dispatch_channel_events() == 0)
+                {
+                    std::this_thread::yield();
+                }
         }
 }
 
 
+void ControlThread::set_event_queue_wakeup()
+{
+    const std::weak_ptr<Concurrent_Queue<pmt::pmt_t>> wakeup_queue = control_queue_;
+    event_queue_->set_wakeup([wakeup_queue]() {
+        const auto queue = wakeup_queue.lock();
+        if (queue)
+            {
+                queue->push(pmt::PMT_NIL);
+            }
+    });
+}
+
+
 /*
  * Runs the control thread that manages the receiver control plane
  *
@@ -308,6 +420,21 @@ int ControlThread::run()
             LOG(ERROR) << "Unable to connect flowgraph";
             return 0;
         }
+    // The block performance counters must be on before the flowgraph starts
+    const uint16_t metrics_port = configuration_->property("GNSS-SDR.metrics_port", static_cast<uint16_t>(0));
+    if (metrics_port != 0)
+        {
+            Block_Metrics::enable_counters();
+        }
+    const std::string latency_trace_file = configuration_->property("GNSS-SDR.latency_trace_file", std::string(""));
+    if (configuration_->property("GNSS-SDR.latency_tracing", false) or !latency_trace_file.empty())
+        {
+            Latency_Tracer::instance().set_enabled(true);
+            if (!latency_trace_file.empty())
+                {
+                    Latency_Tracer::instance().open_trace(latency_trace_file, configuration_->property("GNSS-SDR.latency_trace_period_ms", 1000));
+                }
+        }
     // Start the flowgraph
     flowgraph_->start();
     if (flowgraph_->running())
@@ -319,15 +446,42 @@ int ControlThread::run()
             LOG(ERROR) << "Unable to start flowgraph";
             return 0;
         }
+    if (metrics_port != 0)
+        {
+            try
+                {
+                    const std::shared_ptr<GNSSFlowgraph> flowgraph = flowgraph_;
+                    metrics_server_ = std::unique_ptr<Metrics_Server>(new Metrics_Server(metrics_port, [flowgraph]() { return flowgraph->block_samples(); }));
+                }
+            catch (const std::exception &e)
+                {
+                    LOG(WARNING) << "Can't serve the block metrics on port " << metrics_port << ": " << e.what();
+                    std::cout << "Can't serve the block metrics on port " << metrics_port << ": " << e.what() << std::endl;
+                }
+        }
+
+    Load_Governor_Conf load_governor_conf;
+    load_governor_conf.SetFromConfiguration(configuration_.get());
+    if (load_governor_conf.enable)
+        {
+            const std::shared_ptr<GNSSFlowgraph> flowgraph = flowgraph_;
+            load_governor_ = std::unique_ptr<Load_Governor>(new Load_Governor(load_governor_conf,
+                [flowgraph, load_governor_conf](Load_Governor::Level step, bool shed) { return flowgraph->shed_load(step, shed, load_governor_conf); }));
+            load_governor_interval_s_ = load_governor_conf.interval_s;
+            last_load_sample_ = std::chrono::steady_clock::time_point();
+        }
 
     // launch GNSS assistance process AFTER the flowgraph is running because the GNU Radio asynchronous queues must be already running to transport msgs
     assist_GNSS();
+    // all the blocks have read their configuration by now
+    report_unread_configuration();
     // start the keyboard_listener thread
     keyboard_thread_ = std::thread(&ControlThread::keyboard_listener, this);
     sysv_queue_thread_ = std::thread(&ControlThread::sysv_queue_listener, this);
 
     // start the telecommand listener thread
     cmd_interface_.set_pvt(flowgraph_->get_pvt());
+    cmd_interface_.set_search_scheduler(flowgraph_->get_search_scheduler());
     cmd_interface_thread_ = std::thread(&ControlThread::telecommand_listener, this);
 
 #ifdef ENABLE_FPGA
@@ -339,13 +493,32 @@ int ControlThread::run()
     pmt::pmt_t msg;
     while (flowgraph_->running() && !stop_)
         {
-            // read event messages, triggered by event signaling with a 100 ms timeout to perform low priority receiver management tasks
-            bool valid_event = control_queue_->timed_wait_and_pop(msg, 100);
-            // call the new sat dispatcher and receiver controller
-            event_dispatcher(valid_event, msg);
+            govern_load();
+            // channel events are dispatched in batches, the commands one at a time
+            if (dispatch_channel_events() == 0 and event_queue_->begin_wait())
+                {
+                    // read event messages, triggered by event signaling with a 100 ms timeout to perform low priority receiver management tasks
+                    bool valid_event = control_queue_->timed_wait_and_pop(msg, 100);
+                    event_queue_->end_wait();
+                    if (valid_event and pmt::is_null(msg))
+                        {
+                            continue;  // woken up by a channel event
+                        }
+                    // call the new sat dispatcher and receiver controller
+                    event_dispatcher(valid_event, msg);
+                }
+            else if (control_queue_->try_pop(msg) and !pmt::is_null(msg))
+                {
+                    bool valid_event = true;
+                    event_dispatcher(valid_event, msg);
+                }
         }
+    LOG(INFO) << event_queue_->report();
     std::cout << "Stopping GNSS-SDR, please wait!" << std::endl;
+    metrics_server_.reset();
+    load_governor_.reset();
     flowgraph_->stop();
+    Latency_Tracer::instance().close_trace();
     stop_ = true;
     flowgraph_->disconnect();
 
@@ -384,6 +557,7 @@ void ControlThread::set_control_queue(const std::shared_ptr<Concurrent_Queue<pmt
         }
     control_queue_ = control_queue;
     cmd_interface_.set_msg_queue(control_queue_);
+    set_event_queue_wakeup();
 }
 
 
@@ -613,12 +787,156 @@ bool ControlThread::read_assistance_from_XML()
 }
 
 
+namespace
+{
+template <class T>
+void send_assistance_map(GNSSFlowgraph &flowgraph, const std::map<int, T> &assistance_map)
+{
+    for (const auto &entry : assistance_map)
+        {
+            flowgraph.send_telemetry_msg(pmt::make_any(std::make_shared<T>(entry.second)));
+        }
+}
+
+
+template <class T>
+void send_assistance(GNSSFlowgraph &flowgraph, const T &assistance)
+{
+    flowgraph.send_telemetry_msg(pmt::make_any(std::make_shared<T>(assistance)));
+}
+}  // namespace
+
+
+bool ControlThread::read_assistance_from_snapshot()
+{
+    const std::string snapshot_file = configuration_->property("PVT.snapshot_file", std::string(""));
+    if (snapshot_file.empty() or !configuration_->property("GNSS-SDR.warm_start", true))
+        {
+            return false;
+        }
+    Receiver_State_Snapshot snapshot;
+    if (!snapshot.load(snapshot_file))
+        {
+            LOG(INFO) << "No receiver state to warm start from in " << snapshot_file;
+            return false;
+        }
+    const time_t now = time(nullptr);
+    const time_t age_s = now - static_cast<time_t>(snapshot.utc_time_s);
+    std::cout << "Warm start from the receiver state saved " << age_s << " s ago in " << snapshot_file << std::endl;
+
+    // navigation data, as if they had been decoded
+    send_assistance_map(*flowgraph_, snapshot.gps_ephemeris_map);
+    send_assistance_map(*flowgraph_, snapshot.gps_cnav_ephemeris_map);
+    send_assistance_map(*flowgraph_, snapshot.galileo_ephemeris_map);
+    send_assistance_map(*flowgraph_, snapshot.glonass_gnav_ephemeris_map);
+    send_assistance_map(*flowgraph_, snapshot.beidou_dnav_ephemeris_map);
+    send_assistance_map(*flowgraph_, snapshot.gps_almanac_map);
+    send_assistance_map(*flowgraph_, snapshot.galileo_almanac_map);
+    send_assistance_map(*flowgraph_, snapshot.beidou_dnav_almanac_map);
+    if (snapshot.glonass_gnav_almanac.i_satellite_PRN != 0)
+        {
+            send_assistance(*flowgraph_, snapshot.glonass_gnav_almanac);
+        }
+    if (snapshot.gps_iono.valid)
+        {
+            send_assistance(*flowgraph_, snapshot.gps_iono);
+        }
+    if (snapshot.gps_utc_model.valid)
+        {
+            send_assistance(*flowgraph_, snapshot.gps_utc_model);
+        }
+    if (snapshot.gps_cnav_iono.valid)
+        {
+            send_assistance(*flowgraph_, snapshot.gps_cnav_iono);
+        }
+    if (snapshot.gps_cnav_utc_model.valid)
+        {
+            send_assistance(*flowgraph_, snapshot.gps_cnav_utc_model);
+        }
+    if (!snapshot.galileo_ephemeris_map.empty())  // the Galileo models have no valid flag
+        {
+            send_assistance(*flowgraph_, snapshot.galileo_iono);
+            send_assistance(*flowgraph_, snapshot.galileo_utc_model);
+        }
+    if (snapshot.glonass_gnav_utc_model.valid)
+        {
+            send_assistance(*flowgraph_, snapshot.glonass_gnav_utc_model);
+        }
+    if (snapshot.beidou_dnav_iono.valid)
+        {
+            send_assistance(*flowgraph_, snapshot.beidou_dnav_iono);
+        }
+    if (snapshot.beidou_dnav_utc_model.valid)
+        {
+            send_assistance(*flowgraph_, snapshot.beidou_dnav_utc_model);
+        }
+    LOG(INFO) << "Warm start: " << snapshot.gps_ephemeris_map.size() << " GPS, "
+              << snapshot.galileo_ephemeris_map.size() << " Galileo, "
+              << snapshot.glonass_gnav_ephemeris_map.size() << " GLONASS and "
+              << snapshot.beidou_dnav_ephemeris_map.size() << " BeiDou ephemeris, receiver clock drift "
+              << snapshot.rx_clock_drift_ppm << " ppm";
+
+    // last fix, as reference location for the visibility predictions
+    if (snapshot.position_valid)
+        {
+            agnss_ref_location_.lat = snapshot.latitude_deg;
+            agnss_ref_location_.lon = snapshot.longitude_deg;
+            agnss_ref_location_.uncertainty = 0.0;
+            agnss_ref_location_.valid = true;
+            agnss_ref_time_.d_tv_sec = static_cast<double>(now);
+            agnss_ref_time_.valid = true;
+        }
+
+    // Doppler of the GPS satellites, for the assisted acquisition. The
+    // receiver clock drift is already included in the measured Doppler, and
+    // the uncertainty grows with the age of the snapshot.
+    if (age_s >= 0 and age_s < snapshot_doppler_max_age_s)
+        {
+            const double doppler_uncertainty_hz = std::min(5000.0, 250.0 + static_cast<double>(age_s));
+            for (const auto &doppler : snapshot.gps_doppler_hz)
+                {
+                    Gps_Acq_Assist gps_acq;
+                    gps_acq.i_satellite_PRN = doppler.first;
+                    gps_acq.d_Doppler0 = doppler.second;
+                    gps_acq.dopplerUncertainty = doppler_uncertainty_hz;
+                    global_gps_acq_assist_map.write(doppler.first, gps_acq);
+                }
+        }
+    warm_started_ = true;
+    return true;
+}
+
+
+void ControlThread::report_unread_configuration() const
+{
+    const auto file_configuration = std::dynamic_pointer_cast<FileConfiguration>(configuration_);
+    if (file_configuration == nullptr)
+        {
+            return;
+        }
+    const std::vector<std::string> unread = file_configuration->unread_properties();
+    if (unread.empty())
+        {
+            return;
+        }
+    std::string names;
+    for (const auto &name : unread)
+        {
+            names += (names.empty() ? "" : ", ") + name;
+        }
+    LOG(WARNING) << "Unknown or unused configuration parameters: " << names;
+    std::cout << "CONFIGURATION WARNING: the following parameters are not used by the receiver: " << names << std::endl;
+}
+
+
 void ControlThread::assist_GNSS()
 {
     // ######### GNSS Assistance #################################
     // GNSS Assistance configuration
     bool enable_gps_supl_assistance = configuration_->property("GNSS-SDR.SUPL_gps_enabled", false);
     bool enable_agnss_xml = configuration_->property("GNSS-SDR.AGNSS_XML_enabled", false);
+    // receiver state saved by the PVT block in the previous run, if any
+    const bool warm_start = read_assistance_from_snapshot();
     if ((enable_gps_supl_assistance == true) and (enable_agnss_xml == false))
         {
             std::cout << "SUPL RRLP GPS assistance enabled!" << std::endl;
@@ -818,7 +1136,7 @@ void ControlThread::assist_GNSS()
         }
 
     // If AGNSS is enabled, make use of it
-    if ((agnss_ref_location_.valid == true) and ((enable_gps_supl_assistance == true) or (enable_agnss_xml == true)))
+    if ((agnss_ref_location_.valid == true) and ((enable_gps_supl_assistance == true) or (enable_agnss_xml == true) or warm_start))
         {
             // Get the list of visible satellites
             std::array<float, 3> ref_LLH{};
@@ -830,7 +1148,7 @@ void ControlThread::assist_GNSS()
                     ref_rx_utc_time = static_cast<time_t>(agnss_ref_time_.d_tv_sec);
                 }
 
-            std::vector<std::pair<int, Gnss_Satellite>> visible_sats = get_visible_sats(ref_rx_utc_time, ref_LLH);
+            std::vector<std::pair<int, Gnss_Satellite>> visible_sats = get_visible_sats(ref_rx_utc_time, ref_LLH, true, true);
             // Set the receiver in Standby mode
             flowgraph_->apply_action(0, 10);
             // Give priority to visible satellites in the search list
@@ -866,6 +1184,8 @@ void ControlThread::apply_action(unsigned int what)
             // delete all ephemeris and almanac information from maps (also the PVT map queue)
             pvt_ptr = flowgraph_->get_pvt();
             pvt_ptr->clear_ephemeris();
+            // forget the predicted visibility and the failed searches
+            flowgraph_->get_search_scheduler()->clear_visibility();
             // todo: reorder the satellite queues to the receiver default startup order.
             // This is required to allow repeatability. Otherwise the satellite search order will depend on the last tracked satellites
             // start again the satellite acquisitions
@@ -873,7 +1193,7 @@ void ControlThread::apply_action(unsigned int what)
             break;
         case 12:
             LOG(INFO) << "Receiver action HOTSTART";
-            visible_satellites = get_visible_sats(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH());
+            visible_satellites = get_visible_sats(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH(), true, true);
             // reorder the satellite queue to acquire first those visible satellites
             flowgraph_->priorize_satellites(visible_satellites);
             // start again the satellite acquisitions
@@ -884,11 +1204,14 @@ void ControlThread::apply_action(unsigned int what)
             // delete all ephemeris and almanac information from maps (also the PVT map queue)
             pvt_ptr = flowgraph_->get_pvt();
             pvt_ptr->clear_ephemeris();
-            // load the ephemeris and the almanac from XML files (receiver assistance)
-            read_assistance_from_XML();
+            // load the ephemeris and the almanac from the receiver state snapshot or, if there is none, from XML files (receiver assistance)
+            if (!read_assistance_from_snapshot())
+                {
+                    read_assistance_from_XML();
+                }
             // call here the function that computes the set of visible satellites and its elevation
             // for the date and time specified by the warm start command and the assisted position
-            get_visible_sats(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH());
+            visible_satellites = get_visible_sats(cmd_interface_.get_utc_time(), cmd_interface_.get_LLH(), true, true);
             // reorder the satellite queue to acquire first those visible satellites
             flowgraph_->priorize_satellites(visible_satellites);
             // start again the satellite acquisitions
@@ -901,7 +1224,36 @@ void ControlThread::apply_action(unsigned int what)
 }
 
 
-std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time_t rx_utc_time, const std::array<float, 3> &LLH)
+void ControlThread::update_visibility()
+{
+    const time_t now = time(nullptr);
+    if (now - last_visibility_update_ < visibility_update_s)
+        {
+            return;
+        }
+    last_visibility_update_ = now;
+    double longitude_deg;
+    double latitude_deg;
+    double height_m;
+    double ground_speed_kmh;
+    double course_over_ground_deg;
+    time_t UTC_time;
+    if (flowgraph_->get_pvt()->get_latest_PVT(&longitude_deg, &latitude_deg, &height_m, &ground_speed_kmh, &course_over_ground_deg, &UTC_time))
+        {
+            const std::array<float, 3> LLH{static_cast<float>(latitude_deg), static_cast<float>(longitude_deg), static_cast<float>(height_m)};
+            flowgraph_->priorize_satellites(get_visible_sats(UTC_time, LLH, false, true));
+        }
+    else if (warm_started_ and agnss_ref_location_.valid)
+        {
+            // the navigation data of the snapshot reach the PVT block asynchronously,
+            // so the first prediction at startup may have missed some of it
+            const std::array<float, 3> LLH{static_cast<float>(agnss_ref_location_.lat), static_cast<float>(agnss_ref_location_.lon), 0.0F};
+            flowgraph_->priorize_satellites(get_visible_sats(now, LLH, false, true));
+        }
+}
+
+
+std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time_t rx_utc_time, const std::array<float, 3> &LLH, bool verbose, bool below_horizon)
 {
     // 1. Compute rx ECEF position from LLH WGS84
     arma::vec LLH_rad = arma::vec{degtorad(LLH[0]), degtorad(LLH[1]), LLH[2]};
@@ -927,8 +1279,11 @@ std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time
     tstruct = *gmtime(&rx_utc_time);
     strftime(buf, sizeof(buf), "%d/%m/%Y %H:%M:%S ", &tstruct);
     std::string str_time = std::string(buf);
-    std::cout << "Get visible satellites at " << str_time
-              << "UTC, assuming RX position " << LLH[0] << " [deg], " << LLH[1] << " [deg], " << LLH[2] << " [m]" << std::endl;
+    if (verbose)
+        {
+            std::cout << "Get visible satellites at " << str_time
+                      << "UTC, assuming RX position " << LLH[0] << " [deg], " << LLH[1] << " [deg], " << LLH[2] << " [m]" << std::endl;
+        }
 
     std::map<int, Gps_Ephemeris> gps_eph_map = pvt_ptr->get_gps_ephemeris();
     for (auto &it : gps_eph_map)
@@ -946,9 +1301,12 @@ std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time
             arma::vec dx = r_sat_eb_e - r_eb_e;
             topocent(&Az, &El, &dist_m, r_eb_e, dx);
             // push sat
-            if (El > 0)
+            if (El > 0 or below_horizon)
                 {
-                    std::cout << "Using GPS Ephemeris: Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                    if (verbose and El > 0)
+                        {
+                            std::cout << "Using GPS Ephemeris: Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                        }
                     available_satellites.emplace_back(floor(El),
                         (Gnss_Satellite(std::string("GPS"), it.second.i_satellite_PRN)));
                     visible_gps.push_back(it.second.i_satellite_PRN);
@@ -971,9 +1329,12 @@ std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time
             arma::vec dx = r_sat_eb_e - r_eb_e;
             topocent(&Az, &El, &dist_m, r_eb_e, dx);
             // push sat
-            if (El > 0)
+            if (El > 0 or below_horizon)
                 {
-                    std::cout << "Using Galileo Ephemeris: Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                    if (verbose and El > 0)
+                        {
+                            std::cout << "Using Galileo Ephemeris: Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                        }
                     available_satellites.emplace_back(floor(El),
                         (Gnss_Satellite(std::string("Galileo"), it.second.i_satellite_PRN)));
                     visible_gal.push_back(it.second.i_satellite_PRN);
@@ -998,12 +1359,15 @@ std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time
             topocent(&Az, &El, &dist_m, r_eb_e, dx);
             // push sat
             std::vector<unsigned int>::iterator it2;
-            if (El > 0)
+            if (El > 0 or below_horizon)
                 {
                     it2 = std::find(visible_gps.begin(), visible_gps.end(), it.second.i_satellite_PRN);
                     if (it2 == visible_gps.end())
                         {
-                            std::cout << "Using GPS Almanac:  Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                            if (verbose and El > 0)
+                                {
+                                    std::cout << "Using GPS Almanac:  Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                                }
                             available_satellites.emplace_back(floor(El),
                                 (Gnss_Satellite(std::string("GPS"), it.second.i_satellite_PRN)));
                         }
@@ -1028,12 +1392,15 @@ std::vector<std::pair<int, Gnss_Satellite>> ControlThread::get_visible_sats(time
             topocent(&Az, &El, &dist_m, r_eb_e, dx);
             // push sat
             std::vector<unsigned int>::iterator it2;
-            if (El > 0)
+            if (El > 0 or below_horizon)
                 {
                     it2 = std::find(visible_gal.begin(), visible_gal.end(), it.second.i_satellite_PRN);
                     if (it2 == visible_gal.end())
                         {
-                            std::cout << "Using Galileo Almanac:  Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                            if (verbose and El > 0)
+                                {
+                                    std::cout << "Using Galileo Almanac:  Sat " << it.second.i_satellite_PRN << " Az: " << Az << " El: " << El << std::endl;
+                                }
                             available_satellites.emplace_back(floor(El),
                                 (Gnss_Satellite(std::string("Galileo"), it.second.i_satellite_PRN)));
                         }
@@ -27,10 +27,12 @@
 #include "agnss_ref_location.h"    // for Agnss_Ref_Location
 #include "agnss_ref_time.h"        // for Agnss_Ref_Time
 #include "concurrent_queue.h"      // for Concurrent_Queue
+#include "control_event_queue.h"   // for Control_Event_Queue
 #include "gnss_sdr_supl_client.h"  // for Gnss_Sdr_Supl_Client
 #include "tcp_cmd_interface.h"     // for TcpCmdInterface
 #include <pmt/pmt.h>
 #include <array>    // for array
+#include <chrono>   // for steady_clock
 #include <ctime>    // for time_t (gmtime, strftime in implementation)
 #include <memory>   // for shared_ptr
 #include <string>   // for string
@@ -46,6 +48,8 @@
 class ConfigurationInterface;
 class GNSSFlowgraph;
 class Gnss_Satellite;
+class Load_Governor;
+class Metrics_Server;
 
 /*!
  * \brief This class represents the main thread of the application, so the name is ControlThread.
@@ -125,6 +129,22 @@ private:
     bool receiver_on_standby_;
     void event_dispatcher(bool &valid_event, pmt::pmt_t &msg);
 
+    /*
+     * Dispatches a batch of channel events. Returns the number of events
+     */
+    size_t dispatch_channel_events();
+
+    /*
+     * Dispatches all the channel events pushed so far
+     */
+    void drain_channel_events();
+
+    /*
+     * Feeds the load governor, at most once per GNSS-SDR.load_governor_interval_s
+     */
+    void govern_load();
+    void set_event_queue_wakeup();  // the channel events wake up the control thread through the control queue
+
     std::thread cmd_interface_thread_;
 
     // SUPL assistance classes
@@ -140,6 +160,12 @@ private:
     // Read {ephemeris, iono, utc, ref loc, ref time} assistance from a local XML file previously recorded
     bool read_assistance_from_XML();
 
+    /*
+     * Read the navigation data, last fix and Doppler saved by the PVT block
+     * (PVT.snapshot_file) in a previous run. Returns true if a snapshot was loaded.
+     */
+    bool read_assistance_from_snapshot();
+
     /*
      * Blocking function that reads the GPS assistance queue
      */
@@ -148,24 +174,44 @@ private:
     /*
      * Compute elevations for the specified time and position for all the available satellites in ephemeris and almanac queues
      * returns a vector filled with the available satellites ordered from high elevation to low elevation angle.
+     * If below_horizon is true, the satellites below the horizon are also returned, with negative elevations.
+     */
+    std::vector<std::pair<int, Gnss_Satellite>> get_visible_sats(time_t rx_utc_time, const std::array<float, 3> &LLH, bool verbose = true, bool below_horizon = false);
+
+    /*
+     * Predicts the visible satellites from the last position fix (or the one
+     * of the warm start snapshot, until there is a fix), at most once per
+     * visibility_update_s seconds, so that the satellite search favors them
      */
-    std::vector<std::pair<int, Gnss_Satellite>> get_visible_sats(time_t rx_utc_time, const std::array<float, 3> &LLH);
+    void update_visibility();
 
     /*
      * Read initial GNSS assistance from SUPL server or local XML files
      */
     void assist_GNSS();
 
+    /*
+     * Reports the keys of the configuration file that no block has read
+     */
+    void report_unread_configuration() const;
+
     void apply_action(unsigned int what);
     std::shared_ptr<GNSSFlowgraph> flowgraph_;
     std::shared_ptr<ConfigurationInterface> configuration_;
     std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> control_queue_;
+    std::shared_ptr<Control_Event_Queue> event_queue_;  // channel events
+    std::unique_ptr<Metrics_Server> metrics_server_;    // block performance counters, if GNSS-SDR.metrics_port is set
+    std::unique_ptr<Load_Governor> load_governor_;      // sheds load when falling behind real time, if GNSS-SDR.load_governor is set
+    std::chrono::steady_clock::time_point last_load_sample_;
+    double load_governor_interval_s_;
     bool pre_2009_file_;  // to override the system time to postprocess old gnss records and avoid wrong week rollover
     bool stop_;
     bool restart_;
     bool delete_configuration_;
     unsigned int processed_control_messages_;
     unsigned int applied_actions_;
+    time_t last_visibility_update_;
+    bool warm_started_;  // the receiver state was loaded from a snapshot
 
     std::thread keyboard_thread_;
     std::thread sysv_queue_thread_;
@@ -191,6 +237,9 @@ private:
     const std::string gal_almanac_default_xml_filename = "./gal_almanac.xml";
     const std::string gps_almanac_default_xml_filename = "./gps_almanac.xml";
 
+    const time_t visibility_update_s = 60;  // period of the visibility predictions from the last fix
+    const time_t snapshot_doppler_max_age_s = 3600;  // older Doppler estimates are not used to seed the acquisition
+
     Agnss_Ref_Location agnss_ref_location_;
     Agnss_Ref_Time agnss_ref_time_;
 
@@ -27,6 +27,8 @@
 #include "in_memory_configuration.h"
 #include "string_converter.h"
 #include <glog/logging.h>
+#include <algorithm>
+#include <cctype>
 #include <utility>
 
 
@@ -50,6 +52,12 @@ std::string FileConfiguration::property(std::string property_name, std::string d
         {
             return overrided_->property(property_name, default_value);
         }
+    std::string lowercase_name(property_name);
+    std::transform(lowercase_name.begin(), lowercase_name.end(), lowercase_name.begin(), [](unsigned char c) { return std::tolower(c); });
+    {
+        std::lock_guard<std::mutex> lock(read_mutex_);
+        read_properties_.insert(std::move(lowercase_name));
+    }
     return ini_reader_->Get("GNSS-SDR", property_name, default_value);
 }
 
@@ -159,6 +167,33 @@ void FileConfiguration::set_property(std::string property_name, std::string valu
 }
 
 
+void FileConfiguration::supersede_property(const std::string& property_name, const std::string& value)
+{
+    overrided_->supersede_property(property_name, value);
+}
+
+
+void FileConfiguration::erase_property(const std::string& property_name)
+{
+    overrided_->erase_property(property_name);
+}
+
+
+std::vector<std::string> FileConfiguration::unread_properties() const
+{
+    std::vector<std::string> unread;
+    std::lock_guard<std::mutex> lock(read_mutex_);
+    for (const auto& name : ini_reader_->GetNames("GNSS-SDR"))
+        {
+            if (read_properties_.count(name) == 0)
+                {
+                    unread.push_back(name);
+                }
+        }
+    return unread;
+}
+
+
 void FileConfiguration::init()
 {
     converter_ = std::make_shared<StringConverter>();
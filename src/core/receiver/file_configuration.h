@@ -28,7 +28,10 @@
 #include "configuration_interface.h"
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 
 class INIReader;
 class StringConverter;
@@ -60,6 +63,19 @@ public:
     float property(std::string property_name, float default_value);
     double property(std::string property_name, double default_value);
     void set_property(std::string property_name, std::string value);
+    void supersede_property(const std::string& property_name, const std::string& value);
+
+    /*!
+     * \brief Removes a property set by set_property() or
+     * supersede_property(), so that the one in the file (if any) is used again
+     */
+    void erase_property(const std::string& property_name);
+
+    /*!
+     * \brief Returns the names of the properties defined in the file that
+     * have not been read so far, usually misspelled or obsolete keys.
+     */
+    std::vector<std::string> unread_properties() const;
 
 private:
     void init();
@@ -68,6 +84,8 @@ private:
     std::shared_ptr<InMemoryConfiguration> overrided_;
     std::shared_ptr<StringConverter> converter_;
     int error_{};
+    mutable std::mutex read_mutex_;
+    std::set<std::string> read_properties_;  // in lower case, as stored by INIReader
 };
 
 #endif  // GNSS_SDR_FILE_CONFIGURATION_H
@@ -0,0 +1,121 @@
+/*!
+ * \file flowgraph_conf.cc
+ * \brief Class that contains all the configuration parameters read by the
+ * flowgraph while the receiver runs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "flowgraph_conf.h"
+#include <glog/logging.h>
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <thread>
+
+
+Flowgraph_Conf::Flowgraph_Conf()
+{
+    channels_1C = 0U;
+    channels_2S = 0U;
+    channels_L5 = 0U;
+    channels_SBAS = 0U;
+    channels_1B = 0U;
+    channels_5X = 0U;
+    channels_1G = 0U;
+    channels_2G = 0U;
+    channels_B1 = 0U;
+    channels_B3 = 0U;
+    channels_count = 0U;
+    channels_in_acquisition = 0U;
+    multiband = false;
+    assist_dual_frequency_acq = false;
+    search_backoff_s = 5.0;
+    search_backoff_max_s = 120.0;
+    init_threads = 1U;
+    default_channel_.satellite = 0U;
+    default_channel_.rf_channel_id = 0;
+}
+
+
+void Flowgraph_Conf::SetFromConfiguration(ConfigurationInterface *configuration)
+{
+    channels_1C = configuration->property("Channels_1C.count", 0U);
+    channels_2S = configuration->property("Channels_2S.count", 0U);
+    channels_L5 = configuration->property("Channels_L5.count", 0U);
+    channels_SBAS = configuration->property("Channels_SBAS.count", 0U);
+    channels_1B = configuration->property("Channels_1B.count", 0U);
+    channels_5X = configuration->property("Channels_5X.count", 0U);
+    channels_1G = configuration->property("Channels_1G.count", 0U);
+    channels_2G = configuration->property("Channels_2G.count", 0U);
+    channels_B1 = configuration->property("Channels_B1.count", 0U);
+    channels_B3 = configuration->property("Channels_B3.count", 0U);
+    // as created by GNSSBlockFactory::GetChannels, which has no SBAS channels
+    channels_count = channels_1C + channels_2S + channels_L5 + channels_1B + channels_5X +
+                     channels_1G + channels_2G + channels_B1 + channels_B3;
+
+    channels_in_acquisition = configuration->property("Channels.in_acquisition", channels_count);
+
+    multiband = (channels_1C > 0 and (channels_2S > 0 or channels_L5 > 0)) or
+                (channels_1B > 0 and channels_5X > 0) or
+                (channels_1G > 0 and channels_2G > 0) or
+                (channels_B1 > 0 and channels_B3 > 0);
+    assist_dual_frequency_acq = configuration->property("GNSS-SDR.assist_dual_frequency_acq", multiband);
+
+    search_backoff_s = configuration->property("GNSS-SDR.search_backoff_s", search_backoff_s);
+    search_backoff_max_s = configuration->property("GNSS-SDR.search_backoff_max_s", search_backoff_max_s);
+    if (search_backoff_max_s < search_backoff_s)
+        {
+            LOG(WARNING) << "GNSS-SDR.search_backoff_max_s is smaller than GNSS-SDR.search_backoff_s. Using " << search_backoff_s;
+            search_backoff_max_s = search_backoff_s;
+        }
+
+    init_threads = configuration->property("GNSS-SDR.init_threads", 0U);
+    if (init_threads == 0)
+        {
+            init_threads = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+
+    channels_.assign(channels_count, default_channel_);
+    for (uint32_t n = 0; n < channels_count; n++)
+        {
+            const std::string role = "Channel" + std::to_string(n);
+            try
+                {
+                    channels_[n].satellite = configuration->property(role + ".satellite", 0U);
+                }
+            catch (const std::exception &e)
+                {
+                    LOG(WARNING) << role << ".satellite: " << e.what();
+                }
+            try
+                {
+                    channels_[n].rf_channel_id = configuration->property(role + ".RF_channel_ID", 0);
+                }
+            catch (const std::exception &e)
+                {
+                    LOG(WARNING) << role << ".RF_channel_ID: " << e.what();
+                }
+        }
+}
+
+
+const Channel_Conf &Flowgraph_Conf::channel(uint32_t channel) const
+{
+    if (channel < channels_.size())
+        {
+            return channels_[channel];
+        }
+    return default_channel_;
+}
@@ -0,0 +1,88 @@
+/*!
+ * \file flowgraph_conf.h
+ * \brief Class that contains all the configuration parameters read by the
+ * flowgraph while the receiver runs
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FLOWGRAPH_CONF_H
+#define GNSS_SDR_FLOWGRAPH_CONF_H
+
+#include "configuration_interface.h"
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief Configuration of a channel, as seen by the flowgraph
+ */
+class Channel_Conf
+{
+public:
+    uint32_t satellite;     // PRN the channel is fixed to, or 0 if any
+    int32_t rf_channel_id;  // signal conditioner the channel is connected to
+};
+
+
+/*!
+ * \brief Configuration parameters of the flowgraph.
+ *
+ * They are read and validated once, when the flowgraph is created, so that
+ * the acquisition manager and the signal search do not look up (and parse)
+ * string keys every time a channel changes its state.
+ */
+class Flowgraph_Conf
+{
+public:
+    Flowgraph_Conf();
+
+    void SetFromConfiguration(ConfigurationInterface *configuration);
+
+    /*!
+     * \brief Configuration of a channel. Channels beyond the configured
+     * ones get the defaults (any satellite, first signal conditioner).
+     */
+    const Channel_Conf &channel(uint32_t channel) const;
+
+    /* Channels per signal */
+    uint32_t channels_1C;
+    uint32_t channels_2S;
+    uint32_t channels_L5;
+    uint32_t channels_SBAS;
+    uint32_t channels_1B;
+    uint32_t channels_5X;
+    uint32_t channels_1G;
+    uint32_t channels_2G;
+    uint32_t channels_B1;
+    uint32_t channels_B3;
+    uint32_t channels_count;
+    uint32_t channels_in_acquisition;
+
+    /* Acquisition of secondary frequencies */
+    bool multiband;
+    bool assist_dual_frequency_acq;
+
+    /* Backoff of a satellite after a failed acquisition, in seconds */
+    double search_backoff_s;
+    double search_backoff_max_s;
+
+    /* Threads used to set up the channels at startup (0 for one per core) */
+    uint32_t init_threads;
+
+private:
+    std::vector<Channel_Conf> channels_;
+    Channel_Conf default_channel_;
+};
+
+#endif  // GNSS_SDR_FLOWGRAPH_CONF_H
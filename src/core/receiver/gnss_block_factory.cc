@@ -36,6 +36,7 @@
 #include "beidou_b3i_telemetry_decoder.h"
 #include "byte_to_short.h"
 #include "channel.h"
+#include "channelizer_conditioner.h"
 #include "configuration_interface.h"
 #include "direct_resampler_conditioner.h"
 #include "file_signal_source.h"
@@ -82,6 +83,7 @@
 #include "ibyte_to_complex.h"
 #include "ibyte_to_cshort.h"
 #include "in_memory_configuration.h"
+#include "iq_archive_signal_source.h"
 #include "ishort_to_complex.h"
 #include "ishort_to_cshort.h"
 #include "labsat_signal_source.h"
@@ -91,10 +93,12 @@
 #include "notch_filter_lite.h"
 #include "nsr_file_signal_source.h"
 #include "pass_through.h"
+#include "polyphase_resampler_conditioner.h"
 #include "pulse_blanking_filter.h"
 #include "rtklib_pvt.h"
 #include "rtl_tcp_signal_source.h"
 #include "sbas_l1_telemetry_decoder.h"
+#include "shm_bus_signal_source.h"
 #include "signal_conditioner.h"
 #include "spir_file_signal_source.h"
 #include "spir_gss6450_file_signal_source.h"
@@ -211,6 +215,14 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetSignalConditioner(
         }
     std::string signal_conditioner = configuration->property(role_conditioner + ".implementation", default_implementation);
 
+    if (signal_conditioner == "Channelizer_Conditioner")
+        {
+            // a single block that replaces the whole chain
+            LOG(INFO) << "Getting SignalConditioner with Channelizer_Conditioner implementation";
+            std::unique_ptr<GNSSBlockInterface> conditioner_(new ChannelizerConditioner(configuration.get(), role_conditioner, 1, 1));
+            return conditioner_;
+        }
+
     std::string data_type_adapter;
     std::string input_filter;
     std::string resampler;
@@ -1211,6 +1223,65 @@ std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GNSSBlockFacto
 }
 
 
+std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel(
+    const std::shared_ptr<ConfigurationInterface>& configuration,
+    const std::string& signal, int channel,
+    const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue)
+{
+    const std::string default_implementation = "Pass_Through";
+    const std::string id = std::to_string(channel);
+    // (i.e. Acquisition_1C0.implementation=xxxx), same as in GetChannels()
+    const std::string acquisition_implementation = configuration->property(
+        "Acquisition_" + signal + id + ".implementation",
+        configuration->property("Acquisition_" + signal + ".implementation", default_implementation));
+    const std::string tracking_implementation = configuration->property(
+        "Tracking_" + signal + id + ".implementation",
+        configuration->property("Tracking_" + signal + ".implementation", default_implementation));
+    const std::string telemetry_decoder_implementation = configuration->property(
+        "TelemetryDecoder_" + signal + id + ".implementation",
+        configuration->property("TelemetryDecoder_" + signal + ".implementation", default_implementation));
+
+    if (signal == "1C")
+        {
+            return GetChannel_1C(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "2S")
+        {
+            return GetChannel_2S(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "L5")
+        {
+            return GetChannel_L5(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "1B")
+        {
+            return GetChannel_1B(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "5X")
+        {
+            return GetChannel_5X(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "1G")
+        {
+            return GetChannel_1G(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "2G")
+        {
+            return GetChannel_2G(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "B1")
+        {
+            return GetChannel_B1(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    if (signal == "B3")
+        {
+            return GetChannel_B3(configuration, acquisition_implementation, tracking_implementation, telemetry_decoder_implementation, channel, queue);
+        }
+    LOG(WARNING) << "Unknown signal " << signal << " for channel " << channel;
+    return nullptr;
+}
+
+
 /*
  * Returns the block with the required configuration and implementation
  *
@@ -1260,6 +1331,36 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetBlock(
                     block = std::move(block_);
                 }
 
+            catch (const std::exception& e)
+                {
+                    std::cout << "GNSS-SDR program ended." << std::endl;
+                    exit(1);
+                }
+        }
+    else if (implementation == "Iq_Archive_Signal_Source")
+        {
+            try
+                {
+                    std::unique_ptr<GNSSBlockInterface> block_(new IqArchiveSignalSource(configuration.get(), role, in_streams,
+                        out_streams, queue));
+                    block = std::move(block_);
+                }
+
+            catch (const std::exception& e)
+                {
+                    std::cout << "GNSS-SDR program ended." << std::endl;
+                    exit(1);
+                }
+        }
+    else if (implementation == "Shm_Bus_Signal_Source")
+        {
+            try
+                {
+                    std::unique_ptr<GNSSBlockInterface> block_(new ShmBusSignalSource(configuration.get(), role, in_streams,
+                        out_streams, queue));
+                    block = std::move(block_);
+                }
+
             catch (const std::exception& e)
                 {
                     std::cout << "GNSS-SDR program ended." << std::endl;
@@ -1535,6 +1636,13 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetBlock(
             block = std::move(block_);
         }
 
+    else if (implementation == "Polyphase_Resampler")
+        {
+            std::unique_ptr<GNSSBlockInterface> block_(new PolyphaseResamplerConditioner(configuration.get(), role,
+                in_streams, out_streams));
+            block = std::move(block_);
+        }
+
     // ACQUISITION BLOCKS ---------------------------------------------------------
     else if (implementation == "GPS_L1_CA_PCPS_Acquisition")
         {
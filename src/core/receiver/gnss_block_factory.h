@@ -56,6 +56,15 @@ public:
     std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GetChannels(const std::shared_ptr<ConfigurationInterface>& configuration,
         const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue);  // NOLINT(performance-unnecessary-value-param)
 
+    /*!
+     * \brief Returns a new channel of the given signal ("1C", "1B", ...) with
+     * the given absolute id, as GetChannels() would build it from the current
+     * configuration
+     */
+    std::unique_ptr<GNSSBlockInterface> GetChannel(const std::shared_ptr<ConfigurationInterface>& configuration,
+        const std::string& signal, int channel,
+        const std::shared_ptr<Concurrent_Queue<pmt::pmt_t>>& queue);
+
     std::unique_ptr<GNSSBlockInterface> GetObservables(const std::shared_ptr<ConfigurationInterface>& configuration);
 
     std::unique_ptr<GNSSBlockInterface> GetPVT(const std::shared_ptr<ConfigurationInterface>& configuration);
@@ -27,14 +27,19 @@
 #include "GPS_L5.h"
 #include "Galileo_E1.h"
 #include "Galileo_E5a.h"
+#include "array_signal_conditioner.h"
 #include "channel.h"
 #include "channel_fsm.h"
 #include "channel_interface.h"
+#include "channelizer_conditioner.h"
+#include "command_event.h"
 #include "configuration_interface.h"
+#include "fft_plan_registry.h"
 #include "gnss_block_factory.h"
 #include "gnss_block_interface.h"
 #include "gnss_satellite.h"
 #include "gnss_synchro_monitor.h"
+#include "shm_bus_sink.h"
 #include <boost/lexical_cast.hpp>    // for boost::lexical_cast
 #include <boost/tokenizer.hpp>       // for boost::tokenizer
 #include <glog/logging.h>            // for LOG
@@ -44,13 +49,16 @@
 #include <gnuradio/top_block.h>      // for top_block, make_top_block
 #include <pmt/pmt_sugar.h>           // for mp
 #include <algorithm>                 // for transform, sort, unique
+#include <atomic>                    // for atomic
 #include <cmath>                     // for floor
 #include <cstddef>                   // for size_t
 #include <exception>                 // for exception
+#include <iomanip>                   // for setprecision
 #include <iostream>                  // for operator<<
 #include <iterator>                  // for insert_iterator, inserter
 #include <memory>                    // for std::shared_ptr
 #include <set>                       // for set
+#include <sstream>                   // for stringstream
 #include <stdexcept>                 // for invalid_argument
 #include <thread>                    // for thread
 #ifdef GR_GREATER_38
@@ -67,9 +75,13 @@ GNSSFlowgraph::GNSSFlowgraph(std::shared_ptr<ConfigurationInterface> configurati
 {
     connected_ = false;
     running_ = false;
+    monitor_decimation_factor_ = 1;
+    startup_mark_ = std::chrono::steady_clock::now();
     configuration_ = std::move(configuration);
     queue_ = queue;
+    flowgraph_conf_.SetFromConfiguration(configuration_.get());
     multiband_ = GNSSFlowgraph::is_multiband();
+    search_scheduler_ = std::make_shared<Satellite_Search_Scheduler>();
     init();
 }
 
@@ -80,6 +92,8 @@ GNSSFlowgraph::~GNSSFlowgraph()
         {
             GNSSFlowgraph::disconnect();
         }
+    // the plans must not outlive GNU Radio, and the registry is static
+    Fft_Plan_Registry::instance().clear();
 }
 
 
@@ -124,6 +138,10 @@ void GNSSFlowgraph::connect()
             LOG(WARNING) << "flowgraph already connected";
             return;
         }
+    startup_mark_ = std::chrono::steady_clock::now();
+    stream_edges_.clear();
+    message_edges_.clear();
+    acq_resampler_latency_.assign(channels_count_, 0);
 
 #ifndef ENABLE_FPGA
     for (int i = 0; i < sources_count_; i++)
@@ -221,7 +239,7 @@ void GNSSFlowgraph::connect()
                             for (int j = 0; j < GNSS_SDR_ARRAY_SIGNAL_CONDITIONER_CHANNELS; j++)
                                 {
                                     std::cout << "connecting ch " << j << std::endl;
-                                    top_block_->connect(sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(i)->get_left_block(), j);
+                                    connect_stream(sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(i)->get_left_block(), j);
                                 }
                         }
                     else
@@ -243,8 +261,9 @@ void GNSSFlowgraph::connect()
                                             if (sig_conditioner_.size() > signal_conditioner_ID)
                                                 {
                                                     LOG(INFO) << "connecting sig_source_ " << i << " stream " << j << " to conditioner " << j;
-                                                    top_block_->connect(sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                                    connect_stream(sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
                                                 }
+                                            connect_shm_bus_tap(i, j, sig_source_.at(i)->get_right_block(), j);
                                         }
                                     else
                                         {
@@ -252,13 +271,15 @@ void GNSSFlowgraph::connect()
                                                 {
                                                     // RF_channel 0 backward compatibility with single channel sources
                                                     LOG(INFO) << "connecting sig_source_ " << i << " stream " << 0 << " to conditioner " << j;
-                                                    top_block_->connect(sig_source_.at(i)->get_right_block(), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                                    connect_stream(sig_source_.at(i)->get_right_block(), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                                    connect_shm_bus_tap(i, j, sig_source_.at(i)->get_right_block(), 0);
                                                 }
                                             else
                                                 {
                                                     // Multiple channel sources using multiple output blocks of single channel (requires RF_channel selector in call)
                                                     LOG(INFO) << "connecting sig_source_ " << i << " stream " << j << " to conditioner " << j;
-                                                    top_block_->connect(sig_source_.at(i)->get_right_block(j), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                                    connect_stream(sig_source_.at(i)->get_right_block(j), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                                    connect_shm_bus_tap(i, j, sig_source_.at(i)->get_right_block(j), 0);
                                                 }
                                         }
                                     signal_conditioner_ID++;
@@ -276,7 +297,7 @@ void GNSSFlowgraph::connect()
     DLOG(INFO) << "Signal source connected to signal conditioner";
 #endif
 
-#if ENABLE_FPGA
+#ifdef ENABLE_FPGA
     if (configuration_->property(sig_source_.at(0)->role() + ".enable_FPGA", false) == false)
         {
             // connect the signal source to sample counter
@@ -292,8 +313,8 @@ void GNSSFlowgraph::connect()
                         }
                     int observable_interval_ms = static_cast<double>(configuration_->property("GNSS-SDR.observable_interval_ms", 20));
                     ch_out_sample_counter = gnss_sdr_make_sample_counter(fs, observable_interval_ms, sig_conditioner_.at(0)->get_right_block()->output_signature()->sizeof_stream_item(0));
-                    top_block_->connect(sig_conditioner_.at(0)->get_right_block(), 0, ch_out_sample_counter, 0);
-                    top_block_->connect(ch_out_sample_counter, 0, observables_->get_left_block(), channels_count_);  // extra port for the sample counter pulse
+                    connect_stream(sig_conditioner_.at(0)->get_right_block(), 0, ch_out_sample_counter, 0);
+                    connect_stream(ch_out_sample_counter, 0, observables_->get_left_block(), channels_count_);  // extra port for the sample counter pulse
                 }
             catch (const std::exception& e)
                 {
@@ -317,7 +338,7 @@ void GNSSFlowgraph::connect()
                         }
                     int observable_interval_ms = static_cast<double>(configuration_->property("GNSS-SDR.observable_interval_ms", 20));
                     ch_out_fpga_sample_counter = gnss_sdr_make_fpga_sample_counter(fs, observable_interval_ms);
-                    top_block_->connect(ch_out_fpga_sample_counter, 0, observables_->get_left_block(), channels_count_);  // extra port for the sample counter pulse
+                    connect_stream(ch_out_fpga_sample_counter, 0, observables_->get_left_block(), channels_count_);  // extra port for the sample counter pulse
                 }
             catch (const std::exception& e)
                 {
@@ -342,8 +363,8 @@ void GNSSFlowgraph::connect()
 
             int observable_interval_ms = static_cast<double>(configuration_->property("GNSS-SDR.observable_interval_ms", 20));
             ch_out_sample_counter = gnss_sdr_make_sample_counter(fs, observable_interval_ms, sig_conditioner_.at(0)->get_right_block()->output_signature()->sizeof_stream_item(0));
-            top_block_->connect(sig_conditioner_.at(0)->get_right_block(), 0, ch_out_sample_counter, 0);
-            top_block_->connect(ch_out_sample_counter, 0, observables_->get_left_block(), channels_count_);  // extra port for the sample counter pulse
+            connect_stream(sig_conditioner_.at(0)->get_right_block(), 0, ch_out_sample_counter, 0);
+            connect_stream(ch_out_sample_counter, 0, observables_->get_left_block(), channels_count_);  // extra port for the sample counter pulse
         }
     catch (const std::exception& e)
         {
@@ -355,10 +376,10 @@ void GNSSFlowgraph::connect()
 #endif
 
     // Signal conditioner (selected_signal_source) >> channels (i) (dependent of their associated SignalSource_ID)
-    std::vector<bool> signal_conditioner_connected;
+    std::vector<std::vector<bool>> signal_conditioner_connected;
     for (size_t n = 0; n < sig_conditioner_.size(); n++)
         {
-            signal_conditioner_connected.push_back(false);
+            signal_conditioner_connected.emplace_back(conditioner_outputs(n), false);
         }
     for (unsigned int i = 0; i < channels_count_; i++)
         {
@@ -368,14 +389,8 @@ void GNSSFlowgraph::connect()
             uint32_t fs = configuration_->property("GNSS-SDR.internal_fs_sps", 0);
             if (configuration_->property(sig_source_.at(0)->role() + ".enable_FPGA", false) == false)
                 {
-                    try
-                        {
-                            selected_signal_conditioner_ID = configuration_->property("Channel" + std::to_string(i) + ".RF_channel_ID", 0);
-                        }
-                    catch (const std::exception& e)
-                        {
-                            LOG(WARNING) << e.what();
-                        }
+                    selected_signal_conditioner_ID = flowgraph_conf_.channel(i).rf_channel_id;
+                    const int conditioner_port = conditioner_output_port(selected_signal_conditioner_ID, i);
                     try
                         {
                             // Enable automatic resampler for the acquisition, if required
@@ -424,7 +439,7 @@ void GNSSFlowgraph::connect()
                                     if (acq_fs < fs)
                                         {
                                             // check if the resampler is already created for the channel system/signal and for the specific RF Channel
-                                            std::string map_key = channels_.at(i)->implementation() + std::to_string(selected_signal_conditioner_ID);
+                                            std::string map_key = channels_.at(i)->implementation() + std::to_string(selected_signal_conditioner_ID) + "." + std::to_string(conditioner_port);
                                             resampler_ratio = static_cast<double>(fs) / acq_fs;
                                             int decimation = floor(resampler_ratio);
                                             while (fs % decimation > 0)
@@ -465,7 +480,7 @@ void GNSSFlowgraph::connect()
                                                     ret = acq_resamplers_.insert(std::pair<std::string, gr::basic_block_sptr>(map_key, fir_filter_ccf_));
                                                     if (ret.second == true)
                                                         {
-                                                            top_block_->connect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), 0,
+                                                            connect_stream(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), conditioner_port,
                                                                 acq_resamplers_.at(map_key), 0);
                                                             LOG(INFO) << "Created "
                                                                       << channels_.at(i)->implementation()
@@ -478,34 +493,35 @@ void GNSSFlowgraph::connect()
                                                                       << " acquisition resampler for RF channel " << std::to_string(signal_conditioner_ID) << " with " << taps.size() << " taps and decimation factor of " << decimation;
                                                         }
 
-                                                    top_block_->connect(acq_resamplers_.at(map_key), 0,
+                                                    connect_stream(acq_resamplers_.at(map_key), 0,
                                                         channels_.at(i)->get_left_block_acq(), 0);
 
                                                     std::shared_ptr<Channel> channel_ptr;
                                                     channel_ptr = std::dynamic_pointer_cast<Channel>(channels_.at(i));
-                                                    channel_ptr->acquisition()->set_resampler_latency((taps.size() - 1) / 2);
+                                                    acq_resampler_latency_.at(i) = (taps.size() - 1) / 2;
+                                                    channel_ptr->acquisition()->set_resampler_latency(acq_resampler_latency_.at(i));
                                                 }
                                             else
                                                 {
                                                     LOG(INFO) << "Disabled acquisition resampler because the input sampling frequency is too low";
                                                     // resampler not required!
-                                                    top_block_->connect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), 0,
+                                                    connect_stream(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), conditioner_port,
                                                         channels_.at(i)->get_left_block_acq(), 0);
                                                 }
                                         }
                                     else
                                         {
                                             LOG(INFO) << "Disabled acquisition resampler because the input sampling frequency is too low";
-                                            top_block_->connect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), 0,
+                                            connect_stream(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), conditioner_port,
                                                 channels_.at(i)->get_left_block_acq(), 0);
                                         }
                                 }
                             else
                                 {
-                                    top_block_->connect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), 0,
+                                    connect_stream(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), conditioner_port,
                                         channels_.at(i)->get_left_block_acq(), 0);
                                 }
-                            top_block_->connect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), 0,
+                            connect_stream(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), conditioner_port,
                                 channels_.at(i)->get_left_block_trk(), 0);
                         }
                     catch (const std::exception& e)
@@ -515,14 +531,14 @@ void GNSSFlowgraph::connect()
                             top_block_->disconnect_all();
                             return;
                         }
-                    signal_conditioner_connected.at(selected_signal_conditioner_ID) = true;  // notify that this signal conditioner is connected
+                    signal_conditioner_connected.at(selected_signal_conditioner_ID).at(conditioner_port) = true;  // notify that this signal conditioner is connected
                     DLOG(INFO) << "signal conditioner " << selected_signal_conditioner_ID << " connected to channel " << i;
                 }
 #endif
             // Signal Source > Signal conditioner >> Channels >> Observables
             try
                 {
-                    top_block_->connect(channels_.at(i)->get_right_block(), 0,
+                    connect_stream(channels_.at(i)->get_right_block(), 0,
                         observables_->get_left_block(), i);
                 }
             catch (const std::exception& e)
@@ -539,12 +555,15 @@ void GNSSFlowgraph::connect()
         {
             for (size_t n = 0; n < sig_conditioner_.size(); n++)
                 {
-                    if (signal_conditioner_connected.at(n) == false)
+                    for (size_t port = 0; port < signal_conditioner_connected.at(n).size(); port++)
                         {
-                            null_sinks_.push_back(gr::blocks::null_sink::make(sizeof(gr_complex)));
-                            top_block_->connect(sig_conditioner_.at(n)->get_right_block(), 0,
-                                null_sinks_.back(), 0);
-                            LOG(INFO) << "Null sink connected to signal conditioner " << n << " due to lack of connection to any channel" << std::endl;
+                            if (signal_conditioner_connected.at(n).at(port) == false)
+                                {
+                                    null_sinks_.push_back(gr::blocks::null_sink::make(sizeof(gr_complex)));
+                                    connect_stream(sig_conditioner_.at(n)->get_right_block(), port,
+                                        null_sinks_.back(), 0);
+                                    LOG(INFO) << "Null sink connected to signal conditioner " << n << " output " << port << " due to lack of connection to any channel" << std::endl;
+                                }
                         }
                 }
         }
@@ -553,15 +572,7 @@ void GNSSFlowgraph::connect()
     std::vector<unsigned int> vector_of_channels;
     for (unsigned int i = 0; i < channels_count_; i++)
         {
-            unsigned int sat = 0;
-            try
-                {
-                    sat = configuration_->property("Channel" + std::to_string(i) + ".satellite", 0);
-                }
-            catch (const std::exception& e)
-                {
-                    LOG(WARNING) << e.what();
-                }
+            unsigned int sat = flowgraph_conf_.channel(i).satellite;
             if (sat == 0)
                 {
                     vector_of_channels.push_back(i);
@@ -573,112 +584,86 @@ void GNSSFlowgraph::connect()
                 }
         }
 
-    // Assign satellites to channels in the initialization
+    mark_startup_phase("block connections");
+
+    // Assign satellites to channels in the initialization. The signals are
+    // taken from the search queues in order, then the channels generate their
+    // local codes in parallel
+    std::vector<std::pair<unsigned int, Gnss_Signal>> assignments;
     for (unsigned int& i : vector_of_channels)
         {
             std::string gnss_signal = channels_.at(i)->get_signal().get_signal_str();  // use channel's implicit signal
-            unsigned int sat = 0;
-            try
-                {
-                    sat = configuration_->property("Channel" + std::to_string(i) + ".satellite", 0);
-                }
-            catch (const std::exception& e)
-                {
-                    LOG(WARNING) << e.what();
-                }
+            unsigned int sat = flowgraph_conf_.channel(i).satellite;
             if (sat == 0)
                 {
                     bool assistance_available;
                     float estimated_doppler;
                     double RX_time;
                     bool is_primary_freq;
-                    channels_.at(i)->set_signal(search_next_signal(gnss_signal, false, is_primary_freq, assistance_available, estimated_doppler, RX_time));
+                    Gnss_Signal signal_value;
+                    if (search_next_signal(gnss_signal, false, signal_value, is_primary_freq, assistance_available, estimated_doppler, RX_time))
+                        {
+                            assignments.emplace_back(i, signal_value);
+                        }
                 }
             else
                 {
                     std::string gnss_system;
-                    Gnss_Signal signal_value;
                     switch (mapStringValues_[gnss_signal])
                         {
                         case evGPS_1C:
-                            gnss_system = "GPS";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GPS_1C_signals_.remove(signal_value);
-                            break;
-
                         case evGPS_2S:
-                            gnss_system = "GPS";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GPS_2S_signals_.remove(signal_value);
-                            break;
-
                         case evGPS_L5:
                             gnss_system = "GPS";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GPS_L5_signals_.remove(signal_value);
                             break;
 
                         case evGAL_1B:
-                            gnss_system = "Galileo";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GAL_1B_signals_.remove(signal_value);
-                            break;
-
                         case evGAL_5X:
                             gnss_system = "Galileo";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GAL_5X_signals_.remove(signal_value);
                             break;
 
                         case evGLO_1G:
-                            gnss_system = "Glonass";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GLO_1G_signals_.remove(signal_value);
-                            break;
-
                         case evGLO_2G:
                             gnss_system = "Glonass";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GLO_2G_signals_.remove(signal_value);
                             break;
 
                         case evBDS_B1:
-                            gnss_system = "Beidou";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_BDS_B1_signals_.remove(signal_value);
-                            break;
-
                         case evBDS_B3:
                             gnss_system = "Beidou";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_BDS_B3_signals_.remove(signal_value);
                             break;
 
                         default:
                             LOG(ERROR) << "This should not happen :-(";
                             gnss_system = "GPS";
-                            signal_value = Gnss_Signal(Gnss_Satellite(gnss_system, sat), gnss_signal);
-                            available_GPS_1C_signals_.remove(signal_value);
                             break;
                         }
+                    const Gnss_Signal signal_value(Gnss_Satellite(gnss_system, sat), gnss_signal);
+                    search_scheduler_->remove(signal_value);
 
-                    channels_.at(i)->set_signal(signal_value);
+                    assignments.emplace_back(i, signal_value);
                 }
         }
+    set_channel_signals(assignments);
+    mark_startup_phase("satellite assignment");
+
+    // Plan the FFTs that the acquisition will use at the same time now,
+    // instead of when the first satellites are being searched
+    Fft_Plan_Registry::instance().warm_up(max_acq_channels_);
+    mark_startup_phase("FFT planning");
 
     // Connect the observables output of each channel to the PVT block
     try
         {
             for (unsigned int i = 0; i < channels_count_; i++)
                 {
-                    top_block_->connect(observables_->get_right_block(), i, pvt_->get_left_block(), i);
-                    top_block_->msg_connect(channels_.at(i)->get_right_block(), pmt::mp("telemetry"), pvt_->get_left_block(), pmt::mp("telemetry"));
+                    connect_stream(observables_->get_right_block(), i, pvt_->get_left_block(), i);
+                    connect_message(channels_.at(i)->get_right_block(), pmt::mp("telemetry"), pvt_->get_left_block(), pmt::mp("telemetry"));
                 }
 
-            top_block_->msg_connect(observables_->get_right_block(), pmt::mp("status"), channels_status_, pmt::mp("status"));
+            connect_message(observables_->get_right_block(), pmt::mp("status"), channels_status_, pmt::mp("status"));
 
-            top_block_->msg_connect(pvt_->get_left_block(), pmt::mp("pvt_to_observables"), observables_->get_right_block(), pmt::mp("pvt_to_observables"));
-            top_block_->msg_connect(pvt_->get_left_block(), pmt::mp("status"), channels_status_, pmt::mp("status"));
+            connect_message(pvt_->get_left_block(), pmt::mp("pvt_to_observables"), observables_->get_right_block(), pmt::mp("pvt_to_observables"));
+            connect_message(pvt_->get_left_block(), pmt::mp("status"), channels_status_, pmt::mp("status"));
         }
     catch (const std::exception& e)
         {
@@ -695,7 +680,7 @@ void GNSSFlowgraph::connect()
                 {
                     for (unsigned int i = 0; i < channels_count_; i++)
                         {
-                            top_block_->connect(observables_->get_right_block(), i, GnssSynchroMonitor_, i);
+                            connect_stream(observables_->get_right_block(), i, GnssSynchroMonitor_, i);
                         }
                 }
             catch (const std::exception& e)
@@ -725,6 +710,622 @@ void GNSSFlowgraph::connect()
     connected_ = true;
     LOG(INFO) << "Flowgraph connected";
     top_block_->dump();
+
+    double startup_s = 0.0;
+    std::stringstream phases;
+    for (const auto& phase : startup_phases_)
+        {
+            startup_s += phase.second;
+            phases << (phases.tellp() > 0 ? ", " : "") << phase.first << " " << std::fixed << std::setprecision(2) << phase.second << " s";
+        }
+    std::cout << "Receiver set up in " << std::fixed << std::setprecision(2) << startup_s << " s (" << phases.str()
+              << "; " << Fft_Plan_Registry::instance().get_created() << " FFT plans)" << std::endl;
+}
+
+
+void GNSSFlowgraph::set_channel_signals(const std::vector<std::pair<unsigned int, Gnss_Signal>>& assignments)
+{
+    // Each channel is set by a single thread. Channel construction stays
+    // sequential: GNU Radio does not support creating blocks concurrently
+    std::atomic<size_t> next_assignment(0);
+    auto set_signals = [&]() {
+        for (size_t n = next_assignment++; n < assignments.size(); n = next_assignment++)
+            {
+                try
+                    {
+                        channels_.at(assignments[n].first)->set_signal(assignments[n].second);
+                    }
+                catch (const std::exception& e)
+                    {
+                        LOG(ERROR) << "Can't set the signal of channel " << assignments[n].first << ": " << e.what();
+                    }
+            }
+    };
+    const size_t threads_count = std::min(static_cast<size_t>(flowgraph_conf_.init_threads), assignments.size());
+    std::vector<std::thread> threads;
+    for (size_t n = 1; n < threads_count; n++)
+        {
+            threads.emplace_back(set_signals);
+        }
+    set_signals();
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+}
+
+
+void GNSSFlowgraph::set_event_queue(const std::shared_ptr<Control_Event_Queue>& event_queue)
+{
+    event_queue_ = event_queue;  // for the channels built by reconfigure_channel()
+    for (const auto& channel : channels_)
+        {
+            const auto channel_ptr = std::dynamic_pointer_cast<Channel>(channel);
+            if (channel_ptr)
+                {
+                    channel_ptr->set_event_queue(event_queue);
+                }
+        }
+}
+
+
+void GNSSFlowgraph::mark_startup_phase(const std::string& phase)
+{
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed_s = std::chrono::duration<double>(now - startup_mark_).count();
+    startup_mark_ = now;
+    startup_phases_.emplace_back(phase, elapsed_s);
+    LOG(INFO) << "Startup phase " << phase << " took " << elapsed_s << " s";
+}
+
+
+size_t GNSSFlowgraph::conditioner_outputs(size_t conditioner) const
+{
+    const auto channelizer = std::dynamic_pointer_cast<ChannelizerConditioner>(sig_conditioner_.at(conditioner));
+    if (channelizer)
+        {
+            return channelizer->subbands();
+        }
+    const auto array_conditioner = std::dynamic_pointer_cast<ArraySignalConditioner>(sig_conditioner_.at(conditioner));
+    return array_conditioner ? array_conditioner->beams() : 1;
+}
+
+
+int GNSSFlowgraph::conditioner_output_port(int conditioner, unsigned int channel) const
+{
+    // A multi-beam array conditioner delivers each beam on its own port
+    const auto array_conditioner = std::dynamic_pointer_cast<ArraySignalConditioner>(sig_conditioner_.at(conditioner));
+    if (array_conditioner && array_conditioner->beams() > 1)
+        {
+            const int beam = array_conditioner->output_port(channels_.at(channel)->implementation(), channel);
+            if (beam < 0)
+                {
+                    LOG(WARNING) << "No beam of " << array_conditioner->role() << " is assigned to channel " << channel
+                                 << " (" << channels_.at(channel)->implementation() << "). Using beam 0.";
+                    return 0;
+                }
+            return beam;
+        }
+
+    // A channelizer delivers each band on its own port
+    const auto channelizer = std::dynamic_pointer_cast<ChannelizerConditioner>(sig_conditioner_.at(conditioner));
+    if (!channelizer)
+        {
+            return 0;
+        }
+    const int port = channelizer->output_port(channels_.at(channel)->implementation());
+    if (port < 0)
+        {
+            LOG(WARNING) << "No sub-band of " << channelizer->role() << " carries the " << channels_.at(channel)->implementation()
+                         << " signal of channel " << channel << ". Using sub-band 0.";
+            return 0;
+        }
+    return port;
+}
+
+
+void GNSSFlowgraph::connect_shm_bus_tap(int source, int rf_channel, const gr::basic_block_sptr& block, int port)
+{
+    // Other receivers can read this source with Shm_Bus_Signal_Source
+    const std::string role = sig_source_.at(source)->role();
+    std::string bus_name = configuration_->property(role + ".shm_bus_name", std::string(""));
+    if (bus_name.empty())
+        {
+            return;
+        }
+    if (rf_channel > 0)
+        {
+            bus_name += "." + std::to_string(rf_channel);
+        }
+    const size_t item_size = sig_source_.at(source)->item_size();
+    const uint64_t buffer_bytes = configuration_->property(role + ".shm_bus_buffer_bytes", static_cast<uint64_t>(268435456));
+    const double fs = configuration_->property(role + ".sampling_frequency", configuration_->property("GNSS-SDR.internal_fs_sps", 0.0));
+    Shm_Bus_Tap tap;
+    tap.block = block;
+    tap.port = port;
+    tap.sink = shm_bus_make_sink(bus_name, item_size, buffer_bytes / item_size, fs);
+    top_block_->connect(block, port, tap.sink, 0);
+    shm_bus_taps_.push_back(tap);
+    LOG(INFO) << "Signal source " << source << " RF channel " << rf_channel << " published on the sample bus " << bus_name;
+}
+
+
+void GNSSFlowgraph::connect_stream(const gr::basic_block_sptr& src, int src_port, const gr::basic_block_sptr& dst, int dst_port)
+{
+    top_block_->connect(src, src_port, dst, dst_port);
+    stream_edges_.push_back(Stream_Edge{src, src_port, dst, dst_port});
+}
+
+
+void GNSSFlowgraph::connect_message(const gr::basic_block_sptr& src, const pmt::pmt_t& src_port, const gr::basic_block_sptr& dst, const pmt::pmt_t& dst_port)
+{
+    top_block_->msg_connect(src, src_port, dst, dst_port);
+    message_edges_.push_back(Message_Edge{src, src_port, dst, dst_port});
+}
+
+
+void GNSSFlowgraph::move_edges(const std::vector<std::pair<gr::basic_block_sptr, gr::basic_block_sptr>>& replacements)
+{
+    const auto replace = [&replacements](const gr::basic_block_sptr& block) {
+        for (const auto& replacement : replacements)
+            {
+                if (replacement.first == block)
+                    {
+                        return replacement.second;
+                    }
+            }
+        return block;
+    };
+    for (auto& edge : stream_edges_)
+        {
+            const gr::basic_block_sptr src = replace(edge.src);
+            const gr::basic_block_sptr dst = replace(edge.dst);
+            if (src != edge.src or dst != edge.dst)
+                {
+                    top_block_->disconnect(edge.src, edge.src_port, edge.dst, edge.dst_port);
+                    try
+                        {
+                            top_block_->connect(src, edge.src_port, dst, edge.dst_port);
+                        }
+                    catch (const std::exception& e)
+                        {
+                            top_block_->connect(edge.src, edge.src_port, edge.dst, edge.dst_port);
+                            throw;
+                        }
+                    edge.src = src;
+                    edge.dst = dst;
+                }
+        }
+    for (auto& edge : message_edges_)
+        {
+            const gr::basic_block_sptr src = replace(edge.src);
+            const gr::basic_block_sptr dst = replace(edge.dst);
+            if (src != edge.src or dst != edge.dst)
+                {
+                    top_block_->msg_disconnect(edge.src, edge.src_port, edge.dst, edge.dst_port);
+                    top_block_->msg_connect(src, edge.src_port, dst, edge.dst_port);
+                    edge.src = src;
+                    edge.dst = dst;
+                }
+        }
+}
+
+
+void GNSSFlowgraph::swap_block(const std::shared_ptr<GNSSBlockInterface>& old_block,
+    const std::shared_ptr<GNSSBlockInterface>& new_block,
+    const std::vector<std::pair<gr::basic_block_sptr, gr::basic_block_sptr>>& replacements)
+{
+    // The scheduler only stops while the edges are moved. The rest of the
+    // blocks keep their state and the samples in their buffers.
+    top_block_->lock();
+    try
+        {
+            new_block->connect(top_block_);
+            move_edges(replacements);
+            old_block->disconnect(top_block_);
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << "Can't replace " << old_block->role() << ": " << e.what();
+            std::vector<std::pair<gr::basic_block_sptr, gr::basic_block_sptr>> undo;
+            for (const auto& replacement : replacements)
+                {
+                    undo.emplace_back(replacement.second, replacement.first);
+                }
+            try
+                {
+                    move_edges(undo);
+                    new_block->disconnect(top_block_);
+                }
+            catch (const std::exception& undo_error)
+                {
+                    LOG(ERROR) << "Can't restore " << old_block->role() << ": " << undo_error.what();
+                }
+            top_block_->unlock();
+            throw;
+        }
+    top_block_->unlock();
+}
+
+
+std::vector<Block_Sample> GNSSFlowgraph::block_samples()
+{
+    std::lock_guard<std::mutex> lock(signal_list_mutex);  // the blocks can be replaced by reconfigure_channel()
+    std::vector<Block_Sample> samples;
+    std::set<gr::basic_block*> sampled;
+    const auto add = [&samples, &sampled](const std::string& name, int32_t channel, const gr::basic_block_sptr& block) {
+        if (block != nullptr and sampled.insert(block.get()).second)
+            {
+                samples.push_back(Block_Metrics::sample(name, channel, block));
+            }
+    };
+    const auto add_block = [&add](const std::shared_ptr<GNSSBlockInterface>& block) {
+        const gr::basic_block_sptr left = block->get_left_block();
+        const gr::basic_block_sptr right = block->get_right_block();
+        if (left != right)
+            {
+                add(block->role() + ".first", -1, left);
+                add(block->role() + ".last", -1, right);
+            }
+        else
+            {
+                add(block->role(), -1, right);
+            }
+    };
+
+    for (const auto& source : sig_source_)
+        {
+            add(source->role(), -1, source->get_right_block());
+        }
+    for (const auto& conditioner : sig_conditioner_)
+        {
+            add_block(conditioner);
+        }
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            const std::string name = "Channel" + std::to_string(i);
+            add(name + ".acquisition", static_cast<int32_t>(i), channels_[i]->get_left_block_acq());
+            add(name + ".tracking", static_cast<int32_t>(i), channels_[i]->get_left_block_trk());
+            add(name + ".telemetry", static_cast<int32_t>(i), channels_[i]->get_right_block());
+        }
+    add_block(observables_);
+    add_block(pvt_);
+    // resamplers, sample counter, monitor...
+    for (const auto& edge : stream_edges_)
+        {
+            add(edge.src->alias(), -1, edge.src);
+            add(edge.dst->alias(), -1, edge.dst);
+        }
+    return samples;
+}
+
+
+bool GNSSFlowgraph::load_sample(Load_Sample& sample)
+{
+    std::lock_guard<std::mutex> lock(signal_list_mutex);  // the blocks can be replaced by reconfigure_channel()
+    if (!running_ or ch_out_sample_counter == nullptr or ch_out_sample_counter->detail() == nullptr)
+        {
+            return false;
+        }
+    sample.time_s = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    sample.sample_time_s = static_cast<double>(ch_out_sample_counter->nitems_read(0)) / ch_out_sample_counter->sampling_frequency();
+    // the slowest channel holds the output buffer of the signal conditioner
+    sample.buffer_occupancy = 0.0;
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            sample.buffer_occupancy = std::max(sample.buffer_occupancy, Load_Governor::buffer_occupancy(channels_[i]->get_left_block_trk()));
+#ifndef ENABLE_FPGA
+            sample.buffer_occupancy = std::max(sample.buffer_occupancy, Load_Governor::buffer_occupancy(channels_[i]->get_left_block_acq()));
+#endif
+        }
+    return true;
+}
+
+
+bool GNSSFlowgraph::shed_load(Load_Governor::Level step, bool shed, const Load_Governor_Conf& conf)
+{
+    std::lock_guard<std::mutex> lock(signal_list_mutex);
+    switch (step)
+        {
+        case Load_Governor::Acquisition_Suspended:
+            search_scheduler_->set_high_priority_only(shed);
+            if (!shed)
+                {
+                    // the idle channels may be waiting for a signal to search
+                    acquisition_manager(channels_count_ - 1);
+                }
+            return true;
+        case Load_Governor::Correlators_Reduced:
+            {
+                bool reduced = false;
+                for (unsigned int i = 0; i < channels_count_; i++)
+                    {
+                        const auto channel_ptr = std::dynamic_pointer_cast<Channel>(channels_[i]);
+                        if (channel_ptr != nullptr and channel_ptr->tracking()->reduce_correlators(shed))
+                            {
+                                reduced = true;
+                            }
+                    }
+                return reduced;
+            }
+        case Load_Governor::Monitor_Decimated:
+            {
+                if (!enable_monitor_ or conf.monitor_decimation <= 1)
+                    {
+                        return false;
+                    }
+#if GNURADIO_USES_STD_POINTERS
+                const auto monitor = std::dynamic_pointer_cast<gnss_synchro_monitor>(GnssSynchroMonitor_);
+#else
+                const auto monitor = boost::dynamic_pointer_cast<gnss_synchro_monitor>(GnssSynchroMonitor_);
+#endif
+                if (shed)
+                    {
+                        monitor_decimation_factor_ = monitor->decimation_factor();
+                        monitor->set_decimation_factor(monitor_decimation_factor_ * conf.monitor_decimation);
+                    }
+                else
+                    {
+                        monitor->set_decimation_factor(monitor_decimation_factor_);
+                    }
+                return true;
+            }
+        case Load_Governor::Channels_Released:
+            if (shed)
+                {
+                    // release the tracked channel with the weakest signal
+                    const std::map<int, std::shared_ptr<Gnss_Synchro>> current_channels_status = channels_status_->get_current_status_map();
+                    unsigned int tracked = 0;
+                    unsigned int weakest = channels_count_;
+                    double weakest_cn0 = 0.0;
+                    for (unsigned int i = 0; i < channels_count_; i++)
+                        {
+                            if (channels_state_[i] != 2)
+                                {
+                                    continue;
+                                }
+                            tracked++;
+                            const auto status = current_channels_status.find(static_cast<int>(i));
+                            const double cn0 = status != current_channels_status.end() ? status->second->CN0_dB_hz : 0.0;
+                            if (weakest == channels_count_ or cn0 < weakest_cn0)
+                                {
+                                    weakest = i;
+                                    weakest_cn0 = cn0;
+                                }
+                        }
+                    if (tracked <= conf.min_channels)
+                        {
+                            return false;
+                        }
+                    LOG(INFO) << "Releasing channel " << weakest << " (" << channels_[weakest]->get_signal().get_satellite()
+                              << ", C/N0 " << weakest_cn0 << " dB-Hz) to shed load";
+                    // the satellite backs off as after a failed acquisition
+                    stop_channel(weakest, true);
+                    released_channels_.push_back(weakest);
+                    return true;
+                }
+            while (!released_channels_.empty())
+                {
+                    const unsigned int ch = released_channels_.back();
+                    released_channels_.pop_back();
+                    if (channels_state_[ch] == 3)  // not started by a telecommand meanwhile
+                        {
+                            channels_state_[ch] = 0;
+                            LOG(INFO) << "Channel " << ch << " restarted";
+                            acquisition_manager(ch == 0 ? channels_count_ - 1 : ch - 1);  // this channel first
+                            return true;
+                        }
+                }
+            return false;
+        default:
+            return false;
+        }
+}
+
+
+void GNSSFlowgraph::reconfigure_channel(unsigned int ch, const std::vector<std::pair<std::string, std::string>>& properties)
+{
+#ifdef ENABLE_FPGA
+    throw std::runtime_error("channels cannot be reconfigured in FPGA receivers");
+#else
+    std::lock_guard<std::mutex> lock(signal_list_mutex);
+    if (!connected_)
+        {
+            throw std::runtime_error("the flowgraph is not connected");
+        }
+    if (ch >= channels_count_)
+        {
+            throw std::out_of_range("there is no channel " + std::to_string(ch));
+        }
+    check_properties(properties);
+    const std::shared_ptr<ChannelInterface> old_channel = channels_[ch];
+    const std::vector<std::pair<std::string, std::string>> previous = set_properties(properties);
+
+    // Build the new channel while the old one keeps working
+    GNSSBlockFactory block_factory;
+    std::shared_ptr<ChannelInterface> new_channel;
+    try
+        {
+            std::shared_ptr<GNSSBlockInterface> block = block_factory.GetChannel(configuration_, old_channel->get_signal().get_signal_str(), ch, queue_);
+            new_channel = std::dynamic_pointer_cast<ChannelInterface>(block);
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << e.what();
+        }
+    if (new_channel == nullptr)
+        {
+            restore_properties(properties, previous);
+            throw std::runtime_error("can't build channel " + std::to_string(ch) + " with the new configuration");
+        }
+    const auto channel_ptr = std::dynamic_pointer_cast<Channel>(new_channel);
+    if (channel_ptr and event_queue_)
+        {
+            channel_ptr->set_event_queue(event_queue_);
+        }
+
+    // Release the satellite of the old channel
+    const unsigned int state = channels_state_[ch];
+    const unsigned int sat = flowgraph_conf_.channel(ch).satellite;
+    const Gnss_Signal old_signal = old_channel->get_signal();
+    if (state == 1 or state == 2)
+        {
+            old_channel->stop_channel();
+            if (state == 1 and acq_channels_count_ > 0)
+                {
+                    acq_channels_count_--;
+                }
+            if (sat == 0)
+                {
+                    push_back_signal(old_signal);
+                }
+        }
+    channels_state_[ch] = 3;
+
+    try
+        {
+            swap_block(old_channel, new_channel,
+                {{old_channel->get_left_block_acq(), new_channel->get_left_block_acq()},
+                    {old_channel->get_left_block_trk(), new_channel->get_left_block_trk()},
+                    {old_channel->get_right_block(), new_channel->get_right_block()}});
+        }
+    catch (const std::exception& e)
+        {
+            restore_properties(properties, previous);
+            channels_state_[ch] = state == 3 ? 3 : 0;
+            if (state != 3)
+                {
+                    acquisition_manager(ch == 0 ? channels_count_ - 1 : ch - 1);
+                }
+            throw std::runtime_error("can't connect channel " + std::to_string(ch) + ": " + e.what());
+        }
+    channels_[ch] = new_channel;
+    if (channel_ptr and acq_resampler_latency_.at(ch) > 0)
+        {
+            channel_ptr->acquisition()->set_resampler_latency(acq_resampler_latency_.at(ch));
+        }
+    if (sat != 0)
+        {
+            new_channel->set_signal(old_signal);
+        }
+    LOG(INFO) << "Channel " << ch << " rebuilt with " << properties.size() << " new properties";
+
+    // A stopped channel stays stopped, the others are started again by a
+    // command queued after the events that the old channel may have sent,
+    // which are ignored while the channel is stopped
+    if (state != 3)
+        {
+            queue_->push(pmt::make_any(command_event_make(400 + ch, 21)));
+        }
+#endif
+}
+
+
+void GNSSFlowgraph::reconfigure_conditioner(unsigned int id, const std::vector<std::pair<std::string, std::string>>& properties)
+{
+#ifdef ENABLE_FPGA
+    throw std::runtime_error("signal conditioners cannot be reconfigured in FPGA receivers");
+#else
+    std::lock_guard<std::mutex> lock(signal_list_mutex);
+    if (!connected_)
+        {
+            throw std::runtime_error("the flowgraph is not connected");
+        }
+    if (id >= sig_conditioner_.size())
+        {
+            throw std::out_of_range("there is no signal conditioner " + std::to_string(id));
+        }
+    const std::shared_ptr<GNSSBlockInterface> old_conditioner = sig_conditioner_[id];
+    if (old_conditioner->implementation() == "Array_Signal_Conditioner")
+        {
+            throw std::runtime_error("array signal conditioners cannot be reconfigured");
+        }
+    check_properties(properties);
+    const std::vector<std::pair<std::string, std::string>> previous = set_properties(properties);
+
+    GNSSBlockFactory block_factory;
+    std::shared_ptr<GNSSBlockInterface> new_conditioner;
+    try
+        {
+            // see init(): old configuration files have a single conditioner without ID
+            new_conditioner = block_factory.GetSignalConditioner(configuration_, old_conditioner->role() == "SignalConditioner" ? -1 : static_cast<int>(id));
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << e.what();
+        }
+    if (new_conditioner == nullptr)
+        {
+            restore_properties(properties, previous);
+            throw std::runtime_error("can't build signal conditioner " + std::to_string(id) + " with the new configuration");
+        }
+
+    try
+        {
+            swap_block(old_conditioner, new_conditioner,
+                {{old_conditioner->get_left_block(), new_conditioner->get_left_block()},
+                    {old_conditioner->get_right_block(), new_conditioner->get_right_block()}});
+        }
+    catch (const std::exception& e)
+        {
+            restore_properties(properties, previous);
+            throw std::runtime_error("can't connect signal conditioner " + std::to_string(id) + ": " + e.what());
+        }
+    sig_conditioner_[id] = new_conditioner;
+    LOG(INFO) << "Signal conditioner " << id << " rebuilt with " << properties.size() << " new properties";
+#endif
+}
+
+
+void GNSSFlowgraph::check_properties(const std::vector<std::pair<std::string, std::string>>& properties)
+{
+    // These are read once, when the flowgraph is created (see Flowgraph_Conf),
+    // and define how the blocks are connected
+    for (const auto& property : properties)
+        {
+            const std::string& key = property.first;
+            const size_t dot = key.find('.');
+            const std::string role = key.substr(0, dot);
+            const std::string name = dot == std::string::npos ? "" : key.substr(dot + 1);
+            if (role == "GNSS-SDR" or role.compare(0, 8, "Channels") == 0 or
+                (role.compare(0, 7, "Channel") == 0 and (name == "satellite" or name == "RF_channel_ID" or name == "signal")))
+                {
+                    throw std::invalid_argument(key + " cannot be changed while the receiver is running");
+                }
+        }
+}
+
+
+std::vector<std::pair<std::string, std::string>> GNSSFlowgraph::set_properties(const std::vector<std::pair<std::string, std::string>>& properties)
+{
+    // Returns the previous values of the ones that were set, to undo the change
+    std::vector<std::pair<std::string, std::string>> previous;
+    for (const auto& property : properties)
+        {
+            const std::string value = configuration_->property(property.first, std::string(""));
+            if (!value.empty())
+                {
+                    previous.emplace_back(property.first, value);
+                }
+            configuration_->supersede_property(property.first, property.second);
+        }
+    return previous;
+}
+
+
+void GNSSFlowgraph::restore_properties(const std::vector<std::pair<std::string, std::string>>& properties,
+    const std::vector<std::pair<std::string, std::string>>& previous)
+{
+    // the properties that were not set are removed, so that the factory
+    // falls back to the generic keys again (e.g. Tracking_1C.implementation)
+    for (const auto& property : properties)
+        {
+            configuration_->erase_property(property.first);
+        }
+    for (const auto& property : previous)
+        {
+            configuration_->supersede_property(property.first, property.second);
+        }
 }
 
 
@@ -738,6 +1339,12 @@ void GNSSFlowgraph::disconnect()
             return;
         }
     connected_ = false;
+    for (const auto& tap : shm_bus_taps_)
+        {
+            top_block_->disconnect(tap.block, tap.port, tap.sink, 0);
+        }
+    shm_bus_taps_.clear();
+
     // Signal Source (i) >  Signal conditioner (i) >
     int RF_Channels = 0;
     int signal_conditioner_ID = 0;
@@ -897,25 +1504,15 @@ void GNSSFlowgraph::disconnect()
             top_block_->disconnect_all();
             return;
         }
-#endif
-    // Signal conditioner (selected_signal_source) >> channels (i) (dependent of their associated SignalSource_ID)
-    for (unsigned int i = 0; i < channels_count_; i++)
-        {
-#ifndef ENABLE_FPGA
-            int selected_signal_conditioner_ID;
-            try
-                {
-                    selected_signal_conditioner_ID = configuration_->property("Channel" + std::to_string(i) + ".RF_channel_ID", 0);
-                }
-            catch (const std::exception& e)
-                {
-                    LOG(WARNING) << e.what();
-                    top_block_->disconnect_all();
-                    return;
-                }
+#endif
+    // Signal conditioner (selected_signal_source) >> channels (i) (dependent of their associated SignalSource_ID)
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+#ifndef ENABLE_FPGA
+            const int selected_signal_conditioner_ID = flowgraph_conf_.channel(i).rf_channel_id;
             try
                 {
-                    top_block_->disconnect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), 0,
+                    top_block_->disconnect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), conditioner_output_port(selected_signal_conditioner_ID, i),
                         channels_.at(i)->get_left_block_trk(), 0);
                 }
             catch (const std::exception& e)
@@ -1025,6 +1622,8 @@ void GNSSFlowgraph::disconnect()
             return;
         }
 
+    stream_edges_.clear();
+    message_edges_.clear();
     DLOG(INFO) << "blocks disconnected internally";
     LOG(INFO) << "Flowgraph disconnected";
 }
@@ -1052,106 +1651,15 @@ bool GNSSFlowgraph::send_telemetry_msg(const pmt::pmt_t& msg)
 }
 
 
-void GNSSFlowgraph::push_back_signal(const Gnss_Signal& gs)
+void GNSSFlowgraph::push_back_signal(const Gnss_Signal& gs, bool failed)
 {
-    switch (mapStringValues_[gs.get_signal_str()])
-        {
-        case evGPS_1C:
-            available_GPS_1C_signals_.remove(gs);
-            available_GPS_1C_signals_.push_back(gs);
-            break;
-
-        case evGPS_2S:
-            available_GPS_2S_signals_.remove(gs);
-            available_GPS_2S_signals_.push_back(gs);
-            break;
-
-        case evGPS_L5:
-            available_GPS_L5_signals_.remove(gs);
-            available_GPS_L5_signals_.push_back(gs);
-            break;
-
-        case evGAL_1B:
-            available_GAL_1B_signals_.remove(gs);
-            available_GAL_1B_signals_.push_back(gs);
-            break;
-
-        case evGAL_5X:
-            available_GAL_5X_signals_.remove(gs);
-            available_GAL_5X_signals_.push_back(gs);
-            break;
-
-        case evGLO_1G:
-            available_GLO_1G_signals_.remove(gs);
-            available_GLO_1G_signals_.push_back(gs);
-            break;
-
-        case evGLO_2G:
-            available_GLO_2G_signals_.remove(gs);
-            available_GLO_2G_signals_.push_back(gs);
-            break;
-
-        case evBDS_B1:
-            available_BDS_B1_signals_.remove(gs);
-            available_BDS_B1_signals_.push_back(gs);
-            break;
-
-        case evBDS_B3:
-            available_BDS_B3_signals_.remove(gs);
-            available_BDS_B3_signals_.push_back(gs);
-            break;
-
-        default:
-            LOG(ERROR) << "This should not happen :-(";
-            break;
-        }
+    search_scheduler_->push_back(gs, failed);
 }
 
 
 void GNSSFlowgraph::remove_signal(const Gnss_Signal& gs)
 {
-    switch (mapStringValues_[gs.get_signal_str()])
-        {
-        case evGPS_1C:
-            available_GPS_1C_signals_.remove(gs);
-            break;
-
-        case evGPS_2S:
-            available_GPS_2S_signals_.remove(gs);
-            break;
-
-        case evGPS_L5:
-            available_GPS_L5_signals_.remove(gs);
-            break;
-
-        case evGAL_1B:
-            available_GAL_1B_signals_.remove(gs);
-            break;
-
-        case evGAL_5X:
-            available_GAL_5X_signals_.remove(gs);
-            break;
-
-        case evGLO_1G:
-            available_GLO_1G_signals_.remove(gs);
-            break;
-
-        case evGLO_2G:
-            available_GLO_2G_signals_.remove(gs);
-            break;
-
-        case evBDS_B1:
-            available_BDS_B1_signals_.remove(gs);
-            break;
-
-        case evBDS_B3:
-            available_BDS_B3_signals_.remove(gs);
-            break;
-
-        default:
-            LOG(ERROR) << "This should not happen :-(";
-            break;
-        }
+    search_scheduler_->remove(gs);
 }
 
 
@@ -1177,77 +1685,97 @@ double GNSSFlowgraph::project_doppler(const std::string& searched_signal, double
 
 void GNSSFlowgraph::acquisition_manager(unsigned int who)
 {
-    unsigned int current_channel;
+    // Idle channels, in round-robin order starting after the one that
+    // generated the event, and channels in acquisition per constellation
+    std::vector<unsigned int> idle_channels;
+    std::vector<std::string> channel_system(channels_count_);
+    std::map<std::string, unsigned int> acquisitions_per_system;
     for (unsigned int i = 0; i < channels_count_; i++)
         {
-            current_channel = (i + who + 1) % channels_count_;
-            unsigned int sat_ = 0;
-            try
+            const unsigned int current_channel = (i + who + 1) % channels_count_;
+            channel_system[current_channel] = channels_[current_channel]->get_signal().get_satellite().get_system();
+            if (channels_state_[current_channel] == 0)
                 {
-                    sat_ = configuration_->property("Channel" + std::to_string(current_channel) + ".satellite", 0);
+                    idle_channels.push_back(current_channel);
                 }
-            catch (const std::exception& e)
+            else if (channels_state_[current_channel] == 1)
                 {
-                    LOG(WARNING) << e.what();
+                    acquisitions_per_system[channel_system[current_channel]]++;
                 }
-            if ((acq_channels_count_ < max_acq_channels_) && (channels_state_[current_channel] == 0))
+        }
+
+    while ((acq_channels_count_ < max_acq_channels_) && !idle_channels.empty())
+        {
+            // Give the free acquisition slot to the constellation with fewer
+            // channels in acquisition, so that one with many channels cannot
+            // starve the others
+            const auto next_channel = std::min_element(idle_channels.begin(), idle_channels.end(),
+                [&](unsigned int a, unsigned int b) { return acquisitions_per_system[channel_system[a]] < acquisitions_per_system[channel_system[b]]; });
+            const unsigned int current_channel = *next_channel;
+            idle_channels.erase(next_channel);
+
+            unsigned int sat_ = flowgraph_conf_.channel(current_channel).satellite;
+            bool is_primary_freq = true;
+            bool assistance_available = false;
+            bool start_acquisition = false;
+            Gnss_Signal gnss_signal;
+            float estimated_doppler;
+            double RX_time;
+
+            if (sat_ == 0)
                 {
-                    bool is_primary_freq = true;
-                    bool assistance_available = false;
-                    bool start_acquisition = false;
-                    Gnss_Signal gnss_signal;
-                    float estimated_doppler;
-                    double RX_time;
+                    if (!search_next_signal(channels_[current_channel]->get_signal().get_signal_str(),
+                            true,
+                            gnss_signal,
+                            is_primary_freq,
+                            assistance_available,
+                            estimated_doppler,
+                            RX_time))
+                        {
+                            // all the satellites of this signal are already assigned
+                            continue;
+                        }
+                    channels_[current_channel]->set_signal(gnss_signal);
+                    start_acquisition = is_primary_freq or assistance_available or !flowgraph_conf_.assist_dual_frequency_acq;
+                }
+            else
+                {
+                    channels_[current_channel]->set_signal(channels_[current_channel]->get_signal());
+                    start_acquisition = true;
+                }
 
-                    if (sat_ == 0)
+            if (start_acquisition == true)
+                {
+                    channels_state_[current_channel] = 1;
+                    acq_channels_count_++;
+                    acquisitions_per_system[channel_system[current_channel]]++;
+                    DLOG(INFO) << "Channel " << current_channel
+                               << " Starting acquisition " << channels_[current_channel]->get_signal().get_satellite()
+                               << ", Signal " << channels_[current_channel]->get_signal().get_signal_str();
+                    if (assistance_available == true and flowgraph_conf_.assist_dual_frequency_acq)
                         {
-                            gnss_signal = search_next_signal(channels_[current_channel]->get_signal().get_signal_str(),
-                                true,
-                                is_primary_freq,
-                                assistance_available,
-                                estimated_doppler,
-                                RX_time);
-                            channels_[current_channel]->set_signal(gnss_signal);
-                            start_acquisition = is_primary_freq or assistance_available or !configuration_->property("GNSS-SDR.assist_dual_frequency_acq", multiband_);
+                            channels_[current_channel]->assist_acquisition_doppler(project_doppler(channels_[current_channel]->get_signal().get_signal_str(), estimated_doppler));
                         }
                     else
                         {
-                            channels_[current_channel]->set_signal(channels_[current_channel]->get_signal());
-                            start_acquisition = true;
+                            // set Doppler center to 0 Hz
+                            channels_[current_channel]->assist_acquisition_doppler(0);
                         }
-
-                    if (start_acquisition == true)
-                        {
-                            channels_state_[current_channel] = 1;
-                            acq_channels_count_++;
-                            DLOG(INFO) << "Channel " << current_channel
-                                       << " Starting acquisition " << channels_[current_channel]->get_signal().get_satellite()
-                                       << ", Signal " << channels_[current_channel]->get_signal().get_signal_str();
-                            if (assistance_available == true and configuration_->property("GNSS-SDR.assist_dual_frequency_acq", multiband_))
-                                {
-                                    channels_[current_channel]->assist_acquisition_doppler(project_doppler(channels_[current_channel]->get_signal().get_signal_str(), estimated_doppler));
-                                }
-                            else
-                                {
-                                    // set Doppler center to 0 Hz
-                                    channels_[current_channel]->assist_acquisition_doppler(0);
-                                }
 #ifndef ENABLE_FPGA
-                            channels_[current_channel]->start_acquisition();
+                    channels_[current_channel]->start_acquisition();
 #else
-                            // create a task for the FPGA such that it doesn't stop the flow
-                            std::thread tmp_thread(&ChannelInterface::start_acquisition, channels_[current_channel]);
-                            tmp_thread.detach();
+                    // create a task for the FPGA such that it doesn't stop the flow
+                    std::thread tmp_thread(&ChannelInterface::start_acquisition, channels_[current_channel]);
+                    tmp_thread.detach();
 #endif
-                        }
-                    else
-                        {
-                            push_back_signal(gnss_signal);
-                            DLOG(INFO) << "Channel " << current_channel
-                                       << " secondary frequency acquisition assistance not available in "
-                                       << channels_[current_channel]->get_signal().get_satellite()
-                                       << ", Signal " << channels_[current_channel]->get_signal().get_signal_str();
-                        }
+                }
+            else
+                {
+                    push_back_signal(gnss_signal);
+                    DLOG(INFO) << "Channel " << current_channel
+                               << " secondary frequency acquisition assistance not available in "
+                               << channels_[current_channel]->get_signal().get_satellite()
+                               << ", Signal " << channels_[current_channel]->get_signal().get_signal_str();
                 }
             DLOG(INFO) << "Channel " << current_channel << " in state " << channels_state_[current_channel];
         }
@@ -1285,13 +1813,12 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
     Gnss_Signal gs;
     if (who < 200)
         {
-            try
-                {
-                    sat = configuration_->property("Channel" + std::to_string(who) + ".satellite", 0);
-                }
-            catch (const std::exception& e)
+            sat = flowgraph_conf_.channel(who).satellite;
+            if (channels_state_[who] == 3)
                 {
-                    LOG(WARNING) << e.what();
+                    // late event from a channel that has been stopped
+                    DLOG(INFO) << "Channel " << who << " is stopped, event " << what << " ignored";
+                    return;
                 }
         }
     switch (what)
@@ -1309,7 +1836,7 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
             // push back the old signal AFTER assigning a new one to avoid selecting the same signal
             if (sat == 0)
                 {
-                    push_back_signal(gs);
+                    push_back_signal(gs, true);
                 }
             break;
         case 1:
@@ -1370,63 +1897,60 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
                 }
             acq_channels_count_ = 0;  // all channels are in standby now and no new acquisition should be started
             break;
+        case 20:  // stop channel
+            if (who >= 400 and who - 400 < channels_count_)
+                {
+                    stop_channel(who - 400, false);
+                }
+            break;
+        case 21:  // start channel
+            if (who >= 400 and who - 400 < channels_count_ and channels_state_[who - 400] == 3)
+                {
+                    const unsigned int ch = who - 400;
+                    channels_state_[ch] = 0;
+                    LOG(INFO) << "Channel " << ch << " started";
+                    acquisition_manager(ch == 0 ? channels_count_ - 1 : ch - 1);  // this channel first
+                }
+            break;
         default:
             break;
         }
 }
 
 
-void GNSSFlowgraph::priorize_satellites(const std::vector<std::pair<int, Gnss_Satellite>>& visible_satellites)
+std::vector<unsigned int> GNSSFlowgraph::channels_state()
 {
-    size_t old_size;
-    Gnss_Signal gs;
-    for (auto& visible_satellite : visible_satellites)
-        {
-            if (visible_satellite.second.get_system() == "GPS")
-                {
-                    gs = Gnss_Signal(visible_satellite.second, "1C");
-                    old_size = available_GPS_1C_signals_.size();
-                    available_GPS_1C_signals_.remove(gs);
-                    if (old_size > available_GPS_1C_signals_.size())
-                        {
-                            available_GPS_1C_signals_.push_front(gs);
-                        }
+    std::lock_guard<std::mutex> lock(signal_list_mutex);
+    return channels_state_;
+}
 
-                    gs = Gnss_Signal(visible_satellite.second, "2S");
-                    old_size = available_GPS_2S_signals_.size();
-                    available_GPS_2S_signals_.remove(gs);
-                    if (old_size > available_GPS_2S_signals_.size())
-                        {
-                            available_GPS_2S_signals_.push_front(gs);
-                        }
 
-                    gs = Gnss_Signal(visible_satellite.second, "L5");
-                    old_size = available_GPS_L5_signals_.size();
-                    available_GPS_L5_signals_.remove(gs);
-                    if (old_size > available_GPS_L5_signals_.size())
-                        {
-                            available_GPS_L5_signals_.push_front(gs);
-                        }
+void GNSSFlowgraph::stop_channel(unsigned int ch, bool failed)
+{
+    // called with signal_list_mutex held
+    if (channels_state_[ch] == 1 or channels_state_[ch] == 2)
+        {
+            channels_[ch]->stop_channel();
+            if (channels_state_[ch] == 1 and acq_channels_count_ > 0)
+                {
+                    acq_channels_count_--;
                 }
-            else if (visible_satellite.second.get_system() == "Galileo")
+            if (flowgraph_conf_.channel(ch).satellite == 0)
                 {
-                    gs = Gnss_Signal(visible_satellite.second, "1B");
-                    old_size = available_GAL_1B_signals_.size();
-                    available_GAL_1B_signals_.remove(gs);
-                    if (old_size > available_GAL_1B_signals_.size())
-                        {
-                            available_GAL_1B_signals_.push_front(gs);
-                        }
-
-                    gs = Gnss_Signal(visible_satellite.second, "5X");
-                    old_size = available_GAL_5X_signals_.size();
-                    available_GAL_5X_signals_.remove(gs);
-                    if (old_size > available_GAL_5X_signals_.size())
-                        {
-                            available_GAL_5X_signals_.push_front(gs);
-                        }
+                    push_back_signal(channels_[ch]->get_signal(), failed);
                 }
         }
+    channels_state_[ch] = 3;
+    LOG(INFO) << "Channel " << ch << " stopped";
+    // give its acquisition slot to another channel
+    acquisition_manager(ch);
+}
+
+
+void GNSSFlowgraph::priorize_satellites(const std::vector<std::pair<int, Gnss_Satellite>>& predicted_satellites)
+{
+    // the scheduler ranks the queued signals each time one is requested
+    search_scheduler_->set_visibility(predicted_satellites);
 }
 
 
@@ -1442,6 +1966,7 @@ void GNSSFlowgraph::set_configuration(const std::shared_ptr<ConfigurationInterfa
             LOG(WARNING) << "Unable to update configuration while flowgraph connected";
         }
     configuration_ = configuration;
+    flowgraph_conf_.SetFromConfiguration(configuration_.get());
 }
 
 
@@ -1533,6 +2058,8 @@ void GNSSFlowgraph::init()
                 }
         }
 
+    mark_startup_phase("signal sources");
+
     observables_ = block_factory_->GetObservables(configuration_);
     // Mark old implementations as deprecated
     std::string default_str("Default");
@@ -1553,6 +2080,8 @@ void GNSSFlowgraph::init()
             std::cout << "Please update your configuration file." << std::endl;
         }
 
+    mark_startup_phase("observables and PVT");
+
     std::shared_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> channels = block_factory_->GetChannels(configuration_, queue_);
 
     channels_count_ = channels->size();
@@ -1562,6 +2091,8 @@ void GNSSFlowgraph::init()
             channels_.push_back(std::dynamic_pointer_cast<ChannelInterface>(chan_));
         }
 
+    mark_startup_phase("channels");
+
     top_block_ = gr::make_top_block("GNSSFlowgraph");
 
     mapStringValues_["1C"] = evGPS_1C;
@@ -1600,6 +2131,7 @@ void GNSSFlowgraph::init()
                 configuration_->property("Monitor.udp_port", 1234),
                 udp_addr_vec, enable_protobuf);
         }
+    mark_startup_phase("search lists");
 }
 
 
@@ -1622,6 +2154,8 @@ void GNSSFlowgraph::set_signals_list()
 {
     // Set a sequential list of GNSS satellites
     std::set<unsigned int>::const_iterator available_gnss_prn_iter;
+    search_scheduler_->clear();
+    search_scheduler_->set_retry_backoff(flowgraph_conf_.search_backoff_s, flowgraph_conf_.search_backoff_max_s);
 
     // Create the lists of GNSS satellites
     std::set<unsigned int> available_gps_prn = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
@@ -1722,133 +2256,123 @@ void GNSSFlowgraph::set_signals_list()
                 }
         }
 
-    if (configuration_->property("Channels_1C.count", 0) > 0)
+    if (flowgraph_conf_.channels_1C > 0)
         {
             // Loop to create GPS L1 C/A signals
             for (available_gnss_prn_iter = available_gps_prn.cbegin();
                  available_gnss_prn_iter != available_gps_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_GPS_1C_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("GPS"), *available_gnss_prn_iter),
-                        std::string("1C"));
+                        std::string("1C")));
                 }
         }
 
-    if (configuration_->property("Channels_2S.count", 0) > 0)
+    if (flowgraph_conf_.channels_2S > 0)
         {
             // Loop to create GPS L2C M signals
             for (available_gnss_prn_iter = available_gps_prn.cbegin();
                  available_gnss_prn_iter != available_gps_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_GPS_2S_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("GPS"), *available_gnss_prn_iter),
-                        std::string("2S"));
+                        std::string("2S")));
                 }
         }
 
-    if (configuration_->property("Channels_L5.count", 0) > 0)
+    if (flowgraph_conf_.channels_L5 > 0)
         {
             // Loop to create GPS L5 signals
             for (available_gnss_prn_iter = available_gps_prn.cbegin();
                  available_gnss_prn_iter != available_gps_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_GPS_L5_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("GPS"), *available_gnss_prn_iter),
-                        std::string("L5"));
+                        std::string("L5")));
                 }
         }
 
-    if (configuration_->property("Channels_SBAS.count", 0) > 0)
-        {
-            // Loop to create SBAS L1 C/A signals
-            for (available_gnss_prn_iter = available_sbas_prn.cbegin();
-                 available_gnss_prn_iter != available_sbas_prn.cend();
-                 available_gnss_prn_iter++)
-                {
-                    available_SBAS_1C_signals_.emplace_back(
-                        Gnss_Satellite(std::string("SBAS"), *available_gnss_prn_iter),
-                        std::string("1C"));
-                }
-        }
+    // There are no SBAS channels (see GNSSBlockFactory::GetChannels), and
+    // SBAS L1 signals would share the "1C" queue with GPS L1 C/A.
 
-    if (configuration_->property("Channels_1B.count", 0) > 0)
+    if (flowgraph_conf_.channels_1B > 0)
         {
             // Loop to create the list of Galileo E1B signals
             for (available_gnss_prn_iter = available_galileo_prn.cbegin();
                  available_gnss_prn_iter != available_galileo_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_GAL_1B_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("Galileo"), *available_gnss_prn_iter),
-                        std::string("1B"));
+                        std::string("1B")));
                 }
         }
 
-    if (configuration_->property("Channels_5X.count", 0) > 0)
+    if (flowgraph_conf_.channels_5X > 0)
         {
             // Loop to create the list of Galileo E5a signals
             for (available_gnss_prn_iter = available_galileo_prn.cbegin();
                  available_gnss_prn_iter != available_galileo_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_GAL_5X_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("Galileo"), *available_gnss_prn_iter),
-                        std::string("5X"));
+                        std::string("5X")));
                 }
         }
 
-    if (configuration_->property("Channels_1G.count", 0) > 0)
+    if (flowgraph_conf_.channels_1G > 0)
         {
             // Loop to create the list of GLONASS L1 C/A signals
             for (available_gnss_prn_iter = available_glonass_prn.cbegin();
                  available_gnss_prn_iter != available_glonass_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_GLO_1G_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("Glonass"), *available_gnss_prn_iter),
-                        std::string("1G"));
+                        std::string("1G")));
                 }
         }
 
-    if (configuration_->property("Channels_2G.count", 0) > 0)
+    if (flowgraph_conf_.channels_2G > 0)
         {
             // Loop to create the list of GLONASS L2 C/A signals
             for (available_gnss_prn_iter = available_glonass_prn.cbegin();
                  available_gnss_prn_iter != available_glonass_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_GLO_2G_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("Glonass"), *available_gnss_prn_iter),
-                        std::string("2G"));
+                        std::string("2G")));
                 }
         }
 
-    if (configuration_->property("Channels_B1.count", 0) > 0)
+    if (flowgraph_conf_.channels_B1 > 0)
         {
             // Loop to create the list of BeiDou B1C signals
             for (available_gnss_prn_iter = available_beidou_prn.cbegin();
                  available_gnss_prn_iter != available_beidou_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_BDS_B1_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("Beidou"), *available_gnss_prn_iter),
-                        std::string("B1"));
+                        std::string("B1")));
                 }
         }
 
-    if (configuration_->property("Channels_B3.count", 0) > 0)
+    if (flowgraph_conf_.channels_B3 > 0)
         {
             // Loop to create the list of BeiDou B1C signals
             for (available_gnss_prn_iter = available_beidou_prn.cbegin();
                  available_gnss_prn_iter != available_beidou_prn.cend();
                  available_gnss_prn_iter++)
                 {
-                    available_BDS_B3_signals_.emplace_back(
+                    search_scheduler_->push_back(Gnss_Signal(
                         Gnss_Satellite(std::string("Beidou"), *available_gnss_prn_iter),
-                        std::string("B3"));
+                        std::string("B3")));
                 }
         }
 }
@@ -1857,13 +2381,14 @@ void GNSSFlowgraph::set_signals_list()
 void GNSSFlowgraph::set_channels_state()
 {
     std::lock_guard<std::mutex> lock(signal_list_mutex);
-    max_acq_channels_ = configuration_->property("Channels.in_acquisition", channels_count_);
+    max_acq_channels_ = flowgraph_conf_.channels_in_acquisition;
     if (max_acq_channels_ > channels_count_)
         {
             max_acq_channels_ = channels_count_;
             LOG(WARNING) << "Channels_in_acquisition is bigger than number of channels. Variable acq_channels_count_ is set to " << channels_count_;
         }
     channels_state_.reserve(channels_count_);
+    released_channels_.clear();
     for (unsigned int i = 0; i < channels_count_; i++)
         {
             if (i < max_acq_channels_)
@@ -1883,45 +2408,13 @@ void GNSSFlowgraph::set_channels_state()
 
 bool GNSSFlowgraph::is_multiband() const
 {
-    bool multiband = false;
-    if (configuration_->property("Channels_1C.count", 0) > 0)
-        {
-            if (configuration_->property("Channels_2S.count", 0) > 0)
-                {
-                    multiband = true;
-                }
-            if (configuration_->property("Channels_L5.count", 0) > 0)
-                {
-                    multiband = true;
-                }
-        }
-    if (configuration_->property("Channels_1B.count", 0) > 0)
-        {
-            if (configuration_->property("Channels_5X.count", 0) > 0)
-                {
-                    multiband = true;
-                }
-        }
-    if (configuration_->property("Channels_1G.count", 0) > 0)
-        {
-            if (configuration_->property("Channels_2G.count", 0) > 0)
-                {
-                    multiband = true;
-                }
-        }
-    if (configuration_->property("Channels_B1.count", 0) > 0)
-        {
-            if (configuration_->property("Channels_B3.count", 0) > 0)
-                {
-                    multiband = true;
-                }
-        }
-    return multiband;
+    return flowgraph_conf_.multiband;
 }
 
 
-Gnss_Signal GNSSFlowgraph::search_next_signal(const std::string& searched_signal,
+bool GNSSFlowgraph::search_next_signal(const std::string& searched_signal,
     const bool pop,
+    Gnss_Signal& signal,
     bool& is_primary_frequency,
     bool& assistance_available,
     float& estimated_doppler,
@@ -1929,217 +2422,68 @@ Gnss_Signal GNSSFlowgraph::search_next_signal(const std::string& searched_signal
 {
     is_primary_frequency = false;
     assistance_available = false;
-    Gnss_Signal result;
-    bool found_signal = false;
+    std::string primary_signal;  // signal whose tracking can assist the search
     switch (mapStringValues_[searched_signal])
         {
         case evGPS_1C:
-            // todo: assist the satellite selection with almanac and current PVT here (rehuse priorize_satellite function used in control_thread)
-            result = available_GPS_1C_signals_.front();
-            available_GPS_1C_signals_.pop_front();
-            if (!pop)
-                {
-                    available_GPS_1C_signals_.push_back(result);
-                }
+        case evGAL_1B:
+        case evGLO_1G:
+        case evBDS_B1:
             is_primary_frequency = true;  // indicate that the searched satellite signal belongs to "primary" link (L1, E1, B1, etc..)
             break;
 
         case evGPS_2S:
-            if (configuration_->property("Channels_1C.count", 0) > 0)
-                {
-                    // 1. Get the current channel status map
-                    std::map<int, std::shared_ptr<Gnss_Synchro>> current_channels_status = channels_status_->get_current_status_map();
-                    // 2. search the currently tracked GPS L1 satellites and assist the GPS L2 acquisition if the satellite is not tracked on L2
-                    for (auto& current_status : current_channels_status)
-                        {
-                            if (std::string(current_status.second->Signal) == "1C")
-                                {
-                                    std::list<Gnss_Signal>::iterator it2;
-                                    it2 = std::find_if(std::begin(available_GPS_2S_signals_), std::end(available_GPS_2S_signals_),
-                                        [&](Gnss_Signal const& sig) { return sig.get_satellite().get_PRN() == current_status.second->PRN; });
-
-                                    if (it2 != available_GPS_2S_signals_.end())
-                                        {
-                                            estimated_doppler = current_status.second->Carrier_Doppler_hz;
-                                            RX_time = current_status.second->RX_time;
-                                            // 3. return the GPS L2 satellite and remove it from list
-                                            result = *it2;
-                                            if (pop)
-                                                {
-                                                    available_GPS_2S_signals_.erase(it2);
-                                                }
-                                            found_signal = true;
-                                            assistance_available = true;
-                                            break;
-                                        }
-                                }
-                        }
-                    // fallback: pick the front satellite because there is no tracked satellites in L1 to assist L2
-                    if (found_signal == false)
-                        {
-                            result = available_GPS_2S_signals_.front();
-                            available_GPS_2S_signals_.pop_front();
-                            if (!pop)
-                                {
-                                    available_GPS_2S_signals_.push_back(result);
-                                }
-                        }
-                }
-            else
-                {
-                    result = available_GPS_2S_signals_.front();
-                    available_GPS_2S_signals_.pop_front();
-                    if (!pop)
-                        {
-                            available_GPS_2S_signals_.push_back(result);
-                        }
-                }
-            break;
-
         case evGPS_L5:
-            if (configuration_->property("Channels_1C.count", 0) > 0)
-                {
-                    // 1. Get the current channel status map
-                    std::map<int, std::shared_ptr<Gnss_Synchro>> current_channels_status = channels_status_->get_current_status_map();
-                    // 2. search the currently tracked GPS L1 satellites and assist the GPS L5 acquisition if the satellite is not tracked on L5
-                    for (auto& current_status : current_channels_status)
-                        {
-                            if (std::string(current_status.second->Signal) == "1C")
-                                {
-                                    std::list<Gnss_Signal>::iterator it2;
-                                    it2 = std::find_if(std::begin(available_GPS_L5_signals_), std::end(available_GPS_L5_signals_),
-                                        [&](Gnss_Signal const& sig) { return sig.get_satellite().get_PRN() == current_status.second->PRN; });
-
-                                    if (it2 != available_GPS_L5_signals_.end())
-                                        {
-                                            estimated_doppler = current_status.second->Carrier_Doppler_hz;
-                                            RX_time = current_status.second->RX_time;
-                                            // std::cout << " Channel: " << it->first << " => Doppler: " << estimated_doppler << "[Hz] \n";
-                                            // 3. return the GPS L5 satellite and remove it from list
-                                            result = *it2;
-                                            if (pop)
-                                                {
-                                                    available_GPS_L5_signals_.erase(it2);
-                                                }
-                                            found_signal = true;
-                                            assistance_available = true;
-                                            break;
-                                        }
-                                }
-                        }
-                }
-            // fallback: pick the front satellite because there is no tracked satellites in L1 to assist L5
-            if (found_signal == false)
-                {
-                    result = available_GPS_L5_signals_.front();
-                    available_GPS_L5_signals_.pop_front();
-                    if (!pop)
-                        {
-                            available_GPS_L5_signals_.push_back(result);
-                        }
-                }
-            break;
-
-        case evGAL_1B:
-            result = available_GAL_1B_signals_.front();
-            available_GAL_1B_signals_.pop_front();
-            if (!pop)
+            if (flowgraph_conf_.channels_1C > 0)
                 {
-                    available_GAL_1B_signals_.push_back(result);
+                    primary_signal = "1C";
                 }
-            is_primary_frequency = true;  // indicate that the searched satellite signal belongs to "primary" link (L1, E1, B1, etc..)
             break;
 
         case evGAL_5X:
-            if (configuration_->property("Channels_1B.count", 0) > 0)
-                {
-                    // 1. Get the current channel status map
-                    std::map<int, std::shared_ptr<Gnss_Synchro>> current_channels_status = channels_status_->get_current_status_map();
-                    // 2. search the currently tracked Galileo E1 satellites and assist the Galileo E5 acquisition if the satellite is not tracked on E5
-                    for (auto& current_status : current_channels_status)
-                        {
-                            if (std::string(current_status.second->Signal) == "1B")
-                                {
-                                    std::list<Gnss_Signal>::iterator it2;
-                                    it2 = std::find_if(std::begin(available_GAL_5X_signals_), std::end(available_GAL_5X_signals_),
-                                        [&](Gnss_Signal const& sig) { return sig.get_satellite().get_PRN() == current_status.second->PRN; });
-
-                                    if (it2 != available_GAL_5X_signals_.end())
-                                        {
-                                            estimated_doppler = current_status.second->Carrier_Doppler_hz;
-                                            RX_time = current_status.second->RX_time;
-                                            // std::cout << " Channel: " << it->first << " => Doppler: " << estimated_doppler << "[Hz] \n";
-                                            // 3. return the Gal 5X satellite and remove it from list
-                                            result = *it2;
-                                            if (pop)
-                                                {
-                                                    available_GAL_5X_signals_.erase(it2);
-                                                }
-                                            found_signal = true;
-                                            assistance_available = true;
-                                            break;
-                                        }
-                                }
-                        }
-                }
-            // fallback: pick the front satellite because there is no tracked satellites in E1 to assist E5
-            if (found_signal == false)
-                {
-                    result = available_GAL_5X_signals_.front();
-                    available_GAL_5X_signals_.pop_front();
-                    if (!pop)
-                        {
-                            available_GAL_5X_signals_.push_back(result);
-                        }
-                }
-            break;
-
-        case evGLO_1G:
-            result = available_GLO_1G_signals_.front();
-            available_GLO_1G_signals_.pop_front();
-            if (!pop)
+            if (flowgraph_conf_.channels_1B > 0)
                 {
-                    available_GLO_1G_signals_.push_back(result);
+                    primary_signal = "1B";
                 }
-            is_primary_frequency = true;  // indicate that the searched satellite signal belongs to "primary" link (L1, E1, B1, etc..)
             break;
 
         case evGLO_2G:
-            result = available_GLO_2G_signals_.front();
-            available_GLO_2G_signals_.pop_front();
-            if (!pop)
-                {
-                    available_GLO_2G_signals_.push_back(result);
-                }
-            break;
-
-        case evBDS_B1:
-            result = available_BDS_B1_signals_.front();
-            available_BDS_B1_signals_.pop_front();
-            if (!pop)
-                {
-                    available_BDS_B1_signals_.push_back(result);
-                }
-            is_primary_frequency = true;  // indicate that the searched satellite signal belongs to "primary" link (L1, E1, B1, etc..)
-            break;
-
         case evBDS_B3:
-            result = available_BDS_B3_signals_.front();
-            available_BDS_B3_signals_.pop_front();
-            if (!pop)
-                {
-                    available_BDS_B3_signals_.push_back(result);
-                }
             break;
 
         default:
             LOG(ERROR) << "This should not happen :-(";
-            result = available_GPS_1C_signals_.front();
-            if (pop)
+            break;
+        }
+
+    // Search first the satellites already tracked in the primary frequency,
+    // since their Doppler can assist the acquisition of the secondary one
+    std::map<uint32_t, std::shared_ptr<Gnss_Synchro>> tracked_in_primary;
+    std::set<uint32_t> hinted_prns;
+    if (!primary_signal.empty())
+        {
+            const std::map<int, std::shared_ptr<Gnss_Synchro>> current_channels_status = channels_status_->get_current_status_map();
+            for (const auto& current_status : current_channels_status)
                 {
-                    available_GPS_1C_signals_.pop_front();
+                    if (std::string(current_status.second->Signal) == primary_signal)
+                        {
+                            tracked_in_primary[current_status.second->PRN] = current_status.second;
+                            hinted_prns.insert(current_status.second->PRN);
+                        }
                 }
-            break;
         }
-    return result;
+
+    if (!search_scheduler_->next(searched_signal, pop, signal, hinted_prns))
+        {
+            DLOG(INFO) << "No satellite left to search in signal " << searched_signal;
+            return false;
+        }
+    const auto tracked = tracked_in_primary.find(signal.get_satellite().get_PRN());
+    if (tracked != tracked_in_primary.end())
+        {
+            estimated_doppler = tracked->second->Carrier_Doppler_hz;
+            RX_time = tracked->second->RX_time;
+            assistance_available = true;
+        }
+    return true;
 }
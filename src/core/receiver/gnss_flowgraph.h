@@ -26,15 +26,21 @@
 #ifndef GNSS_SDR_GNSS_FLOWGRAPH_H
 #define GNSS_SDR_GNSS_FLOWGRAPH_H
 
+#include "block_metrics.h"
 #include "channel_status_msg_receiver.h"
 #include "concurrent_queue.h"
+#include "control_event_queue.h"
+#include "flowgraph_conf.h"
 #include "gnss_sdr_sample_counter.h"
 #include "gnss_signal.h"
+#include "load_governor.h"
 #include "pvt_interface.h"
+#include "satellite_search_scheduler.h"
 #include <gnuradio/blocks/null_sink.h>  // for null_sink
 #include <gnuradio/runtime_types.h>     // for basic_block_sptr, top_block_sptr
 #include <pmt/pmt.h>                    // for pmt_t
-#include <list>                         // for list
+#include <chrono>                       // for steady_clock
+#include <cstdint>                      // for uint32_t
 #include <map>                          // for map
 #include <memory>                       // for for shared_ptr, dynamic_pointer_cast
 #include <mutex>                        // for mutex
@@ -110,7 +116,8 @@ public:
      * \brief Applies an action to the flow graph
      *
      * \param[in] who   Who generated the action
-     * \param[in] what  What is the action. 0: acquisition failed; 1: acquisition success; 2: tracking lost
+     * \param[in] what  What is the action. 0: acquisition failed; 1: acquisition success; 2: tracking lost;
+     * 20: stop channel who - 400; 21: start channel who - 400
      */
     void apply_action(unsigned int who, unsigned int what);
 
@@ -145,9 +152,66 @@ public:
     }
 
     /*!
-     * \brief Priorize visible satellites in the specified vector
+     * \brief Makes the channels send their events through event_queue
+     * instead of the control queue
      */
-    void priorize_satellites(const std::vector<std::pair<int, Gnss_Satellite>>& visible_satellites);
+    void set_event_queue(const std::shared_ptr<Control_Event_Queue>& event_queue);
+
+    /*!
+     * \brief Sets the given configuration properties, and replaces channel ch
+     * by a new one built with them while the rest of the flow graph keeps
+     * running. Throws if the channel can't be replaced, keeping the old one,
+     * or if a property can only be set at startup (e.g. ChannelN.satellite).
+     *
+     * The new channel is left stopped, and a command to start it (unless the
+     * old one was stopped) is pushed to the control queue, after any late
+     * event of the old channel. It must be called from the control thread.
+     */
+    void reconfigure_channel(unsigned int ch, const std::vector<std::pair<std::string, std::string>>& properties);
+
+    /*!
+     * \brief Same as reconfigure_channel(), for the signal conditioner with
+     * the given ID (e.g. to change its filter settings)
+     */
+    void reconfigure_conditioner(unsigned int id, const std::vector<std::pair<std::string, std::string>>& properties);
+
+    /*!
+     * \brief State of each channel (0 idle, 1 acquisition, 2 tracking, 3 stopped)
+     */
+    std::vector<unsigned int> channels_state();
+
+    /*!
+     * \brief Reads the performance counters of the blocks of the flow graph
+     * (see Block_Metrics)
+     */
+    std::vector<Block_Sample> block_samples();
+
+    /*!
+     * \brief Measures the samples read by the sample counter and the
+     * occupancy of the input buffers of the channels. Returns false if the
+     * flow graph is not running.
+     */
+    bool load_sample(Load_Sample& sample);
+
+    /*!
+     * \brief Applies (or undoes) a load shedding step, see Load_Governor.
+     * Returns false if there was nothing to do.
+     */
+    bool shed_load(Load_Governor::Level step, bool shed, const Load_Governor_Conf& conf);
+
+    /*!
+     * \brief Returns a smart pointer to the queue of satellites to be searched
+     */
+    std::shared_ptr<Satellite_Search_Scheduler> get_search_scheduler() const
+    {
+        return search_scheduler_;
+    }
+
+    /*!
+     * \brief Priorize visible satellites in the specified vector, according
+     * to their elevation (negative if below the horizon)
+     */
+    void priorize_satellites(const std::vector<std::pair<int, Gnss_Satellite>>& predicted_satellites);
 
 #ifdef ENABLE_FPGA
     void start_acquisition_helper();
@@ -160,18 +224,70 @@ private:
     void set_signals_list();
     void set_channels_state();  // Initializes the channels state (start acquisition or keep standby)
                                 // using the configuration parameters (number of channels and max channels in acquisition)
-    Gnss_Signal search_next_signal(const std::string& searched_signal,
+    bool search_next_signal(const std::string& searched_signal,
         const bool pop,
+        Gnss_Signal& signal,
         bool& is_primary_frequency,
         bool& assistance_available,
         float& estimated_doppler,
         double& RX_time);
 
-    void push_back_signal(const Gnss_Signal& gs);
+    // Sets the signals of several channels at once, using up to GNSS-SDR.init_threads threads
+    void set_channel_signals(const std::vector<std::pair<unsigned int, Gnss_Signal>>& assignments);
+    void mark_startup_phase(const std::string& phase);  // records the time spent since the previous phase
+
+    void stop_channel(unsigned int ch, bool failed);  // moves the channel to the stopped state (3)
+    void push_back_signal(const Gnss_Signal& gs, bool failed = false);
     void remove_signal(const Gnss_Signal& gs);
 
     double project_doppler(const std::string& searched_signal, double primary_freq_doppler_hz);
     bool is_multiband() const;
+    size_t conditioner_outputs(size_t conditioner) const;  // output ports of a signal conditioner
+    int conditioner_output_port(int conditioner, unsigned int channel) const;
+    void connect_shm_bus_tap(int source, int rf_channel, const gr::basic_block_sptr& block, int port);
+
+    // Connect two blocks and record the edge, so that it can be moved to a
+    // new block by reconfigure_channel() or reconfigure_conditioner()
+    void connect_stream(const gr::basic_block_sptr& src, int src_port, const gr::basic_block_sptr& dst, int dst_port);
+    void connect_message(const gr::basic_block_sptr& src, const pmt::pmt_t& src_port, const gr::basic_block_sptr& dst, const pmt::pmt_t& dst_port);
+    void move_edges(const std::vector<std::pair<gr::basic_block_sptr, gr::basic_block_sptr>>& replacements);  // (old, new) blocks
+    void swap_block(const std::shared_ptr<GNSSBlockInterface>& old_block,
+        const std::shared_ptr<GNSSBlockInterface>& new_block,
+        const std::vector<std::pair<gr::basic_block_sptr, gr::basic_block_sptr>>& replacements);
+    static void check_properties(const std::vector<std::pair<std::string, std::string>>& properties);
+    std::vector<std::pair<std::string, std::string>> set_properties(const std::vector<std::pair<std::string, std::string>>& properties);
+    void restore_properties(const std::vector<std::pair<std::string, std::string>>& properties,
+        const std::vector<std::pair<std::string, std::string>>& previous);  // undoes set_properties()
+
+    struct Stream_Edge
+    {
+        gr::basic_block_sptr src;
+        int src_port;
+        gr::basic_block_sptr dst;
+        int dst_port;
+    };
+    struct Message_Edge
+    {
+        gr::basic_block_sptr src;
+        pmt::pmt_t src_port;
+        gr::basic_block_sptr dst;
+        pmt::pmt_t dst_port;
+    };
+    std::vector<Stream_Edge> stream_edges_;
+    std::vector<Message_Edge> message_edges_;
+    std::vector<uint32_t> acq_resampler_latency_;  // samples, per channel
+    std::shared_ptr<Control_Event_Queue> event_queue_;
+
+    // Publishes a source output on a shared memory sample bus (see shm_sample_bus.h)
+    struct Shm_Bus_Tap
+    {
+        gr::basic_block_sptr block;
+        int port;
+        gr::basic_block_sptr sink;
+    };
+    std::vector<Shm_Bus_Tap> shm_bus_taps_;
+    std::chrono::steady_clock::time_point startup_mark_;
+    std::vector<std::pair<std::string, double>> startup_phases_;  // seconds spent in each startup phase
     bool connected_;
     bool running_;
     bool multiband_;
@@ -182,6 +298,7 @@ private:
     unsigned int max_acq_channels_;
     std::string config_file_;
     std::shared_ptr<ConfigurationInterface> configuration_;
+    Flowgraph_Conf flowgraph_conf_;  // read once, instead of looking up keys at runtime
 
     std::vector<std::shared_ptr<GNSSBlockInterface>> sig_source_;
     std::vector<std::shared_ptr<GNSSBlockInterface>> sig_conditioner_;
@@ -199,16 +316,7 @@ private:
     gr::top_block_sptr top_block_;
     std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue_;
 
-    std::list<Gnss_Signal> available_GPS_1C_signals_;
-    std::list<Gnss_Signal> available_GPS_2S_signals_;
-    std::list<Gnss_Signal> available_GPS_L5_signals_;
-    std::list<Gnss_Signal> available_SBAS_1C_signals_;
-    std::list<Gnss_Signal> available_GAL_1B_signals_;
-    std::list<Gnss_Signal> available_GAL_5X_signals_;
-    std::list<Gnss_Signal> available_GLO_1G_signals_;
-    std::list<Gnss_Signal> available_GLO_2G_signals_;
-    std::list<Gnss_Signal> available_BDS_B1_signals_;
-    std::list<Gnss_Signal> available_BDS_B3_signals_;
+    std::shared_ptr<Satellite_Search_Scheduler> search_scheduler_;  // signals waiting to be searched, per band
     enum StringValue
     {
         evGPS_1C,
@@ -225,6 +333,8 @@ private:
     std::map<std::string, StringValue> mapStringValues_;
 
     std::vector<unsigned int> channels_state_;
+    std::vector<unsigned int> released_channels_;  // stopped by the load governor, in order
+    int monitor_decimation_factor_;                // before the load governor raised it
     channel_status_msg_receiver_sptr channels_status_;  // class that receives and stores the current status of the receiver channels
     std::mutex signal_list_mutex;
 
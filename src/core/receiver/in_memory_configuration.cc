@@ -124,6 +124,12 @@ void InMemoryConfiguration::supersede_property(const std::string& property_name,
 }
 
 
+void InMemoryConfiguration::erase_property(const std::string& property_name)
+{
+    properties_.erase(property_name);
+}
+
+
 bool InMemoryConfiguration::is_present(const std::string& property_name)
 {
     return (properties_.find(property_name) != properties_.end());
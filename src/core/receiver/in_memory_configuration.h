@@ -56,6 +56,7 @@ public:
     double property(std::string property_name, double default_value);
     void set_property(std::string property_name, std::string value);
     void supersede_property(const std::string& property_name, const std::string& value);
+    void erase_property(const std::string& property_name);
     bool is_present(const std::string& property_name);
 
 private:
@@ -0,0 +1,249 @@
+/*!
+ * \file load_governor.cc
+ * \brief Detects when the receiver falls behind real time, and sheds load
+ * in a controlled order until it keeps up again
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "load_governor.h"
+#include <gnuradio/block.h>         // for block
+#include <gnuradio/block_detail.h>  // for block_detail
+#include <gnuradio/buffer.h>        // for buffer, buffer_reader
+#include <glog/logging.h>
+#include <algorithm>  // for max, min
+#include <iomanip>    // for setprecision
+#include <iostream>   // for cout
+#include <sstream>    // for ostringstream
+#include <utility>    // for move
+
+
+namespace
+{
+std::string action_name(Load_Governor::Level step, bool shed)
+{
+    switch (step)
+        {
+        case Load_Governor::Acquisition_Suspended:
+            return shed ? "suspended the acquisition of the satellites not predicted to be visible" : "resumed the acquisition of all the satellites";
+        case Load_Governor::Correlators_Reduced:
+            return shed ? "reduced the correlator taps" : "restored the correlator taps";
+        case Load_Governor::Monitor_Decimated:
+            return shed ? "raised the decimation of the monitor output" : "restored the decimation of the monitor output";
+        case Load_Governor::Channels_Released:
+            return shed ? "released the channel with the lowest C/N0" : "restarted a released channel";
+        default:
+            return "";
+        }
+}
+}  // namespace
+
+
+Load_Governor_Conf::Load_Governor_Conf()
+{
+    enable = false;
+    interval_s = 1.0;
+    min_real_time_ratio = 0.95;
+    max_real_time_ratio = 1.05;
+    high_occupancy = 0.8;
+    low_occupancy = 0.3;
+    hold_s = 3.0;
+    recover_s = 30.0;
+    min_channels = 4U;
+    monitor_decimation = 10;
+}
+
+
+void Load_Governor_Conf::SetFromConfiguration(ConfigurationInterface* configuration)
+{
+    enable = configuration->property("GNSS-SDR.load_governor", enable);
+    interval_s = std::max(configuration->property("GNSS-SDR.load_governor_interval_s", interval_s), 0.1);
+    min_real_time_ratio = configuration->property("GNSS-SDR.load_governor_min_real_time_ratio", min_real_time_ratio);
+    max_real_time_ratio = configuration->property("GNSS-SDR.load_governor_max_real_time_ratio", max_real_time_ratio);
+    if (max_real_time_ratio < min_real_time_ratio)
+        {
+            LOG(WARNING) << "GNSS-SDR.load_governor_max_real_time_ratio is smaller than GNSS-SDR.load_governor_min_real_time_ratio. Using " << min_real_time_ratio;
+            max_real_time_ratio = min_real_time_ratio;
+        }
+    high_occupancy = configuration->property("GNSS-SDR.load_governor_high_occupancy", high_occupancy);
+    low_occupancy = configuration->property("GNSS-SDR.load_governor_low_occupancy", low_occupancy);
+    if (high_occupancy < low_occupancy)
+        {
+            LOG(WARNING) << "GNSS-SDR.load_governor_high_occupancy is smaller than GNSS-SDR.load_governor_low_occupancy. Using " << low_occupancy;
+            high_occupancy = low_occupancy;
+        }
+    hold_s = configuration->property("GNSS-SDR.load_governor_hold_s", hold_s);
+    recover_s = configuration->property("GNSS-SDR.load_governor_recover_s", recover_s);
+    min_channels = configuration->property("GNSS-SDR.load_governor_min_channels", min_channels);
+    monitor_decimation = std::max(configuration->property("GNSS-SDR.load_governor_monitor_decimation", monitor_decimation), 1);
+}
+
+
+Load_Governor::Load_Governor(const Load_Governor_Conf& conf, Executor executor)
+    : d_conf(conf),
+      d_executor(std::move(executor)),
+      d_level(Normal),
+      d_has_previous(false),
+      d_real_time_ratio(0.0),
+      d_overloaded_since_s(-1.0),
+      d_relaxed_since_s(-1.0),
+      d_last_change_s(-1.0),
+      d_floor_reported(false)
+{
+}
+
+
+void Load_Governor::update(const Load_Sample& sample)
+{
+    if (!d_has_previous)
+        {
+            d_previous = sample;
+            d_has_previous = true;
+            return;
+        }
+    const double elapsed_s = sample.time_s - d_previous.time_s;
+    if (elapsed_s <= 0.0)
+        {
+            return;
+        }
+    d_real_time_ratio = (sample.sample_time_s - d_previous.sample_time_s) / elapsed_s;
+    d_previous = sample;
+
+    // buffers are always full when the source is read faster than real time
+    const bool paced = d_real_time_ratio < d_conf.max_real_time_ratio;
+    const bool overloaded = d_real_time_ratio < d_conf.min_real_time_ratio or
+                            (paced and sample.buffer_occupancy > d_conf.high_occupancy);
+    const bool relaxed = d_real_time_ratio >= d_conf.min_real_time_ratio and
+                         (!paced or sample.buffer_occupancy < d_conf.low_occupancy);
+    if (overloaded)
+        {
+            d_relaxed_since_s = -1.0;
+            if (d_overloaded_since_s < 0.0)
+                {
+                    d_overloaded_since_s = sample.time_s;
+                }
+            // each step waits for the previous one to take effect
+            if (sample.time_s - std::max(d_overloaded_since_s, d_last_change_s) >= d_conf.hold_s)
+                {
+                    shed(sample);
+                }
+        }
+    else if (relaxed)
+        {
+            d_overloaded_since_s = -1.0;
+            if (d_relaxed_since_s < 0.0)
+                {
+                    d_relaxed_since_s = sample.time_s;
+                }
+            if (d_level != Normal and sample.time_s - std::max(d_relaxed_since_s, d_last_change_s) >= d_conf.recover_s)
+                {
+                    restore(sample);
+                }
+        }
+    else
+        {
+            d_overloaded_since_s = -1.0;
+            d_relaxed_since_s = -1.0;
+        }
+}
+
+
+double Load_Governor::buffer_occupancy(const gr::basic_block_sptr& block)
+{
+#if GNURADIO_USES_STD_POINTERS
+    const gr::block_sptr gr_block = std::dynamic_pointer_cast<gr::block>(block);
+#else
+    const gr::block_sptr gr_block = boost::dynamic_pointer_cast<gr::block>(block);
+#endif
+    if (gr_block == nullptr or gr_block->detail() == nullptr or gr_block->detail()->ninputs() == 0)
+        {
+            return 0.0;
+        }
+    const gr::buffer_reader_sptr reader = gr_block->detail()->input(0);
+    const int bufsize = reader->buffer()->bufsize();
+    if (bufsize <= 0)
+        {
+            return 0.0;
+        }
+    return std::min(static_cast<double>(reader->items_available()) / static_cast<double>(bufsize), 1.0);
+}
+
+
+void Load_Governor::shed(const Load_Sample& sample)
+{
+    // steps with nothing to do are skipped, and channels are released one
+    // at a time
+    for (int32_t step = std::min(d_level + 1, static_cast<int32_t>(Channels_Released)); step <= Channels_Released; step++)
+        {
+            if (d_executor(static_cast<Level>(step), true))
+                {
+                    d_level = static_cast<Level>(step);
+                    report(sample, d_level, true);
+                    return;
+                }
+        }
+    // wait another hold_s before trying again
+    d_last_change_s = sample.time_s;
+    if (!d_floor_reported)
+        {
+            d_floor_reported = true;
+            LOG(WARNING) << "The receiver is falling behind real time (" << d_real_time_ratio
+                         << " s of signal per second), and there is no more load to shed";
+            std::cout << "The receiver is falling behind real time, and there is no more load to shed" << std::endl;
+        }
+}
+
+
+void Load_Governor::restore(const Load_Sample& sample)
+{
+    d_floor_reported = false;
+    while (d_level != Normal)
+        {
+            const Level step = d_level;
+            const bool done = d_executor(step, false);
+            if (step == Channels_Released and done)
+                {
+                    // the level drops when there are no more channels to restart
+                    report(sample, step, false);
+                    return;
+                }
+            d_level = static_cast<Level>(step - 1);
+            if (done)
+                {
+                    report(sample, step, false);
+                    return;
+                }
+        }
+}
+
+
+void Load_Governor::report(const Load_Sample& sample, Level step, bool shed)
+{
+    d_last_change_s = sample.time_s;
+    Load_Event event;
+    event.time_s = sample.time_s;
+    event.level = d_level;
+    event.shed = shed;
+    event.action = action_name(step, shed);
+    event.real_time_ratio = d_real_time_ratio;
+    event.buffer_occupancy = sample.buffer_occupancy;
+    d_events.push_back(event);
+
+    std::ostringstream message;
+    message << std::setprecision(3) << "Load governor " << event.action
+            << " (" << event.real_time_ratio << " s of signal per second, input buffers "
+            << 100.0 * event.buffer_occupancy << " % full)";
+    LOG(WARNING) << message.str();
+    std::cout << message.str() << std::endl;
+}
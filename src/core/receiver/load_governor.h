@@ -0,0 +1,164 @@
+/*!
+ * \file load_governor.h
+ * \brief Detects when the receiver falls behind real time, and sheds load
+ * in a controlled order until it keeps up again
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_LOAD_GOVERNOR_H
+#define GNSS_SDR_LOAD_GOVERNOR_H
+
+#include "configuration_interface.h"
+#include <gnuradio/runtime_types.h>  // for basic_block_sptr
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Configuration of the load governor (GNSS-SDR.load_governor_* keys)
+ */
+class Load_Governor_Conf
+{
+public:
+    Load_Governor_Conf();
+
+    void SetFromConfiguration(ConfigurationInterface* configuration);
+
+    bool enable;
+    double interval_s;           // time between measurements
+    double min_real_time_ratio;  // processing slower than this is falling behind
+    double max_real_time_ratio;  // processing faster than this is not paced by a real-time source
+    double high_occupancy;       // input buffers fuller than this are falling behind
+    double low_occupancy;        // input buffers emptier than this can take more load
+    double hold_s;               // time overloaded before each shedding step
+    double recover_s;            // time with spare capacity before undoing a step
+    uint32_t min_channels;       // channels that are never released
+    int32_t monitor_decimation;  // the monitor decimation factor is multiplied by this
+};
+
+
+/*!
+ * \brief Measurement of the receiver load
+ */
+class Load_Sample
+{
+public:
+    double time_s = 0.0;            // wall time of the measurement
+    double sample_time_s = 0.0;     // samples read by the sample counter, in seconds of signal
+    double buffer_occupancy = 0.0;  // fullest input buffer of the channels (0 to 1)
+};
+
+
+/*!
+ * \brief Event generated by each shedding step, or by undoing it
+ */
+class Load_Event
+{
+public:
+    double time_s;
+    int32_t level;       // shedding level after the event
+    bool shed;           // true if load was shed, false if it was restored
+    std::string action;  // what was done
+    double real_time_ratio;
+    double buffer_occupancy;
+};
+
+
+/*!
+ * \brief Watches the rate at which the sample counter consumes samples and
+ * the occupancy of the input buffers of the channels.
+ *
+ * The receiver falls behind real time when the sample counter reads less
+ * than min_real_time_ratio seconds of signal per second, or when it keeps
+ * the pace of a real-time source (or a throttled file) but the input
+ * buffers of the channels fill up, which ends up in overflows of the
+ * source. A source that is read faster than real time (e.g., a file) always
+ * has full buffers, so their occupancy is only taken into account when the
+ * rate is below max_real_time_ratio.
+ *
+ * After hold_s seconds of overload, the governor sheds load one step at a
+ * time, in this order:
+ * -# suspends the acquisition of the satellites that are not predicted to
+ *    be visible (nor hinted by a tracked primary signal),
+ * -# reduces the correlator taps of the tracking blocks that can,
+ * -# raises the decimation of the monitor output,
+ * -# releases the tracked channel with the lowest C/N0, one more each
+ *    hold_s seconds of overload, keeping min_channels.
+ *
+ * After recover_s seconds with spare capacity, it undoes the last step
+ * (restarting the released channels one at a time). Each step is reported
+ * as a Load_Event, in the log and in the console. A step that has nothing
+ * to do (e.g., the monitor is off) is skipped.
+ */
+class Load_Governor
+{
+public:
+    enum Level : int32_t
+    {
+        Normal = 0,
+        Acquisition_Suspended,
+        Correlators_Reduced,
+        Monitor_Decimated,
+        Channels_Released
+    };
+
+    /*!
+     * \brief Applies (shed = true) or undoes a shedding step. For
+     * Channels_Released, each call releases or restarts one channel.
+     * Returns false if there was nothing to do.
+     */
+    using Executor = std::function<bool(Level step, bool shed)>;
+
+    Load_Governor(const Load_Governor_Conf& conf, Executor executor);
+
+    /*!
+     * \brief Takes a new measurement, and sheds or restores load if needed
+     */
+    void update(const Load_Sample& sample);
+
+    Level level() const { return d_level; }
+    double real_time_ratio() const { return d_real_time_ratio; }
+
+    /*!
+     * \brief All the events so far
+     */
+    const std::vector<Load_Event>& events() const { return d_events; }
+
+    /*!
+     * \brief Occupancy (0 to 1) of the first input buffer of a block, or 0 if
+     * it has no inputs or the flow graph is not running
+     */
+    static double buffer_occupancy(const gr::basic_block_sptr& block);
+
+private:
+    void shed(const Load_Sample& sample);
+    void restore(const Load_Sample& sample);
+    void report(const Load_Sample& sample, Level step, bool shed);
+
+    Load_Governor_Conf d_conf;
+    Executor d_executor;
+    Level d_level;
+    Load_Sample d_previous;
+    bool d_has_previous;
+    double d_real_time_ratio;
+    double d_overloaded_since_s;  // negative if not overloaded
+    double d_relaxed_since_s;     // negative if there is no spare capacity
+    double d_last_change_s;
+    bool d_floor_reported;  // min_channels reached
+    std::vector<Load_Event> d_events;
+};
+
+#endif  // GNSS_SDR_LOAD_GOVERNOR_H
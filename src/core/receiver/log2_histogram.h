@@ -0,0 +1,139 @@
+/*!
+ * \file log2_histogram.h
+ * \brief Histogram with power-of-two buckets, updated without locks
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_LOG2_HISTOGRAM_H
+#define GNSS_SDR_LOG2_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+/*!
+ * \brief Histogram of non-negative values. Bucket n counts the values in
+ * [2^(n-1), 2^n), and bucket 0 the zeros.
+ *
+ * record() can be called from any thread, and the other methods read a
+ * consistent enough snapshot for reporting while it is being updated.
+ */
+class Log2_Histogram
+{
+public:
+    static const std::size_t buckets = 65;
+
+    Log2_Histogram()
+    {
+        reset();
+    }
+
+    void record(uint64_t value)
+    {
+        std::size_t bucket = 0;
+        while (bucket < buckets - 1 and (value >> bucket) != 0)
+            {
+                bucket++;
+            }
+        d_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = d_max.load(std::memory_order_relaxed);
+        while (value > max and !d_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+            {
+            }
+    }
+
+    void reset()
+    {
+        for (auto& count : d_counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+        d_max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const
+    {
+        uint64_t total = 0;
+        for (const auto& count : d_counts)
+            {
+                total += count.load(std::memory_order_relaxed);
+            }
+        return total;
+    }
+
+    uint64_t max() const
+    {
+        return d_max.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Upper bound of the bucket that holds the given quantile
+     * (between 0 and 1), or 0 if nothing has been recorded
+     */
+    double quantile(double q) const
+    {
+        const uint64_t total = count();
+        if (total == 0)
+            {
+                return 0.0;
+            }
+        const auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < buckets; bucket++)
+            {
+                seen += d_counts[bucket].load(std::memory_order_relaxed);
+                if (seen >= rank)
+                    {
+                        return bucket_limit(bucket);
+                    }
+            }
+        return static_cast<double>(max());
+    }
+
+    /*!
+     * \brief Summary and non-empty buckets, one per line, with values divided
+     * by scale and followed by unit
+     */
+    std::string report(const std::string& unit, double scale = 1.0) const
+    {
+        std::stringstream str_stream;
+        str_stream << "count " << count() << ", p50 < " << quantile(0.5) / scale << " " << unit
+                   << ", p99 < " << quantile(0.99) / scale << " " << unit
+                   << ", max " << static_cast<double>(max()) / scale << " " << unit << std::endl;
+        for (std::size_t bucket = 0; bucket < buckets; bucket++)
+            {
+                const uint64_t bucket_count = d_counts[bucket].load(std::memory_order_relaxed);
+                if (bucket_count > 0)
+                    {
+                        str_stream << "  < " << bucket_limit(bucket) / scale << " " << unit << ": " << bucket_count << std::endl;
+                    }
+            }
+        return str_stream.str();
+    }
+
+private:
+    static double bucket_limit(std::size_t bucket)
+    {
+        return bucket == 0 ? 1.0 : static_cast<double>(uint64_t(1) << (bucket - 1)) * 2.0;
+    }
+
+    std::array<std::atomic<uint64_t>, buckets> d_counts;
+    std::atomic<uint64_t> d_max;
+};
+
+#endif  // GNSS_SDR_LOG2_HISTOGRAM_H
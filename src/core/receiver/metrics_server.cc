@@ -0,0 +1,179 @@
+/*!
+ * \file metrics_server.cc
+ * \brief Local HTTP endpoint that serves the performance counters of the
+ * processing blocks
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "metrics_server.h"
+#include "latency_tracer.h"
+#include <boost/asio.hpp>
+#include <glog/logging.h>
+#include <poll.h>     // for poll
+#include <array>      // for array
+#include <exception>  // for exception
+#include <sstream>    // for stringstream
+#include <utility>    // for move
+
+#if BOOST_GREATER_1_65
+using b_io_context = boost::asio::io_context;
+#else
+using b_io_context = boost::asio::io_service;
+#endif
+
+namespace
+{
+const int POLL_PERIOD_MS = 100;  // how often the server checks if it has to stop
+const int REQUEST_TIMEOUT_MS = 1000;
+}
+
+
+class Metrics_Server::Listener
+{
+public:
+    explicit Listener(uint16_t port) : acceptor(io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port))
+    {
+    }
+    b_io_context io_context;
+    boost::asio::ip::tcp::acceptor acceptor;
+};
+
+
+Metrics_Server::Metrics_Server(uint16_t port, std::function<std::vector<Block_Sample>()> collect)
+    : d_collect(std::move(collect)),
+      d_listener(new Listener(port)),
+      d_keep_running(true)
+{
+    d_thread = std::thread(&Metrics_Server::run, this);
+    LOG(INFO) << "Block metrics served on http://127.0.0.1:" << this->port() << "/metrics";
+}
+
+
+Metrics_Server::~Metrics_Server()
+{
+    // run() checks the flag at least every POLL_PERIOD_MS
+    d_keep_running = false;
+    if (d_thread.joinable())
+        {
+            d_thread.join();
+        }
+}
+
+
+uint16_t Metrics_Server::port() const
+{
+    return d_listener->acceptor.local_endpoint().port();
+}
+
+
+std::string Metrics_Server::respond(const std::string& request_line) const
+{
+    std::istringstream request(request_line);
+    std::string method;
+    std::string path;
+    request >> method >> path;
+    std::string status = "200 OK";
+    std::string content_type;
+    std::string body;
+    if (method != "GET")
+        {
+            status = "405 Method Not Allowed";
+        }
+    else if (path == "/metrics")
+        {
+            content_type = "text/plain; version=0.0.4";
+            body = d_metrics.prometheus(d_collect(), Latency_Tracer::instance().histograms());
+        }
+    else if (path == "/metrics.json")
+        {
+            content_type = "application/json";
+            body = d_metrics.json(d_collect(), Latency_Tracer::instance().histograms());
+        }
+    else
+        {
+            status = "404 Not Found";
+        }
+    if (content_type.empty())
+        {
+            content_type = "text/plain";
+            body = status + "\n";
+        }
+    std::stringstream response;
+    response << "HTTP/1.0 " << status << "\r\n"
+             << "Content-Type: " << content_type << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    return response.str();
+}
+
+
+void Metrics_Server::run()
+{
+    // Connections are waited for with a timeout, instead of in a blocking
+    // accept(), so that the destructor does not depend on waking it up
+    try
+        {
+            d_listener->acceptor.non_blocking(true);
+        }
+    catch (const std::exception& e)
+        {
+            LOG(WARNING) << "Metrics server: " << e.what();
+            return;
+        }
+    while (d_keep_running)
+        {
+            try
+                {
+                    pollfd connection_ready{d_listener->acceptor.native_handle(), POLLIN, 0};
+                    if (poll(&connection_ready, 1, POLL_PERIOD_MS) <= 0)
+                        {
+                            continue;
+                        }
+                    boost::asio::ip::tcp::socket socket(d_listener->io_context);
+                    boost::system::error_code error;
+                    d_listener->acceptor.accept(socket, error);
+                    if (error)
+                        {
+                            // the client went away before it was accepted
+                            continue;
+                        }
+                    // Only the request line matters. It comes in the first
+                    // segment, and a client that does not send it in time is
+                    // dropped, so that it can't block the server.
+                    pollfd request_ready{socket.native_handle(), POLLIN, 0};
+                    int ready = 0;
+                    for (int waited_ms = 0; ready == 0 and d_keep_running and waited_ms < REQUEST_TIMEOUT_MS; waited_ms += POLL_PERIOD_MS)
+                        {
+                            ready = poll(&request_ready, 1, POLL_PERIOD_MS);
+                        }
+                    if (ready <= 0)
+                        {
+                            continue;
+                        }
+                    std::array<char, 1024> request{};
+                    const size_t length = socket.read_some(boost::asio::buffer(request));
+                    const std::string received(request.data(), length);
+                    const std::string request_line = received.substr(0, received.find('\n'));
+                    boost::asio::write(socket, boost::asio::buffer(respond(request_line)));
+                    boost::system::error_code not_throw;
+                    socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, not_throw);
+                }
+            catch (const std::exception& e)
+                {
+                    LOG(WARNING) << "Metrics server: " << e.what();
+                }
+        }
+}
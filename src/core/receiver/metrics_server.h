@@ -0,0 +1,71 @@
+/*!
+ * \file metrics_server.h
+ * \brief Local HTTP endpoint that serves the performance counters of the
+ * processing blocks
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_METRICS_SERVER_H
+#define GNSS_SDR_METRICS_SERVER_H
+
+#include "block_metrics.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief Serves the block counters on the loopback interface:
+ * GET /metrics in Prometheus text format, and GET /metrics.json in JSON.
+ *
+ * The counters are collected when they are requested, by a thread of its
+ * own, so the processing blocks do not pay for the requests.
+ */
+class Metrics_Server
+{
+public:
+    /*!
+     * \brief Starts listening on 127.0.0.1:port (any free port if 0). Throws
+     * if the port can't be opened.
+     */
+    Metrics_Server(uint16_t port, std::function<std::vector<Block_Sample>()> collect);
+    ~Metrics_Server();
+
+    Metrics_Server(const Metrics_Server&) = delete;
+    Metrics_Server& operator=(const Metrics_Server&) = delete;
+
+    uint16_t port() const;
+
+    /*!
+     * \brief HTTP response to the given request line (e.g. "GET /metrics HTTP/1.1")
+     */
+    std::string respond(const std::string& request_line) const;
+
+private:
+    void run();
+
+    class Listener;  // socket objects, see metrics_server.cc
+
+    std::function<std::vector<Block_Sample>()> d_collect;
+    Block_Metrics d_metrics;
+    std::unique_ptr<Listener> d_listener;
+    std::atomic<bool> d_keep_running;
+    std::thread d_thread;
+};
+
+#endif  // GNSS_SDR_METRICS_SERVER_H
@@ -0,0 +1,299 @@
+/*!
+ * \file satellite_search_scheduler.cc
+ * \brief Implementation of a class that decides which satellite signal is
+ * searched next in each band
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "satellite_search_scheduler.h"
+#include <algorithm>  // for min, min_element, sort
+#include <chrono>
+#include <cmath>    // for pow
+#include <iomanip>  // for setw, setfill
+#include <sstream>
+
+
+namespace
+{
+std::string signal_key(const Gnss_Signal& signal)
+{
+    const Gnss_Satellite satellite = signal.get_satellite();
+    return satellite.get_system() + std::to_string(satellite.get_PRN()) + signal.get_signal_str();
+}
+}  // namespace
+
+
+Satellite_Search_Scheduler::Satellite_Search_Scheduler(std::function<double()> clock) : d_clock(std::move(clock)),
+                                                                                        d_backoff_base_s(5.0),
+                                                                                        d_backoff_max_s(120.0),
+                                                                                        d_sequence(0),
+                                                                                        d_high_priority_only(false)
+{
+    if (!d_clock)
+        {
+            d_clock = []() {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            };
+        }
+}
+
+
+void Satellite_Search_Scheduler::set_retry_backoff(double base_s, double max_s)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_backoff_base_s = base_s;
+    d_backoff_max_s = max_s;
+}
+
+
+void Satellite_Search_Scheduler::push_back(const Gnss_Signal& signal, bool failed)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    std::vector<Entry>& band = d_bands[signal.get_signal_str()];
+    auto it = find(band, signal);
+    if (it == band.end())
+        {
+            Entry entry;
+            entry.signal = signal;
+            entry.failures = 0;
+            entry.retry_time_s = 0.0;
+            // recover the failures of a signal taken out of the queue by next()
+            const auto failures = d_failures.find(signal_key(signal));
+            if (failures != d_failures.end())
+                {
+                    entry.failures = failures->second.first;
+                    entry.retry_time_s = failures->second.second;
+                    d_failures.erase(failures);
+                }
+            band.push_back(entry);
+            it = band.end() - 1;
+        }
+    it->sequence = d_sequence++;
+    if (failed)
+        {
+            it->failures++;
+            const double backoff_s = std::min(d_backoff_base_s * std::pow(2.0, it->failures - 1), d_backoff_max_s);
+            it->retry_time_s = d_clock() + backoff_s;
+        }
+}
+
+
+void Satellite_Search_Scheduler::remove(const Gnss_Signal& signal)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_failures.erase(signal_key(signal));
+    const auto band = d_bands.find(signal.get_signal_str());
+    if (band == d_bands.end())
+        {
+            return;
+        }
+    const auto it = find(band->second, signal);
+    if (it != band->second.end())
+        {
+            band->second.erase(it);
+        }
+}
+
+
+bool Satellite_Search_Scheduler::next(const std::string& band,
+    bool pop,
+    Gnss_Signal& signal,
+    const std::set<uint32_t>& hinted_prns)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    const auto entries = d_bands.find(band);
+    if (entries == d_bands.end() or entries->second.empty())
+        {
+            return false;
+        }
+    const double now = d_clock();
+    const auto best = std::min_element(entries->second.begin(), entries->second.end(),
+        [&](const Entry& a, const Entry& b) { return precedes(a, b, hinted_prns, now); });
+    // without predictions for the constellation (e.g., at a cold start),
+    // all its satellites are searched
+    int elevation = 0;
+    if (d_high_priority_only and hinted_prns.count(best->signal.get_satellite().get_PRN()) == 0 and
+        d_elevations.count(best->signal.get_satellite().get_system()) > 0 and
+        visibility(best->signal.get_satellite(), elevation) != visible)
+        {
+            // the best one is not a high priority signal, so no one is
+            return false;
+        }
+    signal = best->signal;
+    if (pop)
+        {
+            if (best->failures > 0)
+                {
+                    d_failures[signal_key(signal)] = std::make_pair(best->failures, best->retry_time_s);
+                }
+            entries->second.erase(best);
+        }
+    else
+        {
+            best->sequence = d_sequence++;
+        }
+    return true;
+}
+
+
+void Satellite_Search_Scheduler::set_high_priority_only(bool high_priority_only)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_high_priority_only = high_priority_only;
+}
+
+
+void Satellite_Search_Scheduler::set_visibility(const std::vector<std::pair<int, Gnss_Satellite>>& predicted_satellites)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    std::map<std::string, std::map<uint32_t, int>> elevations;
+    for (const auto& predicted_satellite : predicted_satellites)
+        {
+            elevations[predicted_satellite.second.get_system()][predicted_satellite.second.get_PRN()] = predicted_satellite.first;
+        }
+    for (auto& system : elevations)
+        {
+            d_elevations[system.first] = std::move(system.second);
+        }
+}
+
+
+void Satellite_Search_Scheduler::clear_visibility()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_elevations.clear();
+    d_failures.clear();
+    for (auto& band : d_bands)
+        {
+            for (auto& entry : band.second)
+                {
+                    entry.failures = 0;
+                    entry.retry_time_s = 0.0;
+                }
+        }
+}
+
+
+void Satellite_Search_Scheduler::clear()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_bands.clear();
+    d_failures.clear();
+}
+
+
+std::size_t Satellite_Search_Scheduler::size(const std::string& band) const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    const auto entries = d_bands.find(band);
+    return entries == d_bands.end() ? 0 : entries->second.size();
+}
+
+
+std::string Satellite_Search_Scheduler::report() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    const double now = d_clock();
+    const std::set<uint32_t> no_hints;
+    std::stringstream str_stream;
+    str_stream << "Satellite search queue, in search order:" << std::endl;
+    for (const auto& band : d_bands)
+        {
+            std::vector<Entry> entries = band.second;
+            std::sort(entries.begin(), entries.end(),
+                [&](const Entry& a, const Entry& b) { return precedes(a, b, no_hints, now); });
+            str_stream << "- " << band.first << " (" << entries.size() << "):";
+            for (const auto& entry : entries)
+                {
+                    const Gnss_Satellite satellite = entry.signal.get_satellite();
+                    int elevation = 0;
+                    str_stream << " " << satellite.get_system_short()
+                               << std::setw(2) << std::setfill('0') << satellite.get_PRN();
+                    switch (visibility(satellite, elevation))
+                        {
+                        case visible:
+                            str_stream << "(El " << elevation;
+                            break;
+                        case below_horizon:
+                            str_stream << "(below";
+                            break;
+                        default:
+                            str_stream << "(El ?";
+                            break;
+                        }
+                    if (entry.retry_time_s > now)
+                        {
+                            str_stream << ", retry in " << static_cast<int>(entry.retry_time_s - now + 0.5) << " s";
+                        }
+                    str_stream << ")";
+                }
+            str_stream << std::endl;
+        }
+    return str_stream.str();
+}
+
+
+Satellite_Search_Scheduler::Visibility Satellite_Search_Scheduler::visibility(const Gnss_Satellite& satellite, int& elevation) const
+{
+    const auto system = d_elevations.find(satellite.get_system());
+    if (system == d_elevations.end())
+        {
+            return unknown;
+        }
+    const auto prn = system->second.find(satellite.get_PRN());
+    if (prn == system->second.end())
+        {
+            // no navigation data
+            return unknown;
+        }
+    elevation = prn->second;
+    return elevation >= 0 ? visible : below_horizon;
+}
+
+
+bool Satellite_Search_Scheduler::precedes(const Entry& a, const Entry& b, const std::set<uint32_t>& hinted_prns, double now) const
+{
+    const bool a_hinted = hinted_prns.count(a.signal.get_satellite().get_PRN()) > 0;
+    const bool b_hinted = hinted_prns.count(b.signal.get_satellite().get_PRN()) > 0;
+    if (a_hinted != b_hinted)
+        {
+            return a_hinted;
+        }
+    int a_elevation = 0;
+    int b_elevation = 0;
+    const Visibility a_visibility = visibility(a.signal.get_satellite(), a_elevation);
+    const Visibility b_visibility = visibility(b.signal.get_satellite(), b_elevation);
+    if (a_visibility != b_visibility)
+        {
+            return a_visibility > b_visibility;
+        }
+    const bool a_ready = a.retry_time_s <= now;
+    const bool b_ready = b.retry_time_s <= now;
+    if (a_ready != b_ready)
+        {
+            return a_ready;
+        }
+    if (a_elevation != b_elevation)
+        {
+            return a_elevation > b_elevation;
+        }
+    return a.sequence < b.sequence;
+}
+
+
+std::vector<Satellite_Search_Scheduler::Entry>::iterator Satellite_Search_Scheduler::find(std::vector<Entry>& band, const Gnss_Signal& signal)
+{
+    return std::find_if(band.begin(), band.end(), [&](const Entry& entry) { return entry.signal == signal; });
+}
@@ -0,0 +1,153 @@
+/*!
+ * \file satellite_search_scheduler.h
+ * \brief Interface of a class that decides which satellite signal is
+ * searched next in each band
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SATELLITE_SEARCH_SCHEDULER_H
+#define GNSS_SDR_SATELLITE_SEARCH_SCHEDULER_H
+
+#include "gnss_signal.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ * \brief Queue of the satellite signals waiting to be searched, one per band
+ * (signal string: "1C", "2S", "1B", ...).
+ *
+ * Instead of a plain FIFO, the next signal of a band is the one with the
+ * highest priority, given by, in this order:
+ *  1. a cross-band hint (the satellite is already tracked in another band),
+ *  2. its predicted visibility: above the horizon, unknown, or below it,
+ *  3. whether it is still backing off after a failed acquisition,
+ *  4. its predicted elevation,
+ *  5. the time it has been waiting in the queue.
+ *
+ * The predicted elevations are given by set_visibility(), for the satellites
+ * with navigation data. The visibility of the others is unknown. The
+ * satellites predicted below the horizon are still searched, but only after
+ * all the others. Without predictions, the queue behaves as the FIFO it
+ * replaces.
+ *
+ * All the methods are thread safe. The bands have a few tens of signals at
+ * most, so a linear search of the best one is cheaper than keeping a heap
+ * up to date each time the predictions change.
+ */
+class Satellite_Search_Scheduler
+{
+public:
+    /*!
+     * \brief Constructor. The clock returns the current time, in seconds;
+     * by default, the monotonic clock of the system is used.
+     */
+    explicit Satellite_Search_Scheduler(std::function<double()> clock = nullptr);
+
+    /*!
+     * \brief Sets the backoff after a failed acquisition: it starts at
+     * base_s seconds and doubles with each consecutive failure, up to max_s.
+     */
+    void set_retry_backoff(double base_s, double max_s);
+
+    /*!
+     * \brief Queues a signal behind the ones with the same priority. If
+     * failed is true, the signal was just searched without success and backs
+     * off before competing again with the other signals of its class.
+     */
+    void push_back(const Gnss_Signal& signal, bool failed = false);
+
+    /*!
+     * \brief Removes a signal from the queue (e.g., it is being tracked)
+     */
+    void remove(const Gnss_Signal& signal);
+
+    /*!
+     * \brief Gets the next signal to be searched in a band. If pop is false,
+     * the signal stays in the queue, behind the ones with the same priority.
+     * The satellites whose PRN is in hinted_prns go first.
+     * Returns false if there is no signal left in the band (or no high
+     * priority one, see set_high_priority_only()).
+     */
+    bool next(const std::string& band,
+        bool pop,
+        Gnss_Signal& signal,
+        const std::set<uint32_t>& hinted_prns = std::set<uint32_t>());
+
+    /*!
+     * \brief Sets the predicted elevation (in degrees) of the satellites with
+     * navigation data, negative if they are below the horizon. It replaces
+     * the predictions of the constellations present in the list, and keeps
+     * the others. The satellites left out have an unknown visibility.
+     */
+    void set_visibility(const std::vector<std::pair<int, Gnss_Satellite>>& predicted_satellites);
+
+    /*!
+     * \brief If true, next() only gives the signals of the satellites that
+     * are hinted or predicted above the horizon, to save the load of
+     * searching the others (see Load_Governor). The constellations without
+     * predictions are not filtered.
+     */
+    void set_high_priority_only(bool high_priority_only);
+
+    void clear_visibility();  //!< Forgets all the predictions and failures
+    void clear();             //!< Removes all the signals
+
+    std::size_t size(const std::string& band) const;  //!< Number of signals queued in a band
+
+    /*!
+     * \brief Human-readable state of the queues, in search order
+     */
+    std::string report() const;
+
+private:
+    class Entry
+    {
+    public:
+        Gnss_Signal signal;
+        uint64_t sequence;    // order of arrival, to break ties
+        uint32_t failures;    // consecutive failed acquisitions
+        double retry_time_s;  // end of the backoff
+    };
+
+    enum Visibility
+    {
+        below_horizon = 0,
+        unknown = 1,
+        visible = 2
+    };
+
+    Visibility visibility(const Gnss_Satellite& satellite, int& elevation) const;
+    bool precedes(const Entry& a, const Entry& b, const std::set<uint32_t>& hinted_prns, double now) const;
+    std::vector<Entry>::iterator find(std::vector<Entry>& band, const Gnss_Signal& signal);
+
+    std::function<double()> d_clock;
+    double d_backoff_base_s;
+    double d_backoff_max_s;
+    uint64_t d_sequence;
+    bool d_high_priority_only;
+    std::map<std::string, std::vector<Entry>> d_bands;
+    std::map<std::string, std::map<uint32_t, int>> d_elevations;  // per constellation and PRN
+    std::map<std::string, std::pair<uint32_t, double>> d_failures;  // kept while a signal is out of the queue
+    mutable std::mutex d_mutex;
+};
+
+#endif  // GNSS_SDR_SATELLITE_SEARCH_SCHEDULER_H
@@ -20,12 +20,18 @@
 
 #include "tcp_cmd_interface.h"
 #include "command_event.h"
+#include "control_event_queue.h"
 #include "pvt_interface.h"
+#include "reconfiguration_event.h"
+#include "satellite_search_scheduler.h"
 #include <boost/asio.hpp>
+#include <chrono>     // for seconds
 #include <cmath>      // for isnan
 #include <exception>  // for exception
+#include <future>     // for future
 #include <iomanip>    // for setprecision
 #include <sstream>    // for stringstream
+#include <stdexcept>  // for invalid_argument
 #include <utility>    // for move
 
 #if BOOST_GREATER_1_65
@@ -55,6 +61,12 @@ void TcpCmdInterface::register_functions()
     functions["warmstart"] = std::bind(&TcpCmdInterface::warmstart, this, std::placeholders::_1);
     functions["coldstart"] = std::bind(&TcpCmdInterface::coldstart, this, std::placeholders::_1);
     functions["set_ch_satellite"] = std::bind(&TcpCmdInterface::set_ch_satellite, this, std::placeholders::_1);
+    functions["search_queue"] = std::bind(&TcpCmdInterface::search_queue, this, std::placeholders::_1);
+    functions["event_queue"] = std::bind(&TcpCmdInterface::event_queue, this, std::placeholders::_1);
+    functions["channel_stop"] = std::bind(&TcpCmdInterface::channel_stop, this, std::placeholders::_1);
+    functions["channel_start"] = std::bind(&TcpCmdInterface::channel_start, this, std::placeholders::_1);
+    functions["reconfigure_channel"] = std::bind(&TcpCmdInterface::reconfigure_channel, this, std::placeholders::_1);
+    functions["reconfigure_conditioner"] = std::bind(&TcpCmdInterface::reconfigure_conditioner, this, std::placeholders::_1);
 }
 
 
@@ -64,6 +76,18 @@ void TcpCmdInterface::set_pvt(std::shared_ptr<PvtInterface> PVT_sptr)
 }
 
 
+void TcpCmdInterface::set_search_scheduler(std::shared_ptr<Satellite_Search_Scheduler> search_scheduler)
+{
+    search_scheduler_ = std::move(search_scheduler);
+}
+
+
+void TcpCmdInterface::set_event_queue(std::shared_ptr<Control_Event_Queue> event_queue)
+{
+    event_queue_ = std::move(event_queue);
+}
+
+
 time_t TcpCmdInterface::get_utc_time()
 {
     return receiver_utc_time_;
@@ -285,6 +309,118 @@ std::string TcpCmdInterface::set_ch_satellite(const std::vector<std::string> &co
 }
 
 
+std::string TcpCmdInterface::search_queue(const std::vector<std::string> &commandLine __attribute__((unused)))
+{
+    if (search_scheduler_ == nullptr)
+        {
+            return "ERROR\n";
+        }
+    return search_scheduler_->report();
+}
+
+
+std::string TcpCmdInterface::event_queue(const std::vector<std::string> &commandLine __attribute__((unused)))
+{
+    if (event_queue_ == nullptr)
+        {
+            return "ERROR\n";
+        }
+    return event_queue_->report();
+}
+
+
+std::string TcpCmdInterface::channel_command(const std::vector<std::string> &commandLine, unsigned int what)
+{
+    if (commandLine.size() != 2)
+        {
+            return "ERROR: please use " + commandLine.at(0) + " channel_id\n";
+        }
+    const int channel = std::stoi(commandLine.at(1));
+    if (channel < 0 or channel > 199)
+        {
+            return "ERROR: channel_id out of range\n";
+        }
+    if (control_queue_ == nullptr)
+        {
+            return "ERROR\n";
+        }
+    command_event_sptr new_evnt = command_event_make(400 + channel, what);  // TC channel control (who=400+channel)
+    control_queue_->push(pmt::make_any(new_evnt));
+    return "OK\n";
+}
+
+
+std::string TcpCmdInterface::channel_stop(const std::vector<std::string> &commandLine)
+{
+    return channel_command(commandLine, 20);
+}
+
+
+std::string TcpCmdInterface::channel_start(const std::vector<std::string> &commandLine)
+{
+    return channel_command(commandLine, 21);
+}
+
+
+/*
+ * Splits the key=value arguments that follow the command and the block number
+ */
+static std::vector<std::pair<std::string, std::string>> parse_properties(const std::vector<std::string> &commandLine)
+{
+    std::vector<std::pair<std::string, std::string>> properties;
+    for (size_t n = 2; n < commandLine.size(); n++)
+        {
+            const size_t separator = commandLine.at(n).find('=');
+            if (separator == std::string::npos or separator == 0)
+                {
+                    throw std::invalid_argument("malformed property " + commandLine.at(n) + ", please use key=value");
+                }
+            properties.emplace_back(commandLine.at(n).substr(0, separator), commandLine.at(n).substr(separator + 1));
+        }
+    return properties;
+}
+
+
+std::string TcpCmdInterface::reconfigure(const std::vector<std::string> &commandLine, bool conditioner)
+{
+    if (commandLine.size() < 2)
+        {
+            return "ERROR: please use " + commandLine.at(0) + (conditioner ? " conditioner_id" : " channel_id") + " [key=value ...]\n";
+        }
+    if (control_queue_ == nullptr)
+        {
+            return "ERROR\n";
+        }
+    // the blocks are replaced by the control thread, which also dispatches
+    // the events of the channels
+    const reconfiguration_event_sptr new_evnt = reconfiguration_event_make(conditioner, std::stoul(commandLine.at(1)), parse_properties(commandLine));
+    std::future<std::string> result = new_evnt->result.get_future();
+    control_queue_->push(pmt::make_any(new_evnt));
+    if (result.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+        {
+            return "ERROR: the receiver did not answer\n";
+        }
+    const std::string error = result.get();
+    if (!error.empty())
+        {
+            return "ERROR: " + error + "\n";
+        }
+    return "OK\n";
+}
+
+
+std::string TcpCmdInterface::reconfigure_channel(const std::vector<std::string> &commandLine)
+{
+    return reconfigure(commandLine, false);
+}
+
+
+std::string TcpCmdInterface::reconfigure_conditioner(const std::vector<std::string> &commandLine)
+{
+    return reconfigure(commandLine, true);
+}
+
+
 void TcpCmdInterface::set_msg_queue(std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> control_queue)
 {
     control_queue_ = std::move(control_queue);
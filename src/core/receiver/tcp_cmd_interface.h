@@ -32,7 +32,9 @@
 #include <unordered_map>
 #include <vector>
 
+class Control_Event_Queue;
 class PvtInterface;
+class Satellite_Search_Scheduler;
 
 class TcpCmdInterface
 {
@@ -54,6 +56,10 @@ public:
 
     void set_pvt(std::shared_ptr<PvtInterface> PVT_sptr);
 
+    void set_search_scheduler(std::shared_ptr<Satellite_Search_Scheduler> search_scheduler);
+
+    void set_event_queue(std::shared_ptr<Control_Event_Queue> event_queue);
+
 private:
     std::unordered_map<std::string, std::function<std::string(const std::vector<std::string> &)>>
         functions;
@@ -64,6 +70,14 @@ private:
     std::string warmstart(const std::vector<std::string> &commandLine);
     std::string coldstart(const std::vector<std::string> &commandLine);
     std::string set_ch_satellite(const std::vector<std::string> &commandLine);
+    std::string search_queue(const std::vector<std::string> &commandLine);
+    std::string event_queue(const std::vector<std::string> &commandLine);
+    std::string channel_stop(const std::vector<std::string> &commandLine);
+    std::string channel_start(const std::vector<std::string> &commandLine);
+    std::string reconfigure_channel(const std::vector<std::string> &commandLine);
+    std::string reconfigure_conditioner(const std::vector<std::string> &commandLine);
+    std::string channel_command(const std::vector<std::string> &commandLine, unsigned int what);
+    std::string reconfigure(const std::vector<std::string> &commandLine, bool conditioner);
 
     void register_functions();
 
@@ -77,6 +91,8 @@ private:
     float rx_altitude_;
 
     std::shared_ptr<PvtInterface> PVT_sptr_;
+    std::shared_ptr<Satellite_Search_Scheduler> search_scheduler_;
+    std::shared_ptr<Control_Event_Queue> event_queue_;
 };
 
 #endif  // GNSS_SDR_TCP_CMD_INTERFACE_H
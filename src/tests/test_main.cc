@@ -46,15 +46,24 @@ DECLARE_string(log_dir);
 #include "unit-tests/arithmetic/complex_carrier_test.cc"
 #include "unit-tests/arithmetic/conjugate_test.cc"
 #include "unit-tests/arithmetic/fft_length_test.cc"
+#include "unit-tests/arithmetic/fft_plan_registry_test.cc"
 #include "unit-tests/arithmetic/fft_speed_test.cc"
 #include "unit-tests/arithmetic/magnitude_squared_test.cc"
 #include "unit-tests/arithmetic/multiply_test.cc"
+#include "unit-tests/control-plane/batch_processor_test.cc"
+#include "unit-tests/control-plane/block_metrics_test.cc"
+#include "unit-tests/control-plane/control_event_queue_test.cc"
 #include "unit-tests/control-plane/control_thread_test.cc"
 #include "unit-tests/control-plane/file_configuration_test.cc"
+#include "unit-tests/control-plane/flowgraph_conf_test.cc"
 #include "unit-tests/control-plane/gnss_block_factory_test.cc"
 #include "unit-tests/control-plane/gnss_flowgraph_test.cc"
+#include "unit-tests/control-plane/gnss_synchro_udp_sink_test.cc"
 #include "unit-tests/control-plane/in_memory_configuration_test.cc"
+#include "unit-tests/control-plane/latency_tracer_test.cc"
+#include "unit-tests/control-plane/load_governor_test.cc"
 #include "unit-tests/control-plane/protobuf_test.cc"
+#include "unit-tests/control-plane/satellite_search_scheduler_test.cc"
 #include "unit-tests/control-plane/string_converter_test.cc"
 #include "unit-tests/signal-processing-blocks/acquisition/galileo_e1_pcps_8ms_ambiguous_acquisition_gsoc2013_test.cc"
 #include "unit-tests/signal-processing-blocks/acquisition/galileo_e1_pcps_ambiguous_acquisition_gsoc2013_test.cc"
@@ -71,15 +80,25 @@ DECLARE_string(log_dir);
 #include "unit-tests/signal-processing-blocks/acquisition/gps_l1_ca_pcps_tong_acquisition_gsoc2013_test.cc"
 #include "unit-tests/signal-processing-blocks/adapter/adapter_test.cc"
 #include "unit-tests/signal-processing-blocks/adapter/pass_through_test.cc"
+#include "unit-tests/signal-processing-blocks/filter/fft_channelizer_test.cc"
 #include "unit-tests/signal-processing-blocks/filter/fir_filter_test.cc"
+#include "unit-tests/signal-processing-blocks/filter/interference_mitigation_test.cc"
+#include "unit-tests/signal-processing-blocks/filter/multibeam_beamformer_test.cc"
 #include "unit-tests/signal-processing-blocks/filter/notch_filter_lite_test.cc"
 #include "unit-tests/signal-processing-blocks/filter/notch_filter_test.cc"
 #include "unit-tests/signal-processing-blocks/filter/pulse_blanking_filter_test.cc"
 #include "unit-tests/signal-processing-blocks/resampler/direct_resampler_conditioner_cc_test.cc"
 #include "unit-tests/signal-processing-blocks/resampler/mmse_resampler_test.cc"
+#include "unit-tests/signal-processing-blocks/resampler/polyphase_resampler_test.cc"
 #include "unit-tests/signal-processing-blocks/sources/file_signal_source_test.cc"
 #include "unit-tests/signal-processing-blocks/sources/gnss_sdr_valve_test.cc"
+#include "unit-tests/signal-processing-blocks/sources/iq_archive_test.cc"
+#include "unit-tests/signal-processing-blocks/sources/shm_sample_bus_test.cc"
+#include "unit-tests/signal-processing-blocks/sources/spsc_byte_ring_test.cc"
 #include "unit-tests/signal-processing-blocks/sources/unpack_2bit_samples_test.cc"
+#if RAW_UDP_BLOCKS_TEST
+#include "unit-tests/signal-processing-blocks/sources/gr_complex_ip_packet_source_test.cc"
+#endif
 // #include "unit-tests/signal-processing-blocks/acquisition/glonass_l2_ca_pcps_acquisition_test.cc"
 #include "unit-tests/signal-processing-blocks/libs/item_type_helpers_test.cc"
 
@@ -113,9 +132,13 @@ DECLARE_string(log_dir);
 #endif
 
 #include "unit-tests/signal-processing-blocks/pvt/nmea_printer_test.cc"
+#include "unit-tests/signal-processing-blocks/pvt/observables_epoch_test.cc"
+#include "unit-tests/signal-processing-blocks/pvt/pvt_output_sink_test.cc"
+#include "unit-tests/signal-processing-blocks/pvt/receiver_state_snapshot_test.cc"
 #include "unit-tests/signal-processing-blocks/pvt/rinex_printer_test.cc"
 #include "unit-tests/signal-processing-blocks/pvt/rtcm_printer_test.cc"
 #include "unit-tests/signal-processing-blocks/pvt/rtcm_test.cc"
+#include "unit-tests/signal-processing-blocks/pvt/rtklib_orbit_cache_test.cc"
 #include "unit-tests/signal-processing-blocks/pvt/serdes_monitor_pvt_test.cc"
 #include "unit-tests/signal-processing-blocks/telemetry_decoder/galileo_fnav_inav_decoder_test.cc"
 #include "unit-tests/system-parameters/glonass_gnav_crc_test.cc"
@@ -0,0 +1,96 @@
+/*!
+ * \file fft_plan_registry_test.cc
+ * \brief Tests for Fft_Plan_Registry
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_plan_registry.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+
+TEST(FftPlanRegistryTest, ReusesReturnedPlans)
+{
+    Fft_Plan_Registry& registry = Fft_Plan_Registry::instance();
+    const uint64_t created = registry.get_created();
+    const uint64_t reused = registry.get_reused();
+    gr::fft::fft_complex* first_plan;
+    {
+        const auto plan = registry.get(37, true);
+        first_plan = plan.get();
+        // a second user at the same time gets its own plan
+        const auto other_plan = registry.get(37, true);
+        EXPECT_NE(other_plan.get(), first_plan);
+        // and so does the other direction
+        const auto inverse_plan = registry.get(37, false);
+        EXPECT_NE(inverse_plan.get(), first_plan);
+    }
+    EXPECT_EQ(registry.get_created(), created + 3);
+
+    const auto plan = registry.get(37, true);
+    EXPECT_EQ(registry.get_reused(), reused + 1);
+    EXPECT_EQ(registry.get_created(), created + 3);
+    const auto other_plan = registry.get(37, true);
+    EXPECT_TRUE(plan.get() == first_plan or other_plan.get() == first_plan);
+    EXPECT_EQ(registry.get_created(), created + 3);
+}
+
+
+TEST(FftPlanRegistryTest, WarmsUpAnnouncedSizes)
+{
+    Fft_Plan_Registry& registry = Fft_Plan_Registry::instance();
+    // the sizes announced by other tests are forgotten
+    registry.clear();
+    registry.announce(41, true);
+    registry.announce(41, false);
+    const uint64_t created = registry.get_created();
+    // sizes that already have enough plans are left alone
+    EXPECT_EQ(registry.warm_up(1), 2U);
+    EXPECT_EQ(registry.get_created(), created + 2);
+    EXPECT_EQ(registry.warm_up(1), 0U);
+
+    // the plans are ready for the first user, in any thread
+    std::thread user([&registry]() {
+        const auto plan = registry.get(41, true);
+        std::fill_n(plan->get_inbuf(), 41, gr_complex(0.0, 0.0));
+        plan->get_inbuf()[0] = gr_complex(1.0, 0.0);
+        plan->execute();
+        EXPECT_EQ(plan->get_outbuf()[40], gr_complex(1.0, 0.0));
+    });
+    user.join();
+    EXPECT_EQ(registry.get_created(), created + 2);
+}
+
+
+TEST(FftPlanRegistryTest, ClearDestroysThePlans)
+{
+    Fft_Plan_Registry& registry = Fft_Plan_Registry::instance();
+    registry.clear();
+    registry.announce(43, true);
+    const auto borrowed = registry.get(43, true);
+    {
+        const auto returned = registry.get(43, true);
+    }
+    registry.clear();
+    EXPECT_EQ(registry.warm_up(1), 0U);  // nothing announced
+
+    // neither the free plan nor the borrowed one are lent again
+    const uint64_t created = registry.get_created();
+    const auto plan = registry.get(43, true);
+    EXPECT_NE(plan.get(), borrowed.get());
+    EXPECT_EQ(registry.get_created(), created + 1);
+}
@@ -0,0 +1,287 @@
+/*!
+ * \file batch_processor_test.cc
+ * \brief Unit tests for the segment planning and the output stitching of the
+ * batch processor.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "batch_processor.h"
+#include "file_configuration.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+void write_text(const std::string& filename, const std::string& text)
+{
+    std::ofstream out(filename, std::ios::out | std::ios::trunc);
+    out << text;
+}
+
+
+std::string read_text(const std::string& filename)
+{
+    std::ifstream in(filename);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+
+const std::string rinex_obs_header =
+    "     3.02           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+    "                                                            END OF HEADER\n";
+
+
+std::string rinex_obs_epoch(int second, const std::string& observation)
+{
+    std::stringstream ss;
+    ss << "> 2020 05 01 10 00 " << (second < 10 ? " " : "") << second << ".0000000  0  1\n"
+       << "G01  " << observation << "\n";
+    return ss.str();
+}
+
+
+const std::string kml_header =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<kml xmlns=\"http://www.opengis.net/kml/2.2\">\n"
+    "  <Document>\n"
+    "    <Folder>\n"
+    "      <name>Points</name>\n";
+
+
+std::string kml_placemark(int id, int second, const std::string& coordinates)
+{
+    std::stringstream ss;
+    ss << "      <Placemark>\n"
+       << "        <name>" << id << "</name>\n"
+       << "        <TimeStamp>\n"
+       << "          <when>2020-05-01T10:00:" << (second < 10 ? "0" : "") << second << ".000Z</when>\n"
+       << "        </TimeStamp>\n"
+       << "        <Point>\n"
+       << "          <coordinates>" << coordinates << "</coordinates>\n"
+       << "        </Point>\n"
+       << "      </Placemark>\n";
+    return ss.str();
+}
+
+
+std::string kml_footer(const std::vector<std::string>& coordinates)
+{
+    std::stringstream ss;
+    ss << "    </Folder>\n"
+       << "    <Placemark>\n"
+       << "      <name>Path</name>\n"
+       << "      <styleUrl>#yellowLineGreenPoly</styleUrl>\n"
+       << "      <LineString>\n"
+       << "        <extrude>0</extrude>\n"
+       << "        <tessellate>1</tessellate>\n"
+       << "        <altitudeMode>absolute</altitudeMode>\n"
+       << "        <coordinates>\n";
+    for (const auto& c : coordinates)
+        {
+            ss << "          " << c << "\n";
+        }
+    ss << "        </coordinates>\n"
+       << "      </LineString>\n"
+       << "    </Placemark>\n"
+       << "  </Document>\n"
+       << "</kml>";
+    return ss.str();
+}
+}  // namespace
+
+
+TEST(BatchProcessorTest, PlanSegments)
+{
+    std::vector<Batch_Segment> segments = BatchProcessor::plan_segments(100.0, 25.0, 10.0);
+    ASSERT_EQ(4U, segments.size());
+    EXPECT_DOUBLE_EQ(0.0, segments[0].start_s);
+    EXPECT_DOUBLE_EQ(0.0, segments[0].core_start_s);
+    EXPECT_DOUBLE_EQ(25.0, segments[0].end_s);
+    EXPECT_DOUBLE_EQ(15.0, segments[1].start_s);
+    EXPECT_DOUBLE_EQ(25.0, segments[1].core_start_s);
+    EXPECT_DOUBLE_EQ(50.0, segments[1].end_s);
+    EXPECT_FALSE(segments[2].last);
+    EXPECT_TRUE(segments[3].last);
+    EXPECT_DOUBLE_EQ(100.0, segments[3].end_s);
+
+    // a remainder shorter than half a segment goes to the last one
+    segments = BatchProcessor::plan_segments(110.0, 25.0, 10.0);
+    ASSERT_EQ(4U, segments.size());
+    EXPECT_DOUBLE_EQ(110.0, segments[3].end_s);
+
+    segments = BatchProcessor::plan_segments(100.0, 0.0, 10.0);
+    ASSERT_EQ(1U, segments.size());
+    EXPECT_DOUBLE_EQ(0.0, segments[0].start_s);
+    EXPECT_TRUE(segments[0].last);
+}
+
+
+TEST(BatchProcessorTest, SegmentConfigOverridesProperties)
+{
+    const std::string base = "./batch_base.conf";
+    const std::string segment = "./batch_segment.conf";
+    write_text(base, "[GNSS-SDR]\nSignalSource.seconds_to_skip=0\nPVT.output_path=.\nChannels.count=8\n");
+
+    std::map<std::string, std::string> overrides;
+    overrides["SignalSource.seconds_to_skip"] = "120.5";
+    overrides["PVT.output_path"] = "/tmp/segment_001";
+    ASSERT_TRUE(BatchProcessor::write_segment_config(base, overrides, segment));
+
+    FileConfiguration configuration(segment);
+    EXPECT_DOUBLE_EQ(120.5, configuration.property("SignalSource.seconds_to_skip", 0.0));
+    EXPECT_EQ("/tmp/segment_001", configuration.property("PVT.output_path", std::string(".")));
+    EXPECT_EQ(8, configuration.property("Channels.count", 0));
+
+    std::remove(base.c_str());
+    std::remove(segment.c_str());
+}
+
+
+TEST(BatchProcessorTest, StitchRinexObs)
+{
+    // the second segment starts during the last epochs of the first one
+    const std::string first = "./batch_first.20O";
+    const std::string second = "./batch_second.20O";
+    const std::string output = "./batch_stitched.20O";
+    write_text(first, rinex_obs_header + rinex_obs_epoch(0, "first") + rinex_obs_epoch(1, "first") + rinex_obs_epoch(2, "first"));
+    write_text(second, rinex_obs_header + rinex_obs_epoch(1, "second") + rinex_obs_epoch(2, "second") + rinex_obs_epoch(3, "second"));
+
+    ASSERT_TRUE(BatchProcessor::stitch_rinex_obs({first, second}, output));
+    const std::string expected = rinex_obs_header + rinex_obs_epoch(0, "first") + rinex_obs_epoch(1, "first") + rinex_obs_epoch(2, "first") + rinex_obs_epoch(3, "second");
+    EXPECT_EQ(expected, read_text(output));
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+    std::remove(output.c_str());
+}
+
+
+TEST(BatchProcessorTest, StitchRinexNavDropsRepeatedRecords)
+{
+    const std::string header =
+        "     3.02           N: GNSS NAV DATA    G: GPS              RINEX VERSION / TYPE\n"
+        "                                                            END OF HEADER\n";
+    const std::string record1 =
+        "G01 2020 05 01 10 00 00 1.0\n"
+        "     1.0 2.0\n";
+    const std::string record2 =
+        "G02 2020 05 01 10 00 00 2.0\n"
+        "     3.0 4.0\n";
+    const std::string first = "./batch_first.20N";
+    const std::string second = "./batch_second.20N";
+    const std::string output = "./batch_stitched.20N";
+    write_text(first, header + record1);
+    write_text(second, header + record1 + record2);
+
+    ASSERT_TRUE(BatchProcessor::stitch_rinex_nav({first, second}, output));
+    EXPECT_EQ(header + record1 + record2, read_text(output));
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+    std::remove(output.c_str());
+}
+
+
+TEST(BatchProcessorTest, StitchNmea)
+{
+    const std::string rmc1 = "$GPRMC,100000.000,A,4116.7311,N,00159.8355,E,0.0,0.0,010520,,*00\r\n";
+    const std::string rmc2 = "$GPRMC,100001.000,A,4116.7311,N,00159.8355,E,0.0,0.0,010520,,*00\r\n";
+    const std::string rmc3 = "$GPRMC,100002.000,A,4116.7311,N,00159.8355,E,0.0,0.0,010520,,*00\r\n";
+    const std::string no_fix = "$GPRMC,,V,,,,,,,,,*00\r\n";
+    const std::string gga = "$GPGGA,first\r\n";
+    const std::string gga2 = "$GPGGA,second\r\n";
+    const std::string first = "./batch_first.nmea";
+    const std::string second = "./batch_second.nmea";
+    const std::string output = "./batch_stitched.nmea";
+    write_text(first, no_fix + rmc1 + gga + rmc2 + gga);
+    write_text(second, no_fix + rmc2 + gga2 + rmc3 + gga2);
+
+    ASSERT_TRUE(BatchProcessor::stitch_nmea({first, second}, output));
+    EXPECT_EQ(no_fix + rmc1 + gga + rmc2 + gga + rmc3 + gga2, read_text(output));
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+    std::remove(output.c_str());
+}
+
+
+TEST(BatchProcessorTest, StitchKml)
+{
+    const std::string first = "./batch_first.kml";
+    const std::string second = "./batch_second.kml";
+    const std::string output = "./batch_stitched.kml";
+    write_text(first, kml_header + kml_placemark(1, 0, "2,41,10") + kml_placemark(2, 1, "2,41,11") + kml_footer({"2,41,10", "2,41,11"}));
+    write_text(second, kml_header + kml_placemark(1, 1, "3,42,11") + kml_placemark(2, 2, "3,42,12") + kml_footer({"3,42,11", "3,42,12"}));
+
+    ASSERT_TRUE(BatchProcessor::stitch_kml({first, second}, output));
+    const std::string expected = kml_header + kml_placemark(1, 0, "2,41,10") + kml_placemark(2, 1, "2,41,11") + kml_placemark(3, 2, "3,42,12") +
+                                 kml_footer({"2,41,10", "2,41,11", "3,42,12"});
+    EXPECT_EQ(expected, read_text(output));
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+    std::remove(output.c_str());
+}
+
+
+TEST(BatchProcessorTest, StitchObservablesDump)
+{
+    // 2 channels, 7 doubles per channel: RX time, TOW, Doppler, phase, pseudorange, PRN, valid
+    const uint32_t nchannels = 2;
+    const auto epoch = [](double rx_time, double value) {
+        return std::vector<double>{rx_time, rx_time, value, value, value, 1.0, 1.0,
+            0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    };
+    const auto write_epochs = [](const std::string& filename, const std::vector<std::vector<double>>& epochs) {
+        std::ofstream out(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        for (const auto& e : epochs)
+            {
+                out.write(reinterpret_cast<const char*>(e.data()), e.size() * sizeof(double));
+            }
+    };
+    const std::string first = "./batch_first.dat";
+    const std::string second = "./batch_second.dat";
+    const std::string output = "./batch_stitched.dat";
+    // epochs without a receiver time are only kept from the first file
+    write_epochs(first, {epoch(0.0, 0.0), epoch(100.0, 1.0), epoch(101.0, 1.0)});
+    write_epochs(second, {epoch(0.0, 0.0), epoch(101.0, 2.0), epoch(102.0, 2.0)});
+
+    ASSERT_TRUE(BatchProcessor::stitch_observables_dump({first, second}, nchannels, output));
+    std::ifstream in(output, std::ios::binary);
+    std::vector<double> stitched;
+    double value = 0.0;
+    while (in.read(reinterpret_cast<char*>(&value), sizeof(double)))
+        {
+            stitched.push_back(value);
+        }
+    std::vector<double> expected;
+    for (const auto& e : {epoch(0.0, 0.0), epoch(100.0, 1.0), epoch(101.0, 1.0), epoch(102.0, 2.0)})
+        {
+            expected.insert(expected.end(), e.begin(), e.end());
+        }
+    EXPECT_EQ(expected, stitched);
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+    std::remove(output.c_str());
+}
@@ -0,0 +1,262 @@
+/*!
+ * \file block_metrics_test.cc
+ * \brief Tests for Block_Metrics and Metrics_Server
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "block_metrics.h"
+#include "metrics_server.h"
+#include <arpa/inet.h>  // for htons, inet_pton
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/null_source.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/prefs.h>
+#include <gnuradio/sync_decimator.h>
+#include <gnuradio/top_block.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>  // for sockaddr_in
+#include <sys/socket.h>  // for socket, connect
+#include <unistd.h>      // for close
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <complex>
+#include <iostream>
+#include <string>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+
+namespace
+{
+std::vector<Block_Sample> make_samples()
+{
+    std::vector<Block_Sample> samples(3);
+    samples[0].name = "SignalConditioner";
+    samples[0].work_calls = 10;
+    samples[0].items_out = 40000;
+    samples[1].name = "Channel0.acquisition";
+    samples[1].channel = 0;
+    samples[1].work_s = 0.25;
+    samples[1].input_buffer_full = 0.5;
+    samples[2].name = "Channel0.tracking";
+    samples[2].channel = 0;
+    samples[2].work_s = 0.5;
+    samples[2].items_in = 4000;
+    return samples;
+}
+
+
+std::string http_get(uint16_t port, const std::string& path)
+{
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    std::string response;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+        {
+            const std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            send(fd, request.data(), request.size(), 0);
+            std::array<char, 4096> buffer{};
+            ssize_t length;
+            while ((length = recv(fd, buffer.data(), buffer.size(), 0)) > 0)
+                {
+                    response.append(buffer.data(), length);
+                }
+        }
+    close(fd);
+    return response;
+}
+
+
+// About the work of a tracking block in each call to work(): carrier
+// wipe-off and early, prompt and late correlations of 1 ms of signal at
+// 4 Msps, the lowest usual sampling rate.
+class Metrics_Overhead_Correlator : public gr::sync_decimator
+{
+public:
+    static const int SAMPLES_PER_CALL = 4000;
+
+    Metrics_Overhead_Correlator() : gr::sync_decimator("metrics_overhead_correlator",
+                                        gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                                        gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                                        SAMPLES_PER_CALL),
+                                    d_early(SAMPLES_PER_CALL, 1.0F),
+                                    d_prompt(SAMPLES_PER_CALL, -1.0F),
+                                    d_late(SAMPLES_PER_CALL, 1.0F)
+    {
+        set_max_noutput_items(1);
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star& input_items, gr_vector_void_star& output_items) override
+    {
+        const auto* in = static_cast<const gr_complex*>(input_items[0]);
+        auto* out = static_cast<gr_complex*>(output_items[0]);
+        const gr_complex carrier_step = std::polar(1.0F, 0.01F);
+        for (int n = 0; n < noutput_items; n++)
+            {
+                gr_complex carrier(1.0F, 0.0F);
+                gr_complex early(0.0F, 0.0F);
+                gr_complex prompt(0.0F, 0.0F);
+                gr_complex late(0.0F, 0.0F);
+                for (int i = 0; i < SAMPLES_PER_CALL; i++)
+                    {
+                        const gr_complex sample = in[n * SAMPLES_PER_CALL + i] * carrier;
+                        carrier *= carrier_step;
+                        early += sample * d_early[i];
+                        prompt += sample * d_prompt[i];
+                        late += sample * d_late[i];
+                    }
+                out[n] = early + prompt + late;
+            }
+        return noutput_items;
+    }
+
+private:
+    std::vector<float> d_early;
+    std::vector<float> d_prompt;
+    std::vector<float> d_late;
+};
+
+
+// Runs the correlator over calls * SAMPLES_PER_CALL samples, and returns the
+// elapsed time in seconds
+double run_metrics_overhead_flowgraph(int calls, bool counters, Block_Sample& sample)
+{
+    gr::prefs::singleton()->set_bool("PerfCounters", "on", counters);
+    auto top_block = gr::make_top_block("metrics_overhead");
+    auto source = gr::blocks::null_source::make(sizeof(gr_complex));
+    auto head = gr::blocks::head::make(sizeof(gr_complex), static_cast<uint64_t>(calls) * Metrics_Overhead_Correlator::SAMPLES_PER_CALL);
+#if GNURADIO_USES_STD_POINTERS
+    auto correlator = std::shared_ptr<Metrics_Overhead_Correlator>(new Metrics_Overhead_Correlator());
+#else
+    auto correlator = boost::shared_ptr<Metrics_Overhead_Correlator>(new Metrics_Overhead_Correlator());
+#endif
+    auto sink = gr::blocks::null_sink::make(sizeof(gr_complex));
+    top_block->connect(source, 0, head, 0);
+    top_block->connect(head, 0, correlator, 0);
+    top_block->connect(correlator, 0, sink, 0);
+    const auto start = std::chrono::steady_clock::now();
+    top_block->run();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    sample = Block_Metrics::sample("correlator", -1, correlator);
+    gr::prefs::singleton()->set_bool("PerfCounters", "on", false);
+    return elapsed.count();
+}
+}  // namespace
+
+
+TEST(BlockMetricsTest, PrometheusText)
+{
+    Block_Metrics metrics;
+    const std::string text = metrics.prometheus(make_samples());
+    EXPECT_NE(text.find("# TYPE gnss_sdr_block_work_calls_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_block_work_calls_total{block=\"SignalConditioner\",channel=\"-1\"} 10\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_block_items_out_total{block=\"SignalConditioner\",channel=\"-1\"} 40000\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_block_input_buffer_full_ratio{block=\"Channel0.acquisition\",channel=\"0\"} 0.5\n"), std::string::npos);
+    // the blocks of a channel are added up
+    EXPECT_NE(text.find("gnss_sdr_channel_work_seconds_total{channel=\"0\"} 0.75\n"), std::string::npos);
+    EXPECT_EQ(text.find("gnss_sdr_channel_work_seconds_total{channel=\"-1\"}"), std::string::npos);
+}
+
+
+TEST(BlockMetricsTest, Json)
+{
+    Block_Metrics metrics;
+    const std::string text = metrics.json(make_samples());
+    EXPECT_EQ(text.find("{\"uptime_s\":"), 0U);
+    EXPECT_NE(text.find("{\"name\":\"Channel0.tracking\",\"channel\":0,\"work_calls\":0,\"work_s\":0.5,\"items_in\":4000,"), std::string::npos);
+    EXPECT_NE(text.find("\"channels\":[{\"channel\":0,\"work_s\":0.75,"), std::string::npos);
+}
+
+
+TEST(BlockMetricsTest, LatencyHistograms)
+{
+    Latency_Histogram latency;
+    latency.stage = "pvt";
+    latency.counts.assign(Latency_Tracer::bucket_bounds_ms().size() + 1, 0);
+    latency.counts[1] = 2;  // 1 to 2 ms
+    latency.counts.back() = 1;
+    latency.count = 3;
+    latency.sum_ms = 20003.0;
+    latency.max_ms = 20000.0;
+    Block_Metrics metrics;
+    const std::string text = metrics.prometheus(make_samples(), {latency});
+    EXPECT_NE(text.find("# TYPE gnss_sdr_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_latency_seconds_bucket{stage=\"pvt\",le=\"0.001\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_latency_seconds_bucket{stage=\"pvt\",le=\"0.002\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_latency_seconds_bucket{stage=\"pvt\",le=\"10\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_latency_seconds_bucket{stage=\"pvt\",le=\"+Inf\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_latency_seconds_sum{stage=\"pvt\"} 20.003\n"), std::string::npos);
+    EXPECT_NE(text.find("gnss_sdr_latency_max_seconds{stage=\"pvt\"} 20\n"), std::string::npos);
+    EXPECT_EQ(metrics.prometheus(make_samples()).find("gnss_sdr_latency"), std::string::npos);
+
+    const std::string json = metrics.json(make_samples(), {latency});
+    EXPECT_NE(json.find("\"latency\":[{\"stage\":\"pvt\",\"count\":3,\"missed\":0,\"mean_ms\":6667.66667,\"max_ms\":20000,\"buckets\":[{\"le_ms\":1,\"count\":0},"), std::string::npos);
+    EXPECT_NE(json.find("{\"le_ms\":null,\"count\":1}]}]}"), std::string::npos);
+}
+
+
+TEST(BlockMetricsTest, ServesLocalHttp)
+{
+    int requests = 0;
+    Metrics_Server server(0, [&requests]() { requests++; return make_samples(); });
+    ASSERT_NE(server.port(), 0);
+
+    const std::string response = http_get(server.port(), "/metrics");
+    EXPECT_EQ(response.find("HTTP/1.0 200 OK\r\n"), 0U);
+    EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4\r\n"), std::string::npos);
+    EXPECT_NE(response.find("gnss_sdr_uptime_seconds "), std::string::npos);
+
+    EXPECT_NE(http_get(server.port(), "/metrics.json").find("Content-Type: application/json\r\n"), std::string::npos);
+    EXPECT_EQ(http_get(server.port(), "/other").find("HTTP/1.0 404 Not Found\r\n"), 0U);
+    EXPECT_EQ(requests, 2);
+}
+
+
+TEST(BlockMetricsTest, CounterOverhead)
+{
+    // The counters add a fixed cost to each call to work(), so its weight
+    // depends on how much work each call does. The best of a few runs is
+    // taken, to leave out the noise of other processes.
+    const int calls = 20000;
+    const int runs = 3;
+    double time_off_s = 0.0;
+    double time_on_s = 0.0;
+    Block_Sample sample;
+    for (int run = 0; run < runs; run++)
+        {
+            const double off_s = run_metrics_overhead_flowgraph(calls, false, sample);
+            const double on_s = run_metrics_overhead_flowgraph(calls, true, sample);
+            time_off_s = (run == 0) ? off_s : std::min(time_off_s, off_s);
+            time_on_s = (run == 0) ? on_s : std::min(time_on_s, on_s);
+        }
+    // the number of calls is derived from the mean work time
+    EXPECT_NEAR(sample.work_calls, calls, 0.01 * calls);
+    EXPECT_EQ(sample.items_in, static_cast<uint64_t>(calls) * Metrics_Overhead_Correlator::SAMPLES_PER_CALL);
+    EXPECT_GT(sample.work_s, 0.0);
+
+    std::cout << "Correlator: " << sample.work_s / sample.work_calls * 1e6 << " [us] of CPU per call to work()" << std::endl;
+    std::cout << "Performance counters: " << (time_on_s - time_off_s) / calls * 1e6 << " [us] per call to work(), "
+              << 100.0 * (time_on_s - time_off_s) / time_off_s << " % of the flow graph run time" << std::endl;
+}
@@ -0,0 +1,194 @@
+/*!
+ * \file control_event_queue_test.cc
+ * \brief Tests for Control_Event_Queue
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "control_event_queue.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+TEST(ControlEventQueueTest, BoundedFifo)
+{
+    Control_Event_Queue queue(3);
+    EXPECT_EQ(queue.capacity(), 4U);
+    for (int32_t n = 0; n < 4; n++)
+        {
+            EXPECT_TRUE(queue.push(n, 1));
+        }
+    EXPECT_FALSE(queue.push(4, 1));
+    EXPECT_EQ(queue.overflows(), 1U);
+    EXPECT_EQ(queue.size(), 4U);
+
+    std::array<Control_Event, 3> events{};
+    ASSERT_EQ(queue.pop(events.data(), events.size()), 3U);
+    EXPECT_EQ(events[0].channel_id, 0);
+    EXPECT_EQ(events[2].channel_id, 2);
+    EXPECT_TRUE(queue.push(5, 2));
+    ASSERT_EQ(queue.pop(events.data(), events.size()), 2U);
+    EXPECT_EQ(events[0].channel_id, 3);
+    EXPECT_EQ(events[1].channel_id, 5);
+    EXPECT_EQ(events[1].event_type, 2);
+    EXPECT_EQ(queue.pop(events.data(), events.size()), 0U);
+}
+
+
+TEST(ControlEventQueueTest, WakesUpWaitingConsumer)
+{
+    Control_Event_Queue queue;
+    int wakeups = 0;
+    queue.set_wakeup([&wakeups]() { wakeups++; });
+    EXPECT_TRUE(queue.push(0, 0));
+    EXPECT_EQ(wakeups, 0);
+    // there is an event to pop, so the consumer must not sleep
+    EXPECT_FALSE(queue.begin_wait());
+
+    std::array<Control_Event, 8> events{};
+    ASSERT_EQ(queue.pop(events.data(), events.size()), 1U);
+    queue.record_dispatch(events[0]);
+    ASSERT_TRUE(queue.begin_wait());
+    EXPECT_TRUE(queue.push(1, 0));
+    EXPECT_TRUE(queue.push(2, 0));
+    EXPECT_EQ(wakeups, 1);  // only the first push after begin_wait()
+    queue.end_wait();
+    EXPECT_NE(queue.report().find("Push to dispatch latency: count 1"), std::string::npos);
+}
+
+
+TEST(ControlEventQueueTest, ManyProducers)
+{
+    const int32_t producers = 4;
+    const int32_t events_per_producer = 20000;
+    Control_Event_Queue queue(256);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (int32_t producer = 0; producer < producers; producer++)
+        {
+            threads.emplace_back([&queue, &go, producer]() {
+                while (!go)
+                    {
+                    }
+                for (int32_t n = 0; n < events_per_producer; n++)
+                    {
+                        while (!queue.push(producer, n))
+                            {
+                                std::this_thread::yield();
+                            }
+                    }
+            });
+        }
+    go = true;
+
+    // the events of each producer arrive in order
+    std::vector<int32_t> next_event(producers, 0);
+    std::array<Control_Event, 64> events{};
+    int32_t received = 0;
+    while (received < producers * events_per_producer)
+        {
+            const size_t count = queue.pop(events.data(), events.size());
+            for (size_t n = 0; n < count; n++)
+                {
+                    ASSERT_EQ(events[n].event_type, next_event[events[n].channel_id]++);
+                }
+            received += static_cast<int32_t>(count);
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    EXPECT_EQ(queue.size(), 0U);
+}
+
+
+TEST(ControlEventQueueTest, FallbackKeepsChannelOrder)
+{
+    const int32_t producers = 4;
+    const int32_t events_per_producer = 20000;
+    Control_Event_Queue queue(8);
+    // stands for the command queue
+    std::mutex fallback_mutex;
+    std::deque<Control_Event> fallback;
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (int32_t producer = 0; producer < producers; producer++)
+        {
+            threads.emplace_back([&, producer]() {
+                while (!go)
+                    {
+                    }
+                for (int32_t n = 0; n < events_per_producer; n++)
+                    {
+                        if (!queue.push(producer, n))
+                            {
+                                const std::lock_guard<std::mutex> lock(fallback_mutex);
+                                fallback.push_back(Control_Event{producer, n, 0});
+                            }
+                    }
+            });
+        }
+    go = true;
+
+    // same as the control thread: the events pushed before a fallback
+    // event are dispatched before it
+    std::vector<int32_t> next_event(producers, 0);
+    std::array<Control_Event, 4> events{};
+    int32_t received = 0;
+    const auto dispatch = [&]() {
+        const size_t count = queue.pop(events.data(), events.size());
+        for (size_t n = 0; n < count; n++)
+            {
+                EXPECT_EQ(events[n].event_type, next_event[events[n].channel_id]++);
+            }
+        received += static_cast<int32_t>(count);
+        return count;
+    };
+    while (received < producers * events_per_producer)
+        {
+            dispatch();
+            Control_Event event{};
+            {
+                const std::lock_guard<std::mutex> lock(fallback_mutex);
+                if (fallback.empty())
+                    {
+                        continue;
+                    }
+                event = fallback.front();
+                fallback.pop_front();
+            }
+            const uint64_t pushed = queue.pushed();
+            while (queue.popped() < pushed)
+                {
+                    if (dispatch() == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                }
+            EXPECT_EQ(event.event_type, next_event[event.channel_id]++);
+            received++;
+        }
+    for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    EXPECT_GT(queue.overflows(), 0U);
+    EXPECT_EQ(next_event, std::vector<int32_t>(producers, events_per_producer));
+}
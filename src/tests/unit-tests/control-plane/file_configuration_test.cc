@@ -20,7 +20,9 @@
 
 
 #include "file_configuration.h"
+#include <algorithm>
 #include <string>
+#include <vector>
 
 
 TEST(FileConfigurationTest, OverridedProperties)
@@ -35,6 +37,13 @@ TEST(FileConfigurationTest, OverridedProperties)
     configuration->set_property("NotThere", "Yes!");
     value = configuration->property("NotThere", default_value);
     EXPECT_STREQ("Yes!", value.c_str());
+    // set_property() keeps the first value
+    configuration->set_property("NotThere", "No");
+    EXPECT_EQ("Yes!", configuration->property("NotThere", default_value));
+    configuration->supersede_property("NotThere", "No");
+    EXPECT_EQ("No", configuration->property("NotThere", default_value));
+    configuration->erase_property("NotThere");
+    EXPECT_EQ(default_value, configuration->property("NotThere", default_value));
 }
 
 
@@ -56,3 +65,23 @@ TEST(FileConfigurationTest, PropertyDoesNotExist)
     std::string value = configuration->property("whatever.whatever", default_value);
     EXPECT_STREQ("default_value", value.c_str());
 }
+
+
+TEST(FileConfigurationTest, UnreadProperties)
+{
+    std::string path = std::string(TEST_PATH);
+    std::string filename = path + "data/config_file_sample.txt";
+    FileConfiguration configuration(filename);
+    std::vector<std::string> unread = configuration.unread_properties();
+    EXPECT_NE(std::find(unread.begin(), unread.end(), "foo.param1"), unread.end());
+    EXPECT_NE(std::find(unread.begin(), unread.end(), "signalsource.item_size"), unread.end());
+
+    // lookups are case insensitive, as in the file
+    EXPECT_STREQ("value", configuration.property("foo.PARAM1", std::string("")).c_str());
+    EXPECT_EQ(4, configuration.property("SignalSource.item_size", 0));
+    const std::size_t remaining = unread.size() - 2;
+    unread = configuration.unread_properties();
+    EXPECT_EQ(unread.size(), remaining);
+    EXPECT_EQ(std::find(unread.begin(), unread.end(), "foo.param1"), unread.end());
+    EXPECT_EQ(std::find(unread.begin(), unread.end(), "signalsource.item_size"), unread.end());
+}
@@ -0,0 +1,74 @@
+/*!
+ * \file flowgraph_conf_test.cc
+ * \brief Tests for Flowgraph_Conf
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "flowgraph_conf.h"
+#include "in_memory_configuration.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+
+TEST(FlowgraphConfTest, ReadsChannelsOnce)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("Channels_1C.count", "2");
+    config->set_property("Channels_L5.count", "1");
+    config->set_property("Channels_SBAS.count", "3");
+    config->set_property("Channel1.satellite", "7");
+    config->set_property("Channel2.RF_channel_ID", "1");
+
+    Flowgraph_Conf conf;
+    conf.SetFromConfiguration(config.get());
+    EXPECT_EQ(conf.channels_count, 3U);
+    EXPECT_EQ(conf.channels_in_acquisition, 3U);
+    EXPECT_TRUE(conf.multiband);
+    EXPECT_TRUE(conf.assist_dual_frequency_acq);
+    EXPECT_EQ(conf.channel(0).satellite, 0U);
+    EXPECT_EQ(conf.channel(1).satellite, 7U);
+    EXPECT_EQ(conf.channel(2).rf_channel_id, 1);
+
+    // channels that do not exist get the defaults
+    EXPECT_EQ(conf.channel(100).satellite, 0U);
+    EXPECT_EQ(conf.channel(100).rf_channel_id, 0);
+
+    // the snapshot does not change until the configuration is read again
+    config->set_property("GNSS-SDR.assist_dual_frequency_acq", "false");
+    EXPECT_TRUE(conf.assist_dual_frequency_acq);
+    conf.SetFromConfiguration(config.get());
+    EXPECT_FALSE(conf.assist_dual_frequency_acq);
+}
+
+
+TEST(FlowgraphConfTest, SingleBand)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("Channels_1C.count", "8");
+    config->set_property("Channels_1B.count", "4");
+    config->set_property("Channels.in_acquisition", "2");
+    config->set_property("GNSS-SDR.search_backoff_s", "30");
+    config->set_property("GNSS-SDR.init_threads", "3");
+
+    Flowgraph_Conf conf;
+    conf.SetFromConfiguration(config.get());
+    EXPECT_EQ(conf.channels_count, 12U);
+    EXPECT_EQ(conf.channels_in_acquisition, 2U);
+    EXPECT_FALSE(conf.multiband);
+    EXPECT_FALSE(conf.assist_dual_frequency_acq);
+    EXPECT_DOUBLE_EQ(conf.search_backoff_s, 30.0);
+    EXPECT_DOUBLE_EQ(conf.search_backoff_max_s, 120.0);
+    EXPECT_EQ(conf.init_threads, 3U);
+}
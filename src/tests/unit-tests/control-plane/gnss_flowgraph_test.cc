@@ -22,6 +22,7 @@
 #include "acquisition_interface.h"
 #include "channel.h"
 #include "channel_interface.h"
+#include "command_event.h"
 #include "concurrent_queue.h"
 #include "file_configuration.h"
 #include "file_signal_source.h"
@@ -252,3 +253,79 @@ TEST(GNSSFlowgraph /*unused*/, InstantiateConnectStartStopHybrid /*unused*/)
     flowgraph->stop();
     EXPECT_FALSE(flowgraph->running());
 }
+
+
+TEST(GNSSFlowgraph /*unused*/, ReconfigureWhileRunning /*unused*/)
+{
+    std::shared_ptr<ConfigurationInterface> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("GNSS-SDR.internal_fs_sps", "4000000");
+    config->set_property("SignalSource.sampling_frequency", "4000000");
+    config->set_property("SignalSource.implementation", "File_Signal_Source");
+    config->set_property("SignalSource.item_type", "gr_complex");
+    config->set_property("SignalSource.repeat", "true");
+    std::string path = std::string(TEST_PATH);
+    std::string filename = path + "signal_samples/Galileo_E1_ID_1_Fs_4Msps_8ms.dat";
+    config->set_property("SignalSource.filename", filename);
+    config->set_property("SignalConditioner.implementation", "Pass_Through");
+    config->set_property("Channels_1C.count", "2");
+    config->set_property("Channels.in_acquisition", "1");
+    config->set_property("Channel.signal", "1C");
+    config->set_property("Acquisition_1C.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    config->set_property("Acquisition_1C.threshold", "1");
+    config->set_property("Acquisition_1C.doppler_max", "5000");
+    config->set_property("Tracking_1C.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    config->set_property("TelemetryDecoder_1C.implementation", "GPS_L1_CA_Telemetry_Decoder");
+    config->set_property("Observables.implementation", "Hybrid_Observables");
+    config->set_property("PVT.implementation", "RTKLIB_PVT");
+
+    auto queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+    std::shared_ptr<GNSSFlowgraph> flowgraph = std::make_shared<GNSSFlowgraph>(config, queue);
+    EXPECT_NO_THROW(flowgraph->connect());
+    EXPECT_NO_THROW(flowgraph->start());
+
+    // the channel gets its own acquisition parameters, the other one keeps running
+    EXPECT_NO_THROW(flowgraph->reconfigure_channel(1, {{"Acquisition_1C1.implementation", "GPS_L1_CA_PCPS_Acquisition"}, {"Acquisition_1C1.doppler_max", "3000"}}));
+    EXPECT_EQ(config->property("Acquisition_1C1.doppler_max", 0), 3000);
+    // the new channel is started by a command queued after the events of
+    // the old one, which are ignored meanwhile
+    EXPECT_EQ(flowgraph->channels_state()[1], 3U);
+    bool start_queued = false;
+    pmt::pmt_t msg;
+    while (queue->try_pop(msg))
+        {
+            if (pmt::any_ref(msg).type() == typeid(command_event_sptr))
+                {
+                    const command_event_sptr command = boost::any_cast<command_event_sptr>(pmt::any_ref(msg));
+                    start_queued = command->command_id == 401 and command->event_type == 21;
+                }
+        }
+    EXPECT_TRUE(start_queued);
+    flowgraph->apply_action(1, 0);
+    EXPECT_EQ(flowgraph->channels_state()[1], 3U);
+    flowgraph->apply_action(401, 21);
+    EXPECT_NE(flowgraph->channels_state()[1], 3U);
+    EXPECT_NO_THROW(flowgraph->reconfigure_conditioner(0, {}));
+    EXPECT_TRUE(flowgraph->running());
+
+    // an unknown implementation keeps the old channel
+    EXPECT_THROW(flowgraph->reconfigure_channel(0, {{"Tracking_1C0.implementation", "Wrong_Tracking"}}), std::runtime_error);
+    EXPECT_EQ(config->property("Tracking_1C0.implementation", std::string("")), "");
+    EXPECT_NO_THROW(flowgraph->reconfigure_channel(0, {}));
+    EXPECT_THROW(flowgraph->reconfigure_channel(2, {}), std::out_of_range);
+    // the satellite and the connections are set at startup
+    EXPECT_THROW(flowgraph->reconfigure_channel(0, {{"Channel0.satellite", "5"}}), std::invalid_argument);
+    EXPECT_THROW(flowgraph->reconfigure_conditioner(0, {{"Channel1.RF_channel_ID", "1"}}), std::invalid_argument);
+    EXPECT_EQ(config->property("Channel0.satellite", 0), 0);
+
+    // stopped channels stay stopped until they are started again
+    flowgraph->apply_action(400, 20);
+    EXPECT_EQ(flowgraph->channels_state()[0], 3U);
+    flowgraph->apply_action(0, 0);
+    flowgraph->apply_action(0, 2);
+    EXPECT_EQ(flowgraph->channels_state()[0], 3U);
+    flowgraph->apply_action(400, 21);
+    EXPECT_NE(flowgraph->channels_state()[0], 3U);
+    EXPECT_TRUE(flowgraph->running());
+    flowgraph->stop();
+    EXPECT_FALSE(flowgraph->running());
+}
@@ -0,0 +1,177 @@
+/*!
+ * \file gnss_synchro_udp_sink_test.cc
+ * \brief Tests for Gnss_Synchro_Udp_Sink and Monitor_Udp_Transport
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_synchro_udp_sink.h"
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/asio.hpp>
+#include <boost/serialization/vector.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+std::vector<Gnss_Synchro> make_epoch(uint32_t channels)
+{
+    std::vector<Gnss_Synchro> epoch(channels);
+    for (uint32_t ch = 0; ch < channels; ch++)
+        {
+            epoch[ch].System = 'G';
+            epoch[ch].Signal[0] = '1';
+            epoch[ch].Signal[1] = 'C';
+            epoch[ch].Signal[2] = '\0';
+            epoch[ch].PRN = ch + 1;
+            epoch[ch].Channel_ID = ch;
+            epoch[ch].CN0_dB_hz = 40.0 + ch;
+            epoch[ch].Carrier_Doppler_hz = 1000.0 + ch;
+            epoch[ch].Tracking_sample_counter = 123456789ULL;
+            epoch[ch].Pseudorange_m = 2.2e7 + ch;
+            epoch[ch].RX_time = 345600.0;
+        }
+    return epoch;
+}
+
+
+// Reads datagrams until the socket has been idle for a while
+std::vector<std::string> receive_all(boost::asio::ip::udp::socket& socket)
+{
+    std::vector<std::string> datagrams;
+    std::array<char, 65536> buffer{};
+    while (true)
+        {
+            boost::system::error_code error;
+            if (socket.available(error) == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    if (socket.available(error) == 0)
+                        {
+                            return datagrams;
+                        }
+                }
+            const std::size_t length = socket.receive(boost::asio::buffer(buffer), 0, error);
+            datagrams.emplace_back(buffer.data(), length);
+        }
+}
+}  // namespace
+
+
+TEST(GnssSynchroUdpSinkTest, PacksEpochInProtobufDatagrams)
+{
+    b_io_context io_context;
+    boost::asio::ip::udp::socket receiver(io_context, boost::asio::ip::udp::endpoint(boost::asio::ip::address::from_string("127.0.0.1"), 0));
+    const uint16_t port = receiver.local_endpoint().port();
+
+    const uint32_t channels = 64;
+    const std::vector<Gnss_Synchro> epoch = make_epoch(channels);
+    Gnss_Synchro_Udp_Sink sink({"127.0.0.1"}, port, true);
+    EXPECT_TRUE(sink.write_gnss_synchro(epoch.data(), epoch.size()));
+    sink.flush();
+
+    const std::vector<std::string> datagrams = receive_all(receiver);
+    ASSERT_GT(datagrams.size(), 1U);
+    EXPECT_LT(datagrams.size(), channels);
+    uint32_t received = 0;
+    Serdes_Gnss_Synchro serdes;
+    for (const auto& datagram : datagrams)
+        {
+            EXPECT_LE(datagram.size(), MONITOR_MAX_DATAGRAM_SIZE);
+            gnss_sdr::Observables observables;
+            ASSERT_TRUE(observables.ParseFromString(datagram));
+            for (const auto& gs : serdes.readProtobuffer(observables))
+                {
+                    EXPECT_EQ(gs.Channel_ID, received);
+                    EXPECT_EQ(gs.PRN, received + 1);
+                    EXPECT_DOUBLE_EQ(gs.CN0_dB_hz, 40.0 + received);
+                    received++;
+                }
+        }
+    EXPECT_EQ(received, channels);
+    EXPECT_EQ(sink.transport().get_dropped(), 0U);
+    // one endpoint: the whole epoch goes out in a single system call
+    EXPECT_LE(sink.transport().get_syscalls(), datagrams.size());
+}
+
+
+TEST(GnssSynchroUdpSinkTest, PacksEpochInArchiveDatagrams)
+{
+    b_io_context io_context;
+    boost::asio::ip::udp::socket receiver(io_context, boost::asio::ip::udp::endpoint(boost::asio::ip::address::from_string("127.0.0.1"), 0));
+    const uint16_t port = receiver.local_endpoint().port();
+
+    const uint32_t channels = 64;
+    const std::vector<Gnss_Synchro> epoch = make_epoch(channels);
+    Gnss_Synchro_Udp_Sink sink({"127.0.0.1"}, port, false);
+    for (int n = 0; n < 3; n++)
+        {
+            EXPECT_TRUE(sink.write_gnss_synchro(epoch));
+        }
+    sink.flush();
+
+    uint32_t received = 0;
+    for (const auto& datagram : receive_all(receiver))
+        {
+            EXPECT_LE(datagram.size(), MONITOR_MAX_DATAGRAM_SIZE);
+            std::istringstream archive_stream(datagram);
+            boost::archive::binary_iarchive ia{archive_stream};
+            std::vector<Gnss_Synchro> stocks;
+            ia >> stocks;
+            for (const auto& gs : stocks)
+                {
+                    EXPECT_EQ(gs.Channel_ID, received % channels);
+                    received++;
+                }
+        }
+    EXPECT_EQ(received, 3 * channels);
+}
+
+
+TEST(GnssSynchroUdpSinkTest, TransportDropsWhenFull)
+{
+    Monitor_Udp_Transport transport({"127.0.0.1"}, 9, 64, 4);
+    const std::array<uint8_t, 64> datagram{};
+    uint32_t accepted = 0;
+    for (int n = 0; n < 1000; n++)
+        {
+            accepted += transport.send(datagram.data(), datagram.size()) ? 1 : 0;
+        }
+    EXPECT_FALSE(transport.send(datagram.data(), 65));
+    transport.flush();
+    EXPECT_EQ(transport.get_published(), accepted);
+    EXPECT_EQ(transport.get_sent(), accepted);
+    EXPECT_EQ(transport.get_dropped(), 1001U - accepted);
+}
+
+
+TEST(GnssSynchroUdpSinkTest, TransportCountsDatagramsTooLarge)
+{
+    Monitor_Udp_Transport transport({"127.0.0.1"}, 9, 64, 4);
+    uint8_t* buffer = transport.claim();
+    ASSERT_TRUE(buffer != nullptr);
+    // the archive did not fit in the claimed buffer
+    transport.drop();
+    EXPECT_EQ(buffer, transport.claim());
+    transport.publish(1);
+    transport.flush();
+    EXPECT_EQ(transport.get_published(), 1U);
+    EXPECT_EQ(transport.get_dropped(), 1U);
+}
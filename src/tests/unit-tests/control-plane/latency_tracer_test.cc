@@ -0,0 +1,104 @@
+/*!
+ * \file latency_tracer_test.cc
+ * \brief Tests for the Latency_Tracer class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "latency_tracer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+TEST(LatencyTracerTest, MeasuresEachStage)
+{
+    Latency_Tracer& tracer = Latency_Tracer::instance();
+    tracer.reset();
+    tracer.set_source(4000, 1);
+    EXPECT_TRUE(tracer.histograms().empty());  // disabled
+    tracer.set_enabled(true);
+
+    tracer.mark_source(4000);
+    tracer.mark_source(8000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    tracer.record(Latency_Tracer::Tracking, 7000, 3);  // left the source with the second block
+    tracer.record(Latency_Tracer::Observables, 8000);
+    tracer.record(Latency_Tracer::Pvt, 12000);  // not there yet
+
+    // the history has room for a limited number of blocks
+    tracer.mark_source(4000 * 8193);
+    tracer.record(Latency_Tracer::Tracking, 4000, 3);
+
+    const std::vector<Latency_Histogram> histograms = tracer.histograms();
+    ASSERT_EQ(histograms.size(), 3U);
+    EXPECT_EQ(histograms[0].stage, "tracking");
+    EXPECT_EQ(histograms[0].count, 1U);
+    EXPECT_EQ(histograms[0].missed, 1U);
+    EXPECT_GE(histograms[0].max_ms, 3.0);
+    EXPECT_DOUBLE_EQ(histograms[0].sum_ms, histograms[0].max_ms);
+    ASSERT_EQ(histograms[0].counts.size(), Latency_Tracer::bucket_bounds_ms().size() + 1);
+    EXPECT_EQ(histograms[0].counts[0], 0U);  // under 1 ms
+    EXPECT_EQ(histograms[1].stage, "observables");
+    EXPECT_EQ(histograms[1].count, 1U);
+    EXPECT_EQ(histograms[2].stage, "pvt");
+    EXPECT_EQ(histograms[2].count, 0U);
+    EXPECT_EQ(histograms[2].missed, 1U);
+
+    tracer.set_enabled(false);
+    tracer.reset();
+}
+
+
+TEST(LatencyTracerTest, WritesChromeTrace)
+{
+    const std::string file_name = "./latency_tracer_test.json";
+    Latency_Tracer& tracer = Latency_Tracer::instance();
+    tracer.reset();
+    tracer.set_source(4000, 1);
+    tracer.set_enabled(true);
+    ASSERT_TRUE(tracer.open_trace(file_name, 2));  // one block out of two
+
+    for (uint64_t sample_counter = 4000; sample_counter <= 12000; sample_counter += 4000)
+        {
+            tracer.mark_source(sample_counter);
+            tracer.record(Latency_Tracer::Tracking, sample_counter - 1000, 0);
+            tracer.record(Latency_Tracer::Tracking, sample_counter, 0);  // same block
+            tracer.record(Latency_Tracer::Observables, sample_counter);
+        }
+    tracer.close_trace();
+    tracer.set_enabled(false);
+    tracer.reset();
+
+    std::ifstream file(file_name);
+    const std::string trace((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(file_name.c_str());
+
+    EXPECT_EQ(trace.find("[\n"), 0U);
+    EXPECT_EQ(trace.rfind("\n]\n"), trace.size() - 3);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"Channel 0 tracking\"}"), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"observables\"}"), std::string::npos);
+    // only the second block is traced, once per stage
+    EXPECT_NE(trace.find("\"args\":{\"sample_counter\":7000,\"channel\":0}"), std::string::npos);
+    EXPECT_EQ(trace.find("\"args\":{\"sample_counter\":8000,\"channel\":0}"), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"sample_counter\":8000,\"channel\":-1}"), std::string::npos);
+    EXPECT_EQ(trace.find("\"sample_counter\":4000"), std::string::npos);
+    EXPECT_EQ(trace.find("\"sample_counter\":12000"), std::string::npos);
+}
@@ -0,0 +1,243 @@
+/*!
+ * \file load_governor_test.cc
+ * \brief Tests for the Load_Governor class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "load_governor.h"
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/sync_block.h>
+#include <gnuradio/top_block.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#include <memory>
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+
+namespace
+{
+// records the steps, with a monitor and no correlators to reduce
+class Fake_Receiver
+{
+public:
+    bool execute(Load_Governor::Level step, bool shed)
+    {
+        steps.emplace_back(step, shed);
+        switch (step)
+            {
+            case Load_Governor::Correlators_Reduced:
+                return false;
+            case Load_Governor::Channels_Released:
+                if (shed)
+                    {
+                        if (releasable == 0)
+                            {
+                                return false;
+                            }
+                        releasable--;
+                        released++;
+                        return true;
+                    }
+                if (released == 0)
+                    {
+                        return false;
+                    }
+                released--;
+                releasable++;
+                return true;
+            default:
+                return true;
+            }
+    }
+
+    std::vector<std::pair<Load_Governor::Level, bool>> steps;
+    int releasable = 2;
+    int released = 0;
+};
+
+
+std::vector<std::string> actions(const Load_Governor& governor)
+{
+    std::vector<std::string> result;
+    for (const auto& event : governor.events())
+        {
+            result.push_back((event.shed ? "shed " : "restore ") + std::to_string(event.level));
+        }
+    return result;
+}
+
+
+// consumes at most 1000 samples per call, sleeping between calls
+class Slow_Sink;
+
+#if GNURADIO_USES_STD_POINTERS
+using Slow_Sink_sptr = std::shared_ptr<Slow_Sink>;
+#else
+using Slow_Sink_sptr = boost::shared_ptr<Slow_Sink>;
+#endif
+
+class Slow_Sink : public gr::sync_block
+{
+public:
+    Slow_Sink() : gr::sync_block("Slow_Sink",
+                      gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                      gr::io_signature::make(0, 0, 0))
+    {
+        set_max_noutput_items(1000);
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star& input_items __attribute__((unused)),
+        gr_vector_void_star& output_items __attribute__((unused))) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms.load()));
+        return noutput_items;
+    }
+
+    std::atomic<int> delay_ms{10};
+};
+
+
+Load_Sample measure(const Slow_Sink_sptr& sink, double fs)
+{
+    Load_Sample sample;
+    sample.time_s = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    sample.sample_time_s = static_cast<double>(sink->nitems_read(0)) / fs;
+    sample.buffer_occupancy = Load_Governor::buffer_occupancy(sink);
+    return sample;
+}
+}  // namespace
+
+
+TEST(LoadGovernorTest, ShedsInOrderAndRestores)
+{
+    Load_Governor_Conf conf;
+    conf.hold_s = 3.0;
+    conf.recover_s = 10.0;
+    Fake_Receiver receiver;
+    Load_Governor governor(conf, [&receiver](Load_Governor::Level step, bool shed) { return receiver.execute(step, shed); });
+
+    // one measurement per second
+    Load_Sample sample;
+    const auto feed = [&governor, &sample](int seconds, double ratio, double occupancy) {
+        for (int n = 0; n < seconds; n++)
+            {
+                sample.time_s += 1.0;
+                sample.sample_time_s += ratio;
+                sample.buffer_occupancy = occupancy;
+                governor.update(sample);
+            }
+    };
+    // keeping the pace with empty buffers
+    feed(10, 1.0, 0.1);
+    EXPECT_EQ(governor.level(), Load_Governor::Normal);
+    EXPECT_DOUBLE_EQ(governor.real_time_ratio(), 1.0);
+    // a file read faster than real time always fills the buffers
+    feed(10, 3.0, 1.0);
+    EXPECT_TRUE(governor.events().empty());
+
+    // keeping the pace, but the buffers fill up: a step each 3 s, and the
+    // correlators step is skipped
+    feed(3, 1.0, 0.9);
+    EXPECT_EQ(governor.level(), Load_Governor::Normal);
+    feed(1, 1.0, 0.9);
+    EXPECT_EQ(governor.level(), Load_Governor::Acquisition_Suspended);
+    feed(3, 0.8, 0.9);
+    EXPECT_EQ(governor.level(), Load_Governor::Monitor_Decimated);
+    feed(9, 0.8, 0.9);
+    EXPECT_EQ(governor.level(), Load_Governor::Channels_Released);
+    EXPECT_EQ(receiver.released, 2);  // and then no more to release
+    EXPECT_EQ(actions(governor), std::vector<std::string>({"shed 1", "shed 3", "shed 4", "shed 4"}));
+
+    // neither overloaded nor relaxed
+    feed(20, 1.0, 0.5);
+    EXPECT_EQ(governor.events().size(), 4U);
+
+    // spare capacity: the channels come back one at a time, and then the
+    // other steps are undone in reverse order
+    feed(10, 1.0, 0.1);
+    EXPECT_EQ(governor.events().size(), 4U);
+    feed(1, 1.0, 0.1);
+    EXPECT_EQ(receiver.released, 1);
+    feed(30, 1.0, 0.1);
+    EXPECT_EQ(governor.level(), Load_Governor::Normal);
+    EXPECT_EQ(receiver.released, 0);
+    EXPECT_EQ(actions(governor), std::vector<std::string>({"shed 1", "shed 3", "shed 4", "shed 4",
+                                     "restore 4", "restore 4", "restore 2", "restore 0"}));
+    EXPECT_EQ(receiver.steps.back(), std::make_pair(Load_Governor::Acquisition_Suspended, false));
+}
+
+
+TEST(LoadGovernorTest, FileSourceAndSlowSink)
+{
+    const std::string file_name = "./load_governor_test.dat";
+    {
+        const std::vector<gr_complex> zeros(4000);
+        std::ofstream file(file_name, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(zeros.data()), zeros.size() * sizeof(gr_complex));
+    }
+    // about 100000 samples per second, one tenth of real time
+    const double fs = 1e6;
+    auto top_block = gr::make_top_block("LoadGovernorTest");
+    auto source = gr::blocks::file_source::make(sizeof(gr_complex), file_name.c_str(), true);
+    const Slow_Sink_sptr sink = Slow_Sink_sptr(new Slow_Sink());
+    top_block->connect(source, 0, sink, 0);
+
+    Load_Governor_Conf conf;
+    conf.hold_s = 0.2;
+    conf.recover_s = 0.3;
+    Fake_Receiver receiver;
+    Load_Governor governor(conf, [&receiver](Load_Governor::Level step, bool shed) { return receiver.execute(step, shed); });
+
+    top_block->start();
+    const auto run = [&](const std::function<bool()>& done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!done() and std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                governor.update(measure(sink, fs));
+            }
+    };
+    run([&governor]() { return governor.events().size() == 4; });
+    const double overloaded_ratio = governor.real_time_ratio();
+    const double overloaded_occupancy = Load_Governor::buffer_occupancy(sink);
+    // the sink catches up, the file is read faster than real time
+    sink->delay_ms = 0;
+    run([&governor]() { return governor.level() == Load_Governor::Normal; });
+    top_block->stop();
+    top_block->wait();
+    std::remove(file_name.c_str());
+
+    EXPECT_LT(overloaded_ratio, conf.min_real_time_ratio);
+    EXPECT_GT(overloaded_occupancy, conf.high_occupancy);
+    ASSERT_EQ(governor.events().size(), 8U);
+    EXPECT_EQ(actions(governor), std::vector<std::string>({"shed 1", "shed 3", "shed 4", "shed 4",
+                                     "restore 4", "restore 4", "restore 2", "restore 0"}));
+    EXPECT_LT(governor.events()[0].real_time_ratio, conf.min_real_time_ratio);
+    EXPECT_GT(governor.events()[7].real_time_ratio, conf.max_real_time_ratio);
+    EXPECT_EQ(Load_Governor::buffer_occupancy(source), 0.0);  // no inputs
+}
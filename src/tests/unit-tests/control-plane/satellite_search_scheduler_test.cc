@@ -0,0 +1,184 @@
+/*!
+ * \file satellite_search_scheduler_test.cc
+ * \brief Tests for Satellite_Search_Scheduler
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "satellite_search_scheduler.h"
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+Gnss_Signal gps_1c(uint32_t prn)
+{
+    return Gnss_Signal(Gnss_Satellite(std::string("GPS"), prn), std::string("1C"));
+}
+
+
+std::vector<uint32_t> search_order(Satellite_Search_Scheduler& scheduler, const std::string& band)
+{
+    std::vector<uint32_t> prns;
+    Gnss_Signal signal;
+    while (scheduler.next(band, true, signal))
+        {
+            prns.push_back(signal.get_satellite().get_PRN());
+        }
+    return prns;
+}
+}  // namespace
+
+
+TEST(SatelliteSearchSchedulerTest, FifoWithoutPredictions)
+{
+    Satellite_Search_Scheduler scheduler;
+    for (uint32_t prn = 1; prn <= 4; prn++)
+        {
+            scheduler.push_back(gps_1c(prn));
+        }
+    Gnss_Signal signal;
+    // peeking moves the signal to the back of the queue
+    ASSERT_TRUE(scheduler.next("1C", false, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 1U);
+    scheduler.remove(gps_1c(3));
+    EXPECT_EQ(scheduler.size("1C"), 3U);
+    EXPECT_EQ(search_order(scheduler, "1C"), std::vector<uint32_t>({2, 4, 1}));
+    EXPECT_FALSE(scheduler.next("1C", true, signal));
+    EXPECT_FALSE(scheduler.next("5X", true, signal));
+}
+
+
+TEST(SatelliteSearchSchedulerTest, VisibleSatellitesFirst)
+{
+    Satellite_Search_Scheduler scheduler;
+    for (uint32_t prn = 1; prn <= 6; prn++)
+        {
+            scheduler.push_back(gps_1c(prn));
+        }
+    scheduler.push_back(Gnss_Signal(Gnss_Satellite(std::string("Galileo"), 11), std::string("1C")));
+    const std::vector<std::pair<int, Gnss_Satellite>> predicted = {
+        {15, Gnss_Satellite(std::string("GPS"), 5)},
+        {70, Gnss_Satellite(std::string("GPS"), 3)},
+        {-40, Gnss_Satellite(std::string("GPS"), 4)},
+        {-5, Gnss_Satellite(std::string("GPS"), 6)}};
+    scheduler.set_visibility(predicted);
+    // then the satellites without navigation data, in any constellation, and
+    // the ones below the horizon
+    EXPECT_EQ(search_order(scheduler, "1C"), std::vector<uint32_t>({3, 5, 1, 2, 11, 6, 4}));
+}
+
+
+TEST(SatelliteSearchSchedulerTest, FailedSatellitesBackOff)
+{
+    double now = 1000.0;
+    Satellite_Search_Scheduler scheduler([&now]() { return now; });
+    scheduler.set_retry_backoff(10.0, 15.0);
+    const std::vector<std::pair<int, Gnss_Satellite>> visible = {
+        {80, Gnss_Satellite(std::string("GPS"), 1)},
+        {20, Gnss_Satellite(std::string("GPS"), 2)}};
+    scheduler.set_visibility(visible);
+    scheduler.push_back(gps_1c(1));
+    scheduler.push_back(gps_1c(2));
+
+    Gnss_Signal signal;
+    ASSERT_TRUE(scheduler.next("1C", true, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 1U);
+    scheduler.push_back(signal, true);
+    ASSERT_TRUE(scheduler.next("1C", false, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 2U);
+    EXPECT_NE(scheduler.report().find("retry in 10 s"), std::string::npos);
+
+    // the backoff doubles with each failure, up to the maximum
+    now += 10.0;
+    ASSERT_TRUE(scheduler.next("1C", true, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 1U);
+    scheduler.push_back(signal, true);
+    now += 14.0;
+    ASSERT_TRUE(scheduler.next("1C", false, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 2U);
+    now += 1.0;
+    ASSERT_TRUE(scheduler.next("1C", false, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 1U);
+
+    // a successful acquisition forgets the failures
+    scheduler.remove(gps_1c(1));
+    scheduler.push_back(gps_1c(1), true);
+    now += 9.0;
+    ASSERT_TRUE(scheduler.next("1C", false, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 2U);
+}
+
+
+TEST(SatelliteSearchSchedulerTest, CrossBandHintsGoFirst)
+{
+    Satellite_Search_Scheduler scheduler;
+    for (uint32_t prn = 1; prn <= 4; prn++)
+        {
+            scheduler.push_back(Gnss_Signal(Gnss_Satellite(std::string("GPS"), prn), std::string("L5")));
+        }
+    const std::vector<std::pair<int, Gnss_Satellite>> visible = {{60, Gnss_Satellite(std::string("GPS"), 2)}};
+    scheduler.set_visibility(visible);
+    Gnss_Signal signal;
+    ASSERT_TRUE(scheduler.next("L5", true, signal, std::set<uint32_t>({4})));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 4U);
+    ASSERT_TRUE(scheduler.next("L5", true, signal));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 2U);
+}
+
+
+TEST(SatelliteSearchSchedulerTest, HighPriorityOnly)
+{
+    Satellite_Search_Scheduler scheduler;
+    for (uint32_t prn = 1; prn <= 4; prn++)
+        {
+            scheduler.push_back(gps_1c(prn));
+        }
+    const std::vector<std::pair<int, Gnss_Satellite>> visible = {{40, Gnss_Satellite(std::string("GPS"), 3)}};
+    scheduler.set_visibility(visible);
+    scheduler.set_high_priority_only(true);
+    Gnss_Signal signal;
+    ASSERT_TRUE(scheduler.next("1C", true, signal, std::set<uint32_t>({1})));
+    EXPECT_EQ(signal.get_satellite().get_PRN(), 1U);
+    EXPECT_EQ(search_order(scheduler, "1C"), std::vector<uint32_t>({3}));
+    EXPECT_EQ(scheduler.size("1C"), 2U);  // the others wait
+    scheduler.set_high_priority_only(false);
+    EXPECT_EQ(search_order(scheduler, "1C"), std::vector<uint32_t>({2, 4}));
+}
+
+
+TEST(SatelliteSearchSchedulerTest, HighPriorityOnlyColdStart)
+{
+    // no predictions yet: nothing is filtered
+    Satellite_Search_Scheduler scheduler;
+    for (uint32_t prn = 1; prn <= 3; prn++)
+        {
+            scheduler.push_back(gps_1c(prn));
+        }
+    scheduler.set_high_priority_only(true);
+    EXPECT_EQ(search_order(scheduler, "1C"), std::vector<uint32_t>({1, 2, 3}));
+
+    // predictions of another constellation do not filter GPS
+    for (uint32_t prn = 1; prn <= 3; prn++)
+        {
+            scheduler.push_back(gps_1c(prn));
+        }
+    const std::vector<std::pair<int, Gnss_Satellite>> visible = {{40, Gnss_Satellite(std::string("Galileo"), 3)}};
+    scheduler.set_visibility(visible);
+    EXPECT_EQ(search_order(scheduler, "1C"), std::vector<uint32_t>({1, 2, 3}));
+}
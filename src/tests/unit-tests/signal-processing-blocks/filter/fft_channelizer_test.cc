@@ -0,0 +1,176 @@
+/*!
+ * \file fft_channelizer_test.cc
+ * \brief Implements unit tests for the single-pass sub-band channelizer
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <gnuradio/analog/sig_source_waveform.h>
+#include <gnuradio/top_block.h>
+#include <chrono>
+#ifdef GR_GREATER_38
+#include <gnuradio/analog/sig_source.h>
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#else
+#include <gnuradio/analog/sig_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#endif
+#include "channelizer_conditioner.h"
+#include "concurrent_queue.h"
+#include "fft_channelizer_cc.h"
+#include "gnss_sdr_valve.h"
+#include "in_memory_configuration.h"
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/filter/freq_xlating_fir_filter_ccf.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+
+TEST(FftChannelizerTest, OneTonePerSubband)
+{
+    const double two_pi = 6.283185307179586;
+    const double fs_in = 8000000.0;
+    const uint32_t decimation = 4;
+    // the second center is not a multiple of the bin width
+    const std::vector<Channelizer_Subband> subbands = {{1500000.0, 1600000.0}, {-2300000.0, 1200000.0}, {0.0, 1800000.0}};
+    const std::vector<double> tones = {1623000.0, -2600000.0, 511000.0};
+    const int nsamples = 200000;
+    std::vector<gr_complex> signal(nsamples);
+    for (int i = 0; i < nsamples; i++)
+        {
+            for (double f : tones)
+                {
+                    signal[i] += gr_complex(std::polar(1.0, two_pi * f * i / fs_in));
+                }
+        }
+
+    gr::top_block_sptr top_block = gr::make_top_block("fft_channelizer_test");
+    auto source = gr::blocks::vector_source_c::make(signal);
+    auto channelizer = make_fft_channelizer_cc(fs_in, decimation, subbands, "gr_complex");
+    top_block->connect(source, 0, channelizer, 0);
+    std::vector<gr::blocks::vector_sink_c::sptr> sinks;
+    for (size_t s = 0; s < subbands.size(); s++)
+        {
+            sinks.push_back(gr::blocks::vector_sink_c::make());
+            top_block->connect(channelizer, s, sinks.back(), 0);
+        }
+    top_block->run();
+
+    // Each output is its tone mixed down by the sub-band center, without the
+    // other two, delayed by the filter
+    const double delay = channelizer->latency();
+    for (size_t s = 0; s < subbands.size(); s++)
+        {
+            std::vector<gr_complex> out = sinks[s]->data();
+            ASSERT_GT(out.size(), static_cast<size_t>(nsamples / decimation / 2));
+            const double offset = tones[s] - subbands[s].center_freq_hz;
+            double error = 0.0;
+            for (size_t m = channelizer->num_taps() / decimation + 1; m < out.size(); m++)
+                {
+                    const double phase = two_pi * offset * (static_cast<double>(m * decimation) - delay) / fs_in;
+                    error = std::max(error, static_cast<double>(std::abs(out[m] - gr_complex(std::polar(1.0, phase)))));
+                }
+            EXPECT_LT(error, 5e-3) << "sub-band " << s;
+        }
+}
+
+
+TEST(FftChannelizerTest, SignalsSelectThePort)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("GNSS-SDR.internal_fs_sps", "4000000");
+    config->set_property("SignalConditioner.sample_freq_in", "60000000");
+    config->set_property("SignalConditioner.subbands", "2");
+    config->set_property("SignalConditioner.subband0.freq", "14000000");
+    config->set_property("SignalConditioner.subband0.signals", "1C, 1B");
+    config->set_property("SignalConditioner.subband1.freq", "-13000000");
+    config->set_property("SignalConditioner.subband1.signals", "L5,5X");
+    ChannelizerConditioner conditioner(config.get(), "SignalConditioner", 1, 1);
+
+    EXPECT_STREQ("Channelizer_Conditioner", conditioner.implementation().c_str());
+    EXPECT_EQ(2U, conditioner.subbands());
+    EXPECT_EQ(0, conditioner.output_port("1C"));
+    EXPECT_EQ(0, conditioner.output_port("1B"));
+    EXPECT_EQ(1, conditioner.output_port("L5"));
+    EXPECT_EQ(1, conditioner.output_port("5X"));
+    EXPECT_EQ(-1, conditioner.output_port("2S"));
+    EXPECT_EQ(conditioner.get_left_block(), conditioner.get_right_block());
+    EXPECT_EQ(2, conditioner.get_right_block()->output_signature()->max_streams());
+}
+
+
+TEST(FftChannelizerTest, BenchmarkAgainstFreqXlatingFilters)
+{
+    const double fs_in = 60000000.0;
+    const double fs_out = 5000000.0;
+    const int nsamples = 60000000;  // one second of signal
+    const std::vector<double> centers = {14000000.0, -13000000.0};
+
+    for (int single_pass = 0; single_pass < 2; single_pass++)
+        {
+            std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+            gr::top_block_sptr top_block = gr::make_top_block("channelizer_benchmark");
+            auto source = gr::analog::sig_source_c::make(fs_in, gr::analog::GR_SIN_WAVE, 1000.0, 1.0, gr_complex(0.0));
+            auto valve = gnss_sdr_make_valve(sizeof(gr_complex), nsamples, queue);
+            top_block->connect(source, 0, valve, 0);
+
+            std::vector<gr::blocks::null_sink::sptr> sinks;
+            if (single_pass)
+                {
+                    std::vector<Channelizer_Subband> subbands;
+                    for (double center : centers)
+                        {
+                            subbands.push_back({center, 0.8 * fs_out});
+                        }
+                    auto channelizer = make_fft_channelizer_cc(fs_in, static_cast<uint32_t>(fs_in / fs_out), subbands, "gr_complex");
+                    top_block->connect(valve, 0, channelizer, 0);
+                    for (size_t s = 0; s < centers.size(); s++)
+                        {
+                            sinks.push_back(gr::blocks::null_sink::make(sizeof(gr_complex)));
+                            top_block->connect(channelizer, s, sinks.back(), 0);
+                        }
+                }
+            else
+                {
+                    // one Freq_Xlating_Fir_Filter per band, as with one SignalConditioner per band
+                    const std::vector<float> taps = gr::filter::firdes::low_pass(1.0, fs_in, 0.45 * fs_out, 0.1 * fs_out, gr::filter::firdes::win_type::WIN_HAMMING);
+                    for (double center : centers)
+                        {
+                            auto filter = gr::filter::freq_xlating_fir_filter_ccf::make(static_cast<int>(fs_in / fs_out), taps, center, fs_in);
+                            sinks.push_back(gr::blocks::null_sink::make(sizeof(gr_complex)));
+                            top_block->connect(valve, 0, filter, 0);
+                            top_block->connect(filter, 0, sinks.back(), 0);
+                        }
+                }
+
+            std::chrono::duration<double> elapsed_seconds(0);
+            EXPECT_NO_THROW({
+                auto start = std::chrono::system_clock::now();
+                top_block->run();  // Start threads and wait
+                auto end = std::chrono::system_clock::now();
+                elapsed_seconds = end - start;
+                top_block->stop();
+            });
+
+            std::cout << (single_pass ? "Channelizer" : "Freq_Xlating_Fir_Filter chains") << " extracted " << centers.size()
+                      << " sub-bands from " << nsamples << " samples in " << elapsed_seconds.count() * 1e6 << " microseconds ("
+                      << nsamples / elapsed_seconds.count() / 1e6 << " Msps)" << std::endl;
+        }
+}
@@ -0,0 +1,413 @@
+/*!
+ * \file interference_mitigation_test.cc
+ * \brief Implements unit tests and throughput benchmarks for the interference
+ * mitigation blocks
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <gnuradio/top_block.h>
+#include <chrono>
+#ifdef GR_GREATER_38
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#else
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#endif
+#include "multi_notch_cc.h"
+#include "notch_cc.h"
+#include "notch_lite_cc.h"
+#include "pulse_blanking_cc.h"
+#include <boost/math/distributions/chi_squared.hpp>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/fft/fft.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+const double TWO_PI_TEST = 6.283185307179586;
+
+// Unit power noise plus continuous wave interferers, present after the
+// first interference_start samples
+std::vector<gr_complex> jammed_signal(int nsamples, int interference_start, const std::vector<double> &freqs, const std::vector<double> &amplitudes)
+{
+    std::mt19937 gen(1234);
+    std::normal_distribution<float> noise(0.0, std::sqrt(0.5));
+    std::vector<gr_complex> signal(nsamples);
+    for (int n = 0; n < nsamples; n++)
+        {
+            signal[n] = gr_complex(noise(gen), noise(gen));
+            if (n >= interference_start)
+                {
+                    for (size_t i = 0; i < freqs.size(); i++)
+                        {
+                            signal[n] += gr_complex(std::polar(amplitudes[i], TWO_PI_TEST * freqs[i] * n + static_cast<double>(i)));
+                        }
+                }
+        }
+    return signal;
+}
+
+
+// Power of the tone at freq (cycles / sample) left in the last samples of x, in dB
+double tone_power_db(const std::vector<gr_complex> &x, double freq, size_t from)
+{
+    std::complex<double> acc(0.0, 0.0);
+    for (size_t n = from; n < x.size(); n++)
+        {
+            acc += std::complex<double>(x[n]) * std::polar(1.0, -TWO_PI_TEST * freq * static_cast<double>(n));
+        }
+    return 10.0 * std::log10(std::norm(acc / static_cast<double>(x.size() - from)));
+}
+
+
+// Noise, then a continuous wave interferer, and then strong pulses
+std::vector<gr_complex> mitigation_test_signal()
+{
+    std::vector<gr_complex> signal = jammed_signal(64000, 0, {}, {});
+    for (int n = 20000; n < 40000; n++)
+        {
+            signal[n] += std::polar(10.0F, static_cast<float>(TWO_PI_TEST * 0.1037 * n));
+        }
+    for (int n = 40000; n < 64000; n += 5000)
+        {
+            for (int k = n; k < n + 64; k++)
+                {
+                    signal[k] *= 20.0F;
+                }
+        }
+    return signal;
+}
+
+
+// Reference implementation of the three filters as they were before they
+// were vectorized: scalar, one segment at a time, with the input x and the
+// previous sample x_prev (the history of the block)
+class Reference_Mitigation
+{
+public:
+    Reference_Mitigation(float pfa, int32_t length, int32_t n_segments_est, int32_t n_segments_reset)
+        : length_(length), n_segments_est_(n_segments_est), n_segments_reset_(n_segments_reset), fft_(length, true)
+    {
+        boost::math::chi_squared_distribution<float> dist(2 * length);
+        thres_ = boost::math::quantile(boost::math::complement(dist, pfa));
+    }
+
+    std::vector<gr_complex> notch(const std::vector<gr_complex> &x, float p_c_factor)
+    {
+        return run(x, [&](const gr_complex *in, const gr_complex *in_prev, gr_complex *out, bool first) {
+            for (int32_t k = 0; k < length_; k++)
+                {
+                    const gr_complex z = std::exp(gr_complex(0, 1) * std::arg(in[k] * std::conj(in_prev[k])));
+                    out[k] = in[k] - z * in_prev[k] + p_c_factor * z * (first && k == 0 ? gr_complex(0, 0) : last_out_);
+                    last_out_ = out[k];
+                }
+        });
+    }
+
+    std::vector<gr_complex> notch_lite(const std::vector<gr_complex> &x, float p_c_factor, int32_t n_segments_coeff_reset)
+    {
+        int32_t n_segments_coeff = 0;
+        gr_complex z(0, 0);
+        return run(x, [&](const gr_complex *in, const gr_complex *in_prev, gr_complex *out, bool first) {
+            if (first)
+                {
+                    n_segments_coeff = 0;
+                }
+            if (n_segments_coeff == 0)
+                {
+                    const float angle1 = std::arg(in[1] * std::conj(in[0]));
+                    const float angle2 = std::arg(in[length_ - 1] * std::conj(in[length_ - 2]));
+                    z = std::exp(gr_complex(0, 1) * ((angle1 + angle2) / 2.0F));
+                }
+            for (int32_t k = 0; k < length_; k++)
+                {
+                    out[k] = in[k] - z * in_prev[k] + p_c_factor * z * (first && k == 0 ? gr_complex(0, 0) : last_out_);
+                    last_out_ = out[k];
+                }
+            n_segments_coeff = (n_segments_coeff + 1) % n_segments_coeff_reset;
+        });
+    }
+
+    std::vector<gr_complex> pulse_blanking(const std::vector<gr_complex> &x)
+    {
+        std::vector<gr_complex> y(x.size() - x.size() % length_);
+        bool last_filtered = false;
+        float noise_power = 0.0;
+        int32_t n_segments = 0;
+        detections = 0;
+        for (size_t i = 0; i < y.size(); i += length_)
+            {
+                float energy = 0.0;
+                for (int32_t k = 0; k < length_; k++)
+                    {
+                        energy += std::norm(x[i + k]);
+                    }
+                const bool estimating = (n_segments < n_segments_est_) && !last_filtered;
+                if (estimating)
+                    {
+                        noise_power = (static_cast<float>(n_segments) * noise_power + energy / static_cast<float>(2 * length_)) / static_cast<float>(n_segments + 1);
+                    }
+                if (!estimating && energy / noise_power > thres_)
+                    {
+                        std::fill_n(y.begin() + i, length_, gr_complex(0, 0));
+                        last_filtered = true;
+                        detections++;
+                    }
+                else
+                    {
+                        std::copy_n(x.begin() + i, length_, y.begin() + i);
+                        if (!estimating)
+                            {
+                                last_filtered = false;
+                                n_segments = n_segments > n_segments_reset_ ? 0 : n_segments;
+                            }
+                    }
+                n_segments++;
+            }
+        return y;
+    }
+
+    uint64_t detections = 0;
+
+private:
+    // the noise floor of the power spectrum, as volk_32f_s32f_calc_spectral_noise_floor_32f
+    float noise_power(const gr_complex *in)
+    {
+        std::copy_n(in, length_, fft_.get_inbuf());
+        fft_.execute();
+        std::vector<float> power(length_);
+        float mean = 0.0;
+        for (int32_t k = 0; k < length_; k++)
+            {
+                power[k] = 10.0F * std::log10(std::norm(fft_.get_outbuf()[k]) + 1e-20F);
+                mean += power[k];
+            }
+        const float exclusion = mean / static_cast<float>(length_) + 15.0F;
+        float floor_db = 0.0;
+        int32_t n = 0;
+        for (const float p : power)
+            {
+                if (p <= exclusion)
+                    {
+                        floor_db += p;
+                        n++;
+                    }
+            }
+        floor_db = n == 0 ? exclusion : floor_db / static_cast<float>(n);
+        return std::pow(10.0F, floor_db / 10.0F) / static_cast<float>(2 * length_);
+    }
+
+    template <typename Filter>
+    std::vector<gr_complex> run(const std::vector<gr_complex> &x, Filter filter)
+    {
+        std::vector<gr_complex> x_prev(x.size());
+        std::copy(x.begin(), x.end() - 1, x_prev.begin() + 1);
+        std::vector<gr_complex> y(x.size() - x.size() % length_);
+        bool filter_state = false;
+        float noise_pow_est = 0.0;
+        int32_t n_segments = 0;
+        detections = 0;
+        for (size_t i = 0; i < y.size(); i += length_)
+            {
+                if ((n_segments < n_segments_est_) && !filter_state)
+                    {
+                        noise_pow_est = (static_cast<float>(n_segments) * noise_pow_est + noise_power(&x[i])) / static_cast<float>(n_segments + 1);
+                        std::copy_n(x.begin() + i, length_, y.begin() + i);
+                    }
+                else
+                    {
+                        float energy = 0.0;
+                        for (int32_t k = 0; k < length_; k++)
+                            {
+                                energy += std::norm(x[i + k]);
+                            }
+                        if (energy / noise_pow_est > thres_)
+                            {
+                                filter(&x[i], &x_prev[i], &y[i], !filter_state);
+                                filter_state = true;
+                                detections++;
+                            }
+                        else
+                            {
+                                n_segments = n_segments > n_segments_reset_ ? 0 : n_segments;
+                                filter_state = false;
+                                std::copy_n(x.begin() + i, length_, y.begin() + i);
+                            }
+                    }
+                n_segments++;
+            }
+        return y;
+    }
+
+    int32_t length_;
+    int32_t n_segments_est_;
+    int32_t n_segments_reset_;
+    float thres_;
+    gr::fft::fft_complex fft_;
+    gr_complex last_out_{0, 0};
+};
+
+
+// Runs a filter block over the signal, and returns its output
+std::vector<gr_complex> filter_output(const gr::block_sptr &filter, const std::vector<gr_complex> &signal)
+{
+    gr::top_block_sptr top_block = gr::make_top_block("mitigation_regression_test");
+    auto source = gr::blocks::vector_source_c::make(signal);
+    auto sink = gr::blocks::vector_sink_c::make();
+    top_block->connect(source, 0, filter, 0);
+    top_block->connect(filter, 0, sink, 0);
+    top_block->run();
+    return sink->data();
+}
+
+
+// The block may leave the last segments of the stream unprocessed. The
+// VOLK kernels round differently, and the error of the phase estimate
+// scales with the input.
+void expect_same_output(const std::vector<gr_complex> &signal, const std::vector<gr_complex> &reference, const std::vector<gr_complex> &out)
+{
+    ASSERT_GT(out.size(), reference.size() / 2);
+    const size_t n = std::min(reference.size(), out.size());
+    size_t mismatches = 0;
+    size_t first_mismatch = 0;
+    for (size_t k = 0; k < n; k++)
+        {
+            if (std::abs(out[k] - reference[k]) > 1e-3F * (1.0F + std::abs(signal[k])))
+                {
+                    first_mismatch = mismatches == 0 ? k : first_mismatch;
+                    mismatches++;
+                }
+        }
+    EXPECT_EQ(0U, mismatches) << "first mismatch at sample " << first_mismatch << ": " << out[first_mismatch]
+                              << " instead of " << reference[first_mismatch];
+}
+}  // namespace
+
+
+TEST(InterferenceMitigationTest, OutputUnchanged)
+{
+    const std::vector<gr_complex> signal = mitigation_test_signal();
+    const float pfa = 0.001;
+    const float p_c_factor = 0.9;
+    const int32_t length = 32;
+    const int32_t n_segments_est = 100;
+    const int32_t n_segments_reset = 5000000;
+    Reference_Mitigation reference(pfa, length, n_segments_est, n_segments_reset);
+
+    auto pulse_blanking = make_pulse_blanking_cc(pfa, length, n_segments_est, n_segments_reset);
+    expect_same_output(signal, reference.pulse_blanking(signal), filter_output(pulse_blanking, signal));
+    EXPECT_GT(reference.detections, 0U);
+    EXPECT_GT(pulse_blanking->stats().detections, 0U);
+
+    auto notch_lite = make_notch_filter_lite(p_c_factor, pfa, length, n_segments_est, n_segments_reset, 20);
+    expect_same_output(signal, reference.notch_lite(signal, p_c_factor, 20), filter_output(notch_lite, signal));
+    EXPECT_GT(reference.detections, 0U);
+    EXPECT_GT(notch_lite->stats().detections, 0U);
+
+    auto notch = make_notch_filter(pfa, p_c_factor, length, n_segments_est, n_segments_reset);
+    expect_same_output(signal, reference.notch(signal, p_c_factor), filter_output(notch, signal));
+    EXPECT_GT(reference.detections, 0U);
+    EXPECT_GT(notch->stats().detections, 0U);
+}
+
+
+TEST(MultiNotchTest, SuppressesTwoInterferers)
+{
+    const int nsamples = 400000;
+    const std::vector<double> freqs = {0.1037, -0.2311};
+    const std::vector<double> amplitudes = {10.0, 6.0};
+    const std::vector<gr_complex> signal = jammed_signal(nsamples, 100000, freqs, amplitudes);
+
+    gr::top_block_sptr top_block = gr::make_top_block("multi_notch_test");
+    auto source = gr::blocks::vector_source_c::make(signal);
+    auto filter = make_multi_notch_filter(0.001, 0.9, 32, 2000, 5000000, 3);
+    auto sink = gr::blocks::vector_sink_c::make();
+    top_block->connect(source, 0, filter, 0);
+    top_block->connect(filter, 0, sink, 0);
+    top_block->run();
+
+    // the output lags the input by one sample (history)
+    std::vector<gr_complex> out = sink->data();
+    ASSERT_GT(out.size(), static_cast<size_t>(nsamples / 2));
+    out.insert(out.begin(), gr_complex(0.0, 0.0));
+    for (size_t i = 0; i < freqs.size(); i++)
+        {
+            const double before = tone_power_db(signal, freqs[i], 200000);
+            const double after = tone_power_db(out, freqs[i], 200000);
+            EXPECT_GT(before - after, 20.0) << "interferer at " << freqs[i];
+        }
+
+    std::vector<float> tracked = filter->frequencies();
+    ASSERT_EQ(freqs.size(), tracked.size());
+    for (size_t i = 0; i < freqs.size(); i++)
+        {
+            EXPECT_NEAR(freqs[i], tracked[i], 1e-3);
+        }
+    EXPECT_GT(filter->stats().detections, 0U);
+    EXPECT_GE(filter->stats().segments, filter->stats().detections);
+}
+
+
+TEST(MultiNotchTest, BenchmarkUnderJamming)
+{
+    const int nsamples = 4000000;
+    const std::vector<gr_complex> signal = jammed_signal(nsamples, 0, {0.1037, -0.2311, 0.31}, {10.0, 6.0, 4.0});
+    const std::vector<std::string> names = {"Pulse_Blanking_Filter", "Notch_Filter_Lite", "Notch_Filter", "Notch_Filter (3 interferers)"};
+    for (const auto &name : names)
+        {
+            gr::top_block_sptr top_block = gr::make_top_block("mitigation_benchmark");
+            auto source = gr::blocks::vector_source_c::make(signal);
+            auto sink = gr::blocks::null_sink::make(sizeof(gr_complex));
+            gr::block_sptr filter;
+            if (name == "Pulse_Blanking_Filter")
+                {
+                    filter = make_pulse_blanking_cc(0.001, 32, 100, 5000000);
+                }
+            else if (name == "Notch_Filter_Lite")
+                {
+                    filter = make_notch_filter_lite(0.9, 0.001, 32, 100, 5000000, 20);
+                }
+            else if (name == "Notch_Filter")
+                {
+                    filter = make_notch_filter(0.001, 0.9, 32, 100, 5000000);
+                }
+            else
+                {
+                    filter = make_multi_notch_filter(0.001, 0.9, 32, 100, 5000000, 3);
+                }
+            top_block->connect(source, 0, filter, 0);
+            top_block->connect(filter, 0, sink, 0);
+
+            std::chrono::duration<double> elapsed_seconds(0);
+            EXPECT_NO_THROW({
+                auto start = std::chrono::system_clock::now();
+                top_block->run();  // Start threads and wait
+                auto end = std::chrono::system_clock::now();
+                elapsed_seconds = end - start;
+                top_block->stop();
+            });
+
+            std::cout << name << " processed " << nsamples << " jammed samples in " << elapsed_seconds.count() * 1e6
+                      << " microseconds (" << nsamples / elapsed_seconds.count() / 1e6 << " Msps)" << std::endl;
+        }
+}
@@ -0,0 +1,192 @@
+/*!
+ * \file multibeam_beamformer_test.cc
+ * \brief Implements unit tests for the multi-beam beamformer
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <gnuradio/top_block.h>
+#include <chrono>
+#ifdef GR_GREATER_38
+#include <gnuradio/analog/sig_source.h>
+#else
+#include <gnuradio/analog/sig_source_c.h>
+#endif
+#include "beamformer.h"
+#include "beamformer_filter.h"
+#include "concurrent_queue.h"
+#include "gnss_sdr_valve.h"
+#include "in_memory_configuration.h"
+#include "multibeam_beamformer_cc.h"
+#include <gnuradio/blocks/null_sink.h>
+#include <complex>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+namespace
+{
+std::vector<std::vector<gr_complex>> random_matrix(size_t rows, size_t cols, std::mt19937 &gen)
+{
+    std::normal_distribution<float> dist(0.0, 1.0);
+    std::vector<std::vector<gr_complex>> m(rows, std::vector<gr_complex>(cols));
+    for (auto &row : m)
+        {
+            for (auto &x : row)
+                {
+                    x = gr_complex(dist(gen), dist(gen));
+                }
+        }
+    return m;
+}
+
+
+// Runs work() once and checks every beam against the direct sum
+void check_beams(const multibeam_beamformer_cc_sptr &beamformer, const std::vector<std::vector<gr_complex>> &inputs, const std::vector<std::vector<gr_complex>> &weights)
+{
+    const int nsamples = inputs[0].size();
+    std::vector<std::vector<gr_complex>> outputs(weights.size(), std::vector<gr_complex>(nsamples));
+    gr_vector_const_void_star input_items;
+    for (const auto &in : inputs)
+        {
+            input_items.push_back(in.data());
+        }
+    gr_vector_void_star output_items;
+    for (auto &out : outputs)
+        {
+            output_items.push_back(out.data());
+        }
+    EXPECT_EQ(nsamples, beamformer->work(nsamples, input_items, output_items));
+    for (size_t b = 0; b < weights.size(); b++)
+        {
+            for (int n = 0; n < nsamples; n++)
+                {
+                    gr_complex expected(0.0, 0.0);
+                    for (size_t i = 0; i < inputs.size(); i++)
+                        {
+                            expected += weights[b][i] * inputs[i][n];
+                        }
+                    ASSERT_LT(std::abs(outputs[b][n] - expected), 1e-4) << "beam " << b << ", sample " << n;
+                }
+        }
+}
+}  // namespace
+
+
+TEST(MultibeamBeamformerTest, FormsBeamsAndTakesNewWeights)
+{
+    std::mt19937 gen(42);
+    const uint32_t elements = 8;
+    const std::vector<std::vector<gr_complex>> inputs = random_matrix(elements, 3000, gen);
+    const std::vector<std::vector<gr_complex>> weights = random_matrix(3, elements, gen);
+    auto beamformer = make_multibeam_beamformer_cc(elements, weights);
+    EXPECT_EQ(3U, beamformer->beams());
+    EXPECT_EQ(elements, beamformer->elements());
+    check_beams(beamformer, inputs, weights);
+
+    // the new weights apply from the next call on
+    const std::vector<std::vector<gr_complex>> steered = random_matrix(3, elements, gen);
+    EXPECT_TRUE(beamformer->set_weights(steered));
+    EXPECT_EQ(1U, beamformer->published_weights());
+    check_beams(beamformer, inputs, steered);
+    EXPECT_EQ(1U, beamformer->weight_updates());
+
+    // the shape of the weights can not change
+    EXPECT_FALSE(beamformer->set_weights(random_matrix(2, elements, gen)));
+    EXPECT_FALSE(beamformer->set_weights(random_matrix(3, elements - 1, gen)));
+    check_beams(beamformer, inputs, steered);
+    EXPECT_THROW(make_multibeam_beamformer_cc(elements, random_matrix(2, elements + 1, gen)), std::invalid_argument);
+}
+
+
+TEST(MultibeamBeamformerTest, AdapterAssignsBeams)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("InputFilter.elements", "2");
+    config->set_property("InputFilter.beams", "2");
+    config->set_property("InputFilter.beam0.weights", "1,0, 0,1");
+    config->set_property("InputFilter.beam0.signals", "1C");
+    config->set_property("InputFilter.beam1.signals", "1C,1B");
+    config->set_property("InputFilter.beam1.channels", "3, 4");
+    BeamformerFilter filter(config.get(), "InputFilter", 2, 1);
+
+    EXPECT_EQ(2U, filter.beams());
+    EXPECT_EQ(0, filter.output_port("1C", 0));
+    EXPECT_EQ(1, filter.output_port("1C", 3));
+    EXPECT_EQ(1, filter.output_port("1B", 1));
+    EXPECT_EQ(-1, filter.output_port("L5", 1));
+    EXPECT_EQ(2, filter.get_right_block()->output_signature()->max_streams());
+    EXPECT_TRUE(filter.set_weights({{gr_complex(0.0, 1.0), gr_complex(1.0, 0.0)}, {gr_complex(1.0, 0.0), gr_complex(1.0, 0.0)}}));
+    EXPECT_FALSE(filter.set_weights({{gr_complex(1.0, 0.0), gr_complex(1.0, 0.0)}}));
+}
+
+
+TEST(MultibeamBeamformerTest, BenchmarkAgainstOneBeamformerPerBeam)
+{
+    const double fs = 4000000.0;
+    const int nsamples = 20000000;
+    const int beams = 4;
+
+    for (int multibeam = 0; multibeam < 2; multibeam++)
+        {
+            std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+            gr::top_block_sptr top_block = gr::make_top_block("beamformer_benchmark");
+            std::vector<gr::block_sptr> valves;
+            for (int i = 0; i < GNSS_SDR_BEAMFORMER_CHANNELS; i++)
+                {
+                    auto source = gr::analog::sig_source_c::make(fs, gr::analog::GR_SIN_WAVE, 1000.0 * (i + 1), 1.0, gr_complex(0.0));
+                    valves.push_back(gnss_sdr_make_valve(sizeof(gr_complex), nsamples, queue));
+                    top_block->connect(source, 0, valves.back(), 0);
+                }
+            if (multibeam)
+                {
+                    auto beamformer = make_multibeam_beamformer_cc(GNSS_SDR_BEAMFORMER_CHANNELS, std::vector<std::vector<gr_complex>>(beams, std::vector<gr_complex>(GNSS_SDR_BEAMFORMER_CHANNELS, gr_complex(1.0, 0.0))));
+                    for (int i = 0; i < GNSS_SDR_BEAMFORMER_CHANNELS; i++)
+                        {
+                            top_block->connect(valves[i], 0, beamformer, i);
+                        }
+                    for (int b = 0; b < beams; b++)
+                        {
+                            top_block->connect(beamformer, b, gr::blocks::null_sink::make(sizeof(gr_complex)), 0);
+                        }
+                }
+            else
+                {
+                    for (int b = 0; b < beams; b++)
+                        {
+                            auto beamformer = make_beamformer_sptr();
+                            for (int i = 0; i < GNSS_SDR_BEAMFORMER_CHANNELS; i++)
+                                {
+                                    top_block->connect(valves[i], 0, beamformer, i);
+                                }
+                            top_block->connect(beamformer, 0, gr::blocks::null_sink::make(sizeof(gr_complex)), 0);
+                        }
+                }
+
+            std::chrono::duration<double> elapsed_seconds(0);
+            EXPECT_NO_THROW({
+                auto start = std::chrono::system_clock::now();
+                top_block->run();  // Start threads and wait
+                auto end = std::chrono::system_clock::now();
+                elapsed_seconds = end - start;
+                top_block->stop();
+            });
+
+            std::cout << (multibeam ? "Multi-beam beamformer" : "One beamformer per beam") << " formed " << beams << " beams from "
+                      << GNSS_SDR_BEAMFORMER_CHANNELS << " elements and " << nsamples << " samples in " << elapsed_seconds.count() * 1e6
+                      << " microseconds (" << nsamples / elapsed_seconds.count() / 1e6 << " Msps)" << std::endl;
+        }
+}
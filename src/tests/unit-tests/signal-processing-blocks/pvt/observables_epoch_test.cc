@@ -0,0 +1,112 @@
+/*!
+ * \file observables_epoch_test.cc
+ * \brief Implements Unit Tests for the Observables_Epoch container
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "MATH_CONSTANTS.h"
+#include "gnss_frequencies.h"
+#include "observables_epoch.h"
+#include <cstring>
+#include <map>
+
+
+namespace
+{
+Gnss_Synchro get_test_observable(int channel, double rx_time_s)
+{
+    Gnss_Synchro gnss_synchro{};
+    gnss_synchro.System = 'G';
+    std::memcpy(static_cast<void*>(gnss_synchro.Signal), "1C", 3);
+    gnss_synchro.PRN = channel + 1;
+    gnss_synchro.Channel_ID = channel;
+    gnss_synchro.Flag_valid_pseudorange = true;
+    gnss_synchro.RX_time = rx_time_s;
+    gnss_synchro.Pseudorange_m = 2.0e7 + 1000.0 * channel + 100.0 * rx_time_s;
+    gnss_synchro.Carrier_phase_rads = 1.0e3 * channel + 10.0 * rx_time_s;
+    gnss_synchro.Carrier_Doppler_hz = 1000.0 + channel;
+    return gnss_synchro;
+}
+}  // namespace
+
+
+TEST(ObservablesEpochTest, SignalId)
+{
+    EXPECT_EQ(Observables_Epoch::evGPS_1C, Observables_Epoch::signal_id("1C"));
+    EXPECT_EQ(Observables_Epoch::evGPS_2S, Observables_Epoch::signal_id("2S"));
+    EXPECT_EQ(Observables_Epoch::evGPS_L5, Observables_Epoch::signal_id("L5"));
+    EXPECT_EQ(Observables_Epoch::evGAL_1B, Observables_Epoch::signal_id("1B"));
+    EXPECT_EQ(Observables_Epoch::evGAL_5X, Observables_Epoch::signal_id("5X"));
+    EXPECT_EQ(Observables_Epoch::evGAL_7X, Observables_Epoch::signal_id("7X"));
+    EXPECT_EQ(Observables_Epoch::evGLO_1G, Observables_Epoch::signal_id("1G"));
+    EXPECT_EQ(Observables_Epoch::evGLO_2G, Observables_Epoch::signal_id("2G"));
+    EXPECT_EQ(Observables_Epoch::evBDS_B1, Observables_Epoch::signal_id("B1"));
+    EXPECT_EQ(Observables_Epoch::evBDS_B2, Observables_Epoch::signal_id("B2"));
+    EXPECT_EQ(Observables_Epoch::evBDS_B3, Observables_Epoch::signal_id("B3"));
+    EXPECT_EQ(Observables_Epoch::evUNKNOWN, Observables_Epoch::signal_id("5Q"));
+    EXPECT_EQ(Observables_Epoch::evUNKNOWN, Observables_Epoch::signal_id(""));
+    EXPECT_DOUBLE_EQ(FREQ1, Observables_Epoch::carrier_frequency_hz(Observables_Epoch::evGAL_1B));
+    EXPECT_DOUBLE_EQ(FREQ3_BDS, Observables_Epoch::carrier_frequency_hz(Observables_Epoch::evBDS_B3));
+    EXPECT_DOUBLE_EQ(0.0, Observables_Epoch::carrier_frequency_hz(Observables_Epoch::evUNKNOWN));
+}
+
+
+TEST(ObservablesEpochTest, InsertFindAndInterpolate)
+{
+    Observables_Epoch observables(4);
+    observables.insert(3, get_test_observable(3, 1.0));
+    observables.insert(0, get_test_observable(0, 1.0));
+    observables.insert(2, get_test_observable(2, 1.0));
+    observables.insert(2, get_test_observable(1, 1.0));  // ignored, as std::map::insert
+    ASSERT_EQ(3U, observables.size());
+    EXPECT_EQ(0, observables.cbegin()->first);
+    EXPECT_EQ(3U, observables.find(2)->second.PRN);
+    EXPECT_TRUE(observables.find(1) == observables.cend());
+
+    Observables_Epoch observables_t1(4);
+    observables_t1.insert(0, get_test_observable(0, 1.1));
+    observables_t1.insert(1, get_test_observable(1, 1.1));
+    observables_t1.insert(3, get_test_observable(3, 1.1));
+
+    Observables_Epoch interp(4);
+    interp.interpolate(observables, observables_t1, 1.04);
+    ASSERT_EQ(2U, interp.size());  // channel 2 missing at t1, channel 1 missing at t0
+    for (const auto& observable : interp)
+        {
+            const Gnss_Synchro expected = get_test_observable(observable.first, 1.04);
+            EXPECT_DOUBLE_EQ(1.04, observable.second.RX_time);
+            EXPECT_NEAR(expected.Pseudorange_m, observable.second.Pseudorange_m, 1e-6);
+            EXPECT_NEAR(expected.Carrier_phase_rads, observable.second.Carrier_phase_rads, 1e-9);
+        }
+
+    observables.apply_rx_clock_offset(1e-3);
+    EXPECT_DOUBLE_EQ(1.0 - 1e-3, observables.find(0)->second.RX_time);
+    EXPECT_DOUBLE_EQ(get_test_observable(0, 1.0).Carrier_phase_rads - 1e-3 * FREQ1 * PI_2, observables.find(0)->second.Carrier_phase_rads);
+
+    // the carrier phase of every signal is corrected (RINEX 3.04, Table 1)
+    Observables_Epoch observables_e5b(1);
+    Gnss_Synchro e5b = get_test_observable(0, 1.0);
+    e5b.System = 'E';
+    std::memcpy(static_cast<void*>(e5b.Signal), "7X", 3);
+    observables_e5b.insert(0, e5b);
+    observables_e5b.apply_rx_clock_offset(1e-3);
+    EXPECT_DOUBLE_EQ(e5b.Carrier_phase_rads - 1e-3 * FREQ7 * PI_2, observables_e5b.find(0)->second.Carrier_phase_rads);
+
+    std::map<int, Gnss_Synchro> observables_map;
+    observables.to_map(observables_map);
+    ASSERT_EQ(3U, observables_map.size());
+    EXPECT_EQ(3, observables_map.at(3).Channel_ID);
+}
+
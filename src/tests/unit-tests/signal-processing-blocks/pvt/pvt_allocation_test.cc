@@ -0,0 +1,402 @@
+/*!
+ * \file pvt_allocation_test.cc
+ * \brief Checks that the per-epoch processing of the PVT block does not
+ * allocate memory, with and without position fixes. It replaces the global
+ * operator new, so it is built as a separate test program.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "MATH_CONSTANTS.h"
+#include "gnss_synchro.h"
+#include "gps_ephemeris.h"
+#include "in_memory_configuration.h"
+#include "observables_epoch.h"
+#include "rtklib_pvt.h"
+#include "rtklib_pvt_gs.h"
+#include "rtklib_rtkcmn.h"
+#include <gnuradio/basic_block.h>
+#include <gnuradio/block.h>
+#include <gtest/gtest.h>
+#include <pmt/pmt.h>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#if GNURADIO_USES_STD_POINTERS
+#else
+#include <boost/shared_ptr.hpp>
+#endif
+
+
+namespace
+{
+// Only the allocations of the thread that enables the count are counted,
+// so the threads of other libraries do not interfere
+thread_local bool count_allocations = false;
+thread_local uint64_t allocations = 0;
+
+
+class Allocation_Counter
+{
+public:
+    Allocation_Counter()
+    {
+        allocations = 0;
+        count_allocations = true;
+    }
+
+    ~Allocation_Counter()
+    {
+        count_allocations = false;
+    }
+
+    uint64_t count() const { return allocations; }
+};
+
+
+Gnss_Synchro get_test_observable(int channel, double rx_time_s)
+{
+    Gnss_Synchro gnss_synchro{};
+    gnss_synchro.System = 'G';
+    std::memcpy(static_cast<void*>(gnss_synchro.Signal), "1C", 3);
+    gnss_synchro.PRN = channel + 1;
+    gnss_synchro.Channel_ID = channel;
+    gnss_synchro.Flag_valid_pseudorange = true;
+    gnss_synchro.RX_time = rx_time_s;
+    gnss_synchro.Pseudorange_m = 2.0e7 + 1000.0 * channel + 100.0 * rx_time_s;
+    gnss_synchro.Carrier_phase_rads = 1.0e3 * channel + 10.0 * rx_time_s;
+    gnss_synchro.Carrier_Doppler_hz = 1000.0 + channel;
+    return gnss_synchro;
+}
+
+
+// Calls the message handlers of a block, as the scheduler would
+class Message_Dispatcher : public gr::basic_block
+{
+public:
+    static void dispatch(gr::basic_block& block, const pmt::pmt_t& port, const pmt::pmt_t& msg)
+    {
+        (block.*(&Message_Dispatcher::dispatch_msg))(port, msg);
+    }
+};
+
+
+// A circular orbit with six satellites in each of six planes
+const double TEST_TOE_S = 302400.0;
+
+
+Gps_Ephemeris get_test_ephemeris(uint32_t prn)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = prn;
+    eph.i_GPS_week = 2100;
+    eph.d_Toe = TEST_TOE_S;
+    eph.d_Toc = TEST_TOE_S;
+    eph.d_TOW = static_cast<int32_t>(TEST_TOE_S);
+    eph.d_sqrt_A = 5153.7;
+    eph.d_e_eccentricity = 0.0;
+    eph.d_i_0 = 0.96;
+    eph.d_OMEGA0 = 2.0 * PI * ((prn - 1) % 6) / 6.0;
+    eph.d_M_0 = 2.0 * PI * ((prn - 1) / 6) / 6.0 + 0.5 * ((prn - 1) % 6);
+    eph.d_OMEGA_DOT = -8.0e-9;
+    return eph;
+}
+
+
+// Pseudorange without clock offsets nor atmospheric delays, computed as
+// RTKLIB does: the satellite position at transmission time, rotated to the
+// Earth-fixed frame at reception time
+double get_test_pseudorange(Gps_Ephemeris& eph, const std::array<double, 3>& rx_pos, double rx_time_s)
+{
+    double tau = 0.075;
+    double range = 0.0;
+    for (int i = 0; i < 5; i++)
+        {
+            eph.satellitePosition(rx_time_s - tau);
+            const double theta = DEFAULT_OMEGA_EARTH_DOT * tau;
+            const double x = std::cos(theta) * eph.d_satpos_X + std::sin(theta) * eph.d_satpos_Y;
+            const double y = -std::sin(theta) * eph.d_satpos_X + std::cos(theta) * eph.d_satpos_Y;
+            const double z = eph.d_satpos_Z;
+            range = std::sqrt((x - rx_pos[0]) * (x - rx_pos[0]) + (y - rx_pos[1]) * (y - rx_pos[1]) + (z - rx_pos[2]) * (z - rx_pos[2]));
+            tau = range / SPEED_OF_LIGHT;
+        }
+    return range;
+}
+
+
+double get_test_elevation_deg(Gps_Ephemeris& eph, const std::array<double, 3>& rx_pos)
+{
+    eph.satellitePosition(TEST_TOE_S);
+    const std::array<double, 3> los{eph.d_satpos_X - rx_pos[0], eph.d_satpos_Y - rx_pos[1], eph.d_satpos_Z - rx_pos[2]};
+    const double rx_norm = std::sqrt(rx_pos[0] * rx_pos[0] + rx_pos[1] * rx_pos[1] + rx_pos[2] * rx_pos[2]);
+    const double los_norm = std::sqrt(los[0] * los[0] + los[1] * los[1] + los[2] * los[2]);
+    return std::asin((los[0] * rx_pos[0] + los[1] * rx_pos[1] + los[2] * rx_pos[2]) / rx_norm / los_norm) / D2R;
+}
+
+
+/*
+ * Feeds the ephemeris of the visible satellites to a PVT block, and then one
+ * epoch per call to work(). Returns the number of allocations of the calls
+ * after the first second that solve a position and do not publish the status
+ * report nor print it. The status report is a GNU Radio message that is
+ * allocated and kept by its receiver, and the console output builds a
+ * time_facet, so both allocate at their own (low) rate.
+ *
+ * RTKLIB allocates its matrices with malloc() in mat() and zeros(), which
+ * the replaced operator new does not count. They are out of the scope of
+ * this test.
+ */
+uint64_t count_solve_allocations(bool async_output, int* valid_epochs)
+{
+    const uint32_t nchannels = 8;
+    const int n_epochs = 1000;
+    const int warm_up_epochs = 50;
+    auto configuration = std::make_shared<InMemoryConfiguration>();
+    configuration->set_property("Channels_1C.count", std::to_string(nchannels));
+    configuration->set_property("PVT.positioning_mode", "Single");
+    configuration->set_property("PVT.iono_model", "OFF");
+    configuration->set_property("PVT.trop_model", "OFF");
+    configuration->set_property("PVT.output_rate_ms", "20");
+    configuration->set_property("PVT.display_rate_ms", "1000");
+    configuration->set_property("PVT.output_enabled", "false");
+    configuration->set_property("PVT.rtcm_output_file_enabled", "false");
+    configuration->set_property("PVT.dump", "false");
+    configuration->set_property("PVT.dump_mat", "false");
+    configuration->set_property("PVT.async_output", async_output ? "true" : "false");
+    auto pvt = std::make_shared<Rtklib_Pvt>(configuration.get(), "PVT", nchannels, 0);
+#if GNURADIO_USES_STD_POINTERS
+    auto pvt_block = std::dynamic_pointer_cast<rtklib_pvt_gs>(pvt->get_left_block());
+#else
+    auto pvt_block = boost::dynamic_pointer_cast<rtklib_pvt_gs>(pvt->get_left_block());
+#endif
+    EXPECT_TRUE(pvt_block != nullptr);
+    if (pvt_block == nullptr)
+        {
+            return 0;
+        }
+
+    std::array<double, 3> rx_pos{};
+    const std::array<double, 3> rx_pos_llh{41.27 * D2R, 1.99 * D2R, 100.0};
+    pos2ecef(rx_pos_llh.data(), rx_pos.data());
+    std::vector<Gps_Ephemeris> visible;
+    for (uint32_t prn = 1; prn <= 32 and visible.size() < nchannels - 1; prn++)
+        {
+            Gps_Ephemeris eph = get_test_ephemeris(prn);
+            if (get_test_elevation_deg(eph, rx_pos) > 25.0)
+                {
+                    visible.push_back(eph);
+                    Message_Dispatcher::dispatch(*pvt_block, pmt::mp("telemetry"), pmt::make_any(std::make_shared<Gps_Ephemeris>(eph)));
+                }
+        }
+    EXPECT_LE(5U, visible.size());
+
+    // the last channel is not tracking any satellite
+    std::vector<Gnss_Synchro> channels(nchannels);
+    gr_vector_const_void_star input_items(nchannels);
+    gr_vector_void_star output_items;
+    for (uint32_t i = 0; i < nchannels; i++)
+        {
+            input_items[i] = &channels[i];
+        }
+
+    uint64_t n_allocations = 0;
+    *valid_epochs = 0;
+    for (int epoch = 0; epoch < n_epochs; epoch++)
+        {
+            const double rx_time_s = static_cast<double>(static_cast<uint64_t>(TEST_TOE_S * 1000.0) + 20 * epoch) / 1000.0;
+            for (uint32_t i = 0; i < visible.size(); i++)
+                {
+                    channels[i] = get_test_observable(i, rx_time_s);
+                    channels[i].PRN = visible[i].i_satellite_PRN;
+                    channels[i].CN0_dB_hz = 45.0;
+                    channels[i].Pseudorange_m = get_test_pseudorange(visible[i], rx_pos, rx_time_s);
+                    channels[i].Carrier_Doppler_hz = 0.0;
+                }
+            Allocation_Counter counter;
+            EXPECT_EQ(1, pvt_block->work(1, input_items, output_items));
+            const uint64_t epoch_allocations = counter.count();
+
+            double longitude_deg = 0.0;
+            double latitude_deg = 0.0;
+            double height_m = 0.0;
+            double ground_speed_kmh = 0.0;
+            double course_over_ground_deg = 0.0;
+            time_t utc_time = 0;
+            if (pvt_block->get_latest_PVT(&longitude_deg, &latitude_deg, &height_m, &ground_speed_kmh, &course_over_ground_deg, &utc_time))
+                {
+                    (*valid_epochs)++;
+                    EXPECT_NEAR(41.27, latitude_deg, 1e-4);
+                    EXPECT_NEAR(1.99, longitude_deg, 1e-4);
+                }
+            if (epoch >= warm_up_epochs and static_cast<uint32_t>(rx_time_s * 1000.0) % 1000 != 0)
+                {
+                    n_allocations += epoch_allocations;
+                }
+        }
+    return n_allocations;
+}
+}  // namespace
+
+
+void* operator new(std::size_t size)
+{
+    if (count_allocations)
+        {
+            allocations++;
+        }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+    return p;
+}
+
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete(void* p, std::size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+
+TEST(PvtAllocationTest, ObservablesEpochSteadyState)
+{
+    const uint32_t nchannels = 24;
+    const int n_epochs = 1000;
+    std::vector<Gnss_Synchro> channels(nchannels);
+    Observables_Epoch observables(nchannels);
+    Observables_Epoch observables_t0(nchannels);
+    Observables_Epoch observables_t1(nchannels);
+
+    uint64_t n_allocations = 0;
+    {
+        Allocation_Counter counter;
+        for (int epoch = 0; epoch < n_epochs; epoch++)
+            {
+                // same sequence of operations as rtklib_pvt_gs::work()
+                const double rx_time_s = 0.02 * epoch;
+                for (uint32_t i = 0; i < nchannels; i++)
+                    {
+                        channels[i] = get_test_observable(i, rx_time_s);
+                        // a changing subset of channels loses lock
+                        channels[i].Flag_valid_pseudorange = ((i + epoch) % 7 != 0);
+                    }
+                observables.clear();
+                for (uint32_t i = 0; i < nchannels; i++)
+                    {
+                        if (channels[i].Flag_valid_pseudorange)
+                            {
+                                observables.insert(i, channels[i]);
+                            }
+                    }
+                observables_t0 = observables_t1;
+                observables.apply_rx_clock_offset(1e-7);
+                observables_t1 = observables;
+                if (!observables_t0.empty())
+                    {
+                        observables.interpolate(observables_t0, observables_t1, rx_time_s - 0.01);
+                    }
+            }
+        n_allocations = counter.count();
+    }
+
+    EXPECT_EQ(0U, n_allocations);
+    EXPECT_FALSE(observables.empty());
+    EXPECT_EQ(nchannels, observables.capacity());
+}
+
+
+TEST(PvtAllocationTest, WorkWithoutEphemeris)
+{
+    // the observables are read and discarded, as there is no ephemeris yet
+    const uint32_t nchannels = 8;
+    const int n_items = 50;
+    const int n_calls = 100;
+    auto configuration = std::make_shared<InMemoryConfiguration>();
+    configuration->set_property("Channels_1C.count", std::to_string(nchannels));
+    configuration->set_property("PVT.positioning_mode", "Single");
+    configuration->set_property("PVT.output_rate_ms", "20");
+    configuration->set_property("PVT.display_rate_ms", "500");
+    configuration->set_property("PVT.output_enabled", "false");
+    configuration->set_property("PVT.rtcm_output_file_enabled", "false");
+    configuration->set_property("PVT.dump", "false");
+    configuration->set_property("PVT.dump_mat", "false");
+    auto pvt = std::make_shared<Rtklib_Pvt>(configuration.get(), "PVT", nchannels, 0);
+#if GNURADIO_USES_STD_POINTERS
+    auto pvt_block = std::dynamic_pointer_cast<rtklib_pvt_gs>(pvt->get_left_block());
+#else
+    auto pvt_block = boost::dynamic_pointer_cast<rtklib_pvt_gs>(pvt->get_left_block());
+#endif
+    ASSERT_TRUE(pvt_block != nullptr);
+
+    std::vector<std::vector<Gnss_Synchro>> channels(nchannels, std::vector<Gnss_Synchro>(n_items));
+    gr_vector_const_void_star input_items(nchannels);
+    gr_vector_void_star output_items;
+    for (uint32_t i = 0; i < nchannels; i++)
+        {
+            input_items[i] = channels[i].data();
+        }
+
+    uint64_t n_allocations = 0;
+    for (int call = 0; call < n_calls; call++)
+        {
+            for (uint32_t i = 0; i < nchannels; i++)
+                {
+                    for (int n = 0; n < n_items; n++)
+                        {
+                            channels[i][n] = get_test_observable(i, 0.02 * (call * n_items + n));
+                            channels[i][n].Flag_valid_pseudorange = ((i + n) % 5 != 0);
+                        }
+                }
+            // the first call is left out of the count
+            Allocation_Counter counter;
+            EXPECT_EQ(n_items, pvt_block->work(n_items, input_items, output_items));
+            if (call > 0)
+                {
+                    n_allocations += counter.count();
+                }
+        }
+
+    EXPECT_EQ(0U, n_allocations);
+}
+
+
+TEST(PvtAllocationTest, WorkWithEphemeris)
+{
+    int valid_epochs = 0;
+    EXPECT_EQ(0U, count_solve_allocations(false, &valid_epochs));
+    EXPECT_LT(900, valid_epochs);
+}
+
+
+TEST(PvtAllocationTest, WorkWithEphemerisAsyncOutput)
+{
+    // the output records are filled by work() and written by another thread
+    int valid_epochs = 0;
+    EXPECT_EQ(0U, count_solve_allocations(true, &valid_epochs));
+    EXPECT_LT(900, valid_epochs);
+}
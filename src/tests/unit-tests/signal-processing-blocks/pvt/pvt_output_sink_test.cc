@@ -0,0 +1,117 @@
+/*!
+ * \file pvt_output_sink_test.cc
+ * \brief Implements Unit Tests for the Pvt_Output_Sink class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pvt_output_sink.h"
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+TEST(PvtOutputSinkTest, KeepsOrder)
+{
+    std::vector<int> written;
+    {
+        Pvt_Output_Sink<int> sink(std::vector<int>(8), false, [&written](int& record) { written.push_back(record); });
+        for (int i = 0; i < 1000; i++)
+            {
+                int* record = sink.acquire();
+                ASSERT_NE(nullptr, record);
+                *record = i;
+                sink.commit();
+            }
+        sink.flush();
+        EXPECT_EQ(1000U, sink.get_written());
+        EXPECT_EQ(0U, sink.get_dropped());
+        EXPECT_LE(sink.get_max_depth(), 8U);
+    }
+    ASSERT_EQ(1000U, written.size());
+    for (int i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(i, written[i]);
+        }
+}
+
+
+TEST(PvtOutputSinkTest, ReusesSlots)
+{
+    std::set<const int*> slots;
+    Pvt_Output_Sink<int> sink(std::vector<int>(4), false, [&slots](int& record) { slots.insert(&record); });
+    for (int i = 0; i < 100; i++)
+        {
+            ASSERT_NE(nullptr, sink.acquire());
+            sink.commit();
+        }
+    sink.flush();
+    EXPECT_EQ(4U, slots.size());
+}
+
+
+TEST(PvtOutputSinkTest, DropsWhenFull)
+{
+    std::atomic<bool> release{false};
+    std::atomic<int> written{0};
+    {
+        Pvt_Output_Sink<int> sink(std::vector<int>(4), true, [&release, &written](int& record) {
+            // the first record keeps the writer thread busy
+            while (record == 0 and !release)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            written++;
+        });
+        for (int i = 0; i < 11; i++)
+            {
+                int* record = sink.acquire();
+                if (record != nullptr)
+                    {
+                        *record = i;
+                        sink.commit();
+                    }
+            }
+        EXPECT_TRUE(sink.full());
+        EXPECT_EQ(4U, sink.get_pushed());
+        EXPECT_EQ(7U, sink.get_dropped());
+        release = true;
+        sink.flush();
+        EXPECT_FALSE(sink.full());
+    }
+    EXPECT_EQ(4, written);
+}
+
+
+TEST(PvtOutputSinkTest, BlocksWhenFull)
+{
+    std::atomic<int> written{0};
+    {
+        Pvt_Output_Sink<int> sink(std::vector<int>(2), false, [&written](int& /*record*/) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            written++;
+        });
+        for (int i = 0; i < 20; i++)
+            {
+                EXPECT_NE(nullptr, sink.acquire());
+                sink.commit();
+            }
+        EXPECT_EQ(0U, sink.get_dropped());
+        EXPECT_GT(sink.get_blocked(), 0U);
+    }
+    // the destructor writes the pending records
+    EXPECT_EQ(20, written);
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file receiver_state_snapshot_test.cc
+ * \brief Implements Unit Tests for the Receiver_State_Snapshot class
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "receiver_state_snapshot.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+
+namespace
+{
+Receiver_State_Snapshot make_snapshot()
+{
+    Receiver_State_Snapshot snapshot;
+    snapshot.utc_time_s = 1600000000;
+    snapshot.position_valid = true;
+    snapshot.latitude_deg = 41.27;
+    snapshot.longitude_deg = 1.98;
+    snapshot.height_m = 80.5;
+    snapshot.rx_clock_drift_ppm = -1.25;
+    snapshot.gps_doppler_hz[12] = -2345.5;
+    snapshot.galileo_doppler_hz[4] = 1234.0;
+
+    Gps_Ephemeris gps_eph;
+    gps_eph.i_satellite_PRN = 12;
+    gps_eph.d_Toe = 302400.0;
+    gps_eph.d_sqrt_A = 5153.7;
+    snapshot.gps_ephemeris_map[12] = gps_eph;
+    Galileo_Ephemeris gal_eph;
+    gal_eph.i_satellite_PRN = 4;
+    gal_eph.t0e_1 = 3600;
+    snapshot.galileo_ephemeris_map[4] = gal_eph;
+    Gps_Almanac gps_alm;
+    gps_alm.i_satellite_PRN = 7;
+    snapshot.gps_almanac_map[7] = gps_alm;
+    snapshot.gps_iono.valid = true;
+    snapshot.gps_iono.d_alpha0 = 1.1e-8;
+    snapshot.gps_utc_model.valid = true;
+    snapshot.gps_utc_model.d_DeltaT_LS = 18;
+    return snapshot;
+}
+}  // namespace
+
+
+TEST(ReceiverStateSnapshotTest, RoundTrip)
+{
+    const std::string file_name = "./receiver_state_snapshot_test.bin";
+    ASSERT_TRUE(make_snapshot().save(file_name));
+
+    Receiver_State_Snapshot snapshot;
+    ASSERT_TRUE(snapshot.load(file_name));
+    std::remove(file_name.c_str());
+
+    EXPECT_EQ(1600000000, snapshot.utc_time_s);
+    EXPECT_TRUE(snapshot.position_valid);
+    EXPECT_DOUBLE_EQ(41.27, snapshot.latitude_deg);
+    EXPECT_DOUBLE_EQ(1.98, snapshot.longitude_deg);
+    EXPECT_DOUBLE_EQ(80.5, snapshot.height_m);
+    EXPECT_DOUBLE_EQ(-1.25, snapshot.rx_clock_drift_ppm);
+    EXPECT_DOUBLE_EQ(-2345.5, snapshot.gps_doppler_hz.at(12));
+    EXPECT_DOUBLE_EQ(1234.0, snapshot.galileo_doppler_hz.at(4));
+    ASSERT_EQ(1U, snapshot.gps_ephemeris_map.count(12));
+    EXPECT_EQ(12U, snapshot.gps_ephemeris_map.at(12).i_satellite_PRN);
+    EXPECT_DOUBLE_EQ(302400.0, snapshot.gps_ephemeris_map.at(12).d_Toe);
+    EXPECT_DOUBLE_EQ(5153.7, snapshot.gps_ephemeris_map.at(12).d_sqrt_A);
+    ASSERT_EQ(1U, snapshot.galileo_ephemeris_map.count(4));
+    EXPECT_EQ(3600, snapshot.galileo_ephemeris_map.at(4).t0e_1);
+    EXPECT_EQ(1U, snapshot.gps_almanac_map.count(7));
+    EXPECT_TRUE(snapshot.gps_iono.valid);
+    EXPECT_DOUBLE_EQ(1.1e-8, snapshot.gps_iono.d_alpha0);
+    EXPECT_TRUE(snapshot.gps_utc_model.valid);
+    EXPECT_EQ(18, snapshot.gps_utc_model.d_DeltaT_LS);
+    EXPECT_FALSE(snapshot.gps_cnav_iono.valid);
+    EXPECT_TRUE(snapshot.has_navigation_data());
+    EXPECT_FALSE(Receiver_State_Snapshot().has_navigation_data());
+}
+
+
+TEST(ReceiverStateSnapshotTest, RejectsDamagedFiles)
+{
+    const std::string file_name = "./receiver_state_snapshot_test.bin";
+    Receiver_State_Snapshot snapshot;
+    EXPECT_FALSE(snapshot.load(file_name));  // does not exist
+
+    ASSERT_TRUE(make_snapshot().save(file_name));
+    std::fstream file(file_name, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('\x55');  // payload does not match the checksum
+    file.close();
+    EXPECT_FALSE(snapshot.load(file_name));
+    EXPECT_FALSE(snapshot.position_valid);
+    EXPECT_TRUE(snapshot.gps_ephemeris_map.empty());
+
+    ASSERT_TRUE(make_snapshot().save(file_name));
+    file.open(file_name, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(8);
+    file.put('\x7f');  // other format version
+    file.close();
+    EXPECT_FALSE(snapshot.load(file_name));
+
+    std::ofstream truncated(file_name, std::ios::trunc | std::ios::binary);
+    truncated << "GSDR";
+    truncated.close();
+    EXPECT_FALSE(snapshot.load(file_name));
+    std::remove(file_name.c_str());
+}
@@ -17,8 +17,36 @@
  * -------------------------------------------------------------------------
  */
 
+#include "galileo_ephemeris.h"
+#include "galileo_iono.h"
+#include "galileo_utc_model.h"
 #include "rinex_printer.h"
+#include <fstream>
 #include <string>
+#include <vector>
+
+
+namespace
+{
+std::vector<std::string> read_rinex_lines(const std::string& filename)
+{
+    std::vector<std::string> lines;
+    std::ifstream in(filename);
+    std::string line_str;
+    while (std::getline(in, line_str))
+        {
+            lines.push_back(line_str);
+        }
+    return lines;
+}
+
+
+int64_t get_file_size(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    return static_cast<int64_t>(in.tellg());
+}
+}  // namespace
 
 
 TEST(RinexPrinterTest, GalileoObsHeader)
@@ -743,3 +771,92 @@ TEST(RinexPrinterTest, MixedObsLogGpsGlo)
             LOG(INFO) << "Error deleting temporary file";
         }
 }
+
+
+TEST(RinexPrinterTest, HeaderUpdateInPlace)
+{
+    const Galileo_Ephemeris eph = Galileo_Ephemeris();
+    const Galileo_Iono iono = Galileo_Iono();
+    Galileo_Utc_Model utc_model = Galileo_Utc_Model();
+    auto rp = std::make_shared<Rinex_Printer>(3);
+    rp->rinex_obs_header(rp->obsFile, eph, 0.0);
+    rp->rinex_nav_header(rp->navGalFile, iono, utc_model);
+    const std::string record("> 2020 01 01 00 00  0.0000000  0  0");
+    for (int i = 0; i < 100; i++)
+        {
+            rp->obsFile << record << std::endl;
+            rp->navGalFile << record << std::endl;
+        }
+    rp->obsFile.flush();
+    rp->navGalFile.flush();
+    const int64_t obs_size = get_file_size(rp->obsfilename);
+    const int64_t nav_size = get_file_size(rp->navGalfilename);
+
+    // Until the UTC model is decoded, the header says that the leap seconds are unknown
+    const std::string leap_seconds_unknown("LEAP SECONDS NOT KNOWN YET");
+    int32_t leap_seconds_unknown_lines = 0;
+    for (const auto& line : read_rinex_lines(rp->obsfilename))
+        {
+            if (line.find(leap_seconds_unknown, 0) == 0)
+                {
+                    leap_seconds_unknown_lines++;
+                    EXPECT_EQ(80U, line.size());
+                    EXPECT_EQ(0, line.compare(60, 7, "COMMENT"));
+                }
+        }
+    EXPECT_EQ(1, leap_seconds_unknown_lines);
+
+    utc_model.Delta_tLS_6 = 18;
+    utc_model.A0_6 = 1.0e-9;
+    rp->update_obs_header(rp->obsFile, utc_model);
+    rp->update_nav_header(rp->navGalFile, iono, utc_model);
+
+    // The reserved line is used for LEAP SECONDS, so the files keep their size
+    EXPECT_EQ(obs_size, get_file_size(rp->obsfilename));
+    EXPECT_EQ(nav_size, get_file_size(rp->navGalfilename));
+
+    // Records are still appended at the end of the files
+    rp->obsFile << "last record" << std::endl;
+    rp->obsFile.flush();
+    std::vector<std::string> lines = read_rinex_lines(rp->obsfilename);
+    bool leap_seconds_found = false;
+    int32_t records = 0;
+    for (const auto& line : lines)
+        {
+            if (line.find("LEAP SECONDS", 59) != std::string::npos)
+                {
+                    leap_seconds_found = true;
+                    EXPECT_EQ(0, line.compare(0, 6, "    18"));
+                }
+            EXPECT_NE(0U, line.find(leap_seconds_unknown, 0));
+            if (line == record)
+                {
+                    records++;
+                }
+        }
+    EXPECT_TRUE(leap_seconds_found);
+    EXPECT_EQ(100, records);
+    EXPECT_EQ("last record", lines.back());
+
+    lines = read_rinex_lines(rp->navGalfilename);
+    bool gaut_found = false;
+    for (const auto& line : lines)
+        {
+            if (line.find("GAUT", 0) == 0)
+                {
+                    gaut_found = true;
+                    EXPECT_NE(std::string::npos, line.find(".1000000000D-08"));
+                }
+        }
+    EXPECT_TRUE(gaut_found);
+    EXPECT_EQ(record, lines.back());
+
+    if (remove(rp->obsfilename.c_str()) != 0)
+        {
+            LOG(INFO) << "Error deleting temporary file";
+        }
+    if (remove(rp->navGalfilename.c_str()) != 0)
+        {
+            LOG(INFO) << "Error deleting temporary file";
+        }
+}
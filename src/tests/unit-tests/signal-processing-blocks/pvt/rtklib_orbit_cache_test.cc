@@ -0,0 +1,175 @@
+/*!
+ * \file rtklib_orbit_cache_test.cc
+ * \brief Implements Unit Tests for the satellite orbit/clock cache of the
+ * RTKLIB ephemeris functions.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rtklib_ephemeris.h"
+#include "rtklib_rtkcmn.h"
+#include <array>
+#include <cmath>
+#include <memory>
+
+
+namespace
+{
+eph_t get_test_gps_eph()
+{
+    // GPS PRN 1 broadcast ephemeris
+    eph_t eph{};
+    eph.sat = satno(SYS_GPS, 1);
+    eph.iode = 58;
+    eph.iodc = 58;
+    eph.week = 2063;
+    eph.toes = 446400.0;
+    eph.toe = gpst2time(eph.week, eph.toes);
+    eph.toc = eph.toe;
+    eph.A = std::pow(5153.665142059, 2.0);
+    eph.e = 0.008631116128527;
+    eph.i0 = 0.9781213150698;
+    eph.OMG0 = -0.5213932466424;
+    eph.omg = 0.7257227993693;
+    eph.M0 = 1.569946773470;
+    eph.deln = 4.147315326520e-09;
+    eph.OMGd = -8.048192667868e-09;
+    eph.idot = -3.310852014850e-10;
+    eph.crc = 253.8750000000;
+    eph.crs = 93.18750000000;
+    eph.cuc = 4.859641194344e-06;
+    eph.cus = 5.994737148285e-06;
+    eph.cic = -1.117587089539e-08;
+    eph.cis = 6.332993507385e-08;
+    eph.f0 = -3.641894925386e-04;
+    eph.f1 = -7.844391802792e-12;
+    eph.f2 = 0.0;
+    return eph;
+}
+
+
+geph_t get_test_glonass_eph()
+{
+    // GLONASS slot 1 broadcast ephemeris
+    geph_t geph{};
+    geph.sat = satno(SYS_GLO, 1);
+    geph.iode = 60;
+    geph.frq = 1;
+    geph.toe = gpst2time(2063, 446418.0);
+    geph.pos[0] = 7003008.789;
+    geph.pos[1] = -12206626.953;
+    geph.pos[2] = 21280765.625;
+    geph.vel[0] = 783.8010788;
+    geph.vel[1] = 2804.5997620;
+    geph.vel[2] = 1352.5390625;
+    geph.acc[0] = 0.0;
+    geph.acc[1] = 1.862645149e-06;
+    geph.acc[2] = -2.793967724e-06;
+    geph.taun = -6.253086030483e-05;
+    geph.gamn = 0.0;
+    return geph;
+}
+}  // namespace
+
+
+TEST(RtklibOrbitCacheTest, GpsPositionAndClock)
+{
+    eph_t eph = get_test_gps_eph();
+    auto cache = std::make_shared<orbcache_t>();
+    std::array<double, 6> rs_exact{};
+    std::array<double, 6> rs_cached{};
+    std::array<double, 2> dts_exact{};
+    std::array<double, 2> dts_cached{};
+    double var_exact = 0.0;
+    double var_cached = 0.0;
+
+    // 10 minutes at 50 Hz, crossing several fit spans
+    for (int k = 0; k < 30000; k++)
+        {
+            gtime_t time = timeadd(eph.toe, -300.0 + 0.02 * k);
+            eph2pos(time, &eph, rs_exact.data(), dts_exact.data(), &var_exact);
+            orbcachepos(time, &eph, nullptr, cache.get(), rs_cached.data(), dts_cached.data(), &var_cached);
+            for (int i = 0; i < 3; i++)
+                {
+                    ASSERT_NEAR(rs_exact[i], rs_cached[i], 1e-4);
+                }
+            ASSERT_NEAR(dts_exact[0], dts_cached[0], 1e-13);
+            ASSERT_DOUBLE_EQ(var_exact, var_cached);
+        }
+
+    // Velocity and clock drift against a differential approximation of the exact model
+    gtime_t time = timeadd(eph.toe, 123.456);
+    std::array<double, 3> rs_next{};
+    double dts_next = 0.0;
+    eph2pos(time, &eph, rs_exact.data(), dts_exact.data(), &var_exact);
+    eph2pos(timeadd(time, 1e-3), &eph, rs_next.data(), &dts_next, &var_exact);
+    orbcachepos(time, &eph, nullptr, cache.get(), rs_cached.data(), dts_cached.data(), &var_cached);
+    for (int i = 0; i < 3; i++)
+        {
+            EXPECT_NEAR((rs_next[i] - rs_exact[i]) / 1e-3, rs_cached[i + 3], 1e-3);
+        }
+    EXPECT_NEAR((dts_next - dts_exact[0]) / 1e-3, dts_cached[1], 1e-12);
+}
+
+
+TEST(RtklibOrbitCacheTest, GlonassPositionAndClock)
+{
+    geph_t geph = get_test_glonass_eph();
+    auto cache = std::make_shared<orbcache_t>();
+    std::array<double, 6> rs_exact{};
+    std::array<double, 6> rs_cached{};
+    std::array<double, 2> dts_exact{};
+    std::array<double, 2> dts_cached{};
+    double var_exact = 0.0;
+    double var_cached = 0.0;
+
+    for (int k = 0; k < 30000; k++)
+        {
+            gtime_t time = timeadd(geph.toe, -300.0 + 0.02 * k);
+            geph2pos(time, &geph, rs_exact.data(), dts_exact.data(), &var_exact);
+            orbcachepos(time, nullptr, &geph, cache.get(), rs_cached.data(), dts_cached.data(), &var_cached);
+            for (int i = 0; i < 3; i++)
+                {
+                    ASSERT_NEAR(rs_exact[i], rs_cached[i], 1e-3);
+                }
+            ASSERT_NEAR(dts_exact[0], dts_cached[0], 1e-13);
+        }
+}
+
+
+TEST(RtklibOrbitCacheTest, InvalidatedOnEphemerisChange)
+{
+    eph_t eph = get_test_gps_eph();
+    auto cache = std::make_shared<orbcache_t>();
+    std::array<double, 6> rs_exact{};
+    std::array<double, 6> rs_cached{};
+    std::array<double, 2> dts_exact{};
+    std::array<double, 2> dts_cached{};
+    double var = 0.0;
+
+    gtime_t time = timeadd(eph.toe, 10.0);
+    orbcachepos(time, &eph, nullptr, cache.get(), rs_cached.data(), dts_cached.data(), &var);
+
+    // New ephemeris with the same IODE and Toe
+    eph.M0 += 1e-3;
+    eph.f0 += 1e-6;
+    time = timeadd(time, 1.0);
+    eph2pos(time, &eph, rs_exact.data(), dts_exact.data(), &var);
+    orbcachepos(time, &eph, nullptr, cache.get(), rs_cached.data(), dts_cached.data(), &var);
+    for (int i = 0; i < 3; i++)
+        {
+            EXPECT_NEAR(rs_exact[i], rs_cached[i], 1e-4);
+        }
+    EXPECT_NEAR(dts_exact[0], dts_cached[0], 1e-13);
+}
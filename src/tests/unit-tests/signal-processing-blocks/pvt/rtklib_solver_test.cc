@@ -403,7 +403,7 @@ TEST(RTKLibSolverTest, test1)
                     std::cout << "SUPL: Read XML Ephemeris for GPS SV " << gps_eph_iter->first << std::endl;
                     std::shared_ptr<Gps_Ephemeris> tmp_obj = std::make_shared<Gps_Ephemeris>(gps_eph_iter->second);
                     // update/insert new ephemeris record to the global ephemeris map
-                    d_ls_pvt->gps_ephemeris_map[gps_eph_iter->first] = *tmp_obj;
+                    d_ls_pvt->set_ephemeris(*tmp_obj);
                 }
         }
     else
@@ -463,7 +463,7 @@ TEST(RTKLibSolverTest, test1)
                     std::cout << "RX clock offset: " << d_ls_pvt->get_time_offset_s() << "[s]" << std::endl;
 
                     // boost::posix_time::ptime p_time;
-                    // gtime_t rtklib_utc_time = gpst2time(adjgpsweek(d_ls_pvt->gps_ephemeris_map.cbegin()->second.i_GPS_week), d_rx_time);
+                    // gtime_t rtklib_utc_time = gpst2time(adjgpsweek(d_ls_pvt->get_gps_ephemeris_map().cbegin()->second.i_GPS_week), d_rx_time);
                     // p_time = boost::posix_time::from_time_t(rtklib_utc_time.time);
                     // p_time += boost::posix_time::microseconds(round(rtklib_utc_time.sec * 1e6));
                     // std::cout << TEXT_MAGENTA << "Observable RX time (GPST) " << boost::posix_time::to_simple_string(p_time) << TEXT_RESET << std::endl;
@@ -0,0 +1,187 @@
+/*!
+ * \file polyphase_resampler_test.cc
+ * \brief Implements Unit Tests for the polyphase resampler, and benchmarks
+ * it against the direct and MMSE resamplers
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <gnuradio/analog/sig_source_waveform.h>
+#include <gnuradio/top_block.h>
+#include <chrono>
+#ifdef GR_GREATER_38
+#include <gnuradio/analog/sig_source.h>
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#else
+#include <gnuradio/analog/sig_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/blocks/vector_sink_s.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#endif
+#include "concurrent_queue.h"
+#include "direct_resampler_conditioner.h"
+#include "gnss_block_interface.h"
+#include "gnss_sdr_valve.h"
+#include "in_memory_configuration.h"
+#include "mmse_resampler_conditioner.h"
+#include "polyphase_resampler.h"
+#include "polyphase_resampler_conditioner.h"
+#include <gnuradio/blocks/null_sink.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+TEST(PolyphaseResamplerTest, TonePreserved)
+{
+    const double two_pi = 6.283185307179586;
+    const double fs_in = 30720000.0;
+    const double fs_out = 4000000.0;
+    const double f_tone = 250000.0;
+    const int nsamples = 307200;
+    std::vector<gr_complex> tone(nsamples);
+    for (int i = 0; i < nsamples; i++)
+        {
+            tone[i] = std::polar(1.0F, static_cast<float>(two_pi * f_tone * i / fs_in));
+        }
+
+    gr::top_block_sptr top_block = gr::make_top_block("polyphase_resampler_test");
+    auto source = gr::blocks::vector_source_c::make(tone);
+    auto resampler = make_polyphase_resampler(fs_in, fs_out, "gr_complex");
+    auto sink = gr::blocks::vector_sink_c::make();
+    top_block->connect(source, 0, resampler, 0);
+    top_block->connect(resampler, 0, sink, 0);
+    top_block->run();
+
+    // 30.72 / 4 = 192 / 25
+    EXPECT_TRUE(resampler->exact_ratio());
+    EXPECT_EQ(25U, resampler->num_phases());
+
+    std::vector<gr_complex> out = sink->data();
+    const double expected_size = nsamples * fs_out / fs_in;
+    EXPECT_NEAR(expected_size, static_cast<double>(out.size()), resampler->num_taps());
+
+    // The output sample k is the input signal at k * fs_in / fs_out + num_taps / 2 - 1
+    const double delay = resampler->num_taps() / 2.0 - 1.0;
+    double error = 0.0;
+    for (size_t k = 0; k < out.size(); k++)
+        {
+            const double t = static_cast<double>(k) * fs_in / fs_out + delay;
+            const gr_complex expected = std::polar(1.0F, static_cast<float>(two_pi * f_tone * t / fs_in));
+            error = std::max(error, static_cast<double>(std::abs(out[k] - expected)));
+        }
+    EXPECT_LT(error, 1e-2);
+}
+
+
+TEST(PolyphaseResamplerTest, ComplexShort)
+{
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("Resampler.sample_freq_in", "8000000");
+    config->set_property("Resampler.sample_freq_out", "2000000");
+    config->set_property("GNSS-SDR.internal_fs_sps", "2000000");
+    config->set_property("Resampler.item_type", "cshort");
+    std::shared_ptr<PolyphaseResamplerConditioner> resampler = std::make_shared<PolyphaseResamplerConditioner>(config.get(), "Resampler", 1, 1);
+    EXPECT_STREQ("Polyphase_Resampler", resampler->implementation().c_str());
+    EXPECT_EQ(2 * sizeof(int16_t), resampler->item_size());
+
+    // a constant signal, as interleaved I/Q shorts, goes through unchanged
+    const int nsamples = 8000;
+    std::vector<int16_t> samples(2 * nsamples);
+    for (int i = 0; i < nsamples; i++)
+        {
+            samples[2 * i] = 200;
+            samples[2 * i + 1] = -100;
+        }
+    gr::top_block_sptr top_block = gr::make_top_block("polyphase_resampler_test");
+    auto source = gr::blocks::vector_source_s::make(samples, false, 2);
+    auto sink = gr::blocks::vector_sink_s::make(2);
+    EXPECT_NO_THROW({
+        resampler->connect(top_block);
+        top_block->connect(source, 0, resampler->get_left_block(), 0);
+        top_block->connect(resampler->get_right_block(), 0, sink, 0);
+        top_block->run();
+    });
+
+    std::vector<int16_t> out = sink->data();
+    ASSERT_GT(out.size(), 2U * (nsamples / 4 - 100));
+    for (size_t i = 0; i < out.size(); i += 2)
+        {
+            EXPECT_NEAR(200, out[i], 1);
+            EXPECT_NEAR(-100, out[i + 1], 1);
+        }
+}
+
+
+TEST(PolyphaseResamplerTest, BenchmarkAgainstDirectAndMmse)
+{
+    const double fs_in = 30720000.0;
+    const double fs_out = 4000000.0;
+    const int nsamples = 30720000;  // one second of signal
+    const std::vector<std::string> implementations = {"Direct_Resampler", "Mmse_Resampler", "Polyphase_Resampler"};
+
+    for (const auto& implementation : implementations)
+        {
+            std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+            gr::top_block_sptr top_block = gr::make_top_block("resampler_benchmark");
+            auto source = gr::analog::sig_source_c::make(fs_in, gr::analog::GR_SIN_WAVE, 1000.0, 1.0, gr_complex(0.0));
+            auto valve = gnss_sdr_make_valve(sizeof(gr_complex), nsamples, queue);
+
+            std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+            config->set_property("Resampler.sample_freq_in", std::to_string(fs_in));
+            config->set_property("Resampler.sample_freq_out", std::to_string(fs_out));
+            config->set_property("GNSS-SDR.internal_fs_sps", std::to_string(fs_out));
+            config->set_property("Resampler.item_type", "gr_complex");
+
+            std::shared_ptr<GNSSBlockInterface> resampler;
+            if (implementation == "Direct_Resampler")
+                {
+                    resampler = std::make_shared<DirectResamplerConditioner>(config.get(), "Resampler", 1, 1);
+                }
+            else if (implementation == "Mmse_Resampler")
+                {
+                    resampler = std::make_shared<MmseResamplerConditioner>(config.get(), "Resampler", 1, 1);
+                }
+            else
+                {
+                    resampler = std::make_shared<PolyphaseResamplerConditioner>(config.get(), "Resampler", 1, 1);
+                }
+            auto sink = gr::blocks::null_sink::make(sizeof(gr_complex));
+
+            EXPECT_NO_THROW({
+                resampler->connect(top_block);
+                top_block->connect(source, 0, valve, 0);
+                top_block->connect(valve, 0, resampler->get_left_block(), 0);
+                top_block->connect(resampler->get_right_block(), 0, sink, 0);
+            }) << "Connection failure of " << implementation;
+
+            std::chrono::duration<double> elapsed_seconds(0);
+            EXPECT_NO_THROW({
+                auto start = std::chrono::system_clock::now();
+                top_block->run();  // Start threads and wait
+                auto end = std::chrono::system_clock::now();
+                elapsed_seconds = end - start;
+                top_block->stop();
+            }) << "Failure running " << implementation;
+
+            std::cout << implementation << " resampled " << nsamples << " samples from " << fs_in / 1e6 << " to "
+                      << fs_out / 1e6 << " Msps in " << elapsed_seconds.count() * 1e6 << " microseconds ("
+                      << nsamples / elapsed_seconds.count() / 1e6 << " Msps)" << std::endl;
+        }
+}
@@ -23,7 +23,59 @@
 #include "in_memory_configuration.h"
 #include <gnuradio/top_block.h>
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
 #include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef GR_GREATER_38
+#include <gnuradio/blocks/vector_sink.h>
+#else
+#include <gnuradio/blocks/vector_sink_c.h>
+#endif
+
+
+namespace
+{
+// writes a file of gr_complex items whose value is their index
+std::string write_indexed_file(size_t n_items)
+{
+    const std::string filename = "./file_signal_source_test.dat";
+    std::vector<gr_complex> items(n_items);
+    for (size_t i = 0; i < n_items; i++)
+        {
+            items[i] = gr_complex(static_cast<float>(i), -static_cast<float>(i));
+        }
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char*>(items.data()), items.size() * sizeof(gr_complex));
+    return filename;
+}
+
+
+std::vector<gr_complex> read_with_file_signal_source(const std::string& filename, bool enable_mmap,
+    const std::string& samples, const std::string& seconds_to_skip, const std::string& header_size)
+{
+    std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("Test.samples", samples);
+    config->set_property("Test.sampling_frequency", "1000000");
+    config->set_property("Test.filename", filename);
+    config->set_property("Test.item_type", "gr_complex");
+    config->set_property("Test.repeat", "false");
+    config->set_property("Test.seconds_to_skip", seconds_to_skip);
+    config->set_property("Test.header_size", header_size);
+    config->set_property("Test.enable_mmap", enable_mmap ? "true" : "false");
+
+    auto top_block = gr::make_top_block("FileSignalSourceTest");
+    std::unique_ptr<FileSignalSource> signal_source(new FileSignalSource(config.get(), "Test", 0, 1, queue));
+    auto sink = gr::blocks::vector_sink_c::make();
+    signal_source->connect(top_block);
+    top_block->connect(signal_source->get_right_block(), 0, sink, 0);
+    top_block->run();
+    return sink->data();
+}
+}  // namespace
+
 
 TEST(FileSignalSource, Instantiate)
 {
@@ -57,3 +109,62 @@ TEST(FileSignalSource, InstantiateFileNotExists)
 
     EXPECT_THROW({ auto uptr = std::make_shared<FileSignalSource>(config.get(), "Test", 0, 1, queue); }, std::exception);
 }
+
+TEST(FileSignalSource, InstantiateMmap)
+{
+    std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "0");
+    std::string path = std::string(TEST_PATH);
+    std::string filename = path + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+    config->set_property("Test.filename", filename);
+    config->set_property("Test.item_type", "gr_complex");
+    config->set_property("Test.repeat", "false");
+    config->set_property("Test.enable_mmap", "true");
+
+    std::unique_ptr<FileSignalSource> signal_source(new FileSignalSource(config.get(), "Test", 0, 1, queue));
+
+    EXPECT_STREQ("gr_complex", signal_source->item_type().c_str());
+    EXPECT_TRUE(signal_source->mmap_enabled());
+}
+
+TEST(FileSignalSource, InstantiateMmapFileNotExists)
+{
+    std::shared_ptr<Concurrent_Queue<pmt::pmt_t>> queue = std::make_shared<Concurrent_Queue<pmt::pmt_t>>();
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+
+    config->set_property("Test.samples", "0");
+    config->set_property("Test.sampling_frequency", "0");
+    config->set_property("Test.filename", "./signal_samples/i_dont_exist.dat");
+    config->set_property("Test.item_type", "gr_complex");
+    config->set_property("Test.repeat", "false");
+    config->set_property("Test.enable_mmap", "true");
+
+    EXPECT_THROW({ auto uptr = std::make_shared<FileSignalSource>(config.get(), "Test", 0, 1, queue); }, std::exception);
+}
+
+TEST(FileSignalSource, MmapMatchesFileSource)
+{
+    const size_t n_items = 100000;
+    const std::string filename = write_indexed_file(n_items);
+
+    // the whole file, but the last 2 ms
+    const std::vector<gr_complex> whole = read_with_file_signal_source(filename, false, "0", "0", "0");
+    const std::vector<gr_complex> whole_mmap = read_with_file_signal_source(filename, true, "0", "0", "0");
+    ASSERT_EQ(n_items - 2000, whole.size());
+    EXPECT_TRUE(whole == whole_mmap);
+
+    // 10 ms and a header of 123 items skipped, then 20000 items
+    const std::vector<gr_complex> part = read_with_file_signal_source(filename, false, "20000", "0.01", "123");
+    const std::vector<gr_complex> part_mmap = read_with_file_signal_source(filename, true, "20000", "0.01", "123");
+    std::remove(filename.c_str());
+    ASSERT_EQ(20000U, part.size());
+    EXPECT_EQ(gr_complex(10123.0, -10123.0), part.front());
+    ASSERT_EQ(part.size(), part_mmap.size());
+    for (size_t i = 0; i < part.size(); i++)
+        {
+            ASSERT_EQ(part[i], part_mmap[i]) << "at item " << i;
+        }
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file gr_complex_ip_packet_source_test.cc
+ * \brief Replays UDP packets over the loopback interface to the IP packet
+ * source, and checks the samples and the packet statistics.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "gr_complex_ip_packet_source.h"
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/top_block.h>
+#ifdef GR_GREATER_38
+#include <gnuradio/blocks/vector_sink.h>
+#else
+#include <gnuradio/blocks/vector_sink_c.h>
+#endif
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+TEST(GrComplexIpPacketSourceTest, RecvmmsgLoopbackReplay)
+{
+    const int payload_bytes = 1024;  // 512 complex byte samples
+    const int sequence_number_bytes = 4;
+    const uint32_t num_packets = 100;
+    const uint32_t missing_packet = 50;
+
+    // the kernel assigns a free port
+    auto source = Gr_Complex_Ip_Packet_Source::make("lo", "127.0.0.1", 0, payload_bytes, 1, "cbyte", sizeof(gr_complex), false,
+        "recvmmsg", sequence_number_bytes);
+    const uint64_t num_samples = static_cast<uint64_t>(num_packets - 1) * payload_bytes / 2;
+    auto head = gr::blocks::head::make(sizeof(gr_complex), num_samples);
+    auto sink = gr::blocks::vector_sink_c::make();
+    gr::top_block_sptr top_block = gr::make_top_block("ip_packet_source_test");
+    top_block->connect(source, 0, head, 0);
+    top_block->connect(head, 0, sink, 0);
+    top_block->start();
+    const auto start = std::chrono::steady_clock::now();
+    while (source->udp_port() == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    ASSERT_NE(0, source->udp_port());
+
+    // replay the packets, with a gap in the sequence numbers
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ASSERT_NE(-1, sock);
+    struct sockaddr_in destination
+    {
+    };
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(source->udp_port());
+    destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::vector<uint8_t> packet(sequence_number_bytes + payload_bytes);
+    for (uint32_t seq = 0; seq < num_packets; seq++)
+        {
+            if (seq == missing_packet)
+                {
+                    continue;
+                }
+            packet[0] = static_cast<uint8_t>(seq >> 24U);
+            packet[1] = static_cast<uint8_t>(seq >> 16U);
+            packet[2] = static_cast<uint8_t>(seq >> 8U);
+            packet[3] = static_cast<uint8_t>(seq);
+            for (int i = 0; i < payload_bytes; i++)
+                {
+                    packet[sequence_number_bytes + i] = static_cast<uint8_t>(seq * 7 + i);
+                }
+            sendto(sock, packet.data(), packet.size(), 0, reinterpret_cast<struct sockaddr *>(&destination), sizeof(destination));
+        }
+    close(sock);
+
+    const auto sent = std::chrono::steady_clock::now();
+    while (sink->data().size() < num_samples && std::chrono::steady_clock::now() - sent < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    top_block->stop();
+    top_block->wait();
+
+    EXPECT_EQ(num_packets - 1, source->packets_received());
+    EXPECT_EQ(1U, source->sequence_gaps());
+    EXPECT_EQ(0U, source->out_of_order_packets());
+    EXPECT_EQ(0U, source->packets_dropped());
+
+    // without IQ swap, the first byte of each sample is its imaginary part
+    std::vector<gr_complex> samples = sink->data();
+    ASSERT_EQ(num_samples, samples.size());
+    size_t k = 0;
+    for (uint32_t seq = 0; seq < num_packets; seq++)
+        {
+            if (seq == missing_packet)
+                {
+                    continue;
+                }
+            for (int i = 0; i < payload_bytes / 2; i++, k++)
+                {
+                    const auto imag = static_cast<int8_t>(static_cast<uint8_t>(seq * 7 + 2 * i));
+                    const auto real = static_cast<int8_t>(static_cast<uint8_t>(seq * 7 + 2 * i + 1));
+                    ASSERT_EQ(gr_complex(real, imag), samples[k]) << "sample " << k;
+                }
+        }
+}
@@ -0,0 +1,222 @@
+/*!
+ * \file iq_archive_test.cc
+ * \brief Unit tests for the IQ archive format, and for its recorder and
+ * replay blocks.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "iq_archive.h"
+#include "iq_archive_sink.h"
+#include "iq_archive_source.h"
+#include <gnuradio/top_block.h>
+#ifdef GR_GREATER_38
+#include <gnuradio/blocks/vector_sink.h>
+#include <gnuradio/blocks/vector_source.h>
+#else
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#endif
+#include <unistd.h>  // for truncate
+#include <algorithm>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+// interleaved I and Q components within the range of the given bits
+std::vector<int16_t> random_components(uint32_t samples, uint8_t bits, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(-(1 << (bits - 1)), (1 << (bits - 1)) - 1);
+    std::vector<int16_t> components(2 * static_cast<size_t>(samples));
+    for (auto& c : components)
+        {
+            c = static_cast<int16_t>(distribution(generator));
+        }
+    return components;
+}
+
+
+// Writes an archive of random samples and returns their components
+std::vector<std::vector<int16_t>> write_archive(const std::string& filename, const Iq_Archive_Format& format, uint32_t samples)
+{
+    std::vector<std::vector<int16_t>> channels;
+    for (unsigned int c = 0; c < format.channels; c++)
+        {
+            channels.push_back(random_components(samples, format.bits, c + 1));
+        }
+    Iq_Archive_Writer writer;
+    EXPECT_TRUE(writer.open(filename, format));
+    std::vector<uint8_t> chunk;
+    for (uint32_t first = 0; first < samples; first += format.chunk_samples)
+        {
+            std::vector<const int16_t*> pointers;
+            for (const auto& channel : channels)
+                {
+                    pointers.push_back(&channel[2 * static_cast<size_t>(first)]);
+                }
+            iq_archive::encode_chunk(format, pointers, std::min(format.chunk_samples, samples - first), format.first_sample_counter + first, chunk);
+            EXPECT_TRUE(writer.write_chunk(chunk));
+        }
+    EXPECT_TRUE(writer.close());
+    return channels;
+}
+}  // namespace
+
+
+TEST(IqArchiveTest, PackAndUnpack)
+{
+    for (uint8_t bits : {2, 4, 8, 16})
+        {
+            const uint32_t samples = 1001;  // not a whole number of bytes for 2 bits
+            const std::vector<int16_t> components = random_components(samples, bits, bits);
+            std::vector<uint8_t> packed(iq_archive::packed_size(samples, bits));
+            iq_archive::pack(components.data(), samples, bits, packed.data());
+
+            std::vector<std::complex<int16_t>> unpacked(samples);
+            iq_archive::unpack(packed.data(), samples, bits, unpacked.data());
+            std::vector<std::complex<float>> unpacked_float(samples);
+            iq_archive::unpack(packed.data(), samples, bits, 2.0, unpacked_float.data());
+            for (uint32_t n = 0; n < samples; n++)
+                {
+                    ASSERT_EQ(components[2 * n], unpacked[n].real()) << static_cast<int>(bits) << " bits, sample " << n;
+                    ASSERT_EQ(components[2 * n + 1], unpacked[n].imag()) << static_cast<int>(bits) << " bits, sample " << n;
+                    ASSERT_FLOAT_EQ(components[2 * n] / 2.0F, unpacked_float[n].real());
+                }
+        }
+
+    // out of range values are clipped
+    const std::vector<int16_t> large = {100, -100};
+    uint8_t packed = 0;
+    std::complex<int16_t> unpacked;
+    iq_archive::pack(large.data(), 1, 4, &packed);
+    iq_archive::unpack(&packed, 1, 4, &unpacked);
+    EXPECT_EQ(std::complex<int16_t>(7, -8), unpacked);
+}
+
+
+TEST(IqArchiveTest, WriteReadAndSeek)
+{
+    const std::string filename = "./iq_archive_test.iqa";
+    Iq_Archive_Format format;
+    format.channels = 2;
+    format.bits = 4;
+    format.compression = Iq_Archive_Compression::HUFFMAN;
+    format.chunk_samples = 1000;
+    format.sampling_frequency = 4e6;
+    format.first_sample_counter = 123456;
+    const std::vector<std::vector<int16_t>> channels = write_archive(filename, format, 5500);
+
+    Iq_Archive_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_FALSE(reader.index_rebuilt());
+    EXPECT_EQ(2, reader.format().channels);
+    EXPECT_EQ(4, reader.format().bits);
+    EXPECT_DOUBLE_EQ(4e6, reader.format().sampling_frequency);
+    ASSERT_EQ(6U, reader.chunks());
+    EXPECT_EQ(5500U, reader.samples());
+    EXPECT_EQ(500U, reader.chunk_samples(5));
+    EXPECT_EQ(4U, reader.chunk_for_sample(4321));
+    EXPECT_EQ(5U, reader.chunk_for_sample(5499));
+    EXPECT_EQ(reader.chunks(), reader.chunk_for_sample(5500));
+    EXPECT_EQ(123456U + 4000U, reader.chunk_counter(4));
+
+    std::vector<uint8_t> chunk;
+    std::vector<std::complex<int16_t>> samples;
+    ASSERT_TRUE(reader.read_chunk(4, chunk));
+    ASSERT_TRUE(iq_archive::decode_chunk(reader.format(), chunk, samples));
+    ASSERT_EQ(2000U, samples.size());
+    for (size_t c = 0; c < 2; c++)
+        {
+            for (size_t n = 0; n < 1000; n++)
+                {
+                    ASSERT_EQ(channels[c][2 * (4000 + n)], samples[c * 1000 + n].real());
+                    ASSERT_EQ(channels[c][2 * (4000 + n) + 1], samples[c * 1000 + n].imag());
+                }
+        }
+
+    // a corrupted chunk is detected
+    chunk[20] ^= 1U;
+    EXPECT_FALSE(iq_archive::decode_chunk(reader.format(), chunk, samples));
+    std::remove(filename.c_str());
+}
+
+
+TEST(IqArchiveTest, RebuildIndexOfInterruptedRecording)
+{
+    const std::string filename = "./iq_archive_interrupted.iqa";
+    Iq_Archive_Format format;
+    format.chunk_samples = 1000;
+    write_archive(filename, format, 3000);
+
+    // drop the index and half of the last chunk
+    const size_t chunk_size = iq_archive::CHUNK_HEADER_SIZE + iq_archive::packed_size(1000, 8);
+    ASSERT_EQ(0, truncate(filename.c_str(), iq_archive::FILE_HEADER_SIZE + 2 * chunk_size + chunk_size / 2));
+
+    Iq_Archive_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_TRUE(reader.index_rebuilt());
+    EXPECT_EQ(2U, reader.chunks());
+    EXPECT_EQ(2000U, reader.samples());
+    std::remove(filename.c_str());
+}
+
+
+TEST(IqArchiveTest, RecordAndReplayFlowgraphs)
+{
+    const std::string filename = "./iq_archive_flowgraph.iqa";
+    const int samples = 20000;
+    std::vector<gr_complex> input(samples);
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(-128, 127);
+    for (auto& s : input)
+        {
+            s = gr_complex(distribution(generator), distribution(generator)) / 127.0F;
+        }
+
+    Iq_Archive_Format format;
+    format.bits = 8;
+    format.chunk_samples = 4096;
+    format.scale = 127.0;
+    format.compression = Iq_Archive_Compression::HUFFMAN;
+    auto top_block = gr::make_top_block("IQ archive recording");
+    auto source = gr::blocks::vector_source_c::make(input);
+    auto sink = iq_archive_make_sink(filename, sizeof(gr_complex), format, 2);
+    top_block->connect(source, 0, sink, 0);
+    top_block->run();
+
+    // replay from an arbitrary position
+    const int first = 10000;
+    auto replay_block = gr::make_top_block("IQ archive replay");
+    auto archive = iq_archive_make_source(filename, sizeof(gr_complex), false, 3);
+    ASSERT_EQ(static_cast<uint64_t>(samples), archive->samples());
+    ASSERT_TRUE(archive->seek(first));
+    auto output = gr::blocks::vector_sink_c::make();
+    replay_block->connect(archive, 0, output, 0);
+    replay_block->run();
+
+    const std::vector<gr_complex> replayed = output->data();
+    ASSERT_EQ(static_cast<size_t>(samples - first), replayed.size());
+    for (size_t n = 0; n < replayed.size(); n++)
+        {
+            ASSERT_NEAR(input[first + n].real(), replayed[n].real(), 1e-6);
+            ASSERT_NEAR(input[first + n].imag(), replayed[n].imag(), 1e-6);
+        }
+    std::remove(filename.c_str());
+}
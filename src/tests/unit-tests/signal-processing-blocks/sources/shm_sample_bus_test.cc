@@ -0,0 +1,168 @@
+/*!
+ * \file shm_sample_bus_test.cc
+ * \brief Unit tests for the shared memory sample bus
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "shm_sample_bus.h"
+#include <gtest/gtest.h>
+#include <unistd.h>  // for getpid
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+std::string test_bus_name()
+{
+    return "/gnss-sdr-test-bus-" + std::to_string(getpid());
+}
+
+
+// Reads the bus until it is closed, checking that each item carries its
+// own sample counter, and accounting for the lost and zeroed ones.
+void read_all(Shm_Sample_Bus_Reader& reader, uint64_t& received, uint64_t& lost, uint64_t& errors)
+{
+    std::vector<uint32_t> buffer(4096);
+    uint64_t counter = reader.counter();
+    while (not reader.finished())
+        {
+            if (reader.wait(100) == 0)
+                {
+                    continue;
+                }
+            uint64_t gap = 0;
+            uint64_t zeroed = 0;
+            const uint64_t n = reader.read(buffer.data(), buffer.size(), gap, zeroed);
+            lost += gap + zeroed;
+            counter += gap;
+            for (uint64_t k = zeroed; k < n; k++)
+                {
+                    if (buffer[k] != static_cast<uint32_t>(counter + k))
+                        {
+                            errors++;
+                        }
+                }
+            counter += n;
+            received += n - zeroed;
+        }
+}
+}  // namespace
+
+
+TEST(ShmSampleBusTest, FanOutToTwoReaders)
+{
+    const uint64_t total = 2000000;
+    Shm_Sample_Bus_Writer writer;
+    ASSERT_TRUE(writer.create(test_bus_name(), sizeof(uint32_t), 1 << 20, 4e6));
+
+    Shm_Sample_Bus_Reader reader1;
+    Shm_Sample_Bus_Reader reader2;
+    ASSERT_TRUE(reader1.attach(test_bus_name()));
+    ASSERT_TRUE(reader2.attach(test_bus_name()));
+    EXPECT_EQ(reader1.item_size(), sizeof(uint32_t));
+    EXPECT_EQ(reader1.capacity(), static_cast<uint64_t>(1 << 20));
+    EXPECT_DOUBLE_EQ(reader2.sampling_frequency(), 4e6);
+
+    uint64_t received[2] = {0, 0};
+    uint64_t lost[2] = {0, 0};
+    uint64_t errors[2] = {0, 0};
+    std::thread thread1(read_all, std::ref(reader1), std::ref(received[0]), std::ref(lost[0]), std::ref(errors[0]));
+    std::thread thread2(read_all, std::ref(reader2), std::ref(received[1]), std::ref(lost[1]), std::ref(errors[1]));
+
+    std::vector<uint32_t> block(1000);
+    for (uint64_t counter = 0; counter < total; counter += block.size())
+        {
+            for (size_t k = 0; k < block.size(); k++)
+                {
+                    block[k] = static_cast<uint32_t>(counter + k);
+                }
+            writer.write(block.data(), block.size());
+        }
+    EXPECT_EQ(writer.counter(), total);
+    writer.close();
+    thread1.join();
+    thread2.join();
+
+    for (int r = 0; r < 2; r++)
+        {
+            EXPECT_EQ(errors[r], 0U);
+            EXPECT_EQ(received[r] + lost[r], total);
+        }
+}
+
+
+TEST(ShmSampleBusTest, OverrunIsReported)
+{
+    Shm_Sample_Bus_Writer writer;
+    ASSERT_TRUE(writer.create(test_bus_name(), sizeof(uint32_t), 1024, 1e6));
+    Shm_Sample_Bus_Reader reader;
+    ASSERT_TRUE(reader.attach(test_bus_name()));
+
+    std::vector<uint32_t> samples(5000);
+    for (size_t k = 0; k < samples.size(); k++)
+        {
+            samples[k] = static_cast<uint32_t>(k);
+        }
+    writer.write(samples.data(), samples.size());
+
+    // the reader resumes half a ring behind the writer
+    std::vector<uint32_t> buffer(2048);
+    uint64_t lost = 0;
+    uint64_t zeroed = 0;
+    EXPECT_EQ(reader.read(buffer.data(), buffer.size(), lost, zeroed), 0U);
+    EXPECT_EQ(lost, 5000U - 512U);
+    EXPECT_EQ(reader.counter(), 5000U - 512U);
+
+    EXPECT_EQ(reader.read(buffer.data(), buffer.size(), lost, zeroed), 512U);
+    EXPECT_EQ(lost, 0U);
+    EXPECT_EQ(zeroed, 0U);
+    for (size_t k = 0; k < 512; k++)
+        {
+            EXPECT_EQ(buffer[k], 5000U - 512U + k);
+        }
+}
+
+
+TEST(ShmSampleBusTest, CloseFinishesReaders)
+{
+    Shm_Sample_Bus_Writer writer;
+    ASSERT_TRUE(writer.create(test_bus_name(), sizeof(uint32_t), 1024, 1e6));
+    Shm_Sample_Bus_Reader reader;
+    ASSERT_TRUE(reader.attach(test_bus_name()));
+    EXPECT_EQ(reader.wait(10), 0U);
+    EXPECT_FALSE(reader.finished());
+
+    const uint32_t last = 7;
+    writer.write(&last, 1);
+    writer.close();
+
+    // samples written before closing are still delivered
+    EXPECT_FALSE(reader.finished());
+    EXPECT_EQ(reader.wait(10), 1U);
+    uint32_t value = 0;
+    uint64_t lost = 0;
+    uint64_t zeroed = 0;
+    EXPECT_EQ(reader.read(&value, 1, lost, zeroed), 1U);
+    EXPECT_EQ(value, last);
+    EXPECT_TRUE(reader.finished());
+
+    // the bus name is gone
+    Shm_Sample_Bus_Reader late_reader;
+    EXPECT_FALSE(late_reader.attach(test_bus_name()));
+}
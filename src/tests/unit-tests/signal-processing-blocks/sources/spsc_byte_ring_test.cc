@@ -0,0 +1,121 @@
+/*!
+ * \file spsc_byte_ring_test.cc
+ * \brief Unit tests for the lock-free single-producer, single-consumer ring
+ * buffer of bytes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "spsc_byte_ring.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+TEST(SpscByteRingTest, PushAndConsumeAcrossTheEnd)
+{
+    Spsc_Byte_Ring ring(5000);
+    EXPECT_EQ(8192U, ring.capacity());
+    EXPECT_EQ(8192U, ring.free_space());
+
+    std::vector<uint8_t> data(3000);
+    for (size_t i = 0; i < data.size(); i++)
+        {
+            data[i] = static_cast<uint8_t>(i);
+        }
+    EXPECT_TRUE(ring.push(data.data(), data.size()));
+    EXPECT_TRUE(ring.push(data.data(), data.size()));
+    EXPECT_FALSE(ring.push(data.data(), data.size()));  // does not fit
+    EXPECT_EQ(6000U, ring.available());
+
+    ring.consume(6000);
+    EXPECT_TRUE(ring.push(data.data(), data.size()));  // wraps around the end
+    ASSERT_EQ(3000U, ring.available());
+    for (size_t i = 0; i < data.size(); i++)
+        {
+            EXPECT_EQ(data[i], ring.peek(i));
+        }
+}
+
+
+TEST(SpscByteRingTest, WriteInPlaceAndCompact)
+{
+    Spsc_Byte_Ring ring(4096);
+    size_t contiguous;
+    uint8_t* slot0 = ring.writable(0, contiguous);
+    EXPECT_EQ(4096U, contiguous);
+    uint8_t* slot1 = ring.writable(100, contiguous);
+    for (int i = 0; i < 60; i++)
+        {
+            slot0[i] = 1;  // a datagram shorter than its 100-byte slot
+            slot1[i] = 2;
+        }
+    ring.compact(100, 60, 60);
+    ring.commit(120);
+    ASSERT_EQ(120U, ring.available());
+    for (size_t i = 0; i < 120; i++)
+        {
+            EXPECT_EQ(i < 60 ? 1 : 2, ring.peek(i));
+        }
+}
+
+
+TEST(SpscByteRingTest, ProducerAndConsumerThreads)
+{
+    Spsc_Byte_Ring ring(4096);
+    const size_t total_bytes = 1000000;
+    std::thread producer([&]() {
+        std::vector<uint8_t> chunk(1000);
+        size_t sent = 0;
+        while (sent < total_bytes)
+            {
+                for (size_t i = 0; i < chunk.size(); i++)
+                    {
+                        chunk[i] = static_cast<uint8_t>((sent + i) % 251);
+                    }
+                if (ring.push(chunk.data(), chunk.size()))
+                    {
+                        sent += chunk.size();
+                    }
+                else
+                    {
+                        std::this_thread::yield();
+                    }
+            }
+    });
+
+    size_t received = 0;
+    size_t errors = 0;
+    while (received < total_bytes)
+        {
+            const size_t available = ring.available();
+            if (available == 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+            for (size_t i = 0; i < available; i++)
+                {
+                    if (ring.peek(i) != static_cast<uint8_t>((received + i) % 251))
+                        {
+                            errors++;
+                        }
+                }
+            ring.consume(available);
+            received += available;
+        }
+    producer.join();
+    EXPECT_EQ(0U, errors);
+}
@@ -0,0 +1,954 @@
+/*!
+ * \file batch_processor.cc
+ * \brief Implementation of a segment-parallel batch processor of recorded
+ * captures.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "batch_processor.h"
+#include "file_configuration.h"
+#include <glog/logging.h>
+#include <fcntl.h>     // for open, O_WRONLY
+#include <sys/wait.h>  // for waitpid
+#include <unistd.h>    // for fork, execvp, dup2, chdir
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#if HAS_STD_FILESYSTEM
+#if HAS_STD_FILESYSTEM_EXPERIMENTAL
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem;
+#else
+#include <filesystem>
+namespace fs = std::filesystem;
+#endif
+#else
+#include <boost/filesystem.hpp>
+namespace fs = boost::filesystem;
+#endif
+
+
+namespace
+{
+// Assistance files written by the PVT block when PVT.xml_output_enabled=true,
+// and the properties that load them back
+const std::vector<std::pair<std::string, std::string>> ASSISTANCE_FILES = {
+    {"gps_ephemeris.xml", "GNSS-SDR.AGNSS_gps_ephemeris_xml"},
+    {"gps_utc_model.xml", "GNSS-SDR.AGNSS_gps_utc_model_xml"},
+    {"gps_iono.xml", "GNSS-SDR.AGNSS_gps_iono_xml"},
+    {"gps_almanac.xml", "GNSS-SDR.AGNSS_gps_almanac_xml"},
+    {"gps_cnav_ephemeris.xml", "GNSS-SDR.AGNSS_gps_cnav_ephemeris_xml"},
+    {"gps_cnav_utc_model.xml", "GNSS-SDR.AGNSS_cnav_utc_model_xml"},
+    {"gal_ephemeris.xml", "GNSS-SDR.AGNSS_gal_ephemeris_xml"},
+    {"gal_utc_model.xml", "GNSS-SDR.AGNSS_gal_utc_model_xml"},
+    {"gal_iono.xml", "GNSS-SDR.AGNSS_gal_iono_xml"},
+    {"gal_almanac.xml", "GNSS-SDR.AGNSS_gal_almanac_xml"},
+    {"glo_gnav_ephemeris.xml", "GNSS-SDR.AGNSS_glo_ephemeris_xml"},
+    {"glo_utc_model.xml", "GNSS-SDR.AGNSS_glo_utc_model_xml"}};
+
+
+// Seconds since 1970-01-01 of a civil date and time
+double epoch_seconds(int year, int month, int day, int hour, int minute, double second)
+{
+    // days from civil, valid for the proleptic Gregorian calendar
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = year - era * 400;
+    const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const double days = static_cast<double>(era) * 146097.0 + static_cast<double>(doe) - 719468.0;
+    return days * 86400.0 + hour * 3600.0 + minute * 60.0 + second;
+}
+
+
+// Returns true if line is the epoch record of a RINEX observation file,
+// and then stores its time in t
+bool rinex_obs_epoch(const std::string& line, double& t)
+{
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    int hour = 0;
+    int minute = 0;
+    double second = 0.0;
+    if (!line.empty() && line[0] == '>')
+        {
+            // RINEX 3: > YYYY MM DD HH MM SS.SSSSSSS  F NNN
+            if (std::sscanf(line.c_str() + 1, "%d %d %d %d %d %lf", &year, &month, &day, &hour, &minute, &second) == 6)
+                {
+                    t = epoch_seconds(year, month, day, hour, minute, second);
+                    return true;
+                }
+            return false;
+        }
+    // RINEX 2: 1X,I2.2,4(1X,I2),F11.7,2X,I1,I3
+    if (line.size() >= 32 && line[0] == ' ' && line[18] == '.' && std::isdigit(static_cast<unsigned char>(line[28])) &&
+        std::sscanf(line.c_str(), "%d %d %d %d %d %lf", &year, &month, &day, &hour, &minute, &second) == 6)
+        {
+            year += year < 80 ? 2000 : 1900;
+            t = epoch_seconds(year, month, day, hour, minute, second);
+            return true;
+        }
+    return false;
+}
+
+
+// Returns true if line is a RMC sentence with a valid date and time, and
+// then stores its time in t
+bool nmea_rmc_epoch(const std::string& line, double& t)
+{
+    if (line.size() < 6 || line[0] != '$' || line.compare(3, 3, "RMC") != 0)
+        {
+            return false;
+        }
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ','))
+        {
+            fields.push_back(field);
+        }
+    if (fields.size() < 10 || fields[1].size() < 6 || fields[9].size() != 6)
+        {
+            return false;
+        }
+    try
+        {
+            const int hour = std::stoi(fields[1].substr(0, 2));
+            const int minute = std::stoi(fields[1].substr(2, 2));
+            const double second = std::stod(fields[1].substr(4));
+            const int day = std::stoi(fields[9].substr(0, 2));
+            const int month = std::stoi(fields[9].substr(2, 2));
+            const int year = 2000 + std::stoi(fields[9].substr(4, 2));
+            t = epoch_seconds(year, month, day, hour, minute, second);
+        }
+    catch (const std::exception& e)
+        {
+            return false;
+        }
+    return true;
+}
+
+
+// Copies the header of a RINEX file to out (if not null), and leaves in
+// positioned at the first line of the body
+bool copy_rinex_header(std::ifstream& in, std::ofstream* out)
+{
+    std::string line;
+    while (std::getline(in, line))
+        {
+            if (out != nullptr)
+                {
+                    *out << line << '\n';
+                }
+            if (line.size() > 60 && line.find("END OF HEADER", 60) != std::string::npos)
+                {
+                    return true;
+                }
+        }
+    return false;
+}
+
+
+// Returns true if line contains the time stamp of a KML placemark, and then
+// stores its time in t
+bool kml_placemark_epoch(const std::string& line, double& t)
+{
+    const size_t start = line.find("<when>");
+    if (start == std::string::npos)
+        {
+            return false;
+        }
+    int year = 0;
+    int month = 0;
+    int day = 0;
+    int hour = 0;
+    int minute = 0;
+    double second = 0.0;
+    // YYYY-MM-DDTHH:MM:SS.SSSZ
+    if (std::sscanf(line.c_str() + start + 6, "%d-%d-%dT%d:%d:%lf", &year, &month, &day, &hour, &minute, &second) != 6)
+        {
+            return false;
+        }
+    t = epoch_seconds(year, month, day, hour, minute, second);
+    return true;
+}
+
+
+// Returns the text between the given tags in line, or an empty string
+std::string between_tags(const std::string& line, const std::string& open_tag, const std::string& close_tag)
+{
+    const size_t start = line.find(open_tag);
+    if (start == std::string::npos)
+        {
+            return std::string();
+        }
+    const size_t end = line.find(close_tag, start + open_tag.size());
+    if (end == std::string::npos)
+        {
+            return std::string();
+        }
+    return line.substr(start + open_tag.size(), end - start - open_tag.size());
+}
+
+
+std::string to_string_precise(double value)
+{
+    std::stringstream ss;
+    ss << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    return ss.str();
+}
+}  // namespace
+
+
+BatchProcessor::BatchProcessor(const std::string& config_file, const Batch_Options& options) : config_file_(config_file),
+                                                                                                 options_(options),
+                                                                                                 sampling_frequency_(0.0),
+                                                                                                 duration_s_(0.0),
+                                                                                                 items_per_sample_(1),
+                                                                                                 nchannels_(0)
+{
+    if (options_.jobs == 0)
+        {
+            options_.jobs = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+}
+
+
+std::vector<Batch_Segment> BatchProcessor::plan_segments(double duration_s, double segment_length_s, double overlap_s)
+{
+    std::vector<Batch_Segment> segments;
+    if (duration_s <= 0.0)
+        {
+            return segments;
+        }
+    if (segment_length_s <= 0.0 || segment_length_s > duration_s)
+        {
+            segment_length_s = duration_s;
+        }
+    overlap_s = std::max(overlap_s, 0.0);
+
+    // a tiny remainder is absorbed by the last segment
+    const auto num_segments = std::max(static_cast<uint32_t>(std::round(duration_s / segment_length_s)), 1U);
+    segments.reserve(num_segments);
+    for (uint32_t i = 0; i < num_segments; i++)
+        {
+            Batch_Segment segment{};
+            segment.index = i;
+            segment.core_start_s = static_cast<double>(i) * segment_length_s;
+            segment.start_s = std::max(segment.core_start_s - overlap_s, 0.0);
+            segment.last = (i == num_segments - 1);
+            segment.end_s = segment.last ? duration_s : static_cast<double>(i + 1) * segment_length_s;
+            segments.push_back(segment);
+        }
+    return segments;
+}
+
+
+bool BatchProcessor::write_segment_config(const std::string& base_config, const std::map<std::string, std::string>& overrides, const std::string& output)
+{
+    std::ifstream in(base_config);
+    std::ofstream out(output, std::ios::out | std::ios::trunc);
+    if (!in.is_open() || !out.is_open())
+        {
+            return false;
+        }
+    out << in.rdbuf();
+
+    // the INI reader keeps the last value of repeated properties
+    out << "\n[GNSS-SDR]\n";
+    out << ";######### BATCH SEGMENT ############\n";
+    for (const auto& property : overrides)
+        {
+            out << property.first << "=" << property.second << '\n';
+        }
+    return out.good();
+}
+
+
+bool BatchProcessor::stitch_rinex_obs(const std::vector<std::string>& files, const std::string& output)
+{
+    std::ofstream out(output, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        {
+            return false;
+        }
+
+    bool header_written = false;
+    double last_epoch = -std::numeric_limits<double>::infinity();
+    for (const auto& file : files)
+        {
+            std::ifstream in(file);
+            if (!in.is_open() || !copy_rinex_header(in, header_written ? nullptr : &out))
+                {
+                    LOG(WARNING) << "Skipping RINEX file " << file << ": header not found";
+                    continue;
+                }
+            header_written = true;
+
+            // an epoch is its epoch record and all the lines up to the next one
+            std::string line;
+            std::string block;
+            double block_epoch = 0.0;
+            bool in_block = false;
+            auto flush = [&]() {
+                if (in_block && block_epoch > last_epoch)
+                    {
+                        out << block;
+                        last_epoch = block_epoch;
+                    }
+                block.clear();
+            };
+            while (std::getline(in, line))
+                {
+                    double t = 0.0;
+                    if (rinex_obs_epoch(line, t))
+                        {
+                            flush();
+                            block_epoch = t;
+                            in_block = true;
+                        }
+                    if (in_block)
+                        {
+                            block += line + '\n';
+                        }
+                }
+            flush();
+        }
+    return header_written;
+}
+
+
+bool BatchProcessor::stitch_rinex_nav(const std::vector<std::string>& files, const std::string& output)
+{
+    std::ofstream out(output, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        {
+            return false;
+        }
+
+    bool header_written = false;
+    std::set<std::string> records_written;
+    for (const auto& file : files)
+        {
+            std::ifstream in(file);
+            if (!in.is_open() || !copy_rinex_header(in, header_written ? nullptr : &out))
+                {
+                    LOG(WARNING) << "Skipping RINEX file " << file << ": header not found";
+                    continue;
+                }
+            header_written = true;
+
+            // continuation lines of a navigation record start with at least three blanks
+            std::string line;
+            std::string record;
+            auto flush = [&]() {
+                if (!record.empty() && records_written.insert(record).second)
+                    {
+                        out << record;
+                    }
+                record.clear();
+            };
+            while (std::getline(in, line))
+                {
+                    if (line.compare(0, 3, "   ") != 0)
+                        {
+                            flush();
+                        }
+                    record += line + '\n';
+                }
+            flush();
+        }
+    return header_written;
+}
+
+
+bool BatchProcessor::stitch_nmea(const std::vector<std::string>& files, const std::string& output)
+{
+    std::ofstream out(output, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        {
+            return false;
+        }
+
+    bool first_file = true;
+    double last_epoch = -std::numeric_limits<double>::infinity();
+    for (const auto& file : files)
+        {
+            std::ifstream in(file);
+            if (!in.is_open())
+                {
+                    continue;
+                }
+
+            // sentences without a valid RMC time are only kept from the first file
+            std::string line;
+            std::string block;
+            double block_epoch = 0.0;
+            bool timed = false;
+            auto flush = [&]() {
+                if (timed ? block_epoch > last_epoch : first_file)
+                    {
+                        out << block;
+                        if (timed)
+                            {
+                                last_epoch = block_epoch;
+                            }
+                    }
+                block.clear();
+            };
+            while (std::getline(in, line))
+                {
+                    if (!line.empty() && line.back() == '\r')
+                        {
+                            line.pop_back();
+                        }
+                    if (line.size() >= 6 && line[0] == '$' && line.compare(3, 3, "RMC") == 0)
+                        {
+                            flush();
+                            timed = nmea_rmc_epoch(line, block_epoch);
+                        }
+                    block += line + "\r\n";
+                }
+            flush();
+            first_file = false;
+        }
+    return true;
+}
+
+
+bool BatchProcessor::stitch_kml(const std::vector<std::string>& files, const std::string& output)
+{
+    std::ofstream out(output, std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        {
+            return false;
+        }
+
+    // same layout as Kml_Printer: a header, a folder with a placemark per
+    // position, and a path joining them
+    const std::string indent = "  ";
+    bool header_written = false;
+    double last_epoch = -std::numeric_limits<double>::infinity();
+    uint64_t point_id = 0;
+    std::string path;
+    for (const auto& file : files)
+        {
+            std::ifstream in(file);
+            std::string line;
+            bool in_header = true;
+            while (in_header && std::getline(in, line))
+                {
+                    if (!header_written)
+                        {
+                            out << line << '\n';
+                        }
+                    in_header = line.find("<name>Points</name>") == std::string::npos;
+                }
+            if (in_header)
+                {
+                    LOG(WARNING) << "Skipping KML file " << file << ": header not found";
+                    continue;
+                }
+            header_written = true;
+
+            std::string placemark;
+            std::string coordinates;
+            double placemark_epoch = 0.0;
+            bool timed = false;
+            while (std::getline(in, line) && line.find("</Folder>") == std::string::npos)
+                {
+                    if (line.find("<Placemark>") != std::string::npos)
+                        {
+                            placemark.clear();
+                            timed = false;
+                        }
+                    if (line.find("<name>") != std::string::npos)
+                        {
+                            // the points are numbered again
+                            line = line.substr(0, line.find("<name>")) + "<name>@</name>";
+                        }
+                    if (kml_placemark_epoch(line, placemark_epoch))
+                        {
+                            timed = true;
+                        }
+                    if (line.find("<coordinates>") != std::string::npos)
+                        {
+                            coordinates = between_tags(line, "<coordinates>", "</coordinates>");
+                        }
+                    placemark += line + '\n';
+                    if (line.find("</Placemark>") != std::string::npos && timed && placemark_epoch > last_epoch)
+                        {
+                            last_epoch = placemark_epoch;
+                            point_id++;
+                            placemark.replace(placemark.find("<name>@</name>"), 14, "<name>" + std::to_string(point_id) + "</name>");
+                            out << placemark;
+                            path += indent + indent + indent + indent + indent + coordinates + '\n';
+                        }
+                }
+        }
+    if (!header_written)
+        {
+            return false;
+        }
+
+    out << indent << indent << "</Folder>" << '\n'
+        << indent << indent << "<Placemark>" << '\n'
+        << indent << indent << indent << "<name>Path</name>" << '\n'
+        << indent << indent << indent << "<styleUrl>#yellowLineGreenPoly</styleUrl>" << '\n'
+        << indent << indent << indent << "<LineString>" << '\n'
+        << indent << indent << indent << indent << "<extrude>0</extrude>" << '\n'
+        << indent << indent << indent << indent << "<tessellate>1</tessellate>" << '\n'
+        << indent << indent << indent << indent << "<altitudeMode>absolute</altitudeMode>" << '\n'
+        << indent << indent << indent << indent << "<coordinates>" << '\n'
+        << path
+        << indent << indent << indent << indent << "</coordinates>" << '\n'
+        << indent << indent << indent << "</LineString>" << '\n'
+        << indent << indent << "</Placemark>" << '\n'
+        << indent << "</Document>" << '\n'
+        << "</kml>";
+    return out.good();
+}
+
+
+bool BatchProcessor::stitch_observables_dump(const std::vector<std::string>& files, uint32_t nchannels, const std::string& output)
+{
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open() || nchannels == 0)
+        {
+            return false;
+        }
+
+    // each epoch is a record of 7 doubles per channel, the first one being
+    // the receiver time of the channel
+    const size_t number_of_double_vars = 7;
+    std::vector<double> epoch(number_of_double_vars * nchannels);
+    const auto epoch_size_bytes = static_cast<std::streamsize>(epoch.size() * sizeof(double));
+    bool first_file = true;
+    double last_epoch = -std::numeric_limits<double>::infinity();
+    for (const auto& file : files)
+        {
+            std::ifstream in(file, std::ios::binary);
+            if (!in.is_open())
+                {
+                    continue;
+                }
+            while (in.read(reinterpret_cast<char*>(epoch.data()), epoch_size_bytes))
+                {
+                    double rx_time = 0.0;
+                    for (uint32_t i = 0; i < nchannels; i++)
+                        {
+                            rx_time = std::max(rx_time, epoch[i * number_of_double_vars]);
+                        }
+                    // epochs without a receiver time are only kept from the first file
+                    if (rx_time > 0.0 ? rx_time > last_epoch : first_file)
+                        {
+                            out.write(reinterpret_cast<const char*>(epoch.data()), epoch_size_bytes);
+                            if (rx_time > 0.0)
+                                {
+                                    last_epoch = rx_time;
+                                }
+                        }
+                }
+            first_file = false;
+        }
+    return out.good();
+}
+
+
+bool BatchProcessor::read_capture_parameters()
+{
+    FileConfiguration configuration(config_file_);
+    const std::string implementation = configuration.property("SignalSource.implementation", std::string("Pass_Through"));
+    if (implementation != "File_Signal_Source")
+        {
+            std::cerr << "Batch processing requires SignalSource.implementation=File_Signal_Source, found " << implementation << std::endl;
+            return false;
+        }
+
+    filename_ = configuration.property("SignalSource.filename", std::string("../data/my_capture.dat"));
+    const std::string item_type = configuration.property("SignalSource.item_type", std::string("short"));
+    sampling_frequency_ = configuration.property("SignalSource.sampling_frequency", 0.0);
+    const uint64_t header_size = configuration.property("SignalSource.header_size", static_cast<uint64_t>(0));
+    rinex_name_ = configuration.property("PVT.rinex_name", std::string("-"));
+    if (rinex_name_ == "-")
+        {
+            rinex_name_ = "gnss_sdr_batch";
+        }
+    nmea_filename_ = fs::path(configuration.property("PVT.nmea_dump_filename", std::string("./nmea_pvt.nmea"))).filename().string();
+
+    if (configuration.property("Observables.dump", false))
+        {
+            // named as the Observables block does
+            std::string dump_filename = fs::path(configuration.property("Observables.dump_filename", std::string("./observables.dat"))).filename().string();
+            if (dump_filename.empty())
+                {
+                    dump_filename = "observables.dat";
+                }
+            if (dump_filename.substr(1).find_last_of('.') != std::string::npos)
+                {
+                    dump_filename = dump_filename.substr(0, dump_filename.find_last_of('.'));
+                }
+            observables_dump_filename_ = dump_filename + ".dat";
+        }
+    nchannels_ = 0;
+    for (const char* signal : {"1C", "1B", "1G", "2S", "2G", "5X", "L5", "B1", "B3"})
+        {
+            nchannels_ += configuration.property(std::string("Channels_") + signal + ".count", 0U);
+        }
+
+    uint64_t item_size = 0;
+    items_per_sample_ = 1;
+    if (item_type == "gr_complex")
+        {
+            item_size = 8;
+        }
+    else if (item_type == "float")
+        {
+            item_size = 4;
+        }
+    else if (item_type == "short" || item_type == "ishort")
+        {
+            item_size = 2;
+            items_per_sample_ = item_type == "ishort" ? 2 : 1;
+        }
+    else if (item_type == "byte" || item_type == "ibyte")
+        {
+            item_size = 1;
+            items_per_sample_ = item_type == "ibyte" ? 2 : 1;
+        }
+    else
+        {
+            std::cerr << "Unsupported item type " << item_type << std::endl;
+            return false;
+        }
+
+    if (sampling_frequency_ <= 0.0)
+        {
+            std::cerr << "SignalSource.sampling_frequency must be set" << std::endl;
+            return false;
+        }
+
+    const fs::path capture(filename_);
+    if (!fs::exists(capture))
+        {
+            std::cerr << "The file " << filename_ << " does not exist" << std::endl;
+            return false;
+        }
+    // the receivers do not run in the folder of the configuration file
+    filename_ = fs::absolute(capture).string();
+    const auto items = static_cast<double>(fs::file_size(capture) / item_size);
+    duration_s_ = (items - static_cast<double>(header_size)) / static_cast<double>(items_per_sample_) / sampling_frequency_;
+    if (duration_s_ <= 0.0)
+        {
+            std::cerr << "The file " << filename_ << " does not contain samples" << std::endl;
+            return false;
+        }
+
+    if (configuration.property("GNSS-SDR.AGNSS_XML_enabled", false))
+        {
+            // the configuration already provides the assistance data
+            options_.first_pass_s = 0.0;
+        }
+    return true;
+}
+
+
+std::map<std::string, std::string> BatchProcessor::segment_overrides(const Batch_Segment& segment, const std::string& segment_dir) const
+{
+    std::map<std::string, std::string> overrides = assistance_overrides_;
+
+    overrides["SignalSource.filename"] = filename_;
+    overrides["SignalSource.repeat"] = "false";
+    overrides["SignalSource.seconds_to_skip"] = to_string_precise(segment.start_s);
+    uint64_t items = 0;  // up to the end of the file
+    if (!segment.last)
+        {
+            items = static_cast<uint64_t>(std::llround((segment.end_s - segment.start_s) * sampling_frequency_)) * items_per_sample_;
+        }
+    overrides["SignalSource.samples"] = std::to_string(items);
+
+    // every instance writes its own products
+    for (const char* path : {"output_path", "rinex_output_path", "nmea_output_file_path", "kml_output_path",
+             "gpx_output_path", "geojson_output_path", "xml_output_path", "rtcm_output_file_path"})
+        {
+            overrides[std::string("PVT.") + path] = segment_dir;
+        }
+    overrides["PVT.rinex_name"] = rinex_name_;
+    overrides["PVT.nmea_dump_filename"] = nmea_filename_;
+    if (!observables_dump_filename_.empty())
+        {
+            overrides["Observables.dump_filename"] = segment_dir + "/" + observables_dump_filename_;
+        }
+
+    // and does not share ports or devices with the others
+    overrides["PVT.flag_rtcm_server"] = "false";
+    overrides["PVT.flag_nmea_tty_port"] = "false";
+    overrides["PVT.enable_monitor"] = "false";
+    overrides["Monitor.enable_monitor"] = "false";
+    overrides["GNSS-SDR.telecommand_enabled"] = "false";
+    return overrides;
+}
+
+
+bool BatchProcessor::run_receiver(const std::map<std::string, std::string>& overrides, const std::string& run_dir) const
+{
+    const std::string segment_config = run_dir + "/segment.conf";
+    if (!write_segment_config(config_file_, overrides, segment_config))
+        {
+            LOG(WARNING) << "Unable to write " << segment_config;
+            return false;
+        }
+
+    // the receiver runs in run_dir, so a relative path to it must be made
+    // absolute, while a bare name is searched in the PATH
+    std::string executable = options_.gnss_sdr_executable;
+    if (executable.find('/') != std::string::npos)
+        {
+            executable = fs::absolute(fs::path(executable)).string();
+        }
+    std::string config_arg = "--config_file=" + segment_config;
+    std::string log_dir_arg = "--log_dir=" + run_dir;
+    const std::string log_file = run_dir + "/gnss-sdr.log";
+    std::array<char*, 4> args{{&executable[0], &config_arg[0], &log_dir_arg[0], nullptr}};
+    DLOG(INFO) << "Running " << executable << " " << config_arg << " " << log_dir_arg << " in " << run_dir;
+
+    // only async-signal-safe calls are made in the child, as the other
+    // workers keep running in the parent
+    const pid_t pid = fork();
+    if (pid == -1)
+        {
+            LOG(WARNING) << "Unable to start " << executable << ": fork failed";
+            return false;
+        }
+    if (pid == 0)
+        {
+            const int null_fd = open("/dev/null", O_RDONLY);
+            const int log_fd = open(log_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (null_fd == -1 || log_fd == -1 || dup2(null_fd, STDIN_FILENO) == -1 || dup2(log_fd, STDOUT_FILENO) == -1 ||
+                dup2(log_fd, STDERR_FILENO) == -1 || chdir(run_dir.c_str()) == -1)
+                {
+                    _exit(127);
+                }
+            execvp(args[0], args.data());
+            _exit(127);
+        }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1)
+        {
+            if (errno != EINTR)
+                {
+                    LOG(WARNING) << "Unable to wait for " << executable;
+                    return false;
+                }
+        }
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+        {
+            LOG(WARNING) << "Unable to run " << executable << " in " << run_dir;
+        }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+
+bool BatchProcessor::run_first_pass()
+{
+    const std::string dir = fs::absolute(fs::path(options_.output_dir) / "first_pass").string();
+    fs::create_directories(dir);
+
+    Batch_Segment first_pass{};
+    first_pass.end_s = std::min(options_.first_pass_s, duration_s_);
+    first_pass.last = first_pass.end_s >= duration_s_;
+    std::map<std::string, std::string> overrides = segment_overrides(first_pass, dir);
+    overrides["PVT.xml_output_enabled"] = "true";
+
+    std::cout << "Decoding the navigation message from the first " << first_pass.end_s << " s of the capture..." << std::endl;
+    if (!run_receiver(overrides, dir))
+        {
+            std::cerr << "The first pass failed, see " << dir << "/gnss-sdr.log" << std::endl;
+        }
+
+    for (const auto& assistance : ASSISTANCE_FILES)
+        {
+            const fs::path file = fs::path(dir) / assistance.first;
+            if (fs::exists(file))
+                {
+                    assistance_overrides_[assistance.second] = file.string();
+                }
+        }
+    if (assistance_overrides_.empty())
+        {
+            std::cout << "No navigation data was decoded in the first pass, the segments will start without assistance" << std::endl;
+            return false;
+        }
+    assistance_overrides_["GNSS-SDR.AGNSS_XML_enabled"] = "true";
+    return true;
+}
+
+
+void BatchProcessor::stitch_outputs(const std::vector<Batch_Segment>& segments) const
+{
+    // RINEX files are named rinex_name.YYT, with T the file type
+    std::map<std::string, std::vector<std::string>> rinex_files;
+    std::vector<std::string> nmea_files;
+    std::vector<std::string> kml_files;
+    std::vector<std::string> observables_files;
+    const std::string prefix = rinex_name_ + ".";
+    for (const auto& segment : segments)
+        {
+            std::stringstream name;
+            name << "segment_" << std::setw(3) << std::setfill('0') << segment.index;
+            const fs::path segment_dir = fs::path(options_.output_dir) / name.str();
+            if (!fs::exists(segment_dir))
+                {
+                    continue;
+                }
+            for (const auto& entry : fs::directory_iterator(segment_dir))
+                {
+                    const std::string filename = entry.path().filename().string();
+                    if (filename.compare(0, prefix.size(), prefix) == 0)
+                        {
+                            rinex_files[filename.substr(prefix.size())].push_back(entry.path().string());
+                        }
+                    else if (entry.path().extension() == ".kml")
+                        {
+                            kml_files.push_back(entry.path().string());
+                        }
+                }
+            const fs::path nmea_file = segment_dir / nmea_filename_;
+            if (fs::exists(nmea_file))
+                {
+                    nmea_files.push_back(nmea_file.string());
+                }
+            const fs::path observables_file = segment_dir / observables_dump_filename_;
+            if (!observables_dump_filename_.empty() && fs::exists(observables_file))
+                {
+                    observables_files.push_back(observables_file.string());
+                }
+        }
+
+    for (const auto& type : rinex_files)
+        {
+            const std::string output = (fs::path(options_.output_dir) / (prefix + type.first)).string();
+            const bool ok = type.first.back() == 'O' ? stitch_rinex_obs(type.second, output) : stitch_rinex_nav(type.second, output);
+            if (ok)
+                {
+                    std::cout << "RINEX file " << output << " stitched from " << type.second.size() << " segments" << std::endl;
+                }
+        }
+    if (!nmea_files.empty())
+        {
+            const std::string output = (fs::path(options_.output_dir) / nmea_filename_).string();
+            if (stitch_nmea(nmea_files, output))
+                {
+                    std::cout << "NMEA file " << output << " stitched from " << nmea_files.size() << " segments" << std::endl;
+                }
+        }
+    if (!kml_files.empty())
+        {
+            // named after the file of the first segment, which has the start time
+            const std::string output = (fs::path(options_.output_dir) / fs::path(kml_files.front()).filename()).string();
+            if (stitch_kml(kml_files, output))
+                {
+                    std::cout << "KML file " << output << " stitched from " << kml_files.size() << " segments" << std::endl;
+                }
+        }
+    if (!observables_files.empty())
+        {
+            const std::string output = (fs::path(options_.output_dir) / observables_dump_filename_).string();
+            if (stitch_observables_dump(observables_files, nchannels_, output))
+                {
+                    std::cout << "Observables dump " << output << " stitched from " << observables_files.size() << " segments" << std::endl;
+                }
+        }
+}
+
+
+int BatchProcessor::run()
+{
+    if (!read_capture_parameters())
+        {
+            return 1;
+        }
+
+    const double segment_length_s = options_.segment_length_s > 0.0 ? options_.segment_length_s : duration_s_ / options_.jobs;
+    const std::vector<Batch_Segment> segments = plan_segments(duration_s_, segment_length_s, options_.overlap_s);
+    fs::create_directories(options_.output_dir);
+
+    std::cout << "Processing " << duration_s_ << " s of signal in " << segments.size() << " segments, "
+              << options_.jobs << " at a time" << std::endl;
+    const auto start = std::chrono::steady_clock::now();
+
+    if (options_.first_pass_s > 0.0 && segments.size() > 1)
+        {
+            run_first_pass();
+        }
+
+    std::atomic<size_t> next_segment{0};
+    std::atomic<uint32_t> failures{0};
+    std::mutex cout_mutex;
+    auto worker = [&]() {
+        size_t i;
+        while ((i = next_segment++) < segments.size())
+            {
+                const Batch_Segment& segment = segments[i];
+                std::stringstream name;
+                name << "segment_" << std::setw(3) << std::setfill('0') << segment.index;
+                const std::string segment_dir = fs::absolute(fs::path(options_.output_dir) / name.str()).string();
+                fs::create_directories(segment_dir);
+
+                const bool ok = run_receiver(segment_overrides(segment, segment_dir), segment_dir);
+                if (!ok)
+                    {
+                        failures++;
+                    }
+                std::lock_guard<std::mutex> lock(cout_mutex);
+                std::cout << "Segment " << segment.index << " [" << segment.core_start_s << " s, " << segment.end_s << " s] "
+                          << (ok ? "done" : "FAILED, see " + segment_dir + "/gnss-sdr.log") << std::endl;
+            }
+    };
+    std::vector<std::thread> workers;
+    const auto num_workers = std::min<size_t>(options_.jobs, segments.size());
+    for (size_t w = 0; w < num_workers; w++)
+        {
+            workers.emplace_back(worker);
+        }
+    for (auto& w : workers)
+        {
+            w.join();
+        }
+
+    stitch_outputs(segments);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Processed " << duration_s_ << " s of signal in " << elapsed.count() << " s ("
+              << duration_s_ / elapsed.count() << " times faster than real time)" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
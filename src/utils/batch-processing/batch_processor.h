@@ -0,0 +1,158 @@
+/*!
+ * \file batch_processor.h
+ * \brief Interface of a segment-parallel batch processor of recorded captures.
+ *
+ * A recorded capture is split into time segments that overlap by a few
+ * seconds. Each segment is processed by an independent GNSS-SDR instance,
+ * and the RINEX, NMEA and KML outputs of all the instances are stitched into a
+ * single product.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BATCH_PROCESSOR_H
+#define GNSS_SDR_BATCH_PROCESSOR_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief A time interval of the capture, processed by one receiver instance.
+ *
+ * The receiver runs from start_s to end_s. The outputs produced between
+ * start_s and core_start_s only serve to let the receiver acquire, track
+ * and decode the navigation message, and they are superseded by those of
+ * the previous segment when the outputs are stitched.
+ */
+struct Batch_Segment
+{
+    uint32_t index;
+    double start_s;       //!< Start of processing, in seconds from the beginning of the capture
+    double core_start_s;  //!< Start of the interval this segment is responsible for
+    double end_s;         //!< End of processing
+    bool last;            //!< The last segment reads up to the end of the file
+};
+
+
+/*!
+ * \brief Parameters of a batch run.
+ */
+struct Batch_Options
+{
+    std::string gnss_sdr_executable = "gnss-sdr";  //!< Receiver executable run for each segment
+    std::string output_dir = "./batch";            //!< Folder for the segments and the stitched products
+    uint32_t jobs = 0;                             //!< Receiver instances run at once (0: number of cores)
+    double segment_length_s = 0.0;                 //!< Length of the segments (0: capture length / jobs)
+    double overlap_s = 45.0;                       //!< Overlap between consecutive segments
+    double first_pass_s = 60.0;                    //!< Length of the pass that decodes the ephemeris (0: no first pass)
+};
+
+
+/*!
+ * \brief Runs GNSS-SDR over a recorded capture in parallel time segments,
+ * and stitches their outputs.
+ *
+ * Only the File_Signal_Source implementation is supported. Unless the
+ * configuration already enables GNSS-SDR.AGNSS_XML_enabled, a first pass over
+ * the beginning of the capture stores the decoded ephemeris, UTC and
+ * ionospheric models as XML files, and all the segments load them as
+ * assistance data, so they produce fixes shortly after their start.
+ *
+ * Each receiver runs in the folder of its segment, so relative paths in the
+ * configuration (e.g., the dump files of the processing blocks) point there.
+ * The RINEX, NMEA and KML files and the Observables dump are stitched; the
+ * GPX, GeoJSON and RTCM files, the .mat files and the other dumps are left
+ * in the folders of the segments.
+ */
+class BatchProcessor
+{
+public:
+    BatchProcessor(const std::string& config_file, const Batch_Options& options);
+    ~BatchProcessor() = default;
+
+    /*!
+     * \brief Processes the whole capture. Returns 0 on success.
+     */
+    int run();
+
+    /*!
+     * \brief Splits a capture of duration_s seconds into segments of
+     * segment_length_s seconds, each one starting overlap_s seconds before
+     * the interval it is responsible for.
+     */
+    static std::vector<Batch_Segment> plan_segments(double duration_s, double segment_length_s, double overlap_s);
+
+    /*!
+     * \brief Writes a copy of base_config with the given properties
+     * overridden.
+     */
+    static bool write_segment_config(const std::string& base_config, const std::map<std::string, std::string>& overrides, const std::string& output);
+
+    /*!
+     * \brief Stitches RINEX observation files, given in time order. The header
+     * is taken from the first file, and the epochs of each file are appended
+     * only if they are later than the last epoch already written.
+     */
+    static bool stitch_rinex_obs(const std::vector<std::string>& files, const std::string& output);
+
+    /*!
+     * \brief Stitches RINEX navigation files. The header is taken from the
+     * first file, and repeated navigation records are written only once.
+     */
+    static bool stitch_rinex_nav(const std::vector<std::string>& files, const std::string& output);
+
+    /*!
+     * \brief Stitches NMEA files, given in time order. Each epoch starts with
+     * a RMC sentence, and it is appended only if it is later than the last
+     * epoch already written.
+     */
+    static bool stitch_nmea(const std::vector<std::string>& files, const std::string& output);
+
+    /*!
+     * \brief Stitches KML files written by Kml_Printer, given in time order.
+     * The placemarks are appended only if they are later than the last one
+     * already written, and the path joining them is written again.
+     */
+    static bool stitch_kml(const std::vector<std::string>& files, const std::string& output);
+
+    /*!
+     * \brief Stitches binary dumps of the Observables block, given in time
+     * order. An epoch is appended only if its receiver time is later than the
+     * last one already written.
+     */
+    static bool stitch_observables_dump(const std::vector<std::string>& files, uint32_t nchannels, const std::string& output);
+
+private:
+    bool read_capture_parameters();
+    std::map<std::string, std::string> segment_overrides(const Batch_Segment& segment, const std::string& segment_dir) const;
+    bool run_receiver(const std::map<std::string, std::string>& overrides, const std::string& run_dir) const;
+    bool run_first_pass();
+    void stitch_outputs(const std::vector<Batch_Segment>& segments) const;
+
+    std::string config_file_;
+    Batch_Options options_;
+    std::map<std::string, std::string> assistance_overrides_;
+    std::string filename_;
+    std::string rinex_name_;
+    std::string nmea_filename_;
+    std::string observables_dump_filename_;  // empty if Observables.dump is not enabled
+    double sampling_frequency_;
+    double duration_s_;
+    uint32_t items_per_sample_;
+    uint32_t nchannels_;
+};
+
+#endif  // GNSS_SDR_BATCH_PROCESSOR_H
@@ -0,0 +1,80 @@
+/*!
+ * \file main.cc
+ * \brief Main file of the batch processing program, which runs GNSS-SDR over
+ * a recorded capture in parallel time segments.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BATCH_VERSION
+#define GNSS_SDR_BATCH_VERSION "0.0.1"
+#endif
+
+#include "batch_processor.h"
+#include "gnss_sdr_flags.h"
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <iostream>
+#include <string>
+
+DEFINE_string(gnss_sdr, "gnss-sdr", "Path to the GNSS-SDR executable run for each segment.");
+DEFINE_string(output_dir, "./batch", "Folder for the segments and the stitched RINEX, NMEA and KML files.");
+DEFINE_int32(jobs, 0, "Number of receivers run at once (0: number of processor cores).");
+DEFINE_double(segment_length, 0.0, "Length of the segments, in seconds (0: capture length divided by the number of jobs).");
+DEFINE_double(overlap, 45.0, "Seconds processed before the start of each segment to let the receiver get its first fix.");
+DEFINE_double(first_pass, 60.0, "Seconds processed at the beginning of the capture to decode the ephemeris used as assistance by all the segments (0: no first pass).");
+
+
+int main(int argc, char** argv)
+{
+    const std::string intro_help(
+        std::string("\n GNSS-SDR batch processing of recorded captures in parallel time segments\n") +
+        "Copyright (C) 2010-2020 (see AUTHORS file for a list of contributors)\n" +
+        "This program comes with ABSOLUTELY NO WARRANTY;\n" +
+        "See COPYING file to see a copy of the General Public License\n \n" +
+        "Usage: \n" +
+        "   gnss-sdr-batch --config_file=<file> [--jobs=<n>] [--segment_length=<s>] [--output_dir=<folder>]\n");
+
+    google::SetUsageMessage(intro_help);
+    google::SetVersionString(GNSS_SDR_BATCH_VERSION);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    std::string config_file = FLAGS_config_file;
+    if (FLAGS_c != "-")
+        {
+            config_file = FLAGS_c;
+        }
+
+    if (FLAGS_jobs < 0)
+        {
+            std::cerr << "The number of jobs must be positive" << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+
+    Batch_Options options;
+    options.gnss_sdr_executable = FLAGS_gnss_sdr;
+    options.output_dir = FLAGS_output_dir;
+    options.jobs = static_cast<uint32_t>(FLAGS_jobs);
+    options.segment_length_s = FLAGS_segment_length;
+    options.overlap_s = FLAGS_overlap;
+    options.first_pass_s = FLAGS_first_pass;
+
+    BatchProcessor batch_processor(config_file, options);
+    const int return_code = batch_processor.run();
+
+    google::ShutDownCommandLineFlags();
+    return return_code;
+}